@@ -20,11 +20,16 @@
 #define PWLEDGER_CLI_APP_STATE_H
 
 #include <pwledger/ClipboardTimer.h>
+#include <pwledger/CompletionIndex.h>
 #include <pwledger/Config.h>
+#include <pwledger/KeySlots.h>
 #include <pwledger/PrimaryTable.h>
 #include <pwledger/Secret.h>
+#include <pwledger/VaultCrypto.h>
+#include <pwledger/VaultManager.h>
 
 #include <filesystem>
+#include <optional>
 
 namespace pwledger {
 
@@ -33,8 +38,13 @@ struct AppState {
   pwledger::Config config;
   pwledger::PrimaryTable table;
   pwledger::Secret master_password{1};  // placeholder until initialized
+  std::optional<pwledger::X25519KeyPair> identity;  // unlocked with a key slot (batch --identity) instead
+  std::optional<pwledger::Secret> data_key;         // a key-slot vault's, once unlocked: what saves reseal with
   std::filesystem::path vault_path;
+  pwledger::KdfParams kdf;  // Argon2id cost every save records (see calibrate)
   pwledger::ClipboardTimer clipboard_timer;  // auto-clear clipboard after copy
+  pwledger::CompletionIndex completion;      // entry keys; kept current by the command loop
+  pwledger::VaultManager vaults;             // named vaults (config vault.vaults), beside `table`
 };
 
 }  // namespace pwledger
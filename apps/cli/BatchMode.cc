@@ -0,0 +1,725 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BatchMode.h"
+
+#include "ListView.h"
+#include "SecretIO.h"
+
+#include <pwledger/Secret.h>
+#include <pwledger/SecretEntry.h>
+#include <pwledger/TerminalManager.h>
+#include <pwledger/Transaction.h>
+#include <pwledger/VaultImport.h>
+#include <pwledger/VaultIO.h>
+#include <pwledger/VaultPath.h>
+#include <pwledger/uuid.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include <nlohmann/json.hpp>
+#include <sodium.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace pwledger {
+
+namespace {
+
+using Json = nlohmann::ordered_json;
+
+constexpr const char* kUsage =
+    "usage: pwledger-cli                                   interactive session\n"
+    "       pwledger-cli [options] --batch FILE|-          run a script, one command per line\n"
+    "       pwledger-cli [options] COMMAND [ARGS...]       run one command\n"
+    "\n"
+    "commands:\n"
+    "  list    [--sort name|user|created|modified|used (-KEY reverses)] [--page N --page-size N]\n"
+    "  get     (--name N | --uuid U) [--field name|username|uuid|password|created|modified|used]\n"
+    "  add     --name N [--user U]        (secret: one line from the input fd)\n"
+    "  update  (--name N | --uuid U)      (secret: one line from the input fd)\n"
+    "  delete  (--name N | --uuid U)\n"
+    "  import  --file PATH [--format csv|bitwarden-json|keepass-xml]\n"
+    "\n"
+    "options:\n"
+    "  --vault PATH       use this vault file\n"
+    "  --password-fd N    read the master password from fd N (default: prompt on stdin)\n"
+    "  --identity FILE    unlock a key-slot vault with this X25519 key file, not a password\n"
+    "  --secret-fd N      write passwords requested with --field password to fd N\n"
+    "  --input-fd N       read secrets for add/update from fd N (default 0)\n"
+    "  --keep-going       continue after a failed command\n";
+
+// ----------------------------------------------------------------------------
+// Secret I/O on raw file descriptors
+// ----------------------------------------------------------------------------
+// read(2) and write(2) directly, so no stdio or iostream buffer ever holds
+// secret bytes.
+
+long fd_read(int fd, char* buf, std::size_t n) {
+#ifdef _WIN32
+  return _read(fd, buf, static_cast<unsigned>(n));
+#else
+  return static_cast<long>(::read(fd, buf, n));
+#endif
+}
+
+long fd_write(int fd, const char* buf, std::size_t n) {
+#ifdef _WIN32
+  return _write(fd, buf, static_cast<unsigned>(n));
+#else
+  return static_cast<long>(::write(fd, buf, n));
+#endif
+}
+
+bool fd_is_terminal(int fd) {
+#ifdef _WIN32
+  return _isatty(fd) != 0;
+#else
+  return ::isatty(fd) != 0;
+#endif
+}
+
+void write_all(int fd, const char* data, std::size_t n) {
+  while (n > 0) {
+    const long written = fd_write(fd, data, n);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      throw std::runtime_error("cannot write to fd " + std::to_string(fd) + ": " + std::strerror(errno));
+    }
+    data += written;
+    n -= static_cast<std::size_t>(written);
+  }
+}
+
+// Reads one line from `fd` into `out`, NUL-terminated, without the line
+// ending. One byte per read() so nothing after the line is consumed: the
+// same fd may carry the next secret, or the script.
+std::size_t read_secret_line(int fd, Secret& out) {
+  std::size_t len = 0;
+  bool any = false;
+  bool too_long = false;
+  out.with_write_access([&](std::span<char> buf) {
+    sodium_memzero(buf.data(), buf.size());
+    for (;;) {
+      char c = 0;
+      const long got = fd_read(fd, &c, 1);
+      if (got < 0 && errno == EINTR) {
+        continue;
+      }
+      if (got < 0) {
+        throw std::runtime_error("cannot read from fd " + std::to_string(fd) + ": " + std::strerror(errno));
+      }
+      if (got == 0 || c == '\n') {
+        any = any || got != 0;
+        break;
+      }
+      any = true;
+      if (len + 1 < buf.size()) {
+        buf[len++] = c;
+      } else {
+        too_long = true;
+      }
+    }
+    if (len > 0 && buf[len - 1] == '\r') {
+      buf[--len] = '\0';
+    }
+  });
+  if (!any) {
+    throw std::runtime_error("no secret left on fd " + std::to_string(fd));
+  }
+  if (too_long) {
+    out.zeroize();
+    throw std::runtime_error("secret longer than " + std::to_string(out.size() - 1) + " bytes");
+  }
+  return len;
+}
+
+// Reads one script line from `fd` into `line`, as read_secret_line: a byte
+// per read(), so a script on the same fd as the secrets leaves each secret
+// for the add or update that asks for it. False at end of file.
+bool read_script_line(int fd, std::string& line) {
+  line.clear();
+  bool any = false;
+  for (;;) {
+    char c = 0;
+    const long got = fd_read(fd, &c, 1);
+    if (got < 0 && errno == EINTR) {
+      continue;
+    }
+    if (got < 0) {
+      throw std::runtime_error("cannot read from fd " + std::to_string(fd) + ": " + std::strerror(errno));
+    }
+    if (got == 0) {
+      return any;
+    }
+    any = true;
+    if (c == '\n') {
+      return true;
+    }
+    line.push_back(c);
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Commands
+// ----------------------------------------------------------------------------
+
+struct Batch {
+  AppState& state;
+  std::ostream& out;
+  const BatchOptions& options;
+};
+
+using Args = std::map<std::string, std::string, std::less<>>;
+
+// A command adds its results to `result` and returns whether it changed
+// the table.
+using BatchCommand = bool (*)(Batch&, const Args&, Json&);
+
+std::int64_t epoch_seconds(std::chrono::system_clock::time_point tp) {
+  return std::chrono::duration_cast<std::chrono::seconds>(tp.time_since_epoch()).count();
+}
+
+Json entry_json(const Uuid& uuid, const SecretEntry& entry) {
+  Json j;
+  j["uuid"] = uuid.to_string();
+  j["name"] = entry.primary_key;
+  j["username"] = entry.username_or_email;
+  j["created"] = epoch_seconds(entry.metadata.created_at);
+  j["modified"] = epoch_seconds(entry.metadata.last_modified_at);
+  j["used"] = epoch_seconds(entry.metadata.last_used_at);
+  return j;
+}
+
+std::optional<std::string_view> arg(const Args& args, std::string_view name) {
+  const auto it = args.find(name);
+  return it == args.end() ? std::nullopt : std::optional<std::string_view>(it->second);
+}
+
+std::string_view required_arg(const Args& args, std::string_view name) {
+  const auto value = arg(args, name);
+  if (!value) {
+    throw std::runtime_error("--" + std::string(name) + " is required");
+  }
+  return *value;
+}
+
+// The entry named by --uuid or --name. A name must match exactly one
+// primary key.
+PrimaryTable::iterator find_entry(PrimaryTable& table, const Args& args) {
+  const auto uuid_arg = arg(args, "uuid");
+  const auto name_arg = arg(args, "name");
+  if (uuid_arg.has_value() == name_arg.has_value()) {
+    throw std::runtime_error("give either --name or --uuid");
+  }
+  if (uuid_arg) {
+    const auto uuid = Uuid::from_string(*uuid_arg);
+    if (!uuid) {
+      throw std::runtime_error("'" + std::string(*uuid_arg) + "' is not a UUID");
+    }
+    const auto it = table.find(*uuid);
+    if (it == table.end()) {
+      throw std::runtime_error("no entry with UUID " + std::string(*uuid_arg));
+    }
+    return it;
+  }
+
+  auto found = table.end();
+  std::size_t matches = 0;
+  for (auto it = table.begin(); it != table.end(); ++it) {
+    if (it->second.primary_key == *name_arg) {
+      found = it;
+      ++matches;
+    }
+  }
+  if (matches == 0) {
+    throw std::runtime_error("no entry named '" + std::string(*name_arg) + "'");
+  }
+  if (matches > 1) {
+    throw std::runtime_error(std::to_string(matches) + " entries named '" + std::string(*name_arg) +
+                             "'; use --uuid");
+  }
+  return found;
+}
+
+Secret read_new_secret(const Batch& batch) {
+  Secret secret(kMaxSecretBytes);
+  read_secret_line(batch.options.input_fd, secret);
+  return secret;
+}
+
+std::size_t count_arg(const Args& args, std::string_view name, std::size_t fallback) {
+  const auto value = arg(args, name);
+  if (!value) {
+    return fallback;
+  }
+  std::size_t n = 0;
+  const auto [end, ec] = std::from_chars(value->data(), value->data() + value->size(), n);
+  if (ec != std::errc() || end != value->data() + value->size() || n == 0) {
+    throw std::runtime_error("--" + std::string(name) + " needs a positive number");
+  }
+  return n;
+}
+
+bool batch_list(Batch& batch, const Args& args, Json& result) {
+  ListOrder order;
+  if (const auto sort = arg(args, "sort")) {
+    const auto parsed = parse_list_order(*sort);
+    if (!parsed) {
+      throw std::runtime_error("cannot sort by '" + std::string(*sort) + "'");
+    }
+    order = *parsed;
+  }
+  const PrimaryTable& table = batch.state.table;
+  const std::size_t page_size = count_arg(args, "page-size", ListView::kAll);
+  const std::size_t page = count_arg(args, "page", 1);
+  // (page - 1) * page_size, without overflow; past the end is an empty page.
+  const std::size_t begin = page - 1 > table.size() / page_size ? table.size()
+                                                                : std::min((page - 1) * page_size, table.size());
+  const std::size_t end = begin + std::min(page_size, table.size() - begin);
+
+  const ListView view(table, order, end);
+  for (std::size_t i = begin; i < end; ++i) {
+    batch.out << entry_json(view[i]->first, view[i]->second).dump() << '\n';
+  }
+  result["count"] = end - begin;
+  result["total"] = table.size();
+  return false;
+}
+
+bool batch_get(Batch& batch, const Args& args, Json& result) {
+  const auto it = find_entry(batch.state.table, args);
+  const Uuid& uuid = it->first;
+  const SecretEntry& entry = it->second;
+  const auto field = arg(args, "field");
+  if (!field) {
+    result["entry"] = entry_json(uuid, entry);
+    return false;
+  }
+
+  result["field"] = *field;
+  if (*field != "password") {
+    Json record = entry_json(uuid, entry);
+    if (!record.contains(*field)) {
+      throw std::runtime_error("unknown field '" + std::string(*field) + "'");
+    }
+    result["value"] = record[std::string(*field)];
+    return false;
+  }
+
+  if (batch.options.secret_fd < 0) {
+    throw std::runtime_error("--field password needs --secret-fd");
+  }
+  entry.plaintext_secret.with_read_access([&](std::span<const char> buf) {
+    write_all(batch.options.secret_fd, buf.data(), ::strnlen(buf.data(), buf.size()));
+  });
+  write_all(batch.options.secret_fd, "\n", 1);
+  result["fd"] = batch.options.secret_fd;
+
+  // As the interactive get and copy: reading the secret counts as a use.
+  Transaction tx(batch.state.table);
+  tx.touch(uuid);
+  tx.commit();
+  return true;
+}
+
+bool batch_add(Batch& batch, const Args& args, Json& result) {
+  SecretEntry entry(std::string(required_arg(args, "name")),
+                    std::string(arg(args, "user").value_or("")),
+                    kMaxSecretBytes,
+                    crypto_pwhash_SALTBYTES);
+  entry.salt.with_write_access([](std::span<char> buf) { randombytes_buf(buf.data(), buf.size()); });
+  entry.plaintext_secret = read_new_secret(batch);
+
+  Transaction tx(batch.state.table);
+  const Uuid uuid = tx.insert(std::move(entry));
+  tx.commit();
+  result["uuid"] = uuid.to_string();
+  return true;
+}
+
+bool batch_update(Batch& batch, const Args& args, Json& result) {
+  const Uuid uuid = find_entry(batch.state.table, args)->first;
+  Transaction tx(batch.state.table);
+  tx.update_secret(uuid, read_new_secret(batch));
+  tx.commit();
+  result["uuid"] = uuid.to_string();
+  return true;
+}
+
+bool batch_delete(Batch& batch, const Args& args, Json& result) {
+  const Uuid uuid = find_entry(batch.state.table, args)->first;
+  Transaction tx(batch.state.table);
+  tx.erase(uuid);
+  tx.commit();
+  result["uuid"] = uuid.to_string();
+  return true;
+}
+
+bool batch_import(Batch& batch, const Args& args, Json& result) {
+  const std::string path(required_arg(args, "file"));
+  std::optional<ImportFormat> format = guess_import_format(path);
+  if (const auto name = arg(args, "format")) {
+    format = parse_import_format(*name);
+    if (!format) {
+      throw std::runtime_error("unknown format '" + std::string(*name) + "'");
+    }
+  }
+  if (!format) {
+    throw std::runtime_error("cannot tell the format of '" + path + "'; give --format");
+  }
+
+  PrimaryTable staged;
+  const ImportResult imported = import_file(path, *format, staged);
+  Transaction tx(batch.state.table);
+  tx.insert_all(std::move(staged));
+  tx.commit();
+  result["imported"] = imported.imported;
+  result["skipped"] = imported.skipped;
+  result["too_long"] = imported.too_long;
+  return imported.imported != 0;
+}
+
+struct CommandSpec {
+  BatchCommand fn;
+  std::vector<std::string_view> options;
+};
+
+const std::map<std::string, CommandSpec, std::less<>>& command_table() {
+  static const std::map<std::string, CommandSpec, std::less<>> table{
+      {"list", {batch_list, {"sort", "page", "page-size"}}},
+      {"get", {batch_get, {"name", "uuid", "field"}}},
+      {"add", {batch_add, {"name", "user"}}},
+      {"update", {batch_update, {"name", "uuid"}}},
+      {"delete", {batch_delete, {"name", "uuid"}}},
+      {"import", {batch_import, {"file", "format"}}},
+  };
+  return table;
+}
+
+Args parse_args(const std::vector<std::string>& words, const CommandSpec& spec) {
+  Args args;
+  for (std::size_t i = 1; i < words.size(); i += 2) {
+    const std::string& word = words[i];
+    const std::string_view name = std::string_view(word).substr(2);
+    if (!word.starts_with("--") || std::find(spec.options.begin(), spec.options.end(), name) == spec.options.end()) {
+      throw std::runtime_error("unexpected argument '" + word + "'");
+    }
+    if (i + 1 == words.size()) {
+      throw std::runtime_error(word + " needs a value");
+    }
+    if (!args.emplace(std::string(name), words[i + 1]).second) {
+      throw std::runtime_error(word + " given twice");
+    }
+  }
+  return args;
+}
+
+std::optional<int> parse_fd(std::string_view text) {
+  int fd = -1;
+  const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), fd);
+  if (ec != std::errc() || end != text.data() + text.size() || fd < 0) {
+    return std::nullopt;
+  }
+  return fd;
+}
+
+int usage_error(const std::string& message) {
+  std::cerr << "pwledger-cli: " << message << "\n\n" << kUsage;
+  return 2;
+}
+
+// Unlocks the vault at state.vault_path with a password read from
+// `password_fd`, echo suppressed if that is a terminal.
+void unlock(AppState& state, int password_fd) {
+  Secret password(kMaxSecretBytes);
+  if (password_fd == 0 && fd_is_terminal(0)) {
+    std::cerr << "Master password: " << std::flush;
+    TerminalManager_v terminal_guard;
+    read_secret_line(0, password);
+    std::cerr << '\n';
+  } else {
+    read_secret_line(password_fd, password);
+  }
+
+  password.with_read_access([&](std::span<const char> buf) {
+    const std::string_view text(buf.data(), ::strnlen(buf.data(), buf.size()));
+    state.table = VaultIO::load_vault(state.vault_path, text, state.data_key);
+  });
+  state.kdf = VaultIO::stored_kdf_params(state.vault_path).value_or(KdfParams{});
+  state.master_password = std::move(password);
+}
+
+}  // anonymous namespace
+
+// ============================================================================
+// split_command_line
+// ============================================================================
+
+std::vector<std::string> split_command_line(std::string_view line) {
+  std::vector<std::string> words;
+  std::size_t i = 0;
+  while (i < line.size()) {
+    while (i < line.size() && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r')) {
+      ++i;
+    }
+    if (i == line.size() || line[i] == '#') {
+      break;
+    }
+    std::string word;
+    while (i < line.size() && line[i] != ' ' && line[i] != '\t' && line[i] != '\r') {
+      if (line[i] != '"') {
+        word.push_back(line[i++]);
+        continue;
+      }
+      for (++i;; ++i) {
+        if (i == line.size()) {
+          throw std::runtime_error("unterminated quote");
+        }
+        if (line[i] == '"') {
+          if (i + 1 < line.size() && line[i + 1] == '"') {
+            word.push_back('"');
+            ++i;
+            continue;
+          }
+          ++i;
+          break;
+        }
+        word.push_back(line[i]);
+      }
+    }
+    words.push_back(std::move(word));
+  }
+  return words;
+}
+
+// ============================================================================
+// BatchRunner
+// ============================================================================
+
+BatchRunner::BatchRunner(AppState& state, std::ostream& out, const BatchOptions& options)
+    : state_(state), out_(out), options_(options) {}
+
+bool BatchRunner::run(const std::vector<std::string>& words, std::size_t line) {
+  ++commands_;
+  Json result;
+  const auto& commands = command_table();
+  const auto it = words.empty() ? commands.end() : commands.find(words[0]);
+  // Only a known command is named: a word that is not one may be a secret
+  // the script got out of step with, and stdout must never carry it.
+  result["cmd"] = it == commands.end() ? std::string() : it->first;
+  if (line != 0) {
+    result["line"] = line;
+  }
+  result["ok"] = true;
+
+  try {
+    if (it == commands.end()) {
+      throw std::runtime_error("unknown command");
+    }
+    Batch batch{state_, out_, options_};
+    const Args args = parse_args(words, it->second);
+    changed_ = it->second.fn(batch, args, result) || changed_;
+  } catch (const std::exception& e) {
+    ++failed_;
+    result["ok"] = false;
+    result["error"] = e.what();
+  }
+  // One flush per command: a reader sees each result as soon as it exists.
+  out_ << result.dump() << '\n' << std::flush;
+  return result["ok"].get<bool>();
+}
+
+void BatchRunner::run_script(std::istream& script) {
+  std::string line;
+  for (std::size_t number = 1; std::getline(script, line); ++number) {
+    if (!run_script_line(line, number)) {
+      return;
+    }
+  }
+}
+
+void BatchRunner::run_script(int fd) {
+  std::string line;
+  for (std::size_t number = 1; read_script_line(fd, line); ++number) {
+    if (!run_script_line(line, number)) {
+      return;
+    }
+  }
+}
+
+bool BatchRunner::run_script_line(const std::string& line, std::size_t number) {
+  std::vector<std::string> words;
+  try {
+    words = split_command_line(line);
+  } catch (const std::exception& e) {
+    ++commands_;
+    ++failed_;
+    Json result;
+    result["cmd"] = "";
+    result["line"] = number;
+    result["ok"] = false;
+    result["error"] = e.what();
+    out_ << result.dump() << '\n' << std::flush;
+    return options_.keep_going;
+  }
+  return words.empty() || run(words, number) || options_.keep_going;
+}
+
+// ============================================================================
+// run_batch_main
+// ============================================================================
+
+int run_batch_main(AppState& state, const std::vector<std::string>& args) {
+  BatchOptions options;
+  std::optional<std::string> script;
+  std::optional<std::filesystem::path> vault;
+  std::optional<std::filesystem::path> identity;
+  int password_fd = 0;
+
+  std::size_t i = 0;
+  for (; i < args.size() && args[i].starts_with("-"); ++i) {
+    const std::string& option = args[i];
+    if (option == "--help" || option == "-h") {
+      std::cout << kUsage;
+      return 0;
+    }
+    if (option == "--keep-going") {
+      options.keep_going = true;
+      continue;
+    }
+    if (option != "--batch" && option != "--vault" && option != "--identity" && option != "--password-fd" &&
+        option != "--secret-fd" && option != "--input-fd") {
+      return usage_error("unknown option '" + option + "'");
+    }
+    if (i + 1 == args.size()) {
+      return usage_error(option + " needs a value");
+    }
+    const std::string& value = args[++i];
+    if (option == "--batch") {
+      script = value;
+    } else if (option == "--vault") {
+      vault = value;
+    } else if (option == "--identity") {
+      identity = value;
+    } else {
+      const auto fd = parse_fd(value);
+      if (!fd) {
+        return usage_error("'" + value + "' is not a file descriptor");
+      }
+      if (option == "--password-fd") {
+        password_fd = *fd;
+      } else if (option == "--secret-fd") {
+        options.secret_fd = *fd;
+      } else {
+        options.input_fd = *fd;
+      }
+    }
+  }
+  const std::vector<std::string> command(args.begin() + static_cast<std::ptrdiff_t>(i), args.end());
+  if (script.has_value() == !command.empty()) {
+    return usage_error(script ? "--batch takes no command" : "no command given");
+  }
+
+  // A script on stdin is read from fd 0 with read(2) rather than std::cin,
+  // which would buffer the secrets after it (see run_script(int)).
+  std::ifstream script_file;
+  if (script && *script != "-") {
+    script_file.open(*script);
+    if (!script_file) {
+      return usage_error("cannot open script '" + *script + "'");
+    }
+  }
+
+  auto report = [](const char* cmd, const std::string& error) {
+    Json result;
+    result["cmd"] = cmd;
+    result["ok"] = false;
+    result["error"] = error;
+    std::cout << result.dump() << '\n' << std::flush;
+    return 1;
+  };
+
+  try {
+    if (vault) {
+      state.vault_path = *vault;
+    } else {
+      ensure_vault_dir_exists(resolve_vault_dir(state.config.vault));
+      state.vault_path = resolve_vault_path(state.config.vault);
+    }
+    if (!VaultIO::vault_exists(state.vault_path)) {
+      return report("unlock", "no vault at " + state.vault_path.string() + "; run pwledger-cli once to create it");
+    }
+    if (identity) {
+      // A key slot: no password and no Argon2id.
+      state.identity = X25519KeyPair::read_file(*identity);
+      state.table = VaultIO::load_vault(state.vault_path, *state.identity, state.data_key);
+    } else {
+      unlock(state, password_fd);
+    }
+  } catch (const std::exception& e) {
+    return report("unlock", e.what());
+  }
+
+  BatchRunner runner(state, std::cout, options);
+  if (script) {
+    if (*script == "-") {
+      runner.run_script(0);
+    } else {
+      runner.run_script(script_file);
+    }
+  } else {
+    runner.run(command);
+  }
+
+  bool saved = false;
+  if (runner.should_save()) {
+    try {
+      save_vault(state);
+      saved = true;
+    } catch (const std::exception& e) {
+      return report("commit", std::string("vault not saved: ") + e.what());
+    }
+  }
+  Json result;
+  result["cmd"] = "commit";
+  result["ok"] = runner.failed() == 0;
+  result["saved"] = saved;
+  result["commands"] = runner.commands();
+  result["failed"] = runner.failed();
+  std::cout << result.dump() << '\n' << std::flush;
+  return runner.failed() == 0 ? 0 : 1;
+}
+
+}  // namespace pwledger
@@ -0,0 +1,141 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PWLEDGER_CLI_BATCH_MODE_H
+#define PWLEDGER_CLI_BATCH_MODE_H
+
+#include "AppState.h"
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ============================================================================
+// DESIGN NOTES
+// ============================================================================
+//
+// Non-interactive use of pwledger-cli, for scripts and other programs:
+//
+//   pwledger-cli [options] --batch FILE     one command per line (FILE "-" = stdin)
+//   pwledger-cli [options] COMMAND ARGS...  a single command
+//
+// Commands
+//   list    [--sort KEY] [--page N --page-size N]     (ListView.h)
+//   get     (--name N | --uuid U) [--field name|username|uuid|password|created|modified|used]
+//   add     --name N [--user U]              secret read from the input fd
+//   update  (--name N | --uuid U)            secret read from the input fd
+//   delete  (--name N | --uuid U)
+//   import  --file PATH [--format csv|bitwarden-json|keepass-xml]
+//
+// Options
+//   --vault PATH       vault file instead of the configured one
+//   --password-fd N    read the master password (one line) from fd N rather
+//                      than prompting on the terminal
+//   --identity FILE    unlock with an X25519 key file instead, for a vault
+//                      with a public-key slot for it (KeySlots.h); saves
+//                      use the same key
+//   --secret-fd N      where `get --field password` writes; without it that
+//                      request fails rather than print a secret to stdout
+//   --input-fd N       where add/update read new secrets, a line each (0);
+//                      with --batch -, the secrets may follow their
+//                      commands on stdin
+//   --keep-going       run the remaining commands after one fails
+//
+// The vault is unlocked once. Every change is made in memory, each command
+// through its own Transaction so a command is all-or-nothing, and the vault
+// is saved once after the last command - not at all if a command failed,
+// unless --keep-going. A failed run leaves the file exactly as it was.
+//
+// OUTPUT
+// ------
+// stdout carries JSON Lines only, written as each command runs: one object
+// per listed entry, then one result per command,
+//
+//   {"cmd":"get","line":3,"ok":true,"field":"username","value":"alice"}
+//   {"cmd":"delete","line":4,"ok":false,"error":"no entry named 'x'"}
+//
+// and a final {"cmd":"commit",...} saying whether the vault was saved.
+// Messages for humans go to stderr. Secret bytes never pass through
+// std::string or iostreams: they are read with read(2) straight into a
+// Secret and written with write(2) straight from one, followed by '\n'.
+//
+// Exit status: 0 when every command succeeded and any save did, 1 when a
+// command or the save failed, 2 for a usage error.
+//
+// ============================================================================
+
+namespace pwledger {
+
+struct BatchOptions {
+  int secret_fd = -1;  // -1: password output refused
+  int input_fd = 0;
+  bool keep_going = false;
+};
+
+// Splits a script line into words. Whitespace separates words, double
+// quotes group them ("" inside quotes is a literal quote), and a '#' at the
+// start of a word begins a comment.
+std::vector<std::string> split_command_line(std::string_view line);
+
+class BatchRunner {
+public:
+  BatchRunner(AppState& state, std::ostream& out, const BatchOptions& options);
+
+  // Runs one command, reporting it on `out`. Returns false if it failed.
+  bool run(const std::vector<std::string>& words, std::size_t line = 0);
+
+  // Runs every line of `script`, stopping at the first failure unless
+  // keep_going.
+  void run_script(std::istream& script);
+
+  // As above, reading the script from `fd` a byte at a time, so it may be
+  // the input fd as well: each add or update then reads its secret from the
+  // line after it. Line numbers count script lines only.
+  void run_script(int fd);
+
+  [[nodiscard]] std::size_t commands() const noexcept { return commands_; }
+  [[nodiscard]] std::size_t failed() const noexcept { return failed_; }
+
+  // Whether the table differs from the vault file.
+  [[nodiscard]] bool changed() const noexcept { return changed_; }
+
+  // Whether the caller should save: something changed and no command
+  // failed, or keep_going.
+  [[nodiscard]] bool should_save() const noexcept { return changed_ && (failed_ == 0 || options_.keep_going); }
+
+private:
+  // Runs one script line; false once the script should stop.
+  bool run_script_line(const std::string& line, std::size_t number);
+
+  AppState& state_;
+  std::ostream& out_;
+  BatchOptions options_;
+  std::size_t commands_ = 0;
+  std::size_t failed_ = 0;
+  bool changed_ = false;
+};
+
+// Entry point for a command line with arguments: parses the options,
+// unlocks the vault, runs the commands, saves once. Returns the exit status.
+int run_batch_main(AppState& state, const std::vector<std::string>& args);
+
+}  // namespace pwledger
+
+#endif  // PWLEDGER_CLI_BATCH_MODE_H
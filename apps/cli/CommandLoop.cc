@@ -16,20 +16,37 @@
  * SOFTWARE.
  */
 
+#include "BatchMode.h"
 #include "CommandLoop.h"
 #include "Display.h"
 #include "EntryOps.h"
+#include "EntryPicker.h"
+#include "ListView.h"
 #include "SecretIO.h"
 
 #include <pwledger/Clipboard.h>
+#include <pwledger/Kernels.h>
+#include <pwledger/KeySlots.h>
+#include <pwledger/MerkleTree.h>
 #include <pwledger/Secret.h>
+#include <pwledger/SecretEntry.h>
+#include <pwledger/Transaction.h>
+#include <pwledger/VaultCrypto.h>
+#include <pwledger/VaultIO.h>
+#include <pwledger/VaultImport.h>
+#include <pwledger/VaultManager.h>
+#include <pwledger/VaultSync.h>
 #include <pwledger/uuid.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cstring>
+#include <filesystem>
 #include <iostream>
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace pwledger {
 
@@ -48,23 +65,6 @@ using Uuid = pwledger::Uuid;
 // Exceptions thrown by CRUD operations are caught in run_command_loop and
 // reported to the user without terminating the session.
 
-// ----------------------------------------------------------------------------
-// parse_uuid_input
-// ----------------------------------------------------------------------------
-// Reads a UUID string from stdin and parses it into a Uuid. Returns
-// std::nullopt and prints an error if the input is not a valid UUID.
-std::optional<Uuid> parse_uuid_input() {
-  std::string input;
-  std::cout << "UUID: ";
-  std::getline(std::cin, input);
-
-  auto uuid = Uuid::from_string(input);
-  if (!uuid) {
-    std::cout << "Error: '" << input << "' is not a valid UUID.\n";
-  }
-  return uuid;
-}
-
 void cmd_add(AppState& state) {
   std::string key, user;
   std::cout << "Primary key   : ";
@@ -72,10 +72,11 @@ void cmd_add(AppState& state) {
   std::cout << "Username/email: ";
   std::getline(std::cin, user);
 
-  // Auto-generate a UUID-v4 for the new entry.
+  // Auto-generate a time-ordered UUIDv7 for the new entry.
   Uuid uuid = Uuid::generate();
 
   if (entry_create(state.table, uuid, std::move(key), std::move(user))) {
+    state.completion.insert(uuid, state.table.at(uuid));
     std::cout << "Entry added (UUID: " << uuid << ").\n";
     save_vault_safe(state);
   } else {
@@ -84,7 +85,7 @@ void cmd_add(AppState& state) {
 }
 
 void cmd_get(AppState& state) {
-  auto uuid = parse_uuid_input();
+  auto uuid = pick_entry(state);
   if (!uuid) {
     return;
   }
@@ -101,7 +102,7 @@ void cmd_get(AppState& state) {
 }
 
 void cmd_update(AppState& state) {
-  auto uuid = parse_uuid_input();
+  auto uuid = pick_entry(state);
   if (!uuid) {
     return;
   }
@@ -115,7 +116,7 @@ void cmd_update(AppState& state) {
 }
 
 void cmd_delete(AppState& state) {
-  auto uuid = parse_uuid_input();
+  auto uuid = pick_entry(state);
   if (!uuid) {
     return;
   }
@@ -130,6 +131,9 @@ void cmd_delete(AppState& state) {
     }
   }
 
+  if (const SecretEntry* entry = entry_read(state.table, *uuid)) {
+    state.completion.erase(*uuid, *entry);
+  }
   if (entry_delete(state.table, *uuid)) {
     std::cout << "Entry deleted.\n";
     save_vault_safe(state);
@@ -138,12 +142,64 @@ void cmd_delete(AppState& state) {
   }
 }
 
-void cmd_list(AppState& state) {
-  print_table(state.table);
+// list [--sort KEY] [--page N] [--page-size N] [--all]
+//
+// On a terminal, a listing longer than the screen is shown a screenful at
+// a time. --page shows one page and sorts only as far as that page.
+void cmd_list(AppState& state, const std::vector<std::string>& args) {
+  constexpr std::size_t kDefaultPageSize = 50;
+  const ListOptions options = parse_list_options(args);
+  const PrimaryTable& table = state.table;
+  if (table.empty()) {
+    std::cout << "(no entries)\n";
+    return;
+  }
+
+  const auto rows = terminal_rows();
+  std::size_t page_size = options.page_size;
+  if (page_size == 0) {
+    page_size = rows && *rows > 3 ? *rows - 2 : kDefaultPageSize;  // header + prompt
+  }
+  const std::size_t pages = (table.size() + page_size - 1) / page_size;
+
+  if (options.page != 0) {
+    if (options.page > pages) {
+      std::cout << "Error: page " << options.page << " is past the end (" << pages
+                << (pages == 1 ? " page" : " pages") << ").\n";
+      return;
+    }
+    const std::size_t begin = (options.page - 1) * page_size;
+    const std::size_t end = std::min(begin + page_size, table.size());
+    const ListView view(table, options.order, end);
+    view.render(std::cout, begin, end);
+    std::cout << "Page " << options.page << " of " << pages << " (entries " << begin + 1 << "-" << end << " of "
+              << table.size() << ").\n";
+    return;
+  }
+
+  const ListView view(table, options.order);
+  if (options.all || !rows || pages == 1) {
+    view.render(std::cout, 0, view.size());
+    std::cout.flush();
+    return;
+  }
+  for (std::size_t begin = 0; begin < view.size(); begin += page_size) {
+    const std::size_t end = std::min(begin + page_size, view.size());
+    view.render(std::cout, begin, end);
+    if (end == view.size()) {
+      break;
+    }
+    std::cout << "-- " << end << " of " << view.size() << "; Enter for more, q to stop -- " << std::flush;
+    std::string reply;
+    if (!std::getline(std::cin, reply) || reply == "q" || reply == "Q") {
+      break;
+    }
+  }
+  std::cout.flush();
 }
 
 void cmd_copy(AppState& state) {
-  auto uuid = parse_uuid_input();
+  auto uuid = pick_entry(state);
   if (!uuid) {
     return;
   }
@@ -178,27 +234,477 @@ void cmd_save(AppState& state) {
   std::cout << "Vault saved to " << state.vault_path << ".\n";
 }
 
+void cmd_stats(AppState& state) {
+  print_memory_stats(state.table);
+}
+
 void cmd_change_master(AppState& state) {
-  Secret new_password(256);
-  prompt_secret("Enter new master password", new_password, 256, /*confirm=*/true);
+  if (VaultIO::uses_key_slots(state.vault_path)) {
+    std::cout << "The vault uses key slots: add a slot for the new password and remove the old one\n"
+              << "(add-slot password LABEL, remove-slot LABEL).\n";
+    return;
+  }
+  Secret new_password(kMaxSecretBytes);
+  prompt_secret("Enter new master password", new_password, kMaxSecretBytes, /*confirm=*/true);
   state.master_password = std::move(new_password);
   save_vault_safe(state);
   std::cout << "Master password changed and vault re-encrypted.\n";
 }
 
+// Re-tunes Argon2id to the requested unlock time on this machine and
+// re-encrypts the vault with the new parameters.
+void cmd_calibrate(AppState& state) {
+  std::cout << "Target unlock time in ms [500]: ";
+  std::string input;
+  std::getline(std::cin, input);
+
+  KdfCalibration calibration;
+  if (!input.empty()) {
+    int ms = 0;
+    try {
+      ms = std::stoi(input);
+    } catch (const std::exception&) {
+      ms = 0;
+    }
+    if (ms <= 0) {
+      std::cout << "Error: '" << input << "' is not a positive number of milliseconds.\n";
+      return;
+    }
+    calibration.target = std::chrono::milliseconds(ms);
+  }
+
+  std::cout << "Measuring Argon2id...\n";
+  const KdfParams kdf = calibrate_kdf(calibration);
+  std::cout << "Argon2id: " << kdf.opslimit << " passes, " << kdf.memlimit / (1024 * 1024) << " MiB, "
+            << kdf.parallelism << (kdf.parallelism == 1 ? " lane" : " lanes");
+  if (kdf.opslimit == KdfParams{}.opslimit && kdf.memlimit == KdfParams{}.memlimit) {
+    std::cout << " (the defaults; this machine cannot afford more within the target)";
+  }
+  std::cout << ".\n";
+
+  state.kdf = kdf;
+  if (VaultIO::uses_key_slots(state.vault_path)) {
+    std::cout << "Password slots added from now on use these parameters; existing ones keep theirs.\n";
+    return;
+  }
+  save_vault_safe(state);
+  std::cout << "Vault re-encrypted with the new parameters.\n";
+}
+
+// Imports another password manager's export. Everything is parsed into a
+// staging table first, so a malformed file adds nothing, and the entries go
+// in through one Transaction with a single save: if the save fails they are
+// taken out again, keeping the session in step with the file.
+void cmd_import(AppState& state) {
+  std::string path;
+  std::cout << "File: ";
+  std::getline(std::cin, path);
+  if (path.empty()) {
+    std::cout << "Error: no file given.\n";
+    return;
+  }
+
+  std::optional<ImportFormat> format = guess_import_format(path);
+  std::cout << "Format [csv|bitwarden-json|keepass-xml]";
+  if (format) {
+    std::cout << " [" << import_format_name(*format) << "]";
+  }
+  std::cout << ": ";
+  std::string input;
+  std::getline(std::cin, input);
+  if (!input.empty()) {
+    format = parse_import_format(input);
+  }
+  if (!format) {
+    std::cout << "Error: unknown format '" << input << "'.\n";
+    return;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  PrimaryTable staged;
+  const ImportResult result = import_file(path, *format, staged);
+  std::vector<Uuid> imported;
+  imported.reserve(staged.size());
+  for (const auto& [uuid, entry] : staged) {
+    imported.push_back(uuid);
+  }
+  Transaction tx(state.table);
+  tx.insert_all(std::move(staged));
+  try {
+    tx.commit([&](const PrimaryTable&) { save_vault(state); });
+  } catch (const std::exception& e) {
+    std::cout << "Error: nothing imported: " << e.what() << '\n';
+    return;
+  }
+  for (const Uuid& uuid : imported) {
+    state.completion.insert(uuid, state.table.at(uuid));
+  }
+  const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+  std::cout << "Imported " << result.imported << (result.imported == 1 ? " entry" : " entries") << " in "
+            << elapsed.count() << " s.\n";
+  if (result.skipped != 0) {
+    std::cout << "Skipped " << result.skipped << " empty or non-login records.\n";
+  }
+  if (result.too_long != 0) {
+    std::cout << "Skipped " << result.too_long << " records with passwords over 255 bytes.\n";
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Named vaults
+// ----------------------------------------------------------------------------
+// The vaults configured under vault.vaults, opened beside the main one. They
+// can be searched here; the other commands act on the main vault.
+
+// The named vaults in `args`, or every one (that `want_unlocked` or not)
+// when there are none. Unknown names are reported and skipped.
+std::vector<std::string> vault_names(const AppState& state, const std::vector<std::string>& args,
+                                     bool want_unlocked) {
+  std::vector<std::string> names;
+  if (args.empty()) {
+    for (const auto* vault : state.vaults.vaults()) {
+      if (vault->unlocked == want_unlocked) {
+        names.push_back(vault->name);
+      }
+    }
+    return names;
+  }
+  for (const auto& name : args) {
+    if (state.vaults.find(name) == nullptr) {
+      std::cout << "Error: no vault named '" << name << "' (see 'vaults').\n";
+    } else {
+      names.push_back(name);
+    }
+  }
+  return names;
+}
+
+void cmd_vaults(AppState& state) {
+  std::size_t width = 4;  // "main"
+  for (const auto* vault : state.vaults.vaults()) {
+    width = std::max(width, vault->name.size());
+  }
+  const auto row = [&](const std::string& name, const std::string& status, const std::filesystem::path& path) {
+    std::cout << "  " << name << std::string(width - name.size() + 2, ' ') << status
+              << std::string(status.size() < 14 ? 14 - status.size() : 1, ' ') << path.string() << '\n';
+  };
+  row("main", std::to_string(state.table.size()) + " entries", state.vault_path);
+  for (const auto* vault : state.vaults.vaults()) {
+    row(vault->name, vault->unlocked ? std::to_string(vault->table.size()) + " entries" : "locked", vault->path);
+  }
+  if (state.vaults.size() == 0) {
+    std::cout << "No named vaults. Add them to config.json as \"vault\": {\"vaults\": {\"NAME\": \"FILE\"}}.\n";
+  }
+}
+
+// Asks for every password first, then opens the vaults together.
+void cmd_unlock(AppState& state, const std::vector<std::string>& args) {
+  std::vector<VaultManager::UnlockRequest> requests;
+  for (auto& name : vault_names(state, args, false)) {
+    Secret password(kMaxSecretBytes);
+    prompt_secret("Master password for '" + name + "'", password, kMaxSecretBytes);
+    requests.push_back({std::move(name), std::move(password)});
+  }
+  if (requests.empty()) {
+    std::cout << "Nothing to unlock.\n";
+    return;
+  }
+  for (const auto& outcome : state.vaults.unlock(std::move(requests))) {
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(outcome.elapsed).count();
+    if (outcome.ok()) {
+      std::cout << "  " << outcome.name << ": unlocked, " << state.vaults.find(outcome.name)->table.size()
+                << " entries (" << ms << " ms)\n";
+    } else {
+      std::cout << "  " << outcome.name << ": " << outcome.error << '\n';
+    }
+  }
+}
+
+void cmd_lock(AppState& state, const std::vector<std::string>& args) {
+  for (const auto& name : vault_names(state, args, true)) {
+    if (state.vaults.lock(name)) {
+      std::cout << "  " << name << ": locked\n";
+    }
+  }
+}
+
+// Case-insensitive substring of a name or username, in the main vault and
+// every unlocked named vault.
+void cmd_search(AppState& state, const std::vector<std::string>& args) {
+  if (args.size() != 1) {
+    std::cout << "Usage: search TEXT (quote text with spaces)\n";
+    return;
+  }
+  const std::string& query = args.front();
+  const auto print = [](std::string_view vault, const Uuid& uuid, const SecretEntry& entry) {
+    std::cout << "  [" << vault << "] " << entry.primary_key;
+    if (!entry.username_or_email.empty()) {
+      std::cout << " <" << entry.username_or_email << '>';
+    }
+    std::cout << "  " << uuid << '\n';
+  };
+
+  std::size_t found = 0;
+  for (const auto& [uuid, entry] : state.table) {
+    if (kernels::icontains(entry.primary_key, query) || kernels::icontains(entry.username_or_email, query)) {
+      print("main", uuid, entry);
+      ++found;
+    }
+  }
+  for (const auto& hit : state.vaults.search(query)) {
+    print(hit.vault->name, *hit.uuid, *hit.entry);
+    ++found;
+  }
+  std::cout << found << (found == 1 ? " match" : " matches") << ".\n";
+}
+
+// ----------------------------------------------------------------------------
+// Key slots
+// ----------------------------------------------------------------------------
+// Extra credentials for the main vault (KeySlots.h): more passwords, and
+// X25519 public keys for machines and services. Adding or removing one
+// rewrites the slot table only, never the entries.
+
+// The vault's data key, opened with the session's own credential.
+Secret session_data_key(const AppState& state, const SlottedVault& vault) {
+  if (state.identity) {
+    return vault.unlock(*state.identity);
+  }
+  std::optional<Secret> key;
+  state.master_password.with_read_access([&](std::span<const char> buf) {
+    key.emplace(vault.unlock(std::string_view(buf.data(), ::strnlen(buf.data(), buf.size()))));
+  });
+  return std::move(*key);
+}
+
+void cmd_slots(AppState& state) {
+  if (!VaultIO::uses_key_slots(state.vault_path)) {
+    std::cout << "The vault has one master password and no key slots. 'add-slot' converts it.\n";
+    return;
+  }
+  const SlottedVault vault = VaultIO::read_slotted(state.vault_path);
+  std::size_t width = 0;
+  for (const KeySlot& slot : vault.slots()) {
+    width = std::max(width, slot.label.size());
+  }
+  for (const KeySlot& slot : vault.slots()) {
+    std::cout << "  " << slot.label << std::string(width - slot.label.size() + 2, ' ');
+    if (slot.type == KeySlot::Type::kPassword) {
+      std::cout << "password (Argon2id " << slot.kdf.opslimit << " passes, " << slot.kdf.memlimit / (1024 * 1024)
+                << " MiB)\n";
+    } else {
+      std::cout << "key " << public_key_to_hex(slot.public_key) << '\n';
+    }
+  }
+}
+
+// add-slot password LABEL | add-slot key LABEL PUBLIC_KEY_HEX
+void cmd_add_slot(AppState& state, const std::vector<std::string>& args) {
+  const bool password_slot = args.size() == 2 && args[0] == "password";
+  if (!password_slot && !(args.size() == 3 && args[0] == "key")) {
+    std::cout << "Usage: add-slot password LABEL | add-slot key LABEL PUBLIC_KEY_HEX\n";
+    return;
+  }
+  const std::string& label = args[1];
+  std::optional<X25519PublicKey> recipient;
+  if (!password_slot) {
+    recipient = public_key_from_hex(args[2]);
+    if (!recipient) {
+      std::cout << "Error: '" << args[2] << "' is not a 64-digit hex public key (see 'keygen').\n";
+      return;
+    }
+  }
+  Secret password(kMaxSecretBytes);
+  if (password_slot) {
+    prompt_secret("Password for slot '" + label + "'", password, kMaxSecretBytes, /*confirm=*/true);
+  }
+
+  if (!VaultIO::uses_key_slots(state.vault_path)) {
+    save_vault(state);  // convert what the session holds
+    state.master_password.with_read_access([&](std::span<const char> buf) {
+      state.data_key.emplace(VaultIO::convert_to_slotted(
+          state.vault_path, std::string_view(buf.data(), ::strnlen(buf.data(), buf.size())), "master"));
+    });
+    std::cout << "Converted the vault to key slots; your master password is slot 'master'.\n";
+  }
+  SlottedVault vault = VaultIO::read_slotted(state.vault_path);
+  if (!state.data_key) {
+    state.data_key.emplace(session_data_key(state, vault));
+  }
+  if (password_slot) {
+    password.with_read_access([&](std::span<const char> buf) {
+      vault.add_password_slot(*state.data_key, label,
+                              std::string_view(buf.data(), ::strnlen(buf.data(), buf.size())), state.kdf);
+    });
+  } else {
+    vault.add_public_key_slot(*state.data_key, label, *recipient);
+  }
+  VaultIO::write_slotted(state.vault_path, vault);
+  std::cout << "Added slot '" << label << "' (" << vault.slots().size() << " slots).\n";
+}
+
+void cmd_remove_slot(AppState& state, const std::vector<std::string>& args) {
+  if (args.size() != 1) {
+    std::cout << "Usage: remove-slot LABEL\n";
+    return;
+  }
+  SlottedVault vault = VaultIO::read_slotted(state.vault_path);
+  if (vault.find_slot(args[0]) == nullptr) {
+    std::cout << "Error: no slot named '" << args[0] << "' (see 'slots').\n";
+    return;
+  }
+  // The session saves with its own credential, so it must still open one.
+  SlottedVault after = vault;
+  after.remove_slot(args[0]);
+  try {
+    (void)session_data_key(state, after);
+  } catch (const std::exception&) {
+    std::cout << "Error: this session unlocked the vault through slot '" << args[0]
+              << "'; remove it from a session that uses another one.\n";
+    return;
+  }
+  VaultIO::write_slotted(state.vault_path, after);
+  std::cout << "Removed slot '" << args[0] << "'. Anyone who opened the vault with it has seen its entries;\n"
+            << "rotate those secrets if that matters.\n";
+}
+
+// keygen FILE: a key pair for add-slot key, secret key written to FILE.
+void cmd_keygen(AppState& /*state*/, const std::vector<std::string>& args) {
+  if (args.size() != 1) {
+    std::cout << "Usage: keygen FILE\n";
+    return;
+  }
+  const X25519KeyPair pair = X25519KeyPair::generate();
+  pair.write_file(args[0]);
+  std::cout << "Secret key written to " << args[0] << " (owner-only).\n"
+            << "Public key: " << public_key_to_hex(pair.public_key) << '\n';
+}
+
+// ----------------------------------------------------------------------------
+// Sync
+// ----------------------------------------------------------------------------
+// Offline sync with another copy of the vault (VaultSync.h). Each side names
+// the other, and the files travel however the user likes. A sync password
+// agreed for the pair seals the files and the state kept about the peer.
+
+// sync-export PEER FILE: what PEER lacks, written to FILE.
+void cmd_sync_export(AppState& state, const std::vector<std::string>& args) {
+  if (args.size() != 2) {
+    std::cout << "Usage: sync-export PEER FILE\n";
+    return;
+  }
+  const std::string& peer = args[0];
+  const std::filesystem::path state_file = VaultSync::state_path(state.vault_path, peer);
+  const bool first = !std::filesystem::exists(state_file);
+  if (first) {
+    std::cout << "First sync with '" << peer << "': everything is sent. Choose a sync password to use\n"
+              << "on both machines.\n";
+  }
+  Secret password(kMaxSecretBytes);
+  prompt_secret("Sync password for '" + peer + "'", password, kMaxSecretBytes, /*confirm=*/first);
+
+  password.with_read_access([&](std::span<const char> buf) {
+    const std::string_view pw(buf.data(), ::strnlen(buf.data(), buf.size()));
+    SyncPeerState peer_state = VaultSync::read_state(state_file, pw);
+    const MerkleTree current = MerkleTree::of(state.table);
+    const SyncDelta delta = VaultSync::make_delta(state.table, current, peer_state);
+    VaultSync::write_delta(args[1], delta, pw, state.kdf);
+    VaultSync::write_state(state_file, peer_state, pw, state.kdf);
+    std::cout << "Wrote " << delta.items.size() << (delta.items.size() == 1 ? " change" : " changes") << " for '"
+              << peer << "' to " << args[1] << ".\n";
+  });
+}
+
+// sync-import PEER FILE: merges a file PEER wrote with sync-export.
+void cmd_sync_import(AppState& state, const std::vector<std::string>& args) {
+  if (args.size() != 2) {
+    std::cout << "Usage: sync-import PEER FILE\n";
+    return;
+  }
+  const std::string& peer = args[0];
+  const std::filesystem::path state_file = VaultSync::state_path(state.vault_path, peer);
+  Secret password(kMaxSecretBytes);
+  prompt_secret("Sync password for '" + peer + "'", password, kMaxSecretBytes);
+
+  password.with_read_access([&](std::span<const char> buf) {
+    const std::string_view pw(buf.data(), ::strnlen(buf.data(), buf.size()));
+    SyncPeerState peer_state = VaultSync::read_state(state_file, pw);
+    SyncDelta delta = VaultSync::read_delta(args[1], pw);
+    MerkleTree current = MerkleTree::of(state.table);
+    Transaction tx(state.table);
+    const SyncReport report = VaultSync::apply_delta(tx, state.table, current, peer_state, std::move(delta));
+    try {
+      tx.commit([&](const PrimaryTable&) {
+        if (report.added + report.updated + report.removed != 0) {
+          save_vault(state);
+        }
+      });
+    } catch (const std::exception& e) {
+      // Without the state the next import of this file merges it again.
+      std::cout << "Error: nothing merged: " << e.what() << '\n';
+      return;
+    }
+    state.completion = CompletionIndex(state.table);
+
+    std::cout << "From '" << peer << "': " << report.added << " added, " << report.updated << " updated, "
+              << report.removed << " removed, " << report.unchanged << " already here.\n";
+    for (const SyncConflict& conflict : report.conflicts) {
+      std::cout << "  conflict: " << conflict.primary_key << " (" << conflict.uuid << "): ";
+      switch (conflict.kind) {
+        case SyncConflict::Kind::kBothChanged:
+          std::cout << "changed on both sides; kept " << (conflict.kept_local ? "this copy's" : "the peer's")
+                    << " later edit\n";
+          break;
+        case SyncConflict::Kind::kChangedHereRemovedThere:
+          std::cout << "removed by the peer but changed here; kept\n";
+          break;
+        case SyncConflict::Kind::kRemovedHereChangedThere:
+          std::cout << "removed here but changed by the peer; restored\n";
+          break;
+        default:
+          std::cout << '\n';
+          break;
+      }
+    }
+    VaultSync::write_state(state_file, peer_state, pw, state.kdf);
+  });
+}
+
 void cmd_help(AppState& /*state*/) {
   std::cout << "Commands:\n"
             << "  add            Add a new entry\n"
             << "  get            Show an entry\n"
             << "  update         Update the secret for an entry\n"
             << "  delete         Delete an entry\n"
-            << "  list           List all entries\n"
+            << "  list           List entries, one per line\n"
+            << "                   [--sort name|user|created|modified|used (-KEY reverses)]\n"
+            << "                   [--page N] [--page-size N] [--all]\n"
             << "  copy           Copy an entry's secret to the clipboard\n"
             << "  clip-clear     Clear the clipboard\n"
             << "  save           Force save the vault to disk\n"
             << "  change-master  Change the vault master password\n"
+            << "  calibrate      Tune the unlock cost to a target time on this machine\n"
+            << "  import         Import a CSV, Bitwarden JSON or KeePass XML export\n"
+            << "  stats          Show secure memory usage\n"
+            << "  vaults         Show the named vaults and whether they are unlocked\n"
+            << "  unlock [NAME]  Unlock named vaults (all locked ones by default), together\n"
+            << "  lock [NAME]    Lock named vaults (all by default)\n"
+            << "  search TEXT    Find entries by name or username in every unlocked vault\n"
+            << "  slots          Show the vault's key slots\n"
+            << "  add-slot password LABEL | add-slot key LABEL PUBLIC_KEY\n"
+            << "                 Let another password or key pair open the vault\n"
+            << "  remove-slot LABEL\n"
+            << "                 Revoke a key slot\n"
+            << "  keygen FILE    Create a key pair for add-slot key / pwledger-cli --identity\n"
+            << "  sync-export PEER FILE\n"
+            << "                 Write what changed since the last sync with PEER to FILE\n"
+            << "  sync-import PEER FILE\n"
+            << "                 Merge a file PEER wrote with sync-export\n"
             << "  help           Show this message\n"
-            << "  quit           Exit\n";
+            << "  quit           Exit\n"
+            << "\nget, update, delete and copy ask for an entry: type a UUID or the start of a name\n"
+            << "or username. Tab completes, a second Tab lists the matches.\n";
 }
 
 // ----------------------------------------------------------------------------
@@ -210,19 +716,44 @@ void cmd_help(AppState& /*state*/) {
 // Commands taking AppState can mutate the table and auto-save.
 void run_command_loop(AppState& state) {
   using CommandFn = void (*)(AppState&);
+  using CommandWithArgsFn = void (*)(AppState&, const std::vector<std::string>&);
 
   const std::unordered_map<std::string, CommandFn> dispatch{
       {"add", cmd_add},
       {"get", cmd_get},
       {"update", cmd_update},
       {"delete", cmd_delete},
-      {"list", cmd_list},
       {"copy", cmd_copy},
       {"clip-clear", cmd_clip_clear},
       {"save", cmd_save},
       {"change-master", cmd_change_master},
+      {"calibrate", cmd_calibrate},
+      {"import", cmd_import},
+      {"stats", cmd_stats},
+      {"vaults", cmd_vaults},
+      {"slots", cmd_slots},
       {"help", cmd_help},
   };
+  const std::unordered_map<std::string, CommandWithArgsFn> dispatch_with_args{
+      {"list", cmd_list},
+      {"unlock", cmd_unlock},
+      {"lock", cmd_lock},
+      {"search", cmd_search},
+      {"add-slot", cmd_add_slot},
+      {"remove-slot", cmd_remove_slot},
+      {"keygen", cmd_keygen},
+      {"sync-export", cmd_sync_export},
+      {"sync-import", cmd_sync_import},
+  };
+
+  // Incrementally maintained from here on by add, delete and import.
+  state.completion = CompletionIndex(state.table);
+
+  try {
+    state.vaults = VaultManager::from_config(state.config.vault);
+  } catch (const std::exception& e) {
+    std::cout << "Warning: ignoring vault.vaults in the config: " << e.what() << '\n';
+  }
 
   std::cout << "pwledger — type 'help' for available commands.\n";
 
@@ -235,25 +766,37 @@ void run_command_loop(AppState& state) {
       break;  // EOF (Ctrl-D / Ctrl-Z)
     }
 
-    // Trim leading and trailing whitespace.
-    const auto first = line.find_first_not_of(" \t\r\n");
-    const auto last = line.find_last_not_of(" \t\r\n");
-    if (first == std::string::npos) {
+    std::vector<std::string> words;
+    try {
+      words = split_command_line(line);
+    } catch (const std::exception& e) {
+      std::cout << "Error: " << e.what() << '\n';
       continue;
     }
-    const std::string cmd = line.substr(first, last - first + 1);
+    if (words.empty()) {
+      continue;
+    }
+    const std::string& cmd = words[0];
+    const std::vector<std::string> args(words.begin() + 1, words.end());
 
     if (cmd == "quit" || cmd == "exit") {
       break;
     }
 
-    const auto it = dispatch.find(cmd);
-    if (it == dispatch.end()) {
-      std::cout << "Unknown command '" << cmd << "'. Type 'help'.\n";
-      continue;
-    }
-
     try {
+      if (const auto it = dispatch_with_args.find(cmd); it != dispatch_with_args.end()) {
+        it->second(state, args);
+        continue;
+      }
+      const auto it = dispatch.find(cmd);
+      if (it == dispatch.end()) {
+        std::cout << "Unknown command '" << cmd << "'. Type 'help'.\n";
+        continue;
+      }
+      if (!args.empty()) {
+        std::cout << "Error: '" << cmd << "' takes no arguments; it asks for what it needs.\n";
+        continue;
+      }
       it->second(state);
     } catch (const std::exception& e) {
       std::cout << "Error: " << e.what() << '\n';
@@ -17,7 +17,11 @@
  */
 
 #include "Display.h"
+#include "ListView.h"
 
+#include <pwledger/MemoryStats.h>
+
+#include <cstdint>
 #include <cstring>
 #include <iomanip>
 #include <iostream>
@@ -26,20 +30,60 @@
 namespace pwledger {
 
 // ----------------------------------------------------------------------------
-// format_timepoint
+// put_timepoint / format_timepoint
 // ----------------------------------------------------------------------------
+// Converts with Howard Hinnant's civil_from_days in unsigned arithmetic
+// (times before 1970 print as the epoch) rather than gmtime, so there is no
+// time_t round trip, no locale and no platform split.
+
+namespace {
+
+char* put_digits(char* out, std::uint64_t value, std::size_t width) noexcept {
+  char* const end = out + width;
+  for (char* p = end; p != out; value /= 10) {
+    *--p = static_cast<char>('0' + value % 10);
+  }
+  return end;
+}
+
+}  // namespace
+
+char* put_timepoint(char* out, std::chrono::system_clock::time_point tp, bool seconds) noexcept {
+  const auto since_epoch = std::chrono::duration_cast<std::chrono::seconds>(tp.time_since_epoch()).count();
+  const std::uint64_t secs = since_epoch < 0 ? 0 : static_cast<std::uint64_t>(since_epoch);
+  const std::uint64_t time_of_day = secs % 86400;
+
+  // Days since 0000-03-01, in 400-year eras of 146097 days.
+  const std::uint64_t z = secs / 86400 + 719468;
+  const std::uint64_t era = z / 146097;
+  const std::uint64_t doe = z - era * 146097;
+  const std::uint64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const std::uint64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const std::uint64_t mp = (5 * doy + 2) / 153;
+  const std::uint64_t day = doy - (153 * mp + 2) / 5 + 1;
+  const std::uint64_t month = mp < 10 ? mp + 3 : mp - 9;
+  const std::uint64_t year = yoe + era * 400 + (month <= 2 ? 1 : 0);
+
+  out = put_digits(out, year, 4);
+  *out++ = '-';
+  out = put_digits(out, month, 2);
+  *out++ = '-';
+  out = put_digits(out, day, 2);
+  *out++ = ' ';
+  out = put_digits(out, time_of_day / 3600, 2);
+  *out++ = ':';
+  out = put_digits(out, time_of_day / 60 % 60, 2);
+  if (seconds) {
+    *out++ = ':';
+    out = put_digits(out, time_of_day % 60, 2);
+  }
+  return out;
+}
+
 // Formats a system_clock time_point as "YYYY-MM-DD HH:MM:SS UTC".
 std::string format_timepoint(std::chrono::system_clock::time_point tp) {
-  std::time_t t = std::chrono::system_clock::to_time_t(tp);
-  std::tm tm = {};
-#ifdef _WIN32
-  gmtime_s(&tm, &t);
-#else
-  gmtime_r(&t, &tm);
-#endif
-  std::ostringstream oss;
-  oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S UTC");
-  return oss.str();
+  char buf[kTimepointLength];
+  return std::string(buf, put_timepoint(buf, tp)) + " UTC";
 }
 
 // ----------------------------------------------------------------------------
@@ -75,17 +119,61 @@ void print_entry(const Uuid& uuid, const SecretEntry& entry) {
 // ----------------------------------------------------------------------------
 // print_table
 // ----------------------------------------------------------------------------
-// Lists all entries. Only non-sensitive fields are shown.
+// Lists all entries, one line each. Only non-sensitive fields are shown.
 void print_table(const PrimaryTable& table) {
   if (table.empty()) {
     std::cout << "(no entries)\n";
     return;
   }
-  for (const auto& [uuid, entry] : table) {
-    std::cout << "----\n";
-    print_entry(uuid, entry);
+  const ListView view(table, ListOrder{});
+  view.render(std::cout, 0, view.size());
+  std::cout.flush();
+}
+
+// ----------------------------------------------------------------------------
+// print_memory_stats
+// ----------------------------------------------------------------------------
+// Prints what the unlocked vault costs in memory. Byte counts are shown in
+// KiB; "overhead" is mapped minus requested, i.e. page rounding, canaries and
+// guard pages.
+void print_memory_stats(const PrimaryTable& table) {
+  const auto kib = [](std::uint64_t bytes) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1) << static_cast<double>(bytes) / 1024.0 << " KiB";
+    return oss.str();
+  };
+
+  const SecureMemoryStats secure = secure_memory_stats();
+  const TableMemoryStats t = measure_table(table);
+  const ProcessMemoryStats process = process_memory_stats();
+
+  std::cout << "Secure allocations : " << secure.live_allocations << " live, " << secure.total_allocations
+            << " total\n"
+            << "  requested        : " << kib(secure.requested_bytes) << '\n'
+            << "  mapped           : " << kib(secure.mapped_bytes) << " (peak " << kib(secure.peak_mapped_bytes)
+            << ")\n"
+            << "  overhead         : " << kib(secure.mapped_bytes - secure.requested_bytes) << '\n'
+            << "  guard pages      : " << kib(secure.guard_bytes) << '\n'
+            << "  locked           : " << kib(secure.locked_bytes) << '\n'
+            << "Table              : " << t.entries << " entries\n"
+            << "  secret buffers   : " << kib(t.secret_buffer_bytes) << '\n'
+            << "  strings          : " << kib(t.string_bytes) << " (" << kib(t.string_heap_bytes) << " on heap)\n"
+            << "  nodes + buckets  : " << kib(t.table_bytes) << " (estimate)\n";
+
+  if (process.locked_bytes) {
+    std::cout << "Process locked     : " << kib(*process.locked_bytes);
+    if (process.memlock_limit) {
+      std::cout << " of " << kib(*process.memlock_limit) << " RLIMIT_MEMLOCK";
+    }
+    std::cout << '\n';
+  }
+  if (process.map_count) {
+    std::cout << "Process mappings   : " << *process.map_count;
+    if (process.max_map_count) {
+      std::cout << " of " << *process.max_map_count << " vm.max_map_count";
+    }
+    std::cout << '\n';
   }
-  std::cout << "----\n";
 }
 
 }  // namespace pwledger
@@ -24,6 +24,7 @@
 #include <pwledger/uuid.h>
 
 #include <chrono>
+#include <cstddef>
 #include <string>
 
 namespace pwledger {
@@ -33,13 +34,24 @@ using Uuid = pwledger::Uuid;
 // Formats a system_clock time_point as "YYYY-MM-DD HH:MM:SS UTC".
 std::string format_timepoint(std::chrono::system_clock::time_point tp);
 
+// Writes `tp` in UTC as "YYYY-MM-DD HH:MM:SS" (kTimepointLength chars), or
+// as "YYYY-MM-DD HH:MM" (kShortTimepointLength) without seconds, and
+// returns the end. No allocation and no locale, for per-row use.
+inline constexpr std::size_t kTimepointLength = 19;
+inline constexpr std::size_t kShortTimepointLength = 16;
+char* put_timepoint(char* out, std::chrono::system_clock::time_point tp, bool seconds = true) noexcept;
+
 // Prints a human-readable summary of an entry. The secret value is never
 // printed; only its byte length is shown.
 void print_entry(const Uuid& uuid, const SecretEntry& entry);
 
-// Lists all entries. Only non-sensitive fields are shown.
+// Lists all entries, one line each, ordered by name (see ListView.h).
+// Only non-sensitive fields are shown.
 void print_table(const PrimaryTable& table);
 
+// Prints secure-memory, table and process memory figures (MemoryStats.h).
+void print_memory_stats(const PrimaryTable& table);
+
 }  // namespace pwledger
 
 #endif  // PWLEDGER_CLI_DISPLAY_H
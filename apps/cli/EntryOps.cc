@@ -48,12 +48,6 @@ bool entry_create(PrimaryTable& table, const Uuid& uuid, std::string primary_key
     return false;
   }
 
-  // 256 bytes provides 255 usable characters (the last byte holds '\0').
-  // This is sufficient for the vast majority of passwords and passphrases.
-  // It is intentionally *not* sized for SSH private keys or TLS certificates;
-  // those require a different storage model (file-backed, streaming) rather
-  // than a single contiguous sodium_malloc buffer.
-  constexpr std::size_t kMaxSecretBytes = 256;
   constexpr std::size_t kSaltBytes = crypto_pwhash_SALTBYTES;
 
   SecretEntry entry(std::move(primary_key), std::move(username_or_email), kMaxSecretBytes, kSaltBytes);
@@ -0,0 +1,283 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "EntryPicker.h"
+
+#include <pwledger/TerminalManager.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace pwledger {
+
+namespace {
+
+// Matches listed by a double Tab or offered as numbered choices.
+constexpr std::size_t kMaxListed = 20;
+
+constexpr char kTab = '\t';
+constexpr char kCtrlD = 4;
+constexpr char kCtrlU = 21;
+constexpr char kEscape = 27;
+constexpr char kBackspace = 8;
+constexpr char kDelete = 127;
+
+bool stdin_is_terminal() {
+#ifdef _WIN32
+  return _isatty(_fileno(stdin)) != 0;
+#else
+  return ::isatty(STDIN_FILENO) != 0;
+#endif
+}
+
+bool is_continuation(char c) { return (static_cast<unsigned char>(c) & 0xC0) == 0x80; }
+
+std::size_t columns(std::string_view s) {
+  std::size_t n = 0;
+  for (const char c : s) {
+    if (!is_continuation(c)) {
+      ++n;
+    }
+  }
+  return n;
+}
+
+std::string describe(const PrimaryTable& table, const Uuid& uuid) {
+  const auto it = table.find(uuid);
+  if (it == table.end()) {
+    return uuid.to_string();
+  }
+  std::string text = it->second.primary_key;
+  if (!it->second.username_or_email.empty()) {
+    text += " <" + it->second.username_or_email + ">";
+  }
+  return text;
+}
+
+std::string_view trim(std::string_view s) {
+  const auto first = s.find_first_not_of(" \t\r\n");
+  if (first == std::string_view::npos) {
+    return {};
+  }
+  return s.substr(first, s.find_last_not_of(" \t\r\n") - first + 1);
+}
+
+}  // namespace
+
+// ============================================================================
+// EntryLineEditor
+// ============================================================================
+
+EntryLineEditor::EntryLineEditor(const PrimaryTable& table,
+                                 const CompletionIndex& index,
+                                 std::ostream& out,
+                                 std::string prompt)
+    : table_(table), out_(out), prompt_(std::move(prompt)), cursor_(index.cursor()) {}
+
+void EntryLineEditor::draw() {
+  std::string hint;
+  if (!text_.empty()) {
+    if (!cursor_.matches()) {
+      hint = "  (no match)";
+    } else if (const auto first = cursor_.candidates(2); first.size() == 1) {
+      hint = "  -> " + describe(table_, first.front());
+    } else {
+      hint = "  (" + std::to_string(cursor_.count()) + " matches)";
+    }
+  }
+
+  // Clear the line, redraw, and put the terminal cursor back after the text.
+  out_ << "\r\033[K" << prompt_ << text_;
+  if (!hint.empty()) {
+    out_ << "\033[2m" << hint << "\033[0m\033[" << columns(hint) << 'D';
+  }
+  out_.flush();
+}
+
+void EntryLineEditor::push(std::string_view s) {
+  text_ += s;
+  cursor_.push(s);
+}
+
+void EntryLineEditor::list_matches() {
+  const auto matches = cursor_.candidates(kMaxListed + 1);
+  out_ << "\r\033[K";
+  for (std::size_t i = 0; i < matches.size() && i < kMaxListed; ++i) {
+    out_ << "  " << describe(table_, matches[i]) << '\n';
+  }
+  if (matches.size() > kMaxListed) {
+    out_ << "  ... type more to narrow " << cursor_.count() << " matches\n";
+  }
+}
+
+EntryLineEditor::Status EntryLineEditor::feed(char c) {
+  // Escape sequences (arrow keys, Home, ...) are skipped whole: ESC, then
+  // '[' or 'O', then parameters up to a final byte in 0x40-0x7E.
+  if (escape_ == 1) {
+    escape_ = (c == '[' || c == 'O') ? 2 : 0;
+    return Status::kEditing;
+  }
+  if (escape_ == 2) {
+    escape_ = (c >= 0x40 && c <= 0x7E) ? 0 : 2;
+    return Status::kEditing;
+  }
+
+  const bool tab = c == kTab;
+  switch (c) {
+    case '\r':
+    case '\n':
+      out_ << "\r\033[K" << prompt_ << text_ << '\n';
+      out_.flush();
+      return Status::kDone;
+    case kCtrlD:
+      if (text_.empty()) {
+        out_ << '\n';
+        return Status::kCancelled;
+      }
+      break;
+    case kTab:
+      if (const std::string extension = cursor_.completion(); !extension.empty()) {
+        push(extension);
+      } else if (last_was_tab_ && cursor_.count() > 0) {
+        list_matches();
+      }
+      break;
+    case kBackspace:
+    case kDelete:
+      // One code point: its continuation bytes, then its lead byte.
+      while (!text_.empty() && is_continuation(text_.back())) {
+        text_.pop_back();
+        cursor_.pop();
+      }
+      if (!text_.empty()) {
+        text_.pop_back();
+        cursor_.pop();
+      }
+      break;
+    case kCtrlU:
+      text_.clear();
+      cursor_.reset();
+      break;
+    case kEscape:
+      escape_ = 1;
+      break;
+    default:
+      if (static_cast<unsigned char>(c) >= 0x20) {
+        push(std::string_view(&c, 1));
+      }
+      break;
+  }
+  last_was_tab_ = tab;
+  draw();
+  return Status::kEditing;
+}
+
+// ============================================================================
+// resolve_entry / pick_entry
+// ============================================================================
+
+std::optional<Uuid> resolve_entry(const PrimaryTable& table,
+                                  const CompletionIndex& index,
+                                  std::string_view text,
+                                  std::istream& in,
+                                  std::ostream& out) {
+  text = trim(text);
+  if (text.empty()) {
+    out << "Cancelled.\n";
+    return std::nullopt;
+  }
+  if (auto uuid = Uuid::from_string(text)) {
+    return uuid;
+  }
+
+  auto cursor = index.cursor();
+  cursor.push(text);
+  std::vector<Uuid> choices = cursor.exact();
+  if (choices.size() == 1) {
+    return choices.front();
+  }
+  if (choices.empty()) {
+    choices = cursor.candidates(kMaxListed + 1);
+  }
+  if (choices.empty()) {
+    out << "Error: no entry matches '" << text << "'.\n";
+    return std::nullopt;
+  }
+  if (choices.size() == 1) {
+    return choices.front();
+  }
+
+  const std::size_t shown = std::min(choices.size(), kMaxListed);
+  for (std::size_t i = 0; i < shown; ++i) {
+    out << "  " << (i + 1) << ") " << describe(table, choices[i]) << "  " << choices[i] << '\n';
+  }
+  if (choices.size() > kMaxListed) {
+    out << "  (more match '" << text << "'; type more of the name to narrow them)\n";
+  }
+  out << "Number [1-" << shown << "]: " << std::flush;
+
+  std::string answer;
+  std::getline(in, answer);
+  const std::string_view number = trim(answer);
+  std::size_t choice = 0;
+  const auto [end, ec] = std::from_chars(number.data(), number.data() + number.size(), choice);
+  if (ec != std::errc() || end != number.data() + number.size() || choice == 0 || choice > shown) {
+    out << "Cancelled.\n";
+    return std::nullopt;
+  }
+  return choices[choice - 1];
+}
+
+std::optional<Uuid> pick_entry(const AppState& state) {
+  constexpr const char* kPrompt = "Entry (name, username or UUID): ";
+  if (!stdin_is_terminal()) {
+    std::cout << kPrompt;
+    std::string line;
+    std::getline(std::cin, line);
+    return resolve_entry(state.table, state.completion, line, std::cin, std::cout);
+  }
+
+  std::string text;
+  {
+    TerminalManager_v raw_input;
+    EntryLineEditor editor(state.table, state.completion, std::cout, kPrompt);
+    editor.draw();
+    EntryLineEditor::Status status = EntryLineEditor::Status::kEditing;
+    char c = 0;
+    while (status == EntryLineEditor::Status::kEditing && std::cin.get(c)) {
+      status = editor.feed(c);
+    }
+    if (status != EntryLineEditor::Status::kDone) {
+      std::cout << "Cancelled.\n";
+      return std::nullopt;
+    }
+    text = editor.text();
+  }
+  return resolve_entry(state.table, state.completion, text, std::cin, std::cout);
+}
+
+}  // namespace pwledger
@@ -0,0 +1,107 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PWLEDGER_CLI_ENTRY_PICKER_H
+#define PWLEDGER_CLI_ENTRY_PICKER_H
+
+#include "AppState.h"
+
+#include <pwledger/CompletionIndex.h>
+#include <pwledger/PrimaryTable.h>
+#include <pwledger/uuid.h>
+
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// ============================================================================
+// DESIGN NOTES
+// ============================================================================
+//
+// get, update, delete and copy ask which entry to act on. The answer can
+// be a UUID, as before, or any prefix of a primary key or username/email:
+//
+//   Entry: git            (3 matches)
+//   Entry: github.com     → github.com <alice@example.com>
+//
+// On a terminal the prompt is a small line editor over a
+// CompletionIndex::Cursor (no readline): each keystroke moves the cursor
+// one character and redraws the hint, Tab inserts what every match has in
+// common, a second Tab lists the matches, Backspace removes a character,
+// Ctrl-U clears the line and Ctrl-D on an empty line cancels. The terminal
+// is put in non-canonical, no-echo mode with TerminalManager_v and the
+// editor echoes what it accepts.
+//
+// Without a terminal (input piped in) the line is read whole, so scripts
+// that feed UUIDs keep working.
+//
+// Enter resolves the text: a UUID is taken as is; otherwise an entry
+// whose key equals the text, or the only entry with a key starting with
+// it. When several remain, they are listed with numbers to choose from.
+//
+// ============================================================================
+
+namespace pwledger {
+
+class EntryLineEditor {
+public:
+  enum class Status {
+    kEditing,
+    kDone,
+    kCancelled,
+  };
+
+  EntryLineEditor(const PrimaryTable& table, const CompletionIndex& index, std::ostream& out, std::string prompt);
+
+  // Draws the prompt, the text and the hint on the current line.
+  void draw();
+
+  // Handles one byte of input and redraws.
+  Status feed(char c);
+
+  [[nodiscard]] const std::string& text() const noexcept { return text_; }
+
+private:
+  void push(std::string_view s);
+  void list_matches();
+
+  const PrimaryTable& table_;
+  std::ostream& out_;
+  std::string prompt_;
+  std::string text_;
+  CompletionIndex::Cursor cursor_;
+  bool last_was_tab_ = false;
+  int escape_ = 0;  // 1: after ESC, 2: inside an escape sequence
+};
+
+// Resolves `text` as described above. A numbered choice is read from `in`;
+// messages go to `out`. Returns std::nullopt, having said why, if no single
+// entry was chosen.
+std::optional<Uuid> resolve_entry(const PrimaryTable& table,
+                                  const CompletionIndex& index,
+                                  std::string_view text,
+                                  std::istream& in,
+                                  std::ostream& out);
+
+// Prompts on stdin/stdout and resolves the answer.
+std::optional<Uuid> pick_entry(const AppState& state);
+
+}  // namespace pwledger
+
+#endif  // PWLEDGER_CLI_ENTRY_PICKER_H
@@ -0,0 +1,298 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ListView.h"
+#include "Display.h"
+
+#include <pwledger/uuid.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+namespace pwledger {
+
+namespace {
+
+constexpr std::size_t kFlushBytes = 64 * 1024;
+constexpr std::size_t kMinTextWidth = 4;
+constexpr std::size_t kMaxTextWidth = 32;
+constexpr std::size_t kColumnGap = 2;
+constexpr std::string_view kEllipsis = "\xE2\x80\xA6";  // U+2026
+
+// ----------------------------------------------------------------------------
+// Ordering
+// ----------------------------------------------------------------------------
+
+using Row = ListView::Row;
+
+bool name_then_uuid(Row a, Row b) {
+  if (const int c = a->second.primary_key.compare(b->second.primary_key); c != 0) {
+    return c < 0;
+  }
+  return a->first < b->first;
+}
+
+template <typename Less>
+void order_rows(std::vector<Row>& rows, std::size_t limit, bool descending, Less less) {
+  const auto cmp = [&](Row a, Row b) { return descending ? less(b, a) : less(a, b); };
+  if (limit < rows.size()) {
+    std::partial_sort(rows.begin(), rows.begin() + static_cast<std::ptrdiff_t>(limit), rows.end(), cmp);
+  } else {
+    std::sort(rows.begin(), rows.end(), cmp);
+  }
+}
+
+template <typename Field>
+auto by_time(Field field) {
+  return [field](Row a, Row b) {
+    const auto ta = field(a->second.metadata);
+    const auto tb = field(b->second.metadata);
+    return ta != tb ? ta < tb : name_then_uuid(a, b);
+  };
+}
+
+// ----------------------------------------------------------------------------
+// Text columns
+// ----------------------------------------------------------------------------
+
+// Display width in UTF-8 code points (continuation bytes don't count).
+std::size_t text_width(std::string_view s) noexcept {
+  std::size_t width = 0;
+  for (const char c : s) {
+    width += (static_cast<unsigned char>(c) & 0xC0) != 0x80 ? 1 : 0;
+  }
+  return width;
+}
+
+// Appends `s` padded or cut to exactly `width` columns.
+void put_text(std::string& buf, std::string_view s, std::size_t width) {
+  const std::size_t w = text_width(s);
+  if (w <= width) {
+    buf.append(s);
+    buf.append(width - w, ' ');
+    return;
+  }
+  // Keep width - 1 code points, then the ellipsis.
+  std::size_t kept = 0;
+  std::size_t end = 0;
+  for (; end < s.size(); ++end) {
+    if ((static_cast<unsigned char>(s[end]) & 0xC0) != 0x80 && kept++ == width - 1) {
+      break;
+    }
+  }
+  buf.append(s.substr(0, end));
+  buf.append(kEllipsis);
+}
+
+std::size_t fit_width(std::size_t widest, std::string_view header) {
+  return std::clamp(std::max(widest, header.size()), kMinTextWidth, kMaxTextWidth);
+}
+
+std::size_t parse_count(const std::string& option, const std::string& value) {
+  std::size_t n = 0;
+  const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), n);
+  if (ec != std::errc() || end != value.data() + value.size() || n == 0) {
+    throw std::invalid_argument(option + " needs a positive number, not '" + value + "'");
+  }
+  return n;
+}
+
+}  // namespace
+
+// ============================================================================
+// Options
+// ============================================================================
+
+std::optional<ListOrder> parse_list_order(std::string_view text) {
+  ListOrder order;
+  if (text.starts_with('-')) {
+    order.descending = true;
+    text.remove_prefix(1);
+  }
+  if (text == "name") {
+    order.key = ListSortKey::kName;
+  } else if (text == "user") {
+    order.key = ListSortKey::kUser;
+  } else if (text == "created") {
+    order.key = ListSortKey::kCreated;
+  } else if (text == "modified") {
+    order.key = ListSortKey::kModified;
+  } else if (text == "used") {
+    order.key = ListSortKey::kUsed;
+  } else {
+    return std::nullopt;
+  }
+  return order;
+}
+
+ListOptions parse_list_options(const std::vector<std::string>& args) {
+  ListOptions options;
+  for (std::size_t i = 0; i < args.size(); ++i) {
+    const std::string& option = args[i];
+    if (option == "--all") {
+      options.all = true;
+      continue;
+    }
+    if (option != "--sort" && option != "--page" && option != "--page-size") {
+      throw std::invalid_argument("unknown option '" + option + "' (try --sort, --page, --page-size, --all)");
+    }
+    if (i + 1 == args.size()) {
+      throw std::invalid_argument(option + " needs a value");
+    }
+    const std::string& value = args[++i];
+    if (option == "--sort") {
+      const auto order = parse_list_order(value);
+      if (!order) {
+        throw std::invalid_argument("cannot sort by '" + value +
+                                    "' (name, user, created, modified, used; '-' reverses)");
+      }
+      options.order = *order;
+    } else if (option == "--page") {
+      options.page = parse_count(option, value);
+    } else {
+      options.page_size = parse_count(option, value);
+    }
+  }
+  return options;
+}
+
+// ============================================================================
+// ListView
+// ============================================================================
+
+ListView::ListView(const PrimaryTable& table, ListOrder order, std::size_t limit) {
+  rows_.reserve(table.size());
+  for (const auto& row : table) {
+    rows_.push_back(&row);
+  }
+
+  switch (order.key) {
+    case ListSortKey::kUser:
+      order_rows(rows_, limit, order.descending, [](Row a, Row b) {
+        const int c = a->second.username_or_email.compare(b->second.username_or_email);
+        return c != 0 ? c < 0 : name_then_uuid(a, b);
+      });
+      break;
+    case ListSortKey::kCreated:
+      order_rows(rows_, limit, order.descending, by_time([](const auto& m) { return m.created_at; }));
+      break;
+    case ListSortKey::kModified:
+      order_rows(rows_, limit, order.descending, by_time([](const auto& m) { return m.last_modified_at; }));
+      break;
+    case ListSortKey::kUsed:
+      order_rows(rows_, limit, order.descending, by_time([](const auto& m) { return m.last_used_at; }));
+      break;
+    case ListSortKey::kName:
+    default:
+      order_rows(rows_, limit, order.descending, name_then_uuid);
+      break;
+  }
+}
+
+void ListView::render(std::ostream& out, std::size_t begin, std::size_t end) const {
+  end = std::min(end, rows_.size());
+  begin = std::min(begin, end);
+
+  constexpr std::string_view kName = "NAME";
+  constexpr std::string_view kUser = "USERNAME";
+  std::size_t widest_name = 0;
+  std::size_t widest_user = 0;
+  for (std::size_t i = begin; i < end; ++i) {
+    widest_name = std::max(widest_name, text_width(rows_[i]->second.primary_key));
+    widest_user = std::max(widest_user, text_width(rows_[i]->second.username_or_email));
+  }
+  const std::size_t name_width = fit_width(widest_name, kName);
+  const std::size_t user_width = fit_width(widest_user, kUser);
+
+  std::string buf;
+  buf.reserve(kFlushBytes + 512);
+  const std::string gap(kColumnGap, ' ');
+
+  put_text(buf, kName, name_width);
+  buf += gap;
+  put_text(buf, kUser, user_width);
+  buf += gap;
+  put_text(buf, "MODIFIED", kShortTimepointLength);
+  buf += gap;
+  put_text(buf, "LAST USED", kShortTimepointLength);
+  buf += gap;
+  buf += "UUID\n";
+
+  char fixed[kShortTimepointLength * 2 + kColumnGap * 2 + Uuid::kStringLength + 1];
+  for (std::size_t i = begin; i < end; ++i) {
+    const auto& [uuid, entry] = *rows_[i];
+    put_text(buf, entry.primary_key, name_width);
+    buf += gap;
+    put_text(buf, entry.username_or_email, user_width);
+    buf += gap;
+
+    char* p = put_timepoint(fixed, entry.metadata.last_modified_at, false);
+    p = std::fill_n(p, kColumnGap, ' ');
+    p = put_timepoint(p, entry.metadata.last_used_at, false);
+    p = std::fill_n(p, kColumnGap, ' ');
+    p = uuid.to_chars(p);
+    *p++ = '\n';
+    buf.append(fixed, p);
+
+    if (buf.size() >= kFlushBytes) {
+      out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+      buf.clear();
+    }
+  }
+  out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+}
+
+// ============================================================================
+// terminal_rows
+// ============================================================================
+
+std::optional<std::size_t> terminal_rows() {
+#ifdef _WIN32
+  if (_isatty(_fileno(stdout)) == 0) {
+    return std::nullopt;
+  }
+  CONSOLE_SCREEN_BUFFER_INFO info;
+  if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info) == 0) {
+    return std::size_t{24};
+  }
+  return static_cast<std::size_t>(info.srWindow.Bottom - info.srWindow.Top + 1);
+#else
+  if (::isatty(STDOUT_FILENO) == 0) {
+    return std::nullopt;
+  }
+  winsize ws{};
+  if (::ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) != 0 || ws.ws_row == 0) {
+    return std::size_t{24};
+  }
+  return static_cast<std::size_t>(ws.ws_row);
+#endif
+}
+
+}  // namespace pwledger
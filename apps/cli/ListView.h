@@ -0,0 +1,118 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PWLEDGER_CLI_LIST_VIEW_H
+#define PWLEDGER_CLI_LIST_VIEW_H
+
+#include <pwledger/PrimaryTable.h>
+
+#include <cstddef>
+#include <iosfwd>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ============================================================================
+// DESIGN NOTES
+// ============================================================================
+//
+// The `list` engine: one compact line per entry,
+//
+//   NAME         USERNAME            MODIFIED          LAST USED         UUID
+//   bank         alice@example.com   2026-03-01 09:12  2026-10-17 18:40  0196...
+//
+// in a chosen order, a page at a time.
+//
+// COST
+// ----
+// A ListView holds pointers to the table's entries, not copies, and
+// orders only as many of them as will be shown: page p of size s costs
+// O(n log(p*s)) with a partial sort rather than O(n log n). Rows are
+// formatted into one buffer with std::to_chars, Uuid::to_chars and
+// put_timepoint - no ostringstream, no locale, no allocation per row - and
+// the buffer goes to the stream in 64 KiB writes.
+//
+// Nothing here reads a Secret: a listing never unprotects secret memory
+// (print_entry still does, to show one entry's secret length).
+//
+// Column widths are fitted to the rows being shown, up to a cap past which
+// a value is cut with "…". Widths count UTF-8 code points, not bytes.
+//
+// ============================================================================
+
+namespace pwledger {
+
+enum class ListSortKey {
+  kName,      // primary key
+  kUser,      // username or email
+  kCreated,
+  kModified,
+  kUsed,
+};
+
+struct ListOrder {
+  ListSortKey key = ListSortKey::kName;
+  bool descending = false;
+};
+
+// "name", "user", "created", "modified" or "used"; a leading '-' reverses
+// the order. Returns std::nullopt for anything else.
+std::optional<ListOrder> parse_list_order(std::string_view text);
+
+// Arguments of the interactive `list` command.
+struct ListOptions {
+  ListOrder order;
+  std::size_t page = 0;       // 1-based; 0 = no explicit page
+  std::size_t page_size = 0;  // 0 = fit the terminal (or 50)
+  bool all = false;           // no pager, even on a terminal
+};
+
+// Parses `--sort KEY`, `--page N`, `--page-size N` and `--all`. Throws
+// std::invalid_argument on anything else.
+ListOptions parse_list_options(const std::vector<std::string>& args);
+
+class ListView {
+public:
+  using Row = const PrimaryTable::value_type*;
+
+  static constexpr std::size_t kAll = std::numeric_limits<std::size_t>::max();
+
+  // Orders the first `limit` entries of `table` by `order`; rows past
+  // `limit` are in no particular order. Ties break by name, then UUID, so
+  // the order is stable across calls.
+  ListView(const PrimaryTable& table, ListOrder order, std::size_t limit = kAll);
+
+  [[nodiscard]] std::size_t size() const noexcept { return rows_.size(); }
+  [[nodiscard]] Row operator[](std::size_t i) const noexcept { return rows_[i]; }
+
+  // Writes a header and rows [begin, end) to `out`.
+  void render(std::ostream& out, std::size_t begin, std::size_t end) const;
+
+private:
+  std::vector<Row> rows_;
+};
+
+// Rows on the terminal stdout is attached to; std::nullopt when stdout is
+// not a terminal.
+std::optional<std::size_t> terminal_rows();
+
+}  // namespace pwledger
+
+#endif  // PWLEDGER_CLI_LIST_VIEW_H
@@ -119,6 +119,28 @@ std::size_t prompt_secret(std::string_view prompt, Secret& out, std::size_t max_
   return n;
 }
 
+// ----------------------------------------------------------------------------
+// save_vault
+// ----------------------------------------------------------------------------
+// Saves the vault with the session's master password and KDF parameters,
+// or, for a key-slot vault, the data key unlocking it handed back (no
+// Argon2id per save), or its key pair. Used as the persist step of a
+// Transaction, which needs the failure.
+void save_vault(const AppState& state) {
+  if (state.data_key) {
+    VaultIO::save_vault(state.vault_path, state.table, *state.data_key);
+    return;
+  }
+  if (state.identity) {
+    VaultIO::save_vault(state.vault_path, state.table, *state.identity);
+    return;
+  }
+  state.master_password.with_read_access([&](std::span<const char> buf) {
+    std::size_t len = ::strnlen(buf.data(), buf.size());
+    VaultIO::save_vault(state.vault_path, state.table, std::string_view(buf.data(), len), state.kdf);
+  });
+}
+
 // ----------------------------------------------------------------------------
 // save_vault_safe
 // ----------------------------------------------------------------------------
@@ -126,10 +148,7 @@ std::size_t prompt_secret(std::string_view prompt, Secret& out, std::size_t max_
 // throw, so the command loop can continue.
 void save_vault_safe(const AppState& state) {
   try {
-    state.master_password.with_read_access([&](std::span<const char> buf) {
-      std::size_t len = ::strnlen(buf.data(), buf.size());
-      VaultIO::save_vault(state.vault_path, state.table, std::string_view(buf.data(), len));
-    });
+    save_vault(state);
   } catch (const std::exception& e) {
     std::cerr << "Warning: Failed to save vault: " << e.what() << '\n';
   }
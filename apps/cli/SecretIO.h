@@ -37,6 +37,9 @@ std::size_t read_secret_from_stdin(Secret& out, std::size_t max_bytes);
 // std::runtime_error on confirmation mismatch.
 std::size_t prompt_secret(std::string_view prompt, Secret& out, std::size_t max_bytes, bool confirm = false);
 
+// Saves the vault. Throws whatever VaultIO::save_vault throws.
+void save_vault(const AppState& state);
+
 // Attempts to save the vault. Prints a warning on failure but does not throw.
 void save_vault_safe(const AppState& state);
 
@@ -17,18 +17,23 @@
  */
 
 #include "AppState.h"
+#include "BatchMode.h"
 #include "CommandLoop.h"
 #include "SecretIO.h"
 
 #include <pwledger/Config.h>
 #include <pwledger/ProcessHardening.h>
 #include <pwledger/Secret.h>
+#include <pwledger/SecretEntry.h>
+#include <pwledger/ThreadPool.h>
 #include <pwledger/VaultIO.h>
 #include <pwledger/VaultPath.h>
 
 #include <cstring>
 #include <iostream>
 #include <span>
+#include <string>
+#include <vector>
 
 #include <sodium.h>
 
@@ -36,7 +41,7 @@
 // Entry point
 // ============================================================================
 
-int main() {
+int main(int argc, char* argv[]) {
   // Process hardening must happen before any Secret is constructed.
   // See harden_process() and "KNOWN LIMITATIONS" in Secret.h.
   pwledger::harden_process();
@@ -57,6 +62,12 @@ int main() {
     std::cerr << "Warning: Failed to load config: " << e.what()
               << ". Using defaults.\n";
   }
+  pwledger::ThreadPool::configure_shared(state.config.thread_pool);
+
+  // Any argument selects the non-interactive mode (see BatchMode.h).
+  if (argc > 1) {
+    return pwledger::run_batch_main(state, std::vector<std::string>(argv + 1, argv + argc));
+  }
 
   try {
     auto vault_dir = pwledger::resolve_vault_dir(state.config.vault);
@@ -72,14 +83,18 @@ int main() {
     bool loaded = false;
     // Allow up to 3 attempts
     for (int attempts = 0; attempts < 3; ++attempts) {
-      pwledger::Secret pwd(256);
-      pwledger::prompt_secret("Master password", pwd, 256);
+      pwledger::Secret pwd(pwledger::kMaxSecretBytes);
+      pwledger::prompt_secret("Master password", pwd, pwledger::kMaxSecretBytes);
       try {
         pwd.with_read_access([&](std::span<const char> buf) {
           std::size_t len = ::strnlen(buf.data(), buf.size());
-          pwledger::PrimaryTable t = pwledger::VaultIO::load_vault(state.vault_path, std::string_view(buf.data(), len));
+          pwledger::PrimaryTable t =
+              pwledger::VaultIO::load_vault(state.vault_path, std::string_view(buf.data(), len), state.data_key);
           state.table = std::move(t);
         });
+        // A vault from before KDF parameters were recorded was sealed with
+        // the defaults; the next save writes them into its header.
+        state.kdf = pwledger::VaultIO::stored_kdf_params(state.vault_path).value_or(pwledger::KdfParams{});
         state.master_password = std::move(pwd);
         loaded = true;
         std::cout << "Vault loaded successfully (" << state.table.size() << " entries).\n";
@@ -95,8 +110,8 @@ int main() {
   } else {
     std::cout << "No existing vault found at " << state.vault_path << ".\n";
     std::cout << "Creating a new vault.\n";
-    pwledger::Secret pwd(256);
-    pwledger::prompt_secret("Set master password", pwd, 256, /*confirm=*/true);
+    pwledger::Secret pwd(pwledger::kMaxSecretBytes);
+    pwledger::prompt_secret("Set master password", pwd, pwledger::kMaxSecretBytes, /*confirm=*/true);
     state.master_password = std::move(pwd);
     pwledger::save_vault_safe(state);
     std::cout << "Vault created.\n";
@@ -0,0 +1,336 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "SyntheticVault.h"
+
+#include <pwledger/VaultIO.h>
+#include <pwledger/VaultSerializer.h>
+
+#include <sodium.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+namespace pwledger::gen {
+
+namespace {
+
+// ----------------------------------------------------------------------------
+// Distribution constants
+// ----------------------------------------------------------------------------
+
+// Usernames: share of entries using one of the personal addresses, a
+// site-specific handle, or a one-off address. Remainder: one-off address.
+constexpr double kSharedEmailShare = 0.65;
+constexpr double kHandleShare = 0.20;
+constexpr std::size_t kPersonalEmails = 4;
+
+// Secrets: human-chosen (short, often reused), generated, or long generated
+// passphrase-style. Remainder: long.
+constexpr double kHumanSecretShare = 0.35;
+constexpr double kGeneratedSecretShare = 0.50;
+constexpr double kHumanReuseShare = 0.40;
+constexpr std::size_t kReusedPasswords = 6;
+
+constexpr double kNoteShare = 0.12;
+constexpr double kExpiryShare = 0.10;
+constexpr double kTwoFaShare = 0.30;
+constexpr double kSubdomainShare = 0.25;
+constexpr double kUnmodifiedShare = 0.60;
+
+constexpr std::int64_t kDay = 24 * 60 * 60;
+constexpr std::int64_t kMaxAge = 5 * 365 * kDay;
+
+constexpr std::string_view kConsonants = "bcdfghjklmnprstvwz";
+constexpr std::string_view kVowels = "aeiou";
+constexpr std::string_view kAlnum = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+constexpr std::string_view kPrintable =
+    "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789!#$%&*+-=?@^_~";
+constexpr std::string_view kSymbols = "!#$%&*?@";
+
+constexpr std::string_view kSubdomains[] = {"login.", "accounts.", "app.", "my.", "secure.", "www."};
+
+struct Weighted {
+  std::string_view value;
+  unsigned weight;
+};
+
+constexpr Weighted kTlds[] = {
+    {".com", 55}, {".org", 8}, {".net", 8}, {".io", 7}, {".edu", 5},
+    {".de", 4},   {".co.uk", 4}, {".dev", 3}, {".app", 3}, {".fr", 3},
+};
+
+constexpr Weighted kMailProviders[] = {
+    {"gmail.com", 50}, {"outlook.com", 20}, {"yahoo.com", 10}, {"proton.me", 10}, {"icloud.com", 10},
+};
+
+constexpr std::string_view kNoteTemplates[] = {
+    "Security question answer stored offline",
+    "Recovery codes in the safe",
+    "Shared with family",
+    "Work account - rotate quarterly",
+    "Old account, consider deleting",
+    "PIN is separate",
+    "Billing contact",
+};
+
+std::string_view pick_weighted(SyntheticRng& rng, std::span<const Weighted> table) {
+  unsigned total = 0;
+  for (const Weighted& w : table) {
+    total += w.weight;
+  }
+  std::uint64_t r = rng.below(total);
+  for (const Weighted& w : table) {
+    if (r < w.weight) {
+      return w.value;
+    }
+    r -= w.weight;
+  }
+  return table.back().value;
+}
+
+char pick_char(SyntheticRng& rng, std::string_view set) {
+  return set[rng.below(set.size())];
+}
+
+std::chrono::system_clock::time_point at(std::int64_t epoch_seconds) {
+  return std::chrono::system_clock::time_point{std::chrono::seconds{epoch_seconds}};
+}
+
+std::uint64_t splitmix64(std::uint64_t& state) noexcept {
+  std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+constexpr std::uint64_t rotl(std::uint64_t x, int k) noexcept {
+  return (x << k) | (x >> (64 - k));
+}
+
+}  // anonymous namespace
+
+// ============================================================================
+// SyntheticRng
+// ============================================================================
+
+SyntheticRng::SyntheticRng(std::uint64_t seed) noexcept {
+  for (auto& word : s_) {
+    word = splitmix64(seed);
+  }
+}
+
+std::uint64_t SyntheticRng::next() noexcept {
+  const std::uint64_t result = rotl(s_[1] * 5, 7) * 9;
+  const std::uint64_t t = s_[1] << 17;
+  s_[2] ^= s_[0];
+  s_[3] ^= s_[1];
+  s_[1] ^= s_[2];
+  s_[0] ^= s_[3];
+  s_[2] ^= t;
+  s_[3] = rotl(s_[3], 45);
+  return result;
+}
+
+bool SyntheticRng::chance(double p) noexcept {
+  // 53 random bits -> [0, 1)
+  return static_cast<double>(next() >> 11) * 0x1.0p-53 < p;
+}
+
+// ============================================================================
+// SyntheticVaultGenerator
+// ============================================================================
+
+SyntheticVaultGenerator::SyntheticVaultGenerator(std::uint64_t seed) : rng_(seed) {
+  for (std::size_t i = 0; i < kPersonalEmails; ++i) {
+    personal_emails_.push_back(make_word(4, 8) + "." + make_word(4, 9) + "@" +
+                               std::string(pick_weighted(rng_, kMailProviders)));
+  }
+  for (std::size_t i = 0; i < kReusedPasswords; ++i) {
+    std::string pw = make_word(5, 9);
+    pw[0] = static_cast<char>(pw[0] - 'a' + 'A');
+    pw += std::to_string(rng_.below(10000));
+    pw += pick_char(rng_, kSymbols);
+    reused_passwords_.push_back(std::move(pw));
+  }
+}
+
+SecretEntry SyntheticVaultGenerator::make_entry() {
+  return SecretEntry("", "", kSecretBytes, VaultCrypto::kSaltBytes);
+}
+
+Uuid SyntheticVaultGenerator::next(SecretEntry& entry) {
+  Uuid uuid;
+  const std::uint64_t hi = rng_.next();
+  const std::uint64_t lo = rng_.next();
+  std::memcpy(uuid.bytes.data(), &hi, 8);
+  std::memcpy(uuid.bytes.data() + 8, &lo, 8);
+  uuid.bytes[6] = static_cast<std::uint8_t>((uuid.bytes[6] & 0x0F) | 0x40);  // version 4
+  uuid.bytes[8] = static_cast<std::uint8_t>((uuid.bytes[8] & 0x3F) | 0x80);  // RFC 4122 variant
+
+  entry.primary_key = make_primary_key();
+  entry.username_or_email = make_username(entry.primary_key);
+
+  int strength = 0;
+  entry.plaintext_secret.with_write_access([&](std::span<char> buf) { strength = make_secret(buf); });
+  entry.salt.with_write_access([&](std::span<char> buf) {
+    for (char& c : buf) {
+      c = static_cast<char>(rng_.next() & 0xFF);
+    }
+  });
+
+  const std::int64_t created = kReferenceTime - static_cast<std::int64_t>(rng_.below(kMaxAge));
+  const std::int64_t modified =
+      rng_.chance(kUnmodifiedShare)
+          ? created
+          : created + static_cast<std::int64_t>(rng_.below(static_cast<std::uint64_t>(kReferenceTime - created) + 1));
+  const std::int64_t used =
+      modified + static_cast<std::int64_t>(rng_.below(static_cast<std::uint64_t>(kReferenceTime - modified) + 1));
+  entry.metadata.created_at = at(created);
+  entry.metadata.last_modified_at = at(modified);
+  entry.metadata.last_used_at = at(used);
+
+  entry.security_policy.strength_score = strength;
+  entry.security_policy.reuse_count = 0;  // populated by an audit pass, not at creation
+  entry.security_policy.two_fa_enabled = rng_.chance(kTwoFaShare);
+  if (rng_.chance(kExpiryShare)) {
+    // Anywhere from 90 days overdue to a year out.
+    entry.security_policy.expires_at = at(kReferenceTime - 90 * kDay + static_cast<std::int64_t>(rng_.below(455 * kDay)));
+  } else {
+    entry.security_policy.expires_at.reset();
+  }
+  entry.security_policy.note = rng_.chance(kNoteShare) ? make_note() : std::string{};
+
+  return uuid;
+}
+
+std::string SyntheticVaultGenerator::make_word(std::size_t min_len, std::size_t max_len) {
+  const std::size_t len = rng_.between(min_len, max_len);
+  std::string w;
+  w.reserve(len);
+  for (std::size_t i = 0; i < len; ++i) {
+    w += pick_char(rng_, (i % 2 == 0) ? kConsonants : kVowels);
+  }
+  return w;
+}
+
+std::string SyntheticVaultGenerator::make_primary_key() {
+  std::string key;
+  if (rng_.chance(kSubdomainShare)) {
+    key = kSubdomains[rng_.below(std::size(kSubdomains))];
+  }
+  // Triangular length distribution over 3..13, mode around 8.
+  const std::size_t len = 3 + rng_.below(6) + rng_.below(6);
+  key += make_word(len, len);
+  key += pick_weighted(rng_, kTlds);
+  return key;
+}
+
+std::string SyntheticVaultGenerator::make_username(std::string_view primary_key) {
+  if (rng_.chance(kSharedEmailShare)) {
+    // Skewed towards the first (main) address.
+    const std::size_t i = rng_.chance(0.6) ? 0 : rng_.between(1, kPersonalEmails - 1);
+    return personal_emails_[i];
+  }
+  if (rng_.chance(kHandleShare / (1.0 - kSharedEmailShare))) {
+    return make_word(4, 10) + std::to_string(rng_.below(1000));
+  }
+  // One-off address tagged with the site, as plus-addressing users do.
+  const std::string_view site = primary_key.substr(0, primary_key.find('.'));
+  return make_word(4, 8) + "+" + std::string(site) + "@" + std::string(pick_weighted(rng_, kMailProviders));
+}
+
+int SyntheticVaultGenerator::make_secret(std::span<char> buf) {
+  std::memset(buf.data(), 0, buf.size());
+
+  std::string pw;
+  double charset = 0.0;
+  const double kind = static_cast<double>(rng_.next() >> 11) * 0x1.0p-53;
+  if (kind < kHumanSecretShare) {
+    if (rng_.chance(kHumanReuseShare)) {
+      pw = reused_passwords_[rng_.below(reused_passwords_.size())];
+    } else {
+      pw = make_word(5, 9);
+      pw += std::to_string(rng_.below(100));
+      pw += pick_char(rng_, kSymbols);
+    }
+    // Human passwords are far weaker than their length suggests.
+    charset = 10.0;
+  } else if (kind < kHumanSecretShare + kGeneratedSecretShare) {
+    const std::size_t len = rng_.between(16, 24);
+    for (std::size_t i = 0; i < len; ++i) {
+      pw += pick_char(rng_, rng_.chance(0.85) ? kAlnum : kPrintable);
+    }
+    charset = static_cast<double>(kPrintable.size());
+  } else {
+    const std::size_t len = rng_.between(32, 64);
+    for (std::size_t i = 0; i < len; ++i) {
+      pw += pick_char(rng_, kAlnum);
+    }
+    charset = static_cast<double>(kAlnum.size());
+  }
+
+  const std::size_t len = std::min(pw.size(), buf.size() - 1);
+  std::memcpy(buf.data(), pw.data(), len);
+  sodium_memzero(pw.data(), pw.size());
+  return static_cast<int>(std::lround(static_cast<double>(len) * std::log2(charset)));
+}
+
+std::string SyntheticVaultGenerator::make_note() {
+  std::string note(kNoteTemplates[rng_.below(std::size(kNoteTemplates))]);
+  if (rng_.chance(0.5)) {
+    note += " (" + make_word(3, 12) + ")";
+  }
+  return note;
+}
+
+// ============================================================================
+// Whole-vault helpers
+// ============================================================================
+
+std::vector<std::uint8_t> generate_serialized_vault(std::uint64_t entries, std::uint64_t seed) {
+  SyntheticVaultGenerator gen(seed);
+  SecretEntry entry = SyntheticVaultGenerator::make_entry();
+
+  std::vector<std::uint8_t> out;
+  // ~150 bytes per entry on average; avoids most regrowth (each of which
+  // would leave an unwiped copy of the plaintext behind).
+  out.reserve(13 + static_cast<std::size_t>(entries) * 160);
+
+  VaultSerializer::write_header(out, entries);
+  for (std::uint64_t i = 0; i < entries; ++i) {
+    const Uuid uuid = gen.next(entry);
+    VaultSerializer::write_entry(out, uuid, entry);
+  }
+  return out;
+}
+
+void write_synthetic_vault(const std::filesystem::path& path,
+                           std::uint64_t entries,
+                           std::uint64_t seed,
+                           std::string_view password,
+                           const KdfParams& kdf,
+                           CipherSuite suite) {
+  std::vector<std::uint8_t> plaintext = generate_serialized_vault(entries, seed);
+  VaultIO::save_serialized(path, plaintext, password, kdf, suite);
+}
+
+}  // namespace pwledger::gen
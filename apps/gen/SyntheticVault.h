@@ -0,0 +1,150 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PWLEDGER_GEN_SYNTHETIC_VAULT_H
+#define PWLEDGER_GEN_SYNTHETIC_VAULT_H
+
+#include <pwledger/SecretEntry.h>
+#include <pwledger/VaultCrypto.h>
+#include <pwledger/uuid.h>
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ============================================================================
+// DESIGN NOTES
+// ============================================================================
+//
+// Deterministic synthetic vaults for benchmarking and profiling.
+//
+// DETERMINISM
+// -----------
+// The same seed always yields the same entries (UUIDs, strings, secrets,
+// salts, timestamps) on every platform. That rules out std::mt19937 plus the
+// <random> distributions, whose output is implementation-defined; the
+// generator uses xoshiro256** seeded through splitmix64 and does its own
+// range reduction. Timestamps are relative to a fixed reference instant
+// (kReferenceTime), not the wall clock. The encrypted file still differs
+// between runs because VaultCrypto draws a fresh salt and nonce.
+//
+// STREAMING
+// ---------
+// A PrimaryTable holds two guarded sodium_malloc allocations per entry,
+// which caps a process at a few thousand entries (see bench/BenchSupport.h)
+// and would need tens of GB for a million. The generator instead refills a
+// single SecretEntry in place and appends it to the serialized payload with
+// VaultSerializer::write_entry, so memory is bounded by the payload itself
+// (~150 bytes per entry). The AEAD is single-shot over the whole payload, so
+// that buffer is not avoidable without changing the file format.
+//
+// DISTRIBUTIONS
+// -------------
+// Loosely modelled on real personal vaults: most accounts share a handful
+// of email addresses, human-chosen passwords are short and frequently
+// reused, and notes, expiry policies and 2FA are the minority. The exact
+// proportions are constants in SyntheticVault.cc.
+//
+// ============================================================================
+
+namespace pwledger::gen {
+
+// ----------------------------------------------------------------------------
+// SyntheticRng
+// ----------------------------------------------------------------------------
+// xoshiro256** (Blackman & Vigna). Small, fast and fully specified.
+class SyntheticRng {
+public:
+  explicit SyntheticRng(std::uint64_t seed) noexcept;
+
+  [[nodiscard]] std::uint64_t next() noexcept;
+
+  // Uniform in [0, n). Plain modulo reduction; the bias is irrelevant for
+  // test data and keeps the output trivially reproducible. Precondition: n > 0.
+  [[nodiscard]] std::uint64_t below(std::uint64_t n) noexcept { return next() % n; }
+
+  // Uniform in [lo, hi]. Precondition: lo <= hi.
+  [[nodiscard]] std::uint64_t between(std::uint64_t lo, std::uint64_t hi) noexcept { return lo + below(hi - lo + 1); }
+
+  // True with probability p.
+  [[nodiscard]] bool chance(double p) noexcept;
+
+private:
+  std::array<std::uint64_t, 4> s_{};
+};
+
+// ----------------------------------------------------------------------------
+// SyntheticVaultGenerator
+// ----------------------------------------------------------------------------
+class SyntheticVaultGenerator {
+public:
+  // Capacity of the reusable entry's buffers; matches the CLI's allocation
+  // for new entries.
+  static constexpr std::size_t kSecretBytes = 256;
+
+  // 2026-01-01T00:00:00Z. All generated timestamps are at or before this
+  // instant, except expiry dates which may lie up to a year after it.
+  static constexpr std::int64_t kReferenceTime = 1767225600;
+
+  explicit SyntheticVaultGenerator(std::uint64_t seed);
+
+  // Overwrites every field of `entry` with the next synthetic entry and
+  // returns the UUID to file it under. `entry` must have been constructed
+  // with at least kSecretBytes of secret and VaultCrypto::kSaltBytes of salt
+  // (see make_entry()).
+  Uuid next(SecretEntry& entry);
+
+  // A SecretEntry sized for next().
+  [[nodiscard]] static SecretEntry make_entry();
+
+private:
+  std::string make_primary_key();
+  std::string make_username(std::string_view primary_key);
+  // Writes a NUL-terminated secret into `buf`; returns its strength in bits.
+  int make_secret(std::span<char> buf);
+  std::string make_note();
+  std::string make_word(std::size_t min_len, std::size_t max_len);
+
+  SyntheticRng rng_;
+  std::vector<std::string> personal_emails_;
+  std::vector<std::string> reused_passwords_;
+};
+
+// ----------------------------------------------------------------------------
+// Whole-vault helpers
+// ----------------------------------------------------------------------------
+
+// Serialized (unencrypted, VaultSerializer format) payload of `entries`
+// generated entries. The caller owns the wipe of the returned buffer.
+[[nodiscard]] std::vector<std::uint8_t> generate_serialized_vault(std::uint64_t entries, std::uint64_t seed);
+
+// Generates and writes an encrypted vault through VaultIO::save_serialized.
+void write_synthetic_vault(const std::filesystem::path& path,
+                           std::uint64_t entries,
+                           std::uint64_t seed,
+                           std::string_view password,
+                           const KdfParams& kdf = {},
+                           CipherSuite suite = VaultCrypto::default_cipher_suite());
+
+}  // namespace pwledger::gen
+
+#endif  // PWLEDGER_GEN_SYNTHETIC_VAULT_H
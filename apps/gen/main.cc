@@ -0,0 +1,167 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "SyntheticVault.h"
+
+#include <pwledger/SodiumInit.h>
+#include <pwledger/VaultCrypto.h>
+
+#include <sodium.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// ============================================================================
+// pwledger-gen
+// ============================================================================
+//
+// Writes a deterministic synthetic vault for benchmarking and profiling:
+//
+//   pwledger-gen --output bench.dat --entries 1000000 --seed 42 --fast-kdf
+//
+// The vault is a regular pwledger vault and records its KDF parameters, so
+// one written with --fast-kdf or explicit --kdf-* values still opens in
+// pwledger-cli / pwledger-host with the given password, just faster.
+
+namespace {
+
+void print_usage(std::FILE* out) {
+  std::fputs(
+      "Usage: pwledger-gen --output PATH [options]\n"
+      "\n"
+      "Options:\n"
+      "  --output PATH        Vault file to write (replaced atomically)\n"
+      "  --entries N          Number of entries (default 1000)\n"
+      "  --seed N             Generator seed (default 1)\n"
+      "  --password TEXT      Master password (default \"pwledger-gen\")\n"
+      "  --kdf-ops N          Argon2id opslimit (default: interactive)\n"
+      "  --kdf-mem-kib N      Argon2id memlimit in KiB (default: interactive)\n"
+      "  --kdf-lanes N        Argon2id lanes, 1 to 16 (default 1)\n"
+      "  --fast-kdf           Minimum Argon2id cost, for throwaway test vaults\n"
+      "  --cipher NAME        aes256gcm or xchacha20poly1305 (default: aes256gcm\n"
+      "                       when this CPU supports it)\n"
+      "  --help               Show this message\n",
+      out);
+}
+
+bool parse_u64(const char* text, std::uint64_t& out) {
+  char* end = nullptr;
+  errno = 0;
+  const unsigned long long v = std::strtoull(text, &end, 10);
+  if (errno != 0 || end == text || *end != '\0' || text[0] == '-') {
+    return false;
+  }
+  out = v;
+  return true;
+}
+
+}  // anonymous namespace
+
+// ============================================================================
+// Entry point
+// ============================================================================
+
+int main(int argc, char** argv) {
+  std::filesystem::path output;
+  std::uint64_t entries = 1000;
+  std::uint64_t seed = 1;
+  std::string password = "pwledger-gen";
+  pwledger::KdfParams kdf;
+  std::optional<pwledger::CipherSuite> cipher;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    std::uint64_t value = 0;
+
+    if (arg == "--help" || arg == "-h") {
+      print_usage(stdout);
+      return 0;
+    } else if (arg == "--fast-kdf") {
+      kdf.opslimit = crypto_pwhash_OPSLIMIT_MIN;
+      kdf.memlimit = crypto_pwhash_MEMLIMIT_MIN;
+    } else if (arg == "--cipher" && has_value && (cipher = pwledger::parse_cipher_suite(argv[++i]))) {
+    } else if (arg == "--output" && has_value) {
+      output = argv[++i];
+    } else if (arg == "--password" && has_value) {
+      password = argv[++i];
+    } else if (arg == "--entries" && has_value && parse_u64(argv[++i], value)) {
+      entries = value;
+    } else if (arg == "--seed" && has_value && parse_u64(argv[++i], value)) {
+      seed = value;
+    } else if (arg == "--kdf-ops" && has_value && parse_u64(argv[++i], value)) {
+      kdf.opslimit = value;
+    } else if (arg == "--kdf-mem-kib" && has_value && parse_u64(argv[++i], value)) {
+      kdf.memlimit = static_cast<std::size_t>(value) * 1024u;
+    } else if (arg == "--kdf-lanes" && has_value && parse_u64(argv[++i], value) && value >= 1 &&
+               value <= pwledger::VaultCrypto::kMaxParallelism) {
+      kdf.parallelism = static_cast<std::uint32_t>(value);
+    } else {
+      std::fprintf(stderr, "pwledger-gen: invalid argument '%s'\n\n", argv[i]);
+      print_usage(stderr);
+      return 2;
+    }
+  }
+
+  if (output.empty()) {
+    std::fputs("pwledger-gen: --output is required\n\n", stderr);
+    print_usage(stderr);
+    return 2;
+  }
+  if (kdf.opslimit < crypto_pwhash_OPSLIMIT_MIN || kdf.memlimit < crypto_pwhash_MEMLIMIT_MIN) {
+    std::fprintf(stderr, "pwledger-gen: KDF parameters below the Argon2id minimum (ops %llu, mem %zu KiB)\n",
+                 static_cast<unsigned long long>(crypto_pwhash_OPSLIMIT_MIN),
+                 static_cast<std::size_t>(crypto_pwhash_MEMLIMIT_MIN) / 1024u);
+    return 2;
+  }
+  if (kdf.memlimit / 1024u < std::size_t{8} * kdf.parallelism) {
+    std::fprintf(stderr, "pwledger-gen: Argon2id needs at least 8 KiB per lane (%u lanes)\n", kdf.parallelism);
+    return 2;
+  }
+
+  if (!pwledger::sodium_init_once()) {
+    std::fputs("Fatal: libsodium initialization failed.\n", stderr);
+    return 1;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  try {
+    pwledger::gen::write_synthetic_vault(output, entries, seed, password, kdf,
+                                         cipher.value_or(pwledger::VaultCrypto::default_cipher_suite()));
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "pwledger-gen: %s\n", e.what());
+    return 1;
+  }
+  const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+  std::error_code ec;
+  const auto bytes = std::filesystem::file_size(output, ec);
+  std::printf("Wrote %llu entries (seed %llu) to %s: %llu bytes in %.2f s\n",
+              static_cast<unsigned long long>(entries), static_cast<unsigned long long>(seed),
+              output.string().c_str(), static_cast<unsigned long long>(ec ? 0 : bytes), elapsed.count());
+  sodium_memzero(password.data(), password.size());
+  return 0;
+}
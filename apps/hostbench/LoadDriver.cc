@@ -0,0 +1,498 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "LoadDriver.h"
+
+#include "NativeMessaging.h"
+#include "SyntheticVault.h"
+
+#include <pwledger/VaultPath.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using json = nlohmann::json;
+
+namespace pwledger::hostbench {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Longest time allowed for the host to start and complete the initial
+// unlock (one Argon2id derivation plus loading the vault).
+constexpr std::chrono::seconds kSetupTimeout{120};
+
+// Upper bound on one poll() wait, so stall detection stays responsive.
+constexpr int kMaxPollMs = 100;
+
+std::chrono::microseconds to_us(Clock::duration d) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(d);
+}
+
+void set_nonblocking(int fd) {
+  const int flags = ::fcntl(fd, F_GETFL);
+  if (flags < 0 || ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+    throw std::runtime_error(std::string("fcntl(O_NONBLOCK) failed: ") + std::strerror(errno));
+  }
+}
+
+// ----------------------------------------------------------------------------
+// HostProcess
+// ----------------------------------------------------------------------------
+// pwledger-host as a child with non-blocking pipes on its stdin and stdout.
+// Its stderr is inherited so host warnings stay visible.
+class HostProcess {
+public:
+  HostProcess(const std::filesystem::path& exe, bool rate_limits) {
+    int to_child[2];
+    int from_child[2];
+    if (::pipe(to_child) != 0) {
+      throw std::runtime_error(std::string("pipe() failed: ") + std::strerror(errno));
+    }
+    if (::pipe(from_child) != 0) {
+      ::close(to_child[0]);
+      ::close(to_child[1]);
+      throw std::runtime_error(std::string("pipe() failed: ") + std::strerror(errno));
+    }
+
+    pid_ = ::fork();
+    if (pid_ == 0) {
+      ::dup2(to_child[0], STDIN_FILENO);
+      ::dup2(from_child[1], STDOUT_FILENO);
+      ::close(to_child[0]);
+      ::close(to_child[1]);
+      ::close(from_child[0]);
+      ::close(from_child[1]);
+      if (!rate_limits) {
+        ::setenv("PWLEDGER_HOST_RATE_LIMITS", "off", 1);
+      }
+      ::execlp(exe.c_str(), exe.c_str(), static_cast<char*>(nullptr));
+      ::_exit(127);
+    }
+    ::close(to_child[0]);
+    ::close(from_child[1]);
+    if (pid_ < 0) {
+      ::close(to_child[1]);
+      ::close(from_child[0]);
+      throw std::runtime_error(std::string("fork() failed: ") + std::strerror(errno));
+    }
+    in_ = to_child[1];
+    out_ = from_child[0];
+    set_nonblocking(in_);
+    set_nonblocking(out_);
+  }
+
+  ~HostProcess() {
+    close_input();
+    if (out_ >= 0) {
+      ::close(out_);
+    }
+    // Closing stdin is the host's normal shutdown signal; give it a moment
+    // to drain before forcing it.
+    int status = 0;
+    for (int i = 0; i < 50; ++i) {
+      if (::waitpid(pid_, &status, WNOHANG) != 0) {
+        return;
+      }
+      ::usleep(100 * 1000);
+    }
+    ::kill(pid_, SIGKILL);
+    ::waitpid(pid_, &status, 0);
+  }
+
+  HostProcess(const HostProcess&) = delete;
+  HostProcess& operator=(const HostProcess&) = delete;
+
+  void close_input() noexcept {
+    if (in_ >= 0) {
+      ::close(in_);
+      in_ = -1;
+    }
+  }
+
+  [[nodiscard]] int in() const noexcept { return in_; }
+  [[nodiscard]] int out() const noexcept { return out_; }
+
+private:
+  pid_t pid_ = -1;
+  int in_ = -1;
+  int out_ = -1;
+};
+
+// ----------------------------------------------------------------------------
+// Pipe buffers
+// ----------------------------------------------------------------------------
+
+class FrameWriter {
+public:
+  void push(const json& request) {
+    auto frame = encode_message(request);
+    if (!frame.has_value()) {
+      throw std::runtime_error("request exceeds the native messaging size limit");
+    }
+    buf_ += *frame;
+  }
+
+  [[nodiscard]] bool pending() const noexcept { return offset_ < buf_.size(); }
+
+  // Writes as much as the pipe accepts without blocking.
+  void flush_some(int fd) {
+    while (pending()) {
+      const ssize_t n = ::write(fd, buf_.data() + offset_, buf_.size() - offset_);
+      if (n < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+          break;
+        }
+        throw std::runtime_error(std::string("write to host failed: ") + std::strerror(errno));
+      }
+      offset_ += static_cast<std::size_t>(n);
+    }
+    if (offset_ == buf_.size()) {
+      buf_.clear();
+      offset_ = 0;
+    }
+  }
+
+private:
+  std::string buf_;
+  std::size_t offset_ = 0;
+};
+
+class FrameReader {
+public:
+  // Reads everything currently available. Returns false on EOF.
+  bool fill(int fd) {
+    char chunk[64 * 1024];
+    for (;;) {
+      const ssize_t n = ::read(fd, chunk, sizeof(chunk));
+      if (n > 0) {
+        buf_.append(chunk, static_cast<std::size_t>(n));
+        continue;
+      }
+      if (n == 0) {
+        return false;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        return true;
+      }
+      throw std::runtime_error(std::string("read from host failed: ") + std::strerror(errno));
+    }
+  }
+
+  // Next complete response, if one has been buffered.
+  std::optional<json> next() {
+    const auto payload = decode_message(std::string_view(buf_).substr(offset_));
+    if (!payload.has_value()) {
+      if (offset_ > 0) {
+        buf_.erase(0, offset_);
+        offset_ = 0;
+      }
+      return std::nullopt;
+    }
+    json response = json::parse(*payload, nullptr, /*allow_exceptions=*/false);
+    offset_ += sizeof(std::uint32_t) + payload->size();
+    if (response.is_discarded()) {
+      throw std::runtime_error("host sent a frame that is not JSON");
+    }
+    return response;
+  }
+
+private:
+  std::string buf_;
+  std::size_t offset_ = 0;
+};
+
+// ----------------------------------------------------------------------------
+// Request synthesis
+// ----------------------------------------------------------------------------
+
+class RequestBuilder {
+public:
+  RequestBuilder(const VaultFixture& fixture, std::uint64_t seed)
+    : fixture_(fixture)
+    , rng_(seed) {}
+
+  json build(const RequestShape& shape, std::uint64_t id) {
+    json req = {{"command", shape.command}, {"id", id}};
+    if (shape.command == "search") {
+      req["query"] = query(shape.query_len);
+    } else if (shape.command == "get_credentials") {
+      req["uuid"] = fixture_.uuids.empty() ? std::string(36, '0') : pick(fixture_.uuids);
+    } else if (shape.command == "unlock") {
+      req["password"] = fixture_.password;
+    }
+    return req;
+  }
+
+private:
+  // A substring of a real primary key, so that the search has hits.
+  std::string query(std::size_t len) {
+    if (fixture_.primary_keys.empty()) {
+      return std::string(len, 'x');
+    }
+    const std::string& key = pick(fixture_.primary_keys);
+    len = std::min(len, key.size());
+    return key.substr(static_cast<std::size_t>(rng_.below(key.size() - len + 1)), len);
+  }
+
+  const std::string& pick(const std::vector<std::string>& from) {
+    return from[static_cast<std::size_t>(rng_.below(from.size()))];
+  }
+
+  const VaultFixture& fixture_;
+  gen::SyntheticRng rng_;
+};
+
+struct InFlight {
+  std::string command;
+  Clock::time_point due;
+};
+
+// Waits for the next response. Only used during setup, when exactly one
+// request is in flight.
+json await_response(HostProcess& host, FrameWriter& writer, FrameReader& reader) {
+  const auto deadline = Clock::now() + kSetupTimeout;
+  for (;;) {
+    if (auto response = reader.next()) {
+      return *response;
+    }
+    const auto now = Clock::now();
+    if (now >= deadline) {
+      throw std::runtime_error("timed out waiting for the host to unlock");
+    }
+    pollfd fds[2] = {{host.out(), POLLIN, 0}, {host.in(), static_cast<short>(writer.pending() ? POLLOUT : 0), 0}};
+    if (::poll(fds, 2, kMaxPollMs) < 0 && errno != EINTR) {
+      throw std::runtime_error(std::string("poll() failed: ") + std::strerror(errno));
+    }
+    if (fds[1].revents & POLLOUT) {
+      writer.flush_some(host.in());
+    }
+    if ((fds[0].revents & (POLLIN | POLLHUP)) && !reader.fill(host.out()) && !reader.next()) {
+      throw std::runtime_error("host exited during setup (is the --host path correct?)");
+    }
+  }
+}
+
+void record_response(LoadReport& report, std::unordered_map<std::uint64_t, InFlight>& in_flight,
+                     const json& response, Clock::time_point now) {
+  const auto id_it = response.find("id");
+  if (id_it == response.end() || !id_it->is_number_unsigned()) {
+    return;  // not one of ours
+  }
+  const auto it = in_flight.find(id_it->get<std::uint64_t>());
+  if (it == in_flight.end()) {
+    return;
+  }
+
+  const auto latency = now - it->second.due;
+  CommandResult& result = report.commands[it->second.command];
+  result.latency.record(latency);
+  report.latency.record(latency);
+  ++report.completed;
+
+  if (response.value("status", "") == "ok") {
+    ++result.ok;
+  } else {
+    ++result.errors;
+    ++result.error_messages[response.value("message", std::string("(no message)"))];
+  }
+  in_flight.erase(it);
+}
+
+}  // anonymous namespace
+
+// ============================================================================
+// Fixture
+// ============================================================================
+
+void isolate_home(const std::filesystem::path& home) {
+  std::filesystem::create_directories(home / "config");
+  std::filesystem::create_directories(home / "data");
+  ::setenv("HOME", home.c_str(), 1);
+  ::setenv("XDG_CONFIG_HOME", (home / "config").c_str(), 1);
+  ::setenv("XDG_DATA_HOME", (home / "data").c_str(), 1);
+}
+
+VaultFixture create_fixture(std::uint64_t entries, std::uint64_t seed, std::string password) {
+  const std::filesystem::path path = default_vault_path();
+  ensure_vault_dir_exists(path.parent_path());
+  gen::write_synthetic_vault(path, entries, seed, password);
+
+  // Regenerate the same entries to sample their keys; the generator is
+  // deterministic, and this avoids decrypting the vault we just wrote.
+  VaultFixture fixture;
+  fixture.password = std::move(password);
+  const std::uint64_t stride = entries > kMaxFixtureSamples ? entries / kMaxFixtureSamples : 1;
+  gen::SyntheticVaultGenerator generator(seed);
+  SecretEntry entry = gen::SyntheticVaultGenerator::make_entry();
+  for (std::uint64_t i = 0; i < entries; ++i) {
+    const Uuid uuid = generator.next(entry);
+    if (i % stride == 0 && fixture.uuids.size() < kMaxFixtureSamples) {
+      fixture.uuids.push_back(uuid.to_string());
+      fixture.primary_keys.push_back(entry.primary_key);
+    }
+  }
+  return fixture;
+}
+
+// ============================================================================
+// Run
+// ============================================================================
+
+LoadReport run_load(const Workload& workload, const VaultFixture& fixture, const DriverOptions& options) {
+  // A host that dies mid-run must surface as lost requests, not SIGPIPE.
+  ::signal(SIGPIPE, SIG_IGN);
+
+  LoadReport report;
+  HostProcess host(options.host, options.rate_limits);
+  FrameWriter writer;
+  FrameReader reader;
+  RequestBuilder builder(fixture, options.seed);
+
+  // ---- setup: unlock, reported separately from the run ----
+  {
+    const auto started = Clock::now();
+    writer.push(builder.build(RequestShape{0, "unlock", 0}, 0));
+    writer.flush_some(host.in());
+    const json response = await_response(host, writer, reader);
+    if (response.value("status", "") != "ok") {
+      throw std::runtime_error("initial unlock failed: " + response.value("message", std::string("(no message)")));
+    }
+    report.setup_unlock = to_us(Clock::now() - started);
+  }
+
+  // ---- timed run ----
+  std::unordered_map<std::uint64_t, InFlight> in_flight;
+  std::uint64_t next_id = 1;
+  std::size_t next = 0;
+  bool host_closed = false;
+
+  const auto start = Clock::now();
+  auto last_progress = start;
+  auto last_response = start;
+
+  for (;;) {
+    auto now = Clock::now();
+
+    // Queue everything that is due, up to the in-flight cap.
+    while (next < workload.size() && in_flight.size() < options.max_in_flight) {
+      const RequestShape& shape = workload[next];
+      const auto due = start + std::chrono::microseconds(shape.at_us);
+      if (due > now) {
+        break;
+      }
+      ++next;
+      if (!is_replayable(shape.command)) {
+        ++report.skipped;
+        continue;
+      }
+      report.max_send_lag = std::max(report.max_send_lag, to_us(now - due));
+      writer.push(builder.build(shape, next_id));
+      in_flight.emplace(next_id++, InFlight{shape.command, due});
+      ++report.commands[shape.command].sent;
+      ++report.sent;
+      last_progress = now;
+    }
+
+    if (next == workload.size() && in_flight.empty()) {
+      break;
+    }
+    if (host_closed || now - last_progress > options.stall_timeout) {
+      report.lost = in_flight.size();
+      break;
+    }
+
+    int timeout_ms = kMaxPollMs;
+    if (next < workload.size() && in_flight.size() < options.max_in_flight) {
+      const auto due = start + std::chrono::microseconds(workload[next].at_us);
+      const auto wait = std::chrono::ceil<std::chrono::milliseconds>(due - now).count();
+      timeout_ms = static_cast<int>(std::clamp<long long>(wait, 0, kMaxPollMs));
+    }
+
+    pollfd fds[2] = {{host.out(), POLLIN, 0}, {host.in(), static_cast<short>(writer.pending() ? POLLOUT : 0), 0}};
+    if (writer.pending()) {
+      writer.flush_some(host.in());  // usually completes without waiting
+      fds[1].events = static_cast<short>(writer.pending() ? POLLOUT : 0);
+    }
+    if (::poll(fds, 2, timeout_ms) < 0 && errno != EINTR) {
+      throw std::runtime_error(std::string("poll() failed: ") + std::strerror(errno));
+    }
+    if (fds[1].revents & POLLOUT) {
+      writer.flush_some(host.in());
+    }
+    if (fds[0].revents & (POLLIN | POLLHUP)) {
+      host_closed = !reader.fill(host.out());
+      now = Clock::now();
+      while (auto response = reader.next()) {
+        record_response(report, in_flight, *response, now);
+        last_progress = now;
+        last_response = now;
+      }
+    }
+  }
+
+  report.elapsed = to_us(last_response - start);
+  return report;
+}
+
+// ============================================================================
+// Report
+// ============================================================================
+
+double LoadReport::throughput() const noexcept {
+  const double seconds = std::chrono::duration<double>(elapsed).count();
+  return seconds > 0.0 ? static_cast<double>(completed) / seconds : 0.0;
+}
+
+json LoadReport::to_json() const {
+  json commands_json = json::object();
+  for (const auto& [name, result] : commands) {
+    commands_json[name] = {
+        {"sent", result.sent},
+        {"ok", result.ok},
+        {"errors", result.errors},
+        {"error_messages", result.error_messages},
+        {"latency_us", result.latency.to_json()},
+    };
+  }
+  return {
+      {"setup_unlock_ms", static_cast<double>(setup_unlock.count()) / 1000.0},
+      {"elapsed_ms", static_cast<double>(elapsed.count()) / 1000.0},
+      {"max_send_lag_ms", static_cast<double>(max_send_lag.count()) / 1000.0},
+      {"throughput_rps", throughput()},
+      {"requests", {{"sent", sent}, {"completed", completed}, {"lost", lost}, {"skipped", skipped}}},
+      {"latency_us", latency.to_json()},
+      {"commands", std::move(commands_json)},
+  };
+}
+
+}  // namespace pwledger::hostbench
@@ -0,0 +1,133 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PWLEDGER_HOSTBENCH_LOAD_DRIVER_H
+#define PWLEDGER_HOSTBENCH_LOAD_DRIVER_H
+
+#include "HostStats.h"
+#include "Workload.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+// ============================================================================
+// DESIGN NOTES
+// ============================================================================
+//
+// Drives a real pwledger-host child process over its stdin/stdout pipes,
+// exactly as a browser does: length-prefixed JSON frames, many requests in
+// flight, responses matched to requests by id.
+//
+// OPEN LOOP
+// ---------
+// Requests are sent when they are due according to the workload, not when
+// the previous response arrives, and latency is measured from the *due*
+// time rather than the actual send time. A host that falls behind therefore
+// pays for the queueing it causes instead of silently slowing the offered
+// load down (the "coordinated omission" error of closed-loop drivers). The
+// only back-pressure is max_in_flight, a safety valve against unbounded
+// memory use; the report's max_send_lag shows whether it engaged.
+//
+// I/O is a single-threaded poll() loop over non-blocking pipes, so the
+// driver can never deadlock against a host that is blocked writing a large
+// response while the driver is blocked writing a request.
+//
+// FIXTURE
+// -------
+// The host is pointed at a throwaway HOME containing a synthetic vault from
+// pwledger-gen's generator, written with the default KDF parameters so the
+// host's unlock path is the production one. Queries and uuids for the
+// replayed requests are drawn from that vault, so searches hit and autofills
+// find their entry. The host is unlocked once before the timed run; that
+// unlock is reported separately.
+//
+// POSIX only (fork/exec and poll).
+//
+// ============================================================================
+
+namespace pwledger::hostbench {
+
+// Primary keys and uuids sampled from the synthetic vault, plus its password.
+struct VaultFixture {
+  std::string password;
+  std::vector<std::string> primary_keys;
+  std::vector<std::string> uuids;
+};
+
+// Maximum number of keys and uuids kept in a VaultFixture.
+inline constexpr std::size_t kMaxFixtureSamples = 4096;
+
+// Writes a synthetic vault of `entries` entries to the default vault path
+// and samples it. The process environment (HOME / XDG_*) must already
+// point at the throwaway home, see isolate_home(). Requires
+// libsodium to be initialized.
+[[nodiscard]] VaultFixture create_fixture(std::uint64_t entries, std::uint64_t seed, std::string password);
+
+// Points HOME and XDG_CONFIG_HOME / XDG_DATA_HOME at `home`, for this
+// process and every child it spawns.
+void isolate_home(const std::filesystem::path& home);
+
+struct DriverOptions {
+  std::filesystem::path host = "pwledger-host-bench";
+  std::size_t max_in_flight = 64;
+  // Give up on outstanding requests after this long without any progress.
+  std::chrono::milliseconds stall_timeout{10000};
+  // Keep the host's per-command token buckets (off by default, see
+  // AdmissionController) to measure behaviour under its rate limits. Only
+  // pwledger-host-bench can turn them off; pwledger-host keeps them anyway.
+  bool rate_limits = false;
+  std::uint64_t seed = 1;
+};
+
+struct CommandResult {
+  std::uint64_t sent = 0;
+  std::uint64_t ok = 0;
+  std::uint64_t errors = 0;
+  LatencyHistogram latency;
+  std::map<std::string, std::uint64_t> error_messages;
+};
+
+struct LoadReport {
+  std::chrono::microseconds setup_unlock{0};
+  std::chrono::microseconds elapsed{0};  // first due time to last response
+  std::chrono::microseconds max_send_lag{0};
+  std::uint64_t sent = 0;
+  std::uint64_t completed = 0;
+  std::uint64_t lost = 0;     // never answered (stall or host exit)
+  std::uint64_t skipped = 0;  // not replayable, see is_replayable()
+  LatencyHistogram latency;
+  std::map<std::string, CommandResult> commands;
+
+  [[nodiscard]] double throughput() const noexcept;
+  [[nodiscard]] nlohmann::json to_json() const;
+};
+
+// Starts the host, unlocks it, replays `workload` and shuts the host down.
+// Throws std::runtime_error if the host cannot be started or unlocked.
+[[nodiscard]] LoadReport run_load(const Workload& workload, const VaultFixture& fixture, const DriverOptions& options);
+
+}  // namespace pwledger::hostbench
+
+#endif  // PWLEDGER_HOSTBENCH_LOAD_DRIVER_H
@@ -0,0 +1,166 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Workload.h"
+
+#include "SyntheticVault.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace pwledger::hostbench {
+
+namespace {
+
+struct Preset {
+  std::string_view name;
+  std::string_view spec;
+};
+
+constexpr Preset kPresets[] = {
+    {"pageload", "search=70,get_credentials=20,ping=9,relock=1"},
+    {"search", "search=1"},
+    {"credentials", "get_credentials=1"},
+    {"unlock", "relock=1"},
+};
+
+constexpr std::string_view kMixCommands[] = {
+    "ping", "search", "get_credentials", "lock", "unlock", "stats", "relock",
+};
+
+constexpr std::size_t kMinQueryLen = 3;
+constexpr std::size_t kMaxQueryLen = 12;
+
+// Uniform in (0, 1].
+double unit_interval(gen::SyntheticRng& rng) noexcept {
+  return static_cast<double>((rng.next() >> 11) + 1) * 0x1.0p-53;
+}
+
+}  // anonymous namespace
+
+Mix parse_mix(std::string_view spec) {
+  for (const Preset& preset : kPresets) {
+    if (spec == preset.name) {
+      spec = preset.spec;
+      break;
+    }
+  }
+
+  Mix mix;
+  unsigned long total = 0;
+  while (!spec.empty()) {
+    const std::size_t comma = spec.find(',');
+    const std::string_view item = spec.substr(0, comma);
+    spec = comma == std::string_view::npos ? std::string_view{} : spec.substr(comma + 1);
+
+    const std::size_t eq = item.find('=');
+    if (eq == std::string_view::npos || eq == 0 || eq + 1 == item.size()) {
+      throw std::invalid_argument("mix entries must be command=weight: '" + std::string(item) + "'");
+    }
+    const std::string_view command = item.substr(0, eq);
+    if (std::find(std::begin(kMixCommands), std::end(kMixCommands), command) == std::end(kMixCommands)) {
+      throw std::invalid_argument("unsupported command in mix: '" + std::string(command) + "'");
+    }
+
+    unsigned weight = 0;
+    for (const char c : item.substr(eq + 1)) {
+      if (c < '0' || c > '9' || weight > 100000) {
+        throw std::invalid_argument("invalid weight in mix: '" + std::string(item) + "'");
+      }
+      weight = weight * 10 + static_cast<unsigned>(c - '0');
+    }
+    total += weight;
+    mix.push_back(MixEntry{std::string(command), weight});
+  }
+
+  if (total == 0) {
+    throw std::invalid_argument("mix has no commands with a positive weight");
+  }
+  return mix;
+}
+
+bool is_replayable(std::string_view command) noexcept {
+  return command == "ping" || command == "search" || command == "get_credentials" || command == "lock" ||
+         command == "unlock" || command == "stats";
+}
+
+Workload synthetic_workload(const Mix& mix, std::size_t requests, double rate, std::uint64_t seed) {
+  if (!(rate > 0.0)) {
+    throw std::invalid_argument("rate must be positive");
+  }
+  unsigned long total = 0;
+  for (const MixEntry& e : mix) {
+    total += e.weight;
+  }
+  if (total == 0) {
+    throw std::invalid_argument("mix has no commands with a positive weight");
+  }
+
+  gen::SyntheticRng rng(seed);
+  Workload workload;
+  workload.reserve(requests);
+  double at_s = 0.0;
+
+  while (workload.size() < requests) {
+    at_s += -std::log(unit_interval(rng)) / rate;
+    const auto at_us = static_cast<std::uint64_t>(at_s * 1e6);
+
+    std::uint64_t pick = rng.below(total);
+    const MixEntry* chosen = &mix.front();
+    for (const MixEntry& e : mix) {
+      if (pick < e.weight) {
+        chosen = &e;
+        break;
+      }
+      pick -= e.weight;
+    }
+
+    if (chosen->command == "relock") {
+      workload.push_back(RequestShape{at_us, "lock", 0});
+      if (workload.size() < requests) {
+        workload.push_back(RequestShape{at_us, "unlock", 0});
+      }
+    } else if (chosen->command == "search") {
+      workload.push_back(RequestShape{at_us, "search", static_cast<std::size_t>(rng.between(kMinQueryLen, kMaxQueryLen))});
+    } else {
+      workload.push_back(RequestShape{at_us, chosen->command, 0});
+    }
+  }
+  return workload;
+}
+
+void retime(Workload& workload, double rate) {
+  if (!(rate > 0.0)) {
+    throw std::invalid_argument("rate must be positive");
+  }
+  for (std::size_t i = 0; i < workload.size(); ++i) {
+    workload[i].at_us = static_cast<std::uint64_t>(static_cast<double>(i) * 1e6 / rate);
+  }
+}
+
+void scale_time(Workload& workload, double speed) {
+  if (!(speed > 0.0)) {
+    throw std::invalid_argument("speed must be positive");
+  }
+  for (RequestShape& shape : workload) {
+    shape.at_us = static_cast<std::uint64_t>(static_cast<double>(shape.at_us) / speed);
+  }
+}
+
+}  // namespace pwledger::hostbench
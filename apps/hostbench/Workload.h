@@ -0,0 +1,94 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PWLEDGER_HOSTBENCH_WORKLOAD_H
+#define PWLEDGER_HOSTBENCH_WORKLOAD_H
+
+#include "SessionRecorder.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ============================================================================
+// DESIGN NOTES
+// ============================================================================
+//
+// A workload is a list of RequestShape (SessionRecorder.h), ordered by
+// at_us, the offset from the start of the run at which each request is due.
+// It comes from one of two places:
+//
+//   recorded   A PWLEDGER_HOST_RECORD file captured from a real browser
+//              session, replayed at its recorded timing (optionally sped up
+//              with scale_time) or re-spaced to a fixed rate (retime).
+//   synthetic  A weighted command mix with Poisson arrivals at a target
+//              rate. Page loads are independent events, so exponential
+//              inter-arrival times are a better model of extension traffic
+//              than a fixed tick, and they produce the bursts that exercise
+//              the host's queue.
+//
+// A mix is written as comma-separated `command=weight` pairs, or one of the
+// presets below. Besides host commands it accepts `relock`, which expands to
+// a lock immediately followed by an unlock (an Argon2id derivation), the
+// pattern an idle auto-lock produces.
+//
+// ============================================================================
+
+namespace pwledger::hostbench {
+
+struct MixEntry {
+  std::string command;
+  unsigned weight = 0;
+};
+
+using Mix = std::vector<MixEntry>;
+using Workload = std::vector<RequestShape>;
+
+// Presets accepted by parse_mix().
+//   pageload     mostly searches and autofills, occasional ping and relock
+//   search       searches only
+//   credentials  get_credentials only
+//   unlock       relock only (Argon2id-bound)
+inline constexpr std::string_view kDefaultMix = "pageload";
+
+// Parses a preset name or a `command=weight,...` list. Throws
+// std::invalid_argument on unknown commands, zero total weight or syntax
+// errors.
+[[nodiscard]] Mix parse_mix(std::string_view spec);
+
+// True for commands the driver can replay. copy and clip_clear are skipped
+// (they would overwrite the clipboard of the machine running the bench), as
+// is init_vault (the driver supplies its own vault).
+[[nodiscard]] bool is_replayable(std::string_view command) noexcept;
+
+// `requests` shapes drawn from `mix` with Poisson arrivals at `rate`
+// requests per second. A relock counts as two requests. Search query
+// lengths are drawn from 3 to 12 characters. Deterministic for a seed.
+[[nodiscard]] Workload synthetic_workload(const Mix& mix, std::size_t requests, double rate, std::uint64_t seed);
+
+// Re-spaces `workload` to exactly `rate` requests per second, keeping order.
+void retime(Workload& workload, double rate);
+
+// Divides every offset by `speed` (2.0 replays twice as fast).
+void scale_time(Workload& workload, double speed);
+
+}  // namespace pwledger::hostbench
+
+#endif  // PWLEDGER_HOSTBENCH_WORKLOAD_H
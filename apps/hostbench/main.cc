@@ -0,0 +1,267 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "LoadDriver.h"
+#include "SessionRecorder.h"
+#include "Workload.h"
+
+#include <pwledger/SodiumInit.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+#include <unistd.h>
+
+// ============================================================================
+// pwledger-hostbench
+// ============================================================================
+//
+// Load-tests pwledger-host the way a browser drives it:
+//
+//   pwledger-hostbench --entries 2000 --rate 500 --requests 20000
+//   pwledger-hostbench --replay session.jsonl --speed 10
+//
+// Synthetic runs draw from a command mix (see Workload.h); replays use a
+// recording made by running the host with PWLEDGER_HOST_RECORD set. Each run
+// starts a fresh host against a throwaway synthetic vault (see
+// LoadDriver.h) and prints throughput and latency percentiles, overall and
+// per command.
+
+namespace {
+
+void print_usage(std::FILE* out) {
+  std::fputs(
+      "Usage: pwledger-hostbench [options]\n"
+      "\n"
+      "Workload:\n"
+      "  --mix SPEC           pageload (default), search, credentials, unlock,\n"
+      "                       or command=weight,... (relock = lock + unlock)\n"
+      "  --requests N         Number of requests (default 10000; replay: all)\n"
+      "  --rate R             Target requests per second (default 200; replay:\n"
+      "                       re-space the recording to this rate)\n"
+      "  --replay FILE        Replay a PWLEDGER_HOST_RECORD recording\n"
+      "  --speed X            Replay the recording X times faster (default 1)\n"
+      "  --seed N             Workload and vault seed (default 1)\n"
+      "\n"
+      "Host:\n"
+      "  --host PATH          host executable (default: pwledger-host-bench next to this one)\n"
+      "  --entries N          Synthetic vault size (default 1000)\n"
+      "  --max-in-flight N    Outstanding request cap (default 64)\n"
+      "  --rate-limits        Keep the host's per-command rate limits\n"
+      "  --home DIR           Use DIR as the host's HOME and keep it afterwards\n"
+      "\n"
+      "Output:\n"
+      "  --json               Print the report as JSON\n"
+      "  --help               Show this message\n",
+      out);
+}
+
+bool parse_u64(const char* text, std::uint64_t& out) {
+  char* end = nullptr;
+  errno = 0;
+  const unsigned long long v = std::strtoull(text, &end, 10);
+  if (errno != 0 || end == text || *end != '\0' || text[0] == '-') {
+    return false;
+  }
+  out = v;
+  return true;
+}
+
+bool parse_positive(const char* text, double& out) {
+  char* end = nullptr;
+  errno = 0;
+  const double v = std::strtod(text, &end);
+  if (errno != 0 || end == text || *end != '\0' || !(v > 0.0)) {
+    return false;
+  }
+  out = v;
+  return true;
+}
+
+std::filesystem::path default_host(const char* argv0) {
+  const std::filesystem::path self(argv0);
+  if (self.has_parent_path()) {
+    return self.parent_path() / "pwledger-host-bench";
+  }
+  return "pwledger-host-bench";  // resolved through PATH
+}
+
+void print_report(const pwledger::hostbench::LoadReport& report) {
+  const auto ms = [](std::uint64_t us) { return static_cast<double>(us) / 1000.0; };
+
+  std::printf("setup unlock     %10.1f ms\n", static_cast<double>(report.setup_unlock.count()) / 1000.0);
+  std::printf("elapsed          %10.1f ms\n", static_cast<double>(report.elapsed.count()) / 1000.0);
+  std::printf("requests         %10llu sent, %llu completed, %llu lost, %llu skipped\n",
+              static_cast<unsigned long long>(report.sent), static_cast<unsigned long long>(report.completed),
+              static_cast<unsigned long long>(report.lost), static_cast<unsigned long long>(report.skipped));
+  std::printf("throughput       %10.1f req/s\n", report.throughput());
+  std::printf("max send lag     %10.1f ms\n", static_cast<double>(report.max_send_lag.count()) / 1000.0);
+  std::printf("\n%-16s %8s %8s %10s %10s %10s %10s\n", "command", "sent", "errors", "p50 ms", "p99 ms", "p999 ms",
+              "max ms");
+
+  const auto row = [&](const char* name, std::uint64_t sent, std::uint64_t errors,
+                       const pwledger::LatencyHistogram& h) {
+    std::printf("%-16s %8llu %8llu %10.3f %10.3f %10.3f %10.3f\n", name, static_cast<unsigned long long>(sent),
+                static_cast<unsigned long long>(errors), ms(h.value_at_quantile(0.5)), ms(h.value_at_quantile(0.99)),
+                ms(h.value_at_quantile(0.999)), ms(h.max_us()));
+  };
+
+  std::uint64_t errors = 0;
+  for (const auto& [name, result] : report.commands) {
+    row(name.c_str(), result.sent, result.errors, result.latency);
+    errors += result.errors;
+  }
+  row("all", report.sent, errors, report.latency);
+
+  for (const auto& [name, result] : report.commands) {
+    for (const auto& [message, count] : result.error_messages) {
+      std::printf("  %s: %llu x \"%s\"\n", name.c_str(), static_cast<unsigned long long>(count), message.c_str());
+    }
+  }
+}
+
+}  // anonymous namespace
+
+// ============================================================================
+// Entry point
+// ============================================================================
+
+int main(int argc, char** argv) {
+  namespace hb = pwledger::hostbench;
+
+  std::string mix_spec(hb::kDefaultMix);
+  std::uint64_t requests = 10000;
+  bool requests_set = false;
+  double rate = 200.0;
+  bool rate_set = false;
+  double speed = 1.0;
+  std::filesystem::path replay;
+  std::uint64_t seed = 1;
+  std::uint64_t entries = 1000;
+  std::uint64_t max_in_flight = 64;
+  std::filesystem::path home;
+  bool json_output = false;
+
+  hb::DriverOptions options;
+  options.host = default_host(argv[0]);
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    const bool has_value = i + 1 < argc;
+
+    if (arg == "--help" || arg == "-h") {
+      print_usage(stdout);
+      return 0;
+    } else if (arg == "--json") {
+      json_output = true;
+    } else if (arg == "--rate-limits") {
+      options.rate_limits = true;
+    } else if (arg == "--mix" && has_value) {
+      mix_spec = argv[++i];
+    } else if (arg == "--replay" && has_value) {
+      replay = argv[++i];
+    } else if (arg == "--host" && has_value) {
+      options.host = argv[++i];
+    } else if (arg == "--home" && has_value) {
+      home = argv[++i];
+    } else if (arg == "--requests" && has_value && parse_u64(argv[++i], requests)) {
+      requests_set = true;
+    } else if (arg == "--rate" && has_value && parse_positive(argv[++i], rate)) {
+      rate_set = true;
+    } else if (arg == "--speed" && has_value && parse_positive(argv[++i], speed)) {
+    } else if (arg == "--seed" && has_value && parse_u64(argv[++i], seed)) {
+    } else if (arg == "--entries" && has_value && parse_u64(argv[++i], entries)) {
+    } else if (arg == "--max-in-flight" && has_value && parse_u64(argv[++i], max_in_flight) && max_in_flight > 0) {
+    } else {
+      std::fprintf(stderr, "pwledger-hostbench: invalid argument '%s'\n\n", argv[i]);
+      print_usage(stderr);
+      return 2;
+    }
+  }
+  options.seed = seed;
+  options.max_in_flight = static_cast<std::size_t>(max_in_flight);
+
+  hb::Workload workload;
+  try {
+    if (replay.empty()) {
+      workload = hb::synthetic_workload(hb::parse_mix(mix_spec), static_cast<std::size_t>(requests), rate, seed);
+    } else {
+      workload = pwledger::load_recording(replay);
+      if (requests_set && workload.size() > requests) {
+        workload.resize(static_cast<std::size_t>(requests));
+      }
+      if (rate_set) {
+        hb::retime(workload, rate);
+      } else {
+        hb::scale_time(workload, speed);
+      }
+    }
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "pwledger-hostbench: %s\n", e.what());
+    return 2;
+  }
+
+  if (!pwledger::sodium_init_once()) {
+    std::fputs("Fatal: libsodium initialization failed.\n", stderr);
+    return 1;
+  }
+
+  const bool keep_home = !home.empty();
+  if (!keep_home) {
+    std::string pattern = (std::filesystem::temp_directory_path() / "pwledger-hostbench-XXXXXX").string();
+    if (::mkdtemp(pattern.data()) == nullptr) {
+      std::perror("pwledger-hostbench: mkdtemp");
+      return 1;
+    }
+    home = pattern;
+  }
+
+  int status = 0;
+  try {
+    hb::isolate_home(home);
+    if (!json_output) {
+      std::printf("Writing %llu-entry synthetic vault under %s\n", static_cast<unsigned long long>(entries),
+                  home.string().c_str());
+      std::fflush(stdout);
+    }
+    const hb::VaultFixture fixture = hb::create_fixture(entries, seed, "pwledger-hostbench");
+    const hb::LoadReport report = hb::run_load(workload, fixture, options);
+
+    if (json_output) {
+      std::puts(report.to_json().dump(2).c_str());
+    } else {
+      print_report(report);
+    }
+    status = report.lost == 0 ? 0 : 1;
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "pwledger-hostbench: %s\n", e.what());
+    status = 1;
+  }
+
+  if (!keep_home) {
+    std::error_code ec;
+    std::filesystem::remove_all(home, ec);
+  }
+  return status;
+}
@@ -0,0 +1,225 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "AdmissionControl.h"
+#include "ResponseHelpers.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+using json = nlohmann::json;
+
+namespace pwledger {
+
+namespace {
+
+// ----------------------------------------------------------------------------
+// Per-command limits
+// ----------------------------------------------------------------------------
+// Bursts are sized for legitimate use: a browser restoring a session fires one
+// `search` per restored tab, and a user can click through several fills in a
+// row. Sustained rates sit well above human speed but far below what a page
+// script can generate. Commands absent from this table (notably `lock`) are
+// never limited: refusing to lock would be a security regression.
+struct CommandLimit {
+  const char* command;
+  double burst;
+  double per_second;
+};
+
+constexpr CommandLimit kLimits[] = {
+    {"ping", 50.0, 25.0},
+    {"search", 20.0, 10.0},
+    {"get_credentials", 10.0, 5.0},
+    {"copy", 10.0, 5.0},
+    {"clip_clear", 20.0, 10.0},
+    {"stats", 10.0, 5.0},
+    // Each unlock / init_vault runs Argon2id; UnlockBackoff applies on top.
+    {"unlock", 5.0, 0.2},
+    {"init_vault", 2.0, 0.1},
+};
+
+std::chrono::milliseconds ceil_ms(AdmissionClock::duration d) {
+  return std::chrono::ceil<std::chrono::milliseconds>(d);
+}
+
+json make_rejection(std::string_view message, std::chrono::milliseconds retry_after, const std::optional<json>& id) {
+  json r = make_error(message, id);
+  r["retry_after_ms"] = retry_after.count();
+  return r;
+}
+
+// The query compared for merging. A missing query and an empty one are the
+// same search as far as handle_search is concerned, but keeping the raw JSON
+// value (null vs "") is harmless and avoids throwing on non-string queries.
+const json& query_of(const json& request) {
+  static const json kNone;
+  const auto it = request.find("query");
+  return it != request.end() ? *it : kNone;
+}
+
+}  // anonymous namespace
+
+// ============================================================================
+// TokenBucket
+// ============================================================================
+
+TokenBucket::TokenBucket(double burst, double per_second) noexcept
+    : burst_(burst)
+    , per_second_(per_second)
+    , tokens_(burst) {
+}
+
+void TokenBucket::refill(AdmissionClock::time_point now) noexcept {
+  if (last_refill_.has_value() && now > *last_refill_) {
+    const std::chrono::duration<double> elapsed = now - *last_refill_;
+    tokens_ = std::min(burst_, tokens_ + elapsed.count() * per_second_);
+  }
+  if (!last_refill_.has_value() || now > *last_refill_) {
+    last_refill_ = now;
+  }
+}
+
+bool TokenBucket::try_acquire(AdmissionClock::time_point now) noexcept {
+  refill(now);
+  if (tokens_ < 1.0) {
+    return false;
+  }
+  tokens_ -= 1.0;
+  return true;
+}
+
+std::chrono::milliseconds TokenBucket::retry_after(AdmissionClock::time_point now) noexcept {
+  refill(now);
+  if (tokens_ >= 1.0) {
+    return std::chrono::milliseconds{0};
+  }
+  const double seconds = (1.0 - tokens_) / per_second_;
+  return std::chrono::milliseconds{static_cast<long long>(std::ceil(seconds * 1000.0))};
+}
+
+// ============================================================================
+// UnlockBackoff
+// ============================================================================
+
+std::optional<std::chrono::milliseconds> UnlockBackoff::blocked_for(AdmissionClock::time_point now) const noexcept {
+  if (failures_ == 0 || now >= not_before_) {
+    return std::nullopt;
+  }
+  return ceil_ms(not_before_ - now);
+}
+
+void UnlockBackoff::record_failure(AdmissionClock::time_point now) noexcept {
+  ++failures_;
+  // Clamp the exponent well before the shift could overflow; kMax is reached
+  // long before 2^20 anyway.
+  const int exponent = std::min(failures_ - 1, 20);
+  const auto delay = std::min<std::chrono::milliseconds>(kBase * (1LL << exponent), kMax);
+  not_before_ = now + delay;
+}
+
+void UnlockBackoff::record_success() noexcept {
+  failures_ = 0;
+  not_before_ = {};
+}
+
+// ============================================================================
+// RequestQueue
+// ============================================================================
+
+std::optional<PendingRequest> RequestQueue::push(PendingRequest req) {
+  if (req.command == "search") {
+    const json& query = query_of(req.request);
+    for (PendingRequest& queued : searches_) {
+      if (query_of(queued.request) == query) {
+        // Same result set: answer both ids from a single execution.
+        queued.ids.insert(queued.ids.end(),
+                          std::make_move_iterator(req.ids.begin()),
+                          std::make_move_iterator(req.ids.end()));
+        queued.bytes_in += req.bytes_in;
+        return std::nullopt;
+      }
+    }
+    if (size() >= kCapacity) {
+      return req;
+    }
+    if (searches_.size() >= kMaxSearches) {
+      // The newest search reflects the page the user is looking at now; the
+      // oldest is the one most likely to be stale.
+      PendingRequest shed = std::move(searches_.front());
+      searches_.pop_front();
+      searches_.push_back(std::move(req));
+      return shed;
+    }
+    searches_.push_back(std::move(req));
+    return std::nullopt;
+  }
+
+  if (size() >= kCapacity) {
+    return req;
+  }
+  priority_.push_back(std::move(req));
+  return std::nullopt;
+}
+
+PendingRequest RequestQueue::pop() {
+  std::deque<PendingRequest>& from = priority_.empty() ? searches_ : priority_;
+  PendingRequest next = std::move(from.front());
+  from.pop_front();
+  return next;
+}
+
+// ============================================================================
+// AdmissionController
+// ============================================================================
+
+AdmissionController::AdmissionController(bool rate_limits) {
+  if (!rate_limits) {
+    return;
+  }
+  for (const CommandLimit& limit : kLimits) {
+    buckets_.emplace(limit.command, TokenBucket(limit.burst, limit.per_second));
+  }
+}
+
+std::optional<json> AdmissionController::admit(std::string_view command,
+                                               const std::optional<json>& id,
+                                               AdmissionClock::time_point now) {
+  if (command == "unlock") {
+    if (const auto wait = unlock_backoff_.blocked_for(now)) {
+      return make_rejection("Too many failed unlock attempts", *wait, id);
+    }
+  }
+
+  const auto it = buckets_.find(command);
+  if (it != buckets_.end() && !it->second.try_acquire(now)) {
+    return make_rejection("Rate limited", it->second.retry_after(now), id);
+  }
+  return std::nullopt;
+}
+
+void AdmissionController::record_unlock_result(bool ok, AdmissionClock::time_point now) noexcept {
+  if (ok) {
+    unlock_backoff_.record_success();
+  } else {
+    unlock_backoff_.record_failure(now);
+  }
+}
+
+}  // namespace pwledger
@@ -0,0 +1,205 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PWLEDGER_HOST_ADMISSION_CONTROL_H
+#define PWLEDGER_HOST_ADMISSION_CONTROL_H
+
+#include <pwledger/Kernels.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+// ============================================================================
+// DESIGN NOTES
+// ============================================================================
+//
+// Admission control for the native messaging loop. Any web page can make the
+// content script send requests (one `search` per page load, more on SPA
+// navigations), and every `unlock` costs a full Argon2id derivation. Without
+// a throttle, a hostile or buggy page can keep the host busy indefinitely and
+// delay the requests a user is actually waiting for (autofill's
+// `get_credentials`).
+//
+// Three mechanisms, each owned by one class below:
+//
+//   RequestQueue     Bounded queue between framing and dispatch. The loop
+//                    drains every frame the browser has already written
+//                    before running the next one, so bursts become visible.
+//                    Identical `search` queries are merged (run once, answered
+//                    once per request id); when too many distinct searches
+//                    are waiting, the oldest is shed with a "Busy" error.
+//                    All other commands are dispatched ahead of searches, so
+//                    a search flood never sits in front of an autofill.
+//
+//   TokenBucket      Per-command rate limit, refilled continuously. Each
+//                    command has its own bucket, so exhausting `search` has
+//                    no effect on `get_credentials`. `lock` is never limited.
+//
+//   UnlockBackoff    Exponential backoff after failed unlocks. Each failure
+//                    doubles the mandatory wait before the next attempt is
+//                    even started; a success resets it.
+//
+// Rejected requests are always answered (the extension keys pending promises
+// by request id and would otherwise leak them). Rejections carry a
+// `retry_after_ms` hint.
+//
+// All time is passed in explicitly as a steady_clock time_point so that the
+// policies are deterministic under test.
+//
+// THREAD SAFETY
+// -------------
+// None. Everything here is owned by the single-threaded message loop.
+//
+// ============================================================================
+
+namespace pwledger {
+
+using AdmissionClock = std::chrono::steady_clock;
+
+// ----------------------------------------------------------------------------
+// TokenBucket
+// ----------------------------------------------------------------------------
+// Classic token bucket: holds up to `burst` tokens, refilled at `per_second`
+// tokens per second. Starts full.
+class TokenBucket {
+public:
+  TokenBucket(double burst, double per_second) noexcept;
+
+  // Takes one token if available. Returns false (and takes nothing) if the
+  // bucket is empty.
+  [[nodiscard]] bool try_acquire(AdmissionClock::time_point now) noexcept;
+
+  // Time until the next token becomes available; zero if one is available now.
+  [[nodiscard]] std::chrono::milliseconds retry_after(AdmissionClock::time_point now) noexcept;
+
+private:
+  void refill(AdmissionClock::time_point now) noexcept;
+
+  double burst_;
+  double per_second_;
+  double tokens_;
+  std::optional<AdmissionClock::time_point> last_refill_;
+};
+
+// ----------------------------------------------------------------------------
+// UnlockBackoff
+// ----------------------------------------------------------------------------
+// After the n-th consecutive failure, further attempts are refused for
+// kBase * 2^(n-1), capped at kMax.
+class UnlockBackoff {
+public:
+  static constexpr std::chrono::milliseconds kBase{500};
+  static constexpr std::chrono::milliseconds kMax{5 * 60 * 1000};
+
+  // Remaining wait before another attempt may start; nullopt if allowed now.
+  [[nodiscard]] std::optional<std::chrono::milliseconds> blocked_for(AdmissionClock::time_point now) const noexcept;
+
+  void record_failure(AdmissionClock::time_point now) noexcept;
+  void record_success() noexcept;
+
+  [[nodiscard]] int consecutive_failures() const noexcept { return failures_; }
+
+private:
+  int failures_ = 0;
+  AdmissionClock::time_point not_before_{};
+};
+
+// ----------------------------------------------------------------------------
+// PendingRequest
+// ----------------------------------------------------------------------------
+// A parsed request waiting for dispatch. `ids` has one element per original
+// request; merged searches accumulate several, and their frame sizes in
+// `bytes_in` (used for HostStats only).
+struct PendingRequest {
+  std::string command;
+  nlohmann::json request;
+  std::vector<std::optional<nlohmann::json>> ids;
+  std::uint64_t bytes_in = 0;
+};
+
+// ----------------------------------------------------------------------------
+// RequestQueue
+// ----------------------------------------------------------------------------
+class RequestQueue {
+public:
+  // Total queued requests (after merging) before new arrivals are refused.
+  static constexpr std::size_t kCapacity = 64;
+  // Distinct queued searches before the oldest is shed.
+  static constexpr std::size_t kMaxSearches = 8;
+
+  // Queues a request. Returns the request that was dropped to make room, if
+  // any: either the oldest queued search (when a new search arrives and
+  // kMaxSearches are already waiting) or `req` itself (queue full). The
+  // caller must answer every id of a dropped request.
+  [[nodiscard]] std::optional<PendingRequest> push(PendingRequest req);
+
+  // Removes the next request to dispatch: non-search commands in arrival
+  // order first, then searches in arrival order. Precondition: !empty().
+  [[nodiscard]] PendingRequest pop();
+
+  [[nodiscard]] bool empty() const noexcept { return priority_.empty() && searches_.empty(); }
+  [[nodiscard]] std::size_t size() const noexcept { return priority_.size() + searches_.size(); }
+
+private:
+  std::deque<PendingRequest> priority_;
+  std::deque<PendingRequest> searches_;
+};
+
+// ----------------------------------------------------------------------------
+// AdmissionController
+// ----------------------------------------------------------------------------
+// Per-command token buckets plus the unlock backoff. admit() is called right
+// before a request is dispatched.
+//
+// With `rate_limits` false the token buckets are omitted and only the unlock
+// backoff applies. That is for tests and load testing only: pwledger-host
+// always keeps them, and only pwledger-host-bench, a build of the same
+// sources for pwledger-hostbench, reads PWLEDGER_HOST_RATE_LIMITS=off, where
+// the limits would otherwise cap the measured throughput at the bucket
+// refill rates.
+class AdmissionController {
+public:
+  explicit AdmissionController(bool rate_limits = true);
+
+  // Returns nullopt if the command may run now, or the error response to
+  // send instead. Unknown commands are admitted (dispatch rejects them).
+  [[nodiscard]] std::optional<nlohmann::json> admit(std::string_view command,
+                                                    const std::optional<nlohmann::json>& id,
+                                                    AdmissionClock::time_point now);
+
+  // Feeds the outcome of an admitted `unlock` back into the backoff.
+  void record_unlock_result(bool ok, AdmissionClock::time_point now) noexcept;
+
+private:
+  std::unordered_map<std::string, TokenBucket, kernels::StringHash, std::equal_to<>> buckets_;
+  UnlockBackoff unlock_backoff_;
+};
+
+}  // namespace pwledger
+
+#endif  // PWLEDGER_HOST_ADMISSION_CONTROL_H
@@ -21,6 +21,8 @@
 #include "StringUtils.h"
 
 #include <pwledger/Clipboard.h>
+#include <pwledger/MemoryStats.h>
+#include <pwledger/SodiumInit.h>
 #include <pwledger/VaultIO.h>
 #include <pwledger/VaultPath.h>
 #include <pwledger/uuid.h>
@@ -37,6 +39,20 @@ using json = nlohmann::json;
 
 namespace pwledger {
 
+namespace {
+
+// Parses req["uuid"] in place rather than copying the string out of the
+// request first. Missing, non-string and malformed values all yield nullopt.
+std::optional<Uuid> uuid_field(const json& req) {
+  const auto it = req.find("uuid");
+  if (it == req.end() || !it->is_string()) {
+    return std::nullopt;
+  }
+  return Uuid::from_chars(it->get_ref<const std::string&>());
+}
+
+}  // anonymous namespace
+
 // ----------------------------------------------------------------------------
 // handle_ping
 // ----------------------------------------------------------------------------
@@ -61,6 +77,12 @@ namespace pwledger {
                                  PrimaryTable&  table,
                                  const Config&  cfg,
                                  std::optional<json> id) {
+  // libsodium is initialized on the first command that needs it rather than
+  // at process start; see the cold-start notes in main.cc.
+  if (!sodium_init_once()) {
+    return make_error("libsodium initialization failed", id);
+  }
+
   std::string password = req.value("password", "");
 
   json response = make_error("Vault load failed", id);
@@ -110,6 +132,10 @@ namespace pwledger {
                                      PrimaryTable&  /*table*/,
                                      const Config&  cfg,
                                      std::optional<json> id) {
+  if (!sodium_init_once()) {
+    return make_error("libsodium initialization failed", id);
+  }
+
   std::string password = req.value("password", "");
 
   if (password.empty()) {
@@ -187,8 +213,7 @@ namespace pwledger {
 [[nodiscard]] json handle_copy(const json&    req,
                                PrimaryTable&  table,
                                std::optional<json> id) {
-  const std::string uuid_str = req.value("uuid", "");
-  const auto uuid = Uuid::from_string(uuid_str);
+  const auto uuid = uuid_field(req);
 
   if (!uuid) {
     return make_error("Invalid UUID", id);
@@ -227,8 +252,7 @@ namespace pwledger {
 [[nodiscard]] json handle_get_credentials(const json&    req,
                                           PrimaryTable&  table,
                                           std::optional<json> id) {
-  const std::string uuid_str = req.value("uuid", "");
-  const auto uuid = Uuid::from_string(uuid_str);
+  const auto uuid = uuid_field(req);
 
   if (!uuid) {
     return make_error("Invalid UUID", id);
@@ -257,4 +281,21 @@ namespace pwledger {
   return r;
 }
 
+// ----------------------------------------------------------------------------
+// handle_stats
+// ----------------------------------------------------------------------------
+// Returns request counters and latency percentiles per command, and the
+// secure-memory accounting from MemoryStats.h. Available while locked: the
+// payload carries no vault content (see HostStats.h); the table section is
+// simply empty then.
+[[nodiscard]] json handle_stats(const json&          /*req*/,
+                                const PrimaryTable&  table,
+                                const HostStats&     stats,
+                                std::optional<json>  id) {
+  json r = make_ok(id);
+  r["stats"] = stats.to_json();
+  r["memory"] = memory_stats_json(&table);
+  return r;
+}
+
 }  // namespace pwledger
@@ -19,6 +19,8 @@
 #ifndef PWLEDGER_HOST_COMMAND_HANDLERS_H
 #define PWLEDGER_HOST_COMMAND_HANDLERS_H
 
+#include "HostStats.h"
+
 #include <pwledger/Config.h>
 #include <pwledger/PrimaryTable.h>
 
@@ -71,6 +73,11 @@ enum class VaultState {
                                                      PrimaryTable& table,
                                                      std::optional<nlohmann::json> id);
 
+[[nodiscard]] nlohmann::json handle_stats(const nlohmann::json& req,
+                                           const PrimaryTable& table,
+                                           const HostStats& stats,
+                                           std::optional<nlohmann::json> id);
+
 }  // namespace pwledger
 
 #endif  // PWLEDGER_HOST_COMMAND_HANDLERS_H
@@ -0,0 +1,180 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "HostStats.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+using json = nlohmann::json;
+
+namespace pwledger {
+
+// ============================================================================
+// LatencyHistogram
+// ============================================================================
+
+std::size_t LatencyHistogram::bucket_index(std::uint64_t value_us) noexcept {
+  constexpr std::uint64_t kLinearLimit = std::uint64_t{1} << kLinearLimitBits;
+  constexpr std::uint64_t kMaxValue = (std::uint64_t{1} << kMaxValueBits) - 1;
+
+  value_us = std::min(value_us, kMaxValue);
+  if (value_us < kLinearLimit) {
+    return static_cast<std::size_t>(value_us);
+  }
+  // Octave m holds [2^m, 2^(m+1)); its top kSubBucketBits + 1 bits select
+  // the sub-bucket.
+  const unsigned m = static_cast<unsigned>(std::bit_width(value_us)) - 1;
+  const std::uint64_t sub = (value_us >> (m - kSubBucketBits)) - (std::uint64_t{1} << kSubBucketBits);
+  return static_cast<std::size_t>(kLinearLimit + (m - kLinearLimitBits) * (std::uint64_t{1} << kSubBucketBits) + sub);
+}
+
+std::uint64_t LatencyHistogram::bucket_upper_bound(std::size_t index) noexcept {
+  constexpr std::size_t kLinearLimit = std::size_t{1} << kLinearLimitBits;
+  constexpr std::size_t kSubBuckets = std::size_t{1} << kSubBucketBits;
+
+  if (index < kLinearLimit) {
+    return index;
+  }
+  const std::size_t k = index - kLinearLimit;
+  const unsigned m = kLinearLimitBits + static_cast<unsigned>(k / kSubBuckets);
+  const std::uint64_t sub = k % kSubBuckets;
+  const unsigned shift = m - kSubBucketBits;
+  return ((kSubBuckets + sub) << shift) + (std::uint64_t{1} << shift) - 1;
+}
+
+void LatencyHistogram::record(std::chrono::nanoseconds latency) noexcept {
+  const auto ns = std::max<std::chrono::nanoseconds::rep>(latency.count(), 0);
+  const auto us = static_cast<std::uint64_t>(ns / 1000);
+
+  ++buckets_[bucket_index(us)];
+  ++count_;
+  sum_us_ += us;
+  min_us_ = std::min(min_us_, us);
+  max_us_ = std::max(max_us_, us);
+}
+
+double LatencyHistogram::mean_us() const noexcept {
+  return count_ == 0 ? 0.0 : static_cast<double>(sum_us_) / static_cast<double>(count_);
+}
+
+std::uint64_t LatencyHistogram::value_at_quantile(double quantile) const noexcept {
+  if (count_ == 0) {
+    return 0;
+  }
+  const double clamped = std::clamp(quantile, 0.0, 1.0);
+  const auto target =
+      std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(clamped * static_cast<double>(count_))));
+
+  std::uint64_t seen = 0;
+  for (std::size_t i = 0; i < kBucketCount; ++i) {
+    seen += buckets_[i];
+    if (seen >= target) {
+      // The bucket bound can overshoot the largest value actually seen.
+      return std::min(bucket_upper_bound(i), max_us_);
+    }
+  }
+  return max_us_;
+}
+
+json LatencyHistogram::to_json() const {
+  return {
+      {"count", count_},
+      {"min_us", min_us()},
+      {"mean_us", mean_us()},
+      {"p50_us", value_at_quantile(0.50)},
+      {"p90_us", value_at_quantile(0.90)},
+      {"p99_us", value_at_quantile(0.99)},
+      {"p999_us", value_at_quantile(0.999)},
+      {"max_us", max_us_},
+  };
+}
+
+// ============================================================================
+// HostStats
+// ============================================================================
+
+HostStats::HostStats() : started_(std::chrono::steady_clock::now()) {
+}
+
+CommandStats& HostStats::slot(std::string_view command) {
+  auto it = commands_.find(command);
+  if (it == commands_.end()) {
+    it = commands_.emplace(std::string(command), CommandStats{}).first;
+  }
+  return it->second;
+}
+
+void HostStats::record(std::string_view command,
+                       std::chrono::nanoseconds latency,
+                       bool ok,
+                       std::uint64_t requests,
+                       std::uint64_t bytes_in,
+                       std::uint64_t bytes_out) {
+  CommandStats& s = slot(command);
+  s.requests += requests;
+  if (!ok) {
+    s.errors += requests;
+  }
+  s.bytes_in += bytes_in;
+  s.bytes_out += bytes_out;
+  s.latency.record(latency);
+}
+
+void HostStats::record_rejected(std::string_view command,
+                                std::uint64_t requests,
+                                std::uint64_t bytes_in,
+                                std::uint64_t bytes_out) {
+  CommandStats& s = slot(command);
+  s.requests += requests;
+  s.errors += requests;
+  s.bytes_in += bytes_in;
+  s.bytes_out += bytes_out;
+}
+
+json HostStats::to_json() const {
+  json commands = json::object();
+  std::uint64_t requests = 0;
+  std::uint64_t errors = 0;
+  std::uint64_t bytes_in = 0;
+  std::uint64_t bytes_out = 0;
+
+  for (const auto& [name, s] : commands_) {
+    commands[name] = {
+        {"requests", s.requests},
+        {"errors", s.errors},
+        {"bytes_in", s.bytes_in},
+        {"bytes_out", s.bytes_out},
+        {"latency", s.latency.to_json()},
+    };
+    requests += s.requests;
+    errors += s.errors;
+    bytes_in += s.bytes_in;
+    bytes_out += s.bytes_out;
+  }
+
+  const auto uptime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started_);
+  return {
+      {"uptime_ms", uptime.count()},
+      {"totals", {{"requests", requests}, {"errors", errors}, {"bytes_in", bytes_in}, {"bytes_out", bytes_out}}},
+      {"commands", std::move(commands)},
+  };
+}
+
+}  // namespace pwledger
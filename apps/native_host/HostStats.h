@@ -0,0 +1,155 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PWLEDGER_HOST_HOST_STATS_H
+#define PWLEDGER_HOST_HOST_STATS_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+
+#include <nlohmann/json.hpp>
+
+// ============================================================================
+// DESIGN NOTES
+// ============================================================================
+//
+// Per-command request statistics for the native host: latency histograms
+// plus request, error and byte counters. Recorded by run_message_loop for
+// every dispatched request, returned by the `stats` command and, if
+// PWLEDGER_HOST_STATS is set, written out when the host exits.
+//
+// LATENCY HISTOGRAM
+// -----------------
+// HDR-style log-linear buckets over microseconds: exact below 64 us, then 32
+// linear sub-buckets per power of two, i.e. every recorded value is
+// reported within ~3% (one sub-bucket). Recording is an index computation
+// and an increment into a fixed array: no allocation, no sorting, and
+// constant memory (~9 KiB per command) however long the browser session.
+// Values beyond ~12 days are clamped into the top bucket.
+//
+// NO SECRET MATERIAL
+// ------------------
+// Only command names from the dispatch table, counts, byte totals and
+// durations are stored. Request fields (queries, UUIDs, passwords) are
+// never looked at, and requests naming an unknown command are filed under
+// the fixed key "unknown" rather than under the name the sender supplied.
+//
+// THREAD SAFETY
+// -------------
+// None; owned by the single-threaded message loop.
+//
+// ============================================================================
+
+namespace pwledger {
+
+// ----------------------------------------------------------------------------
+// LatencyHistogram
+// ----------------------------------------------------------------------------
+class LatencyHistogram {
+public:
+  static constexpr unsigned kSubBucketBits = 5;                              // 32 per octave
+  static constexpr unsigned kLinearLimitBits = kSubBucketBits + 1;           // exact below 64
+  static constexpr unsigned kMaxValueBits = 40;                              // ~12.7 days in us
+  static constexpr std::size_t kBucketCount =
+      (std::size_t{1} << kLinearLimitBits) + (kMaxValueBits - kLinearLimitBits) * (std::size_t{1} << kSubBucketBits);
+
+  void record(std::chrono::nanoseconds latency) noexcept;
+
+  [[nodiscard]] std::uint64_t count() const noexcept { return count_; }
+  [[nodiscard]] std::uint64_t min_us() const noexcept { return count_ == 0 ? 0 : min_us_; }
+  [[nodiscard]] std::uint64_t max_us() const noexcept { return max_us_; }
+  [[nodiscard]] double mean_us() const noexcept;
+
+  // Smallest bucket upper bound such that at least `quantile` (0..1] of the
+  // recorded values are at or below it. 0 if nothing was recorded.
+  [[nodiscard]] std::uint64_t value_at_quantile(double quantile) const noexcept;
+
+  // {count, min, mean, p50, p90, p99, p999, max}, all in microseconds.
+  [[nodiscard]] nlohmann::json to_json() const;
+
+  // Exposed for tests.
+  [[nodiscard]] static std::size_t bucket_index(std::uint64_t value_us) noexcept;
+  [[nodiscard]] static std::uint64_t bucket_upper_bound(std::size_t index) noexcept;
+
+private:
+  std::array<std::uint64_t, kBucketCount> buckets_{};
+  std::uint64_t count_ = 0;
+  std::uint64_t sum_us_ = 0;
+  std::uint64_t min_us_ = UINT64_MAX;
+  std::uint64_t max_us_ = 0;
+};
+
+// ----------------------------------------------------------------------------
+// CommandStats
+// ----------------------------------------------------------------------------
+struct CommandStats {
+  std::uint64_t requests = 0;
+  std::uint64_t errors = 0;
+  std::uint64_t bytes_in = 0;
+  std::uint64_t bytes_out = 0;
+  LatencyHistogram latency;
+};
+
+// ----------------------------------------------------------------------------
+// HostStats
+// ----------------------------------------------------------------------------
+class HostStats {
+public:
+  // Key used for requests that never reached a known command (malformed
+  // JSON, unknown command name).
+  static constexpr std::string_view kUnknownCommand = "unknown";
+
+  HostStats();
+
+  // One dispatched execution of `command`. `requests` is the number of
+  // request ids it answered (merged searches answer several). Only commands
+  // present in the dispatch table may be passed.
+  void record(std::string_view command,
+              std::chrono::nanoseconds latency,
+              bool ok,
+              std::uint64_t requests,
+              std::uint64_t bytes_in,
+              std::uint64_t bytes_out);
+
+  // `requests` request ids answered without dispatching (malformed, unknown,
+  // shed or rate-limited). Always counted as errors; no latency is recorded.
+  void record_rejected(std::string_view command,
+                       std::uint64_t requests,
+                       std::uint64_t bytes_in,
+                       std::uint64_t bytes_out);
+
+  [[nodiscard]] const std::map<std::string, CommandStats, std::less<>>& commands() const noexcept { return commands_; }
+
+  // {"uptime_ms": ..., "totals": {...}, "commands": {name: {...}}}
+  [[nodiscard]] nlohmann::json to_json() const;
+
+private:
+  CommandStats& slot(std::string_view command);
+
+  std::chrono::steady_clock::time_point started_;
+  std::map<std::string, CommandStats, std::less<>> commands_;
+};
+
+}  // namespace pwledger
+
+#endif  // PWLEDGER_HOST_HOST_STATS_H
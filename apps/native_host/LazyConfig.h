@@ -0,0 +1,78 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PWLEDGER_HOST_LAZY_CONFIG_H
+#define PWLEDGER_HOST_LAZY_CONFIG_H
+
+#include <pwledger/Config.h>
+#include <pwledger/ThreadPool.h>
+
+#include <cstdio>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace pwledger {
+
+// ----------------------------------------------------------------------------
+// LazyConfig
+// ----------------------------------------------------------------------------
+// Defers reading config.json until a command actually needs a setting.
+//
+// The browser launches a fresh host process on every connectNative call, and
+// the first request is usually a `search` against a locked vault, which needs
+// no configuration at all. Parsing the JSON file on startup therefore sits on
+// the critical path of the first response for nothing. get() loads on first
+// use and caches the result for the lifetime of the process.
+//
+// Load failures follow the same policy main() used to apply eagerly: log a
+// warning and fall back to compiled defaults.
+//
+// Not thread-safe; owned and used by the single-threaded message loop.
+class LazyConfig {
+public:
+  // Loads from default_config_path() on first get().
+  LazyConfig() = default;
+
+  // Uses an already-loaded configuration (tests, embedding callers).
+  explicit LazyConfig(Config cfg) : cfg_(std::move(cfg)) {}
+
+  [[nodiscard]] const Config& get() {
+    if (!cfg_.has_value()) {
+      try {
+        cfg_ = load_config();
+      } catch (const std::exception& e) {
+        std::fprintf(stderr, "Warning: Failed to load config: %s. Using defaults.\n", e.what());
+        cfg_.emplace();
+      }
+      // Unlock is the first command that needs both the settings and the
+      // pool (multi-lane Argon2id), so the pool is sized here.
+      ThreadPool::configure_shared(cfg_->thread_pool);
+    }
+    return *cfg_;
+  }
+
+  [[nodiscard]] bool loaded() const noexcept { return cfg_.has_value(); }
+
+private:
+  std::optional<Config> cfg_;
+};
+
+}  // namespace pwledger
+
+#endif  // PWLEDGER_HOST_LAZY_CONFIG_H
@@ -17,17 +17,27 @@
  */
 
 #include "MessageLoop.h"
+#include "AdmissionControl.h"
 #include "CommandHandlers.h"
+#include "HostStats.h"
 #include "NativeMessaging.h"
 #include "ResponseHelpers.h"
+#include "SessionRecorder.h"
 
 #include <pwledger/ClipboardTimer.h>
 #include <pwledger/PrimaryTable.h>
 
-#include <iostream>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
 
 #include <nlohmann/json.hpp>
 
@@ -46,7 +56,9 @@ namespace pwledger {
 
 // Handler signature is intentionally wide to accommodate all commands
 // without overloading. Unused parameters are named with /**/ in handlers.
-using Handler = json (*)(const json&, VaultState&, PrimaryTable&, const Config&, std::optional<json>);
+// Configuration is passed as a LazyConfig so that only the commands which
+// read a setting pay for loading config.json.
+using Handler = json (*)(const json&, VaultState&, PrimaryTable&, LazyConfig&, HostStats&, std::optional<json>);
 
 struct CommandDescriptor {
   bool requires_unlock;
@@ -58,37 +70,41 @@ struct CommandDescriptor {
 namespace {
 
 json dispatch_ping(const json& req, VaultState& state,
-                   PrimaryTable& table, const Config& /*cfg*/, std::optional<json> id) {
+                   PrimaryTable& table, LazyConfig& /*cfg*/, HostStats& /*stats*/, std::optional<json> id) {
   return handle_ping(req, state, table, std::move(id));
 }
 json dispatch_unlock(const json& req, VaultState& state,
-                     PrimaryTable& table, const Config& cfg, std::optional<json> id) {
-  return handle_unlock(req, state, table, cfg, std::move(id));
+                     PrimaryTable& table, LazyConfig& cfg, HostStats& /*stats*/, std::optional<json> id) {
+  return handle_unlock(req, state, table, cfg.get(), std::move(id));
 }
 json dispatch_lock(const json& req, VaultState& state,
-                   PrimaryTable& table, const Config& /*cfg*/, std::optional<json> id) {
+                   PrimaryTable& table, LazyConfig& /*cfg*/, HostStats& /*stats*/, std::optional<json> id) {
   return handle_lock(req, state, table, std::move(id));
 }
 json dispatch_init_vault(const json& req, VaultState& state,
-                         PrimaryTable& table, const Config& cfg, std::optional<json> id) {
-  return handle_init_vault(req, state, table, cfg, std::move(id));
+                         PrimaryTable& table, LazyConfig& cfg, HostStats& /*stats*/, std::optional<json> id) {
+  return handle_init_vault(req, state, table, cfg.get(), std::move(id));
 }
 json dispatch_search(const json& req, VaultState& /*state*/,
-                     PrimaryTable& table, const Config& /*cfg*/, std::optional<json> id) {
+                     PrimaryTable& table, LazyConfig& /*cfg*/, HostStats& /*stats*/, std::optional<json> id) {
   return handle_search(req, table, std::move(id));
 }
 json dispatch_copy(const json& req, VaultState& /*state*/,
-                   PrimaryTable& table, const Config& /*cfg*/, std::optional<json> id) {
+                   PrimaryTable& table, LazyConfig& /*cfg*/, HostStats& /*stats*/, std::optional<json> id) {
   return handle_copy(req, table, std::move(id));
 }
 json dispatch_clip_clear(const json& req, VaultState& /*state*/,
-                         PrimaryTable& /*table*/, const Config& /*cfg*/, std::optional<json> id) {
+                         PrimaryTable& /*table*/, LazyConfig& /*cfg*/, HostStats& /*stats*/, std::optional<json> id) {
   return handle_clip_clear(req, std::move(id));
 }
 json dispatch_get_credentials(const json& req, VaultState& /*state*/,
-                              PrimaryTable& table, const Config& /*cfg*/, std::optional<json> id) {
+                              PrimaryTable& table, LazyConfig& /*cfg*/, HostStats& /*stats*/, std::optional<json> id) {
   return handle_get_credentials(req, table, std::move(id));
 }
+json dispatch_stats(const json& req, VaultState& /*state*/,
+                    PrimaryTable& table, LazyConfig& /*cfg*/, HostStats& stats, std::optional<json> id) {
+  return handle_stats(req, table, stats, std::move(id));
+}
 
 }  // anonymous namespace
 
@@ -101,63 +117,222 @@ const std::unordered_map<std::string, CommandDescriptor> kCommands{
   { "copy",              { /*requires_unlock=*/true,  dispatch_copy              } },
   { "clip_clear",        { /*requires_unlock=*/false, dispatch_clip_clear        } },
   { "get_credentials",   { /*requires_unlock=*/true,  dispatch_get_credentials   } },
+  { "stats",             { /*requires_unlock=*/false, dispatch_stats             } },
 };
 
 // ============================================================================
 // Message loop
 // ============================================================================
+//
+// Each turn of the loop has two phases:
+//
+//   intake    Every frame the browser has already written is read, parsed
+//             and pushed onto the RequestQueue (bounded per turn). The loop
+//             only blocks in read_message() when there is nothing queued.
+//             Malformed and unknown requests are answered here, since they
+//             cost nothing to reject.
+//   dispatch  One request is popped, checked by the AdmissionController and,
+//             if admitted, run. The response is written once per original
+//             request id (merged searches have several).
+//
+// Every request is accounted in HostStats: dispatched ones with their
+// latency (admission + handler, excluding the response write), rejected
+// ones as errors. See AdmissionControl.h for the queueing and rate-limit
+// policies and HostStats.h for what is (and is not) recorded. With
+// PWLEDGER_HOST_RECORD set, the shape of each accepted request is also
+// appended to a replayable recording (SessionRecorder.h).
+
+namespace {
+
+// Upper bound on frames read per intake phase, so that a sender which keeps
+// the pipe permanently non-empty cannot starve dispatch.
+constexpr std::size_t kMaxFramesPerIntake = RequestQueue::kCapacity;
+
+// Size of a frame as read from the pipe: length prefix plus payload.
+std::uint64_t frame_bytes(const std::string& payload) {
+  return sizeof(std::uint32_t) + payload.size();
+}
+
+void answer_busy(const PendingRequest& dropped, HostStats& stats) {
+  std::uint64_t bytes_out = 0;
+  for (const auto& id : dropped.ids) {
+    bytes_out += write_message(make_error("Busy", id));
+  }
+  stats.record_rejected(dropped.command, dropped.ids.size(), dropped.bytes_in, bytes_out);
+}
+
+// Parses one frame and queues it, or answers it immediately if it is
+// malformed or names an unknown command. Accepted requests are passed to
+// `recorder` when session recording is on.
+void intake(const std::string& raw, RequestQueue& queue, HostStats& stats, SessionRecorder* recorder) {
+  const std::uint64_t bytes_in = frame_bytes(raw);
+  std::optional<json> req_id;
+  try {
+    json req = json::parse(raw);
 
-void run_message_loop(const Config& cfg) {
+    if (req.contains("id")) {
+      req_id = req["id"];
+    }
+
+    std::string cmd = req.value("command", "");
+    if (kCommands.find(cmd) == kCommands.end()) {
+      const std::size_t out = write_message(make_error("Unknown command", req_id));
+      stats.record_rejected(HostStats::kUnknownCommand, 1, bytes_in, out);
+      return;
+    }
+
+    if (recorder != nullptr) {
+      recorder->record(cmd, req, SessionRecorder::Clock::now());
+    }
+
+    if (auto dropped = queue.push(PendingRequest{std::move(cmd), std::move(req), {req_id}, bytes_in})) {
+      answer_busy(*dropped, stats);
+    }
+  } catch (const json::parse_error&) {
+    const std::size_t out = write_message(make_error("Invalid JSON", req_id));
+    stats.record_rejected(HostStats::kUnknownCommand, 1, bytes_in, out);
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "Warning: failed to queue request: %s\n", e.what());
+    const std::size_t out = write_message(make_error("Internal error", req_id));
+    stats.record_rejected(HostStats::kUnknownCommand, 1, bytes_in, out);
+  }
+}
+
+// Writes `response` once per id of `req`, rewriting the echoed id for merged
+// requests. Returns the total bytes written.
+std::uint64_t answer(const PendingRequest& req, json& response) {
+  std::uint64_t bytes_out = 0;
+  for (const auto& id : req.ids) {
+    if (id.has_value()) {
+      response["id"] = *id;
+    } else {
+      response.erase("id");
+    }
+    bytes_out += write_message(response);
+  }
+  return bytes_out;
+}
+
+// Writes the final statistics if PWLEDGER_HOST_STATS names a destination:
+// a file path, or "-" for stderr (stdout is the protocol channel).
+void dump_stats_if_requested(const HostStats& stats) noexcept {
+  const char* dest = std::getenv("PWLEDGER_HOST_STATS");
+  if (dest == nullptr || *dest == '\0') {
+    return;
+  }
+  try {
+    const std::string text = stats.to_json().dump(2) + "\n";
+    if (std::string_view(dest) == "-") {
+      std::fputs(text.c_str(), stderr);
+      return;
+    }
+    std::FILE* f = std::fopen(dest, "w");
+    if (f == nullptr) {
+      std::fprintf(stderr, "Warning: cannot write host stats to %s\n", dest);
+      return;
+    }
+    std::fputs(text.c_str(), f);
+    std::fclose(f);
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "Warning: failed to dump host stats: %s\n", e.what());
+  }
+}
+
+#ifdef PWLEDGER_HOST_BENCH_KNOBS
+// PWLEDGER_HOST_RATE_LIMITS=off disables the per-command token buckets; see
+// AdmissionController. Only pwledger-host-bench, the build pwledger-hostbench
+// drives, compiles this in: the shipped host always applies the limits.
+bool rate_limits_from_env() noexcept {
+  const char* value = std::getenv("PWLEDGER_HOST_RATE_LIMITS");
+  return value == nullptr || std::string_view(value) != "off";
+}
+#endif
+
+}  // anonymous namespace
+
+void run_message_loop(LazyConfig& cfg) {
   PrimaryTable table;
   VaultState   state = VaultState::Locked;
   ClipboardTimer clip_timer;
+  RequestQueue queue;
+#ifdef PWLEDGER_HOST_BENCH_KNOBS
+  AdmissionController admission(rate_limits_from_env());
+#else
+  AdmissionController admission;
+#endif
+  HostStats stats;
+  const std::unique_ptr<SessionRecorder> recorder = SessionRecorder::from_env();
+
+  bool input_closed = false;
 
   for (;;) {
-    auto raw = read_message();
-    if (!raw.has_value()) {
-      break;  // EOF, I/O error, or oversized message; terminate cleanly
+    // ---- intake ----
+    if (queue.empty()) {
+      if (input_closed) {
+        break;
+      }
+      auto raw = read_message();
+      if (!raw.has_value()) {
+        break;  // EOF, I/O error, or oversized message; terminate cleanly
+      }
+      intake(*raw, queue, stats, recorder.get());
+    }
+    for (std::size_t n = 0; !input_closed && n < kMaxFramesPerIntake && message_pending(); ++n) {
+      auto raw = read_message();
+      if (!raw.has_value()) {
+        // Requests already queued are still answered before exiting.
+        input_closed = true;
+        break;
+      }
+      intake(*raw, queue, stats, recorder.get());
+    }
+    if (queue.empty()) {
+      continue;  // everything read this turn was answered during intake
     }
 
-    // Extract the request ID early so it can be echoed in every response,
-    // including parse-error responses.
-    std::optional<json> req_id;
+    // ---- dispatch ----
+    const PendingRequest next = queue.pop();
+    const std::optional<json>& req_id = next.ids.front();
+    const auto started = std::chrono::steady_clock::now();
     json response;
 
-    try {
-      json req = json::parse(*raw);
-
-      if (req.contains("id")) {
-        req_id = req["id"];
-      }
+    if (auto rejection = admission.admit(next.command, req_id, started)) {
+      response = std::move(*rejection);
+      stats.record_rejected(next.command, next.ids.size(), next.bytes_in, answer(next, response));
+      continue;
+    }
 
-      const std::string cmd = req.value("command", "");
-      const auto it = kCommands.find(cmd);
+    try {
+      const CommandDescriptor& desc = kCommands.at(next.command);
 
-      if (it == kCommands.end()) {
-        response = make_error("Unknown command", req_id);
-      } else if (it->second.requires_unlock && state != VaultState::Unlocked) {
+      if (desc.requires_unlock && state != VaultState::Unlocked) {
         response = make_error("Locked", req_id);
       } else {
-        response = it->second.handle(req, state, table, cfg, req_id);
+        response = desc.handle(next.request, state, table, cfg, stats, req_id);
+
+        if (next.command == "unlock") {
+          admission.record_unlock_result(response.value("status", "") == "ok", AdmissionClock::now());
+        }
 
         // Schedule auto-clear after a successful clipboard copy.
-        if (response.value("status", "") == "ok" && cmd == "copy") {
-          const int timeout = cfg.security.clear_clipboard_seconds;
+        if (response.value("status", "") == "ok" && next.command == "copy") {
+          const int timeout = cfg.get().security.clear_clipboard_seconds;
           if (timeout > 0) {
             clip_timer.schedule(timeout);
           }
         }
       }
-    } catch (const json::parse_error&) {
-      response = make_error("Invalid JSON", req_id);
     } catch (const std::exception& e) {
-      std::cerr << "Warning: unhandled exception in command handler: "
-                << e.what() << '\n';
+      std::fprintf(stderr, "Warning: unhandled exception in command handler: %s\n", e.what());
       response = make_error("Internal error", req_id);
     }
 
-    write_message(response);
+    const auto latency = std::chrono::steady_clock::now() - started;
+    const bool ok = response.value("status", "") == "ok";
+    stats.record(next.command, latency, ok, next.ids.size(), next.bytes_in, answer(next, response));
   }
+
+  dump_stats_if_requested(stats);
 }
 
 }  // namespace pwledger
@@ -19,13 +19,15 @@
 #ifndef PWLEDGER_HOST_MESSAGE_LOOP_H
 #define PWLEDGER_HOST_MESSAGE_LOOP_H
 
-#include <pwledger/Config.h>
+#include "LazyConfig.h"
 
 namespace pwledger {
 
 // Runs the Native Messaging message loop, reading commands from stdin
 // and writing JSON responses to stdout until EOF or a fatal error.
-void run_message_loop(const Config& cfg);
+// The configuration is only loaded when a command first needs it (see
+// LazyConfig.h).
+void run_message_loop(LazyConfig& cfg);
 
 }  // namespace pwledger
 
@@ -18,8 +18,18 @@
 
 #include "NativeMessaging.h"
 
-#include <iostream>
 #include <bit>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#  include <io.h>
+#  include <windows.h>
+#else
+#  include <poll.h>
+#  include <unistd.h>
+#endif
 
 namespace pwledger {
 
@@ -32,6 +42,74 @@ static_assert(
     "Native Messaging length prefix assumes little-endian byte order. "
     "Add a byte-swap here for big-endian platforms.");
 
+// ============================================================================
+// Raw descriptor I/O
+// ============================================================================
+//
+// Framing goes straight to file descriptors 0 and 1 instead of std::cin and
+// std::cout. The host is started fresh by the browser for every connectNative
+// call, so anything on the path to the first response is paid on every cold
+// start; the iostream layer (locale setup, sync_with_stdio buffering, sentry
+// objects per read) is pure overhead for a protocol that only ever moves
+// length-prefixed byte blocks. Each frame is one read of the prefix, one read
+// of the body, and a single write of prefix + body.
+
+namespace {
+
+#ifdef _WIN32
+constexpr int kStdinFd = 0;
+constexpr int kStdoutFd = 1;
+#else
+constexpr int kStdinFd = STDIN_FILENO;
+constexpr int kStdoutFd = STDOUT_FILENO;
+#endif
+
+// Reads exactly `len` bytes, retrying on short reads and EINTR. Returns false
+// on EOF or any other error.
+bool read_exact(int fd, char* buf, std::size_t len) noexcept {
+  std::size_t done = 0;
+  while (done < len) {
+#ifdef _WIN32
+    const int n = _read(fd, buf + done, static_cast<unsigned int>(len - done));
+#else
+    const ssize_t n = ::read(fd, buf + done, len - done);
+#endif
+    if (n == 0) {
+      return false;  // EOF
+    }
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    done += static_cast<std::size_t>(n);
+  }
+  return true;
+}
+
+// Writes all `len` bytes, retrying on short writes and EINTR.
+bool write_all(int fd, const char* buf, std::size_t len) noexcept {
+  std::size_t done = 0;
+  while (done < len) {
+#ifdef _WIN32
+    const int n = _write(fd, buf + done, static_cast<unsigned int>(len - done));
+#else
+    const ssize_t n = ::write(fd, buf + done, len - done);
+#endif
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    done += static_cast<std::size_t>(n);
+  }
+  return true;
+}
+
+}  // anonymous namespace
+
 // ----------------------------------------------------------------------------
 // read_message
 // ----------------------------------------------------------------------------
@@ -39,7 +117,7 @@ static_assert(
 //   [uint32_t length (little-endian)] [length bytes of UTF-8 JSON]
 [[nodiscard]] std::optional<std::string> read_message() {
   uint32_t length = 0;
-  if (!std::cin.read(reinterpret_cast<char*>(&length), sizeof(length))) {
+  if (!read_exact(kStdinFd, reinterpret_cast<char*>(&length), sizeof(length))) {
     return std::nullopt;  // EOF or I/O error; caller terminates the loop
   }
 
@@ -50,41 +128,101 @@ static_assert(
   if (length > kMaxMessageBytes) {
     // Reject without reading the body; the stream is now out of sync.
     // Return nullopt to signal a fatal framing error and terminate.
-    std::cerr << "Fatal: incoming message length " << length
-              << " exceeds limit " << kMaxMessageBytes << "; terminating\n";
+    std::fprintf(stderr, "Fatal: incoming message length %u exceeds limit %u; terminating\n",
+                 static_cast<unsigned>(length), static_cast<unsigned>(kMaxMessageBytes));
     return std::nullopt;
   }
 
   std::string payload(length, '\0');
-  if (!std::cin.read(payload.data(), length)) {
+  if (!read_exact(kStdinFd, payload.data(), length)) {
     return std::nullopt;
   }
   return payload;
 }
 
+// ----------------------------------------------------------------------------
+// message_pending
+// ----------------------------------------------------------------------------
+// Zero-timeout readiness check on stdin. The browser connects the host over
+// a pipe on every platform, so poll(2) / PeekNamedPipe are sufficient.
+[[nodiscard]] bool message_pending() noexcept {
+#ifdef _WIN32
+  const HANDLE in = reinterpret_cast<HANDLE>(_get_osfhandle(kStdinFd));
+  DWORD available = 0;
+  if (in == INVALID_HANDLE_VALUE || !PeekNamedPipe(in, nullptr, 0, nullptr, &available, nullptr)) {
+    // A broken pipe means EOF is pending; let read_message() observe it.
+    return GetLastError() == ERROR_BROKEN_PIPE;
+  }
+  return available > 0;
+#else
+  pollfd pfd{};
+  pfd.fd = kStdinFd;
+  pfd.events = POLLIN;
+  for (;;) {
+    const int n = ::poll(&pfd, 1, 0);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    // POLLHUP without POLLIN is EOF, which read_message() reports.
+    return n > 0 && (pfd.revents & (POLLIN | POLLHUP)) != 0;
+  }
+#endif
+}
+
+// ----------------------------------------------------------------------------
+// encode_message / decode_message
+// ----------------------------------------------------------------------------
+// In-memory framing, shared by write_message and usable without a pipe (the
+// benchmarks exercise the framing round trip through these).
+[[nodiscard]] std::optional<std::string> encode_message(const nlohmann::json& msg) {
+  std::string frame(sizeof(uint32_t), '\0');
+  frame += msg.dump();
+  const std::size_t payload_size = frame.size() - sizeof(uint32_t);
+  if (payload_size > kMaxMessageBytes) {
+    return std::nullopt;
+  }
+
+  const uint32_t length = static_cast<uint32_t>(payload_size);
+  std::memcpy(frame.data(), &length, sizeof(length));
+  return frame;
+}
+
+[[nodiscard]] std::optional<std::string_view> decode_message(std::string_view buffer) noexcept {
+  uint32_t length = 0;
+  if (buffer.size() < sizeof(length)) {
+    return std::nullopt;
+  }
+  std::memcpy(&length, buffer.data(), sizeof(length));
+  if (length > kMaxMessageBytes || buffer.size() - sizeof(length) < length) {
+    return std::nullopt;
+  }
+  return buffer.substr(sizeof(length), length);
+}
+
 // ----------------------------------------------------------------------------
 // write_message
 // ----------------------------------------------------------------------------
-// Writes one Native Messaging frame to stdout.
-void write_message(const nlohmann::json& msg) noexcept {
+// Writes one Native Messaging frame to stdout. The prefix and payload are
+// assembled into one buffer so the frame leaves in a single write(2); the
+// browser never observes a prefix without its body.
+std::size_t write_message(const nlohmann::json& msg) noexcept {
   try {
-    const std::string payload = msg.dump();
-
-    if (payload.size() > kMaxMessageBytes) {
+    const auto frame = encode_message(msg);
+    if (!frame.has_value()) {
       // Response too large to send under the protocol limit.
-      std::cerr << "Warning: outgoing message too large ("
-                << payload.size() << " bytes); sending error response\n";
-      write_message({{"status", "error"}, {"message", "Response too large"}});
-      return;
+      std::fputs("Warning: outgoing message too large; sending error response\n", stderr);
+      return write_message({{"status", "error"}, {"message", "Response too large"}});
     }
 
-    const uint32_t length = static_cast<uint32_t>(payload.size());
-    std::cout.write(reinterpret_cast<const char*>(&length), sizeof(length));
-    std::cout.write(payload.data(), static_cast<std::streamsize>(payload.size()));
-    std::cout.flush();
+    if (!write_all(kStdoutFd, frame->data(), frame->size())) {
+      std::fputs("Warning: write_message failed: short write to stdout\n", stderr);
+      return 0;
+    }
+    return frame->size();
   } catch (const std::exception& e) {
     // write_message is called from noexcept contexts; swallow and log.
-    std::cerr << "Warning: write_message failed: " << e.what() << '\n';
+    std::fprintf(stderr, "Warning: write_message failed: %s\n", e.what());
+    return 0;
   }
 }
 
@@ -19,9 +19,11 @@
 #ifndef PWLEDGER_HOST_NATIVE_MESSAGING_H
 #define PWLEDGER_HOST_NATIVE_MESSAGING_H
 
+#include <cstddef>
 #include <cstdint>
 #include <optional>
 #include <string>
+#include <string_view>
 
 #include <nlohmann/json.hpp>
 
@@ -38,9 +40,24 @@ constexpr uint32_t kMaxMessageBytes = 1024u * 1024u;  // 1 MiB
 // if the declared length exceeds kMaxMessageBytes.
 [[nodiscard]] std::optional<std::string> read_message();
 
-// Writes one Native Messaging frame to stdout.
+// Returns true if stdin has data (or EOF) ready, i.e. read_message() would
+// not block. Used by the message loop to drain a burst of frames into its
+// queue before dispatching. Returns false on error.
+[[nodiscard]] bool message_pending() noexcept;
+
+// Encodes `msg` as one frame: [uint32_t length][JSON]. Returns nullopt if the
+// serialized payload exceeds kMaxMessageBytes.
+[[nodiscard]] std::optional<std::string> encode_message(const nlohmann::json& msg);
+
+// Returns the payload of the frame at the start of `buffer`, or nullopt if the
+// buffer holds an incomplete frame or the declared length exceeds
+// kMaxMessageBytes. The returned view aliases `buffer`.
+[[nodiscard]] std::optional<std::string_view> decode_message(std::string_view buffer) noexcept;
+
+// Writes one Native Messaging frame to stdout and returns the number of
+// bytes written (prefix included), or 0 on failure.
 // stdout must be in binary mode (see _setmode call in main).
-void write_message(const nlohmann::json& msg) noexcept;
+std::size_t write_message(const nlohmann::json& msg) noexcept;
 
 }  // namespace pwledger
 
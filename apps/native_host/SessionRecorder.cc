@@ -0,0 +1,139 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "SessionRecorder.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+using json = nlohmann::json;
+
+namespace pwledger {
+
+RequestShape shape_of(std::string_view command, const json& request, std::uint64_t at_us) {
+  RequestShape shape;
+  shape.at_us = at_us;
+  shape.command = std::string(command);
+  if (command == "search") {
+    const auto it = request.find("query");
+    if (it != request.end() && it->is_string()) {
+      shape.query_len = it->get_ref<const std::string&>().size();
+    }
+  }
+  return shape;
+}
+
+json to_json(const RequestShape& shape) {
+  json j = {{"at_us", shape.at_us}, {"command", shape.command}};
+  if (shape.command == "search") {
+    j["query_len"] = shape.query_len;
+  }
+  return j;
+}
+
+RequestShape shape_from_json(const json& j) {
+  if (!j.is_object() || !j.contains("command") || !j["command"].is_string()) {
+    throw std::runtime_error("request shape has no command");
+  }
+  RequestShape shape;
+  shape.command = j["command"].get<std::string>();
+  try {
+    shape.at_us = j.value("at_us", std::uint64_t{0});
+    shape.query_len = j.value("query_len", std::size_t{0});
+  } catch (const json::exception&) {
+    throw std::runtime_error("request shape has a non-numeric at_us or query_len");
+  }
+  return shape;
+}
+
+std::vector<RequestShape> load_recording(const std::filesystem::path& path) {
+  std::ifstream in(path);
+  if (!in) {
+    throw std::runtime_error("cannot open recording: " + path.string());
+  }
+
+  std::vector<RequestShape> shapes;
+  std::string line;
+  for (std::size_t line_no = 1; std::getline(in, line); ++line_no) {
+    if (line.find_first_not_of(" \t\r") == std::string::npos) {
+      continue;
+    }
+    try {
+      shapes.push_back(shape_from_json(json::parse(line)));
+    } catch (const std::exception& e) {
+      throw std::runtime_error(path.string() + ":" + std::to_string(line_no) + ": " + e.what());
+    }
+  }
+  return shapes;
+}
+
+// ----------------------------------------------------------------------------
+// SessionRecorder
+// ----------------------------------------------------------------------------
+
+std::unique_ptr<SessionRecorder> SessionRecorder::from_env() {
+  const char* path = std::getenv("PWLEDGER_HOST_RECORD");
+  if (path == nullptr || *path == '\0') {
+    return nullptr;
+  }
+  try {
+    return std::make_unique<SessionRecorder>(path);
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "Warning: session recording disabled: %s\n", e.what());
+    return nullptr;
+  }
+}
+
+SessionRecorder::SessionRecorder(const std::filesystem::path& path) {
+  file_ = std::fopen(path.string().c_str(), "a");
+  if (file_ == nullptr) {
+    throw std::runtime_error("cannot open " + path.string());
+  }
+}
+
+SessionRecorder::~SessionRecorder() {
+  if (file_ != nullptr) {
+    std::fclose(file_);
+  }
+}
+
+void SessionRecorder::record(std::string_view command, const json& request, Clock::time_point arrived) noexcept {
+  if (file_ == nullptr) {
+    return;
+  }
+  if (!started_) {
+    first_ = arrived;
+    started_ = true;
+  }
+  const auto at = std::chrono::duration_cast<std::chrono::microseconds>(arrived - first_).count();
+
+  try {
+    const std::string line = to_json(shape_of(command, request, static_cast<std::uint64_t>(at))).dump() + "\n";
+    if (std::fputs(line.c_str(), file_) < 0 || std::fflush(file_) != 0) {
+      throw std::runtime_error("write failed");
+    }
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "Warning: session recording stopped: %s\n", e.what());
+    std::fclose(file_);
+    file_ = nullptr;
+  }
+}
+
+}  // namespace pwledger
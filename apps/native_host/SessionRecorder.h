@@ -0,0 +1,113 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PWLEDGER_HOST_SESSION_RECORDER_H
+#define PWLEDGER_HOST_SESSION_RECORDER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+// ============================================================================
+// DESIGN NOTES
+// ============================================================================
+//
+// Records the *shape* of the traffic a real browser session sends to the
+// host, so that pwledger-hostbench can replay a realistic request mix.
+// Enabled by setting PWLEDGER_HOST_RECORD to an output path; the host then
+// appends one JSON object per accepted request (JSON Lines):
+//
+//   {"at_us":1520331,"command":"search","query_len":7}
+//
+// WHAT IS RECORDED
+// ----------------
+// Only the arrival time (microseconds since the first recorded request),
+// the command name, and for `search` the query length. Never the query
+// text, uuids, passwords, request ids or responses: a recording must be
+// safe to share, and the search query alone usually names the site being
+// visited. The replay driver synthesizes the missing fields (a substring of
+// a real primary key of the recorded length, a uuid from the test vault,
+// the test vault's password).
+//
+// Malformed and unknown requests are not recorded; they carry no useful
+// shape and could contain arbitrary content.
+//
+// ============================================================================
+
+namespace pwledger {
+
+// One request as seen by the host, stripped of everything but its shape.
+struct RequestShape {
+  std::uint64_t at_us = 0;
+  std::string command;
+  std::size_t query_len = 0;  // search only
+};
+
+// Extracts the shape of a parsed request for `command`.
+[[nodiscard]] RequestShape shape_of(std::string_view command, const nlohmann::json& request, std::uint64_t at_us);
+
+[[nodiscard]] nlohmann::json to_json(const RequestShape& shape);
+
+// Throws std::runtime_error if `j` has no command or malformed fields.
+[[nodiscard]] RequestShape shape_from_json(const nlohmann::json& j);
+
+// Reads a JSON Lines recording. Blank lines are skipped; any malformed line
+// throws std::runtime_error naming the line number.
+[[nodiscard]] std::vector<RequestShape> load_recording(const std::filesystem::path& path);
+
+// ----------------------------------------------------------------------------
+// SessionRecorder
+// ----------------------------------------------------------------------------
+// Appends request shapes to a recording. Each line is flushed as it is
+// written, so a host that is killed by the browser keeps its recording up
+// to the last request. I/O errors are reported once on stderr and disable
+// the recorder; recording never affects request handling.
+class SessionRecorder {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  // Returns a recorder for PWLEDGER_HOST_RECORD, or nullptr if the variable
+  // is unset or the file cannot be opened.
+  [[nodiscard]] static std::unique_ptr<SessionRecorder> from_env();
+
+  // Throws std::runtime_error if `path` cannot be opened for appending.
+  explicit SessionRecorder(const std::filesystem::path& path);
+  ~SessionRecorder();
+
+  SessionRecorder(const SessionRecorder&) = delete;
+  SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+  void record(std::string_view command, const nlohmann::json& request, Clock::time_point arrived) noexcept;
+
+private:
+  std::FILE* file_ = nullptr;
+  Clock::time_point first_{};
+  bool started_ = false;
+};
+
+}  // namespace pwledger
+
+#endif  // PWLEDGER_HOST_SESSION_RECORDER_H
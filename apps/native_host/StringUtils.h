@@ -19,28 +19,19 @@
 #ifndef PWLEDGER_HOST_STRING_UTILS_H
 #define PWLEDGER_HOST_STRING_UTILS_H
 
-#include <algorithm>
-#include <cctype>
+#include <pwledger/Kernels.h>
+
 #include <string_view>
 
 namespace pwledger {
 
-// Case-insensitive substring search. Both haystack and needle are converted
-// to lowercase for comparison. This is ASCII-only; non-ASCII characters are
-// passed through unchanged (acceptable for URL/domain/email matching).
+// Case-insensitive substring search. ASCII-only: A-Z and a-z compare equal,
+// every other byte (including non-ASCII) must match exactly, which is
+// acceptable for URL/domain/email matching. Runs the SIMD search kernel
+// selected for this CPU (see Kernels.h).
 [[nodiscard]] inline bool icontains(std::string_view haystack,
                                     std::string_view needle) noexcept {
-  if (needle.empty()) { return true; }
-  if (needle.size() > haystack.size()) { return false; }
-
-  auto to_lower = [](unsigned char c) { return std::tolower(c); };
-
-  return std::search(
-      haystack.begin(), haystack.end(),
-      needle.begin(),   needle.end(),
-      [&](unsigned char a, unsigned char b) {
-          return to_lower(a) == to_lower(b);
-      }) != haystack.end();
+  return kernels::icontains(haystack, needle);
 }
 
 }  // namespace pwledger
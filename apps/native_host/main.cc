@@ -30,31 +30,42 @@
 //   - Message framing and size limits (NativeMessaging.h)
 //   - Dispatch table and auto-lock (MessageLoop.h)
 //
+// COLD START
+// ----------
+// The browser spawns a new host for every connectNative call, and the first
+// request (typically a `search` from the content script) waits for the whole
+// startup path. Only work that must precede the first Secret happens here:
+//   - harden_process() stays eager; it must run before any secret exists.
+//   - libsodium is initialized by sodium_init_once() in the unlock and
+//     init_vault handlers, the only entry points that allocate secrets.
+//   - config.json is parsed by LazyConfig on first use.
+//   - Framing uses raw file descriptors, not iostreams (NativeMessaging.cc).
+// tests/test_host_startup.cc measures time to first response and enforces
+// a budget on it.
+//
 // ============================================================================
 
 // On Windows, stdin/stdout must be switched to binary mode before any I/O.
 #ifdef _WIN32
 #  include <fcntl.h>
 #  include <io.h>
+
+#  include <cstdio>
 #endif
 
+#include "LazyConfig.h"
 #include "MessageLoop.h"
 
-#include <pwledger/Config.h>
 #include <pwledger/ProcessHardening.h>
 
-#include <iostream>
-
-#include <sodium.h>
-
 // ============================================================================
 // Entry point
 // ============================================================================
 
 int main() {
   // On Windows, stdin/stdout must be switched to binary mode before any I/O.
-  // This must be done before sodium_init and before the message loop to
-  // prevent text-mode translation of the raw length prefix bytes.
+  // This must be done before the message loop to prevent text-mode
+  // translation of the raw length prefix bytes.
 #ifdef _WIN32
   _setmode(_fileno(stdin),  _O_BINARY);
   _setmode(_fileno(stdout), _O_BINARY);
@@ -64,21 +75,8 @@ int main() {
   // See ProcessHardening.h and Secret.h "KNOWN LIMITATIONS".
   pwledger::harden_process();
 
-  // sodium_init must be called once before any Secret is constructed.
-  // Returns 0 on success, 1 if already initialized, -1 on failure.
-  if (sodium_init() < 0) {
-    std::cerr << "Fatal: libsodium initialization failed\n";
-    return 1;
-  }
-
-  // Load user configuration (missing file -> defaults).
-  pwledger::Config cfg;
-  try {
-    cfg = pwledger::load_config();
-  } catch (const std::exception& e) {
-    std::cerr << "Warning: Failed to load config: " << e.what()
-              << ". Using defaults.\n";
-  }
+  // User configuration is loaded on first use (missing file -> defaults).
+  pwledger::LazyConfig cfg;
 
   pwledger::run_message_loop(cfg);
   return 0;
@@ -0,0 +1,232 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BenchCounters.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace pwledger::bench {
+
+namespace {
+
+bool perf_disabled_by_env() {
+  const char* env = std::getenv("PWLEDGER_BENCH_PERF");
+  return env != nullptr && std::string_view(env) == "off";
+}
+
+#ifdef __linux__
+struct EventSpec {
+  std::uint32_t type;
+  std::uint64_t config;
+};
+
+// Same order as PerfCounters::kNames.
+constexpr std::array<EventSpec, PerfCounters::kEvents> kEventSpecs = {{
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                             (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+}};
+
+int open_event(const EventSpec& spec, bool exclude_kernel) {
+  perf_event_attr attr{};
+  attr.size = sizeof(attr);
+  attr.type = spec.type;
+  attr.config = spec.config;
+  attr.disabled = 1;
+  attr.exclude_kernel = exclude_kernel ? 1 : 0;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+}
+#endif
+
+}  // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// PerfCounters
+// ----------------------------------------------------------------------------
+
+PerfCounters& PerfCounters::for_this_thread() {
+  thread_local PerfCounters counters;
+  return counters;
+}
+
+PerfCounters::PerfCounters() {
+  fds_.fill(-1);
+#ifdef __linux__
+  // Try user+kernel first; perf_event_paranoid >= 2 only allows user-space
+  // counting, which the kernel reports as EACCES.
+  bool exclude_kernel = false;
+  int first_error = 0;
+  for (std::size_t i = 0; i < kEvents; ++i) {
+    int fd = open_event(kEventSpecs[i], exclude_kernel);
+    if (fd < 0 && (errno == EACCES || errno == EPERM) && !exclude_kernel) {
+      exclude_kernel = true;
+      fd = open_event(kEventSpecs[i], exclude_kernel);
+    }
+    if (fd < 0 && first_error == 0) {
+      first_error = errno;
+    }
+    fds_[i] = fd;
+  }
+
+  static std::atomic<bool> noted{false};
+  if (!noted.exchange(true)) {
+    if (first_error != 0) {
+      std::fprintf(stderr, "pwledger_bench: perf_event_open: %s; not reporting", std::strerror(first_error));
+      for (std::size_t i = 0; i < kEvents; ++i) {
+        if (!has(i)) std::fprintf(stderr, " %s", kNames[i]);
+      }
+      std::fputc('\n', stderr);
+    }
+    if (exclude_kernel && any()) {
+      std::fprintf(stderr, "pwledger_bench: perf_event_paranoid restricts counters to user space\n");
+    }
+  }
+#else
+  static std::atomic<bool> noted{false};
+  if (!noted.exchange(true)) {
+    std::fprintf(stderr, "pwledger_bench: hardware counters are only supported on Linux\n");
+  }
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+  for (const int fd : fds_) {
+    if (fd >= 0) ::close(fd);
+  }
+#endif
+}
+
+bool PerfCounters::any() const noexcept {
+  for (std::size_t i = 0; i < kEvents; ++i) {
+    if (has(i)) return true;
+  }
+  return false;
+}
+
+void PerfCounters::reset_and_enable() noexcept {
+#ifdef __linux__
+  for (const int fd : fds_) {
+    if (fd >= 0) {
+      ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+#endif
+}
+
+void PerfCounters::enable() noexcept {
+#ifdef __linux__
+  for (const int fd : fds_) {
+    if (fd >= 0) ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+#endif
+}
+
+void PerfCounters::disable() noexcept {
+#ifdef __linux__
+  for (const int fd : fds_) {
+    if (fd >= 0) ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+  }
+#endif
+}
+
+PerfCounters::Values PerfCounters::read() const noexcept {
+  Values values{};
+#ifdef __linux__
+  for (std::size_t i = 0; i < kEvents; ++i) {
+    std::uint64_t buf[3] = {};  // value, time enabled, time running
+    if (fds_[i] < 0 || ::read(fds_[i], buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf))) {
+      continue;
+    }
+    values[i] = static_cast<double>(buf[0]);
+    if (buf[2] != 0 && buf[2] < buf[1]) {
+      values[i] *= static_cast<double>(buf[1]) / static_cast<double>(buf[2]);
+    }
+  }
+#endif
+  return values;
+}
+
+// ----------------------------------------------------------------------------
+// BenchCounters
+// ----------------------------------------------------------------------------
+
+BenchCounters::BenchCounters(benchmark::State& state)
+    : state_(state)
+    , perf_(nullptr) {
+  if (!perf_disabled_by_env()) {
+    PerfCounters& perf = PerfCounters::for_this_thread();
+    if (perf.any()) perf_ = &perf;
+  }
+  start_ = allocation_count();
+  if (perf_ != nullptr) perf_->reset_and_enable();
+}
+
+BenchCounters::~BenchCounters() {
+  if (perf_ != nullptr) perf_->disable();
+  const AllocationCount end = allocation_count();
+
+  using benchmark::Counter;
+  state_.counters["allocs"] =
+      Counter(static_cast<double>(end.allocations - start_.allocations - excluded_.allocations),
+              Counter::kAvgIterations);
+  state_.counters["alloc_bytes"] = Counter(static_cast<double>(end.bytes - start_.bytes - excluded_.bytes),
+                                           Counter::kAvgIterations, Counter::kIs1024);
+
+  if (perf_ != nullptr) {
+    const PerfCounters::Values values = perf_->read();
+    for (std::size_t i = 0; i < PerfCounters::kEvents; ++i) {
+      if (perf_->has(i)) {
+        state_.counters[PerfCounters::kNames[i]] = Counter(values[i], Counter::kAvgIterations);
+      }
+    }
+  }
+}
+
+void BenchCounters::pause() noexcept {
+  if (perf_ != nullptr) perf_->disable();
+  paused_at_ = allocation_count();
+}
+
+void BenchCounters::resume() noexcept {
+  const AllocationCount now = allocation_count();
+  excluded_.allocations += now.allocations - paused_at_.allocations;
+  excluded_.bytes += now.bytes - paused_at_.bytes;
+  if (perf_ != nullptr) perf_->enable();
+}
+
+}  // namespace pwledger::bench
@@ -0,0 +1,151 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PWLEDGER_BENCH_COUNTERS_H
+#define PWLEDGER_BENCH_COUNTERS_H
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// ============================================================================
+// DESIGN NOTES
+// ============================================================================
+//
+// Per-benchmark counters beyond wall time, so that a regression in the JSON
+// output comes with its explanation: more instructions, more cache or dTLB
+// misses (every Secret access is an mprotect pair, and each one flushes TLB
+// entries), more page faults, more context switches, or more heap
+// allocations.
+//
+// HARDWARE COUNTERS
+// -----------------
+// Read through perf_event_open(2), one independent event per counter so that
+// an event the CPU or hypervisor does not support is simply left out. Events
+// count user and kernel time when perf_event_paranoid allows it (mprotect is
+// kernel work), user time only otherwise. When perf_event_open is missing
+// altogether (non-Linux, containers with a seccomp filter, paranoid level 3)
+// a single note goes to stderr and only allocation counters are reported.
+// Set PWLEDGER_BENCH_PERF=off to skip them deliberately, e.g. to save the
+// syscalls when measuring sub-microsecond benchmarks.
+//
+// ALLOCATION COUNTERS
+// -------------------
+// pwledger_bench replaces the global operator new/delete
+// (AllocationHooks.cc) with versions that bump two relaxed atomics and
+// forward to malloc. This counts every std:: container and string
+// allocation on any thread; sodium_malloc regions are not heap allocations
+// and are not counted (see MemoryStats.h for those).
+//
+// USAGE
+// -----
+// Construct a BenchCounters right before the timing loop and bracket
+// PauseTiming/ResumeTiming with pause()/resume(); the destructor adds
+// per-iteration averages to state.counters:
+//
+//   BenchCounters counters(state);
+//   for (auto _ : state) {
+//     ...
+//     state.PauseTiming();
+//     counters.pause();
+//     ...
+//     counters.resume();
+//     state.ResumeTiming();
+//   }
+//
+// ============================================================================
+
+namespace pwledger::bench {
+
+// ----------------------------------------------------------------------------
+// Allocation counts (AllocationHooks.cc)
+// ----------------------------------------------------------------------------
+struct AllocationCount {
+  std::uint64_t allocations = 0;
+  std::uint64_t bytes = 0;
+};
+
+[[nodiscard]] AllocationCount allocation_count() noexcept;
+
+// ----------------------------------------------------------------------------
+// PerfCounters
+// ----------------------------------------------------------------------------
+// The calling thread's hardware/software counters. Opened once per thread
+// on first use; benchmarks run on the thread that calls their function.
+class PerfCounters {
+ public:
+  static constexpr std::size_t kEvents = 6;
+
+  // Counter names as they appear in the benchmark output.
+  static constexpr std::array<const char*, kEvents> kNames = {
+      "cycles", "instructions", "cache_misses", "dtlb_misses", "page_faults", "ctx_switches",
+  };
+
+  using Values = std::array<double, kEvents>;
+
+  static PerfCounters& for_this_thread();
+
+  ~PerfCounters();
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  // True if event i opened. Values of events that did not open are 0.
+  [[nodiscard]] bool has(std::size_t i) const noexcept { return fds_[i] >= 0; }
+  [[nodiscard]] bool any() const noexcept;
+
+  void reset_and_enable() noexcept;
+  void enable() noexcept;
+  void disable() noexcept;
+
+  // Counts since reset_and_enable, scaled up if the kernel multiplexed the
+  // event (ran it for only part of the time it was enabled).
+  [[nodiscard]] Values read() const noexcept;
+
+ private:
+  PerfCounters();
+
+  std::array<int, kEvents> fds_;
+};
+
+// ----------------------------------------------------------------------------
+// BenchCounters
+// ----------------------------------------------------------------------------
+class BenchCounters {
+ public:
+  explicit BenchCounters(benchmark::State& state);
+  ~BenchCounters();
+
+  BenchCounters(const BenchCounters&) = delete;
+  BenchCounters& operator=(const BenchCounters&) = delete;
+
+  void pause() noexcept;
+  void resume() noexcept;
+
+ private:
+  benchmark::State& state_;
+  PerfCounters* perf_;  // nullptr when disabled or unavailable
+  AllocationCount start_;
+  AllocationCount paused_at_;
+  AllocationCount excluded_;
+};
+
+}  // namespace pwledger::bench
+
+#endif  // PWLEDGER_BENCH_COUNTERS_H
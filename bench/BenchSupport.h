@@ -0,0 +1,126 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PWLEDGER_BENCH_SUPPORT_H
+#define PWLEDGER_BENCH_SUPPORT_H
+
+#include "BenchCounters.h"
+
+#include <pwledger/PrimaryTable.h>
+#include <pwledger/SecretEntry.h>
+#include <pwledger/SodiumInit.h>
+#include <pwledger/VaultCrypto.h>
+#include <pwledger/uuid.h>
+
+#include <benchmark/benchmark.h>
+#include <sodium.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+// ============================================================================
+// DESIGN NOTES
+// ============================================================================
+//
+// Shared fixtures for pwledger_bench. Every benchmark takes the vault size
+// (number of entries) as its first argument, swept from 10 to 1M in decades,
+// so that results from different commits line up by name in the JSON output.
+//
+// TABLE-BACKED BENCHMARKS
+// -----------------------
+// Each SecretEntry owns two Secrets, and every Secret is a separate
+// sodium_malloc allocation with its own guard pages and canary: four kernel
+// mappings apiece, so eight per entry. With the stock vm.max_map_count of
+// 65530 a process cannot hold much more than 8k entries, let alone the 1M
+// the sweep goes up to (which would also need tens of GB of address space
+// and mlock'd memory). Benchmarks that need a real PrimaryTable are
+// therefore capped at kDefaultMaxTableEntries, leaving room for the second
+// table a deserialize builds; set PWLEDGER_BENCH_MAX_TABLE_ENTRIES to raise
+// the cap on a machine with a raised vm.max_map_count. Benchmarks over plain
+// bytes or strings (AEAD, UUID, icontains, framing) run the full range.
+//
+// ============================================================================
+
+namespace pwledger::bench {
+
+inline constexpr std::int64_t kMinEntries = 10;
+inline constexpr std::int64_t kMaxEntries = 1'000'000;
+inline constexpr std::int64_t kDefaultMaxTableEntries = 1'000;
+
+// Secret size used by the CLI for new entries (see EntryOps.cc).
+inline constexpr std::size_t kSecretBytes = 256;
+
+inline void init_sodium() {
+  if (!sodium_init_once()) {
+    throw std::runtime_error("libsodium init failed");
+  }
+}
+
+// 10, 100, ..., `max_entries`.
+inline void apply_sizes(benchmark::internal::Benchmark* b, std::int64_t max_entries) {
+  for (std::int64_t n = kMinEntries; n <= max_entries; n *= 10) {
+    b->Arg(n);
+  }
+}
+
+// Full sweep, for benchmarks that do not materialize a PrimaryTable.
+inline void vault_sizes(benchmark::internal::Benchmark* b) {
+  apply_sizes(b, kMaxEntries);
+}
+
+// Sweep capped for benchmarks that build a PrimaryTable (see DESIGN NOTES).
+inline void table_sizes(benchmark::internal::Benchmark* b) {
+  std::int64_t cap = kDefaultMaxTableEntries;
+  if (const char* env = std::getenv("PWLEDGER_BENCH_MAX_TABLE_ENTRIES")) {
+    cap = std::strtoll(env, nullptr, 10);
+  }
+  apply_sizes(b, std::min(cap, kMaxEntries));
+}
+
+// Deterministic, realistic-looking identifiers: distinct per index and long
+// enough that substring search does real work.
+inline std::string primary_key_for(std::size_t i) {
+  return "login.site" + std::to_string(i) + ".example.com";
+}
+
+inline std::string username_for(std::size_t i) {
+  return "user" + std::to_string(i) + "@mail.example.org";
+}
+
+inline PrimaryTable make_table(std::size_t entries) {
+  init_sodium();
+
+  PrimaryTable table;
+  table.reserve(entries);
+  for (std::size_t i = 0; i < entries; ++i) {
+    SecretEntry entry(primary_key_for(i), username_for(i), kSecretBytes, VaultCrypto::kSaltBytes);
+    entry.plaintext_secret.with_write_access([](std::span<char> buf) { randombytes_buf(buf.data(), buf.size()); });
+    entry.salt.with_write_access([](std::span<char> buf) { randombytes_buf(buf.data(), buf.size()); });
+    table.emplace(Uuid::generate(), std::move(entry));
+  }
+  return table;
+}
+
+}  // namespace pwledger::bench
+
+#endif  // PWLEDGER_BENCH_SUPPORT_H
@@ -0,0 +1,109 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BenchSupport.h"
+
+#include <pwledger/CompletionIndex.h>
+
+#include <cstring>
+#include <string>
+
+using namespace pwledger;
+using namespace pwledger::bench;
+
+namespace {
+
+Uuid uuid_for(std::size_t i) {
+  Uuid uuid;
+  std::memcpy(uuid.bytes.data(), &i, sizeof(i));
+  uuid.bytes[15] = 1;
+  return uuid;
+}
+
+// Both keys of n synthetic entries, as the CLI indexes them.
+CompletionIndex make_index(std::size_t n) {
+  CompletionIndex index;
+  for (std::size_t i = 0; i < n; ++i) {
+    index.insert(primary_key_for(i), uuid_for(i));
+    index.insert(username_for(i), uuid_for(i));
+  }
+  return index;
+}
+
+}  // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// CompletionIndex
+// ----------------------------------------------------------------------------
+
+static void BM_CompletionBuild(benchmark::State& state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    CompletionIndex index = make_index(n);
+    benchmark::DoNotOptimize(index.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CompletionBuild)->Apply(vault_sizes)->Unit(benchmark::kMillisecond);
+
+// One keystroke as the entry picker handles it: narrow the cursor, count
+// the matches and fetch the first screenful of candidates. Each iteration
+// types a whole key and erases it again; items are keystrokes.
+static void BM_CompletionKeystroke(benchmark::State& state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  const CompletionIndex index = make_index(n);
+  const std::string typed = primary_key_for(n / 2);
+  constexpr std::size_t kShown = 10;
+
+  BenchCounters counters(state);
+  auto cursor = index.cursor();
+  for (auto _ : state) {
+    for (const char c : typed) {
+      cursor.push(c);
+      benchmark::DoNotOptimize(cursor.count());
+      benchmark::DoNotOptimize(cursor.candidates(kShown));
+    }
+    for (std::size_t i = 0; i < typed.size(); ++i) {
+      cursor.pop();
+      benchmark::DoNotOptimize(cursor.count());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(typed.size() * 2));
+}
+BENCHMARK(BM_CompletionKeystroke)->Apply(vault_sizes);
+
+// Keeping the index current: add one entry's keys and remove them again.
+static void BM_CompletionUpdate(benchmark::State& state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  CompletionIndex index = make_index(n);
+  const std::string key = primary_key_for(n + 1);
+  const std::string user = username_for(n + 1);
+  const Uuid uuid = uuid_for(n + 1);
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    index.insert(key, uuid);
+    index.insert(user, uuid);
+    index.erase(key, uuid);
+    index.erase(user, uuid);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CompletionUpdate)->Apply(vault_sizes);
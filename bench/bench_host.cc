@@ -0,0 +1,117 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BenchSupport.h"
+
+#include "CommandHandlers.h"
+#include "NativeMessaging.h"
+#include "StringUtils.h"
+
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+using namespace pwledger;
+using namespace pwledger::bench;
+using json = nlohmann::json;
+
+namespace {
+
+// Matches every key whose index starts with 9 (roughly one in nine), so the
+// result-building path is exercised as well as the scan. Upper case to
+// exercise the case folding.
+constexpr char kQuery[] = "SITE9";
+
+}  // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// Search
+// ----------------------------------------------------------------------------
+
+static void BM_IContains(benchmark::State& state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  std::vector<std::string> keys(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    keys[i] = primary_key_for(i);
+  }
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    std::size_t hits = 0;
+    for (const std::string& k : keys) {
+      if (icontains(k, kQuery)) {
+        ++hits;
+      }
+    }
+    benchmark::DoNotOptimize(hits);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_IContains)->Apply(vault_sizes);
+
+static void BM_HandleSearch(benchmark::State& state) {
+  const PrimaryTable table = make_table(static_cast<std::size_t>(state.range(0)));
+  const json req = {{"command", "search"}, {"query", kQuery}, {"id", 1}};
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    json r = handle_search(req, table, json(1));
+    benchmark::DoNotOptimize(r);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_HandleSearch)->Apply(table_sizes);
+
+// ----------------------------------------------------------------------------
+// Native messaging framing
+// ----------------------------------------------------------------------------
+// A burst of n search requests, as a page-heavy browser session produces:
+// encode every frame into one buffer, then decode and parse them back.
+
+static void BM_FramingRoundTrip(benchmark::State& state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  std::vector<json> requests(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    requests[i] = {{"command", "search"}, {"query", primary_key_for(i)}, {"id", i}};
+  }
+
+  std::string wire;
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    wire.clear();
+    for (const json& r : requests) {
+      wire += *encode_message(r);
+    }
+
+    std::string_view rest = wire;
+    std::size_t parsed = 0;
+    while (const auto payload = decode_message(rest)) {
+      json msg = json::parse(*payload);
+      benchmark::DoNotOptimize(msg);
+      rest.remove_prefix(sizeof(std::uint32_t) + payload->size());
+      ++parsed;
+    }
+    benchmark::DoNotOptimize(parsed);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(wire.size()));
+}
+BENCHMARK(BM_FramingRoundTrip)->Apply(vault_sizes);
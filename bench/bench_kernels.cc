@@ -0,0 +1,137 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BenchSupport.h"
+
+#include <pwledger/Kernels.h>
+
+#include <string>
+#include <vector>
+
+using namespace pwledger;
+using namespace pwledger::bench;
+using pwledger::kernels::KernelSet;
+
+// ----------------------------------------------------------------------------
+// SIMD kernels, every variant
+// ----------------------------------------------------------------------------
+// Each kernel is registered once per variant this CPU supports, named
+// BM_Kernel<Name>/<isa>/<arg>, so one run compares scalar against every SIMD
+// level side by side. The end-to-end benchmarks (BM_IContains,
+// BM_UuidToChars, ...) run whichever variant PWLEDGER_SIMD selects.
+
+namespace {
+
+// Byte sizes: a UUID, a secret buffer, a small and a large decrypted vault.
+void byte_sizes(benchmark::internal::Benchmark* b) {
+  for (const std::int64_t n : {16, 256, 4096, 65536, 1 << 20}) {
+    b->Arg(n);
+  }
+}
+
+std::vector<std::uint8_t> random_bytes(std::size_t n) {
+  init_sodium();
+  std::vector<std::uint8_t> v(n);
+  randombytes_buf(v.data(), v.size());
+  return v;
+}
+
+void BM_KernelIContains(benchmark::State& state, const KernelSet* k) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  std::vector<std::string> keys(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    keys[i] = primary_key_for(i);
+  }
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    std::size_t hits = 0;
+    for (const std::string& key : keys) {
+      if (k->icontains(key, "SITE9")) {
+        ++hits;
+      }
+    }
+    benchmark::DoNotOptimize(hits);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_KernelHexEncode(benchmark::State& state, const KernelSet* k) {
+  const std::vector<std::uint8_t> in = random_bytes(static_cast<std::size_t>(state.range(0)));
+  std::string out(2 * in.size(), '\0');
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    k->hex_encode(in.data(), in.size(), out.data());
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void BM_KernelHexDecode(benchmark::State& state, const KernelSet* k) {
+  const std::vector<std::uint8_t> bytes = random_bytes(static_cast<std::size_t>(state.range(0)));
+  std::string hex(2 * bytes.size(), '\0');
+  k->hex_encode(bytes.data(), bytes.size(), hex.data());
+  std::vector<std::uint8_t> out(bytes.size());
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    bool ok = k->hex_decode(hex.data(), out.size(), out.data());
+    benchmark::DoNotOptimize(ok);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void BM_KernelCrc32c(benchmark::State& state, const KernelSet* k) {
+  const std::vector<std::uint8_t> in = random_bytes(static_cast<std::size_t>(state.range(0)));
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    std::uint32_t crc = k->crc32c(0, in.data(), in.size());
+    benchmark::DoNotOptimize(crc);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void BM_KernelSecureZero(benchmark::State& state, const KernelSet* k) {
+  std::vector<std::uint8_t> buf(static_cast<std::size_t>(state.range(0)), 0xAA);
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    k->secure_zero(buf.data(), buf.size());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+bool register_kernel_benchmarks() {
+  for (const KernelSet& k : kernels::variants()) {
+    const std::string isa(isa_name(k.isa));
+    benchmark::RegisterBenchmark(("BM_KernelIContains/" + isa).c_str(), BM_KernelIContains, &k)->Apply(vault_sizes);
+    benchmark::RegisterBenchmark(("BM_KernelHexEncode/" + isa).c_str(), BM_KernelHexEncode, &k)->Apply(byte_sizes);
+    benchmark::RegisterBenchmark(("BM_KernelHexDecode/" + isa).c_str(), BM_KernelHexDecode, &k)->Apply(byte_sizes);
+    benchmark::RegisterBenchmark(("BM_KernelCrc32c/" + isa).c_str(), BM_KernelCrc32c, &k)->Apply(byte_sizes);
+    benchmark::RegisterBenchmark(("BM_KernelSecureZero/" + isa).c_str(), BM_KernelSecureZero, &k)->Apply(byte_sizes);
+  }
+  return true;
+}
+
+const bool kRegistered = register_kernel_benchmarks();
+
+}  // anonymous namespace
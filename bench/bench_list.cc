@@ -0,0 +1,74 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BenchSupport.h"
+
+#include "ListView.h"
+
+#include <ostream>
+#include <streambuf>
+
+using namespace pwledger;
+using namespace pwledger::bench;
+
+namespace {
+
+// Counts and discards what it is given, so the benchmarks measure
+// formatting and not the terminal.
+class NullBuffer : public std::streambuf {
+protected:
+  std::streamsize xsputn(const char* /*s*/, std::streamsize n) override { return n; }
+  int_type overflow(int_type c) override { return traits_type::not_eof(c); }
+};
+
+}  // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// list
+// ----------------------------------------------------------------------------
+
+// The whole table, sorted by name and rendered.
+static void BM_ListAll(benchmark::State& state) {
+  const PrimaryTable table = make_table(static_cast<std::size_t>(state.range(0)));
+  NullBuffer sink;
+  std::ostream out(&sink);
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    const ListView view(table, ListOrder{});
+    view.render(out, 0, view.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ListAll)->Apply(table_sizes);
+
+// The first screenful, most recently used first: a partial sort.
+static void BM_ListFirstPage(benchmark::State& state) {
+  const PrimaryTable table = make_table(static_cast<std::size_t>(state.range(0)));
+  NullBuffer sink;
+  std::ostream out(&sink);
+  constexpr std::size_t kPage = 50;
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    const ListView view(table, ListOrder{ListSortKey::kUsed, true}, kPage);
+    view.render(out, 0, kPage);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ListFirstPage)->Apply(table_sizes);
@@ -0,0 +1,97 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BenchSupport.h"
+
+#include <pwledger/Secret.h>
+
+#include <utility>
+#include <vector>
+
+using namespace pwledger;
+using namespace pwledger::bench;
+
+// ----------------------------------------------------------------------------
+// Secret
+// ----------------------------------------------------------------------------
+// One Secret per vault entry, matching what a loaded vault holds for its
+// passwords. Each Secret is a guarded sodium_malloc allocation.
+
+static void BM_SecretAllocate(benchmark::State& state) {
+  init_sodium();
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    std::vector<Secret> secrets;
+    secrets.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      secrets.emplace_back(kSecretBytes);
+    }
+    benchmark::DoNotOptimize(secrets.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SecretAllocate)->Apply(table_sizes);
+
+static void BM_SecretReadAccess(benchmark::State& state) {
+  init_sodium();
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  std::vector<Secret> secrets;
+  secrets.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    secrets.emplace_back(kSecretBytes);
+  }
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    for (const Secret& s : secrets) {
+      // Each access is an mprotect pair; touch one byte so it is not elided.
+      const char c = s.with_read_access([](std::span<const char> buf) { return buf[0]; });
+      benchmark::DoNotOptimize(c);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SecretReadAccess)->Apply(table_sizes);
+
+static void BM_SecretMove(benchmark::State& state) {
+  init_sodium();
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  std::vector<Secret> from;
+  from.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    from.emplace_back(kSecretBytes);
+  }
+  std::vector<Secret> to;
+  to.reserve(n);
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    for (Secret& s : from) {
+      to.push_back(std::move(s));
+    }
+    from.clear();
+    std::swap(from, to);
+    benchmark::DoNotOptimize(from.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SecretMove)->Apply(table_sizes);
@@ -0,0 +1,132 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BenchSupport.h"
+
+#include <pwledger/MerkleTree.h>
+#include <pwledger/VaultSync.h>
+
+#include <chrono>
+#include <cstring>
+#include <span>
+#include <utility>
+#include <vector>
+
+using namespace pwledger;
+using namespace pwledger::bench;
+
+namespace {
+
+constexpr std::size_t kChanged = 10;
+
+Uuid uuid_for(std::size_t i) {
+  Uuid uuid;
+  std::memcpy(uuid.bytes.data(), &i, sizeof(i));
+  uuid.bytes[15] = 1;
+  return uuid;
+}
+
+MerkleTree::Hash hash_for(std::size_t i, std::size_t version) {
+  MerkleTree::Hash hash{};
+  std::memcpy(hash.data(), &i, sizeof(i));
+  std::memcpy(hash.data() + sizeof(i), &version, sizeof(version));
+  return hash;
+}
+
+}  // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// MerkleTree
+// ----------------------------------------------------------------------------
+
+// The one O(n) step of a sync: hashing every entry of the vault.
+static void BM_MerkleTreeOf(benchmark::State& state) {
+  const PrimaryTable table = make_table(static_cast<std::size_t>(state.range(0)));
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    MerkleTree tree = MerkleTree::of(table);
+    benchmark::DoNotOptimize(tree.root());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MerkleTreeOf)->Apply(table_sizes)->Unit(benchmark::kMillisecond);
+
+// Comparing a vault with a peer's base that differs in kChanged entries.
+// The time and the visited-nodes counter should grow with log n, not n.
+static void BM_MerkleDiff(benchmark::State& state) {
+  init_sodium();
+  const auto n = static_cast<std::size_t>(state.range(0));
+  MerkleTree ours, theirs;
+  for (std::size_t i = 0; i < n; ++i) {
+    ours.set(uuid_for(i), hash_for(i, 0));
+    theirs.set(uuid_for(i), hash_for(i, i % (n / kChanged) == 0 ? 1 : 0));
+  }
+  (void)ours.root();
+  (void)theirs.root();
+
+  BenchCounters counters(state);
+  std::size_t changes = 0;
+  for (auto _ : state) {
+    const std::vector<MerkleTree::Change> diff = ours.diff(theirs);
+    changes = diff.size();
+    benchmark::DoNotOptimize(diff.data());
+  }
+  state.counters["changes"] = static_cast<double>(changes);
+  state.counters["visits"] = static_cast<double>(ours.last_diff_visits());
+}
+BENCHMARK(BM_MerkleDiff)->Apply(vault_sizes)->Unit(benchmark::kMicrosecond);
+
+// ----------------------------------------------------------------------------
+// VaultSync
+// ----------------------------------------------------------------------------
+
+// Merging a delta of kChanged edited entries into a vault of range(0).
+static void BM_SyncApply(benchmark::State& state) {
+  PrimaryTable table = make_table(static_cast<std::size_t>(state.range(0)));
+  MerkleTree current = MerkleTree::of(table);
+  std::vector<Uuid> edited;
+  for (const auto& [uuid, entry] : table) {
+    if (edited.size() == kChanged) {
+      break;
+    }
+    edited.push_back(uuid);
+  }
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    state.PauseTiming();
+    counters.pause();
+    SyncDelta delta;
+    SyncPeerState peer;
+    for (const Uuid& uuid : edited) {
+      SecretEntry entry(table.at(uuid).primary_key, table.at(uuid).username_or_email, kSecretBytes,
+                        VaultCrypto::kSaltBytes);
+      entry.plaintext_secret.with_write_access([](std::span<char> buf) { randombytes_buf(buf.data(), buf.size()); });
+      entry.metadata.last_modified_at = std::chrono::system_clock::now();
+      delta.items.push_back({uuid, current.find(uuid), std::move(entry)});
+    }
+    counters.resume();
+    state.ResumeTiming();
+
+    const SyncReport report = VaultSync::apply_delta(table, current, peer, std::move(delta));
+    benchmark::DoNotOptimize(report.updated);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(kChanged));
+}
+BENCHMARK(BM_SyncApply)->Apply(table_sizes)->Unit(benchmark::kMicrosecond);
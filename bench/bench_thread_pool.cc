@@ -0,0 +1,71 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BenchSupport.h"
+
+#include <pwledger/ThreadPool.h>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+using namespace pwledger;
+using namespace pwledger::bench;
+
+// ----------------------------------------------------------------------------
+// ThreadPool
+// ----------------------------------------------------------------------------
+// Scheduling overhead, not throughput: what a submit() round trip and an
+// empty parallel_for cost, with and without the post-task stack wipe. Real
+// tasks (an Argon2id segment, a batch of entries) run for far longer.
+
+namespace {
+
+ThreadPoolConfig bench_config(int scrub_stack_kib) {
+  ThreadPoolConfig config;
+  config.threads = 2;
+  config.scrub_stack_kib = scrub_stack_kib;
+  return config;
+}
+
+void BM_ThreadPoolSubmit(benchmark::State& state) {
+  ThreadPool pool(bench_config(static_cast<int>(state.range(0))));
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(pool.submit([] { return 1; }).get());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ThreadPoolSubmit)->ArgName("scrub_kib")->Arg(0)->Arg(16)->UseRealTime();
+
+void BM_ThreadPoolParallelFor(benchmark::State& state) {
+  ThreadPool pool(bench_config(16));
+  const auto n = static_cast<std::size_t>(state.range(0));
+  std::vector<std::uint64_t> out(n);
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    pool.parallel_for(0, n, [&](std::size_t i) { out[i] = i * 0x9E3779B97F4A7C15ull; }, 64);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ThreadPoolParallelFor)->Arg(64)->Arg(4096)->Arg(1 << 16)->UseRealTime();
+
+}  // anonymous namespace
@@ -0,0 +1,111 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BenchSupport.h"
+
+#include <pwledger/uuid.h>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace pwledger;
+using namespace pwledger::bench;
+
+// ----------------------------------------------------------------------------
+// Uuid
+// ----------------------------------------------------------------------------
+// One UUID per vault entry: generated on insert, formatted for every search
+// result and parsed for every copy / get_credentials.
+
+static void BM_UuidGenerate(benchmark::State& state) {
+  init_sodium();
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  std::vector<Uuid> out(n);
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = Uuid::generate();
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_UuidGenerate)->Apply(vault_sizes);
+
+static void BM_UuidToString(benchmark::State& state) {
+  init_sodium();
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  std::vector<Uuid> uuids(n);
+  for (auto& u : uuids) {
+    u = Uuid::generate();
+  }
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    for (const Uuid& u : uuids) {
+      std::string s = u.to_string();
+      benchmark::DoNotOptimize(s.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_UuidToString)->Apply(vault_sizes);
+
+static void BM_UuidToChars(benchmark::State& state) {
+  init_sodium();
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  std::vector<Uuid> uuids(n);
+  for (auto& u : uuids) {
+    u = Uuid::generate();
+  }
+
+  char buf[Uuid::kStringLength];
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    for (const Uuid& u : uuids) {
+      u.to_chars(buf);
+      benchmark::DoNotOptimize(buf);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_UuidToChars)->Apply(vault_sizes);
+
+static void BM_UuidFromString(benchmark::State& state) {
+  init_sodium();
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  std::vector<std::string> strings(n);
+  for (auto& s : strings) {
+    s = Uuid::generate().to_string();
+  }
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    for (const std::string& s : strings) {
+      std::optional<Uuid> u = Uuid::from_string(s);
+      benchmark::DoNotOptimize(u);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_UuidFromString)->Apply(vault_sizes);
@@ -0,0 +1,384 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BenchSupport.h"
+
+#include <pwledger/Argon2.h>
+#include <pwledger/KeySlots.h>
+#include <pwledger/VaultCrypto.h>
+#include <pwledger/VaultIO.h>
+#include <pwledger/VaultImport.h>
+#include <pwledger/VaultManager.h>
+#include <pwledger/VaultSerializer.h>
+
+#include <cstring>
+#include <filesystem>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace pwledger;
+using namespace pwledger::bench;
+
+namespace {
+
+constexpr char kPassword[] = "correct horse battery staple";
+
+// Serialized bytes per entry, measured once on a small table so that the
+// AEAD benchmarks can run the full size range on plain buffers.
+std::size_t serialized_bytes_per_entry() {
+  static const std::size_t bytes = [] {
+    constexpr std::size_t kSample = 100;
+    return VaultSerializer::serialize(make_table(kSample)).size() / kSample;
+  }();
+  return bytes;
+}
+
+std::vector<std::uint8_t> random_plaintext(std::int64_t entries) {
+  std::vector<std::uint8_t> buf(static_cast<std::size_t>(entries) * serialized_bytes_per_entry());
+  randombytes_buf(buf.data(), buf.size());
+  return buf;
+}
+
+std::filesystem::path bench_vault_path(const benchmark::State& state) {
+  return std::filesystem::temp_directory_path() /
+         ("pwledger_bench_" + std::to_string(state.range(0)) + ".dat");
+}
+
+}  // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// VaultSerializer
+// ----------------------------------------------------------------------------
+
+static void BM_Serialize(benchmark::State& state) {
+  const PrimaryTable table = make_table(static_cast<std::size_t>(state.range(0)));
+
+  std::size_t bytes = 0;
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    auto out = VaultSerializer::serialize(table);
+    bytes = out.size();
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(bytes));
+}
+BENCHMARK(BM_Serialize)->Apply(table_sizes);
+
+static void BM_Deserialize(benchmark::State& state) {
+  const auto bytes = VaultSerializer::serialize(make_table(static_cast<std::size_t>(state.range(0))));
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    PrimaryTable table = VaultSerializer::deserialize(bytes.data(), bytes.size());
+    benchmark::DoNotOptimize(table.size());
+    // Tearing down the table frees every Secret; keep that out of the number.
+    state.PauseTiming();
+    counters.pause();
+    table.clear();
+    counters.resume();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(bytes.size()));
+}
+BENCHMARK(BM_Deserialize)->Apply(table_sizes);
+
+// ----------------------------------------------------------------------------
+// VaultCrypto
+// ----------------------------------------------------------------------------
+// The KDF cost does not depend on vault size, so it is measured once on its
+// own; the AEAD benchmarks reuse one derived key.
+
+static void BM_DeriveMasterKey(benchmark::State& state) {
+  init_sodium();
+  std::uint8_t salt[VaultCrypto::kSaltBytes];
+  randombytes_buf(salt, sizeof(salt));
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    Secret key = VaultCrypto::derive_master_key(kPassword, salt);
+    benchmark::DoNotOptimize(key.size());
+  }
+}
+BENCHMARK(BM_DeriveMasterKey)->Unit(benchmark::kMillisecond);
+
+// The same 64 MiB split over N lanes, i.e. the default cost with
+// KdfParams::parallelism = N. Lane 1 is the in-tree Argon2id, comparable
+// with libsodium above; more lanes gain nothing on a single-core machine.
+static void BM_DeriveMasterKeyLanes(benchmark::State& state) {
+  init_sodium();
+  std::uint8_t salt[VaultCrypto::kSaltBytes];
+  randombytes_buf(salt, sizeof(salt));
+  const auto password = std::span(reinterpret_cast<const std::uint8_t*>(kPassword), sizeof(kPassword) - 1);
+  Argon2idParams params;
+  params.passes = static_cast<std::uint32_t>(KdfParams{}.opslimit);
+  params.memory_kib = static_cast<std::uint32_t>(KdfParams{}.memlimit / 1024);
+  params.lanes = static_cast<std::uint32_t>(state.range(0));
+  std::uint8_t key[VaultCrypto::kKeyBytes];
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    argon2id(key, password, salt, params);
+    benchmark::DoNotOptimize(key);
+  }
+}
+BENCHMARK(BM_DeriveMasterKeyLanes)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// The AEAD benchmarks run once per cipher suite, named
+// BM_EncryptWithKey/<suite>/<entries>; AES-256-GCM is skipped where this CPU
+// cannot run it.
+
+static bool skip_unavailable(benchmark::State& state, CipherSuite suite) {
+  init_sodium();
+  if (suite == CipherSuite::kAes256Gcm && crypto_aead_aes256gcm_is_available() == 0) {
+    state.SkipWithError("AES-256-GCM is not available on this CPU");
+    return true;
+  }
+  return false;
+}
+
+static void BM_EncryptWithKey(benchmark::State& state, CipherSuite suite) {
+  if (skip_unavailable(state, suite)) {
+    return;
+  }
+  std::uint8_t salt[VaultCrypto::kSaltBytes];
+  randombytes_buf(salt, sizeof(salt));
+  const Secret key = VaultCrypto::derive_master_key(kPassword, salt);
+  const auto plaintext = random_plaintext(state.range(0));
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    auto blob = VaultCrypto::encrypt_with_key(key, salt, {}, plaintext, suite);
+    benchmark::DoNotOptimize(blob.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(plaintext.size()));
+}
+BENCHMARK_CAPTURE(BM_EncryptWithKey, xchacha20poly1305, CipherSuite::kXChaCha20Poly1305)->Apply(vault_sizes);
+BENCHMARK_CAPTURE(BM_EncryptWithKey, aes256gcm, CipherSuite::kAes256Gcm)->Apply(vault_sizes);
+
+static void BM_DecryptWithKey(benchmark::State& state, CipherSuite suite) {
+  if (skip_unavailable(state, suite)) {
+    return;
+  }
+  std::uint8_t salt[VaultCrypto::kSaltBytes];
+  randombytes_buf(salt, sizeof(salt));
+  const Secret key = VaultCrypto::derive_master_key(kPassword, salt);
+  const auto plaintext = random_plaintext(state.range(0));
+  const auto blob = VaultCrypto::encrypt_with_key(key, salt, {}, plaintext, suite);
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    auto out = VaultCrypto::decrypt_with_key(key, blob);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(plaintext.size()));
+}
+BENCHMARK_CAPTURE(BM_DecryptWithKey, xchacha20poly1305, CipherSuite::kXChaCha20Poly1305)->Apply(vault_sizes);
+BENCHMARK_CAPTURE(BM_DecryptWithKey, aes256gcm, CipherSuite::kAes256Gcm)->Apply(vault_sizes);
+
+// ----------------------------------------------------------------------------
+// VaultIO
+// ----------------------------------------------------------------------------
+// End to end, including one Argon2id derivation per call (BM_DeriveMasterKey
+// gives the share of that).
+
+static void BM_VaultSave(benchmark::State& state) {
+  const PrimaryTable table = make_table(static_cast<std::size_t>(state.range(0)));
+  const auto path = bench_vault_path(state);
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    VaultIO::save_vault(path, table, kPassword);
+  }
+  std::filesystem::remove(path);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_VaultSave)->Apply(table_sizes)->Unit(benchmark::kMillisecond);
+
+static void BM_VaultLoad(benchmark::State& state) {
+  const auto path = bench_vault_path(state);
+  VaultIO::save_vault(path, make_table(static_cast<std::size_t>(state.range(0))), kPassword);
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    PrimaryTable table = VaultIO::load_vault(path, kPassword);
+    benchmark::DoNotOptimize(table.size());
+    state.PauseTiming();
+    counters.pause();
+    table.clear();
+    counters.resume();
+    state.ResumeTiming();
+  }
+  std::filesystem::remove(path);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_VaultLoad)->Apply(table_sizes)->Unit(benchmark::kMillisecond);
+
+// ----------------------------------------------------------------------------
+// VaultManager
+// ----------------------------------------------------------------------------
+// range(0) vaults of 100 entries at the default KDF cost, opened one unlock()
+// call each (range(1) = 0) or all in one (range(1) = 1). The second should
+// stay near the one-vault time while there are cores to spare.
+
+static void BM_UnlockVaults(benchmark::State& state) {
+  init_sodium();
+  const auto vaults = static_cast<std::size_t>(state.range(0));
+  const bool together = state.range(1) != 0;
+  VaultManager manager;
+  for (std::size_t i = 0; i < vaults; ++i) {
+    const auto path = std::filesystem::temp_directory_path() / ("pwledger_bench_manager_" + std::to_string(i) + ".dat");
+    VaultIO::save_vault(path, make_table(100), kPassword);
+    manager.add("v" + std::to_string(i), path);
+  }
+  const auto request = [](std::size_t i) {
+    Secret password(sizeof(kPassword));
+    password.with_write_access([](std::span<char> buf) { std::memcpy(buf.data(), kPassword, sizeof(kPassword)); });
+    return VaultManager::UnlockRequest{"v" + std::to_string(i), std::move(password)};
+  };
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    if (together) {
+      std::vector<VaultManager::UnlockRequest> requests;
+      for (std::size_t i = 0; i < vaults; ++i) {
+        requests.push_back(request(i));
+      }
+      benchmark::DoNotOptimize(manager.unlock(std::move(requests)));
+    } else {
+      for (std::size_t i = 0; i < vaults; ++i) {
+        std::vector<VaultManager::UnlockRequest> one;
+        one.push_back(request(i));
+        benchmark::DoNotOptimize(manager.unlock(std::move(one)));
+      }
+    }
+    state.PauseTiming();
+    counters.pause();
+    manager.lock_all();
+    counters.resume();
+    state.ResumeTiming();
+  }
+  for (const auto* vault : manager.vaults()) {
+    std::filesystem::remove(vault->path);
+  }
+}
+BENCHMARK(BM_UnlockVaults)
+    ->ArgsProduct({{1, 2, 3, 4}, {0, 1}})
+    ->ArgNames({"vaults", "together"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// ----------------------------------------------------------------------------
+// Key slots
+// ----------------------------------------------------------------------------
+// A key-slot vault of range(0) entries with the password slot and one
+// public-key slot. Sharing it with one more recipient reads the file, wraps
+// the data key once and writes the file back (to a second path, so every
+// iteration starts from the same vault); compare BM_VaultSave, which
+// re-encrypts everything. Opening it with the key pair skips Argon2id;
+// compare BM_VaultLoad.
+
+namespace {
+
+struct SlottedFixture {
+  std::filesystem::path path;
+  X25519KeyPair identity = X25519KeyPair::generate();
+  Secret data_key{1};
+
+  explicit SlottedFixture(const benchmark::State& state) : path(bench_vault_path(state)) {
+    VaultIO::save_vault(path, make_table(static_cast<std::size_t>(state.range(0))), kPassword);
+    data_key = VaultIO::convert_to_slotted(path, kPassword, "owner");
+    SlottedVault vault = VaultIO::read_slotted(path);
+    vault.add_public_key_slot(data_key, "ci", identity.public_key);
+    VaultIO::write_slotted(path, vault);
+  }
+  ~SlottedFixture() { std::filesystem::remove(path); }
+};
+
+}  // anonymous namespace
+
+static void BM_AddKeySlot(benchmark::State& state) {
+  init_sodium();
+  const SlottedFixture fixture(state);
+  const X25519PublicKey recipient = X25519KeyPair::generate().public_key;
+  auto shared = fixture.path;
+  shared += ".shared";
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    SlottedVault vault = VaultIO::read_slotted(fixture.path);
+    vault.add_public_key_slot(fixture.data_key, "laptop", recipient);
+    VaultIO::write_slotted(shared, vault);
+  }
+  std::filesystem::remove(shared);
+}
+BENCHMARK(BM_AddKeySlot)->Apply(table_sizes)->Unit(benchmark::kMillisecond);
+
+static void BM_VaultLoadWithKey(benchmark::State& state) {
+  init_sodium();
+  const SlottedFixture fixture(state);
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    PrimaryTable table = VaultIO::load_vault(fixture.path, fixture.identity);
+    benchmark::DoNotOptimize(table.size());
+    state.PauseTiming();
+    counters.pause();
+    table.clear();
+    counters.resume();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_VaultLoadWithKey)->Apply(table_sizes)->Unit(benchmark::kMillisecond);
+
+// ----------------------------------------------------------------------------
+// VaultImport
+// ----------------------------------------------------------------------------
+// A Chrome-style CSV export of range(0) logins, parsed from memory.
+
+static void BM_ImportCsv(benchmark::State& state) {
+  init_sodium();
+  const auto rows = static_cast<std::size_t>(state.range(0));
+  std::string csv = "name,url,username,password,note\n";
+  for (std::size_t i = 0; i < rows; ++i) {
+    const std::string n = std::to_string(i);
+    csv += "site" + n + ",https://site" + n + ".example/login,user" + n + "@example.com,\"pw,\"\"" + n + "\",\n";
+  }
+
+  BenchCounters counters(state);
+  for (auto _ : state) {
+    std::istringstream in(csv);
+    PrimaryTable table;
+    import_entries(in, ImportFormat::kCsv, table);
+    benchmark::DoNotOptimize(table.size());
+    state.PauseTiming();
+    counters.pause();
+    table.clear();
+    counters.resume();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(csv.size()));
+}
+BENCHMARK(BM_ImportCsv)->Apply(table_sizes)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,80 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PWLEDGER_ARGON2_H
+#define PWLEDGER_ARGON2_H
+
+// ============================================================================
+// DESIGN NOTES
+// ============================================================================
+//
+// Argon2id version 1.3 (RFC 9106), with any number of lanes.
+//
+// libsodium's crypto_pwhash only implements one lane, so a key derivation
+// fills its whole memory on a single core. With p lanes the memory is split
+// into p independent rows that are filled at the same time, meeting at four
+// synchronisation points per pass; on a machine with p cores the same
+// memory costs about 1/p of the wall-clock time, or p times the memory fits
+// in the same unlock latency. The output depends on p, so it is part of a
+// vault's KDF parameters (KdfParams::parallelism, recorded in the header).
+//
+// VaultCrypto only uses this for p > 1; one-lane vaults keep going through
+// libsodium. The two agree for p = 1 (tests/test_argon2.cc checks this, and
+// the RFC 9106 test vector for p = 4).
+//
+// PIECES
+// ------
+//   H0, H'        BLAKE2b through libsodium's crypto_generichash
+//   compression   kernels::argon2_fill, i.e. scalar or AVX2 as dispatched
+//                 by Kernels.h
+//   lanes         ThreadPool::shared(), one parallel_for over the lanes per
+//                 slice; its return is the synchronisation point, so lanes
+//                 beyond the pool's threads simply queue
+//
+// The block memory is an ordinary heap allocation, as in libsodium, and is
+// wiped before it is freed.
+//
+// ============================================================================
+
+#include <cstdint>
+#include <span>
+
+namespace pwledger {
+
+struct Argon2idParams {
+  std::uint32_t passes = 2;          // t
+  std::uint32_t memory_kib = 65536;  // m; rounded down to a multiple of 4 * lanes
+  std::uint32_t lanes = 1;           // p
+  std::uint32_t threads = 0;         // 0: one per lane, as far as the shared pool allows
+};
+
+// Writes the Argon2id tag for `password` and `salt` to `out` (4 bytes or
+// more). `secret` and `associated_data` are the optional K and X inputs.
+// Throws std::invalid_argument on parameters RFC 9106 does not allow (salt
+// under 8 bytes, no passes or lanes, fewer than 8 KiB per lane) and
+// std::bad_alloc if the memory cannot be allocated.
+void argon2id(std::span<std::uint8_t> out,
+              std::span<const std::uint8_t> password,
+              std::span<const std::uint8_t> salt,
+              const Argon2idParams& params,
+              std::span<const std::uint8_t> secret = {},
+              std::span<const std::uint8_t> associated_data = {});
+
+}  // namespace pwledger
+
+#endif  // PWLEDGER_ARGON2_H
@@ -0,0 +1,180 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PWLEDGER_COMPLETION_INDEX_H
+#define PWLEDGER_COMPLETION_INDEX_H
+
+#include <pwledger/PrimaryTable.h>
+#include <pwledger/SecretEntry.h>
+#include <pwledger/uuid.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ============================================================================
+// DESIGN NOTES
+// ============================================================================
+//
+// CompletionIndex finds entries by a prefix of their primary key or their
+// username/email, for tab completion and narrowing as the user types. It is
+// a compressed radix (Patricia) trie: each edge carries a whole run of
+// characters, so a node exists only where keys branch or end, and 100k
+// entries under two keys each need a few hundred thousand nodes rather
+// than one per character.
+//
+// Keys are indexed ASCII case-folded; other bytes are compared as they are.
+// An entry is indexed under both of its keys, so a prefix of both counts
+// it twice (see count()); candidates() reports each entry once.
+//
+// COST
+// ----
+// insert and erase walk one path, O(key length), and split or merge at
+// most one node. A Cursor moves one character at a time: push is a scan
+// of at most one node's children, pop is O(1), and count() is stored per
+// node, so narrowing by a keystroke is O(1)-ish no matter how many entries
+// lie below. candidates(limit) stops after `limit` distinct entries.
+//
+// The index is maintained incrementally by whoever changes the table; it
+// does not watch the table itself. Nodes live in one vector addressed by
+// 32-bit indices, with freed slots reused, so a trie of n nodes is n
+// contiguous structs plus their labels.
+//
+// THREAD SAFETY: none. A Cursor is invalidated by any insert or erase.
+//
+// ============================================================================
+
+namespace pwledger {
+
+class CompletionIndex {
+public:
+  CompletionIndex();
+
+  // Indexes every entry of `table`.
+  explicit CompletionIndex(const PrimaryTable& table);
+
+  // Adds or removes both keys of an entry. Call erase with the entry as it
+  // was indexed (before renaming it, say).
+  void insert(const Uuid& uuid, const SecretEntry& entry);
+  void erase(const Uuid& uuid, const SecretEntry& entry);
+
+  // One key. Empty keys are not indexed. erase returns false if `key` was
+  // not indexed for `uuid`.
+  void insert(std::string_view key, const Uuid& uuid);
+  bool erase(std::string_view key, const Uuid& uuid);
+
+  void clear();
+
+  // Number of (key, entry) pairs indexed.
+  [[nodiscard]] std::size_t size() const noexcept;
+
+  // Nodes in use (a measure of memory; for tests and benchmarks).
+  [[nodiscard]] std::size_t node_count() const noexcept { return nodes_.size() - free_.size(); }
+
+  // --------------------------------------------------------------------------
+  // Cursor: a prefix being typed
+  // --------------------------------------------------------------------------
+  class Cursor {
+  public:
+    explicit Cursor(const CompletionIndex& index);
+
+    // Appends or removes one character of the prefix.
+    void push(char c);
+    void pop();
+    void reset();
+
+    // Appends every character of `text`.
+    void push(std::string_view text);
+
+    // The prefix so far, case-folded.
+    [[nodiscard]] const std::string& prefix() const noexcept { return prefix_; }
+
+    // Whether any key starts with the prefix.
+    [[nodiscard]] bool matches() const noexcept { return dead_ == 0; }
+
+    // Number of (key, entry) pairs whose key starts with the prefix.
+    [[nodiscard]] std::size_t count() const noexcept;
+
+    // The characters every key under the prefix continues with: what Tab
+    // should insert. Empty when the keys diverge right away or none match.
+    [[nodiscard]] std::string completion() const;
+
+    // Up to `limit` distinct entries under the prefix, keys in byte order.
+    [[nodiscard]] std::vector<Uuid> candidates(std::size_t limit) const;
+
+    // Entries with a key equal to the prefix.
+    [[nodiscard]] std::vector<Uuid> exact() const;
+
+  private:
+    struct Position {
+      std::uint32_t node;
+      std::uint32_t offset;  // characters of the node's label matched
+    };
+
+    const CompletionIndex* index_;
+    std::vector<Position> path_;  // path_.back() is the current position
+    std::string prefix_;
+    std::size_t dead_ = 0;  // characters pushed past the last match
+  };
+
+  [[nodiscard]] Cursor cursor() const { return Cursor(*this); }
+
+  // Convenience wrappers over a Cursor.
+  [[nodiscard]] std::size_t count(std::string_view prefix) const;
+  [[nodiscard]] std::string completion(std::string_view prefix) const;
+  [[nodiscard]] std::vector<Uuid> candidates(std::string_view prefix, std::size_t limit) const;
+
+private:
+  struct Child {
+    char first;  // label[0] of the child, kept here so push never touches it
+    std::uint32_t node;
+  };
+
+  struct Node {
+    std::string label;            // edge from the parent; empty only at the root
+    std::vector<Child> children;  // sorted by `first`
+    std::vector<Uuid> values;     // entries with a key ending here, sorted
+    std::size_t count = 0;        // values here and below
+  };
+
+  static constexpr std::uint32_t kRoot = 0;
+
+  std::uint32_t allocate(std::string label);
+  void release(std::uint32_t node);
+  [[nodiscard]] const Child* find_child(std::uint32_t node, char first) const;
+  void merge_with_only_child(std::uint32_t node);
+  std::string_view start_walk(std::string_view key);
+
+  std::vector<Node> nodes_;
+  std::vector<std::uint32_t> free_;
+
+  // Scratch space for insert and erase.
+  std::string key_;
+  std::vector<std::uint32_t> path_;
+};
+
+// ASCII case folding, as the index applies to every key.
+inline char fold_key_char(char c) noexcept {
+  return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+}  // namespace pwledger
+
+#endif  // PWLEDGER_COMPLETION_INDEX_H
@@ -20,6 +20,7 @@
 #define PWLEDGER_CONFIG_H
 
 #include <filesystem>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -68,11 +69,15 @@ struct SecurityConfig {
 // VaultConfig
 // ----------------------------------------------------------------------------
 // Overrides for vault file location. An empty directory string means "use the
-// platform default" (see VaultPath.h).
+// platform default" (see VaultPath.h). `vaults` names further vaults that are
+// opened side by side with VaultManager, e.g.
+//   "vaults": {"team": "team.dat", "ci": "~/ci/service.dat"}
+// A relative file is taken within the directory.
 struct VaultConfig {
   std::string directory     = "";          // Override vault directory (empty = platform default)
   std::string default_vault = "vault.dat"; // Vault filename within the directory
   bool        auto_unlock   = false;       // Reserved for future use
+  std::map<std::string, std::string> vaults;  // Named vaults: name -> file
 };
 
 // ----------------------------------------------------------------------------
@@ -94,6 +99,17 @@ struct IntegrationConfig {
   std::vector<std::string> allowed_extensions;          // Allowed browser extension origins
 };
 
+// ----------------------------------------------------------------------------
+// ThreadPoolConfig
+// ----------------------------------------------------------------------------
+// Sizing and shutdown of the shared worker pool (see ThreadPool.h) that
+// multi-lane key derivation and other bulk work run on.
+struct ThreadPoolConfig {
+  int  threads           = 0;     // Worker threads (0 = one per hardware thread)
+  bool drain_on_shutdown = true;  // Run queued tasks at exit (false = drop them)
+  int  scrub_stack_kib   = 16;    // Worker stack wiped after each task (0 = disabled)
+};
+
 // ----------------------------------------------------------------------------
 // Config
 // ----------------------------------------------------------------------------
@@ -104,6 +120,7 @@ struct Config {
   VaultConfig       vault;
   CliConfig         cli;
   IntegrationConfig integration;
+  ThreadPoolConfig  thread_pool;
 };
 
 // ============================================================================
@@ -0,0 +1,75 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PWLEDGER_CPUFEATURES_H
+#define PWLEDGER_CPUFEATURES_H
+
+// ============================================================================
+// DESIGN NOTES
+// ============================================================================
+//
+// Which instruction set extensions this CPU offers, detected once per
+// process. Kernels.h uses this to pick one implementation of each kernel at
+// run time, so a single binary built for the baseline target (x86-64 or
+// ARMv8-A) still gets the wide paths on a machine that has them.
+//
+// Only the levels that some kernel actually has an implementation for are
+// named here. Each level implies the ones below it in its family:
+//
+//   x86-64    sse4.2  (SSE4.2 + SSSE3: pshufb, crc32)
+//             avx2    (+ AVX, which the OS must have enabled via XSAVE)
+//             avx512  (AVX-512 F + BW, likewise OS-enabled)
+//   AArch64   neon    (part of every AArch64 target)
+//
+// Detection uses cpuid/xgetbv on x86-64 and is compile-time on AArch64. It
+// is only done with GCC and Clang; other compilers report no features and
+// run the scalar kernels.
+//
+// ============================================================================
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace pwledger {
+
+// Ordered within each family: a higher value implies every lower one of
+// the same family, and kScalar is implied by all.
+enum class Isa : std::uint8_t { kScalar, kSse42, kAvx2, kAvx512, kNeon };
+
+struct CpuFeatures {
+  bool sse42 = false;
+  bool avx2 = false;
+  bool avx512 = false;  // F and BW
+  bool neon = false;
+};
+
+// What the hardware and OS support. Ignores PWLEDGER_SIMD (see Kernels.h).
+[[nodiscard]] const CpuFeatures& cpu_features() noexcept;
+
+[[nodiscard]] bool cpu_supports(Isa isa) noexcept;
+
+// "scalar", "sse4.2", "avx2", "avx512", "neon".
+[[nodiscard]] std::string_view isa_name(Isa isa) noexcept;
+
+// Inverse of isa_name; also accepts "off" for kScalar.
+[[nodiscard]] std::optional<Isa> parse_isa(std::string_view name) noexcept;
+
+}  // namespace pwledger
+
+#endif  // PWLEDGER_CPUFEATURES_H
@@ -0,0 +1,178 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PWLEDGER_KERNELS_H
+#define PWLEDGER_KERNELS_H
+
+// ============================================================================
+// DESIGN NOTES
+// ============================================================================
+//
+// The handful of byte-crunching loops that hot paths spend their time in,
+// each with a scalar implementation and SIMD ones chosen at run time:
+//
+//   icontains    ASCII case-insensitive substring search (host `search`)
+//   hex_encode   bytes -> lowercase hex (Uuid::to_chars)
+//   hex_decode   hex of either case -> bytes, with validation
+//                (Uuid::from_chars)
+//   crc32c       CRC-32C (Castagnoli); the basis of hash_bytes and
+//                StringHash for string-keyed maps
+//   secure_zero  zeroing that the compiler may not elide, for plaintext
+//                buffers that are about to be freed
+//   argon2_fill  Argon2's block compression G (Argon2.h)
+//
+// DISPATCH
+// --------
+// A KernelSet is a table of function pointers, one per kernel, for one
+// instruction set level. Levels without their own version of a kernel
+// reuse the next lower level's (AVX-512 has its own search and zeroing but
+// shares AVX2's hex codec, for example). The sets this binary contains and
+// this CPU can run are listed by variants(); active() is the one everything
+// calls through, chosen on first use:
+//
+//   PWLEDGER_SIMD unset, "" or "auto"   best level the CPU supports
+//   PWLEDGER_SIMD=scalar (or "off")     scalar kernels only
+//   PWLEDGER_SIMD=sse4.2|avx2|...       best level not above the one named
+//
+// Forcing a level is for testing and for comparing paths on one machine;
+// all levels produce identical results. An unknown value is reported on
+// stderr and ignored. Function pointers rather than ifunc resolvers keep
+// this portable and let tests and benchmarks call every variant side by
+// side; the indirect call is a few cycles next to kernels that touch tens
+// of bytes or more.
+//
+// SECURE_ZERO
+// -----------
+// sodium_memzero at every level except AVX-512, which clears buffers
+// shorter than 64 bytes with one masked store and then a compiler barrier
+// that takes the buffer's address (the technique libsodium itself falls
+// back to), so the store cannot be dropped as dead.
+// Longer buffers gain nothing from hand-written stores: libc's memset
+// behind sodium_memzero already uses the widest ones. Secret storage itself
+// is always wiped by libsodium (sodium_free); secure_zero is for ordinary
+// heap buffers such as a decrypted vault.
+//
+// ============================================================================
+
+#include <pwledger/CpuFeatures.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace pwledger::kernels {
+
+// 1 KiB Argon2 block.
+inline constexpr std::size_t kArgon2BlockWords = 128;
+
+// ----------------------------------------------------------------------------
+// KernelSet
+// ----------------------------------------------------------------------------
+struct KernelSet {
+  Isa isa = Isa::kScalar;
+
+  // True if `needle` occurs in `haystack`, comparing A-Z and a-z as equal.
+  // Other bytes, including non-ASCII, must match exactly. An empty needle
+  // matches.
+  bool (*icontains)(std::string_view haystack, std::string_view needle) noexcept = nullptr;
+
+  // Writes 2 * n lowercase hex digits for the n bytes at `in`.
+  void (*hex_encode)(const std::uint8_t* in, std::size_t n, char* out) noexcept = nullptr;
+
+  // Reads 2 * n hex digits (either case) into n bytes. Returns false if any
+  // character is not a hex digit; `out` is then unspecified.
+  bool (*hex_decode)(const char* in, std::size_t n, std::uint8_t* out) noexcept = nullptr;
+
+  // CRC-32C of `n` bytes continuing from `crc` (0 to start), with the
+  // usual pre- and post-inversion: crc32c(0, "123456789", 9) == 0xE3069283.
+  std::uint32_t (*crc32c)(std::uint32_t crc, const void* data, std::size_t n) noexcept = nullptr;
+
+  // Zeroes `n` bytes at `p`; never optimized away.
+  void (*secure_zero)(void* p, std::size_t n) noexcept = nullptr;
+
+  // Argon2 compression over kArgon2BlockWords-word blocks (RFC 9106
+  // section 3.5): out = G(prev, ref), or out ^= G(prev, ref) if `xor_into`.
+  // `out` may alias `prev` or `ref`.
+  void (*argon2_fill)(const std::uint64_t* prev, const std::uint64_t* ref, std::uint64_t* out,
+                      bool xor_into) noexcept = nullptr;
+};
+
+// Every level compiled into this binary that the CPU supports, scalar
+// first and best last.
+[[nodiscard]] std::span<const KernelSet> variants() noexcept;
+
+// The best variant at or below `cap` (the best overall if empty).
+[[nodiscard]] const KernelSet& select(std::optional<Isa> cap) noexcept;
+
+// The variant selected for this process; see DISPATCH.
+[[nodiscard]] const KernelSet& active() noexcept;
+
+// ----------------------------------------------------------------------------
+// Convenience wrappers over active()
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] inline bool icontains(std::string_view haystack, std::string_view needle) noexcept {
+  return active().icontains(haystack, needle);
+}
+
+inline void hex_encode(const std::uint8_t* in, std::size_t n, char* out) noexcept {
+  active().hex_encode(in, n, out);
+}
+
+[[nodiscard]] inline bool hex_decode(const char* in, std::size_t n, std::uint8_t* out) noexcept {
+  return active().hex_decode(in, n, out);
+}
+
+[[nodiscard]] inline std::uint32_t crc32c(std::uint32_t crc, const void* data, std::size_t n) noexcept {
+  return active().crc32c(crc, data, n);
+}
+
+inline void secure_zero(void* p, std::size_t n) noexcept {
+  active().secure_zero(p, n);
+}
+
+// 64-bit hash for in-memory hash tables: CRC-32C of the bytes and their
+// length, spread over 64 bits by a multiply-xorshift finalizer. Not stable
+// across versions and not collision-resistant against chosen input; never
+// persist it or use it on attacker-controlled keys at scale.
+[[nodiscard]] inline std::uint64_t hash_bytes(const void* data, std::size_t n) noexcept {
+  std::uint64_t h = (std::uint64_t{crc32c(0, data, n)} << 32) ^ n;
+  h ^= h >> 33;
+  h *= 0xFF51AFD7ED558CCDULL;
+  h ^= h >> 33;
+  h *= 0xC4CEB9FE1A85EC53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+// Transparent hasher for std::unordered_map<std::string, T, StringHash,
+// std::equal_to<>>, so that find() takes a string_view without building a
+// std::string.
+struct StringHash {
+  using is_transparent = void;
+
+  [[nodiscard]] std::size_t operator()(std::string_view s) const noexcept {
+    return static_cast<std::size_t>(hash_bytes(s.data(), s.size()));
+  }
+};
+
+}  // namespace pwledger::kernels
+
+#endif  // PWLEDGER_KERNELS_H
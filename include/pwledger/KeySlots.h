@@ -0,0 +1,227 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PWLEDGER_KEY_SLOTS_H
+#define PWLEDGER_KEY_SLOTS_H
+
+#include <pwledger/Secret.h>
+#include <pwledger/VaultCrypto.h>
+#include <sodium.h>
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ============================================================================
+// DESIGN NOTES
+// ============================================================================
+//
+// A vault that several people or machines can open, each with their own
+// credential, without sharing a master password. The payload is sealed
+// under a random 256-bit data key. The header holds a table of key slots,
+// and each slot wraps that same data key for one recipient:
+//
+//   password slot    Argon2id(password, slot salt, slot KDF parameters)
+//                    gives a key-encryption key that seals the data key
+//                    with XChaCha20-Poly1305
+//   public-key slot  crypto_box_seal (X25519 + XSalsa20-Poly1305) of the
+//                    data key to the recipient's public key
+//
+// Adding or revoking a recipient changes only the slot table. The payload
+// bytes are carried over as they are, so sharing costs one slot wrap per
+// recipient (and one Argon2id for a new password slot), whatever the size of
+// the vault. Unlocking with a key pair costs one crypto_box_seal_open and no
+// Argon2id at all.
+//
+// FILE FORMAT (version 4 of the "PWLV" family in VaultCrypto.h)
+// -----------
+//   [ "PWLV" ] [ version (1) = 4 ] [ suite (1) ] [ slot count (1) ]
+//   slot count times:
+//     [ type (1) ] [ label length (1) ] [ label ]
+//     password:    [ opslimit (u32 LE) ] [ memlimit KiB (u32 LE) ] [ lanes (1) ]
+//                  [ salt (16) ] [ nonce (24) ] [ data key + tag (48) ]
+//     public key:  [ public key (32) ] [ sealed data key (80) ]
+//   [ payload nonce (24 for XChaCha20, 12 for AES-GCM) ] [ ciphertext + tag ]
+//
+// The payload's additional data is the first six bytes (magic, version,
+// suite), not the slot table, which is what lets the table change without
+// touching the payload. A password slot's AEAD binds its own bytes from the
+// type through the salt, so its label and cost cannot be altered. Labels
+// are unique within a vault and name slots for revocation.
+//
+// LIMITS
+// ------
+// The slot table is outside every AEAD, so a file can ask for any slots it
+// likes. Unlocking by password without a label runs Argon2id once per
+// password slot, each at a cost VaultCrypto::check_kdf_params allows; a
+// vault may hold at most kMaxPasswordSlots of them, which bounds that work
+// to a handful of derivations. Public-key slots cost no Argon2id and count
+// only against kMaxSlots.
+//
+// Removing a slot stops that credential from unlocking the file from then
+// on. It does not take the data key back from someone who has already
+// unlocked the vault: to shut them out, save the vault in the
+// single-password format (VaultIO::save_vault on a new path) and share it
+// again, which picks a fresh data key.
+//
+// The data key lives as long as the vault, so every save reuses it with a
+// fresh random nonce. With AES-256-GCM's 96-bit nonces that stays clear of
+// a collision for far more saves than a vault will ever see (2^32 saves
+// keep the chance under 2^-32).
+//
+// ============================================================================
+
+namespace pwledger {
+
+using X25519PublicKey = std::array<std::uint8_t, crypto_box_PUBLICKEYBYTES>;
+
+// ----------------------------------------------------------------------------
+// X25519KeyPair
+// ----------------------------------------------------------------------------
+// A recipient identity for public-key slots. The secret key lives in a
+// Secret; on disk it is the 32 raw bytes, readable by the owner only.
+struct X25519KeyPair {
+  X25519PublicKey public_key{};
+  Secret secret_key{crypto_box_SECRETKEYBYTES};
+
+  static X25519KeyPair generate();
+
+  // Reads a secret key file and derives its public key. Throws
+  // std::runtime_error if the file cannot be read or is not 32 bytes.
+  static X25519KeyPair read_file(const std::filesystem::path& path);
+
+  // Writes the secret key, creating the file with owner-only permissions.
+  // Throws std::runtime_error if the file exists or cannot be written.
+  void write_file(const std::filesystem::path& path) const;
+};
+
+// Lowercase hex of a public key, and back (nullopt unless 64 hex digits).
+[[nodiscard]] std::string public_key_to_hex(const X25519PublicKey& key);
+[[nodiscard]] std::optional<X25519PublicKey> public_key_from_hex(std::string_view hex);
+
+// ----------------------------------------------------------------------------
+// KeySlot
+// ----------------------------------------------------------------------------
+struct KeySlot {
+  // Part of the file format: never renumber.
+  enum class Type : std::uint8_t {
+    kPassword = 1,
+    kPublicKey = 2,
+  };
+
+  Type type = Type::kPassword;
+  std::string label;
+
+  // kPassword only.
+  KdfParams kdf;
+  std::array<std::uint8_t, VaultCrypto::kSaltBytes> salt{};
+
+  // kPublicKey only.
+  X25519PublicKey public_key{};
+
+  // The wrapped data key: nonce and AEAD output for a password slot, the
+  // crypto_box_seal output for a public-key slot.
+  std::vector<std::uint8_t> wrapped;
+};
+
+// ----------------------------------------------------------------------------
+// SlottedVault
+// ----------------------------------------------------------------------------
+// One version-4 file in memory: the slot table, parsed, and the payload, as
+// stored. Every operation that needs the data key takes it as returned by
+// unlock() or generate_data_key().
+class SlottedVault {
+public:
+  static constexpr std::uint8_t kFormatVersion = 4;
+  static constexpr std::size_t kMaxSlots = 255;
+  static constexpr std::size_t kMaxPasswordSlots = 8;
+  static constexpr std::size_t kMaxLabelBytes = 255;
+
+  // Whether `blob` starts like a version-4 file. Says nothing about whether
+  // the rest is well formed.
+  [[nodiscard]] static bool is_slotted(std::span<const std::uint8_t> blob) noexcept;
+
+  // A fresh random data key.
+  [[nodiscard]] static Secret generate_data_key();
+
+  // A vault holding `plaintext` under `data_key`, with no slots yet: add at
+  // least one before serializing.
+  static SlottedVault create(const Secret& data_key,
+                             const std::vector<std::uint8_t>& plaintext,
+                             CipherSuite suite = VaultCrypto::default_cipher_suite());
+
+  // Parses a version-4 file. Throws std::runtime_error on anything
+  // malformed, including KDF parameters outside the limits VaultCrypto
+  // enforces and more than kMaxPasswordSlots password slots.
+  static SlottedVault parse(std::vector<std::uint8_t> blob);
+
+  [[nodiscard]] CipherSuite suite() const noexcept { return suite_; }
+  [[nodiscard]] const std::vector<KeySlot>& slots() const noexcept { return slots_; }
+  [[nodiscard]] const KeySlot* find_slot(std::string_view label) const noexcept;
+
+  // The data key, from the password slot named `label`, or from the first
+  // password slot `password` opens when `label` is empty (one Argon2id per
+  // slot tried, so at most kMaxPasswordSlots). Throws std::runtime_error if
+  // none opens.
+  [[nodiscard]] Secret unlock(std::string_view password, std::string_view label = {}) const;
+
+  // The data key, from the slot for `identity`'s public key. No Argon2id.
+  // Throws std::runtime_error if there is no such slot or it does not open.
+  [[nodiscard]] Secret unlock(const X25519KeyPair& identity) const;
+
+  // Decrypts the payload. Throws std::runtime_error if authentication fails.
+  [[nodiscard]] std::vector<std::uint8_t> decrypt(const Secret& data_key) const;
+
+  // Replaces the payload with `plaintext` sealed under the same data key;
+  // the slot table is untouched.
+  void reseal(const Secret& data_key,
+              const std::vector<std::uint8_t>& plaintext,
+              CipherSuite suite = VaultCrypto::default_cipher_suite());
+
+  // Adds a recipient. Throws std::invalid_argument if the label is empty,
+  // longer than kMaxLabelBytes or taken, or the table is full (for a
+  // password slot, if it already holds kMaxPasswordSlots of them).
+  void add_password_slot(const Secret& data_key, std::string label, std::string_view password,
+                         const KdfParams& kdf = {});
+  void add_public_key_slot(const Secret& data_key, std::string label, const X25519PublicKey& recipient);
+
+  // Revokes a recipient. Returns false if there is no slot by that name;
+  // throws std::invalid_argument rather than remove the last one.
+  bool remove_slot(std::string_view label);
+
+  // The file bytes. Throws std::logic_error if there are no slots.
+  [[nodiscard]] std::vector<std::uint8_t> serialize() const;
+
+private:
+  SlottedVault() = default;
+
+  void check_new_label(const std::string& label) const;
+
+  CipherSuite suite_ = CipherSuite::kXChaCha20Poly1305;
+  std::vector<KeySlot> slots_;
+  std::vector<std::uint8_t> payload_;  // nonce, ciphertext and tag, as stored
+};
+
+}  // namespace pwledger
+
+#endif  // PWLEDGER_KEY_SLOTS_H
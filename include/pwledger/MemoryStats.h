@@ -0,0 +1,134 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PWLEDGER_MEMORYSTATS_H
+#define PWLEDGER_MEMORYSTATS_H
+
+// ============================================================================
+// DESIGN NOTES
+// ============================================================================
+//
+// Memory accounting for capacity planning. Every Secret is a separate
+// sodium_malloc region, and that region costs far more than the bytes asked
+// for: libsodium rounds the data (plus a 16-byte canary) up to whole pages,
+// adds a read-only header page and a guard page on each side, and mlock()s
+// the data pages. A 256-byte password buffer therefore occupies four pages
+// of address space, one of them locked. With two Secrets per entry, the
+// limits a large vault actually hits are RLIMIT_MEMLOCK and the kernel's
+// per-process mapping limit (vm.max_map_count), not heap size.
+//
+// Three views, from cheapest to most expensive:
+//
+//   SecureMemoryStats   Process-wide counters maintained by Secret on every
+//                       allocate and free (relaxed atomics; a few adds per
+//                       Secret). mapped/guard/locked are derived from
+//                       libsodium's allocation layout, see
+//                       secure_allocation_layout().
+//   TableMemoryStats    A walk over a PrimaryTable: heap bytes held by the
+//                       non-secret string fields and an estimate of the hash
+//                       table's own nodes and buckets. O(entries); never
+//                       opens a Secret.
+//   ProcessMemoryStats  What the OS reports: locked bytes and the mlock
+//                       limit, current and maximum number of mappings.
+//                       Linux only; fields are empty elsewhere.
+//
+// Nothing here reads inside a Secret. Buffer sizes are reported, but those
+// are padding sizes (256 bytes for every password up to 255 characters), so
+// the numbers are safe to print and to return over the native messaging
+// channel.
+//
+// ============================================================================
+
+#include <pwledger/PrimaryTable.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include <nlohmann/json.hpp>
+
+namespace pwledger {
+
+// ----------------------------------------------------------------------------
+// SecureMemoryStats
+// ----------------------------------------------------------------------------
+struct SecureMemoryStats {
+  std::uint64_t live_allocations = 0;
+  std::uint64_t total_allocations = 0;  // since process start
+  std::uint64_t requested_bytes = 0;    // sum of Secret sizes
+  std::uint64_t mapped_bytes = 0;       // address space, guard pages included
+  std::uint64_t guard_bytes = 0;        // inaccessible guard pages
+  std::uint64_t locked_bytes = 0;       // data pages libsodium mlock()s
+  std::uint64_t peak_mapped_bytes = 0;
+};
+
+// Snapshot of the live Secret allocations. The fields are read one by one,
+// so a snapshot taken while another thread allocates may be off by one
+// allocation between fields.
+[[nodiscard]] SecureMemoryStats secure_memory_stats() noexcept;
+
+// How sodium_malloc lays out an allocation of `requested` bytes.
+struct SecureAllocationLayout {
+  std::size_t mapped = 0;
+  std::size_t guard = 0;
+  std::size_t locked = 0;
+};
+
+[[nodiscard]] SecureAllocationLayout secure_allocation_layout(std::size_t requested) noexcept;
+
+// ----------------------------------------------------------------------------
+// TableMemoryStats
+// ----------------------------------------------------------------------------
+struct TableMemoryStats {
+  std::uint64_t entries = 0;
+  std::uint64_t secret_buffer_bytes = 0;  // requested sizes of both Secrets
+  std::uint64_t string_bytes = 0;         // characters in non-secret strings
+  std::uint64_t string_heap_bytes = 0;    // heap blocks behind those strings
+  std::uint64_t table_bytes = 0;          // nodes + buckets (estimate)
+};
+
+[[nodiscard]] TableMemoryStats measure_table(const PrimaryTable& table) noexcept;
+
+// ----------------------------------------------------------------------------
+// ProcessMemoryStats
+// ----------------------------------------------------------------------------
+struct ProcessMemoryStats {
+  std::optional<std::uint64_t> locked_bytes;   // VmLck
+  std::optional<std::uint64_t> memlock_limit;  // RLIMIT_MEMLOCK soft limit
+  std::optional<std::uint64_t> map_count;      // lines in /proc/self/maps
+  std::optional<std::uint64_t> max_map_count;  // vm.max_map_count
+};
+
+[[nodiscard]] ProcessMemoryStats process_memory_stats();
+
+// {"secure": {...}, "process": {...}} plus "table": {...} when `table` is
+// given. Absent process fields are omitted. Shared by the CLI and the
+// native host so both report the same names.
+[[nodiscard]] nlohmann::json memory_stats_json(const PrimaryTable* table);
+
+namespace details {
+
+// Called by Secret after a successful sodium_malloc and before sodium_free.
+void note_secure_alloc(std::size_t size) noexcept;
+void note_secure_free(std::size_t size) noexcept;
+
+}  // namespace details
+
+}  // namespace pwledger
+
+#endif  // PWLEDGER_MEMORYSTATS_H
@@ -0,0 +1,136 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PWLEDGER_MERKLE_TREE_H
+#define PWLEDGER_MERKLE_TREE_H
+
+#include <pwledger/PrimaryTable.h>
+#include <pwledger/SecretEntry.h>
+#include <pwledger/uuid.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+// ============================================================================
+// DESIGN NOTES
+// ============================================================================
+//
+// MerkleTree summarizes a vault as (UUID, entry hash) pairs so that two
+// vaults, or a vault and what a peer held at the last sync, can be compared
+// without looking at entries that are the same on both sides.
+//
+// An entry's hash is BLAKE2b-256 of its canonical serialized form:
+// VaultSerializer::write_entry, UUID and every field included. Equal
+// hashes mean equal entries, down to the secret and the timestamps.
+//
+// SHAPE
+// -----
+// A 16-way trie on BLAKE2b(UUID), one nibble per level. Hashing the UUID
+// spreads time-ordered (version 7) IDs evenly, so the trie is about
+// log16(n) deep whatever order entries were created in. A node is a leaf
+// bucket while at most kBucketSize entries fall under its prefix and
+// splits into 16 children beyond that; it collapses back when removals
+// bring it down again. The shape therefore depends only on the set of
+// UUIDs, and equal contents give equal roots, however they were built.
+//
+//   leaf      BLAKE2b("L" || (UUID || entry hash) for each, in key order)
+//   internal  BLAKE2b("I" || the 16 child hashes)
+//   empty     32 zero bytes
+//
+// COST
+// ----
+// set() and erase() walk one path and mark it stale: O(log n). Hashes are
+// recomputed on the next root() or diff(), along the stale paths only.
+// diff() descends only into subtrees whose hashes differ, so comparing
+// trees that differ in k entries visits O(k log n) nodes. of() hashes every
+// entry once: O(n), the only full pass.
+//
+// The hashes cover the secrets: a tree, or a serialized one, is as
+// sensitive as a list of password hashes. VaultSync seals it like a vault.
+//
+// THREAD SAFETY: none; root() and diff() update cached hashes.
+//
+// ============================================================================
+
+namespace pwledger {
+
+class MerkleTree {
+public:
+  using Hash = std::array<std::uint8_t, 32>;
+
+  // Entries a leaf holds before it splits.
+  static constexpr std::size_t kBucketSize = 16;
+
+  // An entry whose hash differs between two trees: nullopt on the side that
+  // does not have it.
+  struct Change {
+    Uuid uuid;
+    std::optional<Hash> ours;
+    std::optional<Hash> theirs;
+  };
+
+  MerkleTree();
+  ~MerkleTree();
+  MerkleTree(MerkleTree&&) noexcept;
+  MerkleTree& operator=(MerkleTree&&) noexcept;
+  MerkleTree(const MerkleTree&) = delete;
+  MerkleTree& operator=(const MerkleTree&) = delete;
+
+  // Every entry of `table`, hashed.
+  static MerkleTree of(const PrimaryTable& table);
+
+  // BLAKE2b-256 of the entry's canonical serialized form.
+  [[nodiscard]] static Hash hash_entry(const Uuid& uuid, const SecretEntry& entry);
+
+  // Adds or replaces one entry's hash; removes one. erase returns false if
+  // `uuid` was not in the tree.
+  void set(const Uuid& uuid, const Hash& hash);
+  bool erase(const Uuid& uuid);
+
+  [[nodiscard]] std::optional<Hash> find(const Uuid& uuid) const;
+  [[nodiscard]] std::size_t size() const noexcept;
+
+  [[nodiscard]] Hash root() const;
+
+  // The entries whose hashes differ between this tree and `other`, in trie
+  // order. Empty exactly when the roots are equal.
+  [[nodiscard]] std::vector<Change> diff(const MerkleTree& other) const;
+
+  // Nodes visited by the last diff() (for tests and benchmarks).
+  [[nodiscard]] std::size_t last_diff_visits() const noexcept { return last_diff_visits_; }
+
+  // The (UUID, hash) pairs as bytes, and back. parse throws
+  // std::runtime_error on anything malformed.
+  [[nodiscard]] std::vector<std::uint8_t> serialize() const;
+  static MerkleTree parse(const std::uint8_t* data, std::size_t size);
+
+private:
+  struct Node;
+  struct Leaf;
+
+  std::unique_ptr<Node> root_;
+  mutable std::size_t last_diff_visits_ = 0;
+};
+
+}  // namespace pwledger
+
+#endif  // PWLEDGER_MERKLE_TREE_H
@@ -19,11 +19,14 @@
 #ifndef PWLEDGER_SECRET_H
 #define PWLEDGER_SECRET_H
 
+#include <pwledger/SecretProfiler.h>
+
 #include <sodium.h>
 
 #include <atomic>
 #include <cassert>
 #include <cstddef>
+#include <source_location>
 #include <span>
 
 // ============================================================================
@@ -112,6 +115,13 @@
 // In debug builds, an atomic access counter detects overlapping guards and
 // aborts with a diagnostic message.
 //
+// PROFILING
+// ---------
+// with_read_access, with_write_access, zeroize and the guard constructors
+// take a defaulted std::source_location naming their caller. It is only
+// used by the opt-in access profiler (see SecretProfiler.h), which counts
+// windows and hold times per call site; in normal builds it is ignored.
+//
 // ============================================================================
 
 namespace pwledger {
@@ -222,7 +232,7 @@ public:
   // implication that size() becomes 0.
   //
   // Not thread-safe. Requires external synchronization.
-  void zeroize() noexcept;
+  void zeroize(std::source_location site = std::source_location::current()) noexcept;
 
   // -- Safe scoped access (preferred API) ------------------------------------
   // These methods are the preferred way to access Secret's memory. They open
@@ -243,10 +253,11 @@ public:
   // construct Secret_readaccess / Secret_writeaccess, which are incomplete
   // types at this point in the header.
   template <typename F>
-  [[nodiscard]] decltype(auto) with_read_access(F&& f) const;
+  [[nodiscard]] decltype(auto) with_read_access(F&& f,
+                                                std::source_location site = std::source_location::current()) const;
 
   template <typename F>
-  [[nodiscard]] decltype(auto) with_write_access(F&& f);
+  [[nodiscard]] decltype(auto) with_write_access(F&& f, std::source_location site = std::source_location::current());
 
 private:
   char* data_ = nullptr;  // TODO: std::byte* or std::span<std::byte>
@@ -292,7 +303,7 @@ namespace details {
 //                // at worst UB if the pointer has been freed in between.
 class Secret_readaccess {
 public:
-  explicit Secret_readaccess(const Secret& s);
+  explicit Secret_readaccess(const Secret& s, std::source_location site = std::source_location::current());
 
   ~Secret_readaccess() noexcept;
 
@@ -305,6 +316,7 @@ public:
 
 private:
   const Secret& sec_;
+  [[no_unique_address]] secret_profile::Window window_;
 };
 
 // ----------------------------------------------------------------------------
@@ -320,7 +332,7 @@ private:
 // Copy and move are deleted for the same reasons as Secret_readaccess.
 class Secret_writeaccess {
 public:
-  explicit Secret_writeaccess(Secret& s);
+  explicit Secret_writeaccess(Secret& s, std::source_location site = std::source_location::current());
 
   ~Secret_writeaccess() noexcept;
 
@@ -333,6 +345,7 @@ public:
 
 private:
   Secret& sec_;
+  [[no_unique_address]] secret_profile::Window window_;
 };
 }  // namespace details
 
@@ -342,14 +355,14 @@ private:
 // These are defined after Secret_readaccess and Secret_writeaccess are
 // complete types. See the declarations inside the Secret class above.
 template <typename F>
-[[nodiscard]] decltype(auto) Secret::with_read_access(F&& f) const {
-  details::Secret_readaccess guard(*this);
+[[nodiscard]] decltype(auto) Secret::with_read_access(F&& f, std::source_location site) const {
+  details::Secret_readaccess guard(*this, site);
   return std::forward<F>(f)(guard.get());
 }
 
 template <typename F>
-[[nodiscard]] decltype(auto) Secret::with_write_access(F&& f) {
-  details::Secret_writeaccess guard(*this);
+[[nodiscard]] decltype(auto) Secret::with_write_access(F&& f, std::source_location site) {
+  details::Secret_writeaccess guard(*this, site);
   return std::forward<F>(f)(guard.get());
 }
 
@@ -23,10 +23,20 @@
 #include <pwledger/EntrySecurityPolicy.h>
 #include <pwledger/Secret.h>
 
+#include <cstddef>
 #include <string>
 
 namespace pwledger {
 
+// Size of every password buffer: the plaintext_secret of an entry and the
+// prompts and imports that fill one. 256 bytes provides 255 usable
+// characters (the last byte holds '\0'). This is sufficient for the vast
+// majority of passwords and passphrases. It is intentionally *not* sized for
+// SSH private keys or TLS certificates; those require a different storage
+// model (file-backed, streaming) rather than a single contiguous
+// sodium_malloc buffer.
+inline constexpr std::size_t kMaxSecretBytes = 256;
+
 // ----------------------------------------------------------------------------
 // SecretEntry
 // ----------------------------------------------------------------------------
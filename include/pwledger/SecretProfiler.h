@@ -0,0 +1,187 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PWLEDGER_SECRETPROFILER_H
+#define PWLEDGER_SECRETPROFILER_H
+
+// ============================================================================
+// DESIGN NOTES
+// ============================================================================
+//
+// An opt-in profiler for Secret access windows. Every access guard costs two
+// mprotect syscalls (open, then re-lock), and the window between them is
+// time during which the secret is readable. This answers two questions:
+// which call sites open the most windows, so batching is worth it there, and
+// whether any window stays open longer than it should.
+//
+// ENABLING
+// --------
+// Compile time only: the PWLEDGER_ENABLE_SECRET_PROFILER CMake option
+// (default OFF) defines PWLEDGER_SECRET_PROFILING=1. With the option OFF,
+// Window is an empty type whose members are inline no-ops, so guards carry
+// no extra state and make no extra calls. The call-site parameter still
+// exists on with_read_access/with_write_access/zeroize so that the API does
+// not change between builds; it is a defaulted std::source_location and
+// costs nothing to pass.
+//
+// A profiling build writes its report when the process exits normally: to
+// the file named by PWLEDGER_SECRET_PROFILE, or to stderr when the variable
+// is unset or "-".
+//
+// WHAT IS RECORDED
+// ----------------
+// Per call site (file, line, function of the code that called
+// with_read_access, with_write_access, zeroize or a guard constructor):
+// read and write window counts, time spent inside mprotect, and a
+// histogram of hold times, measured from the opening mprotect returning to
+// the re-locking one starting. Nothing about the secret itself is recorded,
+// not even its size.
+//
+// Hold-time buckets are powers of two in nanoseconds, so percentiles in the
+// report are upper bounds within a factor of two. That is enough to tell a
+// 2 us window from a 2 ms one, which is what the report is for.
+//
+// THREAD SAFETY
+// -------------
+// Windows may close on any thread. Recording takes a mutex and a hash
+// lookup per window; next to two syscalls that is noise, and this is a
+// profiling build.
+//
+// ============================================================================
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <source_location>
+#include <string>
+#include <vector>
+
+#ifndef PWLEDGER_SECRET_PROFILING
+#define PWLEDGER_SECRET_PROFILING 0
+#endif
+
+namespace pwledger::secret_profile {
+
+inline constexpr bool kEnabled = PWLEDGER_SECRET_PROFILING != 0;
+
+enum class Access : std::uint8_t { kRead, kWrite };
+
+// ----------------------------------------------------------------------------
+// HoldHistogram
+// ----------------------------------------------------------------------------
+// Bucket i counts holds in [2^i, 2^(i+1)) ns; bucket 0 also takes 0 ns.
+struct HoldHistogram {
+  static constexpr std::size_t kBuckets = 48;  // up to ~3 days
+
+  std::array<std::uint64_t, kBuckets> counts{};
+  std::uint64_t total = 0;
+  std::uint64_t max_ns = 0;
+
+  void record(std::uint64_t ns) noexcept;
+
+  // Upper bound of the bucket holding quantile q (0..1), in nanoseconds.
+  [[nodiscard]] std::uint64_t quantile_ns(double q) const noexcept;
+};
+
+// ----------------------------------------------------------------------------
+// Report
+// ----------------------------------------------------------------------------
+struct SiteReport {
+  std::string file;
+  std::string function;
+  std::uint32_t line = 0;
+  std::uint64_t reads = 0;
+  std::uint64_t writes = 0;
+  std::uint64_t mprotect_calls = 0;
+  std::uint64_t mprotect_ns = 0;
+  HoldHistogram hold;
+};
+
+struct Report {
+  std::vector<SiteReport> sites;  // most windows first
+  std::uint64_t mprotect_calls = 0;  // all sites, plus allocations
+  std::uint64_t mprotect_ns = 0;
+};
+
+// Everything recorded so far. Empty unless kEnabled.
+[[nodiscard]] Report snapshot();
+
+// Discards everything recorded so far. For tests.
+void reset() noexcept;
+
+// Human-readable table, one line per site.
+void write_report(std::FILE* out, const Report& report);
+
+namespace detail {
+
+std::uint64_t now_ns() noexcept;
+
+void record_window(const std::source_location& site, Access access, std::uint64_t hold_ns,
+                   std::uint64_t mprotect_ns) noexcept;
+
+// mprotect calls that are not part of a window (Secret::allocate).
+void record_mprotect(std::uint64_t ns) noexcept;
+
+}  // namespace detail
+
+// ----------------------------------------------------------------------------
+// Window
+// ----------------------------------------------------------------------------
+// Embedded in each access guard; brackets the two mprotect calls:
+//
+//   window.before_open();  mprotect(...);  window.opened();
+//   ... caller reads or writes ...
+//   window.before_close(); mprotect(NOACCESS); window.closed(access);
+#if PWLEDGER_SECRET_PROFILING
+class Window {
+ public:
+  explicit Window(const std::source_location& site) noexcept
+      : site_(site) {}
+
+  void before_open() noexcept { mark_ = detail::now_ns(); }
+  void opened() noexcept {
+    opened_ = detail::now_ns();
+    mprotect_ns_ = opened_ - mark_;
+  }
+  void before_close() noexcept { mark_ = detail::now_ns(); }
+  void closed(Access access) noexcept {
+    const std::uint64_t now = detail::now_ns();
+    detail::record_window(site_, access, mark_ - opened_, mprotect_ns_ + (now - mark_));
+  }
+
+ private:
+  std::source_location site_;
+  std::uint64_t mark_ = 0;
+  std::uint64_t opened_ = 0;
+  std::uint64_t mprotect_ns_ = 0;
+};
+#else
+class Window {
+ public:
+  explicit Window(const std::source_location&) noexcept {}
+
+  void before_open() noexcept {}
+  void opened() noexcept {}
+  void before_close() noexcept {}
+  void closed(Access) noexcept {}
+};
+#endif
+
+}  // namespace pwledger::secret_profile
+
+#endif  // PWLEDGER_SECRETPROFILER_H
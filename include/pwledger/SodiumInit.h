@@ -0,0 +1,45 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PWLEDGER_SODIUMINIT_H
+#define PWLEDGER_SODIUMINIT_H
+
+namespace pwledger {
+
+// ----------------------------------------------------------------------------
+// sodium_init_once
+// ----------------------------------------------------------------------------
+// Initializes libsodium exactly once per process and reports whether that
+// initialization succeeded. The first call runs sodium_init(); every later
+// call is a single guard-variable load, so it is cheap enough to place in
+// front of any code path that is about to construct a Secret or call into
+// libsodium.
+//
+// This exists so that short-lived processes (the native messaging host in
+// particular) can defer libsodium setup until a command actually needs it,
+// instead of paying for it before the first response is written. It is
+// thread-safe: concurrent first calls are serialized by the function-local
+// static initialization guarantee of C++11.
+//
+// Callers that cannot continue without libsodium should treat a false return
+// as fatal (see FAILURE MODEL in Secret.h).
+[[nodiscard]] bool sodium_init_once() noexcept;
+
+}  // namespace pwledger
+
+#endif  // PWLEDGER_SODIUMINIT_H
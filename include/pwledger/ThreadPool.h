@@ -0,0 +1,186 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PWLEDGER_THREAD_POOL_H
+#define PWLEDGER_THREAD_POOL_H
+
+#include <pwledger/Config.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// ============================================================================
+// DESIGN NOTES
+// ============================================================================
+//
+// A work-stealing pool of worker threads for the core library: multi-lane
+// Argon2id, bulk import, auditing and other work that splits into
+// independent pieces. One process-wide instance, ThreadPool::shared(), is
+// sized from ThreadPoolConfig (config.json "thread_pool"); tests and
+// benchmarks may construct their own.
+//
+// SCHEDULING
+// ----------
+// Every worker owns a deque. A task submitted from a worker goes to the back
+// of that worker's deque and is popped from the back again (LIFO, so nested
+// work stays hot in cache); a task submitted from any other thread goes to a
+// shared injection queue. An idle worker first drains its own deque, then
+// the injection queue, then steals from the front of the other workers'
+// deques, and sleeps on a condition variable only when all are empty.
+// Deques are guarded by one mutex each: tasks here are coarse (a lane
+// segment, a batch of entries), so a lock-free deque would not pay for its
+// complexity.
+//
+// parallel_for
+// ------------
+// The calling thread takes part: it and up to size() helper tasks claim
+// chunks from a shared counter until none are left, then the caller waits
+// for chunks still running elsewhere. Because nothing ever waits on a chunk
+// that has not been claimed, nested parallel_for calls (from inside a task)
+// and a pool with fewer workers than chunks cannot deadlock. The first
+// exception thrown by the body is rethrown in the caller after every claimed
+// chunk has finished; chunks not yet started are skipped.
+//
+// SECRETS ON WORKER STACKS
+// ------------------------
+// Tasks handle key material (Argon2id blocks, decrypted entries) in locals.
+// After each task a worker wipes `scrub_stack_kib` of its stack below the
+// point where tasks run, so a finished task does not leave plaintext in
+// stack memory that stays mapped for the life of the process. Secrets held
+// in Secret buffers are unaffected; this covers the copies that compilers
+// spill to the stack.
+//
+// SHUTDOWN
+// --------
+// The destructor (or shutdown()) stops the workers. With drain_on_shutdown
+// queued tasks still run first; without, they are destroyed unrun, and the
+// futures of dropped submit() calls report std::future_errc::broken_promise.
+// submit() after shutdown throws std::runtime_error; parallel_for runs the
+// whole range on the calling thread.
+//
+// ============================================================================
+
+namespace pwledger {
+
+class ThreadPool {
+public:
+  // Starts the workers: config.threads of them, or one per hardware thread
+  // when that is 0 or less.
+  explicit ThreadPool(const ThreadPoolConfig& config = {});
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // The process-wide pool, created on first use from the configuration given
+  // to configure_shared (defaults if it was never called).
+  static ThreadPool& shared();
+
+  // Sets the configuration shared() will use. Returns false, changing
+  // nothing, once the shared pool exists.
+  static bool configure_shared(const ThreadPoolConfig& config);
+
+  // Number of worker threads.
+  [[nodiscard]] std::size_t size() const noexcept { return workers_.size(); }
+
+  // Whether the calling thread is one of this pool's workers.
+  [[nodiscard]] bool on_worker_thread() const noexcept;
+
+  // Runs `f` on a worker. The future holds its result or exception.
+  template <typename F>
+  auto submit(F&& f) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+    using R = std::invoke_result_t<std::decay_t<F>>;
+    auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+    std::future<R> result = task->get_future();
+    enqueue([task = std::move(task)] { (*task)(); });
+    return result;
+  }
+
+  // Calls body(i) for every i in [begin, end), `grain` consecutive indices
+  // per task, on at most `max_parallelism` threads including the caller
+  // (0 = size() + 1). Returns once every call has finished.
+  template <typename F>
+  void parallel_for(std::size_t begin, std::size_t end, F&& body, std::size_t grain = 1,
+                    std::size_t max_parallelism = 0) {
+    if (begin >= end) {
+      return;
+    }
+    grain = std::max<std::size_t>(grain, 1);
+    const std::size_t chunks = (end - begin + grain - 1) / grain;
+    run_chunks(chunks, max_parallelism, [&](std::size_t chunk) {
+      const std::size_t lo = begin + chunk * grain;
+      const std::size_t hi = std::min(end, lo + grain);
+      for (std::size_t i = lo; i < hi; ++i) {
+        body(i);
+      }
+    });
+  }
+
+  // Stops the workers as described in DESIGN NOTES and joins them.
+  // Idempotent; called by the destructor.
+  void shutdown() noexcept;
+
+  struct Stats {
+    std::uint64_t executed = 0;  // tasks run
+    std::uint64_t stolen = 0;    // of which taken from another worker's deque
+  };
+  [[nodiscard]] Stats stats() const noexcept;
+
+private:
+  using Task = std::function<void()>;
+
+  struct Worker;
+
+  void enqueue(Task task);
+  void run_chunks(std::size_t chunks, std::size_t max_parallelism, const std::function<void(std::size_t)>& body);
+  bool try_pop(std::size_t self, Task& task);
+  void worker_main(std::size_t self);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::mutex injected_mutex_;
+  std::deque<Task> injected_;
+
+  // Tasks in any queue. Changed under the lock of the queue that gained or
+  // lost the task, so it never underflows.
+  std::atomic<std::size_t> pending_{0};
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  bool stopping_ = false;  // guarded by sleep_mutex_
+  std::atomic<bool> stopped_{false};
+
+  bool drain_on_shutdown_ = true;
+  std::size_t scrub_stack_kib_ = 0;
+
+  std::atomic<std::uint64_t> executed_{0};
+  std::atomic<std::uint64_t> stolen_{0};
+};
+
+}  // namespace pwledger
+
+#endif  // PWLEDGER_THREAD_POOL_H
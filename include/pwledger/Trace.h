@@ -0,0 +1,218 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PWLEDGER_TRACE_H
+#define PWLEDGER_TRACE_H
+
+// ============================================================================
+// DESIGN NOTES
+// ============================================================================
+//
+// Phase-level span tracing for the slow paths of the core library: vault
+// load/save, key derivation, AEAD and (de)serialization. The goal is to
+// answer "which phase of unlock is slow on this machine" without attaching a
+// profiler, by writing Chrome trace-event JSON that Perfetto
+// (https://ui.perfetto.dev) or chrome://tracing can open directly.
+//
+// ENABLING
+// --------
+// Two switches, both required:
+//
+//   - Compile time: the PWLEDGER_ENABLE_TRACING CMake option (default ON)
+//     defines PWLEDGER_TRACING=1. With the option OFF, PWLEDGER_TRACE_SPAN
+//     expands to nothing and trace::enabled() is a constant false, so every
+//     span, Stopwatch and argument is dead code and is removed by the
+//     optimizer.
+//   - Run time: the PWLEDGER_TRACE environment variable names the output
+//     file. It is read once, on the first span. When unset, a span costs one
+//     relaxed atomic load and a predictable branch.
+//
+// The buffered spans are written when the process exits normally, or
+// earlier via trace::flush(). A process that is killed loses its trace.
+//
+// WHAT IS RECORDED
+// ----------------
+// Span names and argument keys are `const char*` that must point at string
+// literals; argument values are integers. There is deliberately no way to
+// attach a std::string, so a trace cannot carry a primary key, username or
+// any other vault content. Traces are safe to attach to bug reports.
+//
+// Each span is recorded as a complete ("ph":"X") event carrying the thread
+// it ran on; nesting is implied by the timestamps, which is how Perfetto
+// reconstructs the call tree.
+//
+// THREAD SAFETY
+// -------------
+// Spans may be opened on any thread. Completed spans are appended to a
+// single mutex-protected buffer, which is acceptable because spans are
+// placed around millisecond-scale phases, never around per-entry work. For
+// per-entry costs, use a Stopwatch and attach its total as a span argument.
+// The buffer is capped at kMaxEvents; spans beyond the cap are counted and
+// reported as "dropped_events" in the output instead of growing without
+// bound.
+//
+// ============================================================================
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+#ifndef PWLEDGER_TRACING
+#define PWLEDGER_TRACING 0
+#endif
+
+namespace pwledger::trace {
+
+// Maximum number of buffered spans per process.
+inline constexpr std::size_t kMaxEvents = std::size_t{1} << 20;
+
+// Maximum number of integer arguments attached to a single span.
+inline constexpr std::size_t kMaxArgs = 4;
+
+namespace detail {
+
+// -1: PWLEDGER_TRACE not read yet, 0: disabled, 1: enabled.
+extern std::atomic<int> g_state;
+
+bool init_from_env() noexcept;
+
+struct Arg {
+  const char* key = nullptr;
+  std::uint64_t value = 0;
+};
+
+void record(const char* name, std::uint64_t start_ns, std::uint64_t end_ns, const Arg* args,
+            std::size_t arg_count) noexcept;
+
+}  // namespace detail
+
+// ----------------------------------------------------------------------------
+// enabled / now_ns
+// ----------------------------------------------------------------------------
+// enabled() reports whether spans are currently being recorded. now_ns() is a
+// monotonic timestamp in nanoseconds (steady_clock).
+inline bool enabled() noexcept {
+#if PWLEDGER_TRACING
+  const int state = detail::g_state.load(std::memory_order_relaxed);
+  return state > 0 || (state < 0 && detail::init_from_env());
+#else
+  return false;
+#endif
+}
+
+std::uint64_t now_ns() noexcept;
+
+// ----------------------------------------------------------------------------
+// set_output / flush
+// ----------------------------------------------------------------------------
+// set_output() overrides PWLEDGER_TRACE: a non-empty path enables recording
+// into a fresh buffer that will be written to `path`; an empty path disables
+// recording and discards the buffer. Intended for tests and embedders that
+// want to trace a specific operation.
+//
+// flush() writes every span buffered so far to the output file, replacing
+// its previous contents. The buffer is kept, so a later flush (including the
+// implicit one at exit) produces a superset. Returns false if tracing is
+// disabled or the file could not be written; failures are also reported on
+// stderr, since a trace is a diagnostic and must never fail the operation
+// being traced.
+void set_output(const std::filesystem::path& path);
+bool flush() noexcept;
+
+// ----------------------------------------------------------------------------
+// Span
+// ----------------------------------------------------------------------------
+// RAII scope: records one complete event from construction to destruction.
+// Use through PWLEDGER_TRACE_SPAN, or declare directly when arguments are
+// attached:
+//
+//   trace::Span span("VaultIO::read_file");
+//   ...
+//   span.arg("bytes", ciphertext.size());
+class Span {
+ public:
+  explicit Span(const char* name) noexcept
+      : name_(name)
+      , active_(enabled()) {
+    if (active_) start_ns_ = now_ns();
+  }
+
+  ~Span() {
+    if (active_) detail::record(name_, start_ns_, now_ns(), args_.data(), arg_count_);
+  }
+
+  Span(const Span&) = delete;
+  Span& operator=(const Span&) = delete;
+
+  // Attaches an integer argument, shown in Perfetto's slice details. `key`
+  // must be a string literal. Arguments beyond kMaxArgs are ignored.
+  void arg(const char* key, std::uint64_t value) noexcept {
+    if (active_ && arg_count_ < kMaxArgs) args_[arg_count_++] = detail::Arg{key, value};
+  }
+
+ private:
+  const char* name_;
+  bool active_;
+  std::uint64_t start_ns_ = 0;
+  std::array<detail::Arg, kMaxArgs> args_{};
+  std::size_t arg_count_ = 0;
+};
+
+// ----------------------------------------------------------------------------
+// Stopwatch
+// ----------------------------------------------------------------------------
+// Accumulates time across many short intervals (e.g. one per vault entry)
+// without emitting a span for each. Start/stop are no-ops while tracing is
+// disabled.
+class Stopwatch {
+ public:
+  void start() noexcept {
+    if (enabled()) started_ns_ = now_ns();
+  }
+
+  void stop() noexcept {
+    if (started_ns_ != 0) total_ns_ += now_ns() - started_ns_;
+    started_ns_ = 0;
+  }
+
+  [[nodiscard]] std::uint64_t total_us() const noexcept { return total_ns_ / 1000; }
+
+ private:
+  std::uint64_t started_ns_ = 0;
+  std::uint64_t total_ns_ = 0;
+};
+
+}  // namespace pwledger::trace
+
+// ----------------------------------------------------------------------------
+// PWLEDGER_TRACE_SPAN
+// ----------------------------------------------------------------------------
+// Opens an anonymous Span for the rest of the enclosing scope.
+#define PWLEDGER_TRACE_CONCAT_INNER(a, b) a##b
+#define PWLEDGER_TRACE_CONCAT(a, b) PWLEDGER_TRACE_CONCAT_INNER(a, b)
+
+#if PWLEDGER_TRACING
+#define PWLEDGER_TRACE_SPAN(name) \
+  const ::pwledger::trace::Span PWLEDGER_TRACE_CONCAT(pwledger_trace_span_, __LINE__)(name)
+#else
+#define PWLEDGER_TRACE_SPAN(name) static_cast<void>(0)
+#endif
+
+#endif  // PWLEDGER_TRACE_H
@@ -0,0 +1,155 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PWLEDGER_TRANSACTION_H
+#define PWLEDGER_TRANSACTION_H
+
+#include <pwledger/PrimaryTable.h>
+#include <pwledger/Secret.h>
+#include <pwledger/SecretEntry.h>
+#include <pwledger/uuid.h>
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <vector>
+
+// ============================================================================
+// DESIGN NOTES
+// ============================================================================
+//
+// A batch of changes to a PrimaryTable that lands all at once or not at all,
+// followed by one save instead of one per change.
+//
+//   Transaction tx(table);
+//   tx.insert(std::move(entry));
+//   tx.update_secret(uuid, std::move(new_secret));
+//   tx.erase(other_uuid);
+//   tx.commit([&](const PrimaryTable& t) { VaultIO::save_vault(path, t, pw, kdf); });
+//
+// STAGING
+// -------
+// insert / update_secret / touch / erase only record the change; the table
+// is not touched until commit. Staged entries and secrets are owned by the
+// transaction, in Secret memory as always. rollback() (or the destructor of
+// a transaction never committed) destroys them, which wipes them through
+// sodium_free.
+//
+// COMMIT
+// ------
+// Operations are applied in the order they were staged, so a later one sees
+// the earlier ones (insert then update_secret of the same UUID works). An
+// operation that does not fit the table - insert of a UUID that exists, any
+// other on one that does not - undoes everything applied before it and makes
+// commit throw std::runtime_error with the table as it was.
+//
+// Every operation keeps what it replaced: an erased entry stays in its
+// extracted map node, an updated entry's old Secret is swapped into the
+// operation, timestamps are saved. That makes undo allocation-free and
+// noexcept: nodes go back into buckets reserved before the first change.
+// The same undo runs when the persist callback throws, so after a failed
+// save the table matches the file on disk again. Only after persist returns
+// are the replaced Secrets and erased entries destroyed (and wiped).
+//
+// A transaction is single-use: once committed or rolled back, staging or
+// committing again throws std::logic_error. After a failed commit it is
+// still open, its operations intact, and may be retried or rolled back.
+// Like PrimaryTable itself, it is not thread-safe.
+//
+// ============================================================================
+
+namespace pwledger {
+
+class Transaction {
+public:
+  // Writes the table out after the changes are applied (typically
+  // VaultIO::save_vault). Throwing aborts the commit.
+  using Persist = std::function<void(const PrimaryTable&)>;
+
+  explicit Transaction(PrimaryTable& table) noexcept;
+
+  // Rolls back if neither commit nor rollback has been called.
+  ~Transaction();
+
+  Transaction(const Transaction&) = delete;
+  Transaction& operator=(const Transaction&) = delete;
+
+  // -- Staging ----------------------------------------------------------------
+  // None of these touch the table. An empty UUID throws
+  // std::invalid_argument.
+
+  // Stages `entry` under a freshly generated UUID, which is returned.
+  Uuid insert(SecretEntry entry);
+  void insert(const Uuid& uuid, SecretEntry entry);
+
+  // Stages every entry of `entries`, which is left empty.
+  void insert_all(PrimaryTable&& entries);
+
+  // Replaces the entry's secret and sets last_modified_at.
+  void update_secret(const Uuid& uuid, Secret secret);
+
+  // Sets last_used_at.
+  void touch(const Uuid& uuid);
+
+  void erase(const Uuid& uuid);
+
+  // Number of staged operations.
+  [[nodiscard]] std::size_t size() const noexcept { return ops_.size(); }
+
+  // True until commit succeeds or rollback is called.
+  [[nodiscard]] bool active() const noexcept { return active_; }
+
+  // -- Completion -------------------------------------------------------------
+
+  // Applies every staged operation or, throwing std::runtime_error, none.
+  void commit();
+
+  // commit(), then persist(table) once. If persist throws, the changes are
+  // undone and the exception propagates.
+  void commit(const Persist& persist);
+
+  // Drops the staged operations, wiping their secrets.
+  void rollback() noexcept;
+
+private:
+  enum class Kind { kInsert, kUpdateSecret, kTouch, kErase };
+
+  struct Op {
+    Kind kind;
+    Uuid uuid;
+    PrimaryTable::node_type node;   // kInsert before apply, kErase after
+    std::optional<Secret> secret;   // kUpdateSecret: the new one, then the old one
+    std::chrono::system_clock::time_point previous{};  // replaced timestamp
+  };
+
+  void stage(Op op);
+  void require_active() const;
+
+  // Applies `op`; returns false, changing nothing, if it does not fit.
+  bool apply(Op& op);
+  void undo(Op& op) noexcept;
+
+  PrimaryTable& table_;
+  std::vector<Op> ops_;
+  bool active_ = true;
+};
+
+}  // namespace pwledger
+
+#endif  // PWLEDGER_TRANSACTION_H
@@ -22,46 +22,201 @@
 #include <pwledger/Secret.h>
 #include <sodium.h>
 
+#include <chrono>
 #include <cstdint>
+#include <functional>
+#include <optional>
 #include <stdexcept>
 #include <string_view>
 #include <vector>
 
 namespace pwledger {
 
+// ----------------------------------------------------------------------------
+// KdfParams
+// ----------------------------------------------------------------------------
+// Argon2id cost parameters. The defaults are libsodium's INTERACTIVE limits,
+// which new vaults use until `calibrate_kdf` picks stronger ones for this
+// machine. Each vault records the parameters it was sealed with in its
+// header, so a vault opens with its own cost whatever the reader's defaults;
+// only files from before that header (see VaultCrypto) need the caller to
+// pass matching parameters.
+//
+// `parallelism` is Argon2id's lane count p. One lane goes through
+// libsodium's crypto_pwhash; more lanes through the in-tree implementation
+// in Argon2.h, which fills them on separate threads. The derived key depends
+// on it, like on the other two.
+struct KdfParams {
+  unsigned long long opslimit = crypto_pwhash_OPSLIMIT_INTERACTIVE;
+  std::size_t memlimit = crypto_pwhash_MEMLIMIT_INTERACTIVE;
+  std::uint32_t parallelism = 1;
+
+  bool operator==(const KdfParams&) const = default;
+};
+
+// ----------------------------------------------------------------------------
+// calibrate_kdf
+// ----------------------------------------------------------------------------
+// Picks Argon2id parameters that take about `target` to derive a key on this
+// machine. Memory is doubled first, up to `max_memlimit`, since memory is
+// what makes Argon2id expensive to attack; the remaining budget goes into
+// passes (the cost is linear in both), up to VaultCrypto::kMaxOpslimit.
+// The result never drops below the KdfParams defaults: on a machine too
+// slow to meet `target` with them, they are returned unchanged apart from
+// the lane count.
+//
+// `parallelism` is fixed before the search: 0 means one lane per hardware
+// thread (at most VaultCrypto::kMaxParallelism), so a multicore machine
+// spends the same wall-clock time on more memory.
+//
+// Each probe is one real key derivation, so calibration takes a small
+// multiple of `target`.
+struct KdfCalibration {
+  std::chrono::milliseconds target{500};
+  std::size_t max_memlimit = crypto_pwhash_MEMLIMIT_MODERATE;  // 256 MiB
+  std::uint32_t parallelism = 0;
+};
+
+[[nodiscard]] KdfParams calibrate_kdf(const KdfCalibration& calibration = {});
+
+// The same search against a caller-supplied cost, e.g. a model for tests.
+[[nodiscard]] KdfParams calibrate_kdf(const KdfCalibration& calibration,
+                                      const std::function<std::chrono::nanoseconds(const KdfParams&)>& measure);
+
+// ----------------------------------------------------------------------------
+// CipherSuite
+// ----------------------------------------------------------------------------
+// The AEAD a vault file is sealed with, recorded in its header. Values are
+// part of the file format: never renumber them.
+//
+// AES-256-GCM is the faster AEAD on large vaults (BM_EncryptWithKey/<suite>)
+// but libsodium only offers it with hardware support (AES-NI + CLMUL on
+// x86-64, the ARMv8 crypto extensions on AArch64). New vaults use it where
+// that support exists and XChaCha20-Poly1305 elsewhere. Every save picks
+// again, so a vault saved on a machine without AES support is rewritten as
+// XChaCha20-Poly1305 there. Reading an AES-256-GCM vault on such a machine
+// fails with an error naming the suite, as libsodium has no software AES to
+// fall back to.
+enum class CipherSuite : std::uint8_t {
+  kXChaCha20Poly1305 = 1,
+  kAes256Gcm = 2,
+};
+
+// "xchacha20poly1305" or "aes256gcm".
+[[nodiscard]] std::string_view cipher_suite_name(CipherSuite suite) noexcept;
+
+// Inverse of cipher_suite_name.
+[[nodiscard]] std::optional<CipherSuite> parse_cipher_suite(std::string_view name) noexcept;
+
 // ----------------------------------------------------------------------------
 // VaultCrypto
 // ----------------------------------------------------------------------------
-// Wraps libsodium's Argon2id (for KDF) and XChaCha20-Poly1305 (for AEAD).
+// Wraps libsodium's Argon2id (for KDF) and the AEAD selected by CipherSuite.
 //
 // The output vault format from `encrypt_vault` is:
-//   [ ARGON2_SALTBYTES (16) ] [ XCHACHA20_NONCEBYTES (24) ] [ ciphertext ]
-// The auth tag (16 bytes) is appended to the ciphertext automatically by
-// crypto_aead_xchacha20poly1305_ietf_encrypt.
+//   [ "PWLV" ] [ version (1) = 3 ] [ suite (1) ]
+//   [ opslimit (u32 LE) ] [ memlimit in KiB (u32 LE) ] [ lanes (1) ]
+//   [ ARGON2_SALTBYTES (16) ] [ nonce (24 for XChaCha20, 12 for AES-GCM) ]
+//   [ ciphertext ]
+// The auth tag (16 bytes for both suites) is appended to the ciphertext by
+// the AEAD, and every header byte before the ciphertext is bound to it as
+// additional data, so a swapped suite byte fails authentication.
+//
+// Files from before the header still decrypt, with the caller's KdfParams
+// since they do not record any. Every save writes the current version,
+// which is how they are upgraded:
+//   headerless  [ salt ] [ XChaCha20 nonce ] [ ciphertext ], no additional data
+// Version 4 is the key-slot format (KeySlots.h), which VaultCrypto does not
+// open: its functions reject it with an error saying so.
+// A headerless salt that happens to begin with the magic and a known version
+// (probability about 2^-39) would be misread and fail to decrypt.
 
 class VaultCrypto {
 public:
   // Layout constants
+  static constexpr std::uint8_t kMagic[4] = {'P', 'W', 'L', 'V'};
+  static constexpr std::uint8_t kFormatVersion = 3;
+  static constexpr std::size_t kPrefixBytes = sizeof(kMagic) + 2 + 9;  // magic, version, suite, KDF params
   static constexpr std::size_t kSaltBytes = crypto_pwhash_SALTBYTES;
-  static constexpr std::size_t kNonceBytes = crypto_aead_xchacha20poly1305_ietf_NPUBBYTES;
   static constexpr std::size_t kKeyBytes = crypto_aead_xchacha20poly1305_ietf_KEYBYTES;
   static constexpr std::size_t kTagBytes = crypto_aead_xchacha20poly1305_ietf_ABYTES;
-  static constexpr std::size_t kHeaderBytes = kSaltBytes + kNonceBytes;
+  static_assert(crypto_aead_aes256gcm_KEYBYTES == kKeyBytes && crypto_aead_aes256gcm_ABYTES == kTagBytes,
+                "both suites share the key and tag sizes");
 
-  // Derive a master key from a password and salt using Argon2id.
+  static constexpr std::size_t nonce_bytes(CipherSuite suite) noexcept {
+    return suite == CipherSuite::kAes256Gcm ? crypto_aead_aes256gcm_NPUBBYTES
+                                            : crypto_aead_xchacha20poly1305_ietf_NPUBBYTES;
+  }
+  // Everything before the ciphertext.
+  static constexpr std::size_t header_bytes(CipherSuite suite) noexcept {
+    return kPrefixBytes + kSaltBytes + nonce_bytes(suite);
+  }
+
+  // AES-256-GCM when libsodium can run it on this CPU, else
+  // XChaCha20-Poly1305. Initializes libsodium if needed.
+  static CipherSuite default_cipher_suite() noexcept;
+
+  // Largest memlimit a header may ask for. Bounds what a crafted file can
+  // make the reader allocate before authentication can fail.
+  static constexpr std::size_t kMaxMemlimit = std::size_t{4} << 30;
+  // Largest pass count a header may ask for. With kMaxMemlimit it bounds
+  // the time a crafted file can make an unlock take to minutes, where
+  // Argon2id's own limit (2^32 - 1 passes) would be centuries.
+  static constexpr unsigned long long kMaxOpslimit = 256;
+  // Largest lane count a header may ask for, which is also the most threads
+  // a derivation uses.
+  static constexpr std::uint32_t kMaxParallelism = 16;
+
+  // The suite a vault blob was sealed with (kXChaCha20Poly1305 for a legacy
+  // blob). Throws std::runtime_error on a truncated blob, an unknown format
+  // version or an unknown suite.
+  static CipherSuite cipher_suite_of(const std::vector<std::uint8_t>& ciphertext_blob);
+
+  // The KDF parameters recorded in a blob's header, or nullopt for a blob
+  // from before they were recorded. Throws as cipher_suite_of, and on
+  // parameters outside Argon2id's limits or above kMaxOpslimit,
+  // kMaxMemlimit or kMaxParallelism.
+  static std::optional<KdfParams> kdf_params_of(const std::vector<std::uint8_t>& ciphertext_blob);
+
+  // Throws std::runtime_error on parameters outside Argon2id's limits or
+  // above kMaxOpslimit, kMaxMemlimit or kMaxParallelism: what every header
+  // is checked against, when written and when read.
+  static void check_kdf_params(const KdfParams& kdf);
+
+  // Derive a master key from a password and salt using Argon2id, with
+  // libsodium for one lane and argon2id() (Argon2.h) for more.
   // The resulting key is stored in a hardened Secret buffer.
-  // We use the INTERACTIVE limits to keep the CLI responsive (e.g., < 0.5s),
-  // which is fine since the password will be strong.
-  static Secret derive_master_key(std::string_view password, const std::uint8_t* salt);
+  static Secret derive_master_key(std::string_view password, const std::uint8_t* salt, const KdfParams& kdf = {});
 
   // Encrypts plaintext bytes with a master password.
-  // Generates a random salt for Argon2id and a random nonce for XChaCha20.
-  // Returns [salt][nonce][ciphertext+tag].
-  static std::vector<std::uint8_t> encrypt_vault(std::string_view password, const std::vector<std::uint8_t>& plaintext);
+  // Generates a random salt for Argon2id and a random nonce for the AEAD,
+  // and records `kdf` in the header.
+  // Returns [prefix][salt][nonce][ciphertext+tag].
+  static std::vector<std::uint8_t> encrypt_vault(std::string_view password,
+                                                 const std::vector<std::uint8_t>& plaintext,
+                                                 const KdfParams& kdf = {},
+                                                 CipherSuite suite = default_cipher_suite());
 
-  // Decrypts a vault buffer with a master password.
+  // Decrypts a vault buffer with a master password, whichever suite sealed it.
+  // Uses the KDF parameters in the header; `kdf` only applies to blobs that
+  // do not record any.
   // Throws std::runtime_error if authentication fails (wrong password or data corruption).
-  static std::vector<std::uint8_t> decrypt_vault(std::string_view password, const std::vector<std::uint8_t>& ciphertext_blob);
+  static std::vector<std::uint8_t> decrypt_vault(std::string_view password,
+                                                 const std::vector<std::uint8_t>& ciphertext_blob,
+                                                 const KdfParams& kdf = {});
+
+  // AEAD halves of encrypt_vault / decrypt_vault for a key that has already
+  // been derived. `salt` and `kdf` are only recorded in the header (they
+  // must be what `key` was derived with); a fresh random nonce is generated
+  // per call. Separated so the Argon2id cost can be measured and reasoned
+  // about on its own.
+  static std::vector<std::uint8_t> encrypt_with_key(const Secret& key,
+                                                    const std::uint8_t* salt,
+                                                    const KdfParams& kdf,
+                                                    const std::vector<std::uint8_t>& plaintext,
+                                                    CipherSuite suite = default_cipher_suite());
+  static std::vector<std::uint8_t> decrypt_with_key(const Secret& key,
+                                                    const std::vector<std::uint8_t>& ciphertext_blob);
 };
 
 }  // namespace pwledger
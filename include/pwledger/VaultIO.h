@@ -19,12 +19,14 @@
 #ifndef PWLEDGER_VAULTIO_H
 #define PWLEDGER_VAULTIO_H
 
+#include <pwledger/KeySlots.h>
 #include <pwledger/PrimaryTable.h>
 #include <pwledger/VaultCrypto.h>
 #include <pwledger/VaultSerializer.h>
 
 #include <filesystem>
 #include <fstream>
+#include <optional>
 #include <stdexcept>
 #include <string_view>
 #include <vector>
@@ -35,6 +37,15 @@ namespace pwledger {
 // VaultIO
 // ----------------------------------------------------------------------------
 // High-level integration of VaultSerializer, VaultCrypto, and file I/O.
+//
+// A file in the key-slot format (KeySlots.h) opens with any password one of
+// its password slots holds. Saving over one keeps its slot table and data
+// key and reseals only the payload, so `kdf` does not apply to it: each
+// password slot keeps the cost it was added with.
+//
+// Saving with the password unlocks a slot again, one Argon2id per password
+// slot tried. A session that saves more than once instead keeps the data
+// key the load handed back and saves with that: no Argon2id after unlock.
 
 class VaultIO {
 public:
@@ -42,11 +53,95 @@ public:
 
   // Atomically saves the table todisk.
   // Writes to a temporary file first, then renames it over the target.
-  static void save_vault(const std::filesystem::path& path, const PrimaryTable& table, std::string_view password);
+  // `suite` defaults to the fastest one this CPU runs (see CipherSuite).
+  // Over a key-slot file, `password` must open one of its slots.
+  static void save_vault(const std::filesystem::path& path,
+                         const PrimaryTable& table,
+                         std::string_view password,
+                         const KdfParams& kdf = {},
+                         CipherSuite suite = VaultCrypto::default_cipher_suite());
 
-  // Loads the vault from disk. Throws on decryption failure, format failure,
-  // or read errors.
-  static PrimaryTable load_vault(const std::filesystem::path& path, std::string_view password);
+  // As save_vault, for a payload already in VaultSerializer format (e.g.
+  // produced entry by entry with write_header / write_entry). `plaintext` is
+  // wiped and released before returning, including on failure.
+  static void save_serialized(const std::filesystem::path& path,
+                              std::vector<std::uint8_t>& plaintext,
+                              std::string_view password,
+                              const KdfParams& kdf = {},
+                              CipherSuite suite = VaultCrypto::default_cipher_suite());
+
+  // As load_vault, stopping short of deserializing: the decrypted payload,
+  // which the caller wipes (kernels::secure_zero) when done with it.
+  static std::vector<std::uint8_t> load_serialized(const std::filesystem::path& path,
+                                                   std::string_view password,
+                                                   const KdfParams& kdf = {});
+
+  // The KDF parameters recorded in the vault's header, read without the
+  // password; nullopt for a vault saved before they were recorded (its next
+  // save records them). For a key-slot file, those of its first password
+  // slot, or nullopt if it has none. Throws on read errors or a malformed
+  // header.
+  static std::optional<KdfParams> stored_kdf_params(const std::filesystem::path& path);
+
+  // Loads the vault from disk, whichever suite it was saved with, using the
+  // KDF parameters in its header (`kdf` only for vaults without them).
+  // Throws on decryption failure, format failure, or read errors.
+  static PrimaryTable load_vault(const std::filesystem::path& path,
+                                 std::string_view password,
+                                 const KdfParams& kdf = {});
+
+  // Key-slot files only: loads, or saves over, the vault with the key pair
+  // one of its public-key slots was added for, with no Argon2id. Throw as
+  // the password overloads, and if the file is not in the key-slot format.
+  static PrimaryTable load_vault(const std::filesystem::path& path, const X25519KeyPair& identity);
+  static void save_vault(const std::filesystem::path& path,
+                         const PrimaryTable& table,
+                         const X25519KeyPair& identity,
+                         CipherSuite suite = VaultCrypto::default_cipher_suite());
+
+  // As load_vault, also handing back the data key in `data_key`: set for a
+  // key-slot file, reset for a single-password one.
+  static PrimaryTable load_vault(const std::filesystem::path& path,
+                                 std::string_view password,
+                                 std::optional<Secret>& data_key,
+                                 const KdfParams& kdf = {});
+  static PrimaryTable load_vault(const std::filesystem::path& path,
+                                 const X25519KeyPair& identity,
+                                 std::optional<Secret>& data_key);
+
+  // Key-slot files only: saves over the vault with a data key one of the
+  // loads above handed back, keeping the slot table. No Argon2id; one AEAD
+  // pass checks the key still opens the file. Throws as the password
+  // overloads, and if the file is not in the key-slot format or was
+  // replaced by one with another data key.
+  static void save_vault(const std::filesystem::path& path,
+                         const PrimaryTable& table,
+                         const Secret& data_key,
+                         CipherSuite suite = VaultCrypto::default_cipher_suite());
+  static void save_serialized(const std::filesystem::path& path,
+                              std::vector<std::uint8_t>& plaintext,
+                              const Secret& data_key,
+                              CipherSuite suite = VaultCrypto::default_cipher_suite());
+
+  // Whether the file at `path` is in the key-slot format (only its first
+  // bytes are read). False if it does not exist.
+  static bool uses_key_slots(const std::filesystem::path& path);
+
+  // The slot table and sealed payload of a key-slot file, read without any
+  // credential; and the atomic write of one, after adding or removing
+  // slots. Changing slots never touches the payload. Throw on read or
+  // write errors and on a file that is not in the key-slot format.
+  static SlottedVault read_slotted(const std::filesystem::path& path);
+  static void write_slotted(const std::filesystem::path& path, const SlottedVault& vault);
+
+  // Converts a single-password vault to the key-slot format: a fresh data
+  // key, the same entries, and one password slot named `label` for
+  // `password` with the file's KDF parameters, written atomically. Returns
+  // the data key, so the caller can add slots to read_slotted(path) without
+  // unlocking it again.
+  // Throws if `password` does not open the vault or it already uses slots.
+  static Secret convert_to_slotted(const std::filesystem::path& path, std::string_view password,
+                                   const std::string& label);
 };
 
 }  // namespace pwledger
@@ -0,0 +1,115 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PWLEDGER_VAULTIMPORT_H
+#define PWLEDGER_VAULTIMPORT_H
+
+#include <pwledger/PrimaryTable.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <iosfwd>
+#include <optional>
+#include <string_view>
+
+// ============================================================================
+// DESIGN NOTES
+// ============================================================================
+//
+// Bulk import of exports from other password managers:
+//
+//   csv             RFC 4180 CSV with a header row (Chrome, Firefox, Bitwarden
+//                   and 1Password CSV exports, KeePassXC CSV)
+//   bitwarden-json  Bitwarden's unencrypted JSON export
+//   keepass-xml     KeePass 2 XML export
+//
+// STREAMING
+// ---------
+// All three are parsed in one pass over the input, SAX-style: the CSV and
+// XML tokenizers are hand-written state machines, the JSON goes through
+// nlohmann::json::sax_parse. Nothing builds a document tree, so memory use
+// is bounded by ImportOptions::batch_size, not by the size of the export.
+//
+// SECRETS
+// -------
+// Password bytes are written by the tokenizer straight into a slot of a
+// locked Secret arena (batch_size slots of 256 bytes), never into a
+// std::string. Copies outside Secret memory: the 64 KiB read buffer, wiped
+// on every refill and on return, and, for JSON only, the lexer's string
+// buffer (wiped as soon as the value has been copied) and its record of the
+// current token for error messages (overwritten by the next token).
+// import_file opens the file unbuffered so the stream keeps no copy.
+// Columns and fields other than title, username, URL and password (notes,
+// TOTP seeds, custom fields) are skipped without being stored; SecretEntry
+// has no sensitive field to put them in.
+//
+// BATCHES
+// -------
+// When the arena is full, its records become SecretEntry objects on
+// ThreadPool::shared() (one sodium_malloc'd secret and salt each, which is
+// where the time goes), the arena is wiped, and the entries are inserted in
+// input order under fresh time-ordered UUIDs.
+//
+// MAPPING
+// -------
+// The primary key is the record's title, else its URL, else its username.
+// Records with none of these and no password are skipped, as are Bitwarden
+// items that are not logins. Passwords over 255 bytes (kMaxSecretBytes less the
+// terminating NUL) are not truncated: the record is skipped and counted.
+//
+// ============================================================================
+
+namespace pwledger {
+
+enum class ImportFormat { kCsv, kBitwardenJson, kKeePassXml };
+
+// "csv", "bitwarden-json", "keepass-xml".
+[[nodiscard]] std::string_view import_format_name(ImportFormat format) noexcept;
+
+// Parses one of the names above.
+[[nodiscard]] std::optional<ImportFormat> parse_import_format(std::string_view name) noexcept;
+
+// Guesses the format from a file extension (.csv, .json, .xml).
+[[nodiscard]] std::optional<ImportFormat> guess_import_format(const std::filesystem::path& path);
+
+struct ImportOptions {
+  std::size_t batch_size = 1024;  // records per Secret arena and per parallel batch
+};
+
+struct ImportResult {
+  std::size_t imported = 0;
+  std::size_t skipped = 0;   // empty records and non-login items
+  std::size_t too_long = 0;  // passwords over 255 bytes
+};
+
+// Reads an export from `in` and inserts its entries into `out`. Throws
+// std::runtime_error, naming the line (CSV, XML) or byte offset (JSON), on
+// malformed input; `out` then holds the entries of the batches inserted so
+// far, so callers import into a staging table and merge it on success.
+ImportResult import_entries(std::istream& in, ImportFormat format, PrimaryTable& out, const ImportOptions& options = {});
+
+// import_entries on a file, opened unbuffered. Throws std::runtime_error if
+// it cannot be opened.
+ImportResult import_file(const std::filesystem::path& path,
+                         ImportFormat format,
+                         PrimaryTable& out,
+                         const ImportOptions& options = {});
+
+}  // namespace pwledger
+
+#endif  // PWLEDGER_VAULTIMPORT_H
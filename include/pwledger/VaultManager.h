@@ -0,0 +1,178 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PWLEDGER_VAULT_MANAGER_H
+#define PWLEDGER_VAULT_MANAGER_H
+
+#include <pwledger/PrimaryTable.h>
+#include <pwledger/Secret.h>
+#include <pwledger/SecretEntry.h>
+#include <pwledger/VaultCrypto.h>
+#include <pwledger/uuid.h>
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ============================================================================
+// DESIGN NOTES
+// ============================================================================
+//
+// VaultManager holds several named vaults (personal, team, a service
+// account...) side by side. Each is its own file with its own master
+// password, KDF parameters and lock state; locking one leaves the others
+// open, and saving one rewrites only its file.
+//
+// PARALLEL UNLOCK
+// ---------------
+// Opening a vault is read, Argon2id, AEAD decrypt, parse - all of it
+// VaultIO::load_vault, and nearly all of it the key derivation, which runs
+// on one core for a one-lane vault. unlock() takes every password first
+// and then opens the vaults on the thread pool, one task per vault, so
+// three vaults take about as long as the slowest of them rather than the
+// sum. A multi-lane vault's own Argon2id lanes go to the same pool; its
+// parallel_for is safe to nest (see ThreadPool.h), it just shares the cores.
+//
+// The derivations run at the same time, so their memory adds up: three
+// vaults at 256 MiB each need 768 MiB at once for the duration of the
+// unlock.
+//
+// One vault failing (wrong password, corrupt file) does not stop the
+// others: unlock() reports an Outcome per vault, and a vault whose unlock
+// failed stays locked. save_all() works the same way.
+//
+// ACROSS VAULTS
+// -------------
+// entries() and search() walk every unlocked vault in the order the vaults
+// were added; each result names the vault it came from. search() matches
+// like the native host's `search`: an ASCII case-insensitive substring of
+// the primary key or the username/email.
+//
+// THREAD SAFETY: none between calls. unlock() and save_all() use threads
+// internally, each touching only its own vault.
+//
+// ============================================================================
+
+namespace pwledger {
+
+class ThreadPool;
+struct VaultConfig;
+
+class VaultManager {
+public:
+  struct Vault {
+    std::string name;
+    std::filesystem::path path;
+    PrimaryTable table;              // empty while locked
+    Secret password{1};              // the master password while unlocked (NUL-padded)
+    std::optional<Secret> data_key;  // a key-slot vault's, while unlocked: what saves reseal with
+    KdfParams kdf;                   // what the next save records
+    bool unlocked = false;
+  };
+
+  // What happened to one vault in unlock() or save_all().
+  struct Outcome {
+    std::string name;
+    std::string error;  // empty on success
+    std::chrono::nanoseconds elapsed{0};
+
+    [[nodiscard]] bool ok() const noexcept { return error.empty(); }
+  };
+
+  struct UnlockRequest {
+    std::string name;
+    Secret password;  // as read from the user: NUL-terminated or filling the buffer
+  };
+
+  // One entry of one vault, as returned by entries() and search(). Valid
+  // until that vault is locked or its table changes.
+  struct EntryRef {
+    const Vault* vault;
+    const Uuid* uuid;
+    const SecretEntry* entry;
+  };
+
+  // `pool` runs the unlocks and saves; ThreadPool::shared() by default or
+  // when nullptr.
+  VaultManager();
+  explicit VaultManager(ThreadPool* pool);
+  ~VaultManager();
+
+  VaultManager(VaultManager&&) noexcept;
+  VaultManager& operator=(VaultManager&&) noexcept;
+
+  // Registers every vault of VaultConfig::vaults, locked.
+  static VaultManager from_config(const VaultConfig& config, ThreadPool* pool = nullptr);
+
+  // Registers a locked vault. Throws std::invalid_argument if the name is
+  // empty or already taken.
+  Vault& add(std::string name, std::filesystem::path path);
+
+  // Locks and forgets a vault. Returns false if there is none by that name.
+  bool remove(std::string_view name);
+
+  [[nodiscard]] Vault* find(std::string_view name) noexcept;
+  [[nodiscard]] const Vault* find(std::string_view name) const noexcept;
+
+  // Every vault in the order added.
+  [[nodiscard]] std::vector<const Vault*> vaults() const;
+  [[nodiscard]] std::size_t size() const noexcept { return vaults_.size(); }
+
+  // Opens the named vaults concurrently (see DESIGN NOTES). A successful
+  // request's password is kept by its vault; the others are wiped. Returns
+  // one Outcome per request, in request order: unknown names, names given
+  // twice and vaults already unlocked fail without being opened.
+  std::vector<Outcome> unlock(std::vector<UnlockRequest> requests);
+
+  // Starts a vault whose file does not exist yet: it is unlocked empty with
+  // `password` and saved once. Throws std::runtime_error if the file exists
+  // and whatever saving throws.
+  void create(std::string_view name, Secret password, const KdfParams& kdf = {});
+
+  // Drops a vault's entries and password. Returns false if it was not
+  // unlocked. Unsaved changes are lost: save first.
+  bool lock(std::string_view name);
+  void lock_all();
+
+  // Saves one unlocked vault. Throws std::invalid_argument for an unknown
+  // or locked vault, and whatever VaultIO::save_vault throws.
+  void save(std::string_view name) const;
+
+  // Saves every unlocked vault concurrently; one Outcome per vault saved.
+  std::vector<Outcome> save_all() const;
+
+  // Entries of every unlocked vault, and those matching `query` (all of
+  // them for an empty query).
+  [[nodiscard]] std::vector<EntryRef> entries() const;
+  [[nodiscard]] std::vector<EntryRef> search(std::string_view query) const;
+
+private:
+  [[nodiscard]] ThreadPool& pool() const;
+
+  ThreadPool* pool_;
+  std::vector<std::unique_ptr<Vault>> vaults_;  // stable addresses for EntryRef
+};
+
+}  // namespace pwledger
+
+#endif  // PWLEDGER_VAULT_MANAGER_H
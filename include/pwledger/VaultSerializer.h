@@ -69,6 +69,13 @@ public:
   // sodium_memzero or wrapped in a Secret as soon as encryption completes.
   static std::vector<std::uint8_t> serialize(const PrimaryTable& table);
 
+  // Streaming building blocks of serialize(): a header announcing
+  // `num_entries`, followed by exactly that many write_entry calls. Lets a
+  // producer emit entries one at a time without materializing a PrimaryTable
+  // (see apps/gen).
+  static void write_header(std::vector<std::uint8_t>& out, std::uint64_t num_entries);
+  static void write_entry(std::vector<std::uint8_t>& out, const Uuid& uuid, const SecretEntry& entry);
+
   // Deserializes a buffer back into a PrimaryTable. Throws std::runtime_error
   // on format violations. The input pointer must be valid for `size` bytes.
   static PrimaryTable deserialize(const std::uint8_t* data, std::size_t size);
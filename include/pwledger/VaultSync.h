@@ -0,0 +1,201 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PWLEDGER_VAULT_SYNC_H
+#define PWLEDGER_VAULT_SYNC_H
+
+#include <pwledger/MerkleTree.h>
+#include <pwledger/PrimaryTable.h>
+#include <pwledger/SecretEntry.h>
+#include <pwledger/Transaction.h>
+#include <pwledger/VaultCrypto.h>
+#include <pwledger/uuid.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ============================================================================
+// DESIGN NOTES
+// ============================================================================
+//
+// Offline sync between copies of a vault on different machines, through
+// files carried by hand or a shared folder. Only what changed travels.
+//
+//   machine A                             machine B
+//   ---------                             ---------
+//   make_delta(A, peer[B])  -- file -->   apply_delta(B, peer[A], delta)
+//   apply_delta(A, peer[B], delta)  <--   make_delta(B, peer[A])
+//
+// Each side keeps a SyncPeerState per peer. Its base is a MerkleTree of
+// what the peer is known to hold. A delta holds the entries whose hashes
+// differ from the base (MerkleTree::diff, so O(changes log n)). Each item
+// carries the hash the sender believed the peer had: the merge base for
+// that entry.
+//
+// THREE-WAY MERGE
+// ---------------
+// apply_delta() decides each item from three hashes: local (L), the item's
+// base (B) and remote (R). Entries outside the delta are the receiver's
+// own business and are left alone.
+//
+//   L == R                 nothing to do
+//   L == B                 only the sender changed it: take R (add, update
+//                          or remove)
+//   otherwise              both changed it: a conflict, resolved so that
+//                          both machines pick the same side
+//     both kept it         the later last_modified_at wins, then the later
+//                          last_used_at, then the larger hash
+//     one side removed it  the surviving version is kept: no edit is lost
+//                          to a deletion
+//
+// A conflict between versions that differ only in last_used_at (the
+// same entry copied on both machines) is resolved silently. Every other
+// conflict is reported. A delta that lists a UUID twice is malformed and
+// is refused.
+//
+// The merge can be staged in a Transaction instead of applied: committing
+// it with the save lands it only if the save succeeds, so a session never
+// holds merged entries its file lacks.
+//
+// BASES AND ACKNOWLEDGEMENTS
+// --------------------------
+// A base only learns what a peer said it holds, so it never over-estimates:
+// a delta that is lost or never imported costs nothing but a resend. Every
+// item records R in the receiver's base. The sender learns the outcome
+// from an acknowledgement in the receiver's next delta: for each UUID it
+// imported since, the hash it holds when exporting (nullopt if none).
+// Without acknowledgements an entry would travel again on every sync,
+// since nothing else tells its sender that it arrived. Items already in
+// the reply need none. A missing state is an empty one: the first sync
+// sends everything.
+//
+// FILES
+// -----
+// Deltas and peer states hold secrets, or hashes of them, so both are
+// sealed with VaultCrypto like a vault (VaultIO::save_serialized), under a
+// password the caller chooses. A delta's plaintext is
+//
+//   [ "PWLD" ] [ version (1) = 1 ] [ item count (u64 LE) ]
+//   item count times: [ UUID (16) ] [ flags (1) ] [ base hash (32) if flag 1 ]
+//   [ ack count (u64 LE) ]
+//   ack count times:  [ UUID (16) ] [ flags (1) ] [ held hash (32) if flag 1 ]
+//   a VaultSerializer payload with the items that carry an entry (flag 2)
+//
+// and a state's is
+//
+//   [ "PWLS" ] [ version (1) = 1 ] [ base size (u64 LE) ] [ serialized base ]
+//   [ unacknowledged count (u64 LE) ] [ UUID (16) ] for each
+//
+// THREAD SAFETY: none.
+//
+// ============================================================================
+
+namespace pwledger {
+
+// The changes one side sends the other.
+struct SyncDelta {
+  struct Item {
+    Uuid uuid;
+    std::optional<MerkleTree::Hash> base;  // what the peer was known to hold; nullopt if nothing
+    std::optional<SecretEntry> entry;      // the sender's version; nullopt if removed
+  };
+  struct Ack {
+    Uuid uuid;
+    std::optional<MerkleTree::Hash> held;  // what the sender holds; nullopt if nothing
+  };
+  std::vector<Item> items;
+  std::vector<Ack> acks;
+};
+
+// What one side keeps about a peer between syncs.
+struct SyncPeerState {
+  MerkleTree base;            // what the peer is known to hold
+  std::vector<Uuid> unacked;  // imported from the peer since the last export to it
+};
+
+struct SyncConflict {
+  enum class Kind : std::uint8_t {
+    kBothChanged,
+    kChangedHereRemovedThere,
+    kRemovedHereChangedThere,
+  };
+
+  Uuid uuid;
+  Kind kind = Kind::kBothChanged;
+  bool kept_local = true;   // whose version the vault holds now
+  std::string primary_key;  // of the version kept
+};
+
+struct SyncReport {
+  std::size_t added = 0;
+  std::size_t updated = 0;
+  std::size_t removed = 0;
+  std::size_t unchanged = 0;  // the receiver already had the sender's version
+  std::vector<SyncConflict> conflicts;
+};
+
+class VaultSync {
+public:
+  // The items of `table` that differ from `peer.base`, and the
+  // acknowledgements `peer` is owed, which are then cleared. `current` must
+  // describe `table` (MerkleTree::of, or kept in step since).
+  static SyncDelta make_delta(const PrimaryTable& table, const MerkleTree& current, SyncPeerState& peer);
+
+  // Merges `delta` into `table` (see DESIGN NOTES), keeping `current` in
+  // step with it and recording in `peer` what the sender holds.
+  // Throws std::runtime_error, `table` unchanged, if the delta lists a UUID
+  // twice.
+  static SyncReport apply_delta(PrimaryTable& table, MerkleTree& current, SyncPeerState& peer, SyncDelta delta);
+
+  // As above, but stages the changes in `tx`, a transaction open on `table`
+  // with nothing staged, and leaves `table` alone until it is committed.
+  // `current` and `peer` are updated at once, so drop them if the commit
+  // fails.
+  static SyncReport apply_delta(Transaction& tx,
+                                const PrimaryTable& table,
+                                MerkleTree& current,
+                                SyncPeerState& peer,
+                                SyncDelta delta);
+
+  // Where the state for `peer` lives: a directory beside the vault file.
+  // Throws std::invalid_argument unless `peer` is a plain file name.
+  static std::filesystem::path state_path(const std::filesystem::path& vault_path, std::string_view peer);
+
+  // Sealed files. read_state returns an empty state if there is no file.
+  // Throw as VaultIO::save_serialized and VaultIO::load_serialized, and
+  // std::runtime_error on a malformed payload.
+  static void write_delta(const std::filesystem::path& path,
+                          const SyncDelta& delta,
+                          std::string_view password,
+                          const KdfParams& kdf = {});
+  static SyncDelta read_delta(const std::filesystem::path& path, std::string_view password);
+  static void write_state(const std::filesystem::path& path,
+                          const SyncPeerState& state,
+                          std::string_view password,
+                          const KdfParams& kdf = {});
+  static SyncPeerState read_state(const std::filesystem::path& path, std::string_view password);
+};
+
+}  // namespace pwledger
+
+#endif  // PWLEDGER_VAULT_SYNC_H
@@ -23,7 +23,7 @@
 // DESIGN NOTES
 // ============================================================================
 //
-// Uuid represents a 128-bit UUID-v4 identifier stored as a raw byte array.
+// Uuid represents a 128-bit RFC 9562 identifier stored as a raw byte array.
 // This header is intentionally self-contained: it provides generation,
 // string parsing, string formatting, and hashing so that both the CLI and
 // native messaging host can use UUIDs without pulling in heavy dependencies.
@@ -33,15 +33,44 @@
 // The canonical string representation follows RFC 4122:
 //   xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx   (36 characters, lowercase hex)
 //
-// from_string() also accepts the 32-character compact form (no hyphens).
-// to_string() always produces the canonical 36-character form.
+// from_string() also accepts the 32-character compact form (no hyphens),
+// and either case of hex digit. to_string() always produces the canonical
+// 36-character lowercase form.
 //
-// SECURITY
-// --------
-// generate() uses std::random_device + std::mt19937_64, which is NOT
-// cryptographically secure. This is acceptable for table keys but must
-// not be used for nonces or key material. If cryptographic UUIDs are
-// needed, replace the PRNG with randombytes_buf() from libsodium.
+// to_chars() and from_chars() are the allocation-free primitives behind
+// both (and behind operator<<): they write into or read from a caller's
+// buffer, and encode/decode all 32 hex digits through the SIMD hex kernels
+// (see Kernels.h), which pick SSE4.2, AVX2 or NEON at run time.
+//
+// GENERATION (UUIDv7)
+// -------------------
+// generate() produces version-7 UUIDs (RFC 9562 §5.7):
+//
+//   48 bits  Unix time in milliseconds, big-endian
+//    4 bits  version (0111)
+//   12 bits  counter (rand_a)
+//    2 bits  variant (10)
+//   62 bits  random (rand_b)
+//
+// Byte order therefore equals creation order: operator< and memcmp sort
+// entries oldest first, new keys land at the end of any ordered index, and
+// a creation-time range is a key range (see timestamp_ms()).
+//
+// Within one millisecond, IDs are made strictly increasing by the 12-bit
+// counter (RFC 9562 §6.2, method 1). It starts each millisecond at a random
+// value below 2048, leaving at least 2048 increments before it overflows;
+// on overflow, or if the system clock steps backwards, the timestamp is
+// advanced past the last one issued instead of going back. Ordering is
+// guaranteed across threads of one process, not across processes.
+//
+// The random bits come from libsodium's CSPRNG (randombytes_buf), drawn in
+// batches into a pool so that a typical generate() is a mutex, a clock
+// read and a copy rather than a syscall. UUIDs remain identifiers, not
+// secrets: they are stored and transmitted in the clear and reveal their
+// creation time.
+//
+// Existing vaults keep their version-4 IDs; parsing, formatting and
+// hashing do not depend on the version.
 //
 // ============================================================================
 
@@ -49,11 +78,8 @@
 #include <cstdint>
 #include <cstring>
 #include <functional>
-#include <iomanip>
 #include <optional>
 #include <ostream>
-#include <random>
-#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -80,14 +106,37 @@ struct Uuid {
   // Generation
   // --------------------------------------------------------------------------
 
-  // Generates a version-4 (random) UUID per RFC 4122.
-  // NOT cryptographically secure — see DESIGN NOTES.
+  // Generates a time-ordered version-7 UUID. See GENERATION in the DESIGN
+  // NOTES. Thread-safe.
   static Uuid generate();
 
+  // Builds a version-7 UUID from its fields; the counter is masked to 12
+  // bits and rand_b to 62. Used by generate() and by tools that need
+  // reproducible IDs.
+  static Uuid from_v7_fields(std::uint64_t unix_ms, std::uint16_t counter, std::uint64_t rand_b) noexcept;
+
+  // The version nibble (4 for random IDs, 7 for time-ordered ones).
+  int version() const noexcept { return bytes[6] >> 4; }
+
+  // Creation time in Unix milliseconds for a version-7 UUID; std::nullopt
+  // for any other version.
+  std::optional<std::uint64_t> timestamp_ms() const noexcept;
+
   // --------------------------------------------------------------------------
   // String conversion
   // --------------------------------------------------------------------------
 
+  static constexpr std::size_t kStringLength = 36;
+  static constexpr std::size_t kCompactLength = 32;
+
+  // Writes the canonical form into out[0, kStringLength), without a
+  // terminator, and returns out + kStringLength.
+  char* to_chars(char* out) const noexcept;
+
+  // Parses the canonical or compact form. Hyphens are only accepted at the
+  // canonical positions. Returns std::nullopt on malformed input.
+  static std::optional<Uuid> from_chars(std::string_view str) noexcept;
+
   // Formats as the canonical RFC 4122 representation:
   //   xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx
   std::string to_string() const;
@@ -106,16 +155,14 @@ struct Uuid {
 
   bool operator!=(const Uuid& other) const noexcept { return bytes != other.bytes; }
 
+  // Byte-wise order; for version-7 UUIDs this is creation order.
+  bool operator<(const Uuid& other) const noexcept { return bytes < other.bytes; }
+
   // --------------------------------------------------------------------------
   // Stream output
   // --------------------------------------------------------------------------
 
   friend std::ostream& operator<<(std::ostream& os, const Uuid& uuid);
-
-private:
-  static bool is_hex_digit(char c) noexcept;
-
-  static int hex_value(char c) noexcept;
 };
 
 }  // namespace pwledger
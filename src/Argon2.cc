@@ -0,0 +1,315 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pwledger/Argon2.h>
+
+#include <pwledger/Kernels.h>
+#include <pwledger/ThreadPool.h>
+#include <pwledger/Trace.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+#include <sodium.h>
+
+namespace pwledger {
+
+namespace {
+
+using kernels::kArgon2BlockWords;
+
+constexpr std::uint32_t kVersion = 0x13;
+constexpr std::uint32_t kTypeArgon2id = 2;
+constexpr std::uint32_t kSyncPoints = 4;
+constexpr std::size_t kBlockBytes = kArgon2BlockWords * 8;
+constexpr std::size_t kPrehashBytes = 64;
+
+struct alignas(64) Block {
+  std::uint64_t v[kArgon2BlockWords];
+};
+
+void store32(std::uint8_t* p, std::uint32_t v) noexcept {
+  for (int i = 0; i < 4; ++i) {
+    p[i] = static_cast<std::uint8_t>(v >> (8 * i));
+  }
+}
+
+void load_block(Block& b, const std::uint8_t* bytes) noexcept {
+  for (std::size_t i = 0; i < kArgon2BlockWords; ++i) {
+    std::uint64_t w = 0;
+    for (int k = 7; k >= 0; --k) {
+      w = (w << 8) | bytes[8 * i + static_cast<std::size_t>(k)];
+    }
+    b.v[i] = w;
+  }
+}
+
+void store_block(std::uint8_t* bytes, const Block& b) noexcept {
+  for (std::size_t i = 0; i < kArgon2BlockWords; ++i) {
+    for (std::size_t k = 0; k < 8; ++k) {
+      bytes[8 * i + k] = static_cast<std::uint8_t>(b.v[i] >> (8 * k));
+    }
+  }
+}
+
+void hash_update(crypto_generichash_state& st, const std::uint8_t* p, std::size_t n) {
+  crypto_generichash_update(&st, p, n);
+}
+
+void hash_update32(crypto_generichash_state& st, std::uint32_t v) {
+  std::uint8_t le[4];
+  store32(le, v);
+  hash_update(st, le, sizeof(le));
+}
+
+// H' (RFC 9106 section 3.3): BLAKE2b stretched to any output length.
+void blake2b_long(std::uint8_t* out, std::size_t outlen, const std::uint8_t* in, std::size_t inlen) {
+  crypto_generichash_state st;
+  if (outlen <= 64) {
+    crypto_generichash_init(&st, nullptr, 0, outlen);
+    hash_update32(st, static_cast<std::uint32_t>(outlen));
+    hash_update(st, in, inlen);
+    crypto_generichash_final(&st, out, outlen);
+    return;
+  }
+  std::uint8_t v[64];
+  std::uint8_t next[64];
+  crypto_generichash_init(&st, nullptr, 0, sizeof(v));
+  hash_update32(st, static_cast<std::uint32_t>(outlen));
+  hash_update(st, in, inlen);
+  crypto_generichash_final(&st, v, sizeof(v));
+  std::memcpy(out, v, 32);
+  out += 32;
+  std::size_t remaining = outlen - 32;
+  while (remaining > 64) {
+    crypto_generichash(next, sizeof(next), v, sizeof(v), nullptr, 0);
+    std::memcpy(v, next, sizeof(v));
+    std::memcpy(out, v, 32);
+    out += 32;
+    remaining -= 32;
+  }
+  crypto_generichash(out, remaining, v, sizeof(v), nullptr, 0);
+  sodium_memzero(v, sizeof(v));
+  sodium_memzero(next, sizeof(next));
+}
+
+struct Instance {
+  Block* memory = nullptr;
+  std::uint32_t passes = 0;
+  std::uint32_t lanes = 0;
+  std::uint32_t memory_blocks = 0;  // m'
+  std::uint32_t lane_length = 0;    // q = m' / p
+  std::uint32_t segment_length = 0;
+  const kernels::KernelSet* k = nullptr;
+};
+
+// Position of the reference block within its lane (RFC 9106 section 3.4.1.2).
+std::uint32_t index_alpha(const Instance& in, std::uint32_t pass, std::uint32_t slice, std::uint32_t index,
+                          std::uint32_t j1, bool same_lane) noexcept {
+  std::uint64_t area = 0;
+  if (pass == 0) {
+    if (slice == 0) {
+      area = index - 1;
+    } else if (same_lane) {
+      area = std::uint64_t{slice} * in.segment_length + index - 1;
+    } else {
+      area = std::uint64_t{slice} * in.segment_length - (index == 0 ? 1 : 0);
+    }
+  } else if (same_lane) {
+    area = in.lane_length - in.segment_length + index - 1;
+  } else {
+    area = in.lane_length - in.segment_length - (index == 0 ? 1 : 0);
+  }
+
+  std::uint64_t x = (std::uint64_t{j1} * j1) >> 32;
+  x = area - 1 - ((area * x) >> 32);
+  const std::uint64_t start =
+      (pass != 0 && slice != kSyncPoints - 1) ? std::uint64_t{slice + 1} * in.segment_length : 0;
+  return static_cast<std::uint32_t>((start + x) % in.lane_length);
+}
+
+void fill_segment(const Instance& in, std::uint32_t pass, std::uint32_t lane, std::uint32_t slice) noexcept {
+  // Argon2id: the first half of the first pass uses data-independent
+  // addresses (as Argon2i), everything after data-dependent ones.
+  const bool independent = pass == 0 && slice < kSyncPoints / 2;
+  const auto fill = in.k->argon2_fill;
+
+  Block zero{};
+  Block input{};
+  Block address{};
+  const auto next_addresses = [&] {
+    ++input.v[6];
+    fill(zero.v, input.v, address.v, false);
+    fill(zero.v, address.v, address.v, false);
+  };
+  if (independent) {
+    input.v[0] = pass;
+    input.v[1] = lane;
+    input.v[2] = slice;
+    input.v[3] = in.memory_blocks;
+    input.v[4] = in.passes;
+    input.v[5] = kTypeArgon2id;
+  }
+
+  std::uint32_t start = 0;
+  if (pass == 0 && slice == 0) {
+    start = 2;  // the first two blocks of each lane come from H0
+    if (independent) {
+      next_addresses();
+    }
+  }
+
+  Block* const row = in.memory + std::size_t{lane} * in.lane_length;
+  for (std::uint32_t i = start; i < in.segment_length; ++i) {
+    const std::uint32_t col = slice * in.segment_length + i;
+    const Block& prev = row[col == 0 ? in.lane_length - 1 : col - 1];
+
+    std::uint64_t pseudo_rand = 0;
+    if (independent) {
+      if (i % kArgon2BlockWords == 0) {
+        next_addresses();
+      }
+      pseudo_rand = address.v[i % kArgon2BlockWords];
+    } else {
+      pseudo_rand = prev.v[0];
+    }
+
+    std::uint32_t ref_lane = static_cast<std::uint32_t>((pseudo_rand >> 32) % in.lanes);
+    if (pass == 0 && slice == 0) {
+      ref_lane = lane;
+    }
+    const std::uint32_t ref_index =
+        index_alpha(in, pass, slice, i, static_cast<std::uint32_t>(pseudo_rand), ref_lane == lane);
+    const Block& ref = in.memory[std::size_t{ref_lane} * in.lane_length + ref_index];
+
+    // Version 1.3 XORs later passes into the block they overwrite.
+    fill(prev.v, ref.v, row[col].v, pass != 0);
+  }
+}
+
+// Runs every (pass, slice) step on up to `threads` threads. The segments of
+// one slice are independent; the end of each parallel_for is the
+// synchronisation point before the next slice.
+void fill_memory(const Instance& in, std::uint32_t threads) {
+  for (std::uint32_t pass = 0; pass < in.passes; ++pass) {
+    for (std::uint32_t slice = 0; slice < kSyncPoints; ++slice) {
+      if (threads == 1) {
+        for (std::uint32_t lane = 0; lane < in.lanes; ++lane) {
+          fill_segment(in, pass, lane, slice);
+        }
+      } else {
+        ThreadPool::shared().parallel_for(
+            0, in.lanes,
+            [&](std::size_t lane) { fill_segment(in, pass, static_cast<std::uint32_t>(lane), slice); }, 1,
+            threads);
+      }
+    }
+  }
+}
+
+}  // anonymous namespace
+
+void argon2id(std::span<std::uint8_t> out,
+              std::span<const std::uint8_t> password,
+              std::span<const std::uint8_t> salt,
+              const Argon2idParams& params,
+              std::span<const std::uint8_t> secret,
+              std::span<const std::uint8_t> associated_data) {
+  trace::Span span("argon2id");
+  span.arg("passes", params.passes);
+  span.arg("memory_kib", params.memory_kib);
+  span.arg("lanes", params.lanes);
+
+  constexpr std::uint32_t kMaxLanes = 0xFFFFFF;
+  if (out.size() < 4 || out.size() > UINT32_MAX || salt.size() < 8 || params.passes < 1 || params.lanes < 1 ||
+      params.lanes > kMaxLanes || params.memory_kib < 8 * params.lanes) {
+    throw std::invalid_argument("Invalid Argon2id parameters");
+  }
+
+  Instance in;
+  in.passes = params.passes;
+  in.lanes = params.lanes;
+  in.segment_length = params.memory_kib / (params.lanes * kSyncPoints);
+  in.lane_length = in.segment_length * kSyncPoints;
+  in.memory_blocks = in.lane_length * params.lanes;
+  in.k = &kernels::active();
+
+  // H0 (RFC 9106 section 3.2).
+  std::uint8_t seed[kPrehashBytes + 8];
+  {
+    crypto_generichash_state st;
+    crypto_generichash_init(&st, nullptr, 0, kPrehashBytes);
+    hash_update32(st, params.lanes);
+    hash_update32(st, static_cast<std::uint32_t>(out.size()));
+    hash_update32(st, params.memory_kib);
+    hash_update32(st, params.passes);
+    hash_update32(st, kVersion);
+    hash_update32(st, kTypeArgon2id);
+    for (const auto field : {password, salt, secret, associated_data}) {
+      hash_update32(st, static_cast<std::uint32_t>(field.size()));
+      hash_update(st, field.data(), field.size());
+    }
+    crypto_generichash_final(&st, seed, kPrehashBytes);
+  }
+
+  const std::size_t blocks = in.memory_blocks;
+  std::unique_ptr<Block[]> memory(new Block[blocks]);
+  in.memory = memory.get();
+  const auto wipe = [&] {
+    kernels::secure_zero(memory.get(), blocks * sizeof(Block));
+    sodium_memzero(seed, sizeof(seed));
+  };
+
+  // The first two blocks of each lane: H'(H0 || LE32(0 or 1) || LE32(lane)).
+  std::uint8_t block_bytes[kBlockBytes];
+  for (std::uint32_t lane = 0; lane < in.lanes; ++lane) {
+    for (std::uint32_t k = 0; k < 2; ++k) {
+      store32(seed + kPrehashBytes, k);
+      store32(seed + kPrehashBytes + 4, lane);
+      blake2b_long(block_bytes, sizeof(block_bytes), seed, sizeof(seed));
+      load_block(in.memory[std::size_t{lane} * in.lane_length + k], block_bytes);
+    }
+  }
+
+  const std::uint32_t threads = std::min(in.lanes, params.threads != 0 ? params.threads : in.lanes);
+  try {
+    fill_memory(in, threads);
+  } catch (...) {
+    wipe();
+    throw;
+  }
+
+  // Tag: H' of the XOR of every lane's last block.
+  Block final = in.memory[in.lane_length - 1];
+  for (std::uint32_t lane = 1; lane < in.lanes; ++lane) {
+    const Block& last = in.memory[std::size_t{lane} * in.lane_length + in.lane_length - 1];
+    for (std::size_t i = 0; i < kArgon2BlockWords; ++i) {
+      final.v[i] ^= last.v[i];
+    }
+  }
+  store_block(block_bytes, final);
+  blake2b_long(out.data(), out.size(), block_bytes, sizeof(block_bytes));
+
+  sodium_memzero(&final, sizeof(final));
+  sodium_memzero(block_bytes, sizeof(block_bytes));
+  wipe();
+}
+
+}  // namespace pwledger
@@ -0,0 +1,358 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pwledger/CompletionIndex.h>
+
+#include <algorithm>
+#include <unordered_set>
+#include <utility>
+
+namespace pwledger {
+
+namespace {
+
+// Linear duplicate checks beat hashing for a screenful of candidates.
+constexpr std::size_t kLinearDedupLimit = 64;
+
+}  // namespace
+
+CompletionIndex::CompletionIndex() : nodes_(1) {}
+
+CompletionIndex::CompletionIndex(const PrimaryTable& table) : CompletionIndex() {
+  // Two keys per entry need about three nodes (a leaf each, a split on
+  // average for one of them).
+  nodes_.reserve(table.size() * 3 + 1);
+  for (const auto& [uuid, entry] : table) {
+    insert(uuid, entry);
+  }
+}
+
+std::size_t CompletionIndex::size() const noexcept { return nodes_[kRoot].count; }
+
+void CompletionIndex::clear() {
+  nodes_.assign(1, Node{});
+  free_.clear();
+}
+
+// Folds `key` into key_ and resets path_ to the root; both are reused so
+// an update allocates only for what it adds to the trie.
+std::string_view CompletionIndex::start_walk(std::string_view key) {
+  key_.resize(key.size());
+  std::transform(key.begin(), key.end(), key_.begin(), fold_key_char);
+  path_.assign(1, kRoot);
+  return key_;
+}
+
+// ----------------------------------------------------------------------------
+// Node management
+// ----------------------------------------------------------------------------
+
+std::uint32_t CompletionIndex::allocate(std::string label) {
+  if (!free_.empty()) {
+    const std::uint32_t node = free_.back();
+    free_.pop_back();
+    nodes_[node].label = std::move(label);
+    return node;
+  }
+  nodes_.push_back(Node{std::move(label), {}, {}, 0});
+  return static_cast<std::uint32_t>(nodes_.size() - 1);
+}
+
+void CompletionIndex::release(std::uint32_t node) {
+  nodes_[node] = Node{};
+  free_.push_back(node);
+}
+
+const CompletionIndex::Child* CompletionIndex::find_child(std::uint32_t node, char first) const {
+  const auto& children = nodes_[node].children;
+  const auto it = std::lower_bound(children.begin(), children.end(), first,
+                                   [](const Child& child, char c) { return child.first < c; });
+  return it != children.end() && it->first == first ? &*it : nullptr;
+}
+
+// A node with no values and a single child is folded into it, so every
+// inner node but the root branches or ends a key.
+void CompletionIndex::merge_with_only_child(std::uint32_t node) {
+  const std::uint32_t child = nodes_[node].children.front().node;
+  Node& n = nodes_[node];
+  Node& c = nodes_[child];
+  n.label += c.label;
+  n.children = std::move(c.children);
+  n.values = std::move(c.values);
+  release(child);
+}
+
+// ----------------------------------------------------------------------------
+// insert / erase
+// ----------------------------------------------------------------------------
+
+void CompletionIndex::insert(const Uuid& uuid, const SecretEntry& entry) {
+  insert(entry.primary_key, uuid);
+  insert(entry.username_or_email, uuid);
+}
+
+void CompletionIndex::erase(const Uuid& uuid, const SecretEntry& entry) {
+  erase(entry.primary_key, uuid);
+  erase(entry.username_or_email, uuid);
+}
+
+void CompletionIndex::insert(std::string_view raw_key, const Uuid& uuid) {
+  if (raw_key.empty()) {
+    return;
+  }
+  std::string_view rest = start_walk(raw_key);
+  std::uint32_t node = kRoot;
+
+  while (!rest.empty()) {
+    const Child* child = find_child(node, rest.front());
+    if (child == nullptr) {
+      const std::uint32_t leaf = allocate(std::string(rest));
+      auto& children = nodes_[node].children;
+      const auto at = std::lower_bound(children.begin(), children.end(), rest.front(),
+                                       [](const Child& c, char first) { return c.first < first; });
+      children.insert(at, Child{rest.front(), leaf});
+      node = leaf;
+      path_.push_back(node);
+      break;
+    }
+
+    const std::uint32_t next = child->node;
+    const std::string_view label = nodes_[next].label;
+    const auto diverge = std::mismatch(label.begin(), label.end(), rest.begin(), rest.end()).first;
+    const auto common = static_cast<std::size_t>(diverge - label.begin());
+    if (common == label.size()) {
+      node = next;
+      path_.push_back(node);
+      rest.remove_prefix(common);
+      continue;
+    }
+
+    // The key leaves the edge part-way: split it. `mid` takes the shared
+    // part and the old child keeps the rest.
+    std::string shared(label.substr(0, common));
+    const std::uint32_t mid = allocate(std::move(shared));  // may reallocate nodes_
+    Node& old = nodes_[next];
+    old.label.erase(0, common);
+    nodes_[mid].children.push_back(Child{old.label.front(), next});
+    nodes_[mid].count = old.count;
+    for (Child& c : nodes_[node].children) {
+      if (c.node == next) {
+        c.node = mid;
+        break;
+      }
+    }
+    node = mid;
+    path_.push_back(node);
+    rest.remove_prefix(common);
+  }
+
+  auto& values = nodes_[node].values;
+  const auto it = std::lower_bound(values.begin(), values.end(), uuid);
+  if (it != values.end() && *it == uuid) {
+    return;  // both keys of an entry are equal; it is indexed once
+  }
+  values.insert(it, uuid);
+  for (const std::uint32_t n : path_) {
+    ++nodes_[n].count;
+  }
+}
+
+bool CompletionIndex::erase(std::string_view raw_key, const Uuid& uuid) {
+  if (raw_key.empty()) {
+    return false;
+  }
+  std::string_view rest = start_walk(raw_key);
+
+  while (!rest.empty()) {
+    const Child* child = find_child(path_.back(), rest.front());
+    if (child == nullptr || !rest.starts_with(nodes_[child->node].label)) {
+      return false;
+    }
+    rest.remove_prefix(nodes_[child->node].label.size());
+    path_.push_back(child->node);
+  }
+
+  const std::uint32_t node = path_.back();
+  auto& values = nodes_[node].values;
+  const auto it = std::lower_bound(values.begin(), values.end(), uuid);
+  if (it == values.end() || *it != uuid) {
+    return false;
+  }
+  values.erase(it);
+  for (const std::uint32_t n : path_) {
+    --nodes_[n].count;
+  }
+
+  // Restore compression: drop an empty leaf, then fold whichever of it or
+  // its parent is left with one child and no values.
+  if (node == kRoot || !nodes_[node].values.empty()) {
+    return true;
+  }
+  if (nodes_[node].children.size() == 1) {
+    merge_with_only_child(node);
+    return true;
+  }
+  if (!nodes_[node].children.empty()) {
+    return true;
+  }
+  const std::uint32_t parent = path_[path_.size() - 2];
+  auto& siblings = nodes_[parent].children;
+  siblings.erase(std::find_if(siblings.begin(), siblings.end(), [&](const Child& c) { return c.node == node; }));
+  release(node);
+  if (parent != kRoot && nodes_[parent].values.empty() && nodes_[parent].children.size() == 1) {
+    merge_with_only_child(parent);
+  }
+  return true;
+}
+
+// ============================================================================
+// Cursor
+// ============================================================================
+
+CompletionIndex::Cursor::Cursor(const CompletionIndex& index) : index_(&index) { path_.push_back({kRoot, 0}); }
+
+void CompletionIndex::Cursor::reset() {
+  path_.resize(1);
+  prefix_.clear();
+  dead_ = 0;
+}
+
+void CompletionIndex::Cursor::push(char c) {
+  c = fold_key_char(c);
+  prefix_.push_back(c);
+  if (dead_ != 0) {
+    ++dead_;
+    return;
+  }
+  const Position at = path_.back();
+  const Node& node = index_->nodes_[at.node];
+  if (at.offset < node.label.size()) {
+    if (node.label[at.offset] == c) {
+      path_.push_back({at.node, at.offset + 1});
+    } else {
+      ++dead_;
+    }
+    return;
+  }
+  const Child* child = index_->find_child(at.node, c);
+  if (child == nullptr) {
+    ++dead_;
+    return;
+  }
+  path_.push_back({child->node, 1});
+}
+
+void CompletionIndex::Cursor::push(std::string_view text) {
+  for (const char c : text) {
+    push(c);
+  }
+}
+
+void CompletionIndex::Cursor::pop() {
+  if (prefix_.empty()) {
+    return;
+  }
+  prefix_.pop_back();
+  if (dead_ != 0) {
+    --dead_;
+    return;
+  }
+  path_.pop_back();
+}
+
+std::size_t CompletionIndex::Cursor::count() const noexcept {
+  return dead_ != 0 ? 0 : index_->nodes_[path_.back().node].count;
+}
+
+std::string CompletionIndex::Cursor::completion() const {
+  if (dead_ != 0 || count() == 0) {
+    return {};
+  }
+  const Position at = path_.back();
+  const Node* node = &index_->nodes_[at.node];
+  std::string extension = node->label.substr(at.offset);
+  while (node->values.empty() && node->children.size() == 1) {
+    node = &index_->nodes_[node->children.front().node];
+    extension += node->label;
+  }
+  return extension;
+}
+
+std::vector<Uuid> CompletionIndex::Cursor::candidates(std::size_t limit) const {
+  std::vector<Uuid> out;
+  if (dead_ != 0 || limit == 0) {
+    return out;
+  }
+  std::unordered_set<Uuid> seen;
+  const auto first_time = [&](const Uuid& uuid) {
+    if (limit <= kLinearDedupLimit) {
+      return std::find(out.begin(), out.end(), uuid) == out.end();
+    }
+    return seen.insert(uuid).second;
+  };
+  std::vector<std::uint32_t> stack{path_.back().node};
+  while (!stack.empty() && out.size() < limit) {
+    const Node& node = index_->nodes_[stack.back()];
+    stack.pop_back();
+    for (const Uuid& uuid : node.values) {
+      if (first_time(uuid)) {
+        out.push_back(uuid);
+        if (out.size() == limit) {
+          break;
+        }
+      }
+    }
+    for (auto it = node.children.rbegin(); it != node.children.rend(); ++it) {
+      stack.push_back(it->node);
+    }
+  }
+  return out;
+}
+
+std::vector<Uuid> CompletionIndex::Cursor::exact() const {
+  const Position at = path_.back();
+  const Node& node = index_->nodes_[at.node];
+  if (dead_ != 0 || at.offset != node.label.size()) {
+    return {};
+  }
+  return node.values;
+}
+
+// ----------------------------------------------------------------------------
+// Convenience
+// ----------------------------------------------------------------------------
+
+std::size_t CompletionIndex::count(std::string_view prefix) const {
+  Cursor c(*this);
+  c.push(prefix);
+  return c.count();
+}
+
+std::string CompletionIndex::completion(std::string_view prefix) const {
+  Cursor c(*this);
+  c.push(prefix);
+  return c.completion();
+}
+
+std::vector<Uuid> CompletionIndex::candidates(std::string_view prefix, std::size_t limit) const {
+  Cursor c(*this);
+  c.push(prefix);
+  return c.candidates(limit);
+}
+
+}  // namespace pwledger
@@ -63,6 +63,7 @@ void to_json(json& j, const VaultConfig& v) {
       {"directory", v.directory},
       {"default_vault", v.default_vault},
       {"auto_unlock", v.auto_unlock},
+      {"vaults", v.vaults},
   };
 }
 
@@ -71,6 +72,11 @@ void from_json(const json& j, VaultConfig& v) {
   v.directory     = j.value("directory", defaults.directory);
   v.default_vault = j.value("default_vault", defaults.default_vault);
   v.auto_unlock   = j.value("auto_unlock", defaults.auto_unlock);
+  if (j.contains("vaults") && j["vaults"].is_object()) {
+    v.vaults = j["vaults"].get<std::map<std::string, std::string>>();
+  } else {
+    v.vaults = defaults.vaults;
+  }
 }
 
 // --- CliConfig --------------------------------------------------------------
@@ -109,6 +115,23 @@ void from_json(const json& j, IntegrationConfig& i) {
   }
 }
 
+// --- ThreadPoolConfig -------------------------------------------------------
+
+void to_json(json& j, const ThreadPoolConfig& t) {
+  j = json{
+      {"threads", t.threads},
+      {"drain_on_shutdown", t.drain_on_shutdown},
+      {"scrub_stack_kib", t.scrub_stack_kib},
+  };
+}
+
+void from_json(const json& j, ThreadPoolConfig& t) {
+  ThreadPoolConfig defaults;
+  t.threads           = j.value("threads", defaults.threads);
+  t.drain_on_shutdown = j.value("drain_on_shutdown", defaults.drain_on_shutdown);
+  t.scrub_stack_kib   = j.value("scrub_stack_kib", defaults.scrub_stack_kib);
+}
+
 // --- Config (top level) -----------------------------------------------------
 
 void to_json(json& j, const Config& cfg) {
@@ -117,6 +140,7 @@ void to_json(json& j, const Config& cfg) {
       {"vault", cfg.vault},
       {"cli", cfg.cli},
       {"integration", cfg.integration},
+      {"thread_pool", cfg.thread_pool},
   };
 }
 
@@ -142,6 +166,11 @@ void from_json(const json& j, Config& cfg) {
   } else {
     cfg.integration = defaults.integration;
   }
+  if (j.contains("thread_pool") && j["thread_pool"].is_object()) {
+    cfg.thread_pool = j["thread_pool"].get<ThreadPoolConfig>();
+  } else {
+    cfg.thread_pool = defaults.thread_pool;
+  }
 }
 
 // ============================================================================
@@ -243,6 +272,9 @@ Config load_config(const std::filesystem::path& path) {
   if (!cfg.vault.directory.empty()) {
     cfg.vault.directory = expand_tilde(cfg.vault.directory).string();
   }
+  for (auto& [name, file] : cfg.vault.vaults) {
+    file = expand_tilde(file).string();
+  }
 
   return cfg;
 }
@@ -0,0 +1,118 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pwledger/CpuFeatures.h>
+
+#include <cstddef>
+#include <iterator>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <cpuid.h>
+#define PWLEDGER_CPUID 1
+#endif
+
+namespace pwledger {
+
+namespace {
+
+#if defined(PWLEDGER_CPUID)
+// XCR0 bits the OS sets when it saves the corresponding register state on
+// context switch. Without them the instructions fault even if cpuid lists
+// them.
+constexpr std::uint64_t kXcr0Avx = 0x6;      // XMM | YMM
+constexpr std::uint64_t kXcr0Avx512 = 0xE6;  // XMM | YMM | opmask | ZMM
+
+std::uint64_t read_xcr0() noexcept {
+  std::uint32_t lo = 0;
+  std::uint32_t hi = 0;
+  __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+  return (std::uint64_t{hi} << 32) | lo;
+}
+#endif
+
+CpuFeatures detect() noexcept {
+  CpuFeatures f;
+#if defined(PWLEDGER_CPUID)
+  unsigned eax = 0;
+  unsigned ebx = 0;
+  unsigned ecx = 0;
+  unsigned edx = 0;
+  if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0) {
+    return f;
+  }
+  const bool ssse3 = (ecx & bit_SSSE3) != 0;
+  f.sse42 = ssse3 && (ecx & bit_SSE4_2) != 0;
+
+  const bool osxsave = (ecx & bit_OSXSAVE) != 0;
+  const bool avx = (ecx & bit_AVX) != 0;
+  const std::uint64_t xcr0 = osxsave ? read_xcr0() : 0;
+
+  if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) != 0) {
+    f.avx2 = f.sse42 && avx && (ebx & bit_AVX2) != 0 && (xcr0 & kXcr0Avx) == kXcr0Avx;
+    f.avx512 = f.avx2 && (ebx & bit_AVX512F) != 0 && (ebx & bit_AVX512BW) != 0 &&
+               (xcr0 & kXcr0Avx512) == kXcr0Avx512;
+  }
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+  f.neon = true;
+#endif
+  return f;
+}
+
+}  // anonymous namespace
+
+const CpuFeatures& cpu_features() noexcept {
+  static const CpuFeatures features = detect();
+  return features;
+}
+
+bool cpu_supports(Isa isa) noexcept {
+  const CpuFeatures& f = cpu_features();
+  switch (isa) {
+    case Isa::kSse42:
+      return f.sse42;
+    case Isa::kAvx2:
+      return f.avx2;
+    case Isa::kAvx512:
+      return f.avx512;
+    case Isa::kNeon:
+      return f.neon;
+    default:
+      return isa == Isa::kScalar;
+  }
+}
+
+std::string_view isa_name(Isa isa) noexcept {
+  // Indexed by Isa.
+  constexpr std::string_view kNames[] = {"scalar", "sse4.2", "avx2", "avx512", "neon"};
+  const auto i = static_cast<std::size_t>(isa);
+  return i < std::size(kNames) ? kNames[i] : "unknown";
+}
+
+std::optional<Isa> parse_isa(std::string_view name) noexcept {
+  if (name == "scalar" || name == "off") {
+    return Isa::kScalar;
+  }
+  for (const Isa isa : {Isa::kSse42, Isa::kAvx2, Isa::kAvx512, Isa::kNeon}) {
+    if (name == isa_name(isa)) {
+      return isa;
+    }
+  }
+  return std::nullopt;
+}
+
+}  // namespace pwledger
@@ -0,0 +1,788 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pwledger/Kernels.h>
+
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <sodium.h>
+
+// SIMD levels are compiled with per-function target attributes, so the rest
+// of the build keeps the baseline -march and only code reached through a
+// KernelSet the CPU supports ever executes these instructions.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define PWLEDGER_KERNELS_X86 1
+#define PWLEDGER_TARGET(isa) __attribute__((target(isa)))
+#define PWLEDGER_NOINLINE __attribute__((noinline))
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define PWLEDGER_KERNELS_NEON 1
+#endif
+
+namespace pwledger::kernels {
+
+namespace {
+
+// ============================================================================
+// Scalar
+// ============================================================================
+
+// A-Z -> a-z, everything else unchanged.
+constexpr std::array<std::uint8_t, 256> kFold = [] {
+  std::array<std::uint8_t, 256> t{};
+  for (std::size_t c = 0; c < 256; ++c) {
+    t[c] = static_cast<std::uint8_t>(c >= 'A' && c <= 'Z' ? c + 0x20 : c);
+  }
+  return t;
+}();
+
+inline std::uint8_t fold(char c) noexcept {
+  return kFold[static_cast<unsigned char>(c)];
+}
+
+bool equal_folded(const char* a, const char* b, std::size_t n) noexcept {
+  for (std::size_t i = 0; i < n; ++i) {
+    if (fold(a[i]) != fold(b[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Checks a candidate position whose first and last characters already
+// match: only the characters in between remain.
+inline bool verify_candidate(const char* at, std::string_view needle) noexcept {
+  return needle.size() < 3 || equal_folded(at + 1, needle.data() + 1, needle.size() - 2);
+}
+
+// Scalar search over positions [from, end); the SIMD versions finish their
+// tail here.
+bool icontains_from(std::string_view haystack, std::string_view needle, std::size_t from) noexcept {
+  const std::uint8_t first = fold(needle.front());
+  const std::uint8_t last = fold(needle.back());
+  const std::size_t tail = needle.size() - 1;
+  for (std::size_t i = from; i + tail < haystack.size(); ++i) {
+    if (fold(haystack[i]) == first && fold(haystack[i + tail]) == last && verify_candidate(haystack.data() + i, needle)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool icontains_scalar(std::string_view haystack, std::string_view needle) noexcept {
+  if (needle.empty()) {
+    return true;
+  }
+  if (needle.size() > haystack.size()) {
+    return false;
+  }
+  return icontains_from(haystack, needle, 0);
+}
+
+constexpr char kHexDigits[] = "0123456789abcdef";
+
+// 0x00-0x0F for hex digits of either case, 0xFF for everything else.
+constexpr std::array<std::uint8_t, 256> kNibble = [] {
+  std::array<std::uint8_t, 256> t{};
+  for (auto& v : t) v = 0xFF;
+  for (int c = 0; c < 10; ++c) t[static_cast<std::size_t>('0' + c)] = static_cast<std::uint8_t>(c);
+  for (int c = 0; c < 6; ++c) {
+    t[static_cast<std::size_t>('a' + c)] = static_cast<std::uint8_t>(10 + c);
+    t[static_cast<std::size_t>('A' + c)] = static_cast<std::uint8_t>(10 + c);
+  }
+  return t;
+}();
+
+void hex_encode_scalar(const std::uint8_t* in, std::size_t n, char* out) noexcept {
+  for (std::size_t i = 0; i < n; ++i) {
+    out[2 * i] = kHexDigits[in[i] >> 4];
+    out[2 * i + 1] = kHexDigits[in[i] & 0x0F];
+  }
+}
+
+// Validity is accumulated with OR rather than branching per character.
+bool hex_decode_scalar(const char* in, std::size_t n, std::uint8_t* out) noexcept {
+  std::uint8_t bad = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    const std::uint8_t hi = kNibble[static_cast<unsigned char>(in[2 * i])];
+    const std::uint8_t lo = kNibble[static_cast<unsigned char>(in[2 * i + 1])];
+    bad |= static_cast<std::uint8_t>(hi | lo);
+    out[i] = static_cast<std::uint8_t>((hi << 4) | (lo & 0x0F));
+  }
+  return (bad & 0xF0) == 0;
+}
+
+// Slicing-by-8: eight table lookups per 8 input bytes.
+constexpr std::uint32_t kCrc32cPoly = 0x82F63B78;  // reflected 0x1EDC6F41
+
+constexpr std::array<std::array<std::uint32_t, 256>, 8> kCrc32cTables = [] {
+  std::array<std::array<std::uint32_t, 256>, 8> t{};
+  for (std::uint32_t i = 0; i < 256; ++i) {
+    std::uint32_t c = i;
+    for (int k = 0; k < 8; ++k) {
+      c = (c & 1) != 0 ? (c >> 1) ^ kCrc32cPoly : c >> 1;
+    }
+    t[0][i] = c;
+  }
+  for (std::size_t s = 1; s < 8; ++s) {
+    for (std::size_t i = 0; i < 256; ++i) {
+      t[s][i] = (t[s - 1][i] >> 8) ^ t[0][t[s - 1][i] & 0xFF];
+    }
+  }
+  return t;
+}();
+
+std::uint32_t crc32c_scalar(std::uint32_t crc, const void* data, std::size_t n) noexcept {
+  const auto* p = static_cast<const std::uint8_t*>(data);
+  const auto& t = kCrc32cTables;
+  std::uint32_t c = ~crc;
+  for (; n >= 8; n -= 8, p += 8) {
+    const std::uint32_t lo = c ^ (std::uint32_t{p[0]} | std::uint32_t{p[1]} << 8 | std::uint32_t{p[2]} << 16 |
+                                  std::uint32_t{p[3]} << 24);
+    c = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^ t[3][p[4]] ^
+        t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+  }
+  for (; n > 0; --n, ++p) {
+    c = t[0][(c ^ *p) & 0xFF] ^ (c >> 8);
+  }
+  return ~c;
+}
+
+void secure_zero_scalar(void* p, std::size_t n) noexcept {
+  sodium_memzero(p, n);
+}
+
+// Argon2's BLAKE2b round with BlaMka (RFC 9106 section 3.6): the additions
+// in G become a + b + 2 * lo32(a) * lo32(b).
+inline std::uint64_t blamka(std::uint64_t a, std::uint64_t b) noexcept {
+  return a + b + 2 * (a & 0xFFFFFFFFu) * (b & 0xFFFFFFFFu);
+}
+
+inline std::uint64_t rotr64(std::uint64_t x, unsigned n) noexcept {
+  return (x >> n) | (x << (64 - n));
+}
+
+inline void gb(std::uint64_t& a, std::uint64_t& b, std::uint64_t& c, std::uint64_t& d) noexcept {
+  a = blamka(a, b);
+  d = rotr64(d ^ a, 32);
+  c = blamka(c, d);
+  b = rotr64(b ^ c, 24);
+  a = blamka(a, b);
+  d = rotr64(d ^ a, 16);
+  c = blamka(c, d);
+  b = rotr64(b ^ c, 63);
+}
+
+// The permutation P over the 16 words at q[base + stride(k)].
+template <typename Index>
+inline void blamka_round(std::uint64_t* q, Index at) noexcept {
+  gb(q[at(0)], q[at(4)], q[at(8)], q[at(12)]);
+  gb(q[at(1)], q[at(5)], q[at(9)], q[at(13)]);
+  gb(q[at(2)], q[at(6)], q[at(10)], q[at(14)]);
+  gb(q[at(3)], q[at(7)], q[at(11)], q[at(15)]);
+  gb(q[at(0)], q[at(5)], q[at(10)], q[at(15)]);
+  gb(q[at(1)], q[at(6)], q[at(11)], q[at(12)]);
+  gb(q[at(2)], q[at(7)], q[at(8)], q[at(13)]);
+  gb(q[at(3)], q[at(4)], q[at(9)], q[at(14)]);
+}
+
+// R = prev ^ ref; P over the eight rows of 16 words, then over the eight
+// columns of 2-word pairs; out = result ^ R.
+void argon2_fill_scalar(const std::uint64_t* prev, const std::uint64_t* ref, std::uint64_t* out,
+                        bool xor_into) noexcept {
+  std::uint64_t r[kArgon2BlockWords];
+  std::uint64_t q[kArgon2BlockWords];
+  for (std::size_t i = 0; i < kArgon2BlockWords; ++i) {
+    r[i] = prev[i] ^ ref[i];
+    q[i] = r[i];
+  }
+  for (std::size_t row = 0; row < 8; ++row) {
+    blamka_round(q, [row](std::size_t k) { return 16 * row + k; });
+  }
+  for (std::size_t col = 0; col < 8; ++col) {
+    blamka_round(q, [col](std::size_t k) { return 2 * col + 16 * (k / 2) + k % 2; });
+  }
+  for (std::size_t i = 0; i < kArgon2BlockWords; ++i) {
+    out[i] = (xor_into ? out[i] : 0) ^ q[i] ^ r[i];
+  }
+}
+
+#if defined(PWLEDGER_KERNELS_X86)
+// Makes the zero stores before it observable: the asm may read any memory
+// reachable from `p`, so the compiler cannot treat them as dead.
+inline void zero_barrier(void* p) noexcept {
+  __asm__ __volatile__("" : : "r"(p) : "memory");
+}
+#endif
+
+// ============================================================================
+// x86-64: SSE4.2, AVX2, AVX-512
+// ============================================================================
+#if defined(PWLEDGER_KERNELS_X86)
+
+// ----------------------------------------------------------------------------
+// SSE4.2
+// ----------------------------------------------------------------------------
+// pshufb (SSSE3) drives the hex codec and the crc32 instruction the CRC;
+// search uses plain SSE2 compares 16 positions at a time.
+
+PWLEDGER_TARGET("sse4.2") inline __m128i fold_sse(__m128i v) noexcept {
+  // Signed compares: bytes >= 0x80 are negative and never in 'A'..'Z'.
+  const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+  return _mm_add_epi8(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+// Candidate filter shared by the SIMD searches: compare the first and last
+// needle character against W consecutive positions at once and verify only
+// the positions where both match. Each scanW steps from `i` while a full
+// step fits, leaves `i` at the first position it did not scan, and returns
+// true on a match; the caller continues with a narrower scan and finally
+// icontains_from. Callers have checked that the needle is non-empty and no
+// longer than the haystack.
+PWLEDGER_TARGET("sse4.2") inline bool scan16(std::string_view haystack, std::string_view needle, std::size_t& i) noexcept {
+  const std::size_t tail = needle.size() - 1;
+  if (i + tail + 16 > haystack.size()) {
+    return false;  // not even one step: skip the broadcasts
+  }
+  const __m128i first = _mm_set1_epi8(static_cast<char>(fold(needle.front())));
+  const __m128i last = _mm_set1_epi8(static_cast<char>(fold(needle.back())));
+  const char* h = haystack.data();
+
+  for (; i + tail + 16 <= haystack.size(); i += 16) {
+    const __m128i a = fold_sse(_mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i)));
+    const __m128i b = fold_sse(_mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i + tail)));
+    auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last))));
+    for (; mask != 0; mask &= mask - 1) {
+      if (verify_candidate(h + i + static_cast<std::size_t>(__builtin_ctz(mask)), needle)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+PWLEDGER_TARGET("sse4.2") PWLEDGER_NOINLINE bool icontains_sse42(std::string_view haystack, std::string_view needle) noexcept {
+  if (needle.empty()) {
+    return true;
+  }
+  if (needle.size() > haystack.size()) {
+    return false;
+  }
+  std::size_t i = 0;
+  return scan16(haystack, needle, i) || icontains_from(haystack, needle, i);
+}
+
+PWLEDGER_TARGET("sse4.2") inline void hex_encode16_sse(const std::uint8_t* in, char* out) noexcept {
+  const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+  const __m128i mask = _mm_set1_epi8(0x0F);
+  const __m128i lut = _mm_loadu_si128(reinterpret_cast<const __m128i*>(kHexDigits));
+  const __m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+  const __m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(v, mask));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(hi, lo));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_unpackhi_epi8(hi, lo));
+}
+
+PWLEDGER_TARGET("sse4.2") void hex_encode_sse42(const std::uint8_t* in, std::size_t n, char* out) noexcept {
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    hex_encode16_sse(in + i, out + 2 * i);
+  }
+  hex_encode_scalar(in + i, n - i, out + 2 * i);
+}
+
+// 16 hex characters -> 16 nibbles; `valid` keeps a 0xFF lane for every
+// character that is a hex digit.
+PWLEDGER_TARGET("sse4.2") inline __m128i nibbles_sse(__m128i c, __m128i& valid) noexcept {
+  const __m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+  const __m128i is_digit =
+      _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+  const __m128i is_alpha =
+      _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+  valid = _mm_and_si128(valid, _mm_or_si128(is_digit, is_alpha));
+  const __m128i digit = _mm_and_si128(is_digit, _mm_sub_epi8(c, _mm_set1_epi8('0')));
+  const __m128i alpha = _mm_and_si128(is_alpha, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10)));
+  return _mm_or_si128(digit, alpha);
+}
+
+PWLEDGER_TARGET("sse4.2") inline bool hex_decode16_sse(const char* in, std::uint8_t* out) noexcept {
+  __m128i valid = _mm_set1_epi8(-1);
+  const __m128i a = nibbles_sse(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)), valid);
+  const __m128i b = nibbles_sse(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16)), valid);
+  // Each adjacent (hi, lo) pair becomes hi * 16 + lo in a 16-bit lane.
+  const __m128i weights = _mm_set1_epi16(0x0110);
+  const __m128i packed = _mm_packus_epi16(_mm_maddubs_epi16(a, weights), _mm_maddubs_epi16(b, weights));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out), packed);
+  return _mm_movemask_epi8(valid) == 0xFFFF;
+}
+
+PWLEDGER_TARGET("sse4.2") bool hex_decode_sse42(const char* in, std::size_t n, std::uint8_t* out) noexcept {
+  bool ok = true;
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    ok &= hex_decode16_sse(in + 2 * i, out + i);
+  }
+  return hex_decode_scalar(in + 2 * i, n - i, out + i) && ok;
+}
+
+PWLEDGER_TARGET("avx2") inline __m256i blamka_avx2(__m256i a, __m256i b) noexcept {
+  const __m256i m = _mm256_mul_epu32(a, b);  // lo32(a) * lo32(b) per 64-bit lane
+  return _mm256_add_epi64(_mm256_add_epi64(a, b), _mm256_add_epi64(m, m));
+}
+
+// G on four columns at once, one word of each per 64-bit lane. Rotations
+// by 32, 24 and 16 are byte shuffles; by 63 it is a shift and an add.
+PWLEDGER_TARGET("avx2") inline void gb_avx2(__m256i& a, __m256i& b, __m256i& c, __m256i& d) noexcept {
+  const __m256i rot24 = _mm256_setr_epi8(3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10,
+                                         3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10);
+  const __m256i rot16 = _mm256_setr_epi8(2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9,
+                                         2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9);
+  a = blamka_avx2(a, b);
+  d = _mm256_shuffle_epi32(_mm256_xor_si256(d, a), _MM_SHUFFLE(2, 3, 0, 1));
+  c = blamka_avx2(c, d);
+  b = _mm256_shuffle_epi8(_mm256_xor_si256(b, c), rot24);
+  a = blamka_avx2(a, b);
+  d = _mm256_shuffle_epi8(_mm256_xor_si256(d, a), rot16);
+  c = blamka_avx2(c, d);
+  b = _mm256_xor_si256(b, c);
+  b = _mm256_xor_si256(_mm256_srli_epi64(b, 63), _mm256_add_epi64(b, b));
+}
+
+// P on v0..v15 held as a = v0-3, b = v4-7, c = v8-11, d = v12-15: columns
+// directly, then diagonals by rotating b, c and d one, two and three lanes.
+PWLEDGER_TARGET("avx2") inline void blamka_round_avx2(__m256i& a, __m256i& b, __m256i& c, __m256i& d) noexcept {
+  gb_avx2(a, b, c, d);
+  b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(0, 3, 2, 1));
+  c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+  d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(2, 1, 0, 3));
+  gb_avx2(a, b, c, d);
+  b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(2, 1, 0, 3));
+  c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+  d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(0, 3, 2, 1));
+}
+
+// A column's 16 words are word pairs 2*col, 2*col+1 of each row, so each
+// vector takes one 128-bit pair from each of two consecutive rows.
+PWLEDGER_TARGET("avx2") inline __m256i load_pairs(const std::uint64_t* lo, const std::uint64_t* hi) noexcept {
+  return _mm256_inserti128_si256(
+      _mm256_castsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(lo))),
+      _mm_load_si128(reinterpret_cast<const __m128i*>(hi)), 1);
+}
+
+PWLEDGER_TARGET("avx2") inline void store_pairs(std::uint64_t* lo, std::uint64_t* hi, __m256i v) noexcept {
+  _mm_store_si128(reinterpret_cast<__m128i*>(lo), _mm256_castsi256_si128(v));
+  _mm_store_si128(reinterpret_cast<__m128i*>(hi), _mm256_extracti128_si256(v, 1));
+}
+
+PWLEDGER_TARGET("avx2") void argon2_fill_avx2(const std::uint64_t* prev, const std::uint64_t* ref,
+                                              std::uint64_t* out, bool xor_into) noexcept {
+  alignas(32) std::uint64_t q[kArgon2BlockWords];
+  __m256i r[kArgon2BlockWords / 4];
+  for (std::size_t i = 0; i < kArgon2BlockWords / 4; ++i) {
+    r[i] = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev + 4 * i)),
+                            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ref + 4 * i)));
+    _mm256_store_si256(reinterpret_cast<__m256i*>(q + 4 * i), r[i]);
+  }
+  for (std::size_t row = 0; row < 8; ++row) {
+    auto* v = reinterpret_cast<__m256i*>(q + 16 * row);
+    __m256i a = _mm256_load_si256(v);
+    __m256i b = _mm256_load_si256(v + 1);
+    __m256i c = _mm256_load_si256(v + 2);
+    __m256i d = _mm256_load_si256(v + 3);
+    blamka_round_avx2(a, b, c, d);
+    _mm256_store_si256(v, a);
+    _mm256_store_si256(v + 1, b);
+    _mm256_store_si256(v + 2, c);
+    _mm256_store_si256(v + 3, d);
+  }
+  for (std::size_t col = 0; col < 8; ++col) {
+    std::uint64_t* w = q + 2 * col;
+    __m256i a = load_pairs(w, w + 16);
+    __m256i b = load_pairs(w + 32, w + 48);
+    __m256i c = load_pairs(w + 64, w + 80);
+    __m256i d = load_pairs(w + 96, w + 112);
+    blamka_round_avx2(a, b, c, d);
+    store_pairs(w, w + 16, a);
+    store_pairs(w + 32, w + 48, b);
+    store_pairs(w + 64, w + 80, c);
+    store_pairs(w + 96, w + 112, d);
+  }
+  for (std::size_t i = 0; i < kArgon2BlockWords / 4; ++i) {
+    auto* o = reinterpret_cast<__m256i*>(out + 4 * i);
+    __m256i v = _mm256_xor_si256(_mm256_load_si256(reinterpret_cast<const __m256i*>(q + 4 * i)), r[i]);
+    if (xor_into) {
+      v = _mm256_xor_si256(v, _mm256_loadu_si256(o));
+    }
+    _mm256_storeu_si256(o, v);
+  }
+  _mm256_zeroupper();
+}
+
+PWLEDGER_TARGET("sse4.2") std::uint32_t crc32c_sse42(std::uint32_t crc, const void* data, std::size_t n) noexcept {
+  const auto* p = static_cast<const std::uint8_t*>(data);
+  std::uint64_t c = ~crc;
+  for (; n >= 8; n -= 8, p += 8) {
+    std::uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    c = _mm_crc32_u64(c, word);
+  }
+  auto c32 = static_cast<std::uint32_t>(c);
+  for (; n > 0; --n, ++p) {
+    c32 = _mm_crc32_u8(c32, *p);
+  }
+  return ~c32;
+}
+
+// ----------------------------------------------------------------------------
+// AVX2
+// ----------------------------------------------------------------------------
+
+PWLEDGER_TARGET("avx2") inline __m256i fold_avx2(__m256i v) noexcept {
+  const __m256i upper =
+      _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('A' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), v));
+  return _mm256_add_epi8(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+
+PWLEDGER_TARGET("avx2") inline bool scan32(std::string_view haystack, std::string_view needle, std::size_t& i) noexcept {
+  const std::size_t tail = needle.size() - 1;
+  if (i + tail + 32 > haystack.size()) {
+    return false;  // not even one step: skip the broadcasts
+  }
+  const __m256i first = _mm256_set1_epi8(static_cast<char>(fold(needle.front())));
+  const __m256i last = _mm256_set1_epi8(static_cast<char>(fold(needle.back())));
+  const char* h = haystack.data();
+
+  for (; i + tail + 32 <= haystack.size(); i += 32) {
+    const __m256i a = fold_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i)));
+    const __m256i b = fold_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i + tail)));
+    auto mask = static_cast<std::uint32_t>(
+        _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last))));
+    for (; mask != 0; mask &= mask - 1) {
+      if (verify_candidate(h + i + static_cast<std::size_t>(__builtin_ctz(mask)), needle)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+PWLEDGER_TARGET("avx2") PWLEDGER_NOINLINE bool icontains_wide_avx2(std::string_view haystack,
+                                                                  std::string_view needle) noexcept {
+  std::size_t i = 0;
+  return scan32(haystack, needle, i) || scan16(haystack, needle, i) || icontains_from(haystack, needle, i);
+}
+
+// Most vault fields are shorter than one 32-byte step plus the needle. Those
+// tail-call the SSE4.2 search directly: with the wide search inlined here,
+// every call paid its register saves and stack realignment, which measured
+// 10-20% slower than SSE4.2 on vault-sized keys.
+PWLEDGER_TARGET("avx2") bool icontains_avx2(std::string_view haystack, std::string_view needle) noexcept {
+  if (needle.empty() || haystack.size() < needle.size() + 31) {
+    return icontains_sse42(haystack, needle);
+  }
+  return icontains_wide_avx2(haystack, needle);
+}
+
+// 32 bytes per step. pshufb and unpack work within 128-bit lanes, so the
+// two halves of the output are reassembled across lanes before storing.
+PWLEDGER_TARGET("avx2") void hex_encode_avx2(const std::uint8_t* in, std::size_t n, char* out) noexcept {
+  const __m256i mask = _mm256_set1_epi8(0x0F);
+  const __m256i lut = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(kHexDigits)));
+  std::size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+    const __m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), mask));
+    const __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(v, mask));
+    const __m256i a = _mm256_unpacklo_epi8(hi, lo);  // bytes 0-7 | 16-23
+    const __m256i b = _mm256_unpackhi_epi8(hi, lo);  // bytes 8-15 | 24-31
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i), _mm256_permute2x128_si256(a, b, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i + 32), _mm256_permute2x128_si256(a, b, 0x31));
+  }
+  for (; i + 16 <= n; i += 16) {
+    hex_encode16_sse(in + i, out + 2 * i);
+  }
+  hex_encode_scalar(in + i, n - i, out + 2 * i);
+}
+
+PWLEDGER_TARGET("avx2") inline __m256i nibbles_avx2(__m256i c, __m256i& valid) noexcept {
+  const __m256i lower = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+  const __m256i is_digit =
+      _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+  const __m256i is_alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                                            _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lower));
+  valid = _mm256_and_si256(valid, _mm256_or_si256(is_digit, is_alpha));
+  const __m256i digit = _mm256_and_si256(is_digit, _mm256_sub_epi8(c, _mm256_set1_epi8('0')));
+  const __m256i alpha = _mm256_and_si256(is_alpha, _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10)));
+  return _mm256_or_si256(digit, alpha);
+}
+
+// 64 characters -> 32 bytes per step. packus interleaves the two inputs'
+// lanes (0-7, 16-23 | 8-15, 24-31); permute4x64 restores byte order.
+PWLEDGER_TARGET("avx2") bool hex_decode_avx2(const char* in, std::size_t n, std::uint8_t* out) noexcept {
+  const __m256i weights = _mm256_set1_epi16(0x0110);
+  __m256i valid = _mm256_set1_epi8(-1);
+  std::size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    const __m256i a = nibbles_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i)), valid);
+    const __m256i b = nibbles_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i + 32)), valid);
+    const __m256i packed = _mm256_packus_epi16(_mm256_maddubs_epi16(a, weights), _mm256_maddubs_epi16(b, weights));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_permute4x64_epi64(packed, 0xD8));
+  }
+  bool ok = _mm256_movemask_epi8(valid) == -1;
+  // GCC does not always clear the upper halves here on its own, and dirty
+  // upper state makes every later non-VEX SSE instruction in the caller
+  // pay a merge penalty (measured: 10x slower Uuid::from_chars).
+  _mm256_zeroupper();
+  for (; i + 16 <= n; i += 16) {
+    ok &= hex_decode16_sse(in + 2 * i, out + i);
+  }
+  return hex_decode_scalar(in + 2 * i, n - i, out + i) && ok;
+}
+
+
+// ----------------------------------------------------------------------------
+// AVX-512 (F + BW)
+// ----------------------------------------------------------------------------
+// Byte compares produce 64-bit masks directly, and a masked store zeroes
+// any buffer shorter than 64 bytes in one instruction.
+
+PWLEDGER_TARGET("avx512f,avx512bw") inline __m512i fold_avx512(__m512i v) noexcept {
+  const __mmask64 upper =
+      _mm512_cmplt_epu8_mask(_mm512_sub_epi8(v, _mm512_set1_epi8('A')), _mm512_set1_epi8(26));
+  return _mm512_mask_add_epi8(v, upper, v, _mm512_set1_epi8(0x20));
+}
+
+PWLEDGER_TARGET("avx512f,avx512bw") inline bool scan64(std::string_view haystack, std::string_view needle,
+                                                          std::size_t& i) noexcept {
+  const std::size_t tail = needle.size() - 1;
+  if (i + tail + 64 > haystack.size()) {
+    return false;  // not even one step: skip the broadcasts
+  }
+  const __m512i first = _mm512_set1_epi8(static_cast<char>(fold(needle.front())));
+  const __m512i last = _mm512_set1_epi8(static_cast<char>(fold(needle.back())));
+  const char* h = haystack.data();
+
+  for (; i + tail + 64 <= haystack.size(); i += 64) {
+    const __m512i a = fold_avx512(_mm512_loadu_si512(h + i));
+    const __m512i b = fold_avx512(_mm512_loadu_si512(h + i + tail));
+    std::uint64_t mask = _mm512_cmpeq_epi8_mask(a, first) & _mm512_cmpeq_epi8_mask(b, last);
+    for (; mask != 0; mask &= mask - 1) {
+      if (verify_candidate(h + i + static_cast<std::size_t>(__builtin_ctzll(mask)), needle)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+PWLEDGER_TARGET("avx512f,avx512bw") PWLEDGER_NOINLINE bool icontains_wide_avx512(std::string_view haystack,
+                                                                              std::string_view needle) noexcept {
+  std::size_t i = 0;
+  return scan64(haystack, needle, i) || scan32(haystack, needle, i) || scan16(haystack, needle, i) ||
+         icontains_from(haystack, needle, i);
+}
+
+PWLEDGER_TARGET("avx512f,avx512bw") bool icontains_avx512(std::string_view haystack, std::string_view needle) noexcept {
+  if (needle.empty() || haystack.size() < needle.size() + 31) {
+    return icontains_sse42(haystack, needle);
+  }
+  if (haystack.size() < needle.size() + 63) {
+    return icontains_wide_avx2(haystack, needle);
+  }
+  return icontains_wide_avx512(haystack, needle);
+}
+
+// Buffers shorter than one vector take a single masked store: no loop and
+// no byte tail, about half the cost of the call into libc. From 64 bytes on
+// sodium_memzero is as fast or faster (libc's memset already uses the widest
+// stores) and full-width zmm stores here measured slower, so it gets those.
+PWLEDGER_TARGET("avx512f,avx512bw") void secure_zero_avx512(void* p, std::size_t n) noexcept {
+  if (n >= 64) {
+    sodium_memzero(p, n);
+    return;
+  }
+  if (n > 0) {
+    _mm512_mask_storeu_epi8(p, (~__mmask64{0}) >> (64 - n), _mm512_setzero_si512());
+  }
+  zero_barrier(p);
+}
+
+#endif  // PWLEDGER_KERNELS_X86
+
+// ============================================================================
+// AArch64: NEON
+// ============================================================================
+#if defined(PWLEDGER_KERNELS_NEON)
+
+inline uint8x16_t fold_neon(uint8x16_t v) noexcept {
+  const uint8x16_t upper = vcltq_u8(vsubq_u8(v, vdupq_n_u8('A')), vdupq_n_u8(26));
+  return vaddq_u8(v, vandq_u8(upper, vdupq_n_u8(0x20)));
+}
+
+bool icontains_neon(std::string_view haystack, std::string_view needle) noexcept {
+  if (needle.empty()) {
+    return true;
+  }
+  if (needle.size() > haystack.size()) {
+    return false;
+  }
+  const std::size_t tail = needle.size() - 1;
+  const uint8x16_t first = vdupq_n_u8(fold(needle.front()));
+  const uint8x16_t last = vdupq_n_u8(fold(needle.back()));
+  const auto* h = reinterpret_cast<const std::uint8_t*>(haystack.data());
+
+  std::size_t i = 0;
+  for (; i + tail + 16 <= haystack.size(); i += 16) {
+    const uint8x16_t eq = vandq_u8(vceqq_u8(fold_neon(vld1q_u8(h + i)), first),
+                                   vceqq_u8(fold_neon(vld1q_u8(h + i + tail)), last));
+    if (vmaxvq_u8(eq) == 0) {
+      continue;
+    }
+    // Narrow to four mask bits per byte position.
+    std::uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+    for (; mask != 0; mask &= ~(std::uint64_t{0xF} << (__builtin_ctzll(mask) & ~3))) {
+      if (verify_candidate(haystack.data() + i + static_cast<std::size_t>(__builtin_ctzll(mask) / 4), needle)) {
+        return true;
+      }
+    }
+  }
+  return icontains_from(haystack, needle, i);
+}
+
+void hex_encode_neon(const std::uint8_t* in, std::size_t n, char* out) noexcept {
+  const uint8x16_t lut = vld1q_u8(reinterpret_cast<const std::uint8_t*>(kHexDigits));
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const uint8x16_t v = vld1q_u8(in + i);
+    const uint8x16_t hi = vqtbl1q_u8(lut, vshrq_n_u8(v, 4));
+    const uint8x16_t lo = vqtbl1q_u8(lut, vandq_u8(v, vdupq_n_u8(0x0F)));
+    vst1q_u8(reinterpret_cast<std::uint8_t*>(out + 2 * i), vzip1q_u8(hi, lo));
+    vst1q_u8(reinterpret_cast<std::uint8_t*>(out + 2 * i + 16), vzip2q_u8(hi, lo));
+  }
+  hex_encode_scalar(in + i, n - i, out + 2 * i);
+}
+
+inline uint8x16_t nibbles_neon(uint8x16_t c, uint8x16_t& valid) noexcept {
+  const uint8x16_t digit = vsubq_u8(c, vdupq_n_u8('0'));
+  const uint8x16_t alpha = vsubq_u8(vorrq_u8(c, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+  const uint8x16_t is_digit = vcltq_u8(digit, vdupq_n_u8(10));
+  const uint8x16_t is_alpha = vcltq_u8(alpha, vdupq_n_u8(6));
+  valid = vandq_u8(valid, vorrq_u8(is_digit, is_alpha));
+  return vorrq_u8(vandq_u8(is_digit, digit), vandq_u8(is_alpha, vaddq_u8(alpha, vdupq_n_u8(10))));
+}
+
+bool hex_decode_neon(const char* in, std::size_t n, std::uint8_t* out) noexcept {
+  const auto* c = reinterpret_cast<const std::uint8_t*>(in);
+  uint8x16_t valid = vdupq_n_u8(0xFF);
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const uint8x16_t a = nibbles_neon(vld1q_u8(c + 2 * i), valid);
+    const uint8x16_t b = nibbles_neon(vld1q_u8(c + 2 * i + 16), valid);
+    vst1q_u8(out + i, vorrq_u8(vshlq_n_u8(vuzp1q_u8(a, b), 4), vuzp2q_u8(a, b)));
+  }
+  return hex_decode_scalar(in + 2 * i, n - i, out + i) && vminvq_u8(valid) == 0xFF;
+}
+
+#endif  // PWLEDGER_KERNELS_NEON
+
+// ============================================================================
+// Variant tables
+// ============================================================================
+
+constexpr KernelSet kScalar{Isa::kScalar, icontains_scalar, hex_encode_scalar, hex_decode_scalar, crc32c_scalar,
+                            secure_zero_scalar, argon2_fill_scalar};
+
+#if defined(PWLEDGER_KERNELS_X86)
+constexpr KernelSet kSse42{Isa::kSse42, icontains_sse42, hex_encode_sse42, hex_decode_sse42, crc32c_sse42,
+                           secure_zero_scalar, argon2_fill_scalar};
+constexpr KernelSet kAvx2{Isa::kAvx2, icontains_avx2, hex_encode_avx2, hex_decode_avx2, crc32c_sse42,
+                          secure_zero_scalar, argon2_fill_avx2};
+constexpr KernelSet kAvx512{Isa::kAvx512, icontains_avx512, hex_encode_avx2, hex_decode_avx2, crc32c_sse42,
+                            secure_zero_avx512, argon2_fill_avx2};
+constexpr KernelSet kCompiled[] = {kScalar, kSse42, kAvx2, kAvx512};
+#elif defined(PWLEDGER_KERNELS_NEON)
+constexpr KernelSet kNeon{Isa::kNeon, icontains_neon, hex_encode_neon, hex_decode_neon, crc32c_scalar,
+                          secure_zero_scalar, argon2_fill_scalar};
+constexpr KernelSet kCompiled[] = {kScalar, kNeon};
+#else
+constexpr KernelSet kCompiled[] = {kScalar};
+#endif
+
+constexpr std::size_t kCompiledCount = sizeof(kCompiled) / sizeof(kCompiled[0]);
+
+// Levels in kCompiled are in increasing order and each implies the ones
+// before it, so the supported ones form a prefix.
+std::size_t supported_count() noexcept {
+  std::size_t n = 1;
+  while (n < kCompiledCount && cpu_supports(kCompiled[n].isa)) {
+    ++n;
+  }
+  return n;
+}
+
+const KernelSet& choose_from_env() noexcept {
+  const char* env = std::getenv("PWLEDGER_SIMD");
+  if (env == nullptr || *env == '\0' || std::strcmp(env, "auto") == 0) {
+    return select(std::nullopt);
+  }
+  const std::optional<Isa> cap = parse_isa(env);
+  if (!cap) {
+    std::fprintf(stderr, "Warning: ignoring unknown PWLEDGER_SIMD value '%s'\n", env);
+    return select(std::nullopt);
+  }
+  const KernelSet& chosen = select(cap);
+  if (chosen.isa != *cap) {
+    std::fprintf(stderr, "Warning: PWLEDGER_SIMD=%s is not available here; using %s\n", env,
+                 isa_name(chosen.isa).data());
+  }
+  return chosen;
+}
+
+}  // anonymous namespace
+
+std::span<const KernelSet> variants() noexcept {
+  static const std::size_t count = supported_count();
+  return {kCompiled, count};
+}
+
+const KernelSet& select(std::optional<Isa> cap) noexcept {
+  const std::span<const KernelSet> available = variants();
+  if (!cap) {
+    return available.back();
+  }
+  // Isa values are ordered within a family; a level from the other family
+  // (neon on x86-64, avx2 on AArch64) caps at scalar.
+  const auto is_arm = [](Isa isa) { return isa == Isa::kNeon; };
+  const KernelSet* best = &available.front();
+  for (const KernelSet& k : available) {
+    if (is_arm(k.isa) == is_arm(*cap) && k.isa <= *cap) {
+      best = &k;
+    }
+  }
+  return *best;
+}
+
+const KernelSet& active() noexcept {
+  static const KernelSet& chosen = choose_from_env();
+  return chosen;
+}
+
+}  // namespace pwledger::kernels
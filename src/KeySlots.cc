@@ -0,0 +1,541 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pwledger/KeySlots.h>
+
+#include <pwledger/Kernels.h>
+#include <pwledger/SodiumInit.h>
+#include <pwledger/Trace.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace pwledger {
+
+namespace {
+
+constexpr std::size_t kVersionOffset = sizeof(VaultCrypto::kMagic);
+constexpr std::size_t kSuiteOffset = kVersionOffset + 1;
+constexpr std::size_t kSlotCountOffset = kSuiteOffset + 1;
+constexpr std::size_t kSlotsOffset = kSlotCountOffset + 1;
+// The payload's additional data: magic, version and suite.
+constexpr std::size_t kPayloadAdBytes = kSlotCountOffset;
+
+constexpr std::size_t kWrapNonceBytes = crypto_aead_xchacha20poly1305_ietf_NPUBBYTES;
+constexpr std::size_t kPasswordWrapBytes = kWrapNonceBytes + VaultCrypto::kKeyBytes + VaultCrypto::kTagBytes;
+constexpr std::size_t kSealedBytes = crypto_box_SEALBYTES + VaultCrypto::kKeyBytes;
+
+void put_u32le(std::vector<std::uint8_t>& out, std::uint32_t v) {
+  for (int i = 0; i < 4; ++i) {
+    out.push_back(static_cast<std::uint8_t>(v >> (8 * i)));
+  }
+}
+
+// Bounds-checked reads over a blob being parsed.
+class Reader {
+public:
+  explicit Reader(std::span<const std::uint8_t> bytes, std::size_t at) : bytes_(bytes), at_(at) {}
+
+  std::span<const std::uint8_t> take(std::size_t n) {
+    if (bytes_.size() - at_ < n) {
+      throw std::runtime_error("Vault header is truncated");
+    }
+    const auto out = bytes_.subspan(at_, n);
+    at_ += n;
+    return out;
+  }
+
+  std::uint8_t u8() { return take(1)[0]; }
+
+  std::uint32_t u32le() {
+    const auto b = take(4);
+    return static_cast<std::uint32_t>(b[0]) | static_cast<std::uint32_t>(b[1]) << 8 |
+           static_cast<std::uint32_t>(b[2]) << 16 | static_cast<std::uint32_t>(b[3]) << 24;
+  }
+
+  [[nodiscard]] std::size_t offset() const noexcept { return at_; }
+
+private:
+  std::span<const std::uint8_t> bytes_;
+  std::size_t at_;
+};
+
+// A password slot's bytes from its type through its salt: what its AEAD
+// binds as additional data, and the start of its serialized form.
+std::vector<std::uint8_t> password_slot_prefix(const KeySlot& slot) {
+  std::vector<std::uint8_t> out;
+  out.push_back(static_cast<std::uint8_t>(slot.type));
+  out.push_back(static_cast<std::uint8_t>(slot.label.size()));
+  out.insert(out.end(), slot.label.begin(), slot.label.end());
+  put_u32le(out, static_cast<std::uint32_t>(slot.kdf.opslimit));
+  put_u32le(out, static_cast<std::uint32_t>(slot.kdf.memlimit / 1024u));
+  out.push_back(static_cast<std::uint8_t>(slot.kdf.parallelism));
+  out.insert(out.end(), slot.salt.begin(), slot.salt.end());
+  return out;
+}
+
+void check_suite_available(CipherSuite suite) {
+  if (suite == CipherSuite::kAes256Gcm && !(sodium_init_once() && crypto_aead_aes256gcm_is_available() != 0)) {
+    throw std::runtime_error("AES-256-GCM is not available on this CPU");
+  }
+}
+
+const std::uint8_t* key_bytes(std::span<const char> buf) noexcept {
+  return reinterpret_cast<const std::uint8_t*>(buf.data());
+}
+
+// Creates `path` for writing with owner-only permissions, failing if it
+// exists: one open(2), so nothing can reach the file before its mode is
+// set, and a file or link planted at `path` is never followed or reused.
+int create_owner_only(const std::filesystem::path& path) {
+#ifdef _WIN32
+  return _wopen(path.c_str(), _O_WRONLY | _O_CREAT | _O_EXCL | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+  return ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+#endif
+}
+
+bool write_fd(int fd, const char* data, std::size_t n) {
+  while (n > 0) {
+#ifdef _WIN32
+    const long written = _write(fd, data, static_cast<unsigned>(n));
+#else
+    const long written = static_cast<long>(::write(fd, data, n));
+#endif
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      return false;
+    }
+    data += written;
+    n -= static_cast<std::size_t>(written);
+  }
+  return true;
+}
+
+int close_fd(int fd) {
+#ifdef _WIN32
+  return _close(fd);
+#else
+  return ::close(fd);
+#endif
+}
+
+}  // namespace
+
+// ============================================================================
+// X25519KeyPair
+// ============================================================================
+
+X25519KeyPair X25519KeyPair::generate() {
+  X25519KeyPair pair;
+  pair.secret_key.with_write_access([&](std::span<char> sk) {
+    crypto_box_keypair(pair.public_key.data(), reinterpret_cast<std::uint8_t*>(sk.data()));
+  });
+  return pair;
+}
+
+X25519KeyPair X25519KeyPair::read_file(const std::filesystem::path& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    throw std::runtime_error("Failed to open key file " + path.string());
+  }
+  X25519KeyPair pair;
+  bool complete = false;
+  pair.secret_key.with_write_access([&](std::span<char> sk) {
+    in.read(sk.data(), static_cast<std::streamsize>(sk.size()));
+    complete = in.gcount() == static_cast<std::streamsize>(sk.size()) && in.peek() == std::char_traits<char>::eof();
+    if (complete) {
+      crypto_scalarmult_base(pair.public_key.data(), reinterpret_cast<const std::uint8_t*>(sk.data()));
+    }
+  });
+  if (!complete) {
+    throw std::runtime_error("Key file " + path.string() + " is not a " +
+                             std::to_string(crypto_box_SECRETKEYBYTES) + "-byte X25519 secret key");
+  }
+  return pair;
+}
+
+void X25519KeyPair::write_file(const std::filesystem::path& path) const {
+  const int fd = create_owner_only(path);
+  if (fd < 0) {
+    if (errno == EEXIST) {
+      throw std::runtime_error("Key file " + path.string() + " already exists");
+    }
+    throw std::runtime_error("Failed to create key file " + path.string() + ": " + std::strerror(errno));
+  }
+  bool written = false;
+  secret_key.with_read_access([&](std::span<const char> sk) { written = write_fd(fd, sk.data(), sk.size()); });
+  if (close_fd(fd) != 0) {
+    written = false;
+  }
+  if (!written) {
+    std::error_code ignored;
+    std::filesystem::remove(path, ignored);
+    throw std::runtime_error("Write to key file " + path.string() + " failed");
+  }
+}
+
+std::string public_key_to_hex(const X25519PublicKey& key) {
+  std::string out(key.size() * 2, '\0');
+  kernels::hex_encode(key.data(), key.size(), out.data());
+  return out;
+}
+
+std::optional<X25519PublicKey> public_key_from_hex(std::string_view hex) {
+  X25519PublicKey key;
+  if (hex.size() != key.size() * 2 || !kernels::hex_decode(hex.data(), key.size(), key.data())) {
+    return std::nullopt;
+  }
+  return key;
+}
+
+// ============================================================================
+// SlottedVault
+// ============================================================================
+
+bool SlottedVault::is_slotted(std::span<const std::uint8_t> blob) noexcept {
+  return blob.size() >= kSlotsOffset &&
+         std::memcmp(blob.data(), VaultCrypto::kMagic, sizeof(VaultCrypto::kMagic)) == 0 &&
+         blob[kVersionOffset] == kFormatVersion;
+}
+
+Secret SlottedVault::generate_data_key() {
+  Secret key(VaultCrypto::kKeyBytes);
+  key.with_write_access([](std::span<char> buf) { randombytes_buf(buf.data(), buf.size()); });
+  return key;
+}
+
+SlottedVault SlottedVault::create(const Secret& data_key, const std::vector<std::uint8_t>& plaintext,
+                                  CipherSuite suite) {
+  SlottedVault vault;
+  vault.reseal(data_key, plaintext, suite);
+  return vault;
+}
+
+SlottedVault SlottedVault::parse(std::vector<std::uint8_t> blob) {
+  PWLEDGER_TRACE_SPAN("SlottedVault::parse");
+
+  if (!is_slotted(blob)) {
+    throw std::runtime_error("Not a key-slot vault");
+  }
+  SlottedVault vault;
+  const std::uint8_t suite = blob[kSuiteOffset];
+  if (suite != static_cast<std::uint8_t>(CipherSuite::kXChaCha20Poly1305) &&
+      suite != static_cast<std::uint8_t>(CipherSuite::kAes256Gcm)) {
+    throw std::runtime_error("Vault uses an unknown cipher suite (" + std::to_string(suite) + ")");
+  }
+  vault.suite_ = static_cast<CipherSuite>(suite);
+
+  Reader in(blob, kSlotCountOffset);
+  const std::size_t count = in.u8();
+  if (count == 0) {
+    throw std::runtime_error("Vault has no key slots");
+  }
+  vault.slots_.reserve(count);
+  std::size_t password_slots = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    KeySlot slot;
+    const std::uint8_t type = in.u8();
+    const auto label = in.take(in.u8());
+    slot.label.assign(label.begin(), label.end());
+    if (type == static_cast<std::uint8_t>(KeySlot::Type::kPassword)) {
+      if (++password_slots > kMaxPasswordSlots) {
+        throw std::runtime_error("Vault has more than " + std::to_string(kMaxPasswordSlots) + " password slots");
+      }
+      slot.type = KeySlot::Type::kPassword;
+      slot.kdf.opslimit = in.u32le();
+      slot.kdf.memlimit = std::size_t{in.u32le()} * 1024u;
+      slot.kdf.parallelism = in.u8();
+      VaultCrypto::check_kdf_params(slot.kdf);
+      const auto salt = in.take(slot.salt.size());
+      std::copy(salt.begin(), salt.end(), slot.salt.begin());
+      const auto wrapped = in.take(kPasswordWrapBytes);
+      slot.wrapped.assign(wrapped.begin(), wrapped.end());
+    } else if (type == static_cast<std::uint8_t>(KeySlot::Type::kPublicKey)) {
+      slot.type = KeySlot::Type::kPublicKey;
+      const auto key = in.take(slot.public_key.size());
+      std::copy(key.begin(), key.end(), slot.public_key.begin());
+      const auto sealed = in.take(kSealedBytes);
+      slot.wrapped.assign(sealed.begin(), sealed.end());
+    } else {
+      throw std::runtime_error("Vault has a key slot of unknown type (" + std::to_string(type) + ")");
+    }
+    vault.slots_.push_back(std::move(slot));
+  }
+
+  const std::size_t payload_at = in.offset();
+  if (blob.size() - payload_at < VaultCrypto::nonce_bytes(vault.suite_) + VaultCrypto::kTagBytes) {
+    throw std::runtime_error("Ciphertext too short (missing nonce or tag)");
+  }
+  blob.erase(blob.begin(), blob.begin() + static_cast<std::ptrdiff_t>(payload_at));
+  vault.payload_ = std::move(blob);
+  return vault;
+}
+
+const KeySlot* SlottedVault::find_slot(std::string_view label) const noexcept {
+  const auto it = std::find_if(slots_.begin(), slots_.end(), [&](const KeySlot& s) { return s.label == label; });
+  return it != slots_.end() ? &*it : nullptr;
+}
+
+// ----------------------------------------------------------------------------
+// Unwrapping the data key
+// ----------------------------------------------------------------------------
+
+Secret SlottedVault::unlock(std::string_view password, std::string_view label) const {
+  PWLEDGER_TRACE_SPAN("SlottedVault::unlock_password");
+
+  for (const KeySlot& slot : slots_) {
+    if (slot.type != KeySlot::Type::kPassword || (!label.empty() && slot.label != label)) {
+      continue;
+    }
+    const Secret kek = VaultCrypto::derive_master_key(password, slot.salt.data(), slot.kdf);
+    const std::vector<std::uint8_t> ad = password_slot_prefix(slot);
+    Secret data_key(VaultCrypto::kKeyBytes);
+    bool ok = false;
+    kek.with_read_access([&](std::span<const char> k) {
+      data_key.with_write_access([&](std::span<char> out) {
+        unsigned long long out_len = 0;
+        ok = crypto_aead_xchacha20poly1305_ietf_decrypt(
+                 reinterpret_cast<std::uint8_t*>(out.data()), &out_len, nullptr,
+                 slot.wrapped.data() + kWrapNonceBytes, slot.wrapped.size() - kWrapNonceBytes,
+                 ad.data(), ad.size(), slot.wrapped.data(), key_bytes(k)) == 0 &&
+             out_len == out.size();
+      });
+    });
+    if (ok) {
+      return data_key;
+    }
+  }
+  if (!label.empty() && find_slot(label) == nullptr) {
+    throw std::runtime_error("Vault has no key slot named '" + std::string(label) + "'");
+  }
+  throw std::runtime_error("Decryption failed (incorrect password or corrupted vault)");
+}
+
+Secret SlottedVault::unlock(const X25519KeyPair& identity) const {
+  PWLEDGER_TRACE_SPAN("SlottedVault::unlock_key");
+
+  const auto it = std::find_if(slots_.begin(), slots_.end(), [&](const KeySlot& s) {
+    return s.type == KeySlot::Type::kPublicKey && s.public_key == identity.public_key;
+  });
+  if (it == slots_.end()) {
+    throw std::runtime_error("Vault has no key slot for this key (" + public_key_to_hex(identity.public_key) + ")");
+  }
+  Secret data_key(VaultCrypto::kKeyBytes);
+  bool ok = false;
+  identity.secret_key.with_read_access([&](std::span<const char> sk) {
+    data_key.with_write_access([&](std::span<char> out) {
+      ok = crypto_box_seal_open(reinterpret_cast<std::uint8_t*>(out.data()), it->wrapped.data(), it->wrapped.size(),
+                                identity.public_key.data(), key_bytes(sk)) == 0;
+    });
+  });
+  if (!ok) {
+    throw std::runtime_error("Key slot '" + it->label + "' does not open with this key");
+  }
+  return data_key;
+}
+
+// ----------------------------------------------------------------------------
+// Payload
+// ----------------------------------------------------------------------------
+
+std::vector<std::uint8_t> SlottedVault::decrypt(const Secret& data_key) const {
+  trace::Span span("SlottedVault::decrypt");
+  span.arg("bytes", payload_.size());
+  if (suite_ == CipherSuite::kAes256Gcm && !(sodium_init_once() && crypto_aead_aes256gcm_is_available() != 0)) {
+    throw std::runtime_error(
+        "Vault is encrypted with AES-256-GCM, which this CPU does not support; "
+        "open and save it on a machine with AES support to convert it to XChaCha20-Poly1305");
+  }
+
+  std::uint8_t ad[kPayloadAdBytes];
+  std::memcpy(ad, VaultCrypto::kMagic, sizeof(VaultCrypto::kMagic));
+  ad[kVersionOffset] = kFormatVersion;
+  ad[kSuiteOffset] = static_cast<std::uint8_t>(suite_);
+
+  const std::size_t nonce_len = VaultCrypto::nonce_bytes(suite_);
+  const std::uint8_t* nonce = payload_.data();
+  const std::uint8_t* ciphertext = payload_.data() + nonce_len;
+  const std::size_t ciphertext_len = payload_.size() - nonce_len;
+  std::vector<std::uint8_t> plaintext(ciphertext_len - VaultCrypto::kTagBytes);
+  unsigned long long plaintext_len = 0;
+  bool ok = false;
+  data_key.with_read_access([&](std::span<const char> k) {
+    const int rc = suite_ == CipherSuite::kAes256Gcm
+                       ? crypto_aead_aes256gcm_decrypt(plaintext.data(), &plaintext_len, nullptr, ciphertext,
+                                                       ciphertext_len, ad, sizeof(ad), nonce, key_bytes(k))
+                       : crypto_aead_xchacha20poly1305_ietf_decrypt(plaintext.data(), &plaintext_len, nullptr,
+                                                                    ciphertext, ciphertext_len, ad, sizeof(ad), nonce,
+                                                                    key_bytes(k));
+    ok = rc == 0;
+  });
+  if (!ok) {
+    throw std::runtime_error("Decryption failed (wrong data key or corrupted vault)");
+  }
+  plaintext.resize(plaintext_len);
+  return plaintext;
+}
+
+void SlottedVault::reseal(const Secret& data_key, const std::vector<std::uint8_t>& plaintext, CipherSuite suite) {
+  trace::Span span("SlottedVault::reseal");
+  span.arg("bytes", plaintext.size());
+  check_suite_available(suite);
+
+  std::uint8_t ad[kPayloadAdBytes];
+  std::memcpy(ad, VaultCrypto::kMagic, sizeof(VaultCrypto::kMagic));
+  ad[kVersionOffset] = kFormatVersion;
+  ad[kSuiteOffset] = static_cast<std::uint8_t>(suite);
+
+  const std::size_t nonce_len = VaultCrypto::nonce_bytes(suite);
+  std::vector<std::uint8_t> payload(nonce_len + plaintext.size() + VaultCrypto::kTagBytes);
+  randombytes_buf(payload.data(), nonce_len);
+  unsigned long long ciphertext_len = 0;
+  data_key.with_read_access([&](std::span<const char> k) {
+    std::uint8_t* out = payload.data() + nonce_len;
+    const int rc = suite == CipherSuite::kAes256Gcm
+                       ? crypto_aead_aes256gcm_encrypt(out, &ciphertext_len, plaintext.data(), plaintext.size(), ad,
+                                                       sizeof(ad), nullptr, payload.data(), key_bytes(k))
+                       : crypto_aead_xchacha20poly1305_ietf_encrypt(out, &ciphertext_len, plaintext.data(),
+                                                                    plaintext.size(), ad, sizeof(ad), nullptr,
+                                                                    payload.data(), key_bytes(k));
+    if (rc != 0) {
+      throw std::runtime_error("Encryption failed");
+    }
+  });
+  payload.resize(nonce_len + ciphertext_len);
+  payload_ = std::move(payload);
+  suite_ = suite;
+}
+
+// ----------------------------------------------------------------------------
+// Slot table
+// ----------------------------------------------------------------------------
+
+void SlottedVault::check_new_label(const std::string& label) const {
+  if (label.empty() || label.size() > kMaxLabelBytes) {
+    throw std::invalid_argument("key slot label must be 1 to " + std::to_string(kMaxLabelBytes) + " bytes");
+  }
+  if (find_slot(label) != nullptr) {
+    throw std::invalid_argument("a key slot named '" + label + "' already exists");
+  }
+  if (slots_.size() == kMaxSlots) {
+    throw std::invalid_argument("the vault already has " + std::to_string(kMaxSlots) + " key slots");
+  }
+}
+
+void SlottedVault::add_password_slot(const Secret& data_key, std::string label, std::string_view password,
+                                     const KdfParams& kdf) {
+  PWLEDGER_TRACE_SPAN("SlottedVault::add_password_slot");
+  check_new_label(label);
+  const auto password_slots = std::count_if(
+      slots_.begin(), slots_.end(), [](const KeySlot& s) { return s.type == KeySlot::Type::kPassword; });
+  if (static_cast<std::size_t>(password_slots) == kMaxPasswordSlots) {
+    throw std::invalid_argument("the vault already has " + std::to_string(kMaxPasswordSlots) + " password slots");
+  }
+
+  KeySlot slot;
+  slot.type = KeySlot::Type::kPassword;
+  slot.label = std::move(label);
+  slot.kdf = kdf;
+  slot.kdf.memlimit -= slot.kdf.memlimit % 1024u;  // recorded in KiB, as in VaultCrypto
+  VaultCrypto::check_kdf_params(slot.kdf);
+  randombytes_buf(slot.salt.data(), slot.salt.size());
+
+  const Secret kek = VaultCrypto::derive_master_key(password, slot.salt.data(), slot.kdf);
+  const std::vector<std::uint8_t> ad = password_slot_prefix(slot);
+  slot.wrapped.resize(kPasswordWrapBytes);
+  randombytes_buf(slot.wrapped.data(), kWrapNonceBytes);
+  kek.with_read_access([&](std::span<const char> k) {
+    data_key.with_read_access([&](std::span<const char> dk) {
+      crypto_aead_xchacha20poly1305_ietf_encrypt(slot.wrapped.data() + kWrapNonceBytes, nullptr, key_bytes(dk),
+                                                 dk.size(), ad.data(), ad.size(), nullptr, slot.wrapped.data(),
+                                                 key_bytes(k));
+    });
+  });
+  slots_.push_back(std::move(slot));
+}
+
+void SlottedVault::add_public_key_slot(const Secret& data_key, std::string label, const X25519PublicKey& recipient) {
+  check_new_label(label);
+
+  KeySlot slot;
+  slot.type = KeySlot::Type::kPublicKey;
+  slot.label = std::move(label);
+  slot.public_key = recipient;
+  slot.wrapped.resize(kSealedBytes);
+  bool ok = false;
+  data_key.with_read_access([&](std::span<const char> dk) {
+    ok = crypto_box_seal(slot.wrapped.data(), key_bytes(dk), dk.size(), recipient.data()) == 0;
+  });
+  if (!ok) {
+    throw std::invalid_argument("not a usable X25519 public key");
+  }
+  slots_.push_back(std::move(slot));
+}
+
+bool SlottedVault::remove_slot(std::string_view label) {
+  const auto it = std::find_if(slots_.begin(), slots_.end(), [&](const KeySlot& s) { return s.label == label; });
+  if (it == slots_.end()) {
+    return false;
+  }
+  if (slots_.size() == 1) {
+    throw std::invalid_argument("refusing to remove the last key slot; the vault could not be opened again");
+  }
+  slots_.erase(it);
+  return true;
+}
+
+std::vector<std::uint8_t> SlottedVault::serialize() const {
+  if (slots_.empty()) {
+    throw std::logic_error("a key-slot vault needs at least one slot");
+  }
+  std::vector<std::uint8_t> out(VaultCrypto::kMagic, VaultCrypto::kMagic + sizeof(VaultCrypto::kMagic));
+  out.push_back(kFormatVersion);
+  out.push_back(static_cast<std::uint8_t>(suite_));
+  out.push_back(static_cast<std::uint8_t>(slots_.size()));
+  for (const KeySlot& slot : slots_) {
+    if (slot.type == KeySlot::Type::kPassword) {
+      const std::vector<std::uint8_t> prefix = password_slot_prefix(slot);
+      out.insert(out.end(), prefix.begin(), prefix.end());
+    } else {
+      out.push_back(static_cast<std::uint8_t>(slot.type));
+      out.push_back(static_cast<std::uint8_t>(slot.label.size()));
+      out.insert(out.end(), slot.label.begin(), slot.label.end());
+      out.insert(out.end(), slot.public_key.begin(), slot.public_key.end());
+    }
+    out.insert(out.end(), slot.wrapped.begin(), slot.wrapped.end());
+  }
+  out.insert(out.end(), payload_.begin(), payload_.end());
+  return out;
+}
+
+}  // namespace pwledger
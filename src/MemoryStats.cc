@@ -0,0 +1,239 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pwledger/MemoryStats.h>
+
+#include <atomic>
+#include <fstream>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace pwledger {
+
+namespace {
+
+// libsodium prepends a 16-byte canary to the user region (see
+// _sodium_malloc in sodium/utils.c).
+constexpr std::size_t kCanaryBytes = 16;
+
+std::atomic<std::uint64_t> g_live{0};
+std::atomic<std::uint64_t> g_total{0};
+std::atomic<std::uint64_t> g_requested{0};
+std::atomic<std::uint64_t> g_mapped{0};
+std::atomic<std::uint64_t> g_guard{0};
+std::atomic<std::uint64_t> g_locked{0};
+std::atomic<std::uint64_t> g_peak_mapped{0};
+
+std::size_t page_size() noexcept {
+  static const std::size_t size = [] {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return static_cast<std::size_t>(info.dwPageSize);
+#else
+    const long v = ::sysconf(_SC_PAGESIZE);
+    return v > 0 ? static_cast<std::size_t>(v) : std::size_t{4096};
+#endif
+  }();
+  return size;
+}
+
+// Heap bytes behind a std::string, or 0 while it fits the small-string
+// buffer. +1 for the terminator the allocation always includes.
+std::uint64_t heap_bytes(const std::string& s) noexcept {
+  static const std::size_t sso_capacity = std::string().capacity();
+  return s.capacity() > sso_capacity ? s.capacity() + 1 : 0;
+}
+
+#ifndef _WIN32
+// Reads the kB value of `key` from /proc/self/status, e.g. "VmLck:".
+std::optional<std::uint64_t> proc_status_kib(const std::string& key) {
+  std::ifstream in("/proc/self/status");
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.compare(0, key.size(), key) == 0) {
+      try {
+        return std::stoull(line.substr(key.size()));
+      } catch (const std::exception&) {
+        return std::nullopt;
+      }
+    }
+  }
+  return std::nullopt;
+}
+#endif
+
+void put(nlohmann::json& j, const char* key, const std::optional<std::uint64_t>& value) {
+  if (value) {
+    j[key] = *value;
+  }
+}
+
+}  // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// SecureMemoryStats
+// ----------------------------------------------------------------------------
+
+SecureAllocationLayout secure_allocation_layout(std::size_t requested) noexcept {
+  const std::size_t page = page_size();
+  const std::size_t unprotected = (requested + kCanaryBytes + page - 1) / page * page;
+
+  SecureAllocationLayout layout;
+  layout.mapped = 3 * page + unprotected;  // guard + header + data + guard
+  layout.guard = 2 * page;
+  layout.locked = unprotected;
+  return layout;
+}
+
+SecureMemoryStats secure_memory_stats() noexcept {
+  SecureMemoryStats s;
+  s.live_allocations = g_live.load(std::memory_order_relaxed);
+  s.total_allocations = g_total.load(std::memory_order_relaxed);
+  s.requested_bytes = g_requested.load(std::memory_order_relaxed);
+  s.mapped_bytes = g_mapped.load(std::memory_order_relaxed);
+  s.guard_bytes = g_guard.load(std::memory_order_relaxed);
+  s.locked_bytes = g_locked.load(std::memory_order_relaxed);
+  s.peak_mapped_bytes = g_peak_mapped.load(std::memory_order_relaxed);
+  return s;
+}
+
+namespace details {
+
+void note_secure_alloc(std::size_t size) noexcept {
+  const SecureAllocationLayout layout = secure_allocation_layout(size);
+  g_live.fetch_add(1, std::memory_order_relaxed);
+  g_total.fetch_add(1, std::memory_order_relaxed);
+  g_requested.fetch_add(size, std::memory_order_relaxed);
+  g_guard.fetch_add(layout.guard, std::memory_order_relaxed);
+  g_locked.fetch_add(layout.locked, std::memory_order_relaxed);
+
+  const std::uint64_t mapped = g_mapped.fetch_add(layout.mapped, std::memory_order_relaxed) + layout.mapped;
+  std::uint64_t peak = g_peak_mapped.load(std::memory_order_relaxed);
+  while (mapped > peak && !g_peak_mapped.compare_exchange_weak(peak, mapped, std::memory_order_relaxed)) {
+  }
+}
+
+void note_secure_free(std::size_t size) noexcept {
+  const SecureAllocationLayout layout = secure_allocation_layout(size);
+  g_live.fetch_sub(1, std::memory_order_relaxed);
+  g_requested.fetch_sub(size, std::memory_order_relaxed);
+  g_mapped.fetch_sub(layout.mapped, std::memory_order_relaxed);
+  g_guard.fetch_sub(layout.guard, std::memory_order_relaxed);
+  g_locked.fetch_sub(layout.locked, std::memory_order_relaxed);
+}
+
+}  // namespace details
+
+// ----------------------------------------------------------------------------
+// TableMemoryStats
+// ----------------------------------------------------------------------------
+
+TableMemoryStats measure_table(const PrimaryTable& table) noexcept {
+  TableMemoryStats s;
+  s.entries = table.size();
+  for (const auto& [uuid, entry] : table) {
+    s.secret_buffer_bytes += entry.plaintext_secret.size() + entry.salt.size();
+    for (const std::string* field : {&entry.primary_key, &entry.username_or_email, &entry.security_policy.note}) {
+      s.string_bytes += field->size();
+      s.string_heap_bytes += heap_bytes(*field);
+    }
+  }
+
+  // Node-based hash map: one heap node per entry holding the value, the
+  // next pointer and (usually) the cached hash, plus the bucket array.
+  const std::uint64_t node = sizeof(PrimaryTable::value_type) + 2 * sizeof(void*);
+  s.table_bytes = s.entries * node + table.bucket_count() * sizeof(void*);
+  return s;
+}
+
+// ----------------------------------------------------------------------------
+// ProcessMemoryStats
+// ----------------------------------------------------------------------------
+
+ProcessMemoryStats process_memory_stats() {
+  ProcessMemoryStats s;
+#ifndef _WIN32
+  if (const auto kib = proc_status_kib("VmLck:")) {
+    s.locked_bytes = *kib * 1024;
+  }
+
+  struct rlimit limit {};
+  if (::getrlimit(RLIMIT_MEMLOCK, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY) {
+    s.memlock_limit = static_cast<std::uint64_t>(limit.rlim_cur);
+  }
+
+  std::ifstream maps("/proc/self/maps");
+  if (maps) {
+    std::uint64_t lines = 0;
+    std::string line;
+    while (std::getline(maps, line)) {
+      ++lines;
+    }
+    s.map_count = lines;
+  }
+
+  std::ifstream max_maps("/proc/sys/vm/max_map_count");
+  std::uint64_t max_map_count = 0;
+  if (max_maps >> max_map_count) {
+    s.max_map_count = max_map_count;
+  }
+#endif
+  return s;
+}
+
+// ----------------------------------------------------------------------------
+// JSON
+// ----------------------------------------------------------------------------
+
+nlohmann::json memory_stats_json(const PrimaryTable* table) {
+  const SecureMemoryStats secure = secure_memory_stats();
+  nlohmann::json j;
+  j["secure"] = {
+      {"live_allocations", secure.live_allocations}, {"total_allocations", secure.total_allocations},
+      {"requested_bytes", secure.requested_bytes},   {"mapped_bytes", secure.mapped_bytes},
+      {"guard_bytes", secure.guard_bytes},           {"locked_bytes", secure.locked_bytes},
+      {"peak_mapped_bytes", secure.peak_mapped_bytes},
+  };
+
+  if (table != nullptr) {
+    const TableMemoryStats t = measure_table(*table);
+    j["table"] = {
+        {"entries", t.entries},           {"secret_buffer_bytes", t.secret_buffer_bytes},
+        {"string_bytes", t.string_bytes}, {"string_heap_bytes", t.string_heap_bytes},
+        {"table_bytes", t.table_bytes},
+    };
+  }
+
+  const ProcessMemoryStats process = process_memory_stats();
+  nlohmann::json p = nlohmann::json::object();
+  put(p, "locked_bytes", process.locked_bytes);
+  put(p, "memlock_limit", process.memlock_limit);
+  put(p, "map_count", process.map_count);
+  put(p, "max_map_count", process.max_map_count);
+  j["process"] = std::move(p);
+  return j;
+}
+
+}  // namespace pwledger
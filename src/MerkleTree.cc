@@ -0,0 +1,380 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pwledger/MerkleTree.h>
+
+#include <pwledger/Kernels.h>
+#include <pwledger/Trace.h>
+#include <pwledger/VaultSerializer.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include <sodium.h>
+
+namespace pwledger {
+
+namespace {
+
+using Key = std::array<std::uint8_t, 16>;
+
+constexpr std::size_t kMaxDepth = 2 * std::tuple_size_v<Key>;  // nibbles in a Key
+constexpr MerkleTree::Hash kEmptyHash{};
+
+constexpr std::uint8_t kMagic[4] = {'P', 'W', 'L', 'M'};
+constexpr std::uint8_t kVersion = 1;
+constexpr std::size_t kHeaderBytes = sizeof(kMagic) + 1 + 8;
+constexpr std::size_t kRecordBytes = 16 + std::tuple_size_v<MerkleTree::Hash>;
+
+Key key_of(const Uuid& uuid) {
+  Key key;
+  crypto_generichash(key.data(), key.size(), uuid.bytes.data(), uuid.bytes.size(), nullptr, 0);
+  return key;
+}
+
+std::size_t nibble(const Key& key, std::size_t depth) noexcept {
+  const std::uint8_t byte = key[depth / 2];
+  return static_cast<std::size_t>(depth % 2 == 0 ? byte >> 4 : byte & 0x0f);
+}
+
+// hash_entry with a caller-owned buffer, so of() serializes every entry
+// into the same allocation. The buffer is wiped before returning.
+MerkleTree::Hash hash_entry_with(std::vector<std::uint8_t>& scratch, const Uuid& uuid, const SecretEntry& entry) {
+  // Sized up front: a reallocation would leave a copy of the secret behind.
+  scratch.clear();
+  scratch.reserve(96 + entry.primary_key.size() + entry.username_or_email.size() + entry.plaintext_secret.size() +
+                  entry.salt.size() + entry.security_policy.note.size());
+  VaultSerializer::write_entry(scratch, uuid, entry);
+  MerkleTree::Hash hash;
+  crypto_generichash(hash.data(), hash.size(), scratch.data(), scratch.size(), nullptr, 0);
+  kernels::secure_zero(scratch.data(), scratch.size());
+  return hash;
+}
+
+}  // namespace
+
+// ============================================================================
+// Nodes
+// ============================================================================
+
+struct MerkleTree::Leaf {
+  Key key;
+  Uuid uuid;
+  Hash hash;
+};
+
+struct MerkleTree::Node {
+  std::size_t count = 0;  // leaves under this node
+  bool split = false;
+  bool stale = true;
+  Hash hash{};
+  std::vector<Leaf> bucket;                        // sorted by key, while not split
+  std::array<std::unique_ptr<Node>, 16> children;  // once split
+
+  static bool key_less(const Leaf& leaf, const Key& key) noexcept { return leaf.key < key; }
+
+  // Returns whether `leaf` is new under this node.
+  bool insert(Leaf leaf, std::size_t depth) {
+    stale = true;
+    if (!split) {
+      const auto it = std::lower_bound(bucket.begin(), bucket.end(), leaf.key, key_less);
+      if (it != bucket.end() && it->key == leaf.key) {
+        it->hash = leaf.hash;
+        return false;
+      }
+      bucket.insert(it, std::move(leaf));
+      ++count;
+      if (count > kBucketSize && depth < kMaxDepth) {
+        split_at(depth);
+      }
+      return true;
+    }
+    auto& child = children[nibble(leaf.key, depth)];
+    if (!child) {
+      child = std::make_unique<Node>();
+    }
+    const bool added = child->insert(std::move(leaf), depth + 1);
+    if (added) {
+      ++count;
+    }
+    return added;
+  }
+
+  void split_at(std::size_t depth) {
+    split = true;
+    for (Leaf& leaf : bucket) {
+      auto& child = children[nibble(leaf.key, depth)];
+      if (!child) {
+        child = std::make_unique<Node>();
+      }
+      child->insert(std::move(leaf), depth + 1);
+    }
+    bucket.clear();
+    bucket.shrink_to_fit();
+  }
+
+  bool erase(const Key& key, std::size_t depth) {
+    if (!split) {
+      const auto it = std::lower_bound(bucket.begin(), bucket.end(), key, key_less);
+      if (it == bucket.end() || it->key != key) {
+        return false;
+      }
+      bucket.erase(it);
+      --count;
+      stale = true;
+      return true;
+    }
+    auto& child = children[nibble(key, depth)];
+    if (!child || !child->erase(key, depth + 1)) {
+      return false;
+    }
+    --count;
+    stale = true;
+    if (child->count == 0) {
+      child.reset();
+    }
+    if (count <= kBucketSize) {
+      // Back to a bucket, so the shape stays a function of the key set.
+      std::vector<Leaf> leaves;
+      leaves.reserve(count);
+      append_to(leaves);
+      children = {};
+      split = false;
+      bucket = std::move(leaves);
+    }
+    return true;
+  }
+
+  void append_to(std::vector<Leaf>& out) const {
+    if (!split) {
+      out.insert(out.end(), bucket.begin(), bucket.end());
+      return;
+    }
+    for (const auto& child : children) {
+      if (child) {
+        child->append_to(out);
+      }
+    }
+  }
+
+  void collect(std::vector<const Leaf*>& out) const {
+    if (!split) {
+      for (const Leaf& leaf : bucket) {
+        out.push_back(&leaf);
+      }
+      return;
+    }
+    for (const auto& child : children) {
+      if (child) {
+        child->collect(out);
+      }
+    }
+  }
+
+  const Leaf* find(const Key& key, std::size_t depth) const {
+    if (!split) {
+      const auto it = std::lower_bound(bucket.begin(), bucket.end(), key, key_less);
+      return it != bucket.end() && it->key == key ? &*it : nullptr;
+    }
+    const auto& child = children[nibble(key, depth)];
+    return child ? child->find(key, depth + 1) : nullptr;
+  }
+
+  // Recomputes stale hashes below and including this node.
+  const Hash& update() {
+    if (!stale) {
+      return hash;
+    }
+    if (count == 0) {
+      hash = kEmptyHash;
+    } else {
+      crypto_generichash_state st;
+      crypto_generichash_init(&st, nullptr, 0, hash.size());
+      const auto tag = static_cast<std::uint8_t>(split ? 'I' : 'L');
+      crypto_generichash_update(&st, &tag, 1);
+      if (!split) {
+        for (const Leaf& leaf : bucket) {
+          crypto_generichash_update(&st, leaf.uuid.bytes.data(), leaf.uuid.bytes.size());
+          crypto_generichash_update(&st, leaf.hash.data(), leaf.hash.size());
+        }
+      } else {
+        for (const auto& child : children) {
+          const Hash& h = child ? child->update() : kEmptyHash;
+          crypto_generichash_update(&st, h.data(), h.size());
+        }
+      }
+      crypto_generichash_final(&st, hash.data(), hash.size());
+    }
+    stale = false;
+    return hash;
+  }
+
+  // Two nodes at the same prefix, either possibly absent.
+  static void diff(Node* ours, Node* theirs, std::vector<Change>& out, std::size_t& visits) {
+    ++visits;
+    const Hash& a = ours != nullptr ? ours->update() : kEmptyHash;
+    const Hash& b = theirs != nullptr ? theirs->update() : kEmptyHash;
+    if (a == b) {
+      return;
+    }
+    if (ours != nullptr && theirs != nullptr && ours->split && theirs->split) {
+      for (std::size_t i = 0; i < 16; ++i) {
+        diff(ours->children[i].get(), theirs->children[i].get(), out, visits);
+      }
+      return;
+    }
+
+    // At least one side is a bucket, so the other holds at most kBucketSize
+    // entries more than the number that differ: compare them directly.
+    std::vector<const Leaf*> left, right;
+    if (ours != nullptr) {
+      ours->collect(left);
+    }
+    if (theirs != nullptr) {
+      theirs->collect(right);
+    }
+    std::size_t i = 0, j = 0;
+    while (i < left.size() || j < right.size()) {
+      if (j == right.size() || (i < left.size() && left[i]->key < right[j]->key)) {
+        out.push_back({left[i]->uuid, left[i]->hash, std::nullopt});
+        ++i;
+      } else if (i == left.size() || right[j]->key < left[i]->key) {
+        out.push_back({right[j]->uuid, std::nullopt, right[j]->hash});
+        ++j;
+      } else {
+        if (left[i]->hash != right[j]->hash) {
+          out.push_back({left[i]->uuid, left[i]->hash, right[j]->hash});
+        }
+        ++i;
+        ++j;
+      }
+    }
+  }
+};
+
+// ============================================================================
+// MerkleTree
+// ============================================================================
+
+MerkleTree::MerkleTree() : root_(std::make_unique<Node>()) {}
+MerkleTree::~MerkleTree() = default;
+MerkleTree::MerkleTree(MerkleTree&&) noexcept = default;
+MerkleTree& MerkleTree::operator=(MerkleTree&&) noexcept = default;
+
+MerkleTree MerkleTree::of(const PrimaryTable& table) {
+  trace::Span span("MerkleTree::of");
+  span.arg("entries", table.size());
+
+  MerkleTree tree;
+  std::vector<std::uint8_t> scratch;
+  for (const auto& [uuid, entry] : table) {
+    tree.set(uuid, hash_entry_with(scratch, uuid, entry));
+  }
+  return tree;
+}
+
+MerkleTree::Hash MerkleTree::hash_entry(const Uuid& uuid, const SecretEntry& entry) {
+  std::vector<std::uint8_t> scratch;
+  return hash_entry_with(scratch, uuid, entry);
+}
+
+void MerkleTree::set(const Uuid& uuid, const Hash& hash) {
+  root_->insert(Leaf{key_of(uuid), uuid, hash}, 0);
+}
+
+bool MerkleTree::erase(const Uuid& uuid) {
+  return root_->erase(key_of(uuid), 0);
+}
+
+std::optional<MerkleTree::Hash> MerkleTree::find(const Uuid& uuid) const {
+  const Leaf* leaf = root_->find(key_of(uuid), 0);
+  return leaf != nullptr ? std::optional<Hash>(leaf->hash) : std::nullopt;
+}
+
+std::size_t MerkleTree::size() const noexcept {
+  return root_->count;
+}
+
+MerkleTree::Hash MerkleTree::root() const {
+  return root_->update();
+}
+
+std::vector<MerkleTree::Change> MerkleTree::diff(const MerkleTree& other) const {
+  trace::Span span("MerkleTree::diff");
+  std::vector<Change> changes;
+  last_diff_visits_ = 0;
+  Node::diff(root_.get(), other.root_.get(), changes, last_diff_visits_);
+  span.arg("changes", changes.size());
+  span.arg("visits", last_diff_visits_);
+  return changes;
+}
+
+// ----------------------------------------------------------------------------
+// Serialization
+// ----------------------------------------------------------------------------
+//   [ "PWLM" ] [ version (1) = 1 ] [ count (u64 LE) ] then count times
+//   [ UUID (16) ] [ entry hash (32) ], in trie order.
+
+std::vector<std::uint8_t> MerkleTree::serialize() const {
+  std::vector<const Leaf*> leaves;
+  leaves.reserve(size());
+  root_->collect(leaves);
+
+  std::vector<std::uint8_t> out(kMagic, kMagic + sizeof(kMagic));
+  out.reserve(kHeaderBytes + leaves.size() * kRecordBytes);
+  out.push_back(kVersion);
+  const auto count = static_cast<std::uint64_t>(leaves.size());
+  for (int i = 0; i < 8; ++i) {
+    out.push_back(static_cast<std::uint8_t>(count >> (8 * i)));
+  }
+  for (const Leaf* leaf : leaves) {
+    out.insert(out.end(), leaf->uuid.bytes.begin(), leaf->uuid.bytes.end());
+    out.insert(out.end(), leaf->hash.begin(), leaf->hash.end());
+  }
+  return out;
+}
+
+MerkleTree MerkleTree::parse(const std::uint8_t* data, std::size_t size) {
+  if (size < kHeaderBytes || std::memcmp(data, kMagic, sizeof(kMagic)) != 0) {
+    throw std::runtime_error("Not a sync manifest");
+  }
+  if (data[sizeof(kMagic)] != kVersion) {
+    throw std::runtime_error("Unsupported sync manifest version");
+  }
+  std::uint64_t count = 0;
+  for (std::size_t i = 8; i > 0; --i) {
+    count = (count << 8) | data[sizeof(kMagic) + i];
+  }
+  if (count != (size - kHeaderBytes) / kRecordBytes || (size - kHeaderBytes) % kRecordBytes != 0) {
+    throw std::runtime_error("Sync manifest is truncated or has trailing bytes");
+  }
+
+  MerkleTree tree;
+  for (const std::uint8_t* p = data + kHeaderBytes; p != data + size; p += kRecordBytes) {
+    Uuid uuid;
+    std::memcpy(uuid.bytes.data(), p, uuid.bytes.size());
+    Hash hash;
+    std::memcpy(hash.data(), p + uuid.bytes.size(), hash.size());
+    tree.set(uuid, hash);
+  }
+  return tree;
+}
+
+}  // namespace pwledger
@@ -18,7 +18,8 @@
 
 #include <pwledger/ProcessHardening.h>
 
-#include <iostream>
+// stdio rather than iostream: this runs on every native host cold start.
+#include <cstdio>
 
 #ifdef __linux__
 #  include <sys/prctl.h>
@@ -61,8 +62,9 @@ void harden_process() noexcept {
   // We log the failure and continue rather than aborting: the application
   // remains functional, just with reduced hardening.
   if (prctl(PR_SET_DUMPABLE, 0) != 0) {
-    std::cerr << "Warning: prctl(PR_SET_DUMPABLE, 0) failed; "
-                 "core dumps may capture secrets\n";
+    std::fputs("Warning: prctl(PR_SET_DUMPABLE, 0) failed; "
+               "core dumps may capture secrets\n",
+               stderr);
   }
 
   // setrlimit(RLIMIT_CORE, {0, 0}) provides a belt-and-suspenders layer on
@@ -78,8 +80,9 @@ void harden_process() noexcept {
   // would allow the process to raise it back to the hard limit later.
   const rlimit no_core{0, 0};
   if (setrlimit(RLIMIT_CORE, &no_core) != 0) {
-    std::cerr << "Warning: setrlimit(RLIMIT_CORE, {0,0}) failed; "
-                 "core file size limit not enforced\n";
+    std::fputs("Warning: setrlimit(RLIMIT_CORE, {0,0}) failed; "
+               "core file size limit not enforced\n",
+               stderr);
   }
 #endif
 
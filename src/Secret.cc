@@ -18,6 +18,8 @@
 
 #include <pwledger/Secret.h>
 
+#include <pwledger/MemoryStats.h>
+
 #include <cstdlib>
 
 namespace pwledger {
@@ -53,6 +55,7 @@ Secret& Secret::operator=(Secret&& other) noexcept {
 #endif
     // sodium_free zeros before freeing, satisfying the wipe requirement.
     if (data_) {
+      details::note_secure_free(size_);
       sodium_free(data_);
     }
     data_ = other.data_;
@@ -66,16 +69,21 @@ Secret& Secret::operator=(Secret&& other) noexcept {
   return *this;
 }
 
-void Secret::zeroize() noexcept {
+void Secret::zeroize(std::source_location site) noexcept {
   if (data_) {
     // Temporarily open for writing; sodium_memzero; re-lock.
+    secret_profile::Window window(site);
+    window.before_open();
     if (sodium_mprotect_readwrite(data_) != 0) {
       std::abort();
     }
+    window.opened();
     sodium_memzero(data_, size_);
+    window.before_close();
     if (sodium_mprotect_noaccess(data_) != 0) {
       std::abort();
     }
+    window.closed(secret_profile::Access::kWrite);
   }
 }
 
@@ -86,10 +94,15 @@ void Secret::allocate(std::size_t size) {
     std::abort();
   }  // see FAILURE MODEL in file header
   size_ = size;
+  details::note_secure_alloc(size);
   // Buffer starts life locked. Every access must go through a guard.
+  const std::uint64_t start_ns = secret_profile::kEnabled ? secret_profile::detail::now_ns() : 0;
   if (sodium_mprotect_noaccess(data_) != 0) {
     std::abort();
   }
+  if constexpr (secret_profile::kEnabled) {
+    secret_profile::detail::record_mprotect(secret_profile::detail::now_ns() - start_ns);
+  }
 }
 
 void Secret::wipe_and_free() noexcept {
@@ -97,6 +110,7 @@ void Secret::wipe_and_free() noexcept {
     // sodium_free handles zeroing internally. Do not call sodium_memzero
     // here; the buffer is in NOACCESS state and an extra mprotect_readwrite
     // + memzero before sodium_free would be redundant.
+    details::note_secure_free(size_);
     sodium_free(data_);
     data_ = nullptr;
     size_ = 0;
@@ -105,13 +119,16 @@ void Secret::wipe_and_free() noexcept {
 
 namespace details {
 
-Secret_readaccess::Secret_readaccess(const Secret& s) : sec_(s) {
+Secret_readaccess::Secret_readaccess(const Secret& s, std::source_location site)
+    : sec_(s)
+    , window_(site) {
 #ifndef NDEBUG
   int prev = s.access_count_.fetch_add(1, std::memory_order_relaxed);
   assert(prev == 0 &&
          "Overlapping access guards on the same Secret are undefined behavior. "
          "See ACCESS GUARD RULES in Secret.h.");
 #endif
+  window_.before_open();
   if (sodium_mprotect_readonly(sec_.data_) != 0) {
     // mprotect failure means we cannot safely read the secret.
     // Abort rather than silently continuing with an unlocked buffer or,
@@ -121,39 +138,48 @@ Secret_readaccess::Secret_readaccess(const Secret& s) : sec_(s) {
 #endif
     std::abort();
   }
+  window_.opened();
 }
 
 Secret_readaccess::~Secret_readaccess() noexcept {
   // Re-locking in the destructor must not throw or fail silently.
   // If sodium_mprotect_noaccess fails here, the buffer is permanently
   // unlocked, which is a security violation. Abort.
+  window_.before_close();
   if (sodium_mprotect_noaccess(sec_.data_) != 0) {
     std::abort();
   }
+  window_.closed(secret_profile::Access::kRead);
 #ifndef NDEBUG
   sec_.access_count_.fetch_sub(1, std::memory_order_relaxed);
 #endif
 }
 
-Secret_writeaccess::Secret_writeaccess(Secret& s) : sec_(s) {
+Secret_writeaccess::Secret_writeaccess(Secret& s, std::source_location site)
+    : sec_(s)
+    , window_(site) {
 #ifndef NDEBUG
   int prev = s.access_count_.fetch_add(1, std::memory_order_relaxed);
   assert(prev == 0 &&
          "Overlapping access guards on the same Secret are undefined behavior. "
          "See ACCESS GUARD RULES in Secret.h.");
 #endif
+  window_.before_open();
   if (sodium_mprotect_readwrite(sec_.data_) != 0) {
 #ifndef NDEBUG
     sec_.access_count_.fetch_sub(1, std::memory_order_relaxed);
 #endif
     std::abort();
   }
+  window_.opened();
 }
 
 Secret_writeaccess::~Secret_writeaccess() noexcept {
+  window_.before_close();
   if (sodium_mprotect_noaccess(sec_.data_) != 0) {
     std::abort();
   }
+  window_.closed(secret_profile::Access::kWrite);
 #ifndef NDEBUG
   sec_.access_count_.fetch_sub(1, std::memory_order_relaxed);
 #endif
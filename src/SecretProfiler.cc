@@ -0,0 +1,248 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pwledger/SecretProfiler.h>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+
+namespace pwledger::secret_profile {
+
+// ----------------------------------------------------------------------------
+// HoldHistogram
+// ----------------------------------------------------------------------------
+
+void HoldHistogram::record(std::uint64_t ns) noexcept {
+  const std::size_t bucket = ns == 0 ? 0 : static_cast<std::size_t>(std::bit_width(ns) - 1);
+  ++counts[std::min(bucket, kBuckets - 1)];
+  ++total;
+  max_ns = std::max(max_ns, ns);
+}
+
+std::uint64_t HoldHistogram::quantile_ns(double q) const noexcept {
+  if (total == 0) {
+    return 0;
+  }
+  const auto rank = static_cast<std::uint64_t>(q * static_cast<double>(total - 1)) + 1;
+  std::uint64_t seen = 0;
+  for (std::size_t i = 0; i < kBuckets; ++i) {
+    seen += counts[i];
+    if (seen >= rank) {
+      return std::min(max_ns, (std::uint64_t{2} << i) - 1);
+    }
+  }
+  return max_ns;
+}
+
+namespace {
+
+// ----------------------------------------------------------------------------
+// Profile
+// ----------------------------------------------------------------------------
+// Process-wide table of call sites. A function-local static so that it is
+// constructed on first use and destroyed (and therefore reported) during
+// normal process exit; the same arrangement as the trace Recorder.
+
+struct SiteKey {
+  std::string_view file;
+  std::uint32_t line;
+  std::uint32_t column;
+
+  bool operator==(const SiteKey&) const = default;
+};
+
+struct SiteKeyHash {
+  std::size_t operator()(const SiteKey& k) const noexcept {
+    return std::hash<std::string_view>{}(k.file) ^ (std::size_t{k.line} << 16) ^ k.column;
+  }
+};
+
+class Profile {
+ public:
+  Profile() = default;
+
+  ~Profile() {
+    if constexpr (kEnabled) {
+      write_at_exit();
+    }
+  }
+
+  Profile(const Profile&) = delete;
+  Profile& operator=(const Profile&) = delete;
+
+  void record_window(const std::source_location& site, Access access, std::uint64_t hold_ns,
+                     std::uint64_t mprotect_ns) noexcept {
+    std::lock_guard lock(mutex_);
+    mprotect_calls_ += 2;
+    mprotect_ns_ += mprotect_ns;
+    try {
+      // source_location strings have static storage duration, so the key
+      // can view them without copying.
+      SiteReport& s = sites_[SiteKey{site.file_name(), site.line(), site.column()}];
+      if (s.line == 0) {
+        s.file = site.file_name();
+        s.function = site.function_name();
+        s.line = site.line();
+      }
+      ++(access == Access::kRead ? s.reads : s.writes);
+      s.mprotect_calls += 2;
+      s.mprotect_ns += mprotect_ns;
+      s.hold.record(hold_ns);
+    } catch (...) {
+      // Out of memory for a new site: the window still counts in the totals.
+    }
+  }
+
+  void record_mprotect(std::uint64_t ns) noexcept {
+    std::lock_guard lock(mutex_);
+    ++mprotect_calls_;
+    mprotect_ns_ += ns;
+  }
+
+  Report snapshot() {
+    std::lock_guard lock(mutex_);
+    Report report;
+    report.mprotect_calls = mprotect_calls_;
+    report.mprotect_ns = mprotect_ns_;
+    report.sites.reserve(sites_.size());
+    for (const auto& [key, site] : sites_) {
+      report.sites.push_back(site);
+    }
+    std::sort(report.sites.begin(), report.sites.end(), [](const SiteReport& a, const SiteReport& b) {
+      return a.reads + a.writes != b.reads + b.writes ? a.reads + a.writes > b.reads + b.writes
+                                                      : std::tie(a.file, a.line) < std::tie(b.file, b.line);
+    });
+    return report;
+  }
+
+  void reset() noexcept {
+    std::lock_guard lock(mutex_);
+    sites_.clear();
+    mprotect_calls_ = 0;
+    mprotect_ns_ = 0;
+  }
+
+ private:
+  void write_at_exit() noexcept {
+    try {
+      const Report report = snapshot();
+      if (report.mprotect_calls == 0) {
+        return;
+      }
+      const char* path = std::getenv("PWLEDGER_SECRET_PROFILE");
+      if (path == nullptr || *path == '\0' || std::strcmp(path, "-") == 0) {
+        write_report(stderr, report);
+        return;
+      }
+      std::FILE* f = std::fopen(path, "w");
+      if (f == nullptr) {
+        std::fprintf(stderr, "pwledger: could not open secret profile output %s\n", path);
+        return;
+      }
+      write_report(f, report);
+      std::fclose(f);
+    } catch (...) {
+      // A profile is a diagnostic; never fail process exit over it.
+    }
+  }
+
+  std::mutex mutex_;
+  std::unordered_map<SiteKey, SiteReport, SiteKeyHash> sites_;
+  std::uint64_t mprotect_calls_ = 0;
+  std::uint64_t mprotect_ns_ = 0;
+};
+
+Profile& profile() {
+  static Profile instance;
+  return instance;
+}
+
+// Trims a __FILE__ path to the part a reader needs: the last two components.
+std::string_view short_path(std::string_view path) {
+  const std::size_t last = path.find_last_of("/\\");
+  if (last == std::string_view::npos || last == 0) {
+    return path;
+  }
+  const std::size_t prev = path.find_last_of("/\\", last - 1);
+  return prev == std::string_view::npos ? path : path.substr(prev + 1);
+}
+
+double us(std::uint64_t ns) {
+  return static_cast<double>(ns) / 1000.0;
+}
+
+}  // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// Public API
+// ----------------------------------------------------------------------------
+
+Report snapshot() {
+  if constexpr (!kEnabled) {
+    return {};
+  }
+  return profile().snapshot();
+}
+
+void reset() noexcept {
+  if constexpr (kEnabled) {
+    profile().reset();
+  }
+}
+
+void write_report(std::FILE* out, const Report& report) {
+  std::fprintf(out, "pwledger secret access profile: %zu sites, %llu mprotect calls, %.1f us in mprotect\n",
+               report.sites.size(), static_cast<unsigned long long>(report.mprotect_calls), us(report.mprotect_ns));
+  std::fprintf(out, "%10s %10s %12s %10s %10s %10s  %s\n", "reads", "writes", "mprotect us", "hold p50", "hold p99",
+               "hold max", "site");
+  for (const SiteReport& s : report.sites) {
+    const std::string_view file = short_path(s.file);
+    std::fprintf(out, "%10llu %10llu %12.1f %10.1f %10.1f %10.1f  %.*s:%u %s\n",
+                 static_cast<unsigned long long>(s.reads), static_cast<unsigned long long>(s.writes),
+                 us(s.mprotect_ns), us(s.hold.quantile_ns(0.5)), us(s.hold.quantile_ns(0.99)), us(s.hold.max_ns),
+                 static_cast<int>(file.size()), file.data(), static_cast<unsigned>(s.line), s.function.c_str());
+  }
+}
+
+namespace detail {
+
+std::uint64_t now_ns() noexcept {
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+void record_window(const std::source_location& site, Access access, std::uint64_t hold_ns,
+                   std::uint64_t mprotect_ns) noexcept {
+  profile().record_window(site, access, hold_ns, mprotect_ns);
+}
+
+void record_mprotect(std::uint64_t ns) noexcept {
+  profile().record_mprotect(ns);
+}
+
+}  // namespace detail
+
+}  // namespace pwledger::secret_profile
@@ -0,0 +1,309 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pwledger/ThreadPool.h>
+
+#include <pwledger/Trace.h>
+
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+
+#include <sodium.h>
+
+#if defined(_MSC_VER)
+#define PWLEDGER_POOL_NOINLINE __declspec(noinline)
+#else
+#define PWLEDGER_POOL_NOINLINE __attribute__((noinline))
+#endif
+
+namespace pwledger {
+
+struct ThreadPool::Worker {
+  std::mutex mutex;
+  std::deque<Task> tasks;
+  std::thread thread;
+};
+
+namespace {
+
+constexpr std::size_t kMaxThreads = 256;
+constexpr std::size_t kMaxScrubKib = 1024;
+constexpr std::size_t kScrubFrameBytes = 4096;
+
+// The pool and worker index of the calling thread, if it is a worker.
+thread_local const ThreadPool* tls_pool = nullptr;
+thread_local std::size_t tls_index = 0;
+
+// Wipes `frames` x 4 KiB of stack below the caller. The recursive call comes
+// before the wipe so it is not a tail call, and each frame really is a new
+// 4 KiB further down.
+PWLEDGER_POOL_NOINLINE void scrub_stack(std::size_t frames) noexcept {
+  std::uint8_t frame[kScrubFrameBytes];
+  if (frames > 1) {
+    scrub_stack(frames - 1);
+  }
+  sodium_memzero(frame, sizeof(frame));
+}
+
+struct SharedPoolConfig {
+  std::mutex mutex;
+  ThreadPoolConfig config;
+  bool created = false;
+};
+
+SharedPoolConfig& shared_pool_config() {
+  static SharedPoolConfig shared;
+  return shared;
+}
+
+// State of one parallel_for, shared with helper tasks that may start after
+// it has returned: they only touch `body` after claiming a chunk, and no
+// chunk is left to claim by then.
+struct ChunkRun {
+  std::size_t chunks = 0;
+  const std::function<void(std::size_t)>* body = nullptr;
+  std::atomic<std::size_t> next{0};
+  std::atomic<std::size_t> done{0};
+  std::atomic<bool> failed{false};
+  std::mutex error_mutex;
+  std::exception_ptr error;
+
+  void drain() noexcept {
+    for (;;) {
+      const std::size_t chunk = next.fetch_add(1, std::memory_order_relaxed);
+      if (chunk >= chunks) {
+        return;
+      }
+      if (!failed.load(std::memory_order_relaxed)) {
+        try {
+          (*body)(chunk);
+        } catch (...) {
+          std::lock_guard<std::mutex> lk(error_mutex);
+          if (!error) {
+            error = std::current_exception();
+          }
+          failed = true;
+        }
+      }
+      if (done.fetch_add(1, std::memory_order_acq_rel) + 1 == chunks) {
+        done.notify_all();
+      }
+    }
+  }
+};
+
+}  // anonymous namespace
+
+ThreadPool::ThreadPool(const ThreadPoolConfig& config)
+    : drain_on_shutdown_(config.drain_on_shutdown),
+      scrub_stack_kib_(std::min<std::size_t>(static_cast<std::size_t>(std::max(config.scrub_stack_kib, 0)),
+                                             kMaxScrubKib)) {
+  std::size_t threads = config.threads > 0 ? static_cast<std::size_t>(config.threads)
+                                           : std::max(1u, std::thread::hardware_concurrency());
+  threads = std::min(threads, kMaxThreads);
+
+  // Every Worker exists before any thread starts, since workers steal from
+  // each other.
+  workers_.reserve(threads);
+  for (std::size_t i = 0; i < threads; ++i) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+  try {
+    for (std::size_t i = 0; i < threads; ++i) {
+      workers_[i]->thread = std::thread([this, i] { worker_main(i); });
+    }
+  } catch (...) {
+    shutdown();
+    throw;
+  }
+}
+
+ThreadPool::~ThreadPool() { shutdown(); }
+
+ThreadPool& ThreadPool::shared() {
+  static ThreadPool pool([] {
+    SharedPoolConfig& shared = shared_pool_config();
+    std::lock_guard<std::mutex> lk(shared.mutex);
+    shared.created = true;
+    return shared.config;
+  }());
+  return pool;
+}
+
+bool ThreadPool::configure_shared(const ThreadPoolConfig& config) {
+  SharedPoolConfig& shared = shared_pool_config();
+  std::lock_guard<std::mutex> lk(shared.mutex);
+  if (shared.created) {
+    return false;
+  }
+  shared.config = config;
+  return true;
+}
+
+bool ThreadPool::on_worker_thread() const noexcept { return tls_pool == this; }
+
+void ThreadPool::enqueue(Task task) {
+  if (stopped_.load(std::memory_order_acquire)) {
+    throw std::runtime_error("ThreadPool is shut down");
+  }
+  if (on_worker_thread()) {
+    Worker& self = *workers_[tls_index];
+    std::lock_guard<std::mutex> lk(self.mutex);
+    self.tasks.push_back(std::move(task));
+    pending_.fetch_add(1, std::memory_order_release);
+  } else {
+    std::lock_guard<std::mutex> lk(injected_mutex_);
+    injected_.push_back(std::move(task));
+    pending_.fetch_add(1, std::memory_order_release);
+  }
+  // Taking the lock orders this against a worker that has just found
+  // nothing and is about to wait.
+  { std::lock_guard<std::mutex> lk(sleep_mutex_); }
+  wake_.notify_one();
+}
+
+bool ThreadPool::try_pop(std::size_t self, Task& task) {
+  {
+    Worker& own = *workers_[self];
+    std::lock_guard<std::mutex> lk(own.mutex);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      pending_.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lk(injected_mutex_);
+    if (!injected_.empty()) {
+      task = std::move(injected_.front());
+      injected_.pop_front();
+      pending_.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  for (std::size_t k = 1; k < workers_.size(); ++k) {
+    Worker& victim = *workers_[(self + k) % workers_.size()];
+    std::lock_guard<std::mutex> lk(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      pending_.fetch_sub(1, std::memory_order_relaxed);
+      stolen_.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::worker_main(std::size_t self) {
+  tls_pool = this;
+  tls_index = self;
+  const std::size_t scrub_frames = (scrub_stack_kib_ * 1024 + kScrubFrameBytes - 1) / kScrubFrameBytes;
+
+  for (;;) {
+    Task task;
+    if (try_pop(self, task)) {
+      task();
+      task = nullptr;
+      executed_.fetch_add(1, std::memory_order_relaxed);
+      if (scrub_frames != 0) {
+        scrub_stack(scrub_frames);
+      }
+      continue;
+    }
+    std::unique_lock<std::mutex> lk(sleep_mutex_);
+    wake_.wait(lk, [this] { return stopping_ || pending_.load(std::memory_order_acquire) != 0; });
+    if (stopping_ && pending_.load(std::memory_order_acquire) == 0) {
+      return;
+    }
+  }
+}
+
+void ThreadPool::run_chunks(std::size_t chunks, std::size_t max_parallelism,
+                            const std::function<void(std::size_t)>& body) {
+  trace::Span span("ThreadPool::parallel_for");
+  span.arg("chunks", chunks);
+
+  const std::size_t limit = max_parallelism == 0 ? size() + 1 : max_parallelism;
+  std::size_t helpers = std::min({chunks - 1, limit - 1, size()});
+  if (stopped_.load(std::memory_order_acquire)) {
+    helpers = 0;
+  }
+
+  auto run = std::make_shared<ChunkRun>();
+  run->chunks = chunks;
+  run->body = &body;
+  for (std::size_t i = 0; i < helpers; ++i) {
+    try {
+      enqueue([run] { run->drain(); });
+    } catch (const std::runtime_error&) {
+      break;  // shut down meanwhile: the caller covers the rest
+    }
+  }
+  run->drain();
+
+  for (std::size_t done = run->done.load(std::memory_order_acquire); done < chunks;
+       done = run->done.load(std::memory_order_acquire)) {
+    run->done.wait(done, std::memory_order_acquire);
+  }
+  if (run->error) {
+    std::rethrow_exception(run->error);
+  }
+}
+
+void ThreadPool::shutdown() noexcept {
+  if (stopped_.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+  std::deque<Task> dropped;
+  if (!drain_on_shutdown_) {
+    // Destroyed outside the locks: a dropped packaged_task sets its future.
+    {
+      std::lock_guard<std::mutex> lk(injected_mutex_);
+      dropped.swap(injected_);
+    }
+    for (auto& worker : workers_) {
+      std::lock_guard<std::mutex> lk(worker->mutex);
+      for (auto& task : worker->tasks) {
+        dropped.push_back(std::move(task));
+      }
+      worker->tasks.clear();
+    }
+    pending_.fetch_sub(dropped.size(), std::memory_order_relaxed);
+  }
+  {
+    std::lock_guard<std::mutex> lk(sleep_mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (auto& worker : workers_) {
+    if (worker->thread.joinable()) {
+      worker->thread.join();
+    }
+  }
+  dropped.clear();
+}
+
+ThreadPool::Stats ThreadPool::stats() const noexcept {
+  return {executed_.load(std::memory_order_relaxed), stolen_.load(std::memory_order_relaxed)};
+}
+
+}  // namespace pwledger
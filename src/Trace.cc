@@ -0,0 +1,239 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pwledger/Trace.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace pwledger::trace {
+
+namespace detail {
+
+std::atomic<int> g_state{-1};
+
+}  // namespace detail
+
+namespace {
+
+struct Event {
+  const char* name;
+  std::uint64_t start_ns;
+  std::uint64_t duration_ns;
+  std::uint32_t tid;
+  std::array<detail::Arg, kMaxArgs> args;
+  std::size_t arg_count;
+};
+
+std::uint32_t current_tid() noexcept {
+  // Small sequential ids read better in Perfetto than hashed
+  // std::thread::id values.
+  static std::atomic<std::uint32_t> next{1};
+  thread_local const std::uint32_t tid = next.fetch_add(1, std::memory_order_relaxed);
+  return tid;
+}
+
+long current_pid() noexcept {
+#ifdef _WIN32
+  return static_cast<long>(_getpid());
+#else
+  return static_cast<long>(::getpid());
+#endif
+}
+
+void write_escaped(std::FILE* f, const char* s) {
+  std::fputc('"', f);
+  for (; *s != '\0'; ++s) {
+    const auto c = static_cast<unsigned char>(*s);
+    if (c == '"' || c == '\\') {
+      std::fputc('\\', f);
+      std::fputc(c, f);
+    } else if (c < 0x20) {
+      std::fprintf(f, "\\u%04x", c);
+    } else {
+      std::fputc(c, f);
+    }
+  }
+  std::fputc('"', f);
+}
+
+// ----------------------------------------------------------------------------
+// Recorder
+// ----------------------------------------------------------------------------
+// Process-wide span buffer. A function-local static so that it is
+// constructed on first use and destroyed (and therefore flushed) during
+// normal process exit.
+class Recorder {
+ public:
+  Recorder()
+      : epoch_ns_(now_ns()) {}
+
+  ~Recorder() {
+    if (detail::g_state.load(std::memory_order_relaxed) > 0) {
+      std::lock_guard lock(mutex_);
+      if (!events_.empty()) write_locked();
+    }
+  }
+
+  Recorder(const Recorder&) = delete;
+  Recorder& operator=(const Recorder&) = delete;
+
+  void reset(std::filesystem::path path) {
+    std::lock_guard lock(mutex_);
+    path_ = std::move(path);
+    events_.clear();
+    dropped_ = 0;
+    epoch_ns_ = now_ns();
+  }
+
+  void append(const Event& event) noexcept {
+    std::lock_guard lock(mutex_);
+    if (events_.size() >= kMaxEvents) {
+      ++dropped_;
+      return;
+    }
+    try {
+      events_.push_back(event);
+    } catch (...) {
+      ++dropped_;
+    }
+  }
+
+  bool write() noexcept {
+    std::lock_guard lock(mutex_);
+    return write_locked();
+  }
+
+ private:
+  bool write_locked() noexcept {
+    std::FILE* f = nullptr;
+#ifdef _WIN32
+    if (_wfopen_s(&f, path_.c_str(), L"wb") != 0) f = nullptr;
+#else
+    f = std::fopen(path_.c_str(), "wb");
+#endif
+    if (f == nullptr) {
+      std::fprintf(stderr, "pwledger: could not open trace output %s\n", path_.string().c_str());
+      return false;
+    }
+
+    const long pid = current_pid();
+    std::fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    std::fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%ld,\"args\":{\"name\":\"pwledger\"}}", pid);
+    for (const Event& e : events_) {
+      const std::uint64_t ts_ns = e.start_ns >= epoch_ns_ ? e.start_ns - epoch_ns_ : 0;
+      std::fprintf(f, ",\n{\"name\":");
+      write_escaped(f, e.name);
+      std::fprintf(f, ",\"cat\":\"pwledger\",\"ph\":\"X\",\"pid\":%ld,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f", pid,
+                   static_cast<unsigned>(e.tid), static_cast<double>(ts_ns) / 1000.0,
+                   static_cast<double>(e.duration_ns) / 1000.0);
+      if (e.arg_count > 0) {
+        std::fprintf(f, ",\"args\":{");
+        for (std::size_t i = 0; i < e.arg_count; ++i) {
+          if (i > 0) std::fputc(',', f);
+          write_escaped(f, e.args[i].key);
+          std::fprintf(f, ":%llu", static_cast<unsigned long long>(e.args[i].value));
+        }
+        std::fputc('}', f);
+      }
+      std::fputc('}', f);
+    }
+    std::fprintf(f, "\n],\"otherData\":{\"dropped_events\":%llu}}\n", static_cast<unsigned long long>(dropped_));
+
+    const bool ok = std::ferror(f) == 0;
+    if (std::fclose(f) != 0 || !ok) {
+      std::fprintf(stderr, "pwledger: failed to write trace output %s\n", path_.string().c_str());
+      return false;
+    }
+    return true;
+  }
+
+  std::mutex mutex_;
+  std::filesystem::path path_;
+  std::vector<Event> events_;
+  std::uint64_t dropped_ = 0;
+  std::uint64_t epoch_ns_;
+};
+
+Recorder& recorder() {
+  static Recorder instance;
+  return instance;
+}
+
+}  // namespace
+
+namespace detail {
+
+bool init_from_env() noexcept {
+  // Serialize first-time initialization so that two threads racing through
+  // their first span cannot both reset the recorder.
+  static std::mutex init_mutex;
+  std::lock_guard lock(init_mutex);
+  int state = g_state.load(std::memory_order_acquire);
+  if (state >= 0) return state > 0;
+
+  const char* path = std::getenv("PWLEDGER_TRACE");
+  state = 0;
+  if (path != nullptr && *path != '\0') {
+    try {
+      recorder().reset(path);
+      state = 1;
+    } catch (...) {
+      std::fprintf(stderr, "pwledger: ignoring PWLEDGER_TRACE (invalid path)\n");
+    }
+  }
+  g_state.store(state, std::memory_order_release);
+  return state > 0;
+}
+
+void record(const char* name, std::uint64_t start_ns, std::uint64_t end_ns, const Arg* args,
+            std::size_t arg_count) noexcept {
+  Event event{name, start_ns, end_ns - start_ns, current_tid(), {}, arg_count};
+  for (std::size_t i = 0; i < arg_count; ++i) event.args[i] = args[i];
+  recorder().append(event);
+}
+
+}  // namespace detail
+
+std::uint64_t now_ns() noexcept {
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+void set_output(const std::filesystem::path& path) {
+  recorder().reset(path);
+  detail::g_state.store(path.empty() ? 0 : 1, std::memory_order_release);
+}
+
+bool flush() noexcept {
+  if (detail::g_state.load(std::memory_order_acquire) <= 0) return false;
+  return recorder().write();
+}
+
+}  // namespace pwledger::trace
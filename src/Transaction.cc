@@ -0,0 +1,198 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pwledger/Transaction.h>
+
+#include <pwledger/Trace.h>
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace pwledger {
+
+Transaction::Transaction(PrimaryTable& table) noexcept : table_(table) {}
+
+Transaction::~Transaction() { rollback(); }
+
+// ----------------------------------------------------------------------------
+// Staging
+// ----------------------------------------------------------------------------
+
+void Transaction::require_active() const {
+  if (!active_) {
+    throw std::logic_error("transaction already committed or rolled back");
+  }
+}
+
+void Transaction::stage(Op op) {
+  require_active();
+  if (op.uuid.empty()) {
+    throw std::invalid_argument("UUID must not be empty");
+  }
+  ops_.push_back(std::move(op));
+}
+
+Uuid Transaction::insert(SecretEntry entry) {
+  Uuid uuid = Uuid::generate();
+  insert(uuid, std::move(entry));
+  return uuid;
+}
+
+void Transaction::insert(const Uuid& uuid, SecretEntry entry) {
+  require_active();
+  // The entry is staged in its own map node, so applying it later is a node
+  // insertion that cannot fail for lack of memory.
+  PrimaryTable scratch;
+  auto node = scratch.extract(scratch.emplace(uuid, std::move(entry)).first);
+  stage(Op{Kind::kInsert, uuid, std::move(node), std::nullopt});
+}
+
+void Transaction::insert_all(PrimaryTable&& entries) {
+  require_active();
+  ops_.reserve(ops_.size() + entries.size());
+  while (!entries.empty()) {
+    auto node = entries.extract(entries.begin());
+    const Uuid uuid = node.key();
+    stage(Op{Kind::kInsert, uuid, std::move(node), std::nullopt});
+  }
+}
+
+void Transaction::update_secret(const Uuid& uuid, Secret secret) {
+  stage(Op{Kind::kUpdateSecret, uuid, {}, std::move(secret)});
+}
+
+void Transaction::touch(const Uuid& uuid) { stage(Op{Kind::kTouch, uuid, {}, std::nullopt}); }
+
+void Transaction::erase(const Uuid& uuid) { stage(Op{Kind::kErase, uuid, {}, std::nullopt}); }
+
+// ----------------------------------------------------------------------------
+// apply / undo
+// ----------------------------------------------------------------------------
+
+bool Transaction::apply(Op& op) {
+  if (op.kind == Kind::kInsert) {
+    auto result = table_.insert(std::move(op.node));
+    if (!result.inserted) {
+      op.node = std::move(result.node);
+      return false;
+    }
+    return true;
+  }
+
+  auto it = table_.find(op.uuid);
+  if (it == table_.end()) {
+    return false;
+  }
+  SecretEntry& entry = it->second;
+  switch (op.kind) {
+    case Kind::kUpdateSecret:
+      std::swap(entry.plaintext_secret, *op.secret);
+      op.previous = std::exchange(entry.metadata.last_modified_at, std::chrono::system_clock::now());
+      break;
+    case Kind::kTouch:
+      op.previous = std::exchange(entry.metadata.last_used_at, std::chrono::system_clock::now());
+      break;
+    case Kind::kErase:
+      op.node = table_.extract(it);
+      break;
+    default:
+      break;
+  }
+  return true;
+}
+
+void Transaction::undo(Op& op) noexcept {
+  switch (op.kind) {
+    case Kind::kInsert:
+      op.node = table_.extract(op.uuid);
+      break;
+    case Kind::kUpdateSecret: {
+      SecretEntry& entry = table_.find(op.uuid)->second;
+      std::swap(entry.plaintext_secret, *op.secret);
+      entry.metadata.last_modified_at = op.previous;
+      break;
+    }
+    case Kind::kTouch:
+      table_.find(op.uuid)->second.metadata.last_used_at = op.previous;
+      break;
+    case Kind::kErase:
+      table_.insert(std::move(op.node));
+      break;
+    default:
+      break;
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Completion
+// ----------------------------------------------------------------------------
+
+void Transaction::commit() { commit(Persist{}); }
+
+void Transaction::commit(const Persist& persist) {
+  require_active();
+  trace::Span span("Transaction::commit");
+  span.arg("ops", ops_.size());
+
+  // Buckets for every insert up front: once changes start, nothing may
+  // rehash, or undo could need memory.
+  std::size_t inserts = 0;
+  for (const Op& op : ops_) {
+    inserts += op.kind == Kind::kInsert ? 1 : 0;
+  }
+  table_.reserve(table_.size() + inserts);
+
+  std::size_t applied = 0;
+  for (; applied < ops_.size(); ++applied) {
+    if (!apply(ops_[applied])) {
+      break;
+    }
+  }
+  if (applied != ops_.size()) {
+    const Op& failed = ops_[applied];
+    const bool exists = failed.kind == Kind::kInsert;
+    while (applied > 0) {
+      undo(ops_[--applied]);
+    }
+    throw std::runtime_error("transaction: " + std::string(exists ? "an entry already exists" : "no entry") +
+                             " for UUID " + failed.uuid.to_string());
+  }
+
+  if (persist) {
+    try {
+      persist(table_);
+    } catch (...) {
+      for (std::size_t i = ops_.size(); i > 0; --i) {
+        undo(ops_[i - 1]);
+      }
+      throw;
+    }
+  }
+
+  // The replaced secrets and erased entries are wiped as they go.
+  ops_.clear();
+  active_ = false;
+}
+
+void Transaction::rollback() noexcept {
+  ops_.clear();
+  active_ = false;
+}
+
+}  // namespace pwledger
@@ -19,19 +19,196 @@
 
 #include <pwledger/VaultCrypto.h>
 
+#include <pwledger/Argon2.h>
+#include <pwledger/KeySlots.h>
+#include <pwledger/SodiumInit.h>
+#include <pwledger/Trace.h>
+
+#include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <stdexcept>
+#include <string>
+#include <thread>
 #include <vector>
 
 namespace pwledger {
 
-Secret VaultCrypto::derive_master_key(std::string_view password, const std::uint8_t* salt) {
+namespace {
+
+// Byte offsets within the current (version 3) header.
+constexpr std::size_t kVersionOffset = sizeof(VaultCrypto::kMagic);
+constexpr std::size_t kSuiteOffset = kVersionOffset + 1;
+constexpr std::size_t kOpslimitOffset = kSuiteOffset + 1;
+constexpr std::size_t kMemlimitOffset = kOpslimitOffset + 4;
+constexpr std::size_t kLanesOffset = kMemlimitOffset + 4;
+
+// Where a blob's salt, nonce and ciphertext start, from its header.
+struct BlobLayout {
+  CipherSuite suite = CipherSuite::kXChaCha20Poly1305;
+  std::optional<KdfParams> kdf;  // not for legacy blobs
+  std::size_t salt_offset = 0;
+  std::size_t header_bytes = 0;  // also the AEAD additional-data length, except for legacy blobs
+  bool legacy = false;
+};
+
+void store_u32le(std::uint8_t* p, std::uint32_t v) noexcept {
+  for (int i = 0; i < 4; ++i) {
+    p[i] = static_cast<std::uint8_t>(v >> (8 * i));
+  }
+}
+
+std::uint32_t load_u32le(const std::uint8_t* p) noexcept {
+  std::uint32_t v = 0;
+  for (int i = 3; i >= 0; --i) {
+    v = (v << 8) | p[i];
+  }
+  return v;
+}
+
+BlobLayout parse_layout(const std::vector<std::uint8_t>& blob) {
+  BlobLayout layout;
+  const std::uint8_t version =
+      blob.size() > VaultCrypto::kPrefixBytes &&
+              std::memcmp(blob.data(), VaultCrypto::kMagic, sizeof(VaultCrypto::kMagic)) == 0
+          ? blob[kVersionOffset]
+          : 0;
+  if (version == SlottedVault::kFormatVersion) {
+    throw std::runtime_error("Vault uses key slots; open it with VaultIO or SlottedVault");
+  }
+  if (version != VaultCrypto::kFormatVersion) {
+    layout.legacy = true;
+    layout.header_bytes = VaultCrypto::kSaltBytes + VaultCrypto::nonce_bytes(layout.suite);
+  } else {
+    const std::uint8_t suite = blob[kSuiteOffset];
+    if (suite != static_cast<std::uint8_t>(CipherSuite::kXChaCha20Poly1305) &&
+        suite != static_cast<std::uint8_t>(CipherSuite::kAes256Gcm)) {
+      throw std::runtime_error("Vault uses an unknown cipher suite (" + std::to_string(suite) + ")");
+    }
+    layout.suite = static_cast<CipherSuite>(suite);
+    KdfParams kdf;
+    kdf.opslimit = load_u32le(blob.data() + kOpslimitOffset);
+    kdf.memlimit = std::size_t{load_u32le(blob.data() + kMemlimitOffset)} * 1024u;
+    kdf.parallelism = blob[kLanesOffset];
+    VaultCrypto::check_kdf_params(kdf);
+    layout.kdf = kdf;
+    layout.salt_offset = VaultCrypto::kPrefixBytes;
+    layout.header_bytes = layout.salt_offset + VaultCrypto::kSaltBytes + VaultCrypto::nonce_bytes(layout.suite);
+  }
+  if (blob.size() < layout.header_bytes + VaultCrypto::kTagBytes) {
+    throw std::runtime_error("Ciphertext too short (missing headers or tag)");
+  }
+  return layout;
+}
+
+bool aes256gcm_available() noexcept {
+  return sodium_init_once() && crypto_aead_aes256gcm_is_available() != 0;
+}
+
+}  // anonymous namespace
+
+// Both when writing and when reading a header: a crafted file must not be
+// able to ask for more passes than kMaxOpslimit, more memory than
+// kMaxMemlimit, or more threads than kMaxParallelism. Argon2id needs at
+// least 8 KiB per lane.
+void VaultCrypto::check_kdf_params(const KdfParams& kdf) {
+  if (kdf.opslimit < crypto_pwhash_OPSLIMIT_MIN || kdf.opslimit > kMaxOpslimit ||
+      kdf.memlimit < crypto_pwhash_MEMLIMIT_MIN || kdf.memlimit > kMaxMemlimit ||
+      kdf.parallelism < 1 || kdf.parallelism > kMaxParallelism ||
+      kdf.memlimit / 1024 < std::size_t{8} * kdf.parallelism) {
+    throw std::runtime_error("Argon2id parameters out of range (opslimit " + std::to_string(kdf.opslimit) +
+                             ", memlimit " + std::to_string(kdf.memlimit / 1024) + " KiB, " +
+                             std::to_string(kdf.parallelism) + " lanes)");
+  }
+}
+
+std::string_view cipher_suite_name(CipherSuite suite) noexcept {
+  return suite == CipherSuite::kAes256Gcm ? "aes256gcm" : "xchacha20poly1305";
+}
+
+std::optional<CipherSuite> parse_cipher_suite(std::string_view name) noexcept {
+  for (const CipherSuite suite : {CipherSuite::kXChaCha20Poly1305, CipherSuite::kAes256Gcm}) {
+    if (name == cipher_suite_name(suite)) {
+      return suite;
+    }
+  }
+  return std::nullopt;
+}
+
+KdfParams calibrate_kdf(const KdfCalibration& calibration) {
+  PWLEDGER_TRACE_SPAN("calibrate_kdf");
+
+  std::uint8_t salt[VaultCrypto::kSaltBytes] = {};
+  const auto measure = [&](const KdfParams& kdf) {
+    const auto start = std::chrono::steady_clock::now();
+    Secret key = VaultCrypto::derive_master_key("pwledger-calibrate", salt, kdf);
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+  };
+  return calibrate_kdf(calibration, measure);
+}
+
+KdfParams calibrate_kdf(const KdfCalibration& calibration,
+                        const std::function<std::chrono::nanoseconds(const KdfParams&)>& measure) {
+  const std::chrono::nanoseconds target = calibration.target;
+  const std::size_t max_memlimit = std::min(calibration.max_memlimit, VaultCrypto::kMaxMemlimit);
+
+  KdfParams kdf;
+  kdf.parallelism = calibration.parallelism;
+  if (kdf.parallelism == 0) {
+    kdf.parallelism = std::clamp(std::thread::hardware_concurrency(), 1u, VaultCrypto::kMaxParallelism);
+  }
+  std::chrono::nanoseconds cost = measure(kdf);
+  if (cost >= target) {
+    return kdf;
+  }
+
+  while (kdf.memlimit <= max_memlimit / 2 && cost * 2 <= target) {
+    kdf.memlimit *= 2;
+    cost = measure(kdf);
+  }
+
+  // Cost is linear in passes, so scale them into what is left of the target.
+  const auto scaled = static_cast<unsigned long long>(
+      static_cast<double>(kdf.opslimit) * static_cast<double>(target.count()) /
+      static_cast<double>(std::max<std::chrono::nanoseconds::rep>(cost.count(), 1)));
+  kdf.opslimit = std::clamp<unsigned long long>(scaled, kdf.opslimit, VaultCrypto::kMaxOpslimit);
+  return kdf;
+}
+
+CipherSuite VaultCrypto::default_cipher_suite() noexcept {
+  return aes256gcm_available() ? CipherSuite::kAes256Gcm : CipherSuite::kXChaCha20Poly1305;
+}
+
+CipherSuite VaultCrypto::cipher_suite_of(const std::vector<std::uint8_t>& ciphertext_blob) {
+  return parse_layout(ciphertext_blob).suite;
+}
+
+std::optional<KdfParams> VaultCrypto::kdf_params_of(const std::vector<std::uint8_t>& ciphertext_blob) {
+  return parse_layout(ciphertext_blob).kdf;
+}
+
+Secret VaultCrypto::derive_master_key(std::string_view password, const std::uint8_t* salt, const KdfParams& kdf) {
+  trace::Span span("VaultCrypto::derive_master_key");
+  span.arg("opslimit", kdf.opslimit);
+  span.arg("memlimit_kib", kdf.memlimit / 1024);
+  span.arg("lanes", kdf.parallelism);
+
   Secret key(kKeyBytes);
   key.with_write_access([&](std::span<char> buf) {
+    if (kdf.parallelism > 1) {
+      Argon2idParams params;
+      params.passes = static_cast<std::uint32_t>(kdf.opslimit);
+      params.memory_kib = static_cast<std::uint32_t>(kdf.memlimit / 1024);
+      params.lanes = kdf.parallelism;
+      argon2id(std::span(reinterpret_cast<std::uint8_t*>(buf.data()), buf.size()),
+               std::span(reinterpret_cast<const std::uint8_t*>(password.data()), password.size()),
+               std::span(salt, kSaltBytes), params);
+      return;
+    }
     if (crypto_pwhash(reinterpret_cast<std::uint8_t*>(buf.data()), buf.size(),
                       password.data(), password.size(), salt,
-                      crypto_pwhash_OPSLIMIT_INTERACTIVE,
-                      crypto_pwhash_MEMLIMIT_INTERACTIVE,
+                      kdf.opslimit,
+                      kdf.memlimit,
                       crypto_pwhash_ALG_ARGON2ID13) != 0) {
       throw std::runtime_error("Argon2id key derivation failed");
     }
@@ -39,61 +216,130 @@ Secret VaultCrypto::derive_master_key(std::string_view password, const std::uint
   return key;
 }
 
-std::vector<std::uint8_t> VaultCrypto::encrypt_vault(std::string_view password, const std::vector<std::uint8_t>& plaintext) {
+std::vector<std::uint8_t> VaultCrypto::encrypt_vault(std::string_view password,
+                                                     const std::vector<std::uint8_t>& plaintext,
+                                                     const KdfParams& kdf,
+                                                     CipherSuite suite) {
+  PWLEDGER_TRACE_SPAN("VaultCrypto::encrypt_vault");
+
+  // The header stores memlimit in KiB; Argon2id rounds down to KiB as well,
+  // so this does not change the derived key.
+  KdfParams recorded = kdf;
+  recorded.memlimit -= recorded.memlimit % 1024u;
+  check_kdf_params(recorded);
+
   std::uint8_t salt[kSaltBytes];
   randombytes_buf(salt, sizeof(salt));
 
-  std::uint8_t nonce[kNonceBytes];
-  randombytes_buf(nonce, sizeof(nonce));
+  Secret key = derive_master_key(password, salt, recorded);
+  return encrypt_with_key(key, salt, recorded, plaintext, suite);
+}
+
+std::vector<std::uint8_t> VaultCrypto::decrypt_vault(std::string_view password,
+                                                     const std::vector<std::uint8_t>& ciphertext_blob,
+                                                     const KdfParams& kdf) {
+  PWLEDGER_TRACE_SPAN("VaultCrypto::decrypt_vault");
 
-  Secret key = derive_master_key(password, salt);
+  // Validates the header before paying for Argon2id.
+  const BlobLayout layout = parse_layout(ciphertext_blob);
 
-  std::vector<std::uint8_t> out(kHeaderBytes + plaintext.size() + kTagBytes);
-  std::memcpy(out.data(), salt, kSaltBytes);
-  std::memcpy(out.data() + kSaltBytes, nonce, kNonceBytes);
+  Secret key = derive_master_key(password, ciphertext_blob.data() + layout.salt_offset, layout.kdf.value_or(kdf));
+  return decrypt_with_key(key, ciphertext_blob);
+}
+
+std::vector<std::uint8_t> VaultCrypto::encrypt_with_key(const Secret& key,
+                                                        const std::uint8_t* salt,
+                                                        const KdfParams& kdf,
+                                                        const std::vector<std::uint8_t>& plaintext,
+                                                        CipherSuite suite) {
+  trace::Span span("VaultCrypto::aead_encrypt");
+  span.arg("bytes", plaintext.size());
+  span.arg("suite", static_cast<std::uint64_t>(suite));
+
+  if (suite == CipherSuite::kAes256Gcm && !aes256gcm_available()) {
+    throw std::runtime_error("AES-256-GCM is not available on this CPU");
+  }
 
+  check_kdf_params(kdf);
+
+  const std::size_t header = header_bytes(suite);
+  std::vector<std::uint8_t> out(header + plaintext.size() + kTagBytes);
+  std::memcpy(out.data(), kMagic, sizeof(kMagic));
+  out[kVersionOffset] = kFormatVersion;
+  out[kSuiteOffset] = static_cast<std::uint8_t>(suite);
+  store_u32le(out.data() + kOpslimitOffset, static_cast<std::uint32_t>(kdf.opslimit));
+  store_u32le(out.data() + kMemlimitOffset, static_cast<std::uint32_t>(kdf.memlimit / 1024u));
+  out[kLanesOffset] = static_cast<std::uint8_t>(kdf.parallelism);
+  std::memcpy(out.data() + kPrefixBytes, salt, kSaltBytes);
+  std::uint8_t* nonce = out.data() + kPrefixBytes + kSaltBytes;
+  randombytes_buf(nonce, nonce_bytes(suite));
+
+  // The whole header is additional data. The nonce is random. Through
+  // encrypt_vault each save derives a fresh key from a fresh salt, so a key
+  // seals one message. A caller that keeps `key` across calls relies on the
+  // nonce alone, as SlottedVault::reseal does under its long-lived data key:
+  // q messages under one key collide with probability about q^2 / 2^97 for
+  // AES-GCM's 96 bits, under 2^-32 until 2^32 saves, which no vault nears.
+  // XChaCha20's 192-bit nonce leaves no such bound to watch.
   unsigned long long ciphertext_len = 0;
-  
   key.with_read_access([&](std::span<const char> key_buf) {
-    if (crypto_aead_xchacha20poly1305_ietf_encrypt(
-            out.data() + kHeaderBytes, &ciphertext_len,
-            plaintext.data(), plaintext.size(),
-            nullptr, 0,  // additional data
-            nullptr,     // secret nonce (not used)
-            nonce,
-            reinterpret_cast<const std::uint8_t*>(key_buf.data())) != 0) {
+    const auto* k = reinterpret_cast<const std::uint8_t*>(key_buf.data());
+    const int rc = suite == CipherSuite::kAes256Gcm
+                       ? crypto_aead_aes256gcm_encrypt(out.data() + header, &ciphertext_len,
+                                                       plaintext.data(), plaintext.size(),
+                                                       out.data(), header,
+                                                       nullptr, nonce, k)
+                       : crypto_aead_xchacha20poly1305_ietf_encrypt(out.data() + header, &ciphertext_len,
+                                                                    plaintext.data(), plaintext.size(),
+                                                                    out.data(), header,
+                                                                    nullptr, nonce, k);
+    if (rc != 0) {
       throw std::runtime_error("Encryption failed");
     }
   });
 
-  out.resize(kHeaderBytes + ciphertext_len);
+  out.resize(header + ciphertext_len);
   return out;
 }
 
-std::vector<std::uint8_t> VaultCrypto::decrypt_vault(std::string_view password, const std::vector<std::uint8_t>& ciphertext_blob) {
-  if (ciphertext_blob.size() < kHeaderBytes + kTagBytes) {
-    throw std::runtime_error("Ciphertext too short (missing headers or tag)");
+std::vector<std::uint8_t> VaultCrypto::decrypt_with_key(const Secret& key,
+                                                        const std::vector<std::uint8_t>& ciphertext_blob) {
+  const BlobLayout layout = parse_layout(ciphertext_blob);
+  if (layout.suite == CipherSuite::kAes256Gcm && !aes256gcm_available()) {
+    throw std::runtime_error(
+        "Vault is encrypted with AES-256-GCM, which this CPU does not support; "
+        "open and save it on a machine with AES support to convert it to XChaCha20-Poly1305");
   }
 
-  const std::uint8_t* salt = ciphertext_blob.data();
-  const std::uint8_t* nonce = ciphertext_blob.data() + kSaltBytes;
-  const std::uint8_t* encrypted_data = ciphertext_blob.data() + kHeaderBytes;
-  std::size_t encrypted_len = ciphertext_blob.size() - kHeaderBytes;
+  trace::Span span("VaultCrypto::aead_decrypt");
+  span.arg("bytes", ciphertext_blob.size());
+  span.arg("suite", static_cast<std::uint64_t>(layout.suite));
 
-  Secret key = derive_master_key(password, salt);
+  const std::uint8_t* nonce = ciphertext_blob.data() + layout.salt_offset + kSaltBytes;
+  const std::uint8_t* encrypted_data = ciphertext_blob.data() + layout.header_bytes;
+  std::size_t encrypted_len = ciphertext_blob.size() - layout.header_bytes;
+  // Legacy blobs predate the header and were sealed without additional data.
+  const std::uint8_t* ad = layout.legacy ? nullptr : ciphertext_blob.data();
+  const std::size_t ad_len = layout.legacy ? 0 : layout.header_bytes;
 
   std::vector<std::uint8_t> plaintext(encrypted_len - kTagBytes);
   unsigned long long plaintext_len = 0;
 
   bool dec_ok = false;
   key.with_read_access([&](std::span<const char> key_buf) {
-    dec_ok = crypto_aead_xchacha20poly1305_ietf_decrypt(
-                 plaintext.data(), &plaintext_len,
-                 nullptr,
-                 encrypted_data, encrypted_len,
-                 nullptr, 0,
-                 nonce,
-                 reinterpret_cast<const std::uint8_t*>(key_buf.data())) == 0;
+    const auto* k = reinterpret_cast<const std::uint8_t*>(key_buf.data());
+    const int rc = layout.suite == CipherSuite::kAes256Gcm
+                       ? crypto_aead_aes256gcm_decrypt(plaintext.data(), &plaintext_len,
+                                                       nullptr,
+                                                       encrypted_data, encrypted_len,
+                                                       ad, ad_len,
+                                                       nonce, k)
+                       : crypto_aead_xchacha20poly1305_ietf_decrypt(plaintext.data(), &plaintext_len,
+                                                                    nullptr,
+                                                                    encrypted_data, encrypted_len,
+                                                                    ad, ad_len,
+                                                                    nonce, k);
+    dec_ok = rc == 0;
   });
 
   if (!dec_ok) {
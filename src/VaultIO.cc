@@ -18,29 +18,46 @@
 
 #include <pwledger/VaultIO.h>
 
-#include <sodium.h>
+#include <pwledger/Kernels.h>
+#include <pwledger/Trace.h>
 
-namespace pwledger {
-
-bool VaultIO::vault_exists(const std::filesystem::path& path) {
-  return std::filesystem::exists(path) && std::filesystem::is_regular_file(path);
-}
+#include <optional>
+#include <span>
 
-void VaultIO::save_vault(const std::filesystem::path& path, const PrimaryTable& table, std::string_view password) {
-  // 1. Serialize to plaintext bytes
-  std::vector<std::uint8_t> plaintext = VaultSerializer::serialize(table);
+namespace pwledger {
 
-  // 2. Encrypt
-  std::vector<std::uint8_t> ciphertext = VaultCrypto::encrypt_vault(password, plaintext);
+namespace {
 
-  // 3. Clear plaintext from memory immediately (best effort; std::vector
-  // doesn't guarantee zeroing, but we can do it manually before destruction)
-  sodium_memzero(plaintext.data(), plaintext.size());
-  // Also clear its capacity if it reallocated
+void wipe(std::vector<std::uint8_t>& plaintext) {
+  // Best effort; std::vector doesn't guarantee zeroing, but we can do it
+  // manually before destruction, and drop the capacity too.
+  kernels::secure_zero(plaintext.data(), plaintext.size());
   plaintext.clear();
   plaintext.shrink_to_fit();
+}
 
-  // 4. Atomic write
+std::vector<std::uint8_t> read_file(const std::filesystem::path& path) {
+  trace::Span read_span("VaultIO::read_file");
+  std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+  if (!ifs) {
+    throw std::runtime_error("Failed to open vault file for reading");
+  }
+  auto size = ifs.tellg();
+  if (size < 0) {
+    throw std::runtime_error("Failed to determine vault file size");
+  }
+  ifs.seekg(0, std::ios::beg);
+  std::vector<std::uint8_t> bytes(static_cast<std::size_t>(size));
+  if (!ifs.read(reinterpret_cast<char*>(bytes.data()), size)) {
+    throw std::runtime_error("Failed to read vault file");
+  }
+  read_span.arg("bytes", bytes.size());
+  return bytes;
+}
+
+void write_file_atomically(const std::filesystem::path& path, const std::vector<std::uint8_t>& ciphertext) {
+  trace::Span write_span("VaultIO::write_file");
+  write_span.arg("bytes", ciphertext.size());
   std::filesystem::path temp_path = path;
   temp_path += ".tmp";
 
@@ -64,45 +81,298 @@ void VaultIO::save_vault(const std::filesystem::path& path, const PrimaryTable&
   std::filesystem::rename(temp_path, path);
 }
 
-PrimaryTable VaultIO::load_vault(const std::filesystem::path& path, std::string_view password) {
-  if (!vault_exists(path)) {
+// Deserializes and then wipes a decrypted payload.
+PrimaryTable to_table(std::vector<std::uint8_t>& plaintext) {
+  PrimaryTable table;
+  try {
+    table = VaultSerializer::deserialize(plaintext.data(), plaintext.size());
+  } catch (...) {
+    kernels::secure_zero(plaintext.data(), plaintext.size());
+    throw;
+  }
+  kernels::secure_zero(plaintext.data(), plaintext.size());
+  return table;
+}
+
+// load_serialized, also handing back a key-slot file's data key in
+// `data_key` when that is not null (reset for a single-password file).
+std::vector<std::uint8_t> load_payload(const std::filesystem::path& path,
+                                       std::string_view password,
+                                       const KdfParams& kdf,
+                                       std::optional<Secret>* data_key) {
+  if (!VaultIO::vault_exists(path)) {
     throw std::runtime_error("Vault file does not exist");
   }
 
   // 1. Read entire file
-  std::vector<std::uint8_t> ciphertext;
-  {
-    std::ifstream ifs(path, std::ios::binary | std::ios::ate);
-    if (!ifs) {
-      throw std::runtime_error("Failed to open vault file for reading");
-    }
-    auto size = ifs.tellg();
-    if (size < 0) {
-      throw std::runtime_error("Failed to determine vault file size");
-    }
-    ifs.seekg(0, std::ios::beg);
-    ciphertext.resize(static_cast<std::size_t>(size));
-    if (!ifs.read(reinterpret_cast<char*>(ciphertext.data()), size)) {
-      throw std::runtime_error("Failed to read vault file");
+  std::vector<std::uint8_t> ciphertext = read_file(path);
+
+  // 2. Decrypt
+  if (SlottedVault::is_slotted(ciphertext)) {
+    const SlottedVault vault = SlottedVault::parse(std::move(ciphertext));
+    Secret key = vault.unlock(password);
+    std::vector<std::uint8_t> plaintext = vault.decrypt(key);
+    if (data_key != nullptr) {
+      data_key->emplace(std::move(key));
     }
+    return plaintext;
   }
+  if (data_key != nullptr) {
+    data_key->reset();
+  }
+  return VaultCrypto::decrypt_vault(password, ciphertext, kdf);
+}
 
-  // 2. Decrypt
-  std::vector<std::uint8_t> plaintext = VaultCrypto::decrypt_vault(password, ciphertext);
+// Reseals `plaintext` into the key-slot file at `path`, keeping its slots,
+// under the data key `key_of` gets from them (or already holds). Wipes
+// `plaintext` either way.
+template <typename KeyOf>
+void reseal_slotted(const std::filesystem::path& path,
+                    std::vector<std::uint8_t>& plaintext,
+                    CipherSuite suite,
+                    KeyOf&& key_of) {
+  std::vector<std::uint8_t> ciphertext;
+  try {
+    SlottedVault vault = VaultIO::read_slotted(path);
+    const Secret& data_key = key_of(vault);
+    vault.reseal(data_key, plaintext, suite);
+    ciphertext = vault.serialize();
+  } catch (...) {
+    wipe(plaintext);
+    throw;
+  }
+  wipe(plaintext);
+  write_file_atomically(path, ciphertext);
+}
 
-  // 3. Deserialize
-  PrimaryTable table;
+}  // namespace
+
+bool VaultIO::vault_exists(const std::filesystem::path& path) {
+  return std::filesystem::exists(path) && std::filesystem::is_regular_file(path);
+}
+
+void VaultIO::save_vault(const std::filesystem::path& path,
+                         const PrimaryTable& table,
+                         std::string_view password,
+                         const KdfParams& kdf,
+                         CipherSuite suite) {
+  PWLEDGER_TRACE_SPAN("VaultIO::save_vault");
+
+  // 1. Serialize to plaintext bytes
+  std::vector<std::uint8_t> plaintext = VaultSerializer::serialize(table);
+
+  // 2. Encrypt and write
+  save_serialized(path, plaintext, password, kdf, suite);
+}
+
+void VaultIO::save_serialized(const std::filesystem::path& path,
+                              std::vector<std::uint8_t>& plaintext,
+                              std::string_view password,
+                              const KdfParams& kdf,
+                              CipherSuite suite) {
+  PWLEDGER_TRACE_SPAN("VaultIO::save_serialized");
+
+  bool slotted = false;
   try {
-    table = VaultSerializer::deserialize(plaintext.data(), plaintext.size());
+    slotted = uses_key_slots(path);
   } catch (...) {
-    sodium_memzero(plaintext.data(), plaintext.size());
+    wipe(plaintext);
     throw;
   }
+  if (slotted) {
+    reseal_slotted(path, plaintext, suite, [&](const SlottedVault& vault) { return vault.unlock(password); });
+    return;
+  }
 
-  // 4. Clear plaintext
-  sodium_memzero(plaintext.data(), plaintext.size());
+  // 1. Encrypt
+  std::vector<std::uint8_t> ciphertext;
+  try {
+    ciphertext = VaultCrypto::encrypt_vault(password, plaintext, kdf, suite);
+  } catch (...) {
+    wipe(plaintext);
+    throw;
+  }
 
-  return table;
+  // 2. Clear plaintext from memory immediately
+  wipe(plaintext);
+
+  // 3. Atomic write
+  write_file_atomically(path, ciphertext);
+}
+
+std::optional<KdfParams> VaultIO::stored_kdf_params(const std::filesystem::path& path) {
+  // Longest header (XChaCha20 nonce) plus a tag: parse_layout's minimum.
+  constexpr std::size_t kProbeBytes =
+      VaultCrypto::header_bytes(CipherSuite::kXChaCha20Poly1305) + VaultCrypto::kTagBytes;
+
+  if (uses_key_slots(path)) {
+    const SlottedVault vault = read_slotted(path);
+    for (const KeySlot& slot : vault.slots()) {
+      if (slot.type == KeySlot::Type::kPassword) {
+        return slot.kdf;
+      }
+    }
+    return std::nullopt;
+  }
+
+  std::ifstream ifs(path, std::ios::binary);
+  if (!ifs) {
+    throw std::runtime_error("Failed to open vault file for reading");
+  }
+  std::vector<std::uint8_t> head(kProbeBytes);
+  ifs.read(reinterpret_cast<char*>(head.data()), static_cast<std::streamsize>(head.size()));
+  head.resize(static_cast<std::size_t>(ifs.gcount()));
+  return VaultCrypto::kdf_params_of(head);
+}
+
+PrimaryTable VaultIO::load_vault(const std::filesystem::path& path,
+                                 std::string_view password,
+                                 const KdfParams& kdf) {
+  PWLEDGER_TRACE_SPAN("VaultIO::load_vault");
+
+  // 1-2. Read and decrypt
+  std::vector<std::uint8_t> plaintext = load_serialized(path, password, kdf);
+
+  // 3. Deserialize, then clear plaintext
+  return to_table(plaintext);
+}
+
+std::vector<std::uint8_t> VaultIO::load_serialized(const std::filesystem::path& path,
+                                                   std::string_view password,
+                                                   const KdfParams& kdf) {
+  PWLEDGER_TRACE_SPAN("VaultIO::load_serialized");
+  return load_payload(path, password, kdf, nullptr);
+}
+
+// ----------------------------------------------------------------------------
+// Key-slot files
+// ----------------------------------------------------------------------------
+
+PrimaryTable VaultIO::load_vault(const std::filesystem::path& path, const X25519KeyPair& identity) {
+  std::optional<Secret> data_key;
+  return load_vault(path, identity, data_key);
+}
+
+PrimaryTable VaultIO::load_vault(const std::filesystem::path& path,
+                                 const X25519KeyPair& identity,
+                                 std::optional<Secret>& data_key) {
+  PWLEDGER_TRACE_SPAN("VaultIO::load_vault");
+
+  const SlottedVault vault = read_slotted(path);
+  Secret key = vault.unlock(identity);
+  std::vector<std::uint8_t> plaintext = vault.decrypt(key);
+  data_key.emplace(std::move(key));
+  return to_table(plaintext);
+}
+
+PrimaryTable VaultIO::load_vault(const std::filesystem::path& path,
+                                 std::string_view password,
+                                 std::optional<Secret>& data_key,
+                                 const KdfParams& kdf) {
+  PWLEDGER_TRACE_SPAN("VaultIO::load_vault");
+
+  std::vector<std::uint8_t> plaintext = load_payload(path, password, kdf, &data_key);
+  return to_table(plaintext);
+}
+
+void VaultIO::save_vault(const std::filesystem::path& path,
+                         const PrimaryTable& table,
+                         const X25519KeyPair& identity,
+                         CipherSuite suite) {
+  PWLEDGER_TRACE_SPAN("VaultIO::save_vault");
+
+  std::vector<std::uint8_t> plaintext = VaultSerializer::serialize(table);
+  reseal_slotted(path, plaintext, suite, [&](const SlottedVault& vault) { return vault.unlock(identity); });
+}
+
+void VaultIO::save_vault(const std::filesystem::path& path,
+                         const PrimaryTable& table,
+                         const Secret& data_key,
+                         CipherSuite suite) {
+  PWLEDGER_TRACE_SPAN("VaultIO::save_vault");
+
+  std::vector<std::uint8_t> plaintext = VaultSerializer::serialize(table);
+  save_serialized(path, plaintext, data_key, suite);
+}
+
+void VaultIO::save_serialized(const std::filesystem::path& path,
+                              std::vector<std::uint8_t>& plaintext,
+                              const Secret& data_key,
+                              CipherSuite suite) {
+  PWLEDGER_TRACE_SPAN("VaultIO::save_serialized");
+
+  reseal_slotted(path, plaintext, suite, [&](const SlottedVault& vault) -> const Secret& {
+    // The file may have been replaced since the key was unlocked; a payload
+    // sealed under a key its slots do not wrap could never be opened again.
+    // One AEAD pass over the payload, no Argon2id.
+    std::vector<std::uint8_t> current;
+    try {
+      current = vault.decrypt(data_key);
+    } catch (const std::exception&) {
+      throw std::runtime_error("Vault file was replaced since it was unlocked; unlock it again");
+    }
+    wipe(current);
+    return data_key;
+  });
+}
+
+bool VaultIO::uses_key_slots(const std::filesystem::path& path) {
+  if (!vault_exists(path)) {
+    return false;
+  }
+  std::ifstream ifs(path, std::ios::binary);
+  if (!ifs) {
+    throw std::runtime_error("Failed to open vault file for reading");
+  }
+  std::uint8_t head[sizeof(VaultCrypto::kMagic) + 3] = {};
+  ifs.read(reinterpret_cast<char*>(head), sizeof(head));
+  return SlottedVault::is_slotted(std::span<const std::uint8_t>(head, static_cast<std::size_t>(ifs.gcount())));
+}
+
+SlottedVault VaultIO::read_slotted(const std::filesystem::path& path) {
+  if (!vault_exists(path)) {
+    throw std::runtime_error("Vault file does not exist");
+  }
+  std::vector<std::uint8_t> blob = read_file(path);
+  if (!SlottedVault::is_slotted(blob)) {
+    throw std::runtime_error("Vault does not use key slots");
+  }
+  return SlottedVault::parse(std::move(blob));
+}
+
+void VaultIO::write_slotted(const std::filesystem::path& path, const SlottedVault& vault) {
+  PWLEDGER_TRACE_SPAN("VaultIO::write_slotted");
+  write_file_atomically(path, vault.serialize());
+}
+
+Secret VaultIO::convert_to_slotted(const std::filesystem::path& path,
+                                   std::string_view password,
+                                   const std::string& label) {
+  PWLEDGER_TRACE_SPAN("VaultIO::convert_to_slotted");
+
+  if (!vault_exists(path)) {
+    throw std::runtime_error("Vault file does not exist");
+  }
+  std::vector<std::uint8_t> ciphertext = read_file(path);
+  if (SlottedVault::is_slotted(ciphertext)) {
+    throw std::runtime_error("Vault already uses key slots");
+  }
+  const KdfParams kdf = VaultCrypto::kdf_params_of(ciphertext).value_or(KdfParams{});
+  const CipherSuite suite = VaultCrypto::cipher_suite_of(ciphertext);
+  std::vector<std::uint8_t> plaintext = VaultCrypto::decrypt_vault(password, ciphertext, kdf);
+
+  Secret data_key = SlottedVault::generate_data_key();
+  std::optional<SlottedVault> vault;
+  try {
+    vault = SlottedVault::create(data_key, plaintext, suite);
+  } catch (...) {
+    wipe(plaintext);
+    throw;
+  }
+  wipe(plaintext);
+  vault->add_password_slot(data_key, label, password, kdf);
+  write_slotted(path, *vault);
+  return data_key;
 }
 
 }  // namespace pwledger
@@ -0,0 +1,1063 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pwledger/VaultImport.h>
+
+#include <pwledger/Secret.h>
+#include <pwledger/SecretEntry.h>
+#include <pwledger/ThreadPool.h>
+#include <pwledger/Trace.h>
+#include <pwledger/uuid.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+#include <sodium.h>
+
+namespace pwledger {
+
+namespace {
+
+constexpr std::size_t kSlotBytes = kMaxSecretBytes;
+constexpr std::size_t kMaxPasswordBytes = kSlotBytes - 1;
+
+constexpr std::size_t kReadBufferBytes = 64 * 1024;
+
+// Entries built per pool task. Each costs two sodium_malloc calls, so a few
+// dozen amortize the task overhead without starving other workers.
+constexpr std::size_t kBuildGrain = 32;
+
+// Zeroes a std::string's whole allocation, not just its current contents.
+void wipe_string(std::string& s) noexcept {
+  s.resize(s.capacity());
+  sodium_memzero(s.data(), s.size());
+  s.clear();
+}
+
+std::string lowercase_trimmed(std::string_view s) {
+  const auto first = s.find_first_not_of(" \t");
+  if (first == std::string_view::npos) {
+    return {};
+  }
+  s = s.substr(first, s.find_last_not_of(" \t") - first + 1);
+  std::string out(s);
+  std::transform(out.begin(), out.end(), out.begin(), [](unsigned char c) {
+    return static_cast<char>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+  });
+  return out;
+}
+
+// ----------------------------------------------------------------------------
+// Reader
+// ----------------------------------------------------------------------------
+// Buffered bytes from an istream, with the line number for error messages.
+// The buffer can hold password bytes, so it is wiped before every refill
+// and on destruction.
+class Reader {
+public:
+  static constexpr int kEof = -1;
+
+  explicit Reader(std::istream& in) : in_(in), buf_(std::make_unique<char[]>(kReadBufferBytes)) {}
+  ~Reader() { sodium_memzero(buf_.get(), kReadBufferBytes); }
+
+  Reader(const Reader&) = delete;
+  Reader& operator=(const Reader&) = delete;
+
+  int get() {
+    if (pos_ == len_ && !refill()) {
+      return kEof;
+    }
+    const char c = buf_[pos_++];
+    if (c == '\n') {
+      ++line_;
+    }
+    return static_cast<unsigned char>(c);
+  }
+
+  int peek() {
+    if (pos_ == len_ && !refill()) {
+      return kEof;
+    }
+    return static_cast<unsigned char>(buf_[pos_]);
+  }
+
+  // Consumes a UTF-8 byte order mark, if the input starts with one.
+  void skip_utf8_bom(const char* format) {
+    if (peek() != 0xEF) {
+      return;
+    }
+    get();
+    if (get() != 0xBB || get() != 0xBF) {
+      throw std::runtime_error(std::string(format) + ": the input is not UTF-8");
+    }
+  }
+
+  [[nodiscard]] std::size_t line() const noexcept { return line_; }
+
+private:
+  bool refill() {
+    sodium_memzero(buf_.get(), len_);
+    pos_ = len_ = 0;
+    if (!in_) {
+      return false;
+    }
+    in_.read(buf_.get(), kReadBufferBytes);
+    if (in_.bad()) {
+      throw std::runtime_error("import: read error");
+    }
+    len_ = static_cast<std::size_t>(in_.gcount());
+    return len_ != 0;
+  }
+
+  std::istream& in_;
+  std::unique_ptr<char[]> buf_;
+  std::size_t pos_ = 0;
+  std::size_t len_ = 0;
+  std::size_t line_ = 1;
+};
+
+[[noreturn]] void fail_at_line(const char* format, const Reader& reader, const std::string& what) {
+  throw std::runtime_error(std::string(format) + ", line " + std::to_string(reader.line()) + ": " + what);
+}
+
+// ----------------------------------------------------------------------------
+// Batcher
+// ----------------------------------------------------------------------------
+// Collects parsed records and turns them into entries a batch at a time.
+// Parsers fill the current record(), feed its password byte by byte (or as
+// a string, for JSON) into the current arena slot, and end it with commit()
+// or skip(). The arena stays writable from one flush to the next.
+struct Record {
+  std::string title;
+  std::string username;
+  std::string url;
+  std::size_t password_len = 0;  // may exceed kMaxPasswordBytes; only that many are stored
+};
+
+class Batcher {
+public:
+  Batcher(PrimaryTable& out, std::size_t batch_size)
+      : out_(out), capacity_(std::max<std::size_t>(batch_size, 1)), arena_(capacity_ * kSlotBytes) {
+    records_.reserve(capacity_);
+    records_.emplace_back();
+    writer_.emplace(arena_);
+  }
+
+  Record& record() noexcept { return records_.back(); }
+
+  void push_password(char c) noexcept {
+    Record& r = records_.back();
+    if (r.password_len < kMaxPasswordBytes) {
+      slot()[r.password_len] = c;
+    }
+    ++r.password_len;
+  }
+
+  void append_password(std::string_view s) noexcept {
+    Record& r = records_.back();
+    if (r.password_len < kMaxPasswordBytes) {
+      std::memcpy(slot() + r.password_len, s.data(), std::min(s.size(), kMaxPasswordBytes - r.password_len));
+    }
+    r.password_len += s.size();
+  }
+
+  // Ends the current record, keeping it unless it is empty or its password
+  // is too long.
+  void commit() {
+    Record& r = records_.back();
+    if (r.title.empty() && r.url.empty() && r.username.empty() && r.password_len == 0) {
+      skip();
+      return;
+    }
+    if (r.password_len > kMaxPasswordBytes) {
+      ++result_.too_long;
+      discard();
+      return;
+    }
+    if (r.title.empty()) {
+      r.title = !r.url.empty() ? r.url : r.username;
+    }
+    if (records_.size() == capacity_) {
+      flush();
+    } else {
+      records_.emplace_back();
+    }
+  }
+
+  // Ends the current record without keeping it.
+  void skip() {
+    ++result_.skipped;
+    discard();
+  }
+
+  // Flushes the committed records. The current record, if any, is dropped.
+  ImportResult finish() {
+    discard();
+    records_.pop_back();
+    if (!records_.empty()) {
+      flush();
+    }
+    return result_;
+  }
+
+private:
+  char* slot() noexcept { return writer_->get().data() + (records_.size() - 1) * kSlotBytes; }
+
+  void discard() noexcept {
+    sodium_memzero(slot(), std::min(records_.back().password_len, kMaxPasswordBytes));
+    records_.back() = Record{};
+  }
+
+  void flush() {
+    const std::size_t n = records_.size();
+    trace::Span span("import::flush");
+    span.arg("entries", n);
+
+    writer_.reset();
+    std::vector<std::optional<SecretEntry>> built(n);
+    {
+      const details::Secret_readaccess reader(arena_);
+      const std::span<const char> slots = reader.get();
+      ThreadPool::shared().parallel_for(
+          0,
+          n,
+          [&](std::size_t i) {
+            Record& r = records_[i];
+            SecretEntry entry(std::move(r.title), std::move(r.username), kSlotBytes, crypto_pwhash_SALTBYTES);
+            entry.plaintext_secret.with_write_access([&](std::span<char> buf) {
+              sodium_memzero(buf.data(), buf.size());
+              std::memcpy(buf.data(), slots.data() + i * kSlotBytes, r.password_len);
+            });
+            entry.salt.with_write_access([](std::span<char> buf) { randombytes_buf(buf.data(), buf.size()); });
+            built[i].emplace(std::move(entry));
+          },
+          kBuildGrain);
+    }
+    arena_.zeroize();
+
+    // UUIDs are generated here, in input order, so the time-ordered UUIDs
+    // sort the way the export did.
+    for (auto& entry : built) {
+      out_.emplace(Uuid::generate(), std::move(*entry));
+    }
+    result_.imported += n;
+
+    records_.clear();
+    records_.emplace_back();
+    writer_.emplace(arena_);
+  }
+
+  PrimaryTable& out_;
+  std::size_t capacity_;
+  Secret arena_;
+  std::optional<details::Secret_writeaccess> writer_;
+  std::vector<Record> records_;  // committed records, then the current one
+  ImportResult result_;
+};
+
+// ============================================================================
+// CSV
+// ============================================================================
+
+enum class Column { kIgnored, kTitle, kUsername, kPassword, kUrl };
+
+// Header names used by the common exporters: Chrome, Firefox, Bitwarden,
+// 1Password, KeePassXC.
+Column classify_column(std::string_view header) {
+  const std::string name = lowercase_trimmed(header);
+  if (name == "name" || name == "title" || name == "account" || name == "account name") {
+    return Column::kTitle;
+  }
+  if (name == "username" || name == "user name" || name == "login_username" || name == "login name" ||
+      name == "login" || name == "user" || name == "email") {
+    return Column::kUsername;
+  }
+  if (name == "password" || name == "login_password") {
+    return Column::kPassword;
+  }
+  if (name == "url" || name == "login_uri" || name == "uri" || name == "website" || name == "web site" ||
+      name == "login url") {
+    return Column::kUrl;
+  }
+  return Column::kIgnored;
+}
+
+// RFC 4180: fields separated by ',', records by CRLF or LF, fields
+// optionally quoted with '"' (doubled inside), quoted fields may span lines.
+class CsvTokenizer {
+public:
+  enum class End { kField, kRecord, kInput };
+
+  explicit CsvTokenizer(Reader& reader) : reader_(reader) {}
+
+  // Reads one field, handing its bytes to sink(char), and reports what
+  // ended it.
+  template <typename Sink>
+  End read_field(Sink&& sink) {
+    int c = reader_.get();
+    if (c == '"') {
+      const std::size_t start_line = reader_.line();
+      for (;;) {
+        c = reader_.get();
+        if (c == Reader::kEof) {
+          throw std::runtime_error("CSV: unterminated quoted field starting on line " + std::to_string(start_line));
+        }
+        if (c == '"') {
+          if (reader_.peek() != '"') {
+            break;
+          }
+          reader_.get();
+        }
+        sink(static_cast<char>(c));
+      }
+      c = reader_.get();
+      if (c != ',' && c != '\r' && c != '\n' && c != Reader::kEof) {
+        fail_at_line("CSV", reader_, "unexpected character after a closing quote");
+      }
+    } else {
+      while (c != ',' && c != '\r' && c != '\n' && c != Reader::kEof) {
+        sink(static_cast<char>(c));
+        c = reader_.get();
+      }
+    }
+    if (c == ',') {
+      return End::kField;
+    }
+    if (c == '\r' && reader_.peek() == '\n') {
+      reader_.get();
+    }
+    return c == Reader::kEof ? End::kInput : End::kRecord;
+  }
+
+private:
+  Reader& reader_;
+};
+
+void import_csv(Reader& reader, Batcher& batch) {
+  reader.skip_utf8_bom("CSV");
+  CsvTokenizer csv(reader);
+  using End = CsvTokenizer::End;
+
+  std::vector<Column> columns;
+  bool has_password = false;
+  End end;
+  do {
+    std::string name;
+    end = csv.read_field([&](char c) { name.push_back(c); });
+    Column role = classify_column(name);
+    // A second column for the same role (say both "name" and "title") is
+    // ignored rather than appended.
+    if (role != Column::kIgnored && std::find(columns.begin(), columns.end(), role) != columns.end()) {
+      role = Column::kIgnored;
+    }
+    has_password = has_password || role == Column::kPassword;
+    columns.push_back(role);
+  } while (end == End::kField);
+  if (!has_password) {
+    throw std::runtime_error("CSV: the header row has no password column");
+  }
+
+  while (end != End::kInput) {
+    Record& r = batch.record();
+    std::size_t column = 0;
+    bool blank = true;
+    do {
+      const Column role = column < columns.size() ? columns[column] : Column::kIgnored;
+      end = csv.read_field([&](char c) {
+        blank = false;
+        switch (role) {
+          case Column::kTitle:
+            r.title.push_back(c);
+            break;
+          case Column::kUsername:
+            r.username.push_back(c);
+            break;
+          case Column::kUrl:
+            r.url.push_back(c);
+            break;
+          case Column::kPassword:
+            batch.push_password(c);
+            break;
+          default:
+            break;
+        }
+      });
+      ++column;
+    } while (end == End::kField);
+    if (blank && column == 1) {
+      continue;  // empty line, including the one after a trailing newline
+    }
+    batch.commit();
+  }
+}
+
+// ============================================================================
+// Bitwarden JSON
+// ============================================================================
+
+using json = nlohmann::json;
+
+// Input iterator over a Reader, for nlohmann's iterator input adapter (its
+// istream adapter reads one character per virtual call).
+class ReaderIterator {
+public:
+  using iterator_category = std::input_iterator_tag;
+  using value_type = char;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const char*;
+  using reference = char;
+
+  ReaderIterator() = default;
+  explicit ReaderIterator(Reader& reader) : reader_(&reader) {}
+
+  char operator*() const { return static_cast<char>(reader_->peek()); }
+  ReaderIterator& operator++() {
+    reader_->get();
+    return *this;
+  }
+  ReaderIterator operator++(int) {
+    ReaderIterator previous = *this;
+    ++*this;
+    return previous;
+  }
+
+  // Only "at the end or not" is meaningful for a single-pass source.
+  friend bool operator==(const ReaderIterator& a, const ReaderIterator& b) { return a.at_end() == b.at_end(); }
+
+private:
+  [[nodiscard]] bool at_end() const { return reader_ == nullptr || reader_->peek() == Reader::kEof; }
+
+  Reader* reader_ = nullptr;
+};
+
+// SAX handler for {"encrypted": false, "items": [{"type": 1, "name": ...,
+// "login": {"username": ..., "password": ..., "uris": [{"uri": ...}]}}]}.
+// Every string value is wiped once looked at, whatever it was.
+class BitwardenHandler {
+public:
+  explicit BitwardenHandler(Batcher& batch) : batch_(batch) {}
+
+  bool null() { return true; }
+
+  bool boolean(bool value) {
+    if (top() == Scope::kRoot && key_ == "encrypted" && value) {
+      throw std::runtime_error(
+          "Bitwarden JSON: this is an encrypted export; export again choosing the unencrypted JSON format");
+    }
+    return true;
+  }
+
+  bool number_integer(json::number_integer_t value) { return number(value); }
+  bool number_unsigned(json::number_unsigned_t value) { return number(static_cast<std::int64_t>(value)); }
+  bool number_float(json::number_float_t /*value*/, const json::string_t& /*text*/) { return true; }
+
+  bool string(json::string_t& value) {
+    switch (top()) {
+      case Scope::kItem:
+        if (key_ == "name") {
+          batch_.record().title = value;
+        }
+        break;
+      case Scope::kLogin:
+        if (key_ == "username") {
+          batch_.record().username = value;
+        } else if (key_ == "password") {
+          batch_.append_password(value);
+        }
+        break;
+      case Scope::kUri:
+        if (key_ == "uri" && batch_.record().url.empty()) {
+          batch_.record().url = value;
+        }
+        break;
+      default:
+        break;
+    }
+    wipe_string(value);
+    return true;
+  }
+
+  bool binary(json::binary_t& /*value*/) { return true; }
+
+  bool start_object(std::size_t /*elements*/) {
+    Scope scope = Scope::kOther;
+    if (scopes_.empty()) {
+      scope = Scope::kRoot;
+    } else if (top() == Scope::kItems) {
+      scope = Scope::kItem;
+      item_type_ = 0;
+    } else if (top() == Scope::kItem && key_ == "login") {
+      scope = Scope::kLogin;
+    } else if (top() == Scope::kUris) {
+      scope = Scope::kUri;
+    }
+    scopes_.push_back(scope);
+    key_.clear();
+    return true;
+  }
+
+  bool key(json::string_t& key) {
+    key_ = key;
+    return true;
+  }
+
+  bool end_object() {
+    if (top() == Scope::kItem) {
+      // 1 is a login; secure notes, cards and identities have no password.
+      if (item_type_ == 1) {
+        batch_.commit();
+      } else {
+        batch_.skip();
+      }
+    }
+    scopes_.pop_back();
+    key_.clear();
+    return true;
+  }
+
+  bool start_array(std::size_t /*elements*/) {
+    Scope scope = Scope::kOther;
+    if (top() == Scope::kRoot && key_ == "items") {
+      scope = Scope::kItems;
+      saw_items_ = true;
+    } else if (top() == Scope::kLogin && key_ == "uris") {
+      scope = Scope::kUris;
+    }
+    scopes_.push_back(scope);
+    key_.clear();
+    return true;
+  }
+
+  bool end_array() {
+    scopes_.pop_back();
+    key_.clear();
+    return true;
+  }
+
+  // nlohmann's message quotes the last token read, which may be part of a
+  // password, so only the position is reported.
+  bool parse_error(std::size_t position, const std::string& /*last_token*/, const nlohmann::detail::exception&) {
+    throw std::runtime_error("Bitwarden JSON: syntax error at byte " + std::to_string(position));
+  }
+
+  [[nodiscard]] bool saw_items() const noexcept { return saw_items_; }
+
+private:
+  enum class Scope { kNone, kRoot, kItems, kItem, kLogin, kUris, kUri, kOther };
+
+  [[nodiscard]] Scope top() const noexcept { return scopes_.empty() ? Scope::kNone : scopes_.back(); }
+
+  bool number(std::int64_t value) {
+    if (top() == Scope::kItem && key_ == "type") {
+      item_type_ = value;
+    }
+    return true;
+  }
+
+  Batcher& batch_;
+  std::vector<Scope> scopes_;
+  std::string key_;
+  std::int64_t item_type_ = 0;
+  bool saw_items_ = false;
+};
+
+void import_bitwarden_json(Reader& reader, Batcher& batch) {
+  BitwardenHandler handler(batch);
+  json::sax_parse(ReaderIterator(reader), ReaderIterator(), &handler);
+  if (!handler.saw_items()) {
+    throw std::runtime_error("Bitwarden JSON: no \"items\" array; is this a Bitwarden export?");
+  }
+}
+
+// ============================================================================
+// KeePass XML
+// ============================================================================
+//
+// Just enough XML for KeePass 2 exports: elements, attributes (skipped),
+// character and entity references, CDATA, comments, processing instructions
+// and a DOCTYPE without an internal subset. Entries are
+//
+//   <Entry><UUID/>...<String><Key>Title</Key><Value>...</Value></String>...
+//          <History><Entry>...</Entry></History></Entry>
+//
+// Only String elements that are direct children of a top-level Entry count,
+// which leaves out the History copies. Entries in the recycle bin group
+// (Meta/RecycleBinUUID) are skipped.
+
+class KeePassImporter {
+public:
+  KeePassImporter(Reader& reader, Batcher& batch) : reader_(reader), batch_(batch) {}
+
+  ~KeePassImporter() { wipe_string(pending_value_); }
+
+  void run() {
+    reader_.skip_utf8_bom("KeePass XML");
+    for (int c = reader_.get(); c != Reader::kEof; c = reader_.get()) {
+      if (c == '<') {
+        markup();
+      } else if (c == '&') {
+        entity();
+      } else {
+        text(static_cast<char>(c));
+      }
+    }
+    if (!saw_root_) {
+      throw std::runtime_error("KeePass XML: no <KeePassFile> element");
+    }
+    if (!stack_.empty()) {
+      fail("unexpected end of input inside <" + stack_.back() + ">");
+    }
+  }
+
+private:
+  enum class Target { kNone, kKey, kTitle, kUsername, kUrl, kPassword, kPending, kRecycleBinUuid, kGroupUuid };
+
+  [[noreturn]] void fail(const std::string& what) { fail_at_line("KeePass XML", reader_, what); }
+
+  int next() {
+    const int c = reader_.get();
+    if (c == Reader::kEof) {
+      fail("unexpected end of input");
+    }
+    return c;
+  }
+
+  static bool is_space(int c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+  void skip_space() {
+    while (is_space(reader_.peek())) {
+      reader_.get();
+    }
+  }
+
+  std::string name() {
+    std::string out;
+    while (!is_space(reader_.peek()) && reader_.peek() != '>' && reader_.peek() != '/' && reader_.peek() != '=' &&
+           reader_.peek() != Reader::kEof) {
+      out.push_back(static_cast<char>(reader_.get()));
+    }
+    if (out.empty()) {
+      fail("expected a name");
+    }
+    return out;
+  }
+
+  // Consumes input up to and including `terminator`.
+  void skip_past(std::string_view terminator) {
+    std::string tail;
+    while (!tail.ends_with(terminator)) {
+      if (tail.size() == terminator.size()) {
+        tail.erase(0, 1);
+      }
+      tail.push_back(static_cast<char>(next()));
+    }
+  }
+
+  void expect(std::string_view literal) {
+    for (const char want : literal) {
+      if (next() != static_cast<unsigned char>(want)) {
+        fail("malformed markup");
+      }
+    }
+  }
+
+  // After a '<'.
+  void markup() {
+    const int c = reader_.peek();
+    if (c == '?') {
+      skip_past("?>");
+    } else if (c == '!') {
+      reader_.get();
+      if (reader_.peek() == '-') {
+        expect("--");
+        skip_past("-->");
+      } else if (reader_.peek() == '[') {
+        expect("[CDATA[");
+        cdata();
+      } else {
+        skip_past(">");  // DOCTYPE
+      }
+    } else if (c == '/') {
+      reader_.get();
+      const std::string closing = name();
+      skip_space();
+      expect(">");
+      end_element(closing);
+    } else {
+      const std::string opening = name();
+      const bool empty = attributes();
+      start_element(opening);
+      if (empty) {
+        end_element(opening);
+      }
+    }
+  }
+
+  // Skips attributes up to '>' or '/>'; returns true for the latter.
+  bool attributes() {
+    for (;;) {
+      skip_space();
+      const int c = next();
+      if (c == '>') {
+        return false;
+      }
+      if (c == '/') {
+        expect(">");
+        return true;
+      }
+      name();
+      skip_space();
+      expect("=");
+      skip_space();
+      const int quote = next();
+      if (quote != '"' && quote != '\'') {
+        fail("attribute value is not quoted");
+      }
+      while (next() != quote) {
+      }
+    }
+  }
+
+  void cdata() {
+    // "]]>" ends the section; a ']' not followed by "]>" is text.
+    std::size_t brackets = 0;
+    for (;;) {
+      const int c = next();
+      if (c == ']') {
+        ++brackets;
+        continue;
+      }
+      if (c == '>' && brackets >= 2) {
+        for (; brackets > 2; --brackets) {
+          text(']');
+        }
+        return;
+      }
+      for (; brackets > 0; --brackets) {
+        text(']');
+      }
+      text(static_cast<char>(c));
+    }
+  }
+
+  // After a '&'. Inside a password Value the reference is password bytes,
+  // so it is read into a stack buffer wiped on every way out, never a
+  // std::string, and an unknown one is not quoted in the error.
+  void entity() {
+    struct RefBuffer {
+      char bytes[10] = {};
+      std::size_t len = 0;
+      ~RefBuffer() { sodium_memzero(bytes, sizeof(bytes)); }
+    } ref;
+    for (int c = next(); c != ';'; c = next()) {
+      if (ref.len == sizeof(ref.bytes)) {
+        fail("unterminated entity reference");
+      }
+      ref.bytes[ref.len++] = static_cast<char>(c);
+    }
+    const std::string_view name(ref.bytes, ref.len);
+    if (name == "lt") {
+      text('<');
+    } else if (name == "gt") {
+      text('>');
+    } else if (name == "amp") {
+      text('&');
+    } else if (name == "quot") {
+      text('"');
+    } else if (name == "apos") {
+      text('\'');
+    } else if (name.size() > 1 && name[0] == '#') {
+      const bool hex = name[1] == 'x';
+      std::uint32_t cp = 0;
+      const std::string_view digits = name.substr(hex ? 2 : 1);
+      if (digits.empty()) {
+        fail("malformed character reference");
+      }
+      for (const char d : digits) {
+        int v = -1;
+        if (d >= '0' && d <= '9') {
+          v = d - '0';
+        } else if (hex && d >= 'a' && d <= 'f') {
+          v = d - 'a' + 10;
+        } else if (hex && d >= 'A' && d <= 'F') {
+          v = d - 'A' + 10;
+        }
+        if (v < 0) {
+          fail("malformed character reference");
+        }
+        cp = cp * (hex ? 16 : 10) + static_cast<std::uint32_t>(v);
+        if (cp > 0x10FFFF) {
+          fail("character reference out of range");
+        }
+      }
+      utf8(cp);
+    } else if (target_ == Target::kPassword || target_ == Target::kPending) {
+      fail("unknown entity reference in a value");
+    } else {
+      fail("unknown entity &" + std::string(name) + ";");
+    }
+  }
+
+  void utf8(std::uint32_t cp) {
+    if (cp < 0x80) {
+      text(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+      text(static_cast<char>(0xC0 | (cp >> 6)));
+      text(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+      text(static_cast<char>(0xE0 | (cp >> 12)));
+      text(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+      text(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else {
+      text(static_cast<char>(0xF0 | (cp >> 18)));
+      text(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+      text(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+      text(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+  }
+
+  void text(char c) {
+    switch (target_) {
+      case Target::kKey:
+        field_key_.push_back(c);
+        break;
+      case Target::kTitle:
+        batch_.record().title.push_back(c);
+        break;
+      case Target::kUsername:
+        batch_.record().username.push_back(c);
+        break;
+      case Target::kUrl:
+        batch_.record().url.push_back(c);
+        break;
+      case Target::kPassword:
+        batch_.push_password(c);
+        break;
+      case Target::kPending:
+        pending_value_.push_back(c);
+        break;
+      case Target::kRecycleBinUuid:
+        recycle_bin_uuid_.push_back(c);
+        break;
+      case Target::kGroupUuid:
+        group_uuid_.push_back(c);
+        break;
+      default:
+        break;
+    }
+  }
+
+  // Where a String's Value goes once its Key is known. Fields other than
+  // these four (Notes, custom fields) are dropped.
+  Target value_target() const {
+    if (field_key_ == "Title") {
+      return Target::kTitle;
+    }
+    if (field_key_ == "UserName") {
+      return Target::kUsername;
+    }
+    if (field_key_ == "URL") {
+      return Target::kUrl;
+    }
+    if (field_key_ == "Password") {
+      return Target::kPassword;
+    }
+    return Target::kNone;
+  }
+
+  void start_element(const std::string& element) {
+    if (stack_.empty()) {
+      if (saw_root_) {
+        fail("content after the root element");
+      }
+      if (element != "KeePassFile") {
+        throw std::runtime_error("KeePass XML: the root element is <" + element + ">, not <KeePassFile>");
+      }
+      saw_root_ = true;
+    }
+    const std::string parent = stack_.empty() ? std::string() : stack_.back();
+    stack_.push_back(element);
+    const std::size_t depth = stack_.size();
+    target_ = Target::kNone;
+
+    if (element == "RecycleBinUUID" && parent == "Meta") {
+      target_ = Target::kRecycleBinUuid;
+    } else if (element == "UUID" && parent == "Group") {
+      group_uuid_.clear();
+      target_ = Target::kGroupUuid;
+    } else if (element == "Entry" && entry_depth_ == 0) {
+      entry_depth_ = depth;
+    } else if (entry_depth_ != 0 && element == "String" && depth == entry_depth_ + 1) {
+      in_string_ = true;
+      key_known_ = false;
+      field_key_.clear();
+    } else if (in_string_ && depth == entry_depth_ + 2) {
+      if (element == "Key") {
+        target_ = Target::kKey;
+      } else if (element == "Value") {
+        // KeePass writes Key first, so the Value goes straight to its
+        // destination; otherwise it waits in pending_value_ for the Key.
+        target_ = key_known_ ? value_target() : Target::kPending;
+      }
+    }
+  }
+
+  void end_element(const std::string& element) {
+    if (stack_.empty() || stack_.back() != element) {
+      fail("</" + element + "> does not close " + (stack_.empty() ? std::string("anything") : "<" + stack_.back() + ">"));
+    }
+    const std::size_t depth = stack_.size();
+    stack_.pop_back();
+    target_ = Target::kNone;
+
+    if (element == "UUID" && !stack_.empty() && stack_.back() == "Group") {
+      if (recycle_bin_depth_ == 0 && !group_uuid_.empty() && group_uuid_ != "AAAAAAAAAAAAAAAAAAAAAA==" &&
+          group_uuid_ == recycle_bin_uuid_) {
+        recycle_bin_depth_ = depth - 1;
+      }
+    } else if (element == "Group" && depth == recycle_bin_depth_) {
+      recycle_bin_depth_ = 0;
+    } else if (element == "Key" && in_string_ && depth == entry_depth_ + 2) {
+      key_known_ = true;
+    } else if (element == "String" && in_string_ && depth == entry_depth_ + 1) {
+      if (!pending_value_.empty() && key_known_) {
+        target_ = value_target();
+        for (const char c : pending_value_) {
+          text(c);
+        }
+        target_ = Target::kNone;
+      }
+      wipe_string(pending_value_);
+      in_string_ = false;
+    } else if (element == "Entry" && depth == entry_depth_) {
+      if (recycle_bin_depth_ != 0) {
+        batch_.skip();
+      } else {
+        batch_.commit();
+      }
+      entry_depth_ = 0;
+    }
+  }
+
+  Reader& reader_;
+  Batcher& batch_;
+  std::vector<std::string> stack_;
+  bool saw_root_ = false;
+  Target target_ = Target::kNone;
+
+  std::size_t entry_depth_ = 0;  // depth of the Entry being read, 0 outside one
+  bool in_string_ = false;
+  bool key_known_ = false;
+  std::string field_key_;
+  std::string pending_value_;
+
+  std::string recycle_bin_uuid_;
+  std::string group_uuid_;
+  std::size_t recycle_bin_depth_ = 0;  // depth of the recycle bin Group while inside it
+};
+
+}  // anonymous namespace
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+std::string_view import_format_name(ImportFormat format) noexcept {
+  switch (format) {
+    case ImportFormat::kCsv:
+      return "csv";
+    case ImportFormat::kBitwardenJson:
+      return "bitwarden-json";
+    case ImportFormat::kKeePassXml:
+      return "keepass-xml";
+    default:
+      return "unknown";
+  }
+}
+
+std::optional<ImportFormat> parse_import_format(std::string_view name) noexcept {
+  for (const ImportFormat format : {ImportFormat::kCsv, ImportFormat::kBitwardenJson, ImportFormat::kKeePassXml}) {
+    if (name == import_format_name(format)) {
+      return format;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<ImportFormat> guess_import_format(const std::filesystem::path& path) {
+  const std::string extension = lowercase_trimmed(path.extension().string());
+  if (extension == ".csv") {
+    return ImportFormat::kCsv;
+  }
+  if (extension == ".json") {
+    return ImportFormat::kBitwardenJson;
+  }
+  if (extension == ".xml") {
+    return ImportFormat::kKeePassXml;
+  }
+  return std::nullopt;
+}
+
+ImportResult import_entries(std::istream& in, ImportFormat format, PrimaryTable& out, const ImportOptions& options) {
+  trace::Span span("import_entries");
+
+  Reader reader(in);
+  Batcher batch(out, options.batch_size);
+  switch (format) {
+    case ImportFormat::kCsv:
+      import_csv(reader, batch);
+      break;
+    case ImportFormat::kBitwardenJson:
+      import_bitwarden_json(reader, batch);
+      break;
+    case ImportFormat::kKeePassXml:
+      KeePassImporter(reader, batch).run();
+      break;
+    default:
+      throw std::invalid_argument("unknown import format");
+  }
+  const ImportResult result = batch.finish();
+  span.arg("imported", result.imported);
+  return result;
+}
+
+ImportResult import_file(const std::filesystem::path& path,
+                         ImportFormat format,
+                         PrimaryTable& out,
+                         const ImportOptions& options) {
+  // Unbuffered, so Reader's wiped buffer is the only copy of the file in
+  // this process.
+  std::ifstream in;
+  in.rdbuf()->pubsetbuf(nullptr, 0);
+  in.open(path, std::ios::binary);
+  if (!in) {
+    throw std::runtime_error("cannot open '" + path.string() + "'");
+  }
+  return import_entries(in, format, out, options);
+}
+
+}  // namespace pwledger
@@ -0,0 +1,283 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pwledger/VaultManager.h>
+
+#include <pwledger/Config.h>
+#include <pwledger/Kernels.h>
+#include <pwledger/ThreadPool.h>
+#include <pwledger/VaultIO.h>
+#include <pwledger/VaultPath.h>
+
+#include <algorithm>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+namespace pwledger {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// The password a Secret holds, up to its first NUL (as prompt_secret and
+// read_secret leave it).
+template <typename F>
+void with_password(const Secret& password, F&& f) {
+  password.with_read_access([&](std::span<const char> buf) {
+    f(std::string_view(buf.data(), ::strnlen(buf.data(), buf.size())));
+  });
+}
+
+void save_one(const VaultManager::Vault& vault) {
+  if (vault.data_key) {
+    VaultIO::save_vault(vault.path, vault.table, *vault.data_key);
+    return;
+  }
+  with_password(vault.password,
+                [&](std::string_view password) { VaultIO::save_vault(vault.path, vault.table, password, vault.kdf); });
+}
+
+}  // namespace
+
+VaultManager::VaultManager() : VaultManager(nullptr) {}
+
+VaultManager::VaultManager(ThreadPool* pool) : pool_(pool) {}
+
+VaultManager::~VaultManager() = default;
+VaultManager::VaultManager(VaultManager&&) noexcept = default;
+VaultManager& VaultManager::operator=(VaultManager&&) noexcept = default;
+
+VaultManager VaultManager::from_config(const VaultConfig& config, ThreadPool* pool) {
+  VaultManager manager(pool);
+  const std::filesystem::path dir = resolve_vault_dir(config);
+  for (const auto& [name, file] : config.vaults) {
+    manager.add(name, dir / file);  // an absolute `file` replaces `dir`
+  }
+  return manager;
+}
+
+ThreadPool& VaultManager::pool() const { return pool_ != nullptr ? *pool_ : ThreadPool::shared(); }
+
+// ----------------------------------------------------------------------------
+// Registry
+// ----------------------------------------------------------------------------
+
+VaultManager::Vault& VaultManager::add(std::string name, std::filesystem::path path) {
+  if (name.empty()) {
+    throw std::invalid_argument("vault name must not be empty");
+  }
+  if (find(name) != nullptr) {
+    throw std::invalid_argument("a vault named '" + name + "' already exists");
+  }
+  auto vault = std::make_unique<Vault>();
+  vault->name = std::move(name);
+  vault->path = std::move(path);
+  vaults_.push_back(std::move(vault));
+  return *vaults_.back();
+}
+
+bool VaultManager::remove(std::string_view name) {
+  const auto it =
+      std::find_if(vaults_.begin(), vaults_.end(), [&](const std::unique_ptr<Vault>& v) { return v->name == name; });
+  if (it == vaults_.end()) {
+    return false;
+  }
+  vaults_.erase(it);  // ~Vault wipes the password and every entry's Secrets
+  return true;
+}
+
+VaultManager::Vault* VaultManager::find(std::string_view name) noexcept {
+  for (const auto& vault : vaults_) {
+    if (vault->name == name) {
+      return vault.get();
+    }
+  }
+  return nullptr;
+}
+
+const VaultManager::Vault* VaultManager::find(std::string_view name) const noexcept {
+  return const_cast<VaultManager*>(this)->find(name);
+}
+
+std::vector<const VaultManager::Vault*> VaultManager::vaults() const {
+  std::vector<const Vault*> out;
+  out.reserve(vaults_.size());
+  for (const auto& vault : vaults_) {
+    out.push_back(vault.get());
+  }
+  return out;
+}
+
+// ----------------------------------------------------------------------------
+// Lock state
+// ----------------------------------------------------------------------------
+
+std::vector<VaultManager::Outcome> VaultManager::unlock(std::vector<UnlockRequest> requests) {
+  std::vector<Outcome> outcomes(requests.size());
+  std::vector<Vault*> targets(requests.size(), nullptr);
+  std::vector<std::size_t> jobs;
+
+  for (std::size_t i = 0; i < requests.size(); ++i) {
+    const std::string& name = requests[i].name;
+    outcomes[i].name = name;
+    Vault* vault = find(name);
+    if (vault == nullptr) {
+      outcomes[i].error = "no vault named '" + name + "'";
+    } else if (vault->unlocked) {
+      outcomes[i].error = "already unlocked";
+    } else if (std::find(targets.begin(), targets.end(), vault) != targets.end()) {
+      outcomes[i].error = "named twice";
+    } else if (!VaultIO::vault_exists(vault->path)) {
+      outcomes[i].error = "no vault file at " + vault->path.string();
+    } else {
+      targets[i] = vault;
+      jobs.push_back(i);
+    }
+  }
+
+  // One task per vault, all of them at once (the caller runs one). Each
+  // touches only its own Vault, request and Outcome.
+  pool().parallel_for(
+      0, jobs.size(),
+      [&](std::size_t job) {
+        const std::size_t i = jobs[job];
+        Vault& vault = *targets[i];
+        const auto start = Clock::now();
+        try {
+          PrimaryTable table;
+          with_password(requests[i].password, [&](std::string_view password) {
+            table = VaultIO::load_vault(vault.path, password, vault.data_key);
+          });
+          // A vault from before KDF parameters were recorded was sealed with
+          // the defaults; its next save records them.
+          vault.kdf = VaultIO::stored_kdf_params(vault.path).value_or(KdfParams{});
+          vault.table = std::move(table);
+          vault.password = std::move(requests[i].password);
+          vault.unlocked = true;
+        } catch (const std::exception& e) {
+          vault.data_key.reset();
+          outcomes[i].error = e.what();
+        }
+        outcomes[i].elapsed = Clock::now() - start;
+      },
+      1, jobs.size());
+
+  return outcomes;
+}
+
+void VaultManager::create(std::string_view name, Secret password, const KdfParams& kdf) {
+  Vault* vault = find(name);
+  if (vault == nullptr) {
+    throw std::invalid_argument("no vault named '" + std::string(name) + "'");
+  }
+  if (vault->unlocked || VaultIO::vault_exists(vault->path)) {
+    throw std::runtime_error("vault '" + vault->name + "' already exists");
+  }
+  ensure_vault_dir_exists(vault->path.parent_path());
+  vault->password = std::move(password);
+  vault->kdf = kdf;
+  vault->unlocked = true;
+  try {
+    save_one(*vault);
+  } catch (...) {
+    lock(name);
+    throw;
+  }
+}
+
+bool VaultManager::lock(std::string_view name) {
+  Vault* vault = find(name);
+  if (vault == nullptr || !vault->unlocked) {
+    return false;
+  }
+  vault->table.clear();
+  vault->password = Secret(1);
+  vault->data_key.reset();
+  vault->unlocked = false;
+  return true;
+}
+
+void VaultManager::lock_all() {
+  for (const auto& vault : vaults_) {
+    lock(vault->name);
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Persistence
+// ----------------------------------------------------------------------------
+
+void VaultManager::save(std::string_view name) const {
+  const Vault* vault = find(name);
+  if (vault == nullptr || !vault->unlocked) {
+    throw std::invalid_argument("vault '" + std::string(name) + "' is not unlocked");
+  }
+  save_one(*vault);
+}
+
+std::vector<VaultManager::Outcome> VaultManager::save_all() const {
+  std::vector<const Vault*> open;
+  for (const auto& vault : vaults_) {
+    if (vault->unlocked) {
+      open.push_back(vault.get());
+    }
+  }
+
+  // Every save derives a fresh key, so these are as slow as unlocking.
+  std::vector<Outcome> outcomes(open.size());
+  pool().parallel_for(
+      0, open.size(),
+      [&](std::size_t i) {
+        outcomes[i].name = open[i]->name;
+        const auto start = Clock::now();
+        try {
+          save_one(*open[i]);
+        } catch (const std::exception& e) {
+          outcomes[i].error = e.what();
+        }
+        outcomes[i].elapsed = Clock::now() - start;
+      },
+      1, open.size());
+  return outcomes;
+}
+
+// ----------------------------------------------------------------------------
+// Across vaults
+// ----------------------------------------------------------------------------
+
+std::vector<VaultManager::EntryRef> VaultManager::entries() const { return search({}); }
+
+std::vector<VaultManager::EntryRef> VaultManager::search(std::string_view query) const {
+  std::vector<EntryRef> out;
+  for (const auto& vault : vaults_) {
+    if (!vault->unlocked) {
+      continue;
+    }
+    for (const auto& [uuid, entry] : vault->table) {
+      if (query.empty() || kernels::icontains(entry.primary_key, query) ||
+          kernels::icontains(entry.username_or_email, query)) {
+        out.push_back({vault.get(), &uuid, &entry});
+      }
+    }
+  }
+  return out;
+}
+
+}  // namespace pwledger
@@ -19,62 +19,80 @@
 #include <pwledger/VaultSerializer.h>
 
 #include <pwledger/SecretEntry.h>
+#include <pwledger/Trace.h>
 
 namespace pwledger {
 
 std::vector<std::uint8_t> VaultSerializer::serialize(const PrimaryTable& table) {
+  trace::Span span("VaultSerializer::serialize");
+  span.arg("entries", table.size());
+
   std::vector<std::uint8_t> out;
   // Rough preallocation estimate: 128 bytes per entry + header
   out.reserve(13 + table.size() * 128);
 
-  // Header
-  write_bytes(out, kMagic, 4);
-  write_u8(out, kVersion);
-  write_u64(out, static_cast<std::uint64_t>(table.size()));
-
-  // Entries
+  write_header(out, static_cast<std::uint64_t>(table.size()));
   for (const auto& [uuid, entry] : table) {
-    write_bytes(out, uuid.bytes.data(), 16);
-
-    write_string(out, entry.primary_key);
-    write_string(out, entry.username_or_email);
-
-    // Secret data reading requires access guard
-    entry.plaintext_secret.with_read_access([&](std::span<const char> buf) {
-      std::size_t len = ::strnlen(buf.data(), buf.size());
-      write_u32(out, static_cast<std::uint32_t>(len));
-      write_bytes(out, reinterpret_cast<const std::uint8_t*>(buf.data()), len);
-    });
+    write_entry(out, uuid, entry);
+  }
 
-    entry.salt.with_read_access([&](std::span<const char> buf) {
-      write_u32(out, static_cast<std::uint32_t>(buf.size()));
-      write_bytes(out, reinterpret_cast<const std::uint8_t*>(buf.data()), buf.size());
-    });
+  span.arg("bytes", out.size());
+  return out;
+}
 
-    // Metadata
-    write_time(out, entry.metadata.created_at);
-    write_time(out, entry.metadata.last_modified_at);
-    write_time(out, entry.metadata.last_used_at);
-
-    // Security Policy
-    write_u32(out, static_cast<std::uint32_t>(entry.security_policy.strength_score));
-    write_u32(out, static_cast<std::uint32_t>(entry.security_policy.reuse_count));
-    write_u8(out, entry.security_policy.two_fa_enabled ? 1 : 0);
-
-    if (entry.security_policy.expires_at.has_value()) {
-      write_u8(out, 1);
-      write_time(out, *entry.security_policy.expires_at);
-    } else {
-      write_u8(out, 0);
-    }
+void VaultSerializer::write_header(std::vector<std::uint8_t>& out, std::uint64_t num_entries) {
+  write_bytes(out, kMagic, 4);
+  write_u8(out, kVersion);
+  write_u64(out, num_entries);
+}
 
-    write_string(out, entry.security_policy.note);
+void VaultSerializer::write_entry(std::vector<std::uint8_t>& out, const Uuid& uuid, const SecretEntry& entry) {
+  write_bytes(out, uuid.bytes.data(), 16);
+
+  write_string(out, entry.primary_key);
+  write_string(out, entry.username_or_email);
+
+  // Secret data reading requires access guard
+  entry.plaintext_secret.with_read_access([&](std::span<const char> buf) {
+    std::size_t len = ::strnlen(buf.data(), buf.size());
+    write_u32(out, static_cast<std::uint32_t>(len));
+    write_bytes(out, reinterpret_cast<const std::uint8_t*>(buf.data()), len);
+  });
+
+  entry.salt.with_read_access([&](std::span<const char> buf) {
+    write_u32(out, static_cast<std::uint32_t>(buf.size()));
+    write_bytes(out, reinterpret_cast<const std::uint8_t*>(buf.data()), buf.size());
+  });
+
+  // Metadata
+  write_time(out, entry.metadata.created_at);
+  write_time(out, entry.metadata.last_modified_at);
+  write_time(out, entry.metadata.last_used_at);
+
+  // Security Policy
+  write_u32(out, static_cast<std::uint32_t>(entry.security_policy.strength_score));
+  write_u32(out, static_cast<std::uint32_t>(entry.security_policy.reuse_count));
+  write_u8(out, entry.security_policy.two_fa_enabled ? 1 : 0);
+
+  if (entry.security_policy.expires_at.has_value()) {
+    write_u8(out, 1);
+    write_time(out, *entry.security_policy.expires_at);
+  } else {
+    write_u8(out, 0);
   }
 
-  return out;
+  write_string(out, entry.security_policy.note);
 }
 
 PrimaryTable VaultSerializer::deserialize(const std::uint8_t* data, std::size_t size) {
+  trace::Span span("VaultSerializer::deserialize");
+  span.arg("bytes", size);
+
+  // Per-entry costs are too fine-grained for spans; they are accumulated
+  // and attached to the deserialize span as arguments instead.
+  trace::Stopwatch secure_alloc_time;
+  trace::Stopwatch insert_time;
+
   PrimaryTable table;
   std::size_t pos = 0;
 
@@ -118,11 +136,12 @@ PrimaryTable VaultSerializer::deserialize(const std::uint8_t* data, std::size_t
     pos += salt_len;
 
     // SecretEntry needs the max allocation sizes (kMaxSecretBytes, kSaltBytes)
-    // We derive them here or pad up to match the runtime defaults (256, 16).
-    // If the serialized secret is longer than 256, we allocate exactly its size.
-    std::size_t alloc_secret = (secret_len > 256) ? secret_len : 256;
+    // We pad up to match the runtime defaults (kMaxSecretBytes, 16).
+    // If the serialized secret is longer than that, we allocate exactly its size.
+    std::size_t alloc_secret = (secret_len > kMaxSecretBytes) ? secret_len : kMaxSecretBytes;
     std::size_t alloc_salt = (salt_len > 16) ? salt_len : 16;
 
+    secure_alloc_time.start();
     SecretEntry entry(std::move(pk), std::move(uoe), alloc_secret, alloc_salt);
 
     // Copy bytes into the hardened buffer
@@ -135,6 +154,7 @@ PrimaryTable VaultSerializer::deserialize(const std::uint8_t* data, std::size_t
       std::memset(buf.data(), 0, buf.size());
       std::memcpy(buf.data(), salt_data, salt_len);
     });
+    secure_alloc_time.stop();
 
     entry.metadata.created_at = read_time(data, pos, size);
     entry.metadata.last_modified_at = read_time(data, pos, size);
@@ -153,9 +173,14 @@ PrimaryTable VaultSerializer::deserialize(const std::uint8_t* data, std::size_t
 
     entry.security_policy.note = read_string(data, pos, size);
 
+    insert_time.start();
     table.emplace(uuid, std::move(entry));
+    insert_time.stop();
   }
 
+  span.arg("entries", num_entries);
+  span.arg("secure_alloc_us", secure_alloc_time.total_us());
+  span.arg("insert_us", insert_time.total_us());
   return table;
 }
 
@@ -0,0 +1,492 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pwledger/VaultSync.h>
+
+#include <pwledger/Kernels.h>
+#include <pwledger/Trace.h>
+#include <pwledger/VaultIO.h>
+#include <pwledger/VaultPath.h>
+#include <pwledger/VaultSerializer.h>
+
+#include <algorithm>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <utility>
+
+#include <sodium.h>
+
+namespace pwledger {
+
+namespace {
+
+constexpr std::uint8_t kDeltaMagic[4] = {'P', 'W', 'L', 'D'};
+constexpr std::uint8_t kStateMagic[4] = {'P', 'W', 'L', 'S'};
+constexpr std::uint8_t kVersion = 1;
+constexpr std::size_t kHeaderBytes = 4 + 1 + 8;
+
+constexpr std::size_t kUuidBytes = 16;
+constexpr std::size_t kHashBytes = std::tuple_size_v<MerkleTree::Hash>;
+
+// Item flags; an ack uses kHasHash alone.
+constexpr std::uint8_t kHasHash = 1;
+constexpr std::uint8_t kHasEntry = 2;
+
+// SecretEntry is move-only, and the table keeps its own. The copy goes into
+// a delta and is wiped with it.
+SecretEntry copy_of(const SecretEntry& entry) {
+  SecretEntry copy(entry.primary_key, entry.username_or_email, entry.plaintext_secret.size(), entry.salt.size());
+  entry.plaintext_secret.with_read_access([&](std::span<const char> src) {
+    copy.plaintext_secret.with_write_access(
+        [&](std::span<char> dst) { std::memcpy(dst.data(), src.data(), src.size()); });
+  });
+  entry.salt.with_read_access([&](std::span<const char> src) {
+    copy.salt.with_write_access([&](std::span<char> dst) { std::memcpy(dst.data(), src.data(), src.size()); });
+  });
+  copy.metadata = entry.metadata;
+  copy.security_policy = entry.security_policy;
+  return copy;
+}
+
+// Whether two versions of an entry differ in nothing but last_used_at, as
+// when the same entry was copied on both machines.
+bool same_but_last_used(const SecretEntry& a, const SecretEntry& b) {
+  if (a.primary_key != b.primary_key || a.username_or_email != b.username_or_email ||
+      a.metadata.created_at != b.metadata.created_at || a.metadata.last_modified_at != b.metadata.last_modified_at ||
+      a.security_policy.strength_score != b.security_policy.strength_score ||
+      a.security_policy.reuse_count != b.security_policy.reuse_count ||
+      a.security_policy.two_fa_enabled != b.security_policy.two_fa_enabled ||
+      a.security_policy.expires_at != b.security_policy.expires_at ||
+      a.security_policy.note != b.security_policy.note) {
+    return false;
+  }
+  const auto same_bytes = [](const Secret& x, const Secret& y) {
+    return x.with_read_access([&](std::span<const char> xs) {
+      return y.with_read_access([&](std::span<const char> ys) {
+        const std::size_t xn = ::strnlen(xs.data(), xs.size());
+        const std::size_t yn = ::strnlen(ys.data(), ys.size());
+        return xn == yn && sodium_memcmp(xs.data(), ys.data(), xn) == 0;
+      });
+    });
+  };
+  return same_bytes(a.plaintext_secret, b.plaintext_secret) && a.salt.size() == b.salt.size() &&
+         same_bytes(a.salt, b.salt);
+}
+
+// Both machines run this on the same pair of versions with the sides
+// swapped, and must agree on the winner.
+bool remote_wins(const SecretEntry& ours,
+                 const MerkleTree::Hash& ours_hash,
+                 const SecretEntry& theirs,
+                 const MerkleTree::Hash& theirs_hash) {
+  if (theirs.metadata.last_modified_at != ours.metadata.last_modified_at) {
+    return theirs.metadata.last_modified_at > ours.metadata.last_modified_at;
+  }
+  if (theirs.metadata.last_used_at != ours.metadata.last_used_at) {
+    return theirs.metadata.last_used_at > ours.metadata.last_used_at;
+  }
+  return theirs_hash > ours_hash;
+}
+
+void write_u64(std::vector<std::uint8_t>& out, std::uint64_t val) {
+  for (int i = 0; i < 8; ++i) {
+    out.push_back(static_cast<std::uint8_t>(val >> (8 * i)));
+  }
+}
+
+void write_record(std::vector<std::uint8_t>& out,
+                  const Uuid& uuid,
+                  const std::optional<MerkleTree::Hash>& hash,
+                  std::uint8_t flags) {
+  out.insert(out.end(), uuid.bytes.begin(), uuid.bytes.end());
+  out.push_back(static_cast<std::uint8_t>(flags | (hash ? kHasHash : 0)));
+  if (hash) {
+    out.insert(out.end(), hash->begin(), hash->end());
+  }
+}
+
+// Bounds-checked reads over a decrypted payload.
+class Reader {
+public:
+  Reader(const std::uint8_t* data, std::size_t size, const char* what) : data_(data), size_(size), what_(what) {}
+
+  void header(const std::uint8_t (&magic)[4]) {
+    if (size_ < kHeaderBytes || std::memcmp(data_, magic, sizeof(magic)) != 0) {
+      throw std::runtime_error(std::string("Not a ") + what_);
+    }
+    if (data_[sizeof(magic)] != kVersion) {
+      throw std::runtime_error(std::string("Unsupported ") + what_ + " version");
+    }
+    pos_ = sizeof(magic) + 1;
+  }
+
+  // A count of records at least `min_record` bytes each.
+  std::size_t count(std::size_t min_record) {
+    const std::uint8_t* p = take(8);
+    std::uint64_t val = 0;
+    for (std::size_t i = 8; i > 0; --i) {
+      val = (val << 8) | p[i - 1];
+    }
+    if (val > (size_ - pos_) / min_record) {
+      truncated();
+    }
+    return static_cast<std::size_t>(val);
+  }
+
+  // A UUID, a flags byte and the hash it announces. Returns the flags.
+  std::uint8_t record(Uuid& uuid, std::optional<MerkleTree::Hash>& hash, std::uint8_t allowed) {
+    std::memcpy(uuid.bytes.data(), take(kUuidBytes), kUuidBytes);
+    const std::uint8_t flags = *take(1);
+    if ((flags & ~(allowed | kHasHash)) != 0) {
+      throw std::runtime_error(std::string(what_) + " has an unknown flag");
+    }
+    if ((flags & kHasHash) != 0) {
+      hash.emplace();
+      std::memcpy(hash->data(), take(kHashBytes), kHashBytes);
+    }
+    return flags;
+  }
+
+  const std::uint8_t* take(std::size_t n) {
+    if (size_ - pos_ < n) {
+      truncated();
+    }
+    const std::uint8_t* p = data_ + pos_;
+    pos_ += n;
+    return p;
+  }
+
+  std::size_t remaining() const noexcept { return size_ - pos_; }
+
+private:
+  [[noreturn]] void truncated() const { throw std::runtime_error(std::string(what_) + " is truncated"); }
+
+  const std::uint8_t* data_;
+  std::size_t size_;
+  std::size_t pos_ = 0;
+  const char* what_;
+};
+
+SyncDelta parse_delta(const std::uint8_t* data, std::size_t size) {
+  Reader in(data, size, "Sync delta");
+  in.header(kDeltaMagic);
+
+  SyncDelta delta;
+  std::vector<bool> has_entry(in.count(kUuidBytes + 1));
+  delta.items.resize(has_entry.size());
+  std::size_t with_entry = 0;
+  for (std::size_t i = 0; i < delta.items.size(); ++i) {
+    has_entry[i] = (in.record(delta.items[i].uuid, delta.items[i].base, kHasEntry) & kHasEntry) != 0;
+    if (has_entry[i]) {
+      ++with_entry;
+    }
+  }
+  delta.acks.resize(in.count(kUuidBytes + 1));
+  for (SyncDelta::Ack& ack : delta.acks) {
+    in.record(ack.uuid, ack.held, 0);
+  }
+
+  const std::size_t payload_size = in.remaining();
+  PrimaryTable entries = VaultSerializer::deserialize(in.take(payload_size), payload_size);
+  if (entries.size() != with_entry) {
+    throw std::runtime_error("Sync delta entries do not match its items");
+  }
+  for (std::size_t i = 0; i < delta.items.size(); ++i) {
+    if (!has_entry[i]) {
+      continue;
+    }
+    auto node = entries.extract(delta.items[i].uuid);
+    if (node.empty()) {
+      throw std::runtime_error("Sync delta entries do not match its items");
+    }
+    delta.items[i].entry.emplace(std::move(node.mapped()));
+  }
+  return delta;
+}
+
+SyncPeerState parse_state(const std::uint8_t* data, std::size_t size) {
+  Reader in(data, size, "Sync state");
+  in.header(kStateMagic);
+
+  SyncPeerState state;
+  const std::size_t base_size = in.count(1);
+  state.base = MerkleTree::parse(in.take(base_size), base_size);
+  state.unacked.resize(in.count(kUuidBytes));
+  for (Uuid& uuid : state.unacked) {
+    std::memcpy(uuid.bytes.data(), in.take(kUuidBytes), kUuidBytes);
+  }
+  if (in.remaining() != 0) {
+    throw std::runtime_error("Sync state has trailing bytes");
+  }
+  return state;
+}
+
+}  // namespace
+
+// ============================================================================
+// Delta and merge
+// ============================================================================
+
+SyncDelta VaultSync::make_delta(const PrimaryTable& table, const MerkleTree& current, SyncPeerState& peer) {
+  trace::Span span("VaultSync::make_delta");
+  SyncDelta delta;
+  const std::vector<MerkleTree::Change> changes = current.diff(peer.base);
+  delta.items.reserve(changes.size());
+  std::vector<Uuid> sent;
+  sent.reserve(changes.size());
+  for (const MerkleTree::Change& change : changes) {
+    SyncDelta::Item item{change.uuid, change.theirs, std::nullopt};
+    if (change.ours) {
+      item.entry.emplace(copy_of(table.at(change.uuid)));
+    }
+    delta.items.push_back(std::move(item));
+    sent.push_back(change.uuid);
+  }
+
+  // An item already tells the peer what this side holds.
+  std::sort(sent.begin(), sent.end());
+  std::sort(peer.unacked.begin(), peer.unacked.end());
+  peer.unacked.erase(std::unique(peer.unacked.begin(), peer.unacked.end()), peer.unacked.end());
+  for (const Uuid& uuid : peer.unacked) {
+    if (!std::binary_search(sent.begin(), sent.end(), uuid)) {
+      delta.acks.push_back({uuid, current.find(uuid)});
+    }
+  }
+  peer.unacked.clear();
+
+  span.arg("items", delta.items.size());
+  span.arg("acks", delta.acks.size());
+  return delta;
+}
+
+SyncReport VaultSync::apply_delta(PrimaryTable& table, MerkleTree& current, SyncPeerState& peer, SyncDelta delta) {
+  Transaction tx(table);
+  SyncReport report = apply_delta(tx, table, current, peer, std::move(delta));
+  tx.commit();
+  return report;
+}
+
+SyncReport VaultSync::apply_delta(Transaction& tx,
+                                  const PrimaryTable& table,
+                                  MerkleTree& current,
+                                  SyncPeerState& peer,
+                                  SyncDelta delta) {
+  trace::Span span("VaultSync::apply_delta");
+  span.arg("items", delta.items.size());
+  span.arg("acks", delta.acks.size());
+
+  // Nothing reaches the table before commit, so each item must be the only
+  // one for its UUID for `table` to be its local side.
+  std::unordered_set<Uuid> seen;
+  seen.reserve(delta.items.size());
+  for (const SyncDelta::Item& item : delta.items) {
+    if (!seen.insert(item.uuid).second) {
+      throw std::runtime_error("Sync delta lists " + item.uuid.to_string() + " twice");
+    }
+  }
+
+  for (const SyncDelta::Ack& ack : delta.acks) {
+    if (ack.held) {
+      peer.base.set(ack.uuid, *ack.held);
+    } else {
+      peer.base.erase(ack.uuid);
+    }
+  }
+
+  SyncReport report;
+  for (SyncDelta::Item& item : delta.items) {
+    const std::optional<MerkleTree::Hash> local = current.find(item.uuid);
+    std::optional<MerkleTree::Hash> remote;
+    if (item.entry) {
+      remote = MerkleTree::hash_entry(item.uuid, *item.entry);
+    }
+
+    // Whatever the merge decides, this is what the sender holds now, and
+    // the sender learns the outcome from the next delta back.
+    if (remote) {
+      peer.base.set(item.uuid, *remote);
+    } else {
+      peer.base.erase(item.uuid);
+    }
+    peer.unacked.push_back(item.uuid);
+
+    if (local == remote) {
+      ++report.unchanged;
+      continue;
+    }
+
+    bool take_remote = true;
+    if (local != item.base) {
+      SyncConflict conflict{item.uuid, SyncConflict::Kind::kBothChanged, true, {}};
+      if (!local) {
+        conflict.kind = SyncConflict::Kind::kRemovedHereChangedThere;
+        conflict.kept_local = false;
+        conflict.primary_key = item.entry->primary_key;
+        report.conflicts.push_back(std::move(conflict));
+      } else if (!remote) {
+        take_remote = false;
+        conflict.kind = SyncConflict::Kind::kChangedHereRemovedThere;
+        conflict.primary_key = table.at(item.uuid).primary_key;
+        report.conflicts.push_back(std::move(conflict));
+      } else {
+        const SecretEntry& ours = table.at(item.uuid);
+        take_remote = remote_wins(ours, *local, *item.entry, *remote);
+        if (!same_but_last_used(ours, *item.entry)) {
+          conflict.kept_local = !take_remote;
+          conflict.primary_key = take_remote ? item.entry->primary_key : ours.primary_key;
+          report.conflicts.push_back(std::move(conflict));
+        }
+      }
+    }
+    if (!take_remote) {
+      continue;
+    }
+
+    // An update replaces the whole entry, metadata included: the old one
+    // is erased and the new one inserted under the same UUID.
+    if (remote) {
+      if (table.contains(item.uuid)) {
+        tx.erase(item.uuid);
+        ++report.updated;
+      } else {
+        ++report.added;
+      }
+      tx.insert(item.uuid, std::move(*item.entry));
+      current.set(item.uuid, *remote);
+    } else {
+      tx.erase(item.uuid);
+      current.erase(item.uuid);
+      ++report.removed;
+    }
+  }
+  span.arg("conflicts", report.conflicts.size());
+  return report;
+}
+
+// ============================================================================
+// Files
+// ============================================================================
+
+std::filesystem::path VaultSync::state_path(const std::filesystem::path& vault_path, std::string_view peer) {
+  const std::filesystem::path name(peer);
+  if (peer.empty() || peer == "." || peer == ".." || name.filename() != name ||
+      peer.find_first_of("/\\") != std::string_view::npos) {
+    throw std::invalid_argument("Peer name must be a plain file name");
+  }
+  std::filesystem::path dir = vault_path;
+  dir += ".sync";
+  return dir / (std::string(peer) + ".state");
+}
+
+void VaultSync::write_delta(const std::filesystem::path& path,
+                            const SyncDelta& delta,
+                            std::string_view password,
+                            const KdfParams& kdf) {
+  trace::Span span("VaultSync::write_delta");
+  span.arg("items", delta.items.size());
+
+  // Sized up front, as VaultSerializer::serialize does, so that growing the
+  // buffer does not leave copies of secrets behind.
+  constexpr std::size_t kRecordBytes = kUuidBytes + 1 + kHashBytes;
+  std::size_t estimate = 3 * kHeaderBytes + (delta.items.size() + delta.acks.size()) * kRecordBytes;
+  std::size_t with_entry = 0;
+  for (const SyncDelta::Item& item : delta.items) {
+    if (item.entry) {
+      const SecretEntry& e = *item.entry;
+      estimate += 96 + e.primary_key.size() + e.username_or_email.size() + e.plaintext_secret.size() +
+                  e.salt.size() + e.security_policy.note.size();
+      ++with_entry;
+    }
+  }
+
+  std::vector<std::uint8_t> out;
+  out.reserve(estimate);
+  out.insert(out.end(), kDeltaMagic, kDeltaMagic + sizeof(kDeltaMagic));
+  out.push_back(kVersion);
+  write_u64(out, delta.items.size());
+  for (const SyncDelta::Item& item : delta.items) {
+    write_record(out, item.uuid, item.base, item.entry ? kHasEntry : 0);
+  }
+  write_u64(out, delta.acks.size());
+  for (const SyncDelta::Ack& ack : delta.acks) {
+    write_record(out, ack.uuid, ack.held, 0);
+  }
+  VaultSerializer::write_header(out, with_entry);
+  for (const SyncDelta::Item& item : delta.items) {
+    if (item.entry) {
+      VaultSerializer::write_entry(out, item.uuid, *item.entry);
+    }
+  }
+  VaultIO::save_serialized(path, out, password, kdf);
+}
+
+SyncDelta VaultSync::read_delta(const std::filesystem::path& path, std::string_view password) {
+  trace::Span span("VaultSync::read_delta");
+  std::vector<std::uint8_t> plaintext = VaultIO::load_serialized(path, password);
+  try {
+    SyncDelta delta = parse_delta(plaintext.data(), plaintext.size());
+    kernels::secure_zero(plaintext.data(), plaintext.size());
+    span.arg("items", delta.items.size());
+    return delta;
+  } catch (...) {
+    kernels::secure_zero(plaintext.data(), plaintext.size());
+    throw;
+  }
+}
+
+void VaultSync::write_state(const std::filesystem::path& path,
+                            const SyncPeerState& state,
+                            std::string_view password,
+                            const KdfParams& kdf) {
+  if (path.has_parent_path()) {
+    ensure_vault_dir_exists(path.parent_path());
+  }
+  std::vector<std::uint8_t> base = state.base.serialize();
+  std::vector<std::uint8_t> out;
+  out.reserve(2 * kHeaderBytes + base.size() + state.unacked.size() * kUuidBytes);
+  out.insert(out.end(), kStateMagic, kStateMagic + sizeof(kStateMagic));
+  out.push_back(kVersion);
+  write_u64(out, base.size());
+  out.insert(out.end(), base.begin(), base.end());
+  kernels::secure_zero(base.data(), base.size());
+  write_u64(out, state.unacked.size());
+  for (const Uuid& uuid : state.unacked) {
+    out.insert(out.end(), uuid.bytes.begin(), uuid.bytes.end());
+  }
+  VaultIO::save_serialized(path, out, password, kdf);
+}
+
+SyncPeerState VaultSync::read_state(const std::filesystem::path& path, std::string_view password) {
+  if (!std::filesystem::exists(path)) {
+    return {};
+  }
+  std::vector<std::uint8_t> plaintext = VaultIO::load_serialized(path, password);
+  try {
+    SyncPeerState state = parse_state(plaintext.data(), plaintext.size());
+    kernels::secure_zero(plaintext.data(), plaintext.size());
+    return state;
+  } catch (...) {
+    kernels::secure_zero(plaintext.data(), plaintext.size());
+    throw;
+  }
+}
+
+}  // namespace pwledger
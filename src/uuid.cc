@@ -18,97 +18,171 @@
 
 #include <pwledger/uuid.h>
 
+#include <pwledger/Kernels.h>
+#include <pwledger/SodiumInit.h>
+
+#include <chrono>
+#include <mutex>
+
+#include <sodium.h>
+
 namespace pwledger {
 
-// Generates a version-4 (random) UUID per RFC 4122.
-// NOT cryptographically secure — see DESIGN NOTES.
-Uuid Uuid::generate() {
-  Uuid id;
+namespace {
+
+// ----------------------------------------------------------------------------
+// V7Generator
+// ----------------------------------------------------------------------------
+// Process-wide generator state: the last timestamp and counter issued, and
+// a pool of CSPRNG output consumed 8 bytes per UUID. One mutex covers both;
+// generate() is far too short for finer locking to pay off.
+class V7Generator {
+ public:
+  Uuid next() {
+    const std::uint64_t now = wall_clock_ms();
+
+    std::lock_guard lock(mutex_);
+    const std::uint64_t rand = take_random();
+    if (now > last_ms_) {
+      last_ms_ = now;
+      counter_ = random_counter_start();
+    } else if (counter_ < kCounterMax) {
+      ++counter_;  // same millisecond, or the clock stepped back
+    } else {
+      ++last_ms_;  // counter exhausted: borrow the next millisecond
+      counter_ = random_counter_start();
+    }
+    return Uuid::from_v7_fields(last_ms_, counter_, rand);
+  }
 
-  std::random_device rd;
-  std::mt19937_64 gen(rd());
-  std::uniform_int_distribution<std::uint64_t> dist;
+ private:
+  static constexpr std::uint16_t kCounterMax = 0x0FFF;
+  static constexpr std::size_t kPoolWords = 512;  // 4 KiB per refill
 
-  std::uint64_t part1 = dist(gen);
-  std::uint64_t part2 = dist(gen);
+  static std::uint64_t wall_clock_ms() {
+    using namespace std::chrono;
+    return static_cast<std::uint64_t>(duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count());
+  }
 
-  std::memcpy(id.bytes.data(), &part1, 8);
-  std::memcpy(id.bytes.data() + 8, &part2, 8);
+  // A random value below 2048: the counter's top bit starts clear, so at
+  // least 2048 more IDs fit in the millisecond (RFC 9562 §6.2).
+  std::uint16_t random_counter_start() { return static_cast<std::uint16_t>(take_random() >> 53); }
+
+  std::uint64_t take_random() {
+    if (pool_pos_ == kPoolWords) {
+      if (!sodium_init_once()) {
+        throw std::runtime_error("Uuid::generate: libsodium initialization failed");
+      }
+      randombytes_buf(pool_.data(), sizeof(pool_));
+      pool_pos_ = 0;
+    }
+    return pool_[pool_pos_++];
+  }
 
-  // Set version to 4 (bits 4–7 of byte 6).
-  id.bytes[6] = (id.bytes[6] & 0x0F) | 0x40;
+  std::mutex mutex_;
+  std::uint64_t last_ms_ = 0;
+  std::uint16_t counter_ = 0;
+  std::array<std::uint64_t, kPoolWords> pool_{};
+  std::size_t pool_pos_ = kPoolWords;
+};
 
-  // Set variant to RFC 4122 (bits 6–7 of byte 8).
-  id.bytes[8] = (id.bytes[8] & 0x3F) | 0x80;
-  return id;
-}
+}  // anonymous namespace
 
-// Formats as the canonical RFC 4122 representation:
-//   xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx
-std::string Uuid::to_string() const {
-  // Byte groups: 4-2-2-2-6, separated by hyphens.
-  constexpr int kGroups[] = {4, 2, 2, 2, 6};
-  constexpr int kNumGroups = 5;
+// Generates a time-ordered version-7 UUID. See GENERATION in uuid.h.
+Uuid Uuid::generate() {
+  static V7Generator generator;
+  return generator.next();
+}
 
-  std::ostringstream oss;
-  oss << std::hex << std::setfill('0');
+Uuid Uuid::from_v7_fields(std::uint64_t unix_ms, std::uint16_t counter, std::uint64_t rand_b) noexcept {
+  Uuid id;
+  for (int i = 0; i < 6; ++i) {
+    id.bytes[static_cast<std::size_t>(i)] = static_cast<std::uint8_t>(unix_ms >> (40 - 8 * i));
+  }
+  id.bytes[6] = static_cast<std::uint8_t>(0x70 | ((counter >> 8) & 0x0F));
+  id.bytes[7] = static_cast<std::uint8_t>(counter);
+  // Variant 10 in the top bits of byte 8, then the low 62 bits of rand_b.
+  id.bytes[8] = static_cast<std::uint8_t>(0x80 | ((rand_b >> 56) & 0x3F));
+  for (int i = 9; i < 16; ++i) {
+    id.bytes[static_cast<std::size_t>(i)] = static_cast<std::uint8_t>(rand_b >> (8 * (15 - i)));
+  }
+  return id;
+}
 
-  int byte_index = 0;
-  for (int g = 0; g < kNumGroups; ++g) {
-    if (g > 0) {
-      oss << '-';
-    }
-    for (int i = 0; i < kGroups[g]; ++i) {
-      oss << std::setw(2) << static_cast<unsigned int>(bytes[byte_index++]);
-    }
+std::optional<std::uint64_t> Uuid::timestamp_ms() const noexcept {
+  if (version() != 7) {
+    return std::nullopt;
+  }
+  std::uint64_t ms = 0;
+  for (int i = 0; i < 6; ++i) {
+    ms = (ms << 8) | bytes[static_cast<std::size_t>(i)];
   }
-  return oss.str();
+  return ms;
 }
 
-// Parses a UUID from its string representation. Accepts both the canonical
-// 36-character form (with hyphens) and the 32-character compact form.
-// Returns std::nullopt on malformed input rather than throwing, so callers
-// can provide user-friendly error messages.
-std::optional<Uuid> Uuid::from_string(std::string_view str) {
-  // Strip hyphens to get a uniform 32-character hex string.
-  std::string hex;
-  hex.reserve(32);
-  for (char c : str) {
-    if (c == '-') {
-      continue;
-    }
-    if (!is_hex_digit(c)) {
+// ----------------------------------------------------------------------------
+// to_chars / from_chars
+// ----------------------------------------------------------------------------
+// The 16-byte hex conversion is kernels::hex_encode/hex_decode, which run
+// the widest SIMD variant this CPU supports (see Kernels.h).
+
+char* Uuid::to_chars(char* out) const noexcept {
+  // 32 hex digits, then spread into 8-4-4-4-12 groups.
+  char hex[32];
+  kernels::hex_encode(bytes.data(), bytes.size(), hex);
+  std::memcpy(out, hex, 8);
+  out[8] = '-';
+  std::memcpy(out + 9, hex + 8, 4);
+  out[13] = '-';
+  std::memcpy(out + 14, hex + 12, 4);
+  out[18] = '-';
+  std::memcpy(out + 19, hex + 16, 4);
+  out[23] = '-';
+  std::memcpy(out + 24, hex + 20, 12);
+  return out + kStringLength;
+}
+
+std::optional<Uuid> Uuid::from_chars(std::string_view str) noexcept {
+  char hex[32];
+  if (str.size() == kStringLength) {
+    const char* s = str.data();
+    if ((s[8] != '-') | (s[13] != '-') | (s[18] != '-') | (s[23] != '-')) {
       return std::nullopt;
     }
-    hex += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
-  }
-  if (hex.size() != 32) {
+    std::memcpy(hex, s, 8);
+    std::memcpy(hex + 8, s + 9, 4);
+    std::memcpy(hex + 12, s + 14, 4);
+    std::memcpy(hex + 16, s + 19, 4);
+    std::memcpy(hex + 20, s + 24, 12);
+  } else if (str.size() == kCompactLength) {
+    std::memcpy(hex, str.data(), 32);
+  } else {
     return std::nullopt;
   }
 
   Uuid id;
-  for (std::size_t i = 0; i < 16; ++i) {
-    id.bytes[i] = static_cast<std::uint8_t>((hex_value(hex[i * 2]) << 4) | hex_value(hex[i * 2 + 1]));
+  if (!kernels::hex_decode(hex, id.bytes.size(), id.bytes.data())) {
+    return std::nullopt;
   }
   return id;
 }
 
-std::ostream& operator<<(std::ostream& os, const Uuid& uuid) {
-  return os << uuid.to_string();
+// Formats as the canonical RFC 4122 representation:
+//   xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx
+std::string Uuid::to_string() const {
+  std::string out(kStringLength, '\0');
+  to_chars(out.data());
+  return out;
 }
 
-bool Uuid::is_hex_digit(char c) noexcept {
-  return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+std::optional<Uuid> Uuid::from_string(std::string_view str) {
+  return from_chars(str);
 }
 
-int Uuid::hex_value(char c) noexcept {
-  if (c >= '0' && c <= '9')
-    return c - '0';
-  if (c >= 'a' && c <= 'f')
-    return 10 + (c - 'a');
-  if (c >= 'A' && c <= 'F')
-    return 10 + (c - 'A');
-  return 0;  // unreachable after is_hex_digit check
+std::ostream& operator<<(std::ostream& os, const Uuid& uuid) {
+  char buf[Uuid::kStringLength];
+  uuid.to_chars(buf);
+  return os.write(buf, Uuid::kStringLength);
 }
 
 }  // namespace pwledger
@@ -0,0 +1,214 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "AdmissionControl.h"
+
+#include <chrono>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+using namespace pwledger;
+using namespace std::chrono_literals;
+using json = nlohmann::json;
+
+namespace {
+
+PendingRequest make_request(const std::string& command, int id, const std::string& query = "") {
+  json req = {{"command", command}, {"id", id}};
+  if (!query.empty()) {
+    req["query"] = query;
+  }
+  return PendingRequest{command, req, {json(id)}};
+}
+
+}  // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// TokenBucket
+// ----------------------------------------------------------------------------
+
+// 1. A fresh bucket allows exactly `burst` requests, then refuses.
+TEST(TokenBucketTest, AllowsBurstThenRefuses) {
+  const auto t0 = AdmissionClock::time_point{} + 1h;
+  TokenBucket bucket(3.0, 1.0);
+
+  EXPECT_TRUE(bucket.try_acquire(t0));
+  EXPECT_TRUE(bucket.try_acquire(t0));
+  EXPECT_TRUE(bucket.try_acquire(t0));
+  EXPECT_FALSE(bucket.try_acquire(t0));
+  EXPECT_EQ(bucket.retry_after(t0), 1000ms);
+}
+
+// 2. Tokens refill at the configured rate and never exceed the burst.
+TEST(TokenBucketTest, RefillsOverTimeUpToBurst) {
+  const auto t0 = AdmissionClock::time_point{} + 1h;
+  TokenBucket bucket(2.0, 4.0);
+
+  EXPECT_TRUE(bucket.try_acquire(t0));
+  EXPECT_TRUE(bucket.try_acquire(t0));
+  EXPECT_FALSE(bucket.try_acquire(t0));
+
+  EXPECT_TRUE(bucket.try_acquire(t0 + 250ms));
+  EXPECT_FALSE(bucket.try_acquire(t0 + 250ms));
+
+  // A long idle period refills to the burst size, not beyond it.
+  const auto later = t0 + 1h;
+  EXPECT_TRUE(bucket.try_acquire(later));
+  EXPECT_TRUE(bucket.try_acquire(later));
+  EXPECT_FALSE(bucket.try_acquire(later));
+}
+
+// ----------------------------------------------------------------------------
+// UnlockBackoff
+// ----------------------------------------------------------------------------
+
+// 3. Each failure doubles the wait; success clears it.
+TEST(UnlockBackoffTest, DoublesAndResets) {
+  const auto t0 = AdmissionClock::time_point{} + 1h;
+  UnlockBackoff backoff;
+
+  EXPECT_FALSE(backoff.blocked_for(t0).has_value());
+
+  backoff.record_failure(t0);
+  ASSERT_TRUE(backoff.blocked_for(t0).has_value());
+  EXPECT_EQ(*backoff.blocked_for(t0), UnlockBackoff::kBase);
+  EXPECT_FALSE(backoff.blocked_for(t0 + UnlockBackoff::kBase).has_value());
+
+  backoff.record_failure(t0);
+  EXPECT_EQ(*backoff.blocked_for(t0), 2 * UnlockBackoff::kBase);
+
+  backoff.record_success();
+  EXPECT_EQ(backoff.consecutive_failures(), 0);
+  EXPECT_FALSE(backoff.blocked_for(t0).has_value());
+}
+
+// 4. The wait is capped at kMax no matter how many failures accumulate.
+TEST(UnlockBackoffTest, CappedAtMax) {
+  const auto t0 = AdmissionClock::time_point{} + 1h;
+  UnlockBackoff backoff;
+
+  for (int i = 0; i < 100; ++i) {
+    backoff.record_failure(t0);
+  }
+  EXPECT_EQ(*backoff.blocked_for(t0), UnlockBackoff::kMax);
+}
+
+// ----------------------------------------------------------------------------
+// RequestQueue
+// ----------------------------------------------------------------------------
+
+// 5. Identical searches are merged into one request carrying every id.
+TEST(RequestQueueTest, MergesIdenticalSearches) {
+  RequestQueue queue;
+
+  EXPECT_FALSE(queue.push(make_request("search", 1, "github")).has_value());
+  EXPECT_FALSE(queue.push(make_request("search", 2, "github")).has_value());
+  EXPECT_FALSE(queue.push(make_request("search", 3, "gitlab")).has_value());
+  EXPECT_EQ(queue.size(), 2u);
+
+  const PendingRequest first = queue.pop();
+  ASSERT_EQ(first.ids.size(), 2u);
+  EXPECT_EQ(*first.ids[0], 1);
+  EXPECT_EQ(*first.ids[1], 2);
+}
+
+// 6. Non-search commands are dispatched ahead of queued searches.
+TEST(RequestQueueTest, PrioritizesNonSearchCommands) {
+  RequestQueue queue;
+
+  EXPECT_FALSE(queue.push(make_request("search", 1, "a")).has_value());
+  EXPECT_FALSE(queue.push(make_request("search", 2, "b")).has_value());
+  EXPECT_FALSE(queue.push(make_request("get_credentials", 3)).has_value());
+  EXPECT_FALSE(queue.push(make_request("lock", 4)).has_value());
+
+  EXPECT_EQ(queue.pop().command, "get_credentials");
+  EXPECT_EQ(queue.pop().command, "lock");
+  EXPECT_EQ(*queue.pop().ids.front(), 1);
+  EXPECT_EQ(*queue.pop().ids.front(), 2);
+  EXPECT_TRUE(queue.empty());
+}
+
+// 7. Too many distinct searches shed the oldest one.
+TEST(RequestQueueTest, ShedsOldestSearch) {
+  RequestQueue queue;
+
+  for (int i = 0; i < static_cast<int>(RequestQueue::kMaxSearches); ++i) {
+    EXPECT_FALSE(queue.push(make_request("search", i, "q" + std::to_string(i))).has_value());
+  }
+  const auto dropped = queue.push(make_request("search", 100, "newest"));
+  ASSERT_TRUE(dropped.has_value());
+  EXPECT_EQ(*dropped->ids.front(), 0);
+  EXPECT_EQ(queue.size(), RequestQueue::kMaxSearches);
+}
+
+// 8. A full queue refuses the incoming request.
+TEST(RequestQueueTest, RefusesWhenFull) {
+  RequestQueue queue;
+
+  for (int i = 0; i < static_cast<int>(RequestQueue::kCapacity); ++i) {
+    EXPECT_FALSE(queue.push(make_request("ping", i)).has_value());
+  }
+  const auto dropped = queue.push(make_request("ping", 100));
+  ASSERT_TRUE(dropped.has_value());
+  EXPECT_EQ(*dropped->ids.front(), 100);
+}
+
+// ----------------------------------------------------------------------------
+// AdmissionController
+// ----------------------------------------------------------------------------
+
+// 9. Exhausting one command's bucket does not affect another, and `lock` is
+// never limited.
+TEST(AdmissionControllerTest, BucketsAreIndependent) {
+  const auto t0 = AdmissionClock::time_point{} + 1h;
+  AdmissionController admission;
+
+  std::optional<json> rejection;
+  for (int i = 0; i < 1000 && !rejection; ++i) {
+    rejection = admission.admit("search", json(i), t0);
+  }
+  ASSERT_TRUE(rejection.has_value());
+  EXPECT_EQ((*rejection)["status"], "error");
+  EXPECT_EQ((*rejection)["message"], "Rate limited");
+  EXPECT_GT((*rejection)["retry_after_ms"].get<long long>(), 0);
+
+  EXPECT_FALSE(admission.admit("get_credentials", json(1), t0).has_value());
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_FALSE(admission.admit("lock", json(i), t0).has_value());
+  }
+}
+
+// 10. A failed unlock blocks the next attempt until the backoff expires.
+TEST(AdmissionControllerTest, UnlockBackoffAfterFailure) {
+  const auto t0 = AdmissionClock::time_point{} + 1h;
+  AdmissionController admission;
+
+  ASSERT_FALSE(admission.admit("unlock", json(1), t0).has_value());
+  admission.record_unlock_result(false, t0);
+
+  const auto rejection = admission.admit("unlock", json(2), t0 + 100ms);
+  ASSERT_TRUE(rejection.has_value());
+  EXPECT_EQ((*rejection)["message"], "Too many failed unlock attempts");
+  EXPECT_EQ((*rejection)["id"], 2);
+  EXPECT_EQ((*rejection)["retry_after_ms"], 400);
+
+  EXPECT_FALSE(admission.admit("unlock", json(3), t0 + UnlockBackoff::kBase).has_value());
+}
@@ -0,0 +1,129 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <pwledger/Argon2.h>
+#include <pwledger/SodiumInit.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include <sodium.h>
+
+using namespace pwledger;
+
+namespace {
+
+using Bytes = std::vector<std::uint8_t>;
+
+class Argon2Test : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() { ASSERT_TRUE(sodium_init_once()); }
+};
+
+Bytes derive(const Argon2idParams& params, std::size_t out_len = 32) {
+  const Bytes password(16, 0x11);
+  const Bytes salt(crypto_pwhash_SALTBYTES, 0x22);
+  Bytes out(out_len);
+  argon2id(out, password, salt, params);
+  return out;
+}
+
+}  // namespace
+
+// 1. RFC 9106 section 5.3: the Argon2id test vector (4 lanes, secret and
+// associated data).
+TEST_F(Argon2Test, Rfc9106TestVector) {
+  const Bytes password(32, 0x01);
+  const Bytes salt(16, 0x02);
+  const Bytes secret(8, 0x03);
+  const Bytes ad(12, 0x04);
+  const Bytes expected = {0x0d, 0x64, 0x0d, 0xf5, 0x8d, 0x78, 0x76, 0x6c, 0x08, 0xc0, 0x37,
+                          0xa3, 0x4a, 0x8b, 0x53, 0xc9, 0xd0, 0x1e, 0xf0, 0x45, 0x2d, 0x75,
+                          0xb6, 0x5e, 0xb5, 0x25, 0x20, 0xe9, 0x6b, 0x01, 0xe6, 0x59};
+
+  for (const std::uint32_t threads : {1u, 2u, 4u}) {
+    Bytes tag(32);
+    argon2id(tag, password, salt, {.passes = 3, .memory_kib = 32, .lanes = 4, .threads = threads}, secret, ad);
+    EXPECT_EQ(tag, expected) << "threads=" << threads;
+  }
+}
+
+// 2. With one lane the result is libsodium's crypto_pwhash, across pass
+// counts, memory sizes (including ones that are not a multiple of 4 KiB)
+// and tag lengths on both sides of H''s 64-byte boundary.
+TEST_F(Argon2Test, OneLaneMatchesLibsodium) {
+  const Bytes password = {'c', 'o', 'r', 'r', 'e', 'c', 't', ' ', 'h', 'o', 'r', 's', 'e'};
+  Bytes salt(crypto_pwhash_SALTBYTES);
+  randombytes_buf(salt.data(), salt.size());
+
+  for (const std::uint32_t passes : {1u, 2u, 3u}) {
+    for (const std::uint32_t memory_kib : {8u, 64u, 1023u, 4096u}) {
+      for (const std::size_t out_len : {16u, 32u, 64u, 65u, 100u}) {
+        Bytes want(out_len);
+        ASSERT_EQ(crypto_pwhash(want.data(), want.size(), reinterpret_cast<const char*>(password.data()),
+                                password.size(), salt.data(), passes, std::size_t{memory_kib} * 1024,
+                                crypto_pwhash_ALG_ARGON2ID13),
+                  0);
+        Bytes got(out_len);
+        argon2id(got, password, salt, {.passes = passes, .memory_kib = memory_kib, .lanes = 1});
+        ASSERT_EQ(got, want) << "t=" << passes << " m=" << memory_kib << " len=" << out_len;
+      }
+    }
+  }
+}
+
+// 3. The thread count only changes how the lanes are scheduled, never the
+// output; lanes beyond the thread count are shared round-robin.
+TEST_F(Argon2Test, ThreadCountDoesNotChangeOutput) {
+  const Bytes one = derive({.passes = 2, .memory_kib = 1024, .lanes = 6, .threads = 1});
+  for (const std::uint32_t threads : {0u, 2u, 4u, 6u, 16u}) {
+    EXPECT_EQ(derive({.passes = 2, .memory_kib = 1024, .lanes = 6, .threads = threads}), one)
+        << "threads=" << threads;
+  }
+}
+
+// 4. The lane count is part of the function: the same cost with a
+// different p is a different key.
+TEST_F(Argon2Test, LanesChangeOutput) {
+  const Bytes p1 = derive({.passes = 2, .memory_kib = 1024, .lanes = 1});
+  const Bytes p2 = derive({.passes = 2, .memory_kib = 1024, .lanes = 2});
+  const Bytes p4 = derive({.passes = 2, .memory_kib = 1024, .lanes = 4});
+  EXPECT_NE(p1, p2);
+  EXPECT_NE(p2, p4);
+  EXPECT_NE(p1, p4);
+}
+
+// 5. Parameters RFC 9106 does not allow are rejected before any memory is
+// allocated.
+TEST_F(Argon2Test, InvalidParametersThrow) {
+  const Bytes password(8, 0x01);
+  const Bytes salt(16, 0x02);
+  Bytes out(32);
+  Bytes short_out(3);
+  const Bytes short_salt(7, 0x02);
+
+  EXPECT_THROW(argon2id(short_out, password, salt, {}), std::invalid_argument);
+  EXPECT_THROW(argon2id(out, password, short_salt, {}), std::invalid_argument);
+  EXPECT_THROW(argon2id(out, password, salt, {.passes = 0}), std::invalid_argument);
+  EXPECT_THROW(argon2id(out, password, salt, {.lanes = 0}), std::invalid_argument);
+  EXPECT_THROW(argon2id(out, password, salt, {.memory_kib = 31, .lanes = 4}), std::invalid_argument);
+  EXPECT_NO_THROW(argon2id(out, password, salt, {.passes = 1, .memory_kib = 32, .lanes = 4}));
+}
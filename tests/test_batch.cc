@@ -0,0 +1,296 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BatchMode.h"
+
+#include <pwledger/SodiumInit.h>
+#include <pwledger/VaultIO.h>
+
+#include <nlohmann/json.hpp>
+#include <sodium.h>
+
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace pwledger;
+using nlohmann::json;
+
+namespace {
+
+class BatchTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() { ASSERT_TRUE(sodium_init_once()); }
+
+  void SetUp() override {
+    ASSERT_EQ(::pipe(secret_pipe_), 0);
+    ASSERT_EQ(::pipe(input_pipe_), 0);
+    ::fcntl(secret_pipe_[0], F_SETFL, O_NONBLOCK);
+    state_ = std::make_unique<AppState>();
+    options_.secret_fd = secret_pipe_[1];
+    options_.input_fd = input_pipe_[0];
+  }
+
+  void TearDown() override {
+    for (int fd : {secret_pipe_[0], secret_pipe_[1], input_pipe_[0], input_pipe_[1]}) {
+      ::close(fd);
+    }
+  }
+
+  // Queues lines for add/update to read.
+  void feed(const std::string& text) {
+    ASSERT_EQ(::write(input_pipe_[1], text.data(), text.size()), static_cast<ssize_t>(text.size()));
+  }
+
+  // Everything written to the secret fd so far.
+  std::string drain_secrets() {
+    std::string out;
+    char buf[512];
+    for (ssize_t n; (n = ::read(secret_pipe_[0], buf, sizeof(buf))) > 0;) {
+      out.append(buf, static_cast<std::size_t>(n));
+    }
+    return out;
+  }
+
+  // Runs `script`, returning the JSON objects written to stdout.
+  std::vector<json> run_script(const std::string& script) {
+    std::istringstream in(script);
+    std::ostringstream out;
+    BatchRunner runner(*state_, out, options_);
+    runner.run_script(in);
+    last_changed_ = runner.changed();
+    last_failed_ = runner.failed();
+
+    std::vector<json> lines;
+    std::istringstream lines_in(out.str());
+    for (std::string line; std::getline(lines_in, line);) {
+      lines.push_back(json::parse(line));
+    }
+    return lines;
+  }
+
+  std::unique_ptr<AppState> state_;
+  BatchOptions options_;
+  bool last_changed_ = false;
+  std::size_t last_failed_ = 0;
+  int secret_pipe_[2] = {-1, -1};
+  int input_pipe_[2] = {-1, -1};
+};
+
+TEST(SplitCommandLineTest, WordsQuotesAndComments) {
+  EXPECT_EQ(split_command_line("get --name x"), (std::vector<std::string>{"get", "--name", "x"}));
+  EXPECT_EQ(split_command_line("  add\t--name \"My Bank\"  --user \"a\"\"b\"\r"),
+            (std::vector<std::string>{"add", "--name", "My Bank", "--user", "a\"b"}));
+  EXPECT_EQ(split_command_line("get --name \"\""), (std::vector<std::string>{"get", "--name", ""}));
+  EXPECT_TRUE(split_command_line("   # just a comment").empty());
+  EXPECT_EQ(split_command_line("list # trailing"), (std::vector<std::string>{"list"}));
+  EXPECT_THROW(split_command_line("get --name \"open"), std::runtime_error);
+}
+
+TEST_F(BatchTest, AddGetListDelete) {
+  feed("s3cret\nother\n");
+  const auto lines = run_script(
+      "add --name mail --user alice@example.com\n"
+      "add --name bank\n"
+      "\n"
+      "# comment\n"
+      "get --name mail --field password\n"
+      "get --name mail --field username\n"
+      "list\n"
+      "delete --name bank\n");
+
+  ASSERT_EQ(lines.size(), 8u);  // 5 results + 2 list rows + list result
+  EXPECT_EQ(lines[0]["cmd"], "add");
+  EXPECT_EQ(lines[0]["line"], 1);
+  EXPECT_TRUE(lines[0]["ok"].get<bool>());
+  EXPECT_EQ(lines[0]["uuid"].get<std::string>().size(), 36u);
+
+  EXPECT_EQ(lines[2]["field"], "password");
+  EXPECT_EQ(lines[2]["fd"], options_.secret_fd);
+  EXPECT_FALSE(lines[2].contains("value"));
+  EXPECT_EQ(drain_secrets(), "s3cret\n");
+
+  EXPECT_EQ(lines[3]["value"], "alice@example.com");
+
+  EXPECT_EQ(lines[4]["name"], "bank");  // sorted by name
+  EXPECT_EQ(lines[5]["name"], "mail");
+  EXPECT_EQ(lines[6]["count"], 2);
+
+  EXPECT_TRUE(lines[7]["ok"].get<bool>());
+  EXPECT_EQ(state_->table.size(), 1u);
+  EXPECT_TRUE(last_changed_);
+  EXPECT_EQ(last_failed_, 0u);
+}
+
+TEST_F(BatchTest, ListSortsAndPages) {
+  feed("1\n2\n3\n");
+  const auto lines = run_script(
+      "add --name a\n"
+      "add --name b\n"
+      "add --name c\n"
+      "list --sort -name --page 2 --page-size 2\n"
+      "list --page 5 --page-size 2\n");
+
+  ASSERT_EQ(lines.size(), 6u);
+  EXPECT_EQ(lines[3]["name"], "a");
+  EXPECT_EQ(lines[4]["count"], 1);
+  EXPECT_EQ(lines[4]["total"], 3);
+  EXPECT_EQ(lines[5]["count"], 0);
+}
+
+TEST_F(BatchTest, StopsAtTheFirstFailure) {
+  feed("pw\n");
+  const auto lines = run_script(
+      "add --name a\n"
+      "delete --name missing\n"
+      "add --name b\n");
+
+  ASSERT_EQ(lines.size(), 2u);
+  EXPECT_FALSE(lines[1]["ok"].get<bool>());
+  EXPECT_EQ(lines[1]["line"], 2);
+  EXPECT_NE(lines[1]["error"].get<std::string>().find("missing"), std::string::npos);
+  EXPECT_EQ(last_failed_, 1u);
+}
+
+TEST_F(BatchTest, KeepGoingRunsEverything) {
+  options_.keep_going = true;
+  feed("pw\n");
+  const auto lines = run_script(
+      "frobnicate\n"
+      "get --name a\n"
+      "add --name a --bogus x\n"
+      "add --name a\n"
+      "get --name a\n");
+
+  ASSERT_EQ(lines.size(), 5u);
+  EXPECT_FALSE(lines[0]["ok"].get<bool>());
+  EXPECT_FALSE(lines[1]["ok"].get<bool>());
+  EXPECT_FALSE(lines[2]["ok"].get<bool>());
+  EXPECT_TRUE(lines[3]["ok"].get<bool>());
+  EXPECT_EQ(lines[4]["entry"]["name"], "a");
+  EXPECT_EQ(last_failed_, 3u);
+}
+
+TEST_F(BatchTest, PasswordNeedsASecretFd) {
+  options_.secret_fd = -1;
+  feed("pw\n");
+  const auto lines = run_script(
+      "add --name a\n"
+      "get --name a --field password\n");
+
+  ASSERT_EQ(lines.size(), 2u);
+  EXPECT_FALSE(lines[1]["ok"].get<bool>());
+}
+
+TEST_F(BatchTest, AmbiguousNamesNeedAUuid) {
+  feed("one\ntwo\nnew\n");
+  auto lines = run_script(
+      "add --name dup\n"
+      "add --name dup\n"
+      "update --name dup\n");
+  ASSERT_EQ(lines.size(), 3u);
+  EXPECT_FALSE(lines[2]["ok"].get<bool>());
+
+  const std::string uuid = lines[1]["uuid"];
+  lines = run_script("update --uuid " + uuid + "\nget --uuid " + uuid + " --field password\n");
+  ASSERT_EQ(lines.size(), 2u);
+  EXPECT_TRUE(lines[1]["ok"].get<bool>());
+  EXPECT_EQ(drain_secrets(), "new\n");
+}
+
+TEST_F(BatchTest, MissingSecretInputFails) {
+  ::close(input_pipe_[1]);
+  input_pipe_[1] = -1;
+  const auto lines = run_script("add --name a\n");
+  ASSERT_EQ(lines.size(), 1u);
+  EXPECT_FALSE(lines[0]["ok"].get<bool>());
+  EXPECT_TRUE(state_->table.empty());
+  EXPECT_FALSE(last_changed_);
+}
+
+// `--batch -` with the default input fd: the password, the script and the
+// secrets all arrive on stdin through one pipe, each secret on the line
+// after its add. A line out of step with the script is reported without
+// its text.
+TEST_F(BatchTest, ScriptAndSecretsShareStdin) {
+  const std::filesystem::path vault =
+      std::filesystem::temp_directory_path() / ("pwledger_batch_stdin_" + std::to_string(::getpid()) + ".vault");
+  const KdfParams fast{crypto_pwhash_OPSLIMIT_MIN, crypto_pwhash_MEMLIMIT_MIN, 1};
+  VaultIO::save_vault(vault, PrimaryTable{}, "master", fast);
+
+  int stdin_pipe[2] = {-1, -1};
+  ASSERT_EQ(::pipe(stdin_pipe), 0);
+  const std::string input =
+      "master\n"
+      "add --name alpha\n"
+      "supersecret1\n"
+      "add --name beta --user bob\n"
+      "supersecret2\n"
+      "supersecret3\n";
+  ASSERT_EQ(::write(stdin_pipe[1], input.data(), input.size()), static_cast<ssize_t>(input.size()));
+  ::close(stdin_pipe[1]);
+
+  const int saved_stdin = ::dup(0);
+  ASSERT_GE(saved_stdin, 0);
+  ::dup2(stdin_pipe[0], 0);
+  ::close(stdin_pipe[0]);
+  std::ostringstream out;
+  std::streambuf* saved_cout = std::cout.rdbuf(out.rdbuf());
+  AppState state;
+  const int status = run_batch_main(state, {"--vault", vault.string(), "--keep-going", "--batch", "-"});
+  std::cout.rdbuf(saved_cout);
+  ::dup2(saved_stdin, 0);
+  ::close(saved_stdin);
+
+  EXPECT_EQ(status, 1);
+  EXPECT_EQ(out.str().find("supersecret"), std::string::npos) << out.str();
+  std::vector<json> lines;
+  std::istringstream lines_in(out.str());
+  for (std::string line; std::getline(lines_in, line);) {
+    lines.push_back(json::parse(line));
+  }
+  ASSERT_EQ(lines.size(), 4u);
+  EXPECT_TRUE(lines[0]["ok"].get<bool>()) << lines[0];
+  EXPECT_TRUE(lines[1]["ok"].get<bool>()) << lines[1];
+  EXPECT_FALSE(lines[2]["ok"].get<bool>());
+  EXPECT_EQ(lines[2]["cmd"], "");
+  EXPECT_EQ(lines[2]["error"], "unknown command");
+  EXPECT_TRUE(lines[3]["saved"].get<bool>());
+
+  const PrimaryTable table = VaultIO::load_vault(vault, "master");
+  ASSERT_EQ(table.size(), 2u);
+  for (const auto& [uuid, entry] : table) {
+    const std::string expected = entry.primary_key == "alpha" ? "supersecret1" : "supersecret2";
+    entry.plaintext_secret.with_read_access([&](std::span<const char> buf) {
+      EXPECT_EQ(std::string(buf.data(), ::strnlen(buf.data(), buf.size())), expected);
+    });
+  }
+  std::filesystem::remove(vault);
+}
+
+}  // namespace
@@ -0,0 +1,282 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "EntryPicker.h"
+
+#include <pwledger/CompletionIndex.h>
+#include <pwledger/SodiumInit.h>
+
+#include <algorithm>
+#include <optional>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace pwledger;
+
+namespace {
+
+Uuid make_uuid(std::uint8_t n) {
+  Uuid uuid;
+  uuid.bytes[15] = n;
+  uuid.bytes[0] = 1;
+  return uuid;
+}
+
+TEST(CompletionIndexTest, CountsAndCompletes) {
+  CompletionIndex index;
+  index.insert("github.com", make_uuid(1));
+  index.insert("gitlab.com", make_uuid(2));
+  index.insert("GitHub Enterprise", make_uuid(3));
+  index.insert("mail", make_uuid(4));
+
+  EXPECT_EQ(index.size(), 4u);
+  EXPECT_EQ(index.count(""), 4u);
+  EXPECT_EQ(index.count("git"), 3u);
+  EXPECT_EQ(index.count("GITHUB"), 2u);  // case-folded
+  EXPECT_EQ(index.count("github."), 1u);
+  EXPECT_EQ(index.count("gitx"), 0u);
+
+  EXPECT_EQ(index.completion("g"), "it");
+  EXPECT_EQ(index.completion("gith"), "ub");
+  EXPECT_EQ(index.completion("github."), "com");
+  EXPECT_EQ(index.completion("m"), "ail");
+  EXPECT_EQ(index.completion("mail"), "");
+  EXPECT_EQ(index.completion("x"), "");
+}
+
+TEST(CompletionIndexTest, CursorNarrowsAndWidens) {
+  CompletionIndex index;
+  index.insert("bank", make_uuid(1));
+  index.insert("bankofamerica", make_uuid(2));
+  index.insert("barn", make_uuid(3));
+
+  auto cursor = index.cursor();
+  cursor.push('B');
+  EXPECT_EQ(cursor.count(), 3u);
+  cursor.push("ank");
+  EXPECT_EQ(cursor.prefix(), "bank");
+  EXPECT_EQ(cursor.count(), 2u);
+  EXPECT_EQ(cursor.exact(), std::vector<Uuid>{make_uuid(1)});
+
+  cursor.push("zz");  // past any key
+  EXPECT_FALSE(cursor.matches());
+  EXPECT_EQ(cursor.count(), 0u);
+  EXPECT_TRUE(cursor.candidates(10).empty());
+  cursor.pop();
+  cursor.pop();
+  EXPECT_TRUE(cursor.matches());
+  EXPECT_EQ(cursor.count(), 2u);
+
+  cursor.pop();
+  cursor.pop();
+  EXPECT_EQ(cursor.count(), 3u);  // "ba"
+  EXPECT_TRUE(cursor.exact().empty());
+  EXPECT_EQ(cursor.candidates(10), (std::vector<Uuid>{make_uuid(1), make_uuid(2), make_uuid(3)}));
+  EXPECT_EQ(cursor.candidates(2).size(), 2u);
+
+  cursor.reset();
+  EXPECT_EQ(cursor.count(), 3u);
+  cursor.pop();  // nothing to pop
+  EXPECT_EQ(cursor.prefix(), "");
+}
+
+TEST(CompletionIndexTest, EntryIsACandidateOnce) {
+  ASSERT_TRUE(sodium_init_once());
+  CompletionIndex index;
+  SecretEntry entry("alice", "alice@example.com", 8, 8);
+  index.insert(make_uuid(1), entry);
+  EXPECT_EQ(index.size(), 2u);
+  EXPECT_EQ(index.count("alice"), 2u);
+  EXPECT_EQ(index.candidates("alice", 10), std::vector<Uuid>{make_uuid(1)});
+
+  index.erase(make_uuid(1), entry);
+  EXPECT_EQ(index.size(), 0u);
+  EXPECT_EQ(index.node_count(), 1u);  // just the root
+}
+
+TEST(CompletionIndexTest, EraseRestoresCompression) {
+  CompletionIndex index;
+  index.insert("abc", make_uuid(1));
+  index.insert("abd", make_uuid(2));
+  index.insert("ab", make_uuid(3));
+  EXPECT_EQ(index.node_count(), 4u);  // root, "ab", "c", "d"
+
+  EXPECT_FALSE(index.erase("abx", make_uuid(1)));
+  EXPECT_FALSE(index.erase("abc", make_uuid(9)));
+  EXPECT_TRUE(index.erase("ab", make_uuid(3)));
+  EXPECT_EQ(index.node_count(), 4u);  // "ab" still branches
+  EXPECT_TRUE(index.erase("abd", make_uuid(2)));
+  EXPECT_EQ(index.node_count(), 2u);  // root, "abc"
+  EXPECT_EQ(index.completion("a"), "bc");
+  EXPECT_EQ(index.count("abc"), 1u);
+}
+
+// Random inserts and erases, checked against a brute-force scan.
+TEST(CompletionIndexTest, MatchesBruteForce) {
+  std::mt19937 rng(42);
+  const std::string alphabet = "abcAB.";
+  auto random_key = [&] {
+    std::string key(1 + rng() % 6, ' ');
+    for (char& c : key) {
+      c = alphabet[rng() % alphabet.size()];
+    }
+    return key;
+  };
+  auto fold = [](std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(), fold_key_char);
+    return s;
+  };
+
+  CompletionIndex index;
+  std::set<std::pair<std::string, std::uint8_t>> live;  // (folded key, uuid)
+  for (int step = 0; step < 4000; ++step) {
+    const std::uint8_t id = static_cast<std::uint8_t>(rng() % 40);
+    const std::string key = random_key();
+    if (rng() % 3 != 0) {
+      index.insert(key, make_uuid(id));
+      live.emplace(fold(key), id);
+    } else {
+      EXPECT_EQ(index.erase(key, make_uuid(id)), live.erase({fold(key), id}) == 1);
+    }
+
+    const std::string prefix = random_key().substr(0, rng() % 3);
+    std::size_t expected = 0;
+    std::set<std::uint8_t> ids;
+    for (const auto& [k, i] : live) {
+      if (k.starts_with(fold(prefix))) {
+        ++expected;
+        ids.insert(i);
+      }
+    }
+    ASSERT_EQ(index.count(prefix), expected) << "step " << step << " prefix '" << prefix << "'";
+    ASSERT_EQ(index.candidates(prefix, 1000).size(), ids.size());
+  }
+  EXPECT_EQ(index.size(), live.size());
+
+  for (const auto& [k, i] : std::set(live)) {
+    EXPECT_TRUE(index.erase(k, make_uuid(i)));
+  }
+  EXPECT_EQ(index.node_count(), 1u);
+}
+
+// ----------------------------------------------------------------------------
+// Entry picker
+// ----------------------------------------------------------------------------
+
+class EntryPickerTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() { ASSERT_TRUE(sodium_init_once()); }
+
+  Uuid add(const std::string& name, const std::string& user) {
+    const Uuid uuid = Uuid::generate();
+    const auto [it, inserted] = table_.emplace(uuid, SecretEntry(name, user, 16, 16));
+    index_.insert(uuid, it->second);
+    return uuid;
+  }
+
+  std::optional<Uuid> resolve(const std::string& text, const std::string& answer = "") {
+    std::istringstream in(answer);
+    out_.str("");
+    return resolve_entry(table_, index_, text, in, out_);
+  }
+
+  PrimaryTable table_;
+  CompletionIndex index_;
+  std::ostringstream out_;
+};
+
+TEST_F(EntryPickerTest, EditorCompletesAndNarrows) {
+  add("github.com", "alice@example.com");
+  add("gitlab.com", "");
+  std::ostringstream screen;
+  EntryLineEditor editor(table_, index_, screen, "Entry: ");
+
+  editor.feed('G');
+  editor.feed('\t');
+  EXPECT_EQ(editor.text(), "Git");
+  EXPECT_NE(screen.str().find("(2 matches)"), std::string::npos);
+
+  // The keys diverge here, so the next Tab lists them.
+  screen.str("");
+  editor.feed('\t');
+  EXPECT_NE(screen.str().find("  github.com <alice@example.com>\n"), std::string::npos);
+  EXPECT_NE(screen.str().find("  gitlab.com\n"), std::string::npos);
+
+  editor.feed('h');
+  EXPECT_NE(screen.str().find("-> github.com <alice@example.com>"), std::string::npos);
+  editor.feed('\t');
+  EXPECT_EQ(editor.text(), "Github.com");
+  EXPECT_EQ(editor.feed('\r'), EntryLineEditor::Status::kDone);
+}
+
+TEST_F(EntryPickerTest, EditorEditsByCodePoint) {
+  add("caf\xC3\xA9", "");
+  std::ostringstream screen;
+  EntryLineEditor editor(table_, index_, screen, "Entry: ");
+
+  for (const char c : std::string("caf\xC3\xA9x")) {
+    editor.feed(c);
+  }
+  EXPECT_NE(screen.str().find("(no match)"), std::string::npos);
+  editor.feed(127);
+  editor.feed(127);
+  EXPECT_EQ(editor.text(), "caf");
+  EXPECT_EQ(index_.cursor().count(), 1u);
+
+  // Arrow keys are swallowed whole.
+  for (const char c : std::string("\033[A\033OD")) {
+    editor.feed(c);
+  }
+  EXPECT_EQ(editor.text(), "caf");
+
+  editor.feed(21);  // Ctrl-U
+  EXPECT_EQ(editor.text(), "");
+  EXPECT_EQ(editor.feed(4), EntryLineEditor::Status::kCancelled);  // Ctrl-D
+}
+
+TEST_F(EntryPickerTest, ResolvesTextToOneEntry) {
+  const Uuid hub = add("github.com", "alice@example.com");
+  const Uuid lab = add("gitlab.com", "");
+  const Uuid mail1 = add("mail", "alice@example.com");
+  const Uuid mail2 = add("mail", "bob@example.com");
+
+  EXPECT_EQ(resolve(lab.to_string()), lab);
+  EXPECT_EQ(resolve("  GitLab.com "), lab);  // exact, case-folded, trimmed
+  EXPECT_EQ(resolve("gith"), hub);           // the only match
+  EXPECT_EQ(resolve("git", "2"), lab);       // numbered, keys in byte order
+  EXPECT_NE(out_.str().find("1) github.com"), std::string::npos);
+
+  // Two entries named "mail": an exact match still has to be chosen.
+  const auto chosen = resolve("mail", "1");
+  ASSERT_TRUE(chosen.has_value());
+  EXPECT_TRUE(*chosen == mail1 || *chosen == mail2);
+
+  EXPECT_EQ(resolve("alice@", "3"), std::nullopt);  // out of range
+  EXPECT_EQ(resolve("alice@", "x"), std::nullopt);
+  EXPECT_EQ(resolve("zzz"), std::nullopt);
+  EXPECT_NE(out_.str().find("no entry matches 'zzz'"), std::string::npos);
+  EXPECT_EQ(resolve(" "), std::nullopt);
+}
+
+}  // namespace
@@ -78,6 +78,10 @@ TEST_F(ConfigTest, DefaultValues) {
 
   EXPECT_TRUE(cfg.integration.browser_native_host);
   EXPECT_TRUE(cfg.integration.allowed_extensions.empty());
+
+  EXPECT_EQ(cfg.thread_pool.threads, 0);
+  EXPECT_TRUE(cfg.thread_pool.drain_on_shutdown);
+  EXPECT_EQ(cfg.thread_pool.scrub_stack_kib, 16);
 }
 
 // 2. Loading from a non-existent file returns defaults without throwing.
@@ -104,6 +108,7 @@ TEST_F(ConfigTest, SaveAndLoad) {
   original.vault.directory     = "/custom/vaults";
   original.vault.default_vault = "mydb.pwl";
   original.vault.auto_unlock   = true;
+  original.vault.vaults        = {{"team", "team.dat"}, {"ci", "/srv/ci.dat"}};
 
   original.cli.color                  = false;
   original.cli.confirm_before_delete  = false;
@@ -112,6 +117,10 @@ TEST_F(ConfigTest, SaveAndLoad) {
   original.integration.browser_native_host = false;
   original.integration.allowed_extensions  = {"ext1", "ext2"};
 
+  original.thread_pool.threads           = 3;
+  original.thread_pool.drain_on_shutdown = false;
+  original.thread_pool.scrub_stack_kib   = 0;
+
   EXPECT_NO_THROW(save_config(original, test_config_path));
 
   Config loaded = load_config(test_config_path);
@@ -126,6 +135,7 @@ TEST_F(ConfigTest, SaveAndLoad) {
   EXPECT_EQ(loaded.vault.directory, "/custom/vaults");
   EXPECT_EQ(loaded.vault.default_vault, "mydb.pwl");
   EXPECT_TRUE(loaded.vault.auto_unlock);
+  EXPECT_EQ(loaded.vault.vaults, original.vault.vaults);
 
   EXPECT_FALSE(loaded.cli.color);
   EXPECT_FALSE(loaded.cli.confirm_before_delete);
@@ -135,6 +145,10 @@ TEST_F(ConfigTest, SaveAndLoad) {
   ASSERT_EQ(loaded.integration.allowed_extensions.size(), 2);
   EXPECT_EQ(loaded.integration.allowed_extensions[0], "ext1");
   EXPECT_EQ(loaded.integration.allowed_extensions[1], "ext2");
+
+  EXPECT_EQ(loaded.thread_pool.threads, 3);
+  EXPECT_FALSE(loaded.thread_pool.drain_on_shutdown);
+  EXPECT_EQ(loaded.thread_pool.scrub_stack_kib, 0);
 }
 
 // 4. Partial JSON only overrides specified keys; all others retain defaults.
@@ -151,6 +165,7 @@ TEST_F(ConfigTest, PartialJson) {
   EXPECT_TRUE(cfg.cli.clipboard_copy_default);
   EXPECT_EQ(cfg.security.auto_lock_seconds, 300);
   EXPECT_EQ(cfg.vault.default_vault, "vault.dat");
+  EXPECT_TRUE(cfg.vault.vaults.empty());
   EXPECT_TRUE(cfg.integration.browser_native_host);
 }
 
@@ -0,0 +1,122 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "SyntheticVault.h"
+
+#include <pwledger/SodiumInit.h>
+#include <pwledger/VaultIO.h>
+#include <pwledger/VaultSerializer.h>
+
+#include <sodium.h>
+
+#include <cstring>
+#include <filesystem>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+using namespace pwledger;
+
+class SyntheticVaultTest : public ::testing::Test {
+protected:
+  static void SetUpTestSuite() {
+    if (!sodium_init_once()) {
+      throw std::runtime_error("libsodium init failed");
+    }
+  }
+
+  void SetUp() override {
+    auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+    std::string filename = std::string("pwledger_test_")
+                         + info->test_suite_name() + "_"
+                         + info->name() + ".dat";
+    test_vault_path = std::filesystem::temp_directory_path() / filename;
+    std::filesystem::remove(test_vault_path);
+  }
+
+  void TearDown() override {
+    std::filesystem::remove(test_vault_path);
+  }
+
+  std::filesystem::path test_vault_path;
+};
+
+// 1. The same seed produces a byte-identical payload; another seed does not.
+TEST_F(SyntheticVaultTest, DeterministicPerSeed) {
+  const auto a = gen::generate_serialized_vault(500, 42);
+  const auto b = gen::generate_serialized_vault(500, 42);
+  const auto c = gen::generate_serialized_vault(500, 43);
+
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, c);
+}
+
+// 2. The payload is a valid VaultSerializer buffer with the requested count
+// and plausible contents.
+TEST_F(SyntheticVaultTest, DeserializesWithRealisticFields) {
+  constexpr std::size_t kEntries = 1000;
+  const auto bytes = gen::generate_serialized_vault(kEntries, 7);
+  const PrimaryTable table = VaultSerializer::deserialize(bytes.data(), bytes.size());
+  ASSERT_EQ(table.size(), kEntries);
+
+  std::set<std::string> usernames;
+  std::size_t with_note = 0;
+  std::size_t with_2fa = 0;
+  for (const auto& [uuid, entry] : table) {
+    EXPECT_FALSE(entry.primary_key.empty());
+    EXPECT_NE(entry.primary_key.find('.'), std::string::npos);
+    EXPECT_FALSE(entry.username_or_email.empty());
+    usernames.insert(entry.username_or_email);
+
+    const std::size_t secret_len = entry.plaintext_secret.with_read_access(
+        [](std::span<const char> buf) { return ::strnlen(buf.data(), buf.size()); });
+    EXPECT_GE(secret_len, 6u);
+
+    EXPECT_LE(entry.metadata.created_at, entry.metadata.last_modified_at);
+    EXPECT_LE(entry.metadata.last_modified_at, entry.metadata.last_used_at);
+    EXPECT_GT(entry.security_policy.strength_score, 0);
+
+    if (!entry.security_policy.note.empty()) {
+      ++with_note;
+    }
+    if (entry.security_policy.two_fa_enabled) {
+      ++with_2fa;
+    }
+  }
+
+  // Most entries share a few personal addresses.
+  EXPECT_LT(usernames.size(), kEntries / 2);
+  // Optional fields are present but in the minority.
+  EXPECT_GT(with_note, 0u);
+  EXPECT_LT(with_note, kEntries / 2);
+  EXPECT_GT(with_2fa, 0u);
+  EXPECT_LT(with_2fa, kEntries / 2);
+}
+
+// 3. A vault written with custom KDF parameters loads with the same ones.
+TEST_F(SyntheticVaultTest, WritesLoadableVaultWithCustomKdf) {
+  KdfParams fast;
+  fast.opslimit = crypto_pwhash_OPSLIMIT_MIN;
+  fast.memlimit = crypto_pwhash_MEMLIMIT_MIN;
+
+  gen::write_synthetic_vault(test_vault_path, 250, 1, "pw", fast);
+  const PrimaryTable table = VaultIO::load_vault(test_vault_path, "pw", fast);
+  EXPECT_EQ(table.size(), 250u);
+}
@@ -0,0 +1,242 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#  include <signal.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#endif
+
+// ============================================================================
+// TEST STRATEGY
+// ============================================================================
+//
+// The browser launches pwledger-host on every connectNative call, so the time
+// from exec to the first response frame is user-visible latency. These tests
+// spawn the real host binary (PWLEDGER_HOST_EXE, injected by CMake) over a
+// pair of pipes, send one framed request, and measure wall-clock time until
+// the complete response frame has been read.
+//
+// Each test runs several cold starts and reports the median and worst case
+// (printed and recorded as gtest properties, so the numbers show up in the
+// XML output and can be tracked across commits). The median is held to a
+// budget, overridable with PWLEDGER_STARTUP_BUDGET_MS for slow CI machines
+// and sanitizer builds.
+//
+// HOME / XDG_* point into an empty temporary directory so that the user's
+// real config.json and vault are never touched.
+//
+// POSIX only: process spawning uses fork/exec.
+//
+// ============================================================================
+
+#ifndef _WIN32
+
+namespace {
+
+constexpr int kColdStarts = 15;
+constexpr long kDefaultBudgetMs = 250;
+
+long startup_budget_ms() {
+  if (const char* env = std::getenv("PWLEDGER_STARTUP_BUDGET_MS"); env && *env) {
+    return std::strtol(env, nullptr, 10);
+  }
+  return kDefaultBudgetMs;
+}
+
+bool read_exact(int fd, char* buf, std::size_t len) {
+  std::size_t done = 0;
+  while (done < len) {
+    const ssize_t n = ::read(fd, buf + done, len - done);
+    if (n <= 0) {
+      return false;
+    }
+    done += static_cast<std::size_t>(n);
+  }
+  return true;
+}
+
+// Spawns the host, sends `request` as one frame, and returns the response
+// payload together with the elapsed time from fork to the last response byte
+// and everything the host wrote to stderr before exiting.
+struct ColdStartResult {
+  std::string response;
+  std::chrono::microseconds elapsed{0};
+  std::string errors;
+};
+
+ColdStartResult cold_start(const std::filesystem::path& home, const std::string& request) {
+  int to_child[2];
+  int from_child[2];
+  int err_child[2];
+  if (::pipe(to_child) != 0 || ::pipe(from_child) != 0 || ::pipe(err_child) != 0) {
+    ADD_FAILURE() << "pipe() failed";
+    return {};
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  const pid_t pid = ::fork();
+  if (pid == 0) {
+    ::dup2(to_child[0], STDIN_FILENO);
+    ::dup2(from_child[1], STDOUT_FILENO);
+    ::dup2(err_child[1], STDERR_FILENO);
+    ::close(to_child[0]);
+    ::close(to_child[1]);
+    ::close(from_child[0]);
+    ::close(from_child[1]);
+    ::close(err_child[0]);
+    ::close(err_child[1]);
+    ::setenv("HOME", home.c_str(), 1);
+    ::setenv("XDG_CONFIG_HOME", (home / "config").c_str(), 1);
+    ::setenv("XDG_DATA_HOME", (home / "data").c_str(), 1);
+    ::execl(PWLEDGER_HOST_EXE, PWLEDGER_HOST_EXE, static_cast<char*>(nullptr));
+    ::_exit(127);
+  }
+  ::close(to_child[0]);
+  ::close(from_child[1]);
+  ::close(err_child[1]);
+
+  std::string frame(sizeof(std::uint32_t), '\0');
+  const auto length = static_cast<std::uint32_t>(request.size());
+  std::memcpy(frame.data(), &length, sizeof(length));
+  frame += request;
+  const bool sent = ::write(to_child[1], frame.data(), frame.size()) == static_cast<ssize_t>(frame.size());
+
+  ColdStartResult result;
+  std::uint32_t resp_len = 0;
+  if (sent && read_exact(from_child[0], reinterpret_cast<char*>(&resp_len), sizeof(resp_len))) {
+    result.response.resize(resp_len);
+    if (!read_exact(from_child[0], result.response.data(), resp_len)) {
+      result.response.clear();
+    }
+  }
+  result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+  // Closing stdin is the host's normal shutdown signal.
+  ::close(to_child[1]);
+  ::close(from_child[0]);
+  char buf[512];
+  for (ssize_t n; (n = ::read(err_child[0], buf, sizeof(buf))) > 0;) {
+    result.errors.append(buf, static_cast<std::size_t>(n));
+  }
+  ::close(err_child[0]);
+  int status = 0;
+  ::waitpid(pid, &status, 0);
+  return result;
+}
+
+}  // namespace
+
+class HostStartupTest : public ::testing::Test {
+protected:
+  static void SetUpTestSuite() {
+    // A host killed mid-write must not take the test runner down with it.
+    ::signal(SIGPIPE, SIG_IGN);
+  }
+
+  void SetUp() override {
+    auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+    home_ = std::filesystem::temp_directory_path() /
+            (std::string("pwledger_test_") + info->test_suite_name() + "_" + info->name());
+    std::filesystem::remove_all(home_);
+    std::filesystem::create_directories(home_);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(home_); }
+
+  // Runs kColdStarts launches, checks every response with `expect`, reports
+  // the distribution and enforces the budget on the median.
+  template <typename Expect>
+  void measure(const std::string& request, Expect&& expect) {
+    std::vector<long long> samples_us;
+    for (int i = 0; i < kColdStarts; ++i) {
+      ColdStartResult r = cold_start(home_, request);
+      ASSERT_FALSE(r.response.empty()) << "host produced no response frame";
+      expect(r.response);
+      // Kept sorted as they arrive: std::sort and std::nth_element pull in
+      // the heap algorithms, which trip -Wstrict-overflow under GCC.
+      const long long us = r.elapsed.count();
+      samples_us.insert(std::upper_bound(samples_us.begin(), samples_us.end(), us), us);
+    }
+    const long long median = samples_us[samples_us.size() / 2];
+    const long long worst = samples_us.back();
+
+    std::printf("[ startup  ] time to first response: median %lld us, max %lld us (%d runs)\n",
+                median,
+                worst,
+                kColdStarts);
+    RecordProperty("median_us", std::to_string(median));
+    RecordProperty("max_us", std::to_string(worst));
+
+    EXPECT_LE(median / 1000, startup_budget_ms()) << "cold start exceeded PWLEDGER_STARTUP_BUDGET_MS";
+  }
+
+  std::filesystem::path home_;
+};
+
+TEST_F(HostStartupTest, PingWithinBudget) {
+  measure(R"({"command":"ping","id":1})", [](const std::string& resp) {
+    EXPECT_NE(resp.find(R"("status":"ok")"), std::string::npos) << resp;
+    EXPECT_NE(resp.find(R"("is_unlocked":false)"), std::string::npos) << resp;
+  });
+}
+
+// The content script's first message on a page load is a search against a
+// locked vault. It must be answered without loading config or libsodium.
+TEST_F(HostStartupTest, LockedSearchWithinBudget) {
+  measure(R"({"command":"search","query":"example.com","id":2})", [](const std::string& resp) {
+    EXPECT_NE(resp.find(R"("message":"Locked")"), std::string::npos) << resp;
+  });
+}
+
+// Commands that never read settings must not load config.json. A malformed
+// file makes loading print a warning (and fall back to the defaults), so
+// ping must leave stderr clean, while unlock, which needs the settings,
+// shows the warning.
+TEST_F(HostStartupTest, ConfigNotParsedForPing) {
+  std::filesystem::create_directories(home_ / "config" / "pwledger");
+  {
+    std::FILE* f = std::fopen((home_ / "config" / "pwledger" / "config.json").c_str(), "w");
+    ASSERT_NE(f, nullptr);
+    std::fputs("{ this is not json", f);
+    std::fclose(f);
+  }
+  constexpr const char* kWarning = "Failed to load config";
+
+  ColdStartResult ping = cold_start(home_, R"({"command":"ping"})");
+  EXPECT_NE(ping.response.find(R"("status":"ok")"), std::string::npos) << ping.response;
+  EXPECT_EQ(ping.errors.find(kWarning), std::string::npos) << ping.errors;
+
+  ColdStartResult unlock = cold_start(home_, R"({"command":"unlock","password":"x"})");
+  EXPECT_FALSE(unlock.response.empty());
+  EXPECT_NE(unlock.errors.find(kWarning), std::string::npos) << unlock.errors;
+}
+
+#endif  // _WIN32
@@ -0,0 +1,102 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "HostStats.h"
+
+#include <chrono>
+#include <cstdint>
+
+#include <nlohmann/json.hpp>
+
+using namespace pwledger;
+using namespace std::chrono_literals;
+
+// 1. Every value falls in a bucket whose upper bound is at or above it and
+// within the advertised relative error.
+TEST(LatencyHistogramTest, BucketBoundsAreTight) {
+  std::size_t previous = 0;
+  for (std::uint64_t v = 0; v < (std::uint64_t{1} << 22); v += 1 + v / 97) {
+    const std::size_t i = LatencyHistogram::bucket_index(v);
+    ASSERT_LT(i, LatencyHistogram::kBucketCount);
+    ASSERT_GE(i, previous);
+    previous = i;
+
+    const std::uint64_t upper = LatencyHistogram::bucket_upper_bound(i);
+    ASSERT_GE(upper, v);
+    ASSERT_LE(static_cast<double>(upper - v), static_cast<double>(v) / 32.0 + 1.0);
+  }
+}
+
+// 2. Values beyond the range clamp into the last bucket.
+TEST(LatencyHistogramTest, ClampsHugeValues) {
+  EXPECT_EQ(LatencyHistogram::bucket_index(UINT64_MAX), LatencyHistogram::kBucketCount - 1);
+}
+
+// 3. Percentiles of a uniform 1..1000 us distribution land within one bucket.
+TEST(LatencyHistogramTest, Percentiles) {
+  LatencyHistogram h;
+  for (int us = 1; us <= 1000; ++us) {
+    h.record(std::chrono::microseconds{us});
+  }
+
+  EXPECT_EQ(h.count(), 1000u);
+  EXPECT_EQ(h.min_us(), 1u);
+  EXPECT_EQ(h.max_us(), 1000u);
+  EXPECT_DOUBLE_EQ(h.mean_us(), 500.5);
+  EXPECT_NEAR(static_cast<double>(h.value_at_quantile(0.50)), 500.0, 500.0 / 32.0);
+  EXPECT_NEAR(static_cast<double>(h.value_at_quantile(0.99)), 990.0, 990.0 / 32.0);
+  EXPECT_EQ(h.value_at_quantile(1.0), 1000u);
+}
+
+// 4. An empty histogram reports zeros.
+TEST(LatencyHistogramTest, EmptyIsZero) {
+  LatencyHistogram h;
+  EXPECT_EQ(h.value_at_quantile(0.5), 0u);
+  EXPECT_EQ(h.min_us(), 0u);
+  EXPECT_EQ(h.max_us(), 0u);
+}
+
+// 5. Counters and totals aggregate per command.
+TEST(HostStatsTest, AggregatesPerCommand) {
+  HostStats stats;
+  stats.record("search", 120us, /*ok=*/true, /*requests=*/3, /*bytes_in=*/90, /*bytes_out=*/300);
+  stats.record("search", 80us, /*ok=*/false, 1, 30, 40);
+  stats.record_rejected("unlock", 1, 50, 60);
+  stats.record_rejected(HostStats::kUnknownCommand, 1, 10, 20);
+
+  const nlohmann::json j = stats.to_json();
+  const auto& search = j["commands"]["search"];
+  EXPECT_EQ(search["requests"], 4);
+  EXPECT_EQ(search["errors"], 1);
+  EXPECT_EQ(search["bytes_in"], 120);
+  EXPECT_EQ(search["bytes_out"], 340);
+  EXPECT_EQ(search["latency"]["count"], 2);
+  EXPECT_EQ(search["latency"]["max_us"], 120);
+
+  EXPECT_EQ(j["commands"]["unlock"]["errors"], 1);
+  EXPECT_EQ(j["commands"]["unlock"]["latency"]["count"], 0);
+  EXPECT_TRUE(j["commands"].contains("unknown"));
+
+  EXPECT_EQ(j["totals"]["requests"], 6);
+  EXPECT_EQ(j["totals"]["errors"], 3);
+  EXPECT_EQ(j["totals"]["bytes_in"], 180);
+  EXPECT_EQ(j["totals"]["bytes_out"], 420);
+  EXPECT_TRUE(j.contains("uptime_ms"));
+}
@@ -0,0 +1,188 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "LoadDriver.h"
+#include "SessionRecorder.h"
+#include "Workload.h"
+
+#include <pwledger/SodiumInit.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+using namespace pwledger;
+using namespace pwledger::hostbench;
+using json = nlohmann::json;
+
+namespace {
+
+std::filesystem::path temp_path(const std::string& name) {
+  return std::filesystem::temp_directory_path() / ("pwledger_hostbench_" + name);
+}
+
+}  // namespace
+
+// 1. Shapes keep the command, timing and query length, nothing else.
+TEST(SessionRecorderTest, ShapesCarryNoSecrets) {
+  const json unlock = to_json(shape_of("unlock", {{"command", "unlock"}, {"password", "hunter2"}, {"id", 7}}, 5));
+  EXPECT_EQ(unlock, (json{{"at_us", 5}, {"command", "unlock"}}));
+
+  const json search = to_json(shape_of("search", {{"command", "search"}, {"query", "github"}}, 9));
+  EXPECT_EQ(search, (json{{"at_us", 9}, {"command", "search"}, {"query_len", 6}}));
+
+  const json creds = to_json(shape_of("get_credentials", {{"command", "get_credentials"}, {"uuid", "abc"}}, 0));
+  EXPECT_FALSE(creds.contains("uuid"));
+}
+
+// 2. A recording reads back in order; malformed lines name their line.
+TEST(SessionRecorderTest, RecordingRoundTrip) {
+  const auto path = temp_path("roundtrip.jsonl");
+  std::filesystem::remove(path);
+  {
+    SessionRecorder recorder(path);
+    const auto t0 = SessionRecorder::Clock::now();
+    recorder.record("ping", {{"command", "ping"}}, t0);
+    recorder.record("search", {{"command", "search"}, {"query", "abc"}}, t0 + std::chrono::milliseconds(3));
+  }
+
+  const Workload loaded = load_recording(path);
+  ASSERT_EQ(loaded.size(), 2u);
+  EXPECT_EQ(loaded[0].command, "ping");
+  EXPECT_EQ(loaded[0].at_us, 0u);
+  EXPECT_EQ(loaded[1].command, "search");
+  EXPECT_EQ(loaded[1].at_us, 3000u);
+  EXPECT_EQ(loaded[1].query_len, 3u);
+
+  std::ofstream(path, std::ios::app) << "{\"at_us\":1}\n";
+  try {
+    (void)load_recording(path);
+    FAIL() << "expected a parse error";
+  } catch (const std::runtime_error& e) {
+    EXPECT_NE(std::string(e.what()).find(":3:"), std::string::npos) << e.what();
+  }
+  std::filesystem::remove(path);
+}
+
+// 3. Mix presets and command=weight lists; invalid specs are rejected.
+TEST(WorkloadTest, ParseMix) {
+  const Mix pageload = parse_mix("pageload");
+  EXPECT_GE(pageload.size(), 3u);
+
+  const Mix custom = parse_mix("search=3,relock=1");
+  ASSERT_EQ(custom.size(), 2u);
+  EXPECT_EQ(custom[1].command, "relock");
+  EXPECT_EQ(custom[1].weight, 1u);
+
+  EXPECT_THROW((void)parse_mix("copy=1"), std::invalid_argument);
+  EXPECT_THROW((void)parse_mix("ping"), std::invalid_argument);
+  EXPECT_THROW((void)parse_mix("search=0"), std::invalid_argument);
+  EXPECT_THROW((void)parse_mix("search=x"), std::invalid_argument);
+}
+
+// 4. Synthetic workloads are deterministic, ordered, and hit the target rate.
+TEST(WorkloadTest, SyntheticPoissonArrivals) {
+  const Mix mix = parse_mix("search=6,get_credentials=3,relock=1");
+  const Workload a = synthetic_workload(mix, 20000, 500.0, 42);
+  const Workload b = synthetic_workload(mix, 20000, 500.0, 42);
+  ASSERT_EQ(a.size(), 20000u);
+
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    ASSERT_EQ(a[i].at_us, b[i].at_us);
+    ASSERT_EQ(a[i].command, b[i].command);
+    if (i > 0) {
+      ASSERT_GE(a[i].at_us, a[i - 1].at_us);
+    }
+    if (a[i].command == "search") {
+      ASSERT_GE(a[i].query_len, 3u);
+      ASSERT_LE(a[i].query_len, 12u);
+    }
+    if (a[i].command == "lock" && i + 1 < a.size()) {
+      ASSERT_EQ(a[i + 1].command, "unlock");
+    }
+  }
+
+  // Relocks produce two requests per arrival, so arrivals are ~10/11 of the
+  // requests. Allow 5% for sampling noise.
+  const double seconds = static_cast<double>(a.back().at_us) / 1e6;
+  const double expected = 20000.0 * 10.0 / 11.0 / 500.0;
+  EXPECT_NEAR(seconds, expected, expected * 0.05);
+}
+
+// 5. retime re-spaces uniformly; scale_time compresses.
+TEST(WorkloadTest, Retiming) {
+  Workload w = {{0, "ping", 0}, {100, "ping", 0}, {900, "ping", 0}};
+  scale_time(w, 2.0);
+  EXPECT_EQ(w[2].at_us, 450u);
+  retime(w, 1000.0);
+  EXPECT_EQ(w[1].at_us, 1000u);
+  EXPECT_EQ(w[2].at_us, 2000u);
+}
+
+// 6. End to end against the real host: every request is answered, and the
+// host's own recording of the run contains shapes only.
+TEST(LoadDriverTest, DrivesRealHost) {
+  ASSERT_TRUE(sodium_init_once());
+  const auto home = temp_path("home");
+  const auto recording = temp_path("e2e.jsonl");
+  std::filesystem::remove_all(home);
+  std::filesystem::remove(recording);
+
+  isolate_home(home);
+  const VaultFixture fixture = create_fixture(50, 3, "bench-password");
+  ASSERT_EQ(fixture.uuids.size(), 50u);
+
+  // At most 8 requests outstanding keeps the host's search queue (8 slots)
+  // from ever shedding, however slowly the host runs on a loaded machine.
+  DriverOptions options;
+  options.host = PWLEDGER_HOST_EXE;
+  options.max_in_flight = 8;
+  const Workload workload = synthetic_workload(parse_mix("search=7,get_credentials=2,ping=1"), 300, 3000.0, 3);
+
+  ::setenv("PWLEDGER_HOST_RECORD", recording.c_str(), 1);
+  const LoadReport report = run_load(workload, fixture, options);
+  ::unsetenv("PWLEDGER_HOST_RECORD");
+
+  EXPECT_EQ(report.sent, 300u);
+  EXPECT_EQ(report.completed, 300u);
+  EXPECT_EQ(report.lost, 0u);
+  EXPECT_EQ(report.latency.count(), 300u);
+  for (const auto& [name, result] : report.commands) {
+    EXPECT_EQ(result.errors, 0u) << name << ": " << json(result.error_messages).dump();
+  }
+  EXPECT_GT(report.throughput(), 0.0);
+  EXPECT_TRUE(report.to_json().contains("latency_us"));
+
+  // The setup unlock plus every request of the run.
+  const Workload recorded = load_recording(recording);
+  EXPECT_EQ(recorded.size(), 301u);
+  std::ifstream in(recording);
+  const std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  EXPECT_EQ(text.find("bench-password"), std::string::npos);
+  EXPECT_EQ(text.find(fixture.uuids.front()), std::string::npos);
+
+  std::filesystem::remove_all(home);
+  std::filesystem::remove(recording);
+}
@@ -0,0 +1,333 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <pwledger/SodiumInit.h>
+#include <pwledger/VaultImport.h>
+
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace pwledger;
+
+namespace {
+
+class ImportTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() { ASSERT_TRUE(sodium_init_once()); }
+};
+
+struct Imported {
+  std::string username;
+  std::string password;
+};
+
+ImportResult run(const std::string& text, ImportFormat format, PrimaryTable& table, std::size_t batch_size = 1024) {
+  std::istringstream in(text);
+  return import_entries(in, format, table, ImportOptions{batch_size});
+}
+
+// primary_key -> (username, password)
+std::map<std::string, Imported> contents(const PrimaryTable& table) {
+  std::map<std::string, Imported> out;
+  for (const auto& [uuid, entry] : table) {
+    std::string password = entry.plaintext_secret.with_read_access(
+        [](std::span<const char> buf) { return std::string(buf.data(), ::strnlen(buf.data(), buf.size())); });
+    out[entry.primary_key] = {entry.username_or_email, password};
+  }
+  return out;
+}
+
+TEST_F(ImportTest, FormatNames) {
+  for (const ImportFormat format : {ImportFormat::kCsv, ImportFormat::kBitwardenJson, ImportFormat::kKeePassXml}) {
+    EXPECT_EQ(parse_import_format(import_format_name(format)), format);
+  }
+  EXPECT_FALSE(parse_import_format("xlsx").has_value());
+  EXPECT_EQ(guess_import_format("export.CSV"), ImportFormat::kCsv);
+  EXPECT_EQ(guess_import_format("bitwarden_export.json"), ImportFormat::kBitwardenJson);
+  EXPECT_EQ(guess_import_format("Database.xml"), ImportFormat::kKeePassXml);
+  EXPECT_FALSE(guess_import_format("vault.kdbx").has_value());
+}
+
+// ----------------------------------------------------------------------------
+// CSV
+// ----------------------------------------------------------------------------
+
+TEST_F(ImportTest, CsvChromeExport) {
+  PrimaryTable table;
+  const ImportResult result = run(
+      "name,url,username,password,note\n"
+      "example.com,https://example.com/,alice,hunter2,\n"
+      "mail,https://mail.test/,bob@mail.test,\"p,a\"\"ss\",a note\n",
+      ImportFormat::kCsv,
+      table);
+
+  EXPECT_EQ(result.imported, 2u);
+  EXPECT_EQ(result.skipped, 0u);
+  const auto got = contents(table);
+  EXPECT_EQ(got.at("example.com").username, "alice");
+  EXPECT_EQ(got.at("example.com").password, "hunter2");
+  EXPECT_EQ(got.at("mail").username, "bob@mail.test");
+  EXPECT_EQ(got.at("mail").password, "p,a\"ss");
+}
+
+TEST_F(ImportTest, CsvQuotedNewlinesCrlfAndBom) {
+  PrimaryTable table;
+  const ImportResult result = run(
+      "\xEF\xBB\xBF\"Title\",\"Username\",\"Password\",\"URL\",\"Notes\"\r\n"
+      "\"Bank\",\"carol\",\"line1\r\nline2\",\"https://bank.test\",\"multi\nline\nnote\"\r\n"
+      "\r\n"
+      "\"Shop\",\"dave\",\"s3cret\",\"\",\"\"\r\n",
+      ImportFormat::kCsv,
+      table);
+
+  EXPECT_EQ(result.imported, 2u);
+  const auto got = contents(table);
+  EXPECT_EQ(got.at("Bank").password, "line1\r\nline2");
+  EXPECT_EQ(got.at("Shop").username, "dave");
+}
+
+TEST_F(ImportTest, CsvFallsBackToUrlThenUsername) {
+  // Firefox exports have no title column.
+  PrimaryTable table;
+  const ImportResult result = run(
+      "\"url\",\"username\",\"password\",\"httpRealm\"\n"
+      "\"https://a.test\",\"erin\",\"pw1\",\n"
+      "\"\",\"frank\",\"pw2\",\n"
+      ",,,\n",
+      ImportFormat::kCsv,
+      table);
+
+  EXPECT_EQ(result.imported, 2u);
+  EXPECT_EQ(result.skipped, 1u);
+  const auto got = contents(table);
+  EXPECT_EQ(got.at("https://a.test").password, "pw1");
+  EXPECT_EQ(got.at("frank").password, "pw2");
+}
+
+TEST_F(ImportTest, CsvSkipsPasswordsOverTheLimit) {
+  PrimaryTable table;
+  const ImportResult result = run("title,password\n"
+                                  "ok," + std::string(255, 'a') + "\n"
+                                  "long," + std::string(256, 'b') + "\n",
+                                  ImportFormat::kCsv,
+                                  table);
+
+  EXPECT_EQ(result.imported, 1u);
+  EXPECT_EQ(result.too_long, 1u);
+  EXPECT_EQ(contents(table).at("ok").password, std::string(255, 'a'));
+}
+
+TEST_F(ImportTest, CsvRejectsMalformedInput) {
+  PrimaryTable table;
+  EXPECT_THROW(run("title,username\nx,y\n", ImportFormat::kCsv, table), std::runtime_error);
+  EXPECT_THROW(run("title,password\n\"open,quote\n", ImportFormat::kCsv, table), std::runtime_error);
+  EXPECT_THROW(run("title,password\n\"a\"b,c\n", ImportFormat::kCsv, table), std::runtime_error);
+}
+
+TEST_F(ImportTest, BatchBoundariesKeepEveryRecord) {
+  std::string csv = "name,username,password\n";
+  for (int i = 0; i < 10; ++i) {
+    csv += "site" + std::to_string(i) + ",user" + std::to_string(i) + ",pw" + std::to_string(i) + "\n";
+  }
+
+  for (const std::size_t batch_size : {1u, 3u, 10u, 64u}) {
+    PrimaryTable table;
+    const ImportResult result = run(csv, ImportFormat::kCsv, table, batch_size);
+    ASSERT_EQ(result.imported, 10u) << "batch_size " << batch_size;
+    const auto got = contents(table);
+    for (int i = 0; i < 10; ++i) {
+      const Imported& entry = got.at("site" + std::to_string(i));
+      EXPECT_EQ(entry.username, "user" + std::to_string(i));
+      EXPECT_EQ(entry.password, "pw" + std::to_string(i));
+    }
+  }
+}
+
+TEST_F(ImportTest, EntriesGetSaltsAndTimestamps) {
+  PrimaryTable table;
+  run("name,password\na,1\nb,2\n", ImportFormat::kCsv, table);
+  ASSERT_EQ(table.size(), 2u);
+  for (const auto& [uuid, entry] : table) {
+    EXPECT_FALSE(uuid.empty());
+    EXPECT_EQ(entry.plaintext_secret.size(), 256u);
+    const bool salt_is_zero = entry.salt.with_read_access([](std::span<const char> buf) {
+      for (const char c : buf) {
+        if (c != 0) {
+          return false;
+        }
+      }
+      return true;
+    });
+    EXPECT_FALSE(salt_is_zero);
+    EXPECT_NE(entry.metadata.created_at.time_since_epoch().count(), 0);
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Bitwarden JSON
+// ----------------------------------------------------------------------------
+
+TEST_F(ImportTest, BitwardenLoginsOnly) {
+  PrimaryTable table;
+  const ImportResult result = run(R"({
+  "encrypted": false,
+  "folders": [{"id": "f1", "name": "Work"}],
+  "items": [
+    {"id": "1", "type": 1, "name": "GitHub", "notes": null, "fields": [{"name": "pin", "value": "1234", "type": 1}],
+     "login": {"uris": [{"match": null, "uri": "https://github.com"}], "username": "gina", "password": "ghé\"pw",
+               "totp": null}},
+    {"id": "2", "type": 2, "name": "A note", "notes": "secret note", "secureNote": {"type": 0}},
+    {"id": "3", "type": 1, "name": "", "login": {"uris": [{"uri": "https://nameless.test"}, {"uri": "https://b.test"}],
+                                                  "username": "hank", "password": "pw"}},
+    {"id": "4", "type": 3, "name": "Visa", "card": {"number": "4111111111111111", "code": "123"}}
+  ]
+})",
+                                  ImportFormat::kBitwardenJson,
+                                  table);
+
+  EXPECT_EQ(result.imported, 2u);
+  EXPECT_EQ(result.skipped, 2u);
+  const auto got = contents(table);
+  EXPECT_EQ(got.at("GitHub").username, "gina");
+  EXPECT_EQ(got.at("GitHub").password, "gh\xC3\xA9\"pw");
+  EXPECT_EQ(got.at("https://nameless.test").username, "hank");
+}
+
+TEST_F(ImportTest, BitwardenRejectsEncryptedAndMalformedExports) {
+  PrimaryTable table;
+  EXPECT_THROW(run(R"({"encrypted": true, "items": []})", ImportFormat::kBitwardenJson, table), std::runtime_error);
+  EXPECT_THROW(run(R"({"items": [{"type": 1, "login": {"password": "x"})", ImportFormat::kBitwardenJson, table),
+               std::runtime_error);
+  EXPECT_THROW(run(R"({"entries": []})", ImportFormat::kBitwardenJson, table), std::runtime_error);
+
+  try {
+    run(R"({"items": [{"type": 1, "login": {"password": "leaked-token)", ImportFormat::kBitwardenJson, table);
+    FAIL() << "expected an exception";
+  } catch (const std::runtime_error& e) {
+    EXPECT_EQ(std::string(e.what()).find("leaked"), std::string::npos) << e.what();
+  }
+}
+
+// ----------------------------------------------------------------------------
+// KeePass XML
+// ----------------------------------------------------------------------------
+
+constexpr const char* kKeePassXml = R"(<?xml version="1.0" encoding="utf-8" standalone="yes"?>
+<!-- exported -->
+<KeePassFile>
+  <Meta>
+    <Generator>KeePass</Generator>
+    <RecycleBinEnabled>True</RecycleBinEnabled>
+    <RecycleBinUUID>cmVjeWNsZWJpbnV1aWQxMg==</RecycleBinUUID>
+  </Meta>
+  <Root>
+    <Group>
+      <UUID>cm9vdGdyb3VwdXVpZDEyMw==</UUID>
+      <Name>Database</Name>
+      <Entry>
+        <UUID>ZW50cnkxdXVpZDEyMzQ1Ng==</UUID>
+        <String><Key>Notes</Key><Value>not imported</Value></String>
+        <String><Key>Password</Key><Value ProtectInMemory="True">a&lt;b&amp;c&#x263A;</Value></String>
+        <String><Key>Title</Key><Value>Router</Value></String>
+        <String><Key>URL</Key><Value /></String>
+        <String><Key>UserName</Key><Value>admin</Value></String>
+        <History>
+          <Entry>
+            <String><Key>Password</Key><Value>old-password</Value></String>
+            <String><Key>Title</Key><Value>Router (old)</Value></String>
+          </Entry>
+        </History>
+      </Entry>
+      <Group>
+        <UUID>c3ViZ3JvdXB1dWlkMTIzNA==</UUID>
+        <Entry>
+          <String><Value><![CDATA[x]]y]]]></Value><Key>Password</Key></String>
+          <String><Key>UserName</Key><Value>ivan</Value></String>
+          <String><Key>URL</Key><Value>https://nested.test</Value></String>
+        </Entry>
+      </Group>
+      <Group>
+        <UUID>cmVjeWNsZWJpbnV1aWQxMg==</UUID>
+        <Name>Recycle Bin</Name>
+        <Entry>
+          <String><Key>Title</Key><Value>Deleted</Value></String>
+          <String><Key>Password</Key><Value>gone</Value></String>
+        </Entry>
+      </Group>
+    </Group>
+  </Root>
+</KeePassFile>
+)";
+
+TEST_F(ImportTest, KeePassEntries) {
+  PrimaryTable table;
+  const ImportResult result = run(kKeePassXml, ImportFormat::kKeePassXml, table);
+
+  EXPECT_EQ(result.imported, 2u);
+  EXPECT_EQ(result.skipped, 1u);  // the recycle bin entry
+  const auto got = contents(table);
+  ASSERT_EQ(got.size(), 2u);
+  EXPECT_EQ(got.at("Router").username, "admin");
+  EXPECT_EQ(got.at("Router").password, "a<b&c\xE2\x98\xBA");
+  EXPECT_EQ(got.at("https://nested.test").username, "ivan");
+  EXPECT_EQ(got.at("https://nested.test").password, "x]]y]");
+}
+
+TEST_F(ImportTest, KeePassRejectsMalformedInput) {
+  PrimaryTable table;
+  EXPECT_THROW(run("<Database></Database>", ImportFormat::kKeePassXml, table), std::runtime_error);
+  EXPECT_THROW(run("<KeePassFile><Root></Group></KeePassFile>", ImportFormat::kKeePassXml, table),
+               std::runtime_error);
+  EXPECT_THROW(run("<KeePassFile><Root>", ImportFormat::kKeePassXml, table), std::runtime_error);
+  EXPECT_THROW(run("<KeePassFile>&bogus;</KeePassFile>", ImportFormat::kKeePassXml, table), std::runtime_error);
+}
+
+// An unknown entity inside a password is password bytes: the error must not
+// quote it, though it still names one anywhere else.
+TEST_F(ImportTest, KeePassErrorsDoNotQuotePasswords) {
+  PrimaryTable table;
+  const auto error = [&](const std::string& xml) {
+    try {
+      run(xml, ImportFormat::kKeePassXml, table);
+    } catch (const std::runtime_error& e) {
+      return std::string(e.what());
+    }
+    return std::string();
+  };
+  const std::string in_password =
+      error("<KeePassFile><Root><Group><Entry><String><Key>Password</Key><Value>x&hunter2;</Value>"
+            "</String></Entry></Group></Root></KeePassFile>");
+  EXPECT_FALSE(in_password.empty());
+  EXPECT_EQ(in_password.find("hunter2"), std::string::npos) << in_password;
+
+  const std::string pending =
+      error("<KeePassFile><Root><Group><Entry><String><Value>x&hunter2;</Value><Key>Password</Key>"
+            "</String></Entry></Group></Root></KeePassFile>");
+  EXPECT_FALSE(pending.empty());
+  EXPECT_EQ(pending.find("hunter2"), std::string::npos) << pending;
+
+  EXPECT_NE(error("<KeePassFile>&bogus;</KeePassFile>").find("&bogus;"), std::string::npos);
+}
+
+}  // namespace
@@ -0,0 +1,328 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <pwledger/CpuFeatures.h>
+#include <pwledger/Kernels.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using pwledger::Isa;
+using pwledger::kernels::KernelSet;
+
+namespace {
+
+// Every test runs against each variant this CPU supports, so a bug in one
+// SIMD path cannot hide behind the one active() happens to pick.
+class KernelsTest : public ::testing::Test {
+ protected:
+  static std::string name(const KernelSet& k) { return std::string(pwledger::isa_name(k.isa)); }
+};
+
+char fold(char c) {
+  return c >= 'A' && c <= 'Z' ? static_cast<char>(c + 0x20) : c;
+}
+
+bool reference_icontains(std::string_view h, std::string_view n) {
+  if (n.size() > h.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i + n.size() <= h.size(); ++i) {
+    std::size_t j = 0;
+    while (j < n.size() && fold(h[i + j]) == fold(n[j])) {
+      ++j;
+    }
+    if (j == n.size()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Letters of both cases plus bytes that differ from a letter only in bit
+// 0x20 without being letters ('@'/'`', '['/'{', 0xC1/0xE1), which a sloppy
+// case fold would treat as equal.
+std::string random_text(std::mt19937& rng, std::size_t len) {
+  static constexpr char kAlphabet[] = "aAbBzZ@`[{.\xC1\xE1";
+  std::uniform_int_distribution<std::size_t> pick(0, sizeof(kAlphabet) - 2);
+  std::string s(len, '\0');
+  for (char& c : s) {
+    c = kAlphabet[pick(rng)];
+  }
+  return s;
+}
+
+}  // namespace
+
+// 1. The scalar level is always present and first; the best level is last.
+TEST_F(KernelsTest, VariantsStartWithScalar) {
+  const auto v = pwledger::kernels::variants();
+  ASSERT_FALSE(v.empty());
+  EXPECT_EQ(v.front().isa, Isa::kScalar);
+  for (const KernelSet& k : v) {
+    EXPECT_TRUE(pwledger::cpu_supports(k.isa)) << name(k);
+    EXPECT_NE(k.icontains, nullptr);
+    EXPECT_NE(k.hex_encode, nullptr);
+    EXPECT_NE(k.hex_decode, nullptr);
+    EXPECT_NE(k.crc32c, nullptr);
+    EXPECT_NE(k.secure_zero, nullptr);
+  }
+}
+
+// 2. select() caps at the requested level and never crosses families.
+TEST_F(KernelsTest, SelectRespectsCap) {
+  using pwledger::kernels::select;
+  const auto v = pwledger::kernels::variants();
+  EXPECT_EQ(&select(std::nullopt), &v.back());
+  EXPECT_EQ(select(Isa::kScalar).isa, Isa::kScalar);
+  for (const KernelSet& k : v) {
+    EXPECT_EQ(&select(k.isa), &k) << name(k);
+  }
+  if (v.back().isa != Isa::kNeon) {
+    EXPECT_EQ(select(Isa::kNeon).isa, Isa::kScalar);
+  } else {
+    EXPECT_EQ(select(Isa::kAvx512).isa, Isa::kScalar);
+  }
+}
+
+TEST_F(KernelsTest, ParseIsaRoundTrips) {
+  for (const Isa isa : {Isa::kScalar, Isa::kSse42, Isa::kAvx2, Isa::kAvx512, Isa::kNeon}) {
+    EXPECT_EQ(pwledger::parse_isa(pwledger::isa_name(isa)), isa);
+  }
+  EXPECT_EQ(pwledger::parse_isa("off"), Isa::kScalar);
+  EXPECT_EQ(pwledger::parse_isa("sse2"), std::nullopt);
+}
+
+// 3. PWLEDGER_SIMD=scalar forces the scalar kernels (ctest runs this file a
+// second time with it set); otherwise the best level is active.
+TEST_F(KernelsTest, ActiveHonoursEnvironment) {
+  const char* env = std::getenv("PWLEDGER_SIMD");
+  if (env != nullptr && std::string_view(env) == "scalar") {
+    EXPECT_EQ(pwledger::kernels::active().isa, Isa::kScalar);
+  } else if (env == nullptr || *env == '\0') {
+    EXPECT_EQ(&pwledger::kernels::active(), &pwledger::kernels::variants().back());
+  }
+}
+
+// 4. CRC-32C check values (RFC 3720 B.4 and the usual "123456789"), and
+// continuation across calls.
+TEST_F(KernelsTest, Crc32cKnownValues) {
+  const std::string digits = "123456789";
+  const std::vector<std::uint8_t> zeros(32, 0x00);
+  const std::vector<std::uint8_t> ones(32, 0xFF);
+  for (const KernelSet& k : pwledger::kernels::variants()) {
+    EXPECT_EQ(k.crc32c(0, digits.data(), digits.size()), 0xE3069283u) << name(k);
+    EXPECT_EQ(k.crc32c(0, zeros.data(), zeros.size()), 0x8A9136AAu) << name(k);
+    EXPECT_EQ(k.crc32c(0, ones.data(), ones.size()), 0x62A8AB43u) << name(k);
+    EXPECT_EQ(k.crc32c(0, nullptr, 0), 0u) << name(k);
+    EXPECT_EQ(k.crc32c(k.crc32c(0, digits.data(), 4), digits.data() + 4, 5), 0xE3069283u) << name(k);
+  }
+}
+
+// 5. Every variant matches the scalar CRC at every length and alignment.
+TEST_F(KernelsTest, Crc32cVariantsAgree) {
+  std::mt19937 rng(1);
+  std::vector<std::uint8_t> buf(300 + 8);
+  for (auto& b : buf) {
+    b = static_cast<std::uint8_t>(rng());
+  }
+  const KernelSet& scalar = pwledger::kernels::variants().front();
+  for (const KernelSet& k : pwledger::kernels::variants()) {
+    for (std::size_t off = 0; off < 8; ++off) {
+      for (std::size_t n = 0; n <= 300; ++n) {
+        ASSERT_EQ(k.crc32c(7, buf.data() + off, n), scalar.crc32c(7, buf.data() + off, n))
+            << name(k) << " off=" << off << " n=" << n;
+      }
+    }
+  }
+}
+
+// 6. icontains agrees with a naive reference on random text, including
+// matches that end in the last byte and needles longer than one vector.
+TEST_F(KernelsTest, IContainsMatchesReference) {
+  std::mt19937 rng(2);
+  std::uniform_int_distribution<std::size_t> hay_len(0, 200);
+  std::uniform_int_distribution<std::size_t> needle_len(1, 70);
+  for (int iter = 0; iter < 3000; ++iter) {
+    const std::string h = random_text(rng, hay_len(rng));
+    std::string n = random_text(rng, needle_len(rng) % 4 == 0 ? needle_len(rng) : needle_len(rng) % 4 + 1);
+    // Plant the needle (with its case flipped) half the time.
+    if (iter % 2 == 0 && n.size() <= h.size()) {
+      std::string planted = h;
+      const std::size_t at = std::uniform_int_distribution<std::size_t>(0, h.size() - n.size())(rng);
+      for (std::size_t j = 0; j < n.size(); ++j) {
+        const char c = n[j];
+        planted[at + j] = c >= 'a' && c <= 'z' ? static_cast<char>(c - 0x20) : c;
+      }
+      for (const KernelSet& k : pwledger::kernels::variants()) {
+        ASSERT_TRUE(k.icontains(planted, n)) << name(k) << " h=" << planted << " n=" << n;
+      }
+    }
+    const bool expected = reference_icontains(h, n);
+    for (const KernelSet& k : pwledger::kernels::variants()) {
+      ASSERT_EQ(k.icontains(h, n), expected) << name(k) << " h=" << h << " n=" << n;
+    }
+  }
+}
+
+TEST_F(KernelsTest, IContainsEdgeCases) {
+  for (const KernelSet& k : pwledger::kernels::variants()) {
+    EXPECT_TRUE(k.icontains("", "")) << name(k);
+    EXPECT_TRUE(k.icontains("abc", "")) << name(k);
+    EXPECT_FALSE(k.icontains("", "a")) << name(k);
+    EXPECT_FALSE(k.icontains("ab", "abc")) << name(k);
+    EXPECT_TRUE(k.icontains("login.GitHub.com", "github")) << name(k);
+    EXPECT_FALSE(k.icontains("user@example.org", "`")) << name(k);
+    EXPECT_FALSE(k.icontains("[section]", "{")) << name(k);
+    EXPECT_FALSE(k.icontains("\xC1", "\xE1")) << name(k);
+    const std::string long_h(1000, 'x');
+    EXPECT_TRUE(k.icontains(long_h + "NEEDLE", "needle")) << name(k);
+    EXPECT_FALSE(k.icontains(long_h + "NEEDL", "needle")) << name(k);
+  }
+}
+
+// 7. Hex encoding matches the scalar table at every length, and decoding
+// accepts both cases.
+TEST_F(KernelsTest, HexRoundTrip) {
+  std::mt19937 rng(3);
+  for (std::size_t n = 0; n <= 130; ++n) {
+    std::vector<std::uint8_t> bytes(n);
+    for (auto& b : bytes) {
+      b = static_cast<std::uint8_t>(rng());
+    }
+    std::string expected(2 * n, '\0');
+    for (std::size_t i = 0; i < n; ++i) {
+      std::snprintf(&expected[2 * i], 3, "%02x", bytes[i]);
+    }
+    std::string upper = expected;
+    for (char& c : upper) {
+      c = c >= 'a' && c <= 'f' ? static_cast<char>(c - 0x20) : c;
+    }
+
+    for (const KernelSet& k : pwledger::kernels::variants()) {
+      std::string hex(2 * n, '\0');
+      k.hex_encode(bytes.data(), n, hex.data());
+      ASSERT_EQ(hex, expected) << name(k) << " n=" << n;
+
+      std::vector<std::uint8_t> back(n);
+      ASSERT_TRUE(k.hex_decode(hex.data(), n, back.data())) << name(k) << " n=" << n;
+      ASSERT_EQ(back, bytes) << name(k) << " n=" << n;
+      ASSERT_TRUE(k.hex_decode(upper.data(), n, back.data())) << name(k) << " n=" << n;
+      ASSERT_EQ(back, bytes) << name(k) << " n=" << n;
+    }
+  }
+}
+
+// 8. A single non-hex byte anywhere fails the decode. 56 bytes covers the
+// 32-byte, 16-byte and scalar stages of the widest decoder.
+TEST_F(KernelsTest, HexDecodeRejectsEveryNonHexByte) {
+  constexpr std::size_t kBytes = 56;
+  const std::string valid(2 * kBytes, 'a');
+  std::vector<std::uint8_t> out(kBytes);
+  for (const KernelSet& k : pwledger::kernels::variants()) {
+    for (std::size_t pos = 0; pos < valid.size(); ++pos) {
+      for (int c = 0; c < 256; ++c) {
+        std::string s = valid;
+        s[pos] = static_cast<char>(c);
+        const bool is_hex = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+        ASSERT_EQ(k.hex_decode(s.data(), kBytes, out.data()), is_hex) << name(k) << " pos=" << pos << " c=" << c;
+      }
+    }
+  }
+}
+
+// 9. secure_zero clears exactly the requested range.
+TEST_F(KernelsTest, SecureZeroClearsExactRange) {
+  std::vector<std::uint8_t> buf(300 + 16);
+  for (const KernelSet& k : pwledger::kernels::variants()) {
+    for (std::size_t off = 0; off < 8; ++off) {
+      for (std::size_t n = 0; n <= 300; ++n) {
+        std::memset(buf.data(), 0xAA, buf.size());
+        k.secure_zero(buf.data() + off, n);
+        for (std::size_t i = 0; i < buf.size(); ++i) {
+          const std::uint8_t want = (i >= off && i < off + n) ? 0x00 : 0xAA;
+          ASSERT_EQ(buf[i], want) << name(k) << " off=" << off << " n=" << n << " i=" << i;
+        }
+      }
+    }
+  }
+}
+
+// 10. StringHash supports heterogeneous lookup.
+TEST_F(KernelsTest, StringHashTransparentLookup) {
+  using pwledger::kernels::StringHash;
+  std::unordered_map<std::string, int, StringHash, std::equal_to<>> map{{"search", 1}, {"unlock", 2}};
+  EXPECT_EQ(map.find(std::string_view("search"))->second, 1);
+  EXPECT_EQ(map.find(std::string_view("unlock"))->second, 2);
+  EXPECT_EQ(map.find(std::string_view("lock")), map.end());
+  EXPECT_EQ(StringHash{}("abc"), StringHash{}(std::string("abc")));
+  EXPECT_NE(StringHash{}(""), StringHash{}(std::string_view("\0", 1)));
+}
+
+// 11. argon2_fill variants agree with scalar, overwriting and XORing, and
+// with the output aliasing either input as Argon2's address blocks do.
+TEST_F(KernelsTest, Argon2FillVariantsAgree) {
+  using pwledger::kernels::kArgon2BlockWords;
+  using Block = std::vector<std::uint64_t>;
+  std::mt19937_64 rng(3);
+  const auto random_block = [&] {
+    Block b(kArgon2BlockWords);
+    for (auto& w : b) {
+      w = rng();
+    }
+    return b;
+  };
+  const KernelSet& scalar = pwledger::kernels::variants().front();
+  for (int round = 0; round < 16; ++round) {
+    const Block prev = random_block();
+    const Block ref = random_block();
+    const Block old = random_block();
+    for (const bool xor_into : {false, true}) {
+      Block want = old;
+      scalar.argon2_fill(prev.data(), ref.data(), want.data(), xor_into);
+      ASSERT_NE(want, old);
+      for (const KernelSet& k : pwledger::kernels::variants()) {
+        Block out = old;
+        k.argon2_fill(prev.data(), ref.data(), out.data(), xor_into);
+        ASSERT_EQ(out, want) << name(k) << " xor=" << xor_into;
+
+        Block aliased = prev;
+        Block expect = prev;
+        scalar.argon2_fill(prev.data(), ref.data(), expect.data(), xor_into);
+        k.argon2_fill(aliased.data(), ref.data(), aliased.data(), xor_into);
+        ASSERT_EQ(aliased, expect) << name(k) << " out aliases prev";
+
+        aliased = ref;
+        expect = ref;
+        scalar.argon2_fill(prev.data(), ref.data(), expect.data(), xor_into);
+        k.argon2_fill(prev.data(), aliased.data(), aliased.data(), xor_into);
+        ASSERT_EQ(aliased, expect) << name(k) << " out aliases ref";
+      }
+    }
+  }
+}
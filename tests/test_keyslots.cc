@@ -0,0 +1,246 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "TestKdf.h"
+
+#include <pwledger/KeySlots.h>
+#include <pwledger/SodiumInit.h>
+#include <pwledger/VaultIO.h>
+
+#include <filesystem>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+using namespace pwledger;
+
+namespace {
+
+std::vector<std::uint8_t> bytes(const std::string& text) { return {text.begin(), text.end()}; }
+
+class KeySlotsTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() { ASSERT_TRUE(sodium_init_once()); }
+
+  void SetUp() override {
+    const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+    dir_ = std::filesystem::temp_directory_path() / ("pwledger_test_keyslots_" + std::string(info->name()));
+    std::filesystem::remove_all(dir_);
+    std::filesystem::create_directories(dir_);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(dir_); }
+
+  std::filesystem::path dir_;
+};
+
+TEST_F(KeySlotsTest, EverySlotOpensTheSamePayload) {
+  const Secret data_key = SlottedVault::generate_data_key();
+  SlottedVault vault = SlottedVault::create(data_key, bytes("entries"));
+  EXPECT_THROW((void)vault.serialize(), std::logic_error);
+
+  const X25519KeyPair laptop = X25519KeyPair::generate();
+  vault.add_password_slot(data_key, "alice", "pw-alice", kFastKdf);
+  vault.add_password_slot(data_key, "bob", "pw-bob", kFastKdf);
+  vault.add_public_key_slot(data_key, "laptop", laptop.public_key);
+
+  const SlottedVault parsed = SlottedVault::parse(vault.serialize());
+  ASSERT_EQ(parsed.slots().size(), 3u);
+  EXPECT_EQ(parsed.find_slot("bob")->kdf, kFastKdf);
+  EXPECT_EQ(parsed.find_slot("laptop")->public_key, laptop.public_key);
+
+  EXPECT_EQ(parsed.decrypt(parsed.unlock("pw-alice")), bytes("entries"));
+  EXPECT_EQ(parsed.decrypt(parsed.unlock("pw-bob")), bytes("entries"));
+  EXPECT_EQ(parsed.decrypt(parsed.unlock("pw-bob", "bob")), bytes("entries"));
+  EXPECT_EQ(parsed.decrypt(parsed.unlock(laptop)), bytes("entries"));
+
+  EXPECT_THROW((void)parsed.unlock("pw-bob", "alice"), std::runtime_error);
+  EXPECT_THROW((void)parsed.unlock("wrong"), std::runtime_error);
+  EXPECT_THROW((void)parsed.unlock("pw-bob", "carol"), std::runtime_error);
+  EXPECT_THROW((void)parsed.unlock(X25519KeyPair::generate()), std::runtime_error);
+}
+
+TEST_F(KeySlotsTest, ChangingSlotsKeepsThePayloadBytes) {
+  const Secret data_key = SlottedVault::generate_data_key();
+  SlottedVault vault = SlottedVault::create(data_key, bytes("a payload"));
+  vault.add_password_slot(data_key, "owner", "pw", kFastKdf);
+  const std::vector<std::uint8_t> before = vault.serialize();
+
+  vault.add_public_key_slot(data_key, "ci", X25519KeyPair::generate().public_key);
+  EXPECT_TRUE(vault.remove_slot("ci"));
+  EXPECT_FALSE(vault.remove_slot("ci"));
+  EXPECT_EQ(vault.serialize(), before);  // the same slot table, and the payload never moved
+
+  EXPECT_THROW(vault.add_password_slot(data_key, "owner", "pw", kFastKdf), std::invalid_argument);
+  EXPECT_THROW(vault.add_password_slot(data_key, "", "pw", kFastKdf), std::invalid_argument);
+  EXPECT_THROW(vault.add_password_slot(data_key, std::string(256, 'x'), "pw", kFastKdf), std::invalid_argument);
+  EXPECT_THROW(vault.remove_slot("owner"), std::invalid_argument);  // the last one
+}
+
+// Unlocking without a label tries every password slot, so their number is
+// capped both when adding one and when parsing a file.
+TEST_F(KeySlotsTest, PasswordSlotsAreCapped) {
+  const Secret data_key = SlottedVault::generate_data_key();
+  SlottedVault vault = SlottedVault::create(data_key, bytes("payload"));
+  for (std::size_t i = 0; i < SlottedVault::kMaxPasswordSlots; ++i) {
+    vault.add_password_slot(data_key, "p" + std::to_string(i), "pw" + std::to_string(i), kFastKdf);
+  }
+  EXPECT_THROW(vault.add_password_slot(data_key, "one-more", "pw", kFastKdf), std::invalid_argument);
+  vault.add_public_key_slot(data_key, "laptop", X25519KeyPair::generate().public_key);
+  const std::vector<std::uint8_t> blob = vault.serialize();
+  const SlottedVault parsed = SlottedVault::parse(blob);
+  EXPECT_EQ(parsed.decrypt(parsed.unlock("pw7")), bytes("payload"));
+
+  // A file with one password slot too many, made by repeating the first
+  // (type, label "p0", then 97 bytes of KDF parameters, salt and wrap).
+  constexpr std::size_t kCountOffset = 6;
+  constexpr std::size_t kFirstSlotBytes = 2 + 2 + 97;
+  std::vector<std::uint8_t> crafted = blob;
+  crafted[kCountOffset] = static_cast<std::uint8_t>(crafted[kCountOffset] + 1);
+  crafted.insert(crafted.begin() + kCountOffset + 1, blob.begin() + kCountOffset + 1,
+                 blob.begin() + kCountOffset + 1 + kFirstSlotBytes);
+  crafted[kCountOffset + 4] = '9';  // relabel the copy "p9"
+  EXPECT_THROW((void)SlottedVault::parse(crafted), std::runtime_error);
+}
+
+TEST_F(KeySlotsTest, RejectsTampering) {
+  const Secret data_key = SlottedVault::generate_data_key();
+  SlottedVault vault = SlottedVault::create(data_key, bytes("payload"));
+  vault.add_password_slot(data_key, "owner", "pw", kFastKdf);
+  const std::vector<std::uint8_t> blob = vault.serialize();
+
+  // The label is part of the slot's additional data.
+  std::vector<std::uint8_t> relabelled = blob;
+  relabelled[10] ^= 0x20;
+  EXPECT_THROW((void)SlottedVault::parse(relabelled).unlock("pw"), std::runtime_error);
+
+  std::vector<std::uint8_t> flipped = blob;
+  flipped.back() ^= 1;
+  const SlottedVault parsed = SlottedVault::parse(flipped);
+  EXPECT_THROW((void)parsed.decrypt(parsed.unlock("pw")), std::runtime_error);
+
+  EXPECT_THROW(SlottedVault::parse(std::vector<std::uint8_t>(blob.begin(), blob.begin() + 40)), std::runtime_error);
+
+  // VaultCrypto refuses the format rather than misreading it as headerless.
+  EXPECT_THROW((void)VaultCrypto::decrypt_vault("pw", blob), std::runtime_error);
+}
+
+TEST_F(KeySlotsTest, KeyPairFiles) {
+  const X25519KeyPair pair = X25519KeyPair::generate();
+  const auto path = dir_ / "id.key";
+  pair.write_file(path);
+  EXPECT_EQ(std::filesystem::status(path).permissions() & std::filesystem::perms::all,
+            std::filesystem::perms::owner_read | std::filesystem::perms::owner_write);
+  EXPECT_THROW(pair.write_file(path), std::runtime_error);
+  EXPECT_EQ(X25519KeyPair::read_file(path).public_key, pair.public_key);
+
+  const std::string hex = public_key_to_hex(pair.public_key);
+  EXPECT_EQ(hex.size(), 64u);
+  EXPECT_EQ(public_key_from_hex(hex), pair.public_key);
+  EXPECT_FALSE(public_key_from_hex(hex.substr(1)).has_value());
+  EXPECT_FALSE(public_key_from_hex(std::string(64, 'g')).has_value());
+
+  EXPECT_THROW(X25519KeyPair::read_file(dir_ / "missing.key"), std::runtime_error);
+}
+
+#ifndef _WIN32
+// The file is created owner-only whatever the umask, and a link planted
+// where it should go is refused rather than followed.
+TEST_F(KeySlotsTest, KeyFileIsCreatedOwnerOnly) {
+  const X25519KeyPair pair = X25519KeyPair::generate();
+  const ::mode_t old_umask = ::umask(0);
+  pair.write_file(dir_ / "id.key");
+  ::umask(old_umask);
+  EXPECT_EQ(std::filesystem::status(dir_ / "id.key").permissions() & std::filesystem::perms::all,
+            std::filesystem::perms::owner_read | std::filesystem::perms::owner_write);
+
+  const auto target = dir_ / "elsewhere";
+  std::filesystem::create_symlink(target, dir_ / "link.key");
+  EXPECT_THROW(pair.write_file(dir_ / "link.key"), std::runtime_error);
+  EXPECT_FALSE(std::filesystem::exists(target));
+}
+#endif
+
+TEST_F(KeySlotsTest, VaultIOConvertsAndKeepsSlots) {
+  const auto path = dir_ / "vault.dat";
+  PrimaryTable table;
+  table.emplace(Uuid::generate(), SecretEntry("mail", "me@example.com", 16, 16));
+  VaultIO::save_vault(path, table, "master", kFastKdf);
+  EXPECT_FALSE(VaultIO::uses_key_slots(path));
+  EXPECT_THROW(VaultIO::read_slotted(path), std::runtime_error);
+
+  EXPECT_THROW(VaultIO::convert_to_slotted(path, "wrong", "owner"), std::runtime_error);
+  const Secret data_key = VaultIO::convert_to_slotted(path, "master", "owner");
+  EXPECT_TRUE(VaultIO::uses_key_slots(path));
+  EXPECT_EQ(VaultIO::stored_kdf_params(path), kFastKdf);
+  EXPECT_THROW(VaultIO::convert_to_slotted(path, "master", "owner"), std::runtime_error);
+
+  const X25519KeyPair ci = X25519KeyPair::generate();
+  SlottedVault vault = VaultIO::read_slotted(path);
+  vault.add_public_key_slot(data_key, "ci", ci.public_key);
+  VaultIO::write_slotted(path, vault);
+
+  // The same entries with either credential, and a save with one keeps the other.
+  EXPECT_EQ(VaultIO::load_vault(path, "master").size(), 1u);
+  PrimaryTable loaded = VaultIO::load_vault(path, ci);
+  ASSERT_EQ(loaded.size(), 1u);
+  loaded.emplace(Uuid::generate(), SecretEntry("bank", "", 16, 16));
+  VaultIO::save_vault(path, loaded, ci);
+  EXPECT_EQ(VaultIO::load_vault(path, "master").size(), 2u);
+  VaultIO::save_vault(path, loaded, "master");
+  EXPECT_EQ(VaultIO::read_slotted(path).slots().size(), 2u);
+  EXPECT_EQ(VaultIO::load_vault(path, ci).size(), 2u);
+
+  EXPECT_THROW(VaultIO::save_vault(path, loaded, "wrong"), std::runtime_error);
+  EXPECT_THROW(VaultIO::load_vault(path, X25519KeyPair::generate()), std::runtime_error);
+}
+
+// A session keeps the data key its load handed back and saves with it. A
+// file since replaced by one under another data key is refused, not
+// overwritten with a payload no slot opens.
+TEST_F(KeySlotsTest, SavesWithTheSessionDataKey) {
+  const auto path = dir_ / "vault.dat";
+  VaultIO::save_vault(path, PrimaryTable{}, "master", kFastKdf);
+  std::optional<Secret> data_key;
+  EXPECT_TRUE(VaultIO::load_vault(path, "master", data_key).empty());
+  EXPECT_FALSE(data_key.has_value());
+  (void)VaultIO::convert_to_slotted(path, "master", "owner");
+
+  PrimaryTable table = VaultIO::load_vault(path, "master", data_key);
+  ASSERT_TRUE(data_key.has_value());
+  table.emplace(Uuid::generate(), SecretEntry("mail", "", 16, 16));
+  VaultIO::save_vault(path, table, *data_key);
+  EXPECT_EQ(VaultIO::load_vault(path, "master").size(), 1u);
+  EXPECT_EQ(VaultIO::read_slotted(path).slots().size(), 1u);
+
+  const auto other = dir_ / "other.dat";
+  VaultIO::save_vault(other, PrimaryTable{}, "master", kFastKdf);
+  (void)VaultIO::convert_to_slotted(other, "master", "owner");
+  std::filesystem::copy_file(other, path, std::filesystem::copy_options::overwrite_existing);
+  EXPECT_THROW(VaultIO::save_vault(path, table, *data_key), std::runtime_error);
+  EXPECT_TRUE(VaultIO::load_vault(path, "master").empty());
+}
+
+}  // namespace
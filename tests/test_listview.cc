@@ -0,0 +1,174 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Display.h"
+#include "ListView.h"
+
+#include <pwledger/SodiumInit.h>
+
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace pwledger;
+
+namespace {
+
+using std::chrono::seconds;
+using std::chrono::system_clock;
+
+class ListViewTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() { ASSERT_TRUE(sodium_init_once()); }
+
+  // Entry `name` last modified `modified` seconds after the epoch.
+  Uuid add(const std::string& name, const std::string& user, std::int64_t modified) {
+    SecretEntry entry(name, user, 16, 16);
+    entry.metadata.last_modified_at = system_clock::time_point(seconds(modified));
+    const Uuid uuid = Uuid::generate();
+    table_.emplace(uuid, std::move(entry));
+    return uuid;
+  }
+
+  static std::vector<std::string> names(const ListView& view, std::size_t count) {
+    std::vector<std::string> out;
+    for (std::size_t i = 0; i < count; ++i) {
+      out.push_back(view[i]->second.primary_key);
+    }
+    return out;
+  }
+
+  static std::vector<std::string> lines(const std::string& text) {
+    std::vector<std::string> out;
+    std::istringstream in(text);
+    for (std::string line; std::getline(in, line);) {
+      out.push_back(line);
+    }
+    return out;
+  }
+
+  PrimaryTable table_;
+};
+
+TEST(PutTimepointTest, FormatsUtc) {
+  char buf[kTimepointLength];
+  const auto at = [&](std::int64_t s, bool with_seconds) {
+    return std::string(buf, put_timepoint(buf, system_clock::time_point(seconds(s)), with_seconds));
+  };
+  EXPECT_EQ(at(0, true), "1970-01-01 00:00:00");
+  EXPECT_EQ(at(951868799, true), "2000-02-29 23:59:59");
+  EXPECT_EQ(at(946598400, true), "1999-12-31 00:00:00");
+  EXPECT_EQ(at(1792262405, false), "2026-10-17 18:40");
+  EXPECT_EQ(format_timepoint(system_clock::time_point(seconds(1792262405))), "2026-10-17 18:40:05 UTC");
+}
+
+TEST(ListOptionsTest, Parses) {
+  const auto order = parse_list_order("-modified");
+  ASSERT_TRUE(order.has_value());
+  EXPECT_EQ(order->key, ListSortKey::kModified);
+  EXPECT_TRUE(order->descending);
+  EXPECT_FALSE(parse_list_order("size").has_value());
+
+  const ListOptions options = parse_list_options({"--sort", "user", "--page", "3", "--page-size", "20", "--all"});
+  EXPECT_EQ(options.order.key, ListSortKey::kUser);
+  EXPECT_FALSE(options.order.descending);
+  EXPECT_EQ(options.page, 3u);
+  EXPECT_EQ(options.page_size, 20u);
+  EXPECT_TRUE(options.all);
+
+  EXPECT_THROW(parse_list_options({"--page", "0"}), std::invalid_argument);
+  EXPECT_THROW(parse_list_options({"--page-size", "x"}), std::invalid_argument);
+  EXPECT_THROW(parse_list_options({"--sort"}), std::invalid_argument);
+  EXPECT_THROW(parse_list_options({"--verbose"}), std::invalid_argument);
+}
+
+TEST_F(ListViewTest, SortsByKeyAndDirection) {
+  add("carol", "z@example.com", 300);
+  add("alice", "y@example.com", 100);
+  add("bob", "x@example.com", 200);
+
+  EXPECT_EQ(names(ListView(table_, {}), 3), (std::vector<std::string>{"alice", "bob", "carol"}));
+  EXPECT_EQ(names(ListView(table_, {ListSortKey::kName, true}), 3),
+            (std::vector<std::string>{"carol", "bob", "alice"}));
+  EXPECT_EQ(names(ListView(table_, {ListSortKey::kUser, false}), 3),
+            (std::vector<std::string>{"bob", "alice", "carol"}));
+  EXPECT_EQ(names(ListView(table_, {ListSortKey::kModified, true}), 3),
+            (std::vector<std::string>{"carol", "bob", "alice"}));
+}
+
+TEST_F(ListViewTest, PartialOrderMatchesFullOrder) {
+  for (int i = 0; i < 500; ++i) {
+    add("entry-" + std::to_string((i * 7919) % 500), "", (i * 31) % 97);
+  }
+  const ListOrder order{ListSortKey::kModified, false};
+  const ListView full(table_, order);
+  const ListView first_page(table_, order, 40);
+  ASSERT_EQ(first_page.size(), 500u);
+  for (std::size_t i = 0; i < 40; ++i) {
+    EXPECT_EQ(first_page[i], full[i]) << i;
+  }
+}
+
+TEST_F(ListViewTest, RendersOneLinePerEntry) {
+  const Uuid uuid = add("mail", "alice@example.com", 1792262405);
+  add(std::string(40, 'n'), "", 0);
+  add("caf\xC3\xA9", "", 0);  // "café": 4 columns, 5 bytes
+
+  const ListView view(table_, {});
+  std::ostringstream out;
+  view.render(out, 0, view.size());
+  const auto rows = lines(out.str());
+
+  ASSERT_EQ(rows.size(), 4u);
+  EXPECT_TRUE(rows[0].starts_with("NAME"));
+  EXPECT_NE(rows[0].find("UUID"), std::string::npos);
+
+  EXPECT_TRUE(rows[1].starts_with("caf\xC3\xA9"));
+  EXPECT_TRUE(rows[2].starts_with("mail "));
+  EXPECT_NE(rows[2].find("2026-10-17 18:40"), std::string::npos);
+  EXPECT_TRUE(rows[2].ends_with(uuid.to_string()));
+
+  // Name column capped at 32: 31 characters and an ellipsis.
+  EXPECT_TRUE(rows[3].starts_with(std::string(31, 'n') + "\xE2\x80\xA6  "));
+
+  // Columns line up by characters, not bytes: "café" is one byte longer.
+  EXPECT_EQ(rows[1].size(), rows[2].size() + 1);
+}
+
+TEST_F(ListViewTest, RendersASlice) {
+  for (int i = 0; i < 10; ++i) {
+    add("e" + std::to_string(i), "", i);
+  }
+  const ListView view(table_, {}, 6);
+  std::ostringstream out;
+  view.render(out, 3, 6);
+  const auto rows = lines(out.str());
+  ASSERT_EQ(rows.size(), 4u);
+  EXPECT_TRUE(rows[1].starts_with("e3 "));
+  EXPECT_TRUE(rows[3].starts_with("e5 "));
+
+  std::ostringstream past_end;
+  view.render(past_end, 20, 30);
+  EXPECT_EQ(lines(past_end.str()).size(), 1u);  // header only
+}
+
+}  // namespace
@@ -0,0 +1,124 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <pwledger/MemoryStats.h>
+#include <pwledger/PrimaryTable.h>
+#include <pwledger/Secret.h>
+#include <pwledger/SecretEntry.h>
+#include <pwledger/SodiumInit.h>
+#include <pwledger/uuid.h>
+
+#include <string>
+#include <utility>
+
+#include <nlohmann/json.hpp>
+
+using namespace pwledger;
+
+namespace {
+
+class MemoryStatsTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() { ASSERT_TRUE(sodium_init_once()); }
+};
+
+}  // namespace
+
+// 1. The layout follows libsodium: data + canary rounded to pages, plus a
+// header page and two guard pages; only the data pages are locked.
+TEST_F(MemoryStatsTest, AllocationLayout) {
+  const SecureAllocationLayout small = secure_allocation_layout(256);
+  ASSERT_EQ(small.guard % 2, 0u);
+  const std::size_t page = small.guard / 2;
+  EXPECT_EQ(small.locked, page);
+  EXPECT_EQ(small.mapped, 4 * page);
+
+  // 16 bytes of canary push a full page of data onto a second page.
+  const SecureAllocationLayout full = secure_allocation_layout(page);
+  EXPECT_EQ(full.locked, 2 * page);
+  EXPECT_EQ(full.mapped, 5 * page);
+}
+
+// 2. Counters follow Secret construction, move and destruction.
+TEST_F(MemoryStatsTest, CountersTrackSecretLifetime) {
+  const SecureMemoryStats before = secure_memory_stats();
+  const SecureAllocationLayout layout = secure_allocation_layout(256);
+  {
+    Secret a(256);
+    Secret b(256);
+    SecureMemoryStats now = secure_memory_stats();
+    EXPECT_EQ(now.live_allocations, before.live_allocations + 2);
+    EXPECT_EQ(now.total_allocations, before.total_allocations + 2);
+    EXPECT_EQ(now.requested_bytes, before.requested_bytes + 512);
+    EXPECT_EQ(now.mapped_bytes, before.mapped_bytes + 2 * layout.mapped);
+    EXPECT_EQ(now.guard_bytes, before.guard_bytes + 2 * layout.guard);
+    EXPECT_EQ(now.locked_bytes, before.locked_bytes + 2 * layout.locked);
+    EXPECT_GE(now.peak_mapped_bytes, now.mapped_bytes);
+
+    // Move-assignment frees the destination's buffer.
+    a = std::move(b);
+    now = secure_memory_stats();
+    EXPECT_EQ(now.live_allocations, before.live_allocations + 1);
+    EXPECT_EQ(now.requested_bytes, before.requested_bytes + 256);
+
+    // Move construction transfers without allocating.
+    Secret c(std::move(a));
+    EXPECT_EQ(secure_memory_stats().live_allocations, before.live_allocations + 1);
+  }
+  const SecureMemoryStats after = secure_memory_stats();
+  EXPECT_EQ(after.live_allocations, before.live_allocations);
+  EXPECT_EQ(after.requested_bytes, before.requested_bytes);
+  EXPECT_EQ(after.mapped_bytes, before.mapped_bytes);
+  EXPECT_EQ(after.locked_bytes, before.locked_bytes);
+  EXPECT_EQ(after.total_allocations, before.total_allocations + 2);
+}
+
+// 3. Table measurement counts both Secrets and the non-secret strings.
+TEST_F(MemoryStatsTest, MeasureTable) {
+  PrimaryTable table;
+  for (int i = 0; i < 3; ++i) {
+    SecretEntry entry("site-" + std::to_string(i), std::string(40, 'u'), 256, 16);
+    entry.security_policy.note = std::string(100, 'n');
+    table.emplace(Uuid::generate(), std::move(entry));
+  }
+
+  const TableMemoryStats t = measure_table(table);
+  EXPECT_EQ(t.entries, 3u);
+  EXPECT_EQ(t.secret_buffer_bytes, 3u * (256 + 16));
+  EXPECT_EQ(t.string_bytes, 3u * (6 + 40 + 100));
+  // "site-N" fits the small-string buffer; the other two need the heap.
+  EXPECT_GE(t.string_heap_bytes, 3u * (41 + 101));
+  EXPECT_GT(t.table_bytes, 3 * sizeof(PrimaryTable::value_type));
+
+  EXPECT_EQ(measure_table(PrimaryTable{}).entries, 0u);
+}
+
+// 4. The JSON form has the documented sections, and table only on request.
+TEST_F(MemoryStatsTest, Json) {
+  Secret s(64);
+  const nlohmann::json without = memory_stats_json(nullptr);
+  EXPECT_TRUE(without.contains("secure"));
+  EXPECT_TRUE(without.contains("process"));
+  EXPECT_FALSE(without.contains("table"));
+  EXPECT_GE(without["secure"]["live_allocations"].get<std::uint64_t>(), 1u);
+
+  const PrimaryTable table;
+  EXPECT_EQ(memory_stats_json(&table)["table"]["entries"], 0);
+}
@@ -0,0 +1,129 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <pwledger/Secret.h>
+#include <pwledger/SecretProfiler.h>
+#include <pwledger/SodiumInit.h>
+
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <string>
+
+using namespace pwledger;
+
+// Most of these tests only have something to check in a build configured
+// with -DPWLEDGER_ENABLE_SECRET_PROFILER=ON; elsewhere they verify that the
+// profiler stays out of the way.
+
+namespace {
+
+class SecretProfilerTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() { ASSERT_TRUE(sodium_init_once()); }
+  void SetUp() override { secret_profile::reset(); }
+};
+
+const secret_profile::SiteReport* find_line(const secret_profile::Report& report, std::uint32_t line) {
+  for (const auto& site : report.sites) {
+    if (site.line == line && site.file.find("test_secret_profiler") != std::string::npos) {
+      return &site;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+// 1. Buckets are powers of two; quantiles are bucket upper bounds capped at
+// the largest recorded value.
+TEST(HoldHistogramTest, Quantiles) {
+  secret_profile::HoldHistogram h;
+  EXPECT_EQ(h.quantile_ns(0.5), 0u);
+  for (int i = 0; i < 99; ++i) {
+    h.record(1000);
+  }
+  h.record(1'000'000);
+  EXPECT_EQ(h.total, 100u);
+  EXPECT_EQ(h.max_ns, 1'000'000u);
+  // 1000 lies in [512, 1024), so the p50 upper bound is 1023.
+  EXPECT_EQ(h.quantile_ns(0.5), 1023u);
+  EXPECT_EQ(h.quantile_ns(1.0), 1'000'000u);
+}
+
+// 2. Each access is attributed to the line that opened it, with two
+// mprotect calls per window.
+TEST_F(SecretProfilerTest, CountsPerCallSite) {
+  Secret s(32);
+  const std::uint32_t write_line = __LINE__ + 1;
+  s.with_write_access([](std::span<char> buf) { std::memset(buf.data(), 'x', buf.size()); });
+  std::uint32_t read_line = 0;
+  for (int i = 0; i < 3; ++i) {
+    read_line = __LINE__ + 1;
+    s.with_read_access([](std::span<const char>) {});
+  }
+  const std::uint32_t zeroize_line = __LINE__ + 1;
+  s.zeroize();
+
+  const secret_profile::Report report = secret_profile::snapshot();
+  if (!secret_profile::kEnabled) {
+    EXPECT_TRUE(report.sites.empty());
+    EXPECT_EQ(report.mprotect_calls, 0u);
+    GTEST_SKIP() << "built without PWLEDGER_ENABLE_SECRET_PROFILER";
+  }
+
+  const auto* writes = find_line(report, write_line);
+  const auto* reads = find_line(report, read_line);
+  const auto* zeroize = find_line(report, zeroize_line);
+  ASSERT_NE(writes, nullptr);
+  ASSERT_NE(reads, nullptr);
+  ASSERT_NE(zeroize, nullptr);
+  EXPECT_EQ(writes->writes, 1u);
+  EXPECT_EQ(reads->reads, 3u);
+  EXPECT_EQ(reads->writes, 0u);
+  EXPECT_EQ(reads->mprotect_calls, 6u);
+  EXPECT_EQ(reads->hold.total, 3u);
+  EXPECT_EQ(zeroize->writes, 1u);
+  // Busiest site first; allocation's initial mprotect counts in the total.
+  EXPECT_EQ(report.sites.front().line, read_line);
+  EXPECT_EQ(report.mprotect_calls, 1u + 2u + 6u + 2u);
+}
+
+// 3. The report names every site.
+TEST_F(SecretProfilerTest, WritesReport) {
+  Secret s(16);
+  s.with_read_access([](std::span<const char>) {});
+
+  std::FILE* f = std::tmpfile();
+  ASSERT_NE(f, nullptr);
+  secret_profile::write_report(f, secret_profile::snapshot());
+  std::rewind(f);
+  std::string text;
+  char buf[512];
+  while (std::fgets(buf, sizeof buf, f) != nullptr) {
+    text += buf;
+  }
+  std::fclose(f);
+
+  EXPECT_NE(text.find("secret access profile"), std::string::npos);
+  if (secret_profile::kEnabled) {
+    EXPECT_NE(text.find("test_secret_profiler.cc"), std::string::npos) << text;
+  }
+}
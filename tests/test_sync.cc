@@ -0,0 +1,411 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "TestKdf.h"
+
+#include <pwledger/MerkleTree.h>
+#include <pwledger/SodiumInit.h>
+#include <pwledger/Transaction.h>
+#include <pwledger/VaultSync.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace pwledger;
+
+namespace {
+
+MerkleTree::Hash hash_of(std::size_t n) {
+  MerkleTree::Hash hash{};
+  std::memcpy(hash.data(), &n, sizeof(n));
+  return hash;
+}
+
+std::chrono::system_clock::time_point at(int seconds) {
+  return std::chrono::system_clock::time_point(std::chrono::seconds(1'700'000'000 + seconds));
+}
+
+// One copy of the vault, with what it knows about the other machine.
+struct Machine {
+  PrimaryTable table;
+  MerkleTree current;
+  SyncPeerState peer;
+
+  void rehash() { current = MerkleTree::of(table); }
+};
+
+class SyncTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() { ASSERT_TRUE(sodium_init_once()); }
+
+  void SetUp() override {
+    const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+    dir_ = std::filesystem::temp_directory_path() / ("pwledger_test_sync_" + std::string(info->name()));
+    std::filesystem::remove_all(dir_);
+    std::filesystem::create_directories(dir_);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(dir_); }
+
+  static SecretEntry make_entry(const std::string& key, std::string_view secret, int modified) {
+    SecretEntry entry(key, key + "@example.com", 256, 16);
+    entry.plaintext_secret.with_write_access([&](std::span<char> buf) {
+      std::memset(buf.data(), 0, buf.size());
+      std::memcpy(buf.data(), secret.data(), secret.size());
+    });
+    entry.metadata.created_at = at(0);
+    entry.metadata.last_modified_at = at(modified);
+    entry.metadata.last_used_at = at(modified);
+    return entry;
+  }
+
+  static std::string secret_of(const PrimaryTable& table, const Uuid& uuid) {
+    return table.at(uuid).plaintext_secret.with_read_access(
+        [](std::span<const char> buf) { return std::string(buf.data(), ::strnlen(buf.data(), buf.size())); });
+  }
+
+  static SyncReport send(Machine& from, Machine& to) {
+    SyncDelta delta = VaultSync::make_delta(from.table, from.current, from.peer);
+    return VaultSync::apply_delta(to.table, to.current, to.peer, std::move(delta));
+  }
+
+  static void edit(Machine& m, const Uuid& uuid, std::string_view secret, int modified) {
+    SecretEntry& entry = m.table.at(uuid);
+    entry = make_entry(entry.primary_key, secret, modified);
+    m.current.set(uuid, MerkleTree::hash_entry(uuid, entry));
+  }
+
+  std::filesystem::path dir_;
+};
+
+// ----------------------------------------------------------------------------
+// MerkleTree
+// ----------------------------------------------------------------------------
+
+TEST_F(SyncTest, TreeShapeDependsOnlyOnContents) {
+  std::vector<Uuid> uuids(500);
+  std::generate(uuids.begin(), uuids.end(), Uuid::generate);
+
+  MerkleTree forward, backward, churned;
+  for (std::size_t i = 0; i < uuids.size(); ++i) {
+    forward.set(uuids[i], hash_of(i));
+    churned.set(uuids[i], hash_of(i + 1));
+  }
+  for (std::size_t i = uuids.size(); i > 0; --i) {
+    backward.set(uuids[i - 1], hash_of(i - 1));
+  }
+  EXPECT_EQ(forward.size(), 500u);
+  EXPECT_EQ(forward.root(), backward.root());
+  EXPECT_NE(forward.root(), churned.root());
+
+  // Removing most entries collapses the buckets back to the shape a fresh
+  // tree of the survivors has.
+  MerkleTree survivors;
+  for (std::size_t i = 0; i < uuids.size(); ++i) {
+    churned.set(uuids[i], hash_of(i));
+    if (i % 50 == 0) {
+      survivors.set(uuids[i], hash_of(i));
+    } else {
+      EXPECT_TRUE(churned.erase(uuids[i]));
+    }
+  }
+  EXPECT_FALSE(churned.erase(uuids[1]));
+  EXPECT_EQ(churned.size(), survivors.size());
+  EXPECT_EQ(churned.root(), survivors.root());
+  EXPECT_EQ(churned.serialize(), survivors.serialize());
+  EXPECT_EQ(MerkleTree().root(), MerkleTree::Hash{});
+}
+
+TEST_F(SyncTest, DiffVisitsOnlyChangedPaths) {
+  constexpr std::size_t kEntries = 20'000;
+  std::vector<Uuid> uuids(kEntries);
+  std::generate(uuids.begin(), uuids.end(), Uuid::generate);
+  MerkleTree ours;
+  for (std::size_t i = 0; i < kEntries; ++i) {
+    ours.set(uuids[i], hash_of(i));
+  }
+  const std::vector<std::uint8_t> bytes = ours.serialize();
+  MerkleTree theirs = MerkleTree::parse(bytes.data(), bytes.size());
+  EXPECT_EQ(ours.root(), theirs.root());
+  EXPECT_TRUE(ours.diff(theirs).empty());
+  EXPECT_EQ(ours.last_diff_visits(), 1u);
+
+  const Uuid added = Uuid::generate();
+  theirs.set(uuids[7], hash_of(kEntries + 7));
+  theirs.erase(uuids[42]);
+  theirs.set(added, hash_of(kEntries));
+
+  const std::vector<MerkleTree::Change> changes = ours.diff(theirs);
+  ASSERT_EQ(changes.size(), 3u);
+  for (const MerkleTree::Change& c : changes) {
+    if (c.uuid == uuids[7]) {
+      EXPECT_EQ(c.ours, hash_of(7));
+      EXPECT_EQ(c.theirs, hash_of(kEntries + 7));
+    } else if (c.uuid == uuids[42]) {
+      EXPECT_EQ(c.ours, hash_of(42));
+      EXPECT_FALSE(c.theirs.has_value());
+    } else {
+      EXPECT_EQ(c.uuid, added);
+      EXPECT_FALSE(c.ours.has_value());
+    }
+  }
+  // Three root-to-leaf paths of 16-way nodes, not 20000 entries.
+  EXPECT_LT(ours.last_diff_visits(), 3u * 16u * 4u);
+}
+
+TEST_F(SyncTest, TreeParseRejectsMalformedInput) {
+  MerkleTree tree;
+  tree.set(Uuid::generate(), hash_of(1));
+  std::vector<std::uint8_t> bytes = tree.serialize();
+  EXPECT_EQ(MerkleTree::parse(bytes.data(), bytes.size()).root(), tree.root());
+
+  bytes.push_back(0);
+  EXPECT_THROW((void)MerkleTree::parse(bytes.data(), bytes.size()), std::runtime_error);
+  bytes.resize(bytes.size() - 2);
+  EXPECT_THROW((void)MerkleTree::parse(bytes.data(), bytes.size()), std::runtime_error);
+  bytes[0] = 'X';
+  EXPECT_THROW((void)MerkleTree::parse(bytes.data(), bytes.size()), std::runtime_error);
+}
+
+// ----------------------------------------------------------------------------
+// Delta and merge
+// ----------------------------------------------------------------------------
+
+TEST_F(SyncTest, OneSidedChangesPropagateAndOnlyChangesTravel) {
+  Machine a, b;
+  std::vector<Uuid> uuids(50);
+  for (std::size_t i = 0; i < uuids.size(); ++i) {
+    uuids[i] = Uuid::generate();
+    a.table.emplace(uuids[i], make_entry("site" + std::to_string(i), "pw" + std::to_string(i), 1));
+  }
+  a.rehash();
+  b.rehash();
+
+  SyncReport report = send(a, b);
+  EXPECT_EQ(report.added, 50u);
+  EXPECT_EQ(b.current.root(), a.current.root());
+
+  // B has nothing new; its reply only acknowledges what arrived.
+  SyncDelta reply = VaultSync::make_delta(b.table, b.current, b.peer);
+  EXPECT_TRUE(reply.items.empty());
+  EXPECT_EQ(reply.acks.size(), 50u);
+  report = VaultSync::apply_delta(a.table, a.current, a.peer, std::move(reply));
+  EXPECT_TRUE(report.conflicts.empty());
+  EXPECT_TRUE(VaultSync::make_delta(a.table, a.current, a.peer).items.empty());
+
+  edit(a, uuids[3], "new3", 2);
+  a.table.erase(uuids[4]);
+  a.current.erase(uuids[4]);
+  const Uuid fresh = Uuid::generate();
+  a.table.emplace(fresh, make_entry("fresh", "pw", 2));
+  a.current.set(fresh, MerkleTree::hash_entry(fresh, a.table.at(fresh)));
+
+  SyncDelta delta = VaultSync::make_delta(a.table, a.current, a.peer);
+  EXPECT_EQ(delta.items.size(), 3u);
+  report = VaultSync::apply_delta(b.table, b.current, b.peer, std::move(delta));
+  EXPECT_EQ(report.added, 1u);
+  EXPECT_EQ(report.updated, 1u);
+  EXPECT_EQ(report.removed, 1u);
+  EXPECT_TRUE(report.conflicts.empty());
+  EXPECT_EQ(secret_of(b.table, uuids[3]), "new3");
+  EXPECT_EQ(b.table.count(uuids[4]), 0u);
+  EXPECT_EQ(b.current.root(), a.current.root());
+  EXPECT_EQ(b.current.root(), MerkleTree::of(b.table).root());
+
+  send(b, a);
+  EXPECT_TRUE(VaultSync::make_delta(a.table, a.current, a.peer).items.empty());
+  EXPECT_TRUE(VaultSync::make_delta(b.table, b.current, b.peer).items.empty());
+}
+
+TEST_F(SyncTest, ConflictsResolveTheSameWayOnBothMachines) {
+  Machine a, b;
+  const Uuid both = Uuid::generate(), gone = Uuid::generate(), copied = Uuid::generate();
+  a.table.emplace(both, make_entry("both", "v1", 1));
+  a.table.emplace(gone, make_entry("gone", "v1", 1));
+  a.table.emplace(copied, make_entry("copied", "v1", 1));
+  a.rehash();
+  b.rehash();
+  send(a, b);
+  send(b, a);
+
+  // Both edit `both`, B later; A edits `gone`, which B removes; both copy
+  // `copied`, which only bumps last_used_at.
+  edit(a, both, "from-a", 5);
+  edit(b, both, "from-b", 9);
+  edit(a, gone, "kept", 5);
+  b.table.erase(gone);
+  b.current.erase(gone);
+  a.table.at(copied).metadata.last_used_at = at(20);
+  a.current.set(copied, MerkleTree::hash_entry(copied, a.table.at(copied)));
+  b.table.at(copied).metadata.last_used_at = at(30);
+  b.current.set(copied, MerkleTree::hash_entry(copied, b.table.at(copied)));
+
+  // The deltas cross: each is made before the other is applied.
+  SyncDelta to_b = VaultSync::make_delta(a.table, a.current, a.peer);
+  SyncDelta to_a = VaultSync::make_delta(b.table, b.current, b.peer);
+  const SyncReport at_b = VaultSync::apply_delta(b.table, b.current, b.peer, std::move(to_b));
+  const SyncReport at_a = VaultSync::apply_delta(a.table, a.current, a.peer, std::move(to_a));
+
+  EXPECT_EQ(a.current.root(), b.current.root());
+  EXPECT_EQ(secret_of(a.table, both), "from-b");
+  EXPECT_EQ(secret_of(b.table, gone), "kept");
+  EXPECT_EQ(a.table.at(copied).metadata.last_used_at, at(30));
+
+  ASSERT_EQ(at_a.conflicts.size(), 2u);
+  ASSERT_EQ(at_b.conflicts.size(), 2u);
+  for (const SyncReport* report : {&at_a, &at_b}) {
+    for (const SyncConflict& c : report->conflicts) {
+      if (c.uuid == both) {
+        EXPECT_EQ(c.kind, SyncConflict::Kind::kBothChanged);
+        EXPECT_EQ(c.kept_local, report == &at_b);
+      } else {
+        EXPECT_EQ(c.uuid, gone);
+        EXPECT_EQ(c.primary_key, "gone");
+        EXPECT_EQ(c.kind, report == &at_a ? SyncConflict::Kind::kChangedHereRemovedThere
+                                          : SyncConflict::Kind::kRemovedHereChangedThere);
+      }
+    }
+  }
+
+  // One more round trip settles the bases: nothing left to send.
+  send(a, b);
+  send(b, a);
+  EXPECT_TRUE(VaultSync::make_delta(a.table, a.current, a.peer).items.empty());
+  EXPECT_TRUE(VaultSync::make_delta(b.table, b.current, b.peer).items.empty());
+}
+
+TEST_F(SyncTest, LostDeltaIsResent) {
+  Machine a, b;
+  const Uuid uuid = Uuid::generate();
+  a.table.emplace(uuid, make_entry("site", "pw", 1));
+  a.rehash();
+  b.rehash();
+
+  (void)VaultSync::make_delta(a.table, a.current, a.peer);  // never delivered
+  const SyncReport report = send(a, b);
+  EXPECT_EQ(report.added, 1u);
+  EXPECT_EQ(b.current.root(), a.current.root());
+}
+
+// A merge staged in a transaction reaches the table only with a save that
+// succeeds; after a failed one the table is as it was and the commit can
+// be retried.
+TEST_F(SyncTest, StagedMergeLandsOnlyWithTheSave) {
+  Machine a, b;
+  const Uuid changed = Uuid::generate(), removed = Uuid::generate();
+  a.table.emplace(changed, make_entry("changed", "v1", 1));
+  a.table.emplace(removed, make_entry("removed", "v1", 1));
+  a.rehash();
+  b.rehash();
+  send(a, b);
+  send(b, a);
+
+  edit(a, changed, "v2", 2);
+  a.table.erase(removed);
+  a.current.erase(removed);
+  const Uuid added = Uuid::generate();
+  a.table.emplace(added, make_entry("added", "v1", 2));
+  a.current.set(added, MerkleTree::hash_entry(added, a.table.at(added)));
+
+  const MerkleTree::Hash before = MerkleTree::of(b.table).root();
+  Transaction tx(b.table);
+  const SyncReport report =
+      VaultSync::apply_delta(tx, b.table, b.current, b.peer, VaultSync::make_delta(a.table, a.current, a.peer));
+  EXPECT_EQ(report.added + report.updated + report.removed, 3u);
+  EXPECT_EQ(MerkleTree::of(b.table).root(), before);
+
+  EXPECT_THROW(tx.commit([](const PrimaryTable&) { throw std::runtime_error("disk full"); }), std::runtime_error);
+  EXPECT_EQ(MerkleTree::of(b.table).root(), before);
+  EXPECT_EQ(secret_of(b.table, changed), "v1");
+
+  tx.commit([](const PrimaryTable&) {});
+  EXPECT_EQ(MerkleTree::of(b.table).root(), a.current.root());
+  EXPECT_EQ(secret_of(b.table, changed), "v2");
+}
+
+TEST_F(SyncTest, DeltaListingAnEntryTwiceIsRefused) {
+  Machine a, b;
+  const Uuid uuid = Uuid::generate();
+  a.table.emplace(uuid, make_entry("site", "pw", 1));
+  a.rehash();
+  b.rehash();
+
+  SyncDelta delta = VaultSync::make_delta(a.table, a.current, a.peer);
+  delta.items.push_back(SyncDelta::Item{uuid, std::nullopt, std::nullopt});
+  EXPECT_THROW(VaultSync::apply_delta(b.table, b.current, b.peer, std::move(delta)), std::runtime_error);
+  EXPECT_TRUE(b.table.empty());
+}
+
+// ----------------------------------------------------------------------------
+// Files
+// ----------------------------------------------------------------------------
+
+TEST_F(SyncTest, FilesRoundTripSealed) {
+  Machine a, b;
+  const Uuid kept = Uuid::generate(), removed = Uuid::generate();
+  a.table.emplace(kept, make_entry("kept", "secret", 1));
+  a.table.emplace(removed, make_entry("removed", "secret", 1));
+  a.rehash();
+  b.rehash();
+  send(a, b);
+  a.peer.base = MerkleTree::of(a.table);
+  a.table.erase(removed);
+  a.current.erase(removed);
+  edit(a, kept, "changed", 2);
+  a.peer.unacked.push_back(Uuid::generate());
+
+  const std::filesystem::path file = dir_ / "a-to-b.pwsync";
+  SyncDelta delta = VaultSync::make_delta(a.table, a.current, a.peer);
+  VaultSync::write_delta(file, delta, "carry", kFastKdf);
+  EXPECT_THROW((void)VaultSync::read_delta(file, "wrong"), std::runtime_error);
+  SyncDelta read = VaultSync::read_delta(file, "carry");
+  ASSERT_EQ(read.items.size(), 2u);
+  ASSERT_EQ(read.acks.size(), 1u);
+  EXPECT_FALSE(read.acks[0].held.has_value());
+
+  const SyncReport report = VaultSync::apply_delta(b.table, b.current, b.peer, std::move(read));
+  EXPECT_EQ(report.updated, 1u);
+  EXPECT_EQ(report.removed, 1u);
+  EXPECT_EQ(secret_of(b.table, kept), "changed");
+  EXPECT_EQ(b.current.root(), a.current.root());
+
+  const std::filesystem::path vault = dir_ / "vault.dat";
+  const std::filesystem::path state = VaultSync::state_path(vault, "laptop");
+  EXPECT_EQ(state, dir_ / "vault.dat.sync" / "laptop.state");
+  EXPECT_THROW((void)VaultSync::state_path(vault, "../laptop"), std::invalid_argument);
+  EXPECT_THROW((void)VaultSync::state_path(vault, ".."), std::invalid_argument);
+  EXPECT_THROW((void)VaultSync::state_path(vault, ""), std::invalid_argument);
+
+  EXPECT_EQ(VaultSync::read_state(state, "master").base.size(), 0u);
+  VaultSync::write_state(state, b.peer, "master", kFastKdf);
+  const SyncPeerState loaded = VaultSync::read_state(state, "master");
+  EXPECT_EQ(loaded.base.root(), b.peer.base.root());
+  EXPECT_EQ(loaded.unacked, b.peer.unacked);
+  EXPECT_THROW((void)VaultSync::read_state(state, "wrong"), std::runtime_error);
+}
+
+}  // namespace
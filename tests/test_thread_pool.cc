@@ -0,0 +1,202 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <pwledger/ThreadPool.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <latch>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace pwledger;
+
+namespace {
+
+ThreadPoolConfig pool_config(int threads) {
+  ThreadPoolConfig config;
+  config.threads = threads;
+  return config;
+}
+
+}  // namespace
+
+// 1. The pool has the configured number of workers, and submit() returns
+// each task's result through its future.
+TEST(ThreadPoolTest, SubmitReturnsResults) {
+  ThreadPool pool(pool_config(3));
+  EXPECT_EQ(pool.size(), 3u);
+  EXPECT_FALSE(pool.on_worker_thread());
+
+  std::vector<std::future<int>> results;
+  for (int i = 0; i < 100; ++i) {
+    results.push_back(pool.submit([i] { return i * i; }));
+  }
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(results[static_cast<std::size_t>(i)].get(), i * i);
+  }
+  EXPECT_TRUE(pool.submit([&pool] { return pool.on_worker_thread(); }).get());
+}
+
+// 2. An exception thrown by a task reaches its future.
+TEST(ThreadPoolTest, SubmitPropagatesExceptions) {
+  ThreadPool pool(pool_config(2));
+  auto failing = pool.submit([]() -> int { throw std::logic_error("task failed"); });
+  EXPECT_THROW(failing.get(), std::logic_error);
+  EXPECT_EQ(pool.submit([] { return 7; }).get(), 7);
+}
+
+// 3. parallel_for visits every index exactly once, for any grain and
+// parallelism cap, including grains that do not divide the range.
+TEST(ThreadPoolTest, ParallelForCoversRange) {
+  ThreadPool pool(pool_config(4));
+  for (const std::size_t grain : {1u, 3u, 64u, 5000u}) {
+    for (const std::size_t cap : {0u, 1u, 2u}) {
+      std::vector<std::atomic<int>> hits(1000);
+      pool.parallel_for(10, 1000, [&](std::size_t i) { hits[i].fetch_add(1); }, grain, cap);
+      for (std::size_t i = 0; i < hits.size(); ++i) {
+        ASSERT_EQ(hits[i].load(), i < 10 ? 0 : 1) << "grain=" << grain << " cap=" << cap << " i=" << i;
+      }
+    }
+  }
+  bool called = false;
+  pool.parallel_for(5, 5, [&](std::size_t) { called = true; });
+  EXPECT_FALSE(called);
+}
+
+// 4. The first exception from the body is rethrown once the claimed chunks
+// have finished.
+TEST(ThreadPoolTest, ParallelForRethrows) {
+  ThreadPool pool(pool_config(2));
+  std::atomic<int> calls{0};
+  EXPECT_THROW(pool.parallel_for(0, 100,
+                                 [&](std::size_t i) {
+                                   calls.fetch_add(1);
+                                   if (i == 0) {
+                                     throw std::runtime_error("chunk failed");
+                                   }
+                                 }),
+               std::runtime_error);
+  EXPECT_GE(calls.load(), 1);
+  EXPECT_LE(calls.load(), 100);
+}
+
+// 5. parallel_for inside tasks, on a pool with fewer workers than tasks,
+// completes: callers work through their own chunks instead of waiting on
+// queued ones.
+TEST(ThreadPoolTest, NestedParallelForDoesNotDeadlock) {
+  ThreadPool pool(pool_config(2));
+  std::vector<std::future<std::size_t>> outer;
+  for (int t = 0; t < 8; ++t) {
+    outer.push_back(pool.submit([&pool] {
+      std::vector<std::size_t> values(256);
+      pool.parallel_for(0, values.size(), [&](std::size_t i) { values[i] = i; });
+      return std::accumulate(values.begin(), values.end(), std::size_t{0});
+    }));
+  }
+  for (auto& f : outer) {
+    ASSERT_EQ(f.wait_for(std::chrono::seconds(30)), std::future_status::ready);
+    EXPECT_EQ(f.get(), 255u * 256u / 2u);
+  }
+}
+
+// 6. Tasks a worker pushes onto its own deque are stolen by idle workers:
+// the three below can only finish together, while their submitter blocks.
+TEST(ThreadPoolTest, IdleWorkersSteal) {
+  ThreadPool pool(pool_config(4));
+  auto submitter = pool.submit([&pool] {
+    std::latch all_running(3);
+    std::vector<std::future<void>> children;
+    for (int i = 0; i < 3; ++i) {
+      children.push_back(pool.submit([&all_running] { all_running.arrive_and_wait(); }));
+    }
+    for (auto& child : children) {
+      child.get();
+    }
+  });
+  ASSERT_EQ(submitter.wait_for(std::chrono::seconds(30)), std::future_status::ready);
+  submitter.get();
+  pool.shutdown();
+  EXPECT_GE(pool.stats().stolen, 3u);
+  EXPECT_EQ(pool.stats().executed, 4u);
+}
+
+// 7. Shutdown drains queued tasks by default, drops them when configured
+// not to, and refuses new ones afterwards.
+TEST(ThreadPoolTest, ShutdownHonoursDrainSetting) {
+  for (const bool drain : {true, false}) {
+    ThreadPoolConfig config = pool_config(1);
+    config.drain_on_shutdown = drain;
+    ThreadPool pool(config);
+
+    std::latch release(1);
+    auto blocker = pool.submit([&release] { release.wait(); });
+    std::atomic<int> ran{0};
+    std::vector<std::future<void>> queued;
+    for (int i = 0; i < 5; ++i) {
+      queued.push_back(pool.submit([&ran] { ran.fetch_add(1); }));
+    }
+
+    // Release the blocker only once shutdown has begun (submit refuses).
+    std::thread stopper([&pool] { pool.shutdown(); });
+    for (;;) {
+      try {
+        pool.submit([] {});
+      } catch (const std::runtime_error&) {
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    release.count_down();
+    stopper.join();
+    blocker.get();
+
+    if (drain) {
+      EXPECT_EQ(ran.load(), 5);
+      for (auto& f : queued) {
+        EXPECT_NO_THROW(f.get());
+      }
+    } else {
+      EXPECT_EQ(ran.load(), 0);
+      for (auto& f : queued) {
+        EXPECT_THROW(f.get(), std::future_error);
+      }
+    }
+    EXPECT_THROW(pool.submit([] {}), std::runtime_error);
+
+    // parallel_for still works, on the calling thread alone.
+    std::atomic<int> sum{0};
+    pool.parallel_for(0, 10, [&](std::size_t i) { sum.fetch_add(static_cast<int>(i)); });
+    EXPECT_EQ(sum.load(), 45);
+  }
+}
+
+// 8. The shared pool takes its configuration from configure_shared until
+// it is first used.
+TEST(ThreadPoolTest, SharedPoolIsConfiguredOnce) {
+  EXPECT_TRUE(ThreadPool::configure_shared(pool_config(2)));
+  EXPECT_EQ(ThreadPool::shared().size(), 2u);
+  EXPECT_FALSE(ThreadPool::configure_shared(pool_config(5)));
+  EXPECT_EQ(ThreadPool::shared().size(), 2u);
+}
@@ -0,0 +1,158 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <pwledger/PrimaryTable.h>
+#include <pwledger/Trace.h>
+#include <pwledger/VaultCrypto.h>
+#include <pwledger/VaultIO.h>
+#include <pwledger/uuid.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <nlohmann/json.hpp>
+#include <sodium.h>
+
+using namespace pwledger;
+using json = nlohmann::json;
+
+class TraceTest : public ::testing::Test {
+protected:
+  static void SetUpTestSuite() {
+    if (sodium_init() < 0) {
+      throw std::runtime_error("libsodium init failed");
+    }
+  }
+
+  void SetUp() override {
+#if !PWLEDGER_TRACING
+    GTEST_SKIP() << "built with PWLEDGER_ENABLE_TRACING=OFF";
+#endif
+    auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+    base_ = std::filesystem::temp_directory_path() / (std::string("pwledger_trace_") + info->name());
+    trace_path_ = base_;
+    trace_path_ += ".json";
+    trace::set_output(trace_path_);
+  }
+
+  void TearDown() override {
+    trace::set_output({});
+    std::filesystem::remove(trace_path_);
+    std::filesystem::remove(base_);
+  }
+
+  // Flushes and returns the complete ("X") events, in recording order.
+  json read_spans() {
+    EXPECT_TRUE(trace::flush());
+    std::ifstream in(trace_path_);
+    json doc = json::parse(in);
+    json spans = json::array();
+    for (const auto& e : doc.at("traceEvents")) {
+      if (e.at("ph") == "X") spans.push_back(e);
+    }
+    return spans;
+  }
+
+  static const json* find(const json& spans, const std::string& name) {
+    for (const auto& e : spans) {
+      if (e.at("name") == name) return &e;
+    }
+    return nullptr;
+  }
+
+  // True if `inner` lies within `outer` on the same thread.
+  static bool nested(const json& inner, const json& outer) {
+    const double slack = 0.001;
+    return inner.at("tid") == outer.at("tid") &&
+           inner.at("ts").get<double>() + slack >= outer.at("ts").get<double>() &&
+           inner.at("ts").get<double>() + inner.at("dur").get<double>() <=
+               outer.at("ts").get<double>() + outer.at("dur").get<double>() + slack;
+  }
+
+  std::filesystem::path base_;
+  std::filesystem::path trace_path_;
+};
+
+// 1. Nested spans are written as Chrome trace-event JSON with their arguments.
+TEST_F(TraceTest, WritesNestedCompleteEvents) {
+  {
+    trace::Span outer("outer");
+    outer.arg("items", 3);
+    PWLEDGER_TRACE_SPAN("inner");
+  }
+
+  const json spans = read_spans();
+  ASSERT_EQ(spans.size(), 2u);
+  const json* outer = find(spans, "outer");
+  const json* inner = find(spans, "inner");
+  ASSERT_NE(outer, nullptr);
+  ASSERT_NE(inner, nullptr);
+  EXPECT_EQ(outer->at("args").at("items"), 3);
+  EXPECT_FALSE(inner->contains("args"));
+  EXPECT_TRUE(nested(*inner, *outer));
+}
+
+// 2. A save/load round trip records every phase, nested under its caller.
+TEST_F(TraceTest, VaultRoundTripPhases) {
+  const KdfParams fast{crypto_pwhash_OPSLIMIT_MIN, crypto_pwhash_MEMLIMIT_MIN};
+  {
+    PrimaryTable table;
+    for (int i = 0; i < 3; ++i) {
+      SecretEntry entry("site" + std::to_string(i), "user", 256, VaultCrypto::kSaltBytes);
+      table.emplace(Uuid::generate(), std::move(entry));
+    }
+    VaultIO::save_vault(base_, table, "pw", fast);
+    PrimaryTable loaded = VaultIO::load_vault(base_, "pw", fast);
+    ASSERT_EQ(loaded.size(), 3u);
+  }
+
+  const json spans = read_spans();
+  for (const char* name : {"VaultIO::save_vault", "VaultIO::save_serialized", "VaultSerializer::serialize",
+                           "VaultCrypto::encrypt_vault", "VaultCrypto::aead_encrypt", "VaultIO::write_file",
+                           "VaultIO::load_vault", "VaultIO::read_file", "VaultCrypto::decrypt_vault",
+                           "VaultCrypto::aead_decrypt", "VaultSerializer::deserialize"}) {
+    EXPECT_NE(find(spans, name), nullptr) << name;
+  }
+
+  const json* load = find(spans, "VaultIO::load_vault");
+  const json* deserialize = find(spans, "VaultSerializer::deserialize");
+  ASSERT_NE(load, nullptr);
+  ASSERT_NE(deserialize, nullptr);
+  EXPECT_TRUE(nested(*deserialize, *load));
+  EXPECT_EQ(deserialize->at("args").at("entries"), 3);
+  EXPECT_TRUE(deserialize->at("args").contains("insert_us"));
+
+  // One key derivation per save and one per load.
+  int derivations = 0;
+  for (const auto& e : spans) {
+    if (e.at("name") == "VaultCrypto::derive_master_key") ++derivations;
+  }
+  EXPECT_EQ(derivations, 2);
+}
+
+// 3. With no output configured nothing is recorded and flush reports it.
+TEST_F(TraceTest, DisabledRecordsNothing) {
+  trace::set_output({});
+  EXPECT_FALSE(trace::enabled());
+  { PWLEDGER_TRACE_SPAN("ignored"); }
+  EXPECT_FALSE(trace::flush());
+  EXPECT_FALSE(std::filesystem::exists(trace_path_));
+}
@@ -0,0 +1,195 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <pwledger/SodiumInit.h>
+#include <pwledger/Transaction.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+using namespace pwledger;
+
+namespace {
+
+class TransactionTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() { ASSERT_TRUE(sodium_init_once()); }
+
+  static Secret make_secret(std::string_view value) {
+    Secret secret(256);
+    secret.with_write_access([&](std::span<char> buf) {
+      std::memset(buf.data(), 0, buf.size());
+      std::memcpy(buf.data(), value.data(), value.size());
+    });
+    return secret;
+  }
+
+  static SecretEntry make_entry(const std::string& key, std::string_view secret) {
+    SecretEntry entry(key, key + "@example.com", 256, 16);
+    entry.plaintext_secret = make_secret(secret);
+    return entry;
+  }
+
+  static std::string secret_of(const PrimaryTable& table, const Uuid& uuid) {
+    return table.at(uuid).plaintext_secret.with_read_access(
+        [](std::span<const char> buf) { return std::string(buf.data(), ::strnlen(buf.data(), buf.size())); });
+  }
+};
+
+TEST_F(TransactionTest, StagingLeavesTheTableAlone) {
+  PrimaryTable table;
+  const Uuid existing = Uuid::generate();
+  table.emplace(existing, make_entry("existing", "old"));
+
+  {
+    Transaction tx(table);
+    tx.insert(make_entry("new", "pw"));
+    tx.update_secret(existing, make_secret("changed"));
+    tx.erase(existing);
+    EXPECT_EQ(tx.size(), 3u);
+    EXPECT_EQ(table.size(), 1u);
+    EXPECT_EQ(secret_of(table, existing), "old");
+  }  // never committed: rolled back
+
+  EXPECT_EQ(table.size(), 1u);
+  EXPECT_EQ(secret_of(table, existing), "old");
+}
+
+TEST_F(TransactionTest, CommitAppliesInOrderAndPersistsOnce) {
+  PrimaryTable table;
+  const Uuid keep = Uuid::generate();
+  const Uuid drop = Uuid::generate();
+  table.emplace(keep, make_entry("keep", "old"));
+  table.emplace(drop, make_entry("drop", "x"));
+  const auto modified_before = table.at(keep).metadata.last_modified_at;
+
+  Transaction tx(table);
+  const Uuid added = tx.insert(make_entry("added", "first"));
+  tx.update_secret(added, make_secret("second"));  // sees the staged insert
+  tx.update_secret(keep, make_secret("new"));
+  tx.touch(keep);
+  tx.erase(drop);
+
+  int saves = 0;
+  tx.commit([&](const PrimaryTable& t) {
+    ++saves;
+    EXPECT_EQ(t.size(), 2u);
+  });
+
+  EXPECT_EQ(saves, 1);
+  EXPECT_FALSE(tx.active());
+  EXPECT_EQ(table.size(), 2u);
+  EXPECT_FALSE(table.contains(drop));
+  EXPECT_EQ(secret_of(table, added), "second");
+  EXPECT_EQ(secret_of(table, keep), "new");
+  EXPECT_GE(table.at(keep).metadata.last_modified_at, modified_before);
+}
+
+TEST_F(TransactionTest, FailingOperationUndoesEverything) {
+  PrimaryTable table;
+  const Uuid a = Uuid::generate();
+  const Uuid b = Uuid::generate();
+  table.emplace(a, make_entry("a", "a-secret"));
+  table.emplace(b, make_entry("b", "b-secret"));
+  const auto used_before = table.at(a).metadata.last_used_at;
+
+  Transaction tx(table);
+  tx.update_secret(a, make_secret("a-new"));
+  tx.touch(a);
+  tx.erase(b);
+  tx.insert(make_entry("c", "c-secret"));
+  tx.erase(Uuid::generate());  // not in the table
+
+  bool persisted = false;
+  EXPECT_THROW(tx.commit([&](const PrimaryTable&) { persisted = true; }), std::runtime_error);
+
+  EXPECT_FALSE(persisted);
+  EXPECT_TRUE(tx.active());
+  ASSERT_EQ(table.size(), 2u);
+  EXPECT_EQ(secret_of(table, a), "a-secret");
+  EXPECT_EQ(secret_of(table, b), "b-secret");
+  EXPECT_EQ(table.at(a).metadata.last_used_at, used_before);
+}
+
+TEST_F(TransactionTest, InsertOfAnExistingUuidFails) {
+  PrimaryTable table;
+  const Uuid a = Uuid::generate();
+  table.emplace(a, make_entry("a", "original"));
+
+  Transaction tx(table);
+  tx.insert(a, make_entry("a", "duplicate"));
+  EXPECT_THROW(tx.commit(), std::runtime_error);
+  EXPECT_EQ(secret_of(table, a), "original");
+}
+
+TEST_F(TransactionTest, FailedPersistRestoresTheTable) {
+  PrimaryTable table;
+  const Uuid a = Uuid::generate();
+  table.emplace(a, make_entry("a", "before"));
+
+  Transaction tx(table);
+  tx.update_secret(a, make_secret("after"));
+  tx.insert(make_entry("b", "b"));
+
+  EXPECT_THROW(tx.commit([](const PrimaryTable&) { throw std::runtime_error("disk full"); }), std::runtime_error);
+  ASSERT_EQ(table.size(), 1u);
+  EXPECT_EQ(secret_of(table, a), "before");
+
+  // Still open with its operations intact, so the commit can be retried.
+  ASSERT_TRUE(tx.active());
+  tx.commit();
+  EXPECT_EQ(table.size(), 2u);
+  EXPECT_EQ(secret_of(table, a), "after");
+}
+
+TEST_F(TransactionTest, InsertAllMovesEveryEntry) {
+  PrimaryTable staged;
+  for (int i = 0; i < 50; ++i) {
+    staged.emplace(Uuid::generate(), make_entry("e" + std::to_string(i), "s"));
+  }
+  PrimaryTable table;
+  Transaction tx(table);
+  tx.insert_all(std::move(staged));
+  EXPECT_TRUE(staged.empty());
+  EXPECT_EQ(tx.size(), 50u);
+  tx.commit();
+  EXPECT_EQ(table.size(), 50u);
+}
+
+TEST_F(TransactionTest, SingleUse) {
+  PrimaryTable table;
+  Transaction tx(table);
+  const Uuid empty;
+  EXPECT_THROW(tx.erase(empty), std::invalid_argument);
+  tx.commit();
+  EXPECT_THROW(tx.touch(Uuid::generate()), std::logic_error);
+  EXPECT_THROW(tx.commit(), std::logic_error);
+
+  Transaction rolled_back(table);
+  rolled_back.insert(make_entry("x", "y"));
+  rolled_back.rollback();
+  EXPECT_EQ(rolled_back.size(), 0u);
+  EXPECT_THROW(rolled_back.commit(), std::logic_error);
+  EXPECT_TRUE(table.empty());
+}
+
+}  // namespace
@@ -0,0 +1,177 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <pwledger/uuid.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+using pwledger::Uuid;
+
+namespace {
+
+std::uint64_t now_ms() {
+  using namespace std::chrono;
+  return static_cast<std::uint64_t>(duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count());
+}
+
+}  // namespace
+
+// 1. Field layout matches the RFC 9562 Appendix A.6 example.
+TEST(UuidTest, V7FieldLayout) {
+  const Uuid id = Uuid::from_v7_fields(0x017F22E279B0, 0xCC3, 0x18C4DC0C0C07398F);
+  EXPECT_EQ(id.to_string(), "017f22e2-79b0-7cc3-98c4-dc0c0c07398f");
+  EXPECT_EQ(id.version(), 7);
+  EXPECT_EQ(id.timestamp_ms(), 0x017F22E279B0u);
+}
+
+// 2. Generated IDs are version 7, RFC variant, stamped with the current
+// time, and round-trip through both string forms.
+TEST(UuidTest, GenerateIsV7) {
+  const std::uint64_t before = now_ms();
+  const Uuid id = Uuid::generate();
+  const std::uint64_t after = now_ms();
+
+  EXPECT_EQ(id.version(), 7);
+  EXPECT_EQ(id.bytes[8] & 0xC0, 0x80);
+  ASSERT_TRUE(id.timestamp_ms().has_value());
+  EXPECT_GE(*id.timestamp_ms(), before);
+  EXPECT_LE(*id.timestamp_ms(), after + 1);  // +1: a borrowed millisecond
+
+  const std::string text = id.to_string();
+  EXPECT_EQ(Uuid::from_string(text), id);
+  std::string compact = text;
+  compact.erase(std::remove(compact.begin(), compact.end(), '-'), compact.end());
+  EXPECT_EQ(Uuid::from_string(compact), id);
+}
+
+// 3. IDs from one process are strictly increasing, even far faster than
+// one per millisecond.
+TEST(UuidTest, GenerateIsMonotonic) {
+  Uuid prev = Uuid::generate();
+  for (int i = 0; i < 100000; ++i) {
+    const Uuid next = Uuid::generate();
+    ASSERT_TRUE(prev < next) << prev << " !< " << next;
+    prev = next;
+  }
+}
+
+// 4. Concurrent generation yields no duplicates.
+TEST(UuidTest, ConcurrentGenerateIsUnique) {
+  constexpr int kThreads = 4;
+  constexpr int kPerThread = 20000;
+  std::vector<std::vector<Uuid>> ids(kThreads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&ids, t] {
+      ids[static_cast<std::size_t>(t)].reserve(kPerThread);
+      for (int i = 0; i < kPerThread; ++i) {
+        ids[static_cast<std::size_t>(t)].push_back(Uuid::generate());
+      }
+    });
+  }
+  for (auto& th : threads) {
+    th.join();
+  }
+
+  std::unordered_set<Uuid> seen;
+  for (const auto& batch : ids) {
+    EXPECT_TRUE(std::is_sorted(batch.begin(), batch.end()));
+    for (const Uuid& id : batch) {
+      ASSERT_TRUE(seen.insert(id).second) << "duplicate " << id;
+    }
+  }
+}
+
+// 5. Version-4 IDs from existing vaults still parse; they have no timestamp.
+TEST(UuidTest, V4StillParses) {
+  const auto id = Uuid::from_string("f47ac10b-58cc-4372-a567-0e02b2c3d479");
+  ASSERT_TRUE(id.has_value());
+  EXPECT_EQ(id->version(), 4);
+  EXPECT_FALSE(id->timestamp_ms().has_value());
+  EXPECT_EQ(id->to_string(), "f47ac10b-58cc-4372-a567-0e02b2c3d479");
+  EXPECT_FALSE(Uuid::from_string("f47ac10b-58cc-4372-a567-0e02b2c3d47").has_value());
+  EXPECT_FALSE(Uuid::from_string("g47ac10b-58cc-4372-a567-0e02b2c3d479").has_value());
+}
+
+// 6. to_chars writes exactly the canonical form; operator<< matches.
+TEST(UuidTest, ToChars) {
+  Uuid id;
+  for (std::size_t i = 0; i < 16; ++i) {
+    id.bytes[i] = static_cast<std::uint8_t>(i * 17);  // 00 11 22 ... ff
+  }
+  char buf[Uuid::kStringLength + 1];
+  buf[Uuid::kStringLength] = '#';
+  EXPECT_EQ(id.to_chars(buf), buf + Uuid::kStringLength);
+  EXPECT_EQ(buf[Uuid::kStringLength], '#');  // nothing written past the end
+  EXPECT_EQ(std::string_view(buf, Uuid::kStringLength), "00112233-4455-6677-8899-aabbccddeeff");
+  EXPECT_EQ(id.to_string(), "00112233-4455-6677-8899-aabbccddeeff");
+
+  std::ostringstream os;
+  os << id;
+  EXPECT_EQ(os.str(), id.to_string());
+}
+
+// 7. from_chars accepts either case and both forms, and rejects every
+// non-hex byte at every digit position and any misplaced hyphen.
+TEST(UuidTest, FromCharsValidation) {
+  const std::string canonical = "00112233-4455-6677-8899-aabbccddeeff";
+  const auto upper = Uuid::from_chars("00112233-4455-6677-8899-AABBCCDDEEFF");
+  ASSERT_TRUE(upper.has_value());
+  EXPECT_EQ(upper->to_string(), canonical);
+  EXPECT_EQ(Uuid::from_chars("00112233445566778899aAbBcCdDeEfF"), upper);
+
+  for (std::size_t pos = 0; pos < canonical.size(); ++pos) {
+    if (canonical[pos] == '-') {
+      continue;
+    }
+    for (int c = 0; c < 256; ++c) {
+      std::string s = canonical;
+      s[pos] = static_cast<char>(c);
+      const bool hex = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+      ASSERT_EQ(Uuid::from_chars(s).has_value(), hex) << "pos " << pos << " char " << c;
+    }
+  }
+
+  EXPECT_FALSE(Uuid::from_chars("001122334-455-6677-8899-aabbccddeeff").has_value());
+  EXPECT_FALSE(Uuid::from_chars("00112233-4455-6677-8899_aabbccddeeff").has_value());
+  EXPECT_FALSE(Uuid::from_chars("00112233-4455-6677-8899-aabbccddeef").has_value());
+  EXPECT_FALSE(Uuid::from_chars("").has_value());
+}
+
+// 8. Random round trips.
+TEST(UuidTest, CharsRoundTrip) {
+  for (int i = 0; i < 10000; ++i) {
+    Uuid id;
+    for (auto& b : id.bytes) {
+      b = static_cast<std::uint8_t>(std::rand());
+    }
+    char buf[Uuid::kStringLength];
+    id.to_chars(buf);
+    ASSERT_EQ(Uuid::from_chars(std::string_view(buf, sizeof(buf))), id);
+  }
+}
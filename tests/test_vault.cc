@@ -30,6 +30,7 @@
 #include <chrono>
 #include <cstring>
 #include <filesystem>
+#include <fstream>
 #include <string>
 
 using namespace pwledger;
@@ -146,7 +147,7 @@ TEST_F(VaultTest, EncryptDecryptRoundTrip) {
   std::vector<std::uint8_t> plaintext = {1, 2, 3, 4, 5, 255, 0, 42};
 
   std::vector<std::uint8_t> ciphertext = VaultCrypto::encrypt_vault(password, plaintext);
-  EXPECT_GT(ciphertext.size(), plaintext.size() + VaultCrypto::kHeaderBytes);
+  EXPECT_GT(ciphertext.size(), plaintext.size() + VaultCrypto::header_bytes(VaultCrypto::cipher_suite_of(ciphertext)));
 
   std::vector<std::uint8_t> decrypted = VaultCrypto::decrypt_vault(password, ciphertext);
   EXPECT_EQ(plaintext, decrypted);
@@ -172,6 +173,240 @@ TEST_F(VaultTest, DecryptCorruptDataFails) {
   EXPECT_THROW(VaultCrypto::decrypt_vault(password, ciphertext), std::runtime_error);
 }
 
+TEST_F(VaultTest, EachCipherSuiteRoundTrips) {
+  const std::vector<std::uint8_t> plaintext(100000, 0x5A);
+  for (const CipherSuite suite : {CipherSuite::kXChaCha20Poly1305, CipherSuite::kAes256Gcm}) {
+    if (suite == CipherSuite::kAes256Gcm && crypto_aead_aes256gcm_is_available() == 0) {
+      continue;
+    }
+    SCOPED_TRACE(std::string(cipher_suite_name(suite)));
+    const auto blob = VaultCrypto::encrypt_vault("pw", plaintext, {}, suite);
+    EXPECT_EQ(blob.size(), VaultCrypto::header_bytes(suite) + plaintext.size() + VaultCrypto::kTagBytes);
+    EXPECT_EQ(VaultCrypto::cipher_suite_of(blob), suite);
+    EXPECT_EQ(VaultCrypto::decrypt_vault("pw", blob), plaintext);
+  }
+}
+
+TEST_F(VaultTest, DefaultCipherSuiteFollowsHardware) {
+  EXPECT_EQ(VaultCrypto::default_cipher_suite(), crypto_aead_aes256gcm_is_available() != 0
+                                                     ? CipherSuite::kAes256Gcm
+                                                     : CipherSuite::kXChaCha20Poly1305);
+  EXPECT_EQ(parse_cipher_suite("aes256gcm"), CipherSuite::kAes256Gcm);
+  EXPECT_EQ(parse_cipher_suite("xchacha20poly1305"), CipherSuite::kXChaCha20Poly1305);
+  EXPECT_FALSE(parse_cipher_suite("aes128gcm").has_value());
+}
+
+TEST_F(VaultTest, HeaderIsAuthenticated) {
+  const std::vector<std::uint8_t> plaintext = {1, 2, 3};
+  auto blob = VaultCrypto::encrypt_vault("pw", plaintext, {}, CipherSuite::kXChaCha20Poly1305);
+
+  // The header is additional data: a flipped nonce bit fails the tag. An
+  // unknown suite byte is rejected before any key derivation.
+  auto tampered = blob;
+  tampered[VaultCrypto::kPrefixBytes + VaultCrypto::kSaltBytes] ^= 1;
+  EXPECT_THROW(VaultCrypto::decrypt_vault("pw", tampered), std::runtime_error);
+
+  tampered = blob;
+  tampered[sizeof(VaultCrypto::kMagic) + 1] = 0x7F;
+  EXPECT_THROW(VaultCrypto::cipher_suite_of(tampered), std::runtime_error);
+  EXPECT_THROW(VaultCrypto::decrypt_vault("pw", tampered), std::runtime_error);
+}
+
+TEST_F(VaultTest, LegacyHeaderlessVaultStillDecrypts) {
+  // [salt][xchacha nonce][ciphertext], no additional data: the format before
+  // the suite header existed.
+  const std::vector<std::uint8_t> plaintext = {9, 8, 7, 6};
+  std::vector<std::uint8_t> blob(VaultCrypto::kSaltBytes + crypto_aead_xchacha20poly1305_ietf_NPUBBYTES +
+                                 plaintext.size() + VaultCrypto::kTagBytes);
+  randombytes_buf(blob.data(), VaultCrypto::kSaltBytes + crypto_aead_xchacha20poly1305_ietf_NPUBBYTES);
+  blob[0] = 0;  // keep the random salt from looking like the magic
+  const Secret key = VaultCrypto::derive_master_key("pw", blob.data());
+  key.with_read_access([&](std::span<const char> k) {
+    ASSERT_EQ(crypto_aead_xchacha20poly1305_ietf_encrypt(
+                  blob.data() + VaultCrypto::kSaltBytes + crypto_aead_xchacha20poly1305_ietf_NPUBBYTES, nullptr,
+                  plaintext.data(), plaintext.size(), nullptr, 0, nullptr, blob.data() + VaultCrypto::kSaltBytes,
+                  reinterpret_cast<const std::uint8_t*>(k.data())),
+              0);
+  });
+
+  EXPECT_EQ(VaultCrypto::cipher_suite_of(blob), CipherSuite::kXChaCha20Poly1305);
+  EXPECT_FALSE(VaultCrypto::kdf_params_of(blob).has_value());
+  EXPECT_EQ(VaultCrypto::decrypt_vault("pw", blob), plaintext);
+}
+
+namespace {
+
+const KdfParams kFastKdf{crypto_pwhash_OPSLIMIT_MIN, crypto_pwhash_MEMLIMIT_MIN};
+
+}  // anonymous namespace
+
+TEST_F(VaultTest, KdfParamsAreRecordedInHeader) {
+  const std::vector<std::uint8_t> plaintext = {4, 5, 6};
+  const auto blob = VaultCrypto::encrypt_vault("pw", plaintext, kFastKdf);
+  EXPECT_EQ(VaultCrypto::kdf_params_of(blob), kFastKdf);
+
+  // The caller's parameters no longer matter for a blob that records its own.
+  EXPECT_EQ(VaultCrypto::decrypt_vault("pw", blob), plaintext);
+  EXPECT_EQ(VaultCrypto::decrypt_vault("pw", blob, KdfParams{crypto_pwhash_OPSLIMIT_MIN + 1}), plaintext);
+}
+
+TEST_F(VaultTest, HeaderKdfParamsAreBounded) {
+  auto blob = VaultCrypto::encrypt_vault("pw", {1}, kFastKdf);
+  constexpr std::size_t kMemlimitOffset = sizeof(VaultCrypto::kMagic) + 2 + 4;
+
+  // 16 TiB: must be refused before Argon2id tries to allocate it.
+  for (std::size_t i = 0; i < 4; ++i) {
+    blob[kMemlimitOffset + i] = 0xFF;
+  }
+  EXPECT_THROW((void)VaultCrypto::kdf_params_of(blob), std::runtime_error);
+  EXPECT_THROW(VaultCrypto::decrypt_vault("pw", blob), std::runtime_error);
+
+  KdfParams too_big = kFastKdf;
+  too_big.memlimit = VaultCrypto::kMaxMemlimit + 1024;
+  EXPECT_THROW(VaultCrypto::encrypt_vault("pw", {1}, too_big), std::runtime_error);
+}
+
+TEST_F(VaultTest, HeaderPassCountIsBounded) {
+  auto blob = VaultCrypto::encrypt_vault("pw", {1}, kFastKdf);
+  constexpr std::size_t kOpslimitOffset = sizeof(VaultCrypto::kMagic) + 2;
+
+  // 2^32 - 1 passes at the memory ceiling would keep an unlock busy for
+  // centuries: refused before any Argon2id runs.
+  constexpr std::size_t kMemlimitOffset = kOpslimitOffset + 4;
+  const std::uint32_t max_kib = static_cast<std::uint32_t>(VaultCrypto::kMaxMemlimit / 1024);
+  for (std::size_t i = 0; i < 4; ++i) {
+    blob[kOpslimitOffset + i] = 0xFF;
+    blob[kMemlimitOffset + i] = static_cast<std::uint8_t>(max_kib >> (8 * i));
+  }
+  EXPECT_THROW((void)VaultCrypto::kdf_params_of(blob), std::runtime_error);
+  EXPECT_THROW(VaultCrypto::decrypt_vault("pw", blob), std::runtime_error);
+
+  KdfParams too_slow = kFastKdf;
+  too_slow.opslimit = VaultCrypto::kMaxOpslimit + 1;
+  EXPECT_THROW(VaultCrypto::encrypt_vault("pw", {1}, too_slow), std::runtime_error);
+  too_slow.opslimit = VaultCrypto::kMaxOpslimit;
+  EXPECT_NO_THROW(VaultCrypto::check_kdf_params(too_slow));
+}
+
+TEST_F(VaultTest, SaveUpgradesVaultWithoutKdfParams) {
+  // Write a headerless vault, as releases before the header did.
+  const std::vector<std::uint8_t> serialized = VaultSerializer::serialize(PrimaryTable{});
+  std::vector<std::uint8_t> blob(VaultCrypto::kSaltBytes + crypto_aead_xchacha20poly1305_ietf_NPUBBYTES +
+                                 serialized.size() + VaultCrypto::kTagBytes);
+  randombytes_buf(blob.data(), VaultCrypto::kSaltBytes + crypto_aead_xchacha20poly1305_ietf_NPUBBYTES);
+  blob[0] = 0;
+  const Secret key = VaultCrypto::derive_master_key("pw", blob.data(), kFastKdf);
+  key.with_read_access([&](std::span<const char> k) {
+    ASSERT_EQ(crypto_aead_xchacha20poly1305_ietf_encrypt(
+                  blob.data() + VaultCrypto::kSaltBytes + crypto_aead_xchacha20poly1305_ietf_NPUBBYTES, nullptr,
+                  serialized.data(), serialized.size(), nullptr, 0, nullptr, blob.data() + VaultCrypto::kSaltBytes,
+                  reinterpret_cast<const std::uint8_t*>(k.data())),
+              0);
+  });
+  {
+    std::ofstream ofs(test_vault_path, std::ios::binary);
+    ofs.write(reinterpret_cast<const char*>(blob.data()), static_cast<std::streamsize>(blob.size()));
+  }
+
+  EXPECT_FALSE(VaultIO::stored_kdf_params(test_vault_path).has_value());
+  PrimaryTable table = VaultIO::load_vault(test_vault_path, "pw", kFastKdf);
+  VaultIO::save_vault(test_vault_path, table, "pw", kFastKdf);
+  EXPECT_EQ(VaultIO::stored_kdf_params(test_vault_path), kFastKdf);
+  EXPECT_NO_THROW(VaultIO::load_vault(test_vault_path, "pw"));
+}
+
+TEST_F(VaultTest, ParallelKdfRoundTrips) {
+  const std::vector<std::uint8_t> plaintext = {7, 8, 9};
+  KdfParams lanes4 = kFastKdf;
+  lanes4.memlimit = std::size_t{256} << 10;
+  lanes4.parallelism = 4;
+  const auto blob = VaultCrypto::encrypt_vault("pw", plaintext, lanes4);
+  EXPECT_EQ(blob[sizeof(VaultCrypto::kMagic)], VaultCrypto::kFormatVersion);
+  EXPECT_EQ(VaultCrypto::kdf_params_of(blob), lanes4);
+  EXPECT_EQ(VaultCrypto::decrypt_vault("pw", blob), plaintext);
+  EXPECT_THROW(VaultCrypto::decrypt_vault("wrong", blob), std::runtime_error);
+
+  // The lane count is bound to the key: the same cost with one lane derives
+  // a different one.
+  KdfParams lanes1 = lanes4;
+  lanes1.parallelism = 1;
+  const Secret k4 = VaultCrypto::derive_master_key("pw", blob.data() + VaultCrypto::kPrefixBytes, lanes4);
+  const Secret k1 = VaultCrypto::derive_master_key("pw", blob.data() + VaultCrypto::kPrefixBytes, lanes1);
+  k4.with_read_access([&](std::span<const char> a) {
+    k1.with_read_access([&](std::span<const char> b) { EXPECT_NE(std::memcmp(a.data(), b.data(), a.size()), 0); });
+  });
+}
+
+TEST_F(VaultTest, HeaderLaneCountIsBounded) {
+  KdfParams lanes2 = kFastKdf;
+  lanes2.memlimit = std::size_t{64} << 10;
+  lanes2.parallelism = 2;
+  auto blob = VaultCrypto::encrypt_vault("pw", {1}, lanes2);
+  constexpr std::size_t kLanesOffset = sizeof(VaultCrypto::kMagic) + 2 + 8;
+
+  for (const std::uint8_t lanes : {std::uint8_t{0}, std::uint8_t{VaultCrypto::kMaxParallelism + 1}}) {
+    blob[kLanesOffset] = lanes;
+    EXPECT_THROW((void)VaultCrypto::kdf_params_of(blob), std::runtime_error) << int{lanes};
+  }
+
+  // Fewer than 8 KiB per lane.
+  KdfParams thin = kFastKdf;
+  thin.parallelism = 2;
+  EXPECT_THROW(VaultCrypto::encrypt_vault("pw", {1}, thin), std::runtime_error);
+}
+
+TEST_F(VaultTest, CalibrationScalesMemoryThenPasses) {
+  // Model: 1 ms per pass per MiB.
+  const auto model = [](const KdfParams& kdf) {
+    return std::chrono::nanoseconds(std::chrono::milliseconds(kdf.opslimit * (kdf.memlimit >> 20)));
+  };
+  KdfCalibration calibration;
+  calibration.target = std::chrono::milliseconds(500);
+  calibration.max_memlimit = std::size_t{1} << 30;
+  calibration.parallelism = 1;
+
+  // Defaults cost 2 x 64 = 128 ms; one doubling to 128 MiB (256 ms) fits,
+  // another would not; 500 / 128 rounds down to 3 passes.
+  const KdfParams kdf = calibrate_kdf(calibration, model);
+  EXPECT_EQ(kdf.memlimit, std::size_t{128} << 20);
+  EXPECT_EQ(kdf.opslimit, 3u);
+  EXPECT_LE(model(kdf), calibration.target);
+
+  // Memory is capped, and the rest of the budget goes into passes.
+  calibration.target = std::chrono::seconds(10);
+  calibration.max_memlimit = std::size_t{256} << 20;
+  const KdfParams capped = calibrate_kdf(calibration, model);
+  EXPECT_EQ(capped.memlimit, std::size_t{256} << 20);
+  EXPECT_EQ(capped.opslimit, 39u);
+
+  // Passes stop at the ceiling every header is checked against.
+  calibration.target = std::chrono::hours(24);
+  calibration.max_memlimit = crypto_pwhash_MEMLIMIT_INTERACTIVE;
+  const KdfParams slowest = calibrate_kdf(calibration, model);
+  EXPECT_EQ(slowest.opslimit, VaultCrypto::kMaxOpslimit);
+  EXPECT_NO_THROW(VaultCrypto::check_kdf_params(slowest));
+}
+
+TEST_F(VaultTest, CalibrationNeverGoesBelowDefaults) {
+  const auto slow = [](const KdfParams&) { return std::chrono::nanoseconds(std::chrono::seconds(5)); };
+  KdfCalibration calibration;
+  calibration.target = std::chrono::milliseconds(100);
+  calibration.parallelism = 1;
+  EXPECT_EQ(calibrate_kdf(calibration, slow), KdfParams{});
+
+  // And against the real Argon2id, a target below one derivation.
+  calibration.target = std::chrono::milliseconds(1);
+  EXPECT_EQ(calibrate_kdf(calibration), KdfParams{});
+
+  // A lane count is kept even then, and 0 resolves to the hardware threads.
+  calibration.parallelism = 0;
+  const std::uint32_t lanes = calibrate_kdf(calibration, slow).parallelism;
+  EXPECT_GE(lanes, 1u);
+  EXPECT_LE(lanes, VaultCrypto::kMaxParallelism);
+  calibration.parallelism = 3;
+  EXPECT_EQ(calibrate_kdf(calibration, slow).parallelism, 3u);
+}
+
 TEST_F(VaultTest, FullVaultIORoundtrip) {
   std::string master_password = "my_vault_password";
 
@@ -0,0 +1,203 @@
+/* Copyright (c) 2026 Harun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "TestKdf.h"
+
+#include <pwledger/Config.h>
+#include <pwledger/SodiumInit.h>
+#include <pwledger/ThreadPool.h>
+#include <pwledger/VaultIO.h>
+#include <pwledger/VaultManager.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace pwledger;
+
+namespace {
+
+Secret make_password(const std::string& text) {
+  Secret password(256);
+  password.with_write_access([&](std::span<char> buf) {
+    std::memset(buf.data(), 0, buf.size());
+    std::memcpy(buf.data(), text.data(), text.size());
+  });
+  return password;
+}
+
+std::vector<VaultManager::UnlockRequest> requests(
+    std::initializer_list<std::pair<const char*, const char*>> names_and_passwords) {
+  std::vector<VaultManager::UnlockRequest> out;
+  for (const auto& [name, password] : names_and_passwords) {
+    out.push_back({name, make_password(password)});
+  }
+  return out;
+}
+
+class VaultManagerTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() { ASSERT_TRUE(sodium_init_once()); }
+
+  void SetUp() override {
+    const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+    dir_ = std::filesystem::temp_directory_path() / ("pwledger_test_vaults_" + std::string(info->name()));
+    std::filesystem::remove_all(dir_);
+    std::filesystem::create_directories(dir_);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(dir_); }
+
+  // Writes a vault file with `names` as entries and registers it.
+  void make_vault(const std::string& name, const std::string& password, const std::vector<std::string>& names) {
+    PrimaryTable table;
+    for (const auto& key : names) {
+      table.emplace(Uuid::generate(), SecretEntry(key, name + "@example.com", 16, 16));
+    }
+    const auto path = dir_ / (name + ".dat");
+    VaultIO::save_vault(path, table, password, kFastKdf);
+    manager_.add(name, path);
+  }
+
+  std::filesystem::path dir_;
+  ThreadPool pool_{ThreadPoolConfig{3, true, 0}};
+  VaultManager manager_{&pool_};
+};
+
+TEST_F(VaultManagerTest, UnlocksEachVaultOnItsOwn) {
+  make_vault("personal", "pw-personal", {"mail", "bank"});
+  make_vault("team", "pw-team", {"github.com", "ci"});
+  make_vault("service", "pw-service", {"deploy"});
+
+  const auto outcomes = manager_.unlock(requests({{"personal", "pw-personal"},
+                                                  {"team", "wrong"},
+                                                  {"service", "pw-service"},
+                                                  {"nope", "x"},
+                                                  {"service", "pw-service"}}));
+  ASSERT_EQ(outcomes.size(), 5u);
+  EXPECT_TRUE(outcomes[0].ok());
+  EXPECT_FALSE(outcomes[1].ok());  // wrong password: the others still open
+  EXPECT_TRUE(outcomes[2].ok());
+  EXPECT_EQ(outcomes[3].error, "no vault named 'nope'");
+  EXPECT_EQ(outcomes[4].error, "named twice");
+  EXPECT_EQ(outcomes[4].name, "service");
+  EXPECT_GT(outcomes[0].elapsed.count(), 0);
+
+  EXPECT_TRUE(manager_.find("personal")->unlocked);
+  EXPECT_EQ(manager_.find("personal")->table.size(), 2u);
+  EXPECT_EQ(manager_.find("personal")->kdf, kFastKdf);
+  EXPECT_FALSE(manager_.find("team")->unlocked);
+  EXPECT_TRUE(manager_.find("team")->table.empty());
+
+  // A second try needs only the vault that failed.
+  const auto retry = manager_.unlock(requests({{"team", "pw-team"}, {"personal", "pw-personal"}}));
+  EXPECT_TRUE(retry[0].ok());
+  EXPECT_EQ(retry[1].error, "already unlocked");
+}
+
+TEST_F(VaultManagerTest, SearchesAcrossUnlockedVaults) {
+  make_vault("personal", "a", {"GitHub personal", "mail"});
+  make_vault("team", "b", {"github.com", "jira"});
+  make_vault("service", "c", {"github deploy key"});
+  manager_.unlock(requests({{"personal", "a"}, {"team", "b"}}));
+
+  EXPECT_EQ(manager_.entries().size(), 4u);
+
+  const auto hits = manager_.search("GITHUB");
+  ASSERT_EQ(hits.size(), 2u);  // the locked service vault is not searched
+  EXPECT_EQ(hits[0].vault->name, "personal");
+  EXPECT_EQ(hits[0].entry->primary_key, "GitHub personal");
+  EXPECT_EQ(hits[1].vault->name, "team");
+  EXPECT_EQ(hits[1].entry->primary_key, "github.com");
+  EXPECT_EQ(hits[1].vault->table.at(*hits[1].uuid).primary_key, "github.com");
+
+  EXPECT_EQ(manager_.search("team@").size(), 2u);  // matches usernames too
+  EXPECT_TRUE(manager_.search("nothing").empty());
+}
+
+TEST_F(VaultManagerTest, LocksAndSavesPerVault) {
+  make_vault("personal", "a", {"mail"});
+  make_vault("team", "b", {"jira"});
+  manager_.unlock(requests({{"personal", "a"}, {"team", "b"}}));
+
+  // A change saved in one vault leaves the other file alone.
+  const auto team_before = std::filesystem::last_write_time(dir_ / "team.dat");
+  VaultManager::Vault& personal = *manager_.find("personal");
+  personal.table.emplace(Uuid::generate(), SecretEntry("bank", "", 16, 16));
+  manager_.save("personal");
+  EXPECT_EQ(std::filesystem::last_write_time(dir_ / "team.dat"), team_before);
+
+  EXPECT_TRUE(manager_.lock("personal"));
+  EXPECT_FALSE(manager_.lock("personal"));
+  EXPECT_FALSE(personal.unlocked);
+  EXPECT_TRUE(personal.table.empty());
+  EXPECT_TRUE(manager_.find("team")->unlocked);
+  EXPECT_THROW(manager_.save("personal"), std::invalid_argument);
+
+  ASSERT_TRUE(manager_.unlock(requests({{"personal", "a"}}))[0].ok());
+  EXPECT_EQ(personal.table.size(), 2u);
+
+  const auto saved = manager_.save_all();
+  ASSERT_EQ(saved.size(), 2u);
+  EXPECT_TRUE(saved[0].ok() && saved[1].ok());
+
+  manager_.lock_all();
+  EXPECT_TRUE(manager_.entries().empty());
+  EXPECT_TRUE(manager_.remove("team"));
+  EXPECT_FALSE(manager_.remove("team"));
+  EXPECT_EQ(manager_.size(), 1u);
+}
+
+TEST_F(VaultManagerTest, CreatesAndRegisters) {
+  manager_.add("fresh", dir_ / "sub" / "fresh.dat");
+  manager_.create("fresh", make_password("new"), kFastKdf);
+  EXPECT_TRUE(manager_.find("fresh")->unlocked);
+  EXPECT_TRUE(VaultIO::vault_exists(dir_ / "sub" / "fresh.dat"));
+  EXPECT_THROW(manager_.create("fresh", make_password("new"), kFastKdf), std::runtime_error);
+
+  manager_.lock("fresh");
+  EXPECT_TRUE(manager_.unlock(requests({{"fresh", "new"}}))[0].ok());
+
+  manager_.add("missing", dir_ / "missing.dat");
+  EXPECT_EQ(manager_.unlock(requests({{"missing", "x"}}))[0].error.find("no vault file"), 0u);
+
+  EXPECT_THROW(manager_.add("fresh", dir_ / "other.dat"), std::invalid_argument);
+  EXPECT_THROW(manager_.add("", dir_ / "other.dat"), std::invalid_argument);
+}
+
+TEST_F(VaultManagerTest, FromConfig) {
+  VaultConfig config;
+  config.directory = dir_.string();
+  config.vaults = {{"team", "team.dat"}, {"ci", (dir_ / "elsewhere" / "ci.dat").string()}};
+
+  const VaultManager manager = VaultManager::from_config(config, &pool_);
+  const auto vaults = manager.vaults();
+  ASSERT_EQ(vaults.size(), 2u);
+  EXPECT_EQ(vaults[0]->name, "ci");
+  EXPECT_EQ(vaults[0]->path, dir_ / "elsewhere" / "ci.dat");
+  EXPECT_EQ(vaults[1]->path, dir_ / "team.dat");
+  EXPECT_FALSE(vaults[1]->unlocked);
+}
+
+}  // namespace